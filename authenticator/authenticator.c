@@ -35,7 +35,22 @@
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_mgmt.h"
 #include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_reauth_timer_fsm.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_cache.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_shard.h"
+#include "authenticator/authenticator_latency.h"
+#include "authenticator/authenticator_radsec.h"
+#include "authenticator/authenticator_dae.h"
+#include "authenticator/authenticator_local.h"
+#include "authenticator/authenticator_random.h"
+#include "authenticator/authenticator_event.h"
+#include "authenticator/authenticator_stream.h"
+#include "authenticator/authenticator_capture.h"
+#include "authenticator/authenticator_profile.h"
 #include "radius/radius.h"
 #include "debug.h"
 
@@ -57,11 +72,52 @@ void authenticatorGetDefaultSettings(AuthenticatorSettings *settings)
 
    //Peer interface
    settings->interface = NULL;
+   //Additional network interfaces
+   settings->numInterfaces = 0;
+   settings->interfaces = NULL;
 
    //Number of ports
    settings->numPorts = 0;
    //Ports
    settings->ports = NULL;
+   settings->portData = NULL;
+   settings->portNumbers = NULL;
+   //Number of additional sessions
+   settings->numHosts = 0;
+   //Additional sessions of multi-supplicant ports
+   settings->hosts = NULL;
+   settings->hostData = NULL;
+   //A single supplicant is authenticated on each port
+   settings->maxHostsPerPort = 1;
+
+   //Number of session buffers (each port uses its built-in session buffer
+   //unless a pool is supplied)
+   settings->numBuffers = 0;
+   //Pool of session buffers
+   settings->buffers = NULL;
+   settings->bufferMemory = NULL;
+   //Session buffers are sized for EAP-TLS
+   settings->txBufferSize = AUTHENTICATOR_TX_BUFFER_SIZE;
+   settings->framedMtu = EAP_MAX_FRAG_SIZE;
+   //The number of concurrently authenticating ports is only bounded by the
+   //size of the pool
+   settings->maxSessions = 0;
+   //Waiting ports are served in a round-robin fashion
+   settings->admissionPolicy = AUTHENTICATOR_ADMISSION_POLICY_FAIR;
+   //The authorization cache is disabled
+   settings->authCacheTtl = 0;
+   //Reauthentication takes place exactly every reAuthPeriod seconds
+   settings->reauthJitter = 0;
+   //Interim accounting updates are disabled
+   settings->acctInterimInterval = 0;
+   //Dynamic Authorization server port
+   settings->daePort = RADIUS_DAE_PORT;
+   //Sessions fail when the RADIUS servers do not answer
+   settings->criticalAuthPolicy = AUTHENTICATOR_CRITICAL_AUTH_DISABLED;
+   settings->criticalAuthDeadline = 0;
+   //Reauthentications fail when the RADIUS servers do not answer
+   settings->reauthDeferral = FALSE;
+   settings->reauthDrainRate = 0;
 
    //RADIUS server interface
    settings->serverInterface = NULL;
@@ -77,6 +133,12 @@ void authenticatorGetDefaultSettings(AuthenticatorSettings *settings)
    settings->prngAlgo = NULL;
    settings->prngContext = NULL;
 
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   //The software implementation is used by default
+   settings->cryptoProvider = NULL;
+   settings->cryptoParam = NULL;
+#endif
+
    //Authenticator PAE state change callback function
    settings->paeStateChangeCallback = NULL;
    //Backend authentication state change callback function
@@ -85,8 +147,72 @@ void authenticatorGetDefaultSettings(AuthenticatorSettings *settings)
    settings->reauthTimerStateChangeCallback = NULL;
    //EAP full authenticator state change callback function
    settings->eapFullAuthStateChangeCallback = NULL;
+   //Host status callback function
+   settings->hostStatusCallback = NULL;
    //Tick callback function
    settings->tickCallback = NULL;
+   settings->portChangeCallback = NULL;
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   //TLS initialization callback function
+   settings->radsecInitCallback = NULL;
+#endif
+   //Link state callback function
+   settings->linkStateCallback = NULL;
+   //The link state of the ports is polled
+   settings->linkChangeNotification = FALSE;
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   //The state changes are delivered from the authenticator task
+   settings->eventNotification = NULL;
+#endif
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   //No capture
+   settings->captureCallback = NULL;
+#endif
+}
+
+
+/**
+ * @brief Size the session buffers according to a footprint profile
+ *
+ * The small-footprint profile is validated against the largest EAP-MD5
+ * Access-Request. It does not leave enough room for EAP-TLS, whose
+ * responses are rejected by the authenticator once the buffer is full.
+ * The memory backing the pool must be sized accordingly, using the
+ * AUTHENTICATOR_BUFFER_MEMORY_SIZE macro
+ *
+ * @param[in,out] settings Structure that contains 802.1X authenticator settings
+ * @param[in] profile Footprint profile
+ * @return Error code
+ **/
+
+error_t authenticatorSetFootprintProfile(AuthenticatorSettings *settings,
+   AuthenticatorFootprintProfile profile)
+{
+   //Check parameters
+   if(settings == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check footprint profile
+   if(profile == AUTHENTICATOR_FOOTPRINT_DEFAULT)
+   {
+      //Session buffers are sized for EAP-TLS
+      settings->txBufferSize = AUTHENTICATOR_TX_BUFFER_SIZE;
+      settings->framedMtu = EAP_MAX_FRAG_SIZE;
+   }
+   else if(profile == AUTHENTICATOR_FOOTPRINT_SMALL)
+   {
+      //Session buffers are sized for EAP-MD5 and MAB
+      settings->txBufferSize = AUTHENTICATOR_SMALL_TX_BUFFER_SIZE;
+      settings->framedMtu = AUTHENTICATOR_SMALL_FRAMED_MTU;
+   }
+   else
+   {
+      //Unknown profile
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Successful processing
+   return NO_ERROR;
 }
 
 
@@ -102,6 +228,7 @@ error_t authenticatorInit(AuthenticatorContext *context,
 {
    error_t error;
    uint_t i;
+   uint_t j;
    AuthenticatorPort *port;
 
    //Debug message
@@ -111,15 +238,136 @@ error_t authenticatorInit(AuthenticatorContext *context,
    if(context == NULL || settings == NULL)
       return ERROR_INVALID_PARAMETER;
 
-   if(settings->interface == NULL)
+   if(settings->numPorts == 0 || settings->ports == NULL ||
+      settings->portData == NULL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Several network interfaces?
+   if(settings->numInterfaces > 0)
+   {
+      if(settings->interfaces == NULL ||
+         settings->numInterfaces > AUTHENTICATOR_MAX_INTERFACES)
+      {
+         return ERROR_INVALID_PARAMETER;
+      }
+
+      //Loop through the network interfaces
+      for(i = 0; i < settings->numInterfaces; i++)
+      {
+         if(settings->interfaces[i].interface == NULL)
+            return ERROR_INVALID_PARAMETER;
+
+         //All the interfaces must belong to the same TCP/IP stack
+         if(settings->interfaces[i].interface->netContext !=
+            settings->interfaces[0].interface->netContext)
+         {
+            return ERROR_INVALID_PARAMETER;
+         }
+
+         //Port offsets must be listed in ascending order
+         if(i > 0 && settings->interfaces[i].portOffset <=
+            settings->interfaces[i - 1].portOffset)
+         {
+            return ERROR_INVALID_PARAMETER;
+         }
+      }
+
+      //The first port must belong to the first interface
+      if(settings->portNumbers != NULL)
+      {
+         if(settings->portNumbers[0] <= settings->interfaces[0].portOffset)
+            return ERROR_INVALID_PARAMETER;
+      }
+      else
+      {
+         if(settings->interfaces[0].portOffset != 0)
+            return ERROR_INVALID_PARAMETER;
+      }
+   }
+   else
+   {
+      //The ports are attached to the underlying network interface
+      if(settings->interface == NULL)
+         return ERROR_INVALID_PARAMETER;
+   }
+
+   //Port numbers are 16-bit values
+   if(settings->portNumbers != NULL)
+   {
+      //Port numbers must be non-zero and listed in ascending order
+      for(i = 0; i < settings->numPorts; i++)
+      {
+         if(settings->portNumbers[i] == 0)
+            return ERROR_INVALID_PARAMETER;
+
+         if(i > 0 && settings->portNumbers[i] <= settings->portNumbers[i - 1])
+            return ERROR_INVALID_PARAMETER;
+      }
+
+      //Additional sessions are numbered after the last port
+      if((settings->portNumbers[settings->numPorts - 1] +
+         settings->numHosts) > UINT16_MAX)
+      {
+         return ERROR_INVALID_PARAMETER;
+      }
+   }
+   else
+   {
+      //Ports are numbered from 1 to numPorts
+      if((settings->numPorts + settings->numHosts) > UINT16_MAX)
+         return ERROR_INVALID_PARAMETER;
+   }
+
+#if (AUTHENTICATOR_STATIC_BUFFER_SUPPORT == ENABLED)
+   //Each port falls back to its built-in session buffer when the caller does
+   //not supply a pool
+   if(settings->numBuffers == 0 && settings->buffers == NULL &&
+      settings->bufferMemory == NULL)
+   {
+      //The built-in session buffers have a fixed size
+      if(settings->txBufferSize > AUTHENTICATOR_TX_BUFFER_SIZE)
+         return ERROR_INVALID_PARAMETER;
+   }
+   else if(settings->numBuffers == 0 || settings->buffers == NULL ||
+      settings->bufferMemory == NULL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+#else
+   //The pool of session buffers must be supplied by the caller
+   if(settings->numBuffers == 0 || settings->buffers == NULL ||
+      settings->bufferMemory == NULL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+#endif
+
+   //The transmission buffers must hold the largest Access-Request that is
+   //not checked against the size of the buffer
+   if(settings->txBufferSize < AUTHENTICATOR_MIN_TX_BUFFER_SIZE)
       return ERROR_INVALID_PARAMETER;
 
-   if(settings->numPorts == 0 || settings->ports == NULL)
+   //The EAP packets received from the server are relayed as EAPOL PDUs
+   if(settings->framedMtu < AUTHENTICATOR_MIN_FRAMED_MTU ||
+      (settings->framedMtu + sizeof(EapolPdu)) > settings->txBufferSize)
+   {
       return ERROR_INVALID_PARAMETER;
+   }
 
    if(settings->prngAlgo == NULL || settings->prngContext == NULL)
       return ERROR_INVALID_PARAMETER;
 
+   if(settings->reauthJitter > AUTHENTICATOR_MAX_REAUTH_JITTER)
+      return ERROR_INVALID_PARAMETER;
+
+   if(settings->maxHostsPerPort == 0 || (settings->numHosts > 0 &&
+      (settings->hosts == NULL || settings->hostData == NULL)))
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
    //Clear authenticator context
    osMemset(context, 0, sizeof(AuthenticatorContext));
 
@@ -127,23 +375,81 @@ error_t authenticatorInit(AuthenticatorContext *context,
    context->taskParams = settings->task;
    context->taskId = OS_INVALID_TASK_ID;
 
+   //Save the network interfaces
+   if(settings->numInterfaces > 0)
+   {
+      //Loop through the network interfaces
+      for(i = 0; i < settings->numInterfaces; i++)
+      {
+         context->interfaces[i].interface = settings->interfaces[i].interface;
+         context->interfaces[i].portOffset = settings->interfaces[i].portOffset;
+      }
+
+      //Save the number of network interfaces
+      context->numInterfaces = settings->numInterfaces;
+   }
+   else
+   {
+      //All the ports are attached to the underlying network interface
+      context->interfaces[0].interface = settings->interface;
+      context->interfaces[0].portOffset = 0;
+      context->numInterfaces = 1;
+   }
+
    //Attach TCP/IP stack context
-   context->netContext = settings->interface->netContext;
+   context->netContext = context->interfaces[0].interface->netContext;
 
    //Save user settings
-   context->interface = settings->interface;
+   context->interface = context->interfaces[0].interface;
    context->numPorts = settings->numPorts;
    context->ports = settings->ports;
+   context->numHosts = settings->numHosts;
+   context->hosts = settings->hosts;
+   context->maxHostsPerPort = settings->maxHostsPerPort;
+   context->numBuffers = settings->numBuffers;
+   context->buffers = settings->buffers;
+   context->bufferMemory = settings->bufferMemory;
+   context->txBufferSize = settings->txBufferSize;
+   context->framedMtu = settings->framedMtu;
+   context->maxSessions = settings->maxSessions;
+   context->admissionPolicy = settings->admissionPolicy;
+   context->authCacheTtl = settings->authCacheTtl;
+   context->reauthJitter = settings->reauthJitter;
+   context->reauthDeferral = settings->reauthDeferral;
+   context->reauthDrainRate = settings->reauthDrainRate;
+   context->acctInterimInterval = settings->acctInterimInterval;
    context->serverPortIndex = settings->serverPortIndex;
-   context->serverIpAddr = settings->serverIpAddr;
-   context->serverPort = settings->serverPort;
    context->prngAlgo = settings->prngAlgo;
    context->prngContext = settings->prngContext;
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   context->cryptoProvider = settings->cryptoProvider;
+   context->cryptoParam = settings->cryptoParam;
+#endif
    context->paeStateChangeCallback = settings->paeStateChangeCallback;
    context->backendStateChangeCallback = settings->backendStateChangeCallback;
    context->reauthTimerStateChangeCallback = settings->reauthTimerStateChangeCallback;
    context->eapFullAuthStateChangeCallback = settings->eapFullAuthStateChangeCallback;
+   context->hostStatusCallback = settings->hostStatusCallback;
    context->tickCallback = settings->tickCallback;
+   context->portChangeCallback = settings->portChangeCallback;
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   context->radsecInitCallback = settings->radsecInitCallback;
+#endif
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+   context->daePort = settings->daePort;
+#endif
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   context->criticalAuthPolicy = settings->criticalAuthPolicy;
+   context->criticalAuthDeadline = settings->criticalAuthDeadline;
+#endif
+   context->linkStateCallback = settings->linkStateCallback;
+   context->linkChangeNotification = settings->linkChangeNotification;
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   context->eventNotification = settings->eventNotification;
+#endif
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   context->captureCallback = settings->captureCallback;
+#endif
 
    //Select the interface used to reach the RADIUS server
    if(settings->serverInterface != NULL)
@@ -152,7 +458,7 @@ error_t authenticatorInit(AuthenticatorContext *context,
    }
    else
    {
-      context->serverInterface = settings->interface;
+      context->serverInterface = context->interface;
    }
 
    //Loop through the ports
@@ -163,11 +469,39 @@ error_t authenticatorInit(AuthenticatorContext *context,
 
       //Clear port context
       osMemset(port, 0, sizeof(AuthenticatorPort));
+      //Clear the cold record of the port
+      osMemset(&settings->portData[i], 0, sizeof(AuthenticatorPortData));
 
       //Attach authenticator context to each port
       port->context = context;
+      //Attach the cold record to the port
+      port->data = &settings->portData[i];
       //Set port index
-      port->portIndex = i + 1;
+      if(settings->portNumbers != NULL)
+      {
+         port->portIndex = settings->portNumbers[i];
+      }
+      else
+      {
+         port->portIndex = i + 1;
+      }
+
+      //Sparse numbering requires the port table to be searched
+      if(port->portIndex != (i + 1))
+      {
+         context->sparsePorts = TRUE;
+      }
+
+      //Select the network interface the port is attached to
+      for(j = context->numInterfaces - 1; j > 0; j--)
+      {
+         //The ports of an interface are numbered from its offset + 1
+         if(port->portIndex > context->interfaces[j].portOffset)
+            break;
+      }
+
+      //Save the index of the network interface
+      port->data->interfaceIndex = j;
 
       //Default value of parameters
       port->portControl = AUTHENTICATOR_PORT_MODE_FORCE_AUTH;
@@ -183,18 +517,61 @@ error_t authenticatorInit(AuthenticatorContext *context,
       authenticatorGeneratePortAddr(port);
 
       //The port is down
-      port->sessionStats.sessionTerminateCause =
+      port->data->sessionStats.sessionTerminateCause =
          AUTHENTICATOR_TERMINATE_CAUSE_PORT_FAILURE;
    }
 
-   //Initialize authenticator state machine
-   authenticatorInitFsm(context);
+   //Loop through the additional sessions
+   for(i = 0; i < context->numHosts; i++)
+   {
+      //Point to the current session
+      port = &context->hosts[i];
+
+      //Clear session context
+      osMemset(port, 0, sizeof(AuthenticatorPort));
+      //Clear the cold record of the session
+      osMemset(&settings->hostData[i], 0, sizeof(AuthenticatorPortData));
+
+      //Attach authenticator context to each session
+      port->context = context;
+      //Attach the cold record to the session
+      port->data = &settings->hostData[i];
+      //Additional sessions are numbered after the ports
+      port->portIndex = context->ports[context->numPorts - 1].portIndex +
+         i + 1;
+      //The session is not bound to any port yet
+      port->host = TRUE;
+      port->portControl = AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH;
+   }
+
+   //Split the ports into shards
+   authenticatorInitShards(context);
+
+   //Initialize the pool of session buffers
+   authenticatorInitBufferPool(context);
+
+   //The first entry of the server list is populated with the user settings
+   context->servers[0].enabled = TRUE;
+   context->servers[0].ipAddr = settings->serverIpAddr;
+   context->servers[0].port = settings->serverPort;
+   context->servers[0].priority = 0;
+   context->servers[0].weight = 1;
+
+   //Loop through the RADIUS servers
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Precompute the HMAC-MD5 states of the (empty) shared secret
+      authenticatorInitHmacKey(context, &context->servers[i]);
+      //No round-trip time measurement is available yet
+      authenticatorResetRadiusRtt(&context->servers[i]);
+      authenticatorResetRadiusWindow(&context->servers[i]);
+   }
 
    //Start of exception handling block
    do
    {
-      //Create a mutex to prevent simultaneous access to 802.1X authenticator
-      //context
+      //Create a mutex to prevent simultaneous access to the state shared by
+      //the shards
       if(!osCreateMutex(&context->mutex))
       {
          //Failed to create mutex
@@ -210,9 +587,69 @@ error_t authenticatorInit(AuthenticatorContext *context,
          break;
       }
 
-      //Successful initialization
+      //Initialize status code
       error = NO_ERROR;
 
+      //Loop through the shards
+      for(i = 0; i < AUTHENTICATOR_NUM_SHARDS && !error; i++)
+      {
+         //Create a mutex to prevent simultaneous access to the ports of the
+         //shard
+         if(!osCreateMutex(&context->shards[i].mutex))
+         {
+            //Failed to create mutex
+            error = ERROR_OUT_OF_RESOURCES;
+         }
+         //Create an event object to wake up the shard task
+         else if(!osCreateEvent(&context->shards[i].event))
+         {
+            //Failed to create event
+            error = ERROR_OUT_OF_RESOURCES;
+         }
+         else
+         {
+            //Just for sanity
+         }
+      }
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+      //Loop through the TLS connections
+      for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS && !error; i++)
+      {
+         //Create a mutex to serialize the accesses to the connection
+         if(!osCreateMutex(&context->radsecConns[i].mutex))
+         {
+            //Failed to create mutex
+            error = ERROR_OUT_OF_RESOURCES;
+         }
+      }
+#endif
+
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+      //Create a mutex to protect the event queue
+      if(!error && !osCreateMutex(&context->eventMutex))
+      {
+         //Failed to create mutex
+         error = ERROR_OUT_OF_RESOURCES;
+      }
+#endif
+
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+      //Create a mutex to serialize the blocks of the capture
+      if(!error && !osCreateMutex(&context->captureMutex))
+      {
+         //Failed to create mutex
+         error = ERROR_OUT_OF_RESOURCES;
+      }
+#endif
+
+      //Any error to report?
+      if(error)
+         break;
+
+      //Initialize authenticator state machine
+      authenticatorInitFsm(context);
+
       //End of exception handling block
    } while(0);
 
@@ -239,19 +676,36 @@ error_t authenticatorInit(AuthenticatorContext *context,
 error_t authenticatorSetServerAddr(AuthenticatorContext *context,
    const IpAddr *serverIpAddr, uint16_t serverPort)
 {
+   uint_t i;
+
    //Check parameters
    if(context == NULL || serverIpAddr == NULL)
       return ERROR_INVALID_PARAMETER;
 
    //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
    osAcquireMutex(&context->mutex);
 
    //Save the IP address and the port number of the RADIUS server
-   context->serverIpAddr = *serverIpAddr;
-   context->serverPort = serverPort;
+   context->servers[0].enabled = TRUE;
+   context->servers[0].ipAddr = *serverIpAddr;
+   context->servers[0].port = serverPort;
+
+   //The NAS-IP-Address attribute depends on the route to the RADIUS server
+   for(i = 0; i < context->numPorts; i++)
+   {
+      authenticatorInvalidateRadiusTemplate(&context->ports[i]);
+   }
+
+   //Additional sessions format their own attributes
+   for(i = 0; i < context->numHosts; i++)
+   {
+      authenticatorInvalidateRadiusTemplate(&context->hosts[i]);
+   }
 
    //Release exclusive access to the 802.1X authenticator context
    osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
 
    //Successful processing
    return NO_ERROR;
@@ -282,15 +736,20 @@ error_t authenticatorSetServerKey(AuthenticatorContext *context,
       return ERROR_INVALID_LENGTH;
 
    //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
    osAcquireMutex(&context->mutex);
 
    //Copy key
-   osMemcpy(context->serverKey, key, keyLen);
+   osMemcpy(context->servers[0].key, key, keyLen);
    //Save the length of the key
-   context->serverKeyLen = keyLen;
+   context->servers[0].keyLen = keyLen;
+
+   //The HMAC-MD5 inner and outer states are computed once for all
+   authenticatorInitHmacKey(context, &context->servers[0]);
 
    //Release exclusive access to the 802.1X authenticator context
    osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
 
    //Successful processing
    return NO_ERROR;
@@ -298,287 +757,1828 @@ error_t authenticatorSetServerKey(AuthenticatorContext *context,
 
 
 /**
- * @brief Reinitialize the specified port
+ * @brief Configure an entry of the RADIUS server list
+ *
+ * New sessions are assigned to the live servers having the lowest priority
+ * value, in proportion to their weight. A server that repeatedly fails to
+ * answer is declared dead and probed with Status-Server packets until it
+ * responds again
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
+ * @param[in] serverIndex Zero-based index of the entry
+ * @param[in] serverIpAddr IP address of the RADIUS server
+ * @param[in] serverPort Port number
+ * @param[in] key Pointer to the shared secret
+ * @param[in] keyLen Length of the shared secret, in bytes
+ * @param[in] priority Priority of the server (lower values are preferred)
+ * @param[in] weight Relative share of new sessions
  * @return Error code
  **/
 
-error_t authenticatorInitPort(AuthenticatorContext *context,
-   uint_t portIndex)
+error_t authenticatorSetServer(AuthenticatorContext *context,
+   uint_t serverIndex, const IpAddr *serverIpAddr, uint16_t serverPort,
+   const uint8_t *key, size_t keyLen, uint_t priority, uint_t weight)
 {
-   error_t error;
+   uint_t i;
+   AuthenticatorRadiusServer *server;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || serverIpAddr == NULL)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetInitialize(context, portIndex, TRUE,
-         TRUE);
+   if(key == NULL && keyLen != 0)
+      return ERROR_INVALID_PARAMETER;
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
+   //Invalid server index?
+   if(serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
+
+   //The weight must be a positive value
+   if(weight == 0)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the length of the key
+   if(keyLen > AUTHENTICATOR_MAX_SERVER_KEY_LEN)
+      return ERROR_INVALID_LENGTH;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   osAcquireMutex(&context->mutex);
+
+   //Point to the server entry
+   server = &context->servers[serverIndex];
+
+   //Cancel any outstanding Status-Server probe
+   authenticatorCancelStatusServer(context, server);
+
+   //Save server parameters
+   server->enabled = TRUE;
+   server->ipAddr = *serverIpAddr;
+   server->port = serverPort;
+   server->priority = priority;
+   server->weight = weight;
+   server->credit = 0;
+
+   //The server is reached over UDP unless specified otherwise
+   server->transport = AUTHENTICATOR_RADIUS_TRANSPORT_UDP;
+   //Close any TLS connection to the previous server
+   authenticatorResetRadsecConn(context, serverIndex);
+
+   //The server is assumed to be alive
+   server->dead = FALSE;
+   server->failures = 0;
+   server->holdDownTimer = 0;
+
+   //Discard the round-trip time measurements of the previous server
+   authenticatorResetRadiusRtt(server);
+   authenticatorResetRadiusWindow(server);
+
+   //Copy key
+   osMemcpy(server->key, key, keyLen);
+   //Save the length of the key
+   server->keyLen = keyLen;
+
+   //The HMAC-MD5 inner and outer states are computed once for all
+   authenticatorInitHmacKey(context, server);
+
+   //The NAS-IP-Address attribute depends on the route to the RADIUS server
+   for(i = 0; i < context->numPorts; i++)
+   {
+      authenticatorInvalidateRadiusTemplate(&context->ports[i]);
    }
-   else
+
+   //Additional sessions format their own attributes
+   for(i = 0; i < context->numHosts; i++)
    {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
+      authenticatorInvalidateRadiusTemplate(&context->hosts[i]);
    }
 
-   //Return status code
-   return error;
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Force the authenticator to reauthenticate the supplicant
+ * @brief Remove an entry from the RADIUS server list
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
+ * @param[in] serverIndex Zero-based index of the entry
  * @return Error code
  **/
 
-error_t authenticatorReauthenticate(AuthenticatorContext *context,
-   uint_t portIndex)
+error_t authenticatorDeleteServer(AuthenticatorContext *context,
+   uint_t serverIndex)
 {
-   error_t error;
+   AuthenticatorRadiusServer *server;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetReauthenticate(context, portIndex, TRUE,
-         TRUE);
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   osAcquireMutex(&context->mutex);
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
-   }
-   else
-   {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
-   }
+   //Point to the server entry
+   server = &context->servers[serverIndex];
 
-   //Return status code
-   return error;
+   //Cancel any outstanding Status-Server probe
+   authenticatorCancelStatusServer(context, server);
+
+   //The entry is no longer in use. Responses from this server are discarded
+   server->enabled = FALSE;
+   server->dead = FALSE;
+   server->failures = 0;
+
+   //Close any TLS connection to the server
+   authenticatorResetRadsecConn(context, serverIndex);
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Set the value of the AuthControlledPortControl parameter
+ * @brief Select the transport protocol used to reach a RADIUS server
+ *
+ * With the TLS transport, a long-lived connection is maintained to the
+ * server and carries all the requests. The shared secret is set to "radsec"
+ * (refer to RFC 6614, section 2.3), so this function must be called after
+ * authenticatorSetServer
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[in] portControl Value of the AuthControlledPortControl parameter
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[in] transport Transport protocol
  * @return Error code
  **/
 
-error_t authenticatorSetPortControl(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorPortMode portControl)
+error_t authenticatorSetServerTransport(AuthenticatorContext *context,
+   uint_t serverIndex, AuthenticatorRadiusTransport transport)
 {
-   error_t error;
+   AuthenticatorRadiusServer *server;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check transport protocol
+   if(transport == AUTHENTICATOR_RADIUS_TRANSPORT_UDP)
+   {
+      //RADIUS over UDP is always supported
+   }
+   else if(transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+   {
+#if (AUTHENTICATOR_RADSEC_SUPPORT == DISABLED)
+      //RADIUS over TLS is not supported
+      return ERROR_NOT_IMPLEMENTED;
+#endif
+   }
+   else
+   {
+      //Report an error
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   osAcquireMutex(&context->mutex);
+
+   //Point to the server entry
+   server = &context->servers[serverIndex];
+
+   //Cancel any outstanding Status-Server probe
+   authenticatorCancelStatusServer(context, server);
+
+   //Save the transport protocol
+   server->transport = transport;
+
+   //RADIUS over TLS?
+   if(transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+   {
+      //The TLS layer protects the packets. The shared secret is a fixed
+      //string
+      osMemcpy(server->key, "radsec", 6);
+      server->keyLen = 6;
+
+      //The HMAC-MD5 inner and outer states are computed once for all
+      authenticatorInitHmacKey(context, server);
+   }
+
+   //The server is assumed to be alive
+   server->dead = FALSE;
+   server->failures = 0;
+   server->holdDownTimer = 0;
+
+   //The round-trip times differ from one transport to another
+   authenticatorResetRadiusRtt(server);
+   authenticatorResetRadiusWindow(server);
+
+   //Open a new connection if needed
+   authenticatorResetRadsecConn(context, serverIndex);
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Limit the number of sessions assigned to a RADIUS server
+ *
+ * Once all the servers have reached their limit, the ports that start a new
+ * authentication exchange wait until a session completes
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[in] maxSessions Maximum number of concurrent sessions (0 means no
+ *   limit)
+ * @return Error code
+ **/
+
+error_t authenticatorSetServerMaxSessions(AuthenticatorContext *context,
+   uint_t serverIndex, uint_t maxSessions)
+{
+   //Check parameters
+   if(context == NULL || serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Save the session limit
+   context->servers[serverIndex].maxSessions = maxSessions;
+
+   //A higher limit may allow waiting ports to proceed
+   authenticatorGrantPortBuffers(context, NULL);
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Configure admission control
+ *
+ * Limiting the number of concurrently authenticating ports prevents a burst
+ * of link-up events from overloading the RADIUS servers. The ports that
+ * cannot be admitted wait in the RESTART state
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] maxSessions Maximum number of concurrently authenticating ports
+ *   (0 means the number of ports is only bounded by the size of the pool)
+ * @param[in] policy Order in which the waiting ports are served
+ * @return Error code
+ **/
+
+error_t authenticatorSetAdmissionControl(AuthenticatorContext *context,
+   uint_t maxSessions, AuthenticatorAdmissionPolicy policy)
+{
+   //Check parameters
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid policy?
+   if(policy != AUTHENTICATOR_ADMISSION_POLICY_FAIR &&
+      policy != AUTHENTICATOR_ADMISSION_POLICY_PREFER_NEW)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Save admission control parameters
+   context->maxSessions = maxSessions;
+   context->admissionPolicy = policy;
+
+   //A higher limit may allow waiting ports to proceed
+   authenticatorGrantPortBuffers(context, NULL);
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Set the lifetime of the authorization cache entries
+ *
+ * A supplicant that has been authorized recently is re-admitted immediately
+ * when it comes back after a link flap, while a reauthentication confirms
+ * the decision in the background. The lifetime of an entry is further
+ * bounded by the Session-Timeout attribute of the Access-Accept
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] ttl Lifetime of the cache entries, in seconds (0 to disable the
+ *   authorization cache)
+ * @return Error code
+ **/
+
+error_t authenticatorSetAuthCacheTtl(AuthenticatorContext *context,
+   uint_t ttl)
+{
+   uint_t i;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+
+   //Save the lifetime of the cache entries
+   context->authCacheTtl = ttl;
+
+   //Existing entries are discarded when the cache is disabled
+   for(i = 0; i < context->numPorts && ttl == 0; i++)
+   {
+      authenticatorFlushPortAuthCache(&context->ports[i]);
+   }
+
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Flush the authorization cache
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index (0 to flush the cache of all the ports)
+ * @return Error code
+ **/
+
+error_t authenticatorFlushAuthCache(AuthenticatorContext *context,
+   uint_t portIndex)
+{
+   uint_t i;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid port index?
+   if(portIndex != 0 && authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+
+   //Loop through the ports
+   for(i = 0; i < context->numPorts; i++)
+   {
+      //Matching port?
+      if(portIndex == 0 || portIndex == context->ports[i].portIndex)
+      {
+         authenticatorFlushPortAuthCache(&context->ports[i]);
+      }
+   }
+
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Set the reauthentication jitter
+ *
+ * Each reauthentication is scheduled at a random time within the last part
+ * of the reauthentication period, so that the ports that authenticated
+ * together do not keep reauthenticating together
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] jitter Fraction of the reauthentication period over which the
+ *   ports are spread, in percent (0 to disable jitter)
+ * @return Error code
+ **/
+
+error_t authenticatorSetReauthJitter(AuthenticatorContext *context,
+   uint_t jitter)
+{
+   //Check parameters
+   if(context == NULL || jitter > AUTHENTICATOR_MAX_REAUTH_JITTER)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   //The new value applies to the next reauthentications
+   context->reauthJitter = jitter;
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Configure the handling of reauthentications during server outages
+ *
+ * When every RADIUS server is known to be dead, the reauthentications are
+ * postponed with an exponential backoff and the sessions remain authorized.
+ * Once a server has recovered, the postponed reauthentications are started
+ * at a controlled rate
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] enable Keep the sessions authorized during server outages
+ * @param[in] drainRate Number of postponed reauthentications started per
+ *   second once a RADIUS server has recovered (0 means no limit)
+ * @return Error code
+ **/
+
+error_t authenticatorSetReauthDeferral(AuthenticatorContext *context,
+   bool_t enable, uint_t drainRate)
+{
+   //Check parameters
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Save reauthentication deferral parameters
+   context->reauthDeferral = enable;
+   context->reauthDrainRate = drainRate;
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Set RADIUS accounting server
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] ipAddr IP address of the accounting server
+ * @param[in] port UDP port number of the accounting server (0 to disable
+ *   accounting)
+ * @param[in] key Pointer to the shared secret
+ * @param[in] keyLen Length of the shared secret
+ * @return Error code
+ **/
+
+error_t authenticatorSetAcctServer(AuthenticatorContext *context,
+   const IpAddr *ipAddr, uint16_t port, const uint8_t *key, size_t keyLen)
+{
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   uint_t i;
+   AuthenticatorAcctRecord *record;
+
+   //Check parameters
+   if(context == NULL || ipAddr == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check parameters
+   if(key == NULL && keyLen != 0)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the length of the key
+   if(keyLen > AUTHENTICATOR_MAX_SERVER_KEY_LEN)
+      return ERROR_INVALID_LENGTH;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   osAcquireMutex(&context->mutex);
+
+   //Save the IP address and the port number of the accounting server
+   context->acctServerIpAddr = *ipAddr;
+   context->acctServerPort = port;
+
+   //Save the shared secret
+   osMemcpy(context->acctKey, key, keyLen);
+   context->acctKeyLen = keyLen;
+
+   //Loop through the accounting records
+   for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE; i++)
+   {
+      //Point to the current record
+      record = &context->acctQueue[i];
+
+      //Accounting is disabled?
+      if(port == 0)
+      {
+         //Discard the records that have not been acknowledged
+         record->state = AUTHENTICATOR_ACCT_RECORD_FREE;
+      }
+      else if(record->state == AUTHENTICATOR_ACCT_RECORD_PENDING)
+      {
+         //The Request Authenticator depends on the shared secret
+         record->state = AUTHENTICATOR_ACCT_RECORD_READY;
+      }
+      else
+      {
+         //Just for sanity
+      }
+   }
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //RADIUS accounting is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Set the interval between interim accounting updates
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] interval Interval between interim updates, in seconds (0 to
+ *   disable interim updates)
+ * @return Error code
+ **/
+
+error_t authenticatorSetAcctInterimInterval(AuthenticatorContext *context,
+   uint_t interval)
+{
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+   //The new value applies to the next interim updates
+   context->acctInterimInterval = interval;
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //RADIUS accounting is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Get RADIUS accounting statistics
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] stats Accounting statistics
+ * @return Error code
+ **/
+
+error_t authenticatorGetAcctStats(AuthenticatorContext *context,
+   AuthenticatorAcctStats *stats)
+{
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   //Check parameters
+   if(context == NULL || stats == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+   //Get accounting statistics
+   *stats = context->acctStats;
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //RADIUS accounting is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Set Dynamic Authorization client
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] ipAddr IP address of the Dynamic Authorization client (the
+ *   unspecified address disables the Dynamic Authorization server)
+ * @param[in] key Pointer to the shared secret
+ * @param[in] keyLen Length of the shared secret
+ * @return Error code
+ **/
+
+error_t authenticatorSetDaeClient(AuthenticatorContext *context,
+   const IpAddr *ipAddr, const uint8_t *key, size_t keyLen)
+{
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+   //Check parameters
+   if(context == NULL || ipAddr == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check parameters
+   if(key == NULL && keyLen != 0)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the length of the key
+   if(keyLen > AUTHENTICATOR_MAX_SERVER_KEY_LEN)
+      return ERROR_INVALID_LENGTH;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Save the IP address of the Dynamic Authorization client
+   context->daeClientIpAddr = *ipAddr;
+
+   //Save the shared secret
+   osMemcpy(context->daeKey, key, keyLen);
+   context->daeKeyLen = keyLen;
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Dynamic Authorization is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Get Dynamic Authorization statistics
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] stats Dynamic Authorization statistics
+ * @return Error code
+ **/
+
+error_t authenticatorGetDaeStats(AuthenticatorContext *context,
+   AuthenticatorDaeStats *stats)
+{
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+   //Check parameters
+   if(context == NULL || stats == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+   //Get Dynamic Authorization statistics
+   *stats = context->daeStats;
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Dynamic Authorization is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Set critical authentication policy
+ *
+ * The policy determines how supplicants are handled when the RADIUS servers
+ * are unreachable or do not answer in time
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] policy Critical authentication policy
+ * @param[in] deadline Time after which eligible supplicants are authenticated
+ *   locally, in seconds (0 to wait for the last retransmission)
+ * @return Error code
+ **/
+
+error_t authenticatorSetCriticalAuthPolicy(AuthenticatorContext *context,
+   AuthenticatorCriticalAuthPolicy policy, uint_t deadline)
+{
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   //Check parameters
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid policy?
+   if(policy != AUTHENTICATOR_CRITICAL_AUTH_DISABLED &&
+      policy != AUTHENTICATOR_CRITICAL_AUTH_CACHED &&
+      policy != AUTHENTICATOR_CRITICAL_AUTH_LOCAL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Save critical authentication parameters
+   context->criticalAuthPolicy = policy;
+   context->criticalAuthDeadline = deadline;
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Local authentication is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Add a user to the local credential store
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] identity NULL-terminated string containing the identity
+ * @param[in] password NULL-terminated string containing the password
+ * @return Error code
+ **/
+
+error_t authenticatorAddLocalUser(AuthenticatorContext *context,
+   const char_t *identity, const char_t *password)
+{
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   error_t error;
+   AuthenticatorLocalUser *user;
+
+   //Check parameters
+   if(context == NULL || identity == NULL || password == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the length of the identity
+   if(osStrlen(identity) == 0 || osStrlen(identity) > AUTHENTICATOR_MAX_ID_LEN)
+      return ERROR_INVALID_LENGTH;
+
+   //Check the length of the password
+   if(osStrlen(password) > AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN)
+      return ERROR_INVALID_LENGTH;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Search the credential store for a matching entry
+   user = authenticatorFindLocalUser(context, identity);
+
+   //No matching entry?
+   if(user == NULL)
+   {
+      //Search the credential store for a free entry
+      user = authenticatorFindLocalUser(context, "");
+   }
+
+   //Any entry available?
+   if(user != NULL)
+   {
+      //Save the credentials of the user
+      osStrcpy(user->identity, identity);
+      osStrcpy(user->password, password);
+
+      //Successful processing
+      error = NO_ERROR;
+   }
+   else
+   {
+      //The credential store is full
+      error = ERROR_OUT_OF_RESOURCES;
+   }
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Return status code
+   return error;
+#else
+   //Local authentication is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Remove a user from the local credential store
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] identity NULL-terminated string containing the identity
+ * @return Error code
+ **/
+
+error_t authenticatorDeleteLocalUser(AuthenticatorContext *context,
+   const char_t *identity)
+{
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   error_t error;
+   AuthenticatorLocalUser *user;
+
+   //Check parameters
+   if(context == NULL || identity == NULL || identity[0] == '\0')
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+
+   //Search the credential store for a matching entry
+   user = authenticatorFindLocalUser(context, identity);
+
+   //Any matching entry?
+   if(user != NULL)
+   {
+      //Clear the credentials of the user
+      osMemset(user, 0, sizeof(AuthenticatorLocalUser));
+      //Successful processing
+      error = NO_ERROR;
+   }
+   else
+   {
+      //The user is not in the credential store
+      error = ERROR_NOT_FOUND;
+   }
+
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Return status code
+   return error;
+#else
+   //Local authentication is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Notify the authenticator that the PRNG has been reseeded
+ *
+ * The random data that has been generated before the reseed is discarded
+ * from the pool. The pool is refilled by the periodic task
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Error code
+ **/
+
+error_t authenticatorNotifyPrngReseed(AuthenticatorContext *context)
+{
+#if (AUTHENTICATOR_RANDOM_POOL_SUPPORT == ENABLED)
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   osAcquireMutex(&context->mutex);
+   //Discard the buffered random data
+   authenticatorFlushRandomPool(context);
+   //Release exclusive access to the 802.1X authenticator context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Random data pool is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Deliver the state changes waiting in the event queue
+ *
+ * This function is called by the consumer registered through the
+ * eventNotification setting. The state change callbacks are invoked from the
+ * calling task, without holding any lock of the 802.1X authenticator
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Error code
+ **/
+
+error_t authenticatorProcessEvents(AuthenticatorContext *context)
+{
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Deliver the queued state changes
+   authenticatorDeliverEvents(context);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Deferred delivery of the state changes is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Read events from the session event stream
+ *
+ * The events are copied out of the rings of the shards without taking any
+ * lock, so that a telemetry task can drain the stream without contending
+ * with the authenticator task. This function must not be called from several
+ * tasks at the same time
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] events Buffer where to copy the events
+ * @param[in] maxEvents Maximum number of events to read
+ * @param[out] numEvents Number of events read
+ * @return Error code
+ **/
+
+error_t authenticatorReadSessionEvents(AuthenticatorContext *context,
+   AuthenticatorSessionEvent *events, uint_t maxEvents, uint_t *numEvents)
+{
+#if (AUTHENTICATOR_SESSION_STREAM_SUPPORT == ENABLED)
+   uint_t i;
+   uint_t n;
+
+   //Check parameters
+   if(context == NULL || events == NULL || numEvents == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Number of events read
+   n = 0;
+
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS && n < maxEvents; i++)
+   {
+      //Drain the ring of the current shard
+      n += authenticatorReadSessionStream(&context->shards[i], events + n,
+         maxEvents - n);
+   }
+
+   //Return the number of events read
+   *numEvents = n;
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //The session event stream is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Get the number of session events discarded because the stream was
+ *   full
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] overflows Number of discarded events
+ * @return Error code
+ **/
+
+error_t authenticatorGetSessionStreamOverflows(AuthenticatorContext *context,
+   uint32_t *overflows)
+{
+#if (AUTHENTICATOR_SESSION_STREAM_SUPPORT == ENABLED)
+   uint_t i;
+
+   //Check parameters
+   if(context == NULL || overflows == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Sum the counters of the shards
+   *overflows = 0;
+
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      *overflows += context->shards[i].streamOverflows;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //The session event stream is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Replay a capture
+ *
+ * The capture must have been written through the capture callback. It is fed
+ * to the authenticator at maximum speed, so that a recorded storm can be used
+ * as a deterministic performance test. The RADIUS responses are signed again
+ * with the shared secret of the configured servers. The authenticator must
+ * not be running
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] replay Pointer to the replay context
+ * @param[in] data Pointer to the pcapng capture
+ * @param[in] length Length of the capture, in bytes
+ * @return Error code
+ **/
+
+error_t authenticatorReplayCapture(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, const uint8_t *data, size_t length)
+{
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   error_t error;
+
+   //Check parameters
+   if(context == NULL || replay == NULL || data == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //The receive buffer of the RADIUS path belongs to the authenticator task,
+   //so the frames must not be processed by the task during the replay
+   if(context->running || context->replaying)
+   {
+      error = ERROR_ALREADY_RUNNING;
+   }
+   else
+   {
+      context->replaying = TRUE;
+      error = NO_ERROR;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The authenticator is running?
+   if(error)
+      return error;
+
+   //Feed the capture to the authenticator
+   error = authenticatorReplayCaptureData(context, replay, data, length);
+
+   //The authenticator can be started again
+   osAcquireMutex(&context->mutex);
+   context->replaying = FALSE;
+   osReleaseMutex(&context->mutex);
+
+   //Return status code
+   return error;
+#else
+   //Capture and replay are not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Reinitialize the specified port
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @return Error code
+ **/
+
+error_t authenticatorInitPort(AuthenticatorContext *context,
+   uint_t portIndex)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetInitialize(context, portIndex, TRUE,
+         TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Force the authenticator to reauthenticate the supplicant
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @return Error code
+ **/
+
+error_t authenticatorReauthenticate(AuthenticatorContext *context,
+   uint_t portIndex)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetReauthenticate(context, portIndex, TRUE,
+         TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Report a change of the link state of a port
+ *
+ * This function is intended to be called from the link change handler of the
+ * switch driver when the linkChangeNotification setting is enabled. When the
+ * context serves several network interfaces, the port index is the switch
+ * port plus the port offset of the interface
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] linkState Link state of the port
+ * @return Error code
+ **/
+
+error_t authenticatorSetLinkState(AuthenticatorContext *context,
+   uint_t portIndex, bool_t linkState)
+{
+   AuthenticatorPort *port;
+
+   //Check parameters
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
+   //Invalid port index?
+   if(port == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorLock(context);
+
+   //Update the value of the portEnabled variable
+   authenticatorUpdateLinkState(port, linkState);
+   //Update the state machines of the port
+   authenticatorRunFsm(port->shard);
+
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorUnlock(context);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Set the value of the AuthControlledPortControl parameter
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] portControl Value of the AuthControlledPortControl parameter
+ * @return Error code
+ **/
+
+error_t authenticatorSetPortControl(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortMode portControl)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
 
       //Perform management operation
       error = authenticatorMgmtSetPortControl(context, portIndex, portControl,
          TRUE);
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
-   }
-   else
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Set the value of the quietPeriod parameter
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] quietPeriod Value of the quietPeriod parameter
+ * @return Error code
+ **/
+
+error_t authenticatorSetQuietPeriod(AuthenticatorContext *context,
+   uint_t portIndex, uint_t quietPeriod)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetQuietPeriod(context, portIndex, quietPeriod,
+         TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Set the value of the serverTimeout parameter
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] serverTimeout Value of the serverTimeout parameter
+ * @return Error code
+ **/
+
+error_t authenticatorSetServerTimeout(AuthenticatorContext *context,
+   uint_t portIndex, uint_t serverTimeout)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetServerTimeout(context, portIndex,
+         serverTimeout, TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Set the value of the reAuthEnabled parameter
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] reAuthEnabled Value of the reAuthEnabled parameter
+ * @return Error code
+ **/
+
+error_t authenticatorSetReAuthEnabled(AuthenticatorContext *context,
+   uint_t portIndex, bool_t reAuthEnabled)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetReAuthEnabled(context, portIndex,
+         reAuthEnabled, TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Set the value of the reAuthPeriod parameter
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[in] reAuthPeriod Value of the reAuthPeriod parameter
+ * @return Error code
+ **/
+
+error_t authenticatorSetReAuthPeriod(AuthenticatorContext *context,
+   uint_t portIndex, uint_t reAuthPeriod)
+{
+   error_t error;
+
+   //Make sure the 802.1X authenticator context is valid
+   if(context != NULL)
+   {
+      //Acquire exclusive access to the 802.1X authenticator context
+      authenticatorLock(context);
+
+      //Perform management operation
+      error = authenticatorMgmtSetReAuthPeriod(context, portIndex,
+         reAuthPeriod, TRUE);
+
+      //Release exclusive access to the 802.1X authenticator context
+      authenticatorUnlock(context);
+   }
+   else
+   {
+      //Report an error
+      error = ERROR_INVALID_PARAMETER;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Get a consistent snapshot of the state of a port
+ *
+ * The snapshot is read without locking the port. Should the task that owns
+ * the port keep updating it, the mutex of the shard is acquired as a last
+ * resort
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[out] snapshot State, configuration and statistics of the port
+ * @return Error code
+ **/
+
+error_t authenticatorGetPortSnapshot(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortSnapshot *snapshot)
+{
+   uint_t i;
+   uint_t seq;
+   AuthenticatorPort *port;
+
+   //Check parameters
+   if(context == NULL || snapshot == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
+   //Invalid port index?
+   if(port == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Try to read the snapshot without locking the port
+   for(i = 0; i < AUTHENTICATOR_SNAPSHOT_MAX_RETRIES; i++)
+   {
+      //Retrieve the sequence number before reading the snapshot
+      seq = port->data->snapshotSeq;
+      AUTHENTICATOR_MEMORY_BARRIER();
+
+      //Copy the snapshot
+      osMemcpy(snapshot, &port->data->snapshot,
+         sizeof(AuthenticatorPortSnapshot));
+
+      //The snapshot is consistent if no update took place in the meantime
+      AUTHENTICATOR_MEMORY_BARRIER();
+      if((seq & 1) == 0 && seq == port->data->snapshotSeq)
+         return NO_ERROR;
+   }
+
+   //The snapshot is only updated by a task that holds the mutex of the shard
+   osAcquireMutex(&port->shard->mutex);
+   //Copy the snapshot
+   osMemcpy(snapshot, &port->data->snapshot,
+      sizeof(AuthenticatorPortSnapshot));
+   //Release exclusive access to the ports of the shard
+   osReleaseMutex(&port->shard->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get the current change generation
+ *
+ * The generation is advanced each time authPaeState or authPortStatus
+ * changes on any port. It is read without locking the context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] generation Current change generation
+ * @return Error code
+ **/
+
+error_t authenticatorGetChangeGeneration(AuthenticatorContext *context,
+   uint32_t *generation)
+{
+   //Check parameters
+   if(context == NULL || generation == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get the current change generation
+   *generation = context->changeGeneration;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get the ports that have changed since a given generation
+ *
+ * A management application polls the full tables once, then only fetches
+ * the rows of the ports returned by this function, passing the generation
+ * returned by the previous call. ERROR_BUFFER_OVERFLOW is returned when
+ * more than maxPorts ports have changed, in which case the tables should be
+ * walked again
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] generation Generation returned by the previous call (0 to get
+ *   all the ports that have ever changed)
+ * @param[out] portIndexes Indexes of the ports that have changed
+ * @param[in] maxPorts Maximum number of entries in the portIndexes array
+ * @param[out] numPorts Number of ports that have changed
+ * @param[out] currentGeneration Generation to pass to the next call
+ * @return Error code
+ **/
+
+error_t authenticatorGetChangedPorts(AuthenticatorContext *context,
+   uint32_t generation, uint_t *portIndexes, uint_t maxPorts, uint_t *numPorts,
+   uint32_t *currentGeneration)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   AuthenticatorPort *port;
+
+   //Check parameters
+   if(context == NULL || portIndexes == NULL || numPorts == NULL ||
+      currentGeneration == NULL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Loop through the ports
+   for(n = 0, i = 0; i < context->numPorts; i++)
+   {
+      //Point to the current port
+      port = &context->ports[i];
+
+      //The generations wrap around
+      if((int32_t) (port->data->changeGeneration - generation) > 0)
+      {
+         //Make sure the array is large enough
+         if(n >= maxPorts)
+         {
+            error = ERROR_BUFFER_OVERFLOW;
+            break;
+         }
+
+         //Save the index of the port
+         portIndexes[n++] = port->portIndex;
+      }
+   }
+
+   //Return the generation the ports have been compared against
+   *currentGeneration = context->changeGeneration;
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return the number of ports that have changed
+   *numPorts = n;
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Export the state of a port
+ *
+ * A port is reported as authorized when the supplicant has successfully
+ * authenticated. The exported state can be saved to non-volatile memory
+ * before a restart of the authenticator
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[out] state Authorization state and session statistics of the port
+ * @return Error code
+ **/
+
+error_t authenticatorExportPortState(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortState *state)
+{
+   AuthenticatorPort *port;
+
+   //Check parameters
+   if(context == NULL || state == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
+   //Invalid port index?
+   if(port == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Clear exported state
+   osMemset(state, 0, sizeof(AuthenticatorPortState));
+
+   //Acquire exclusive access to the ports of the shard
+   osAcquireMutex(&port->shard->mutex);
+
+   //Check whether the supplicant has been authenticated
+   if(port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+      port->authPaeState == AUTHENTICATOR_PAE_STATE_AUTHENTICATED)
    {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
+      //The controlled port is authorized
+      state->authorized = TRUE;
+
+      //Save the identity of the supplicant
+      macCopyAddr(&state->supplicantMacAddr, &port->supplicantMacAddr);
+      osStrcpy(state->aaaIdentity, port->data->aaaIdentity);
+
+      //Save the time remaining before reauthentication
+      if(port->reAuthEnabled)
+      {
+         state->reAuthWhen = authenticatorGetTimerRemaining(port,
+            AUTHENTICATOR_TIMER_REAUTH_WHEN);
+      }
    }
 
-   //Return status code
-   return error;
+   //Save session statistics
+   state->sessionStats = port->data->sessionStats;
+
+   //Release exclusive access to the ports of the shard
+   osReleaseMutex(&port->shard->mutex);
+
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Set the value of the quietPeriod parameter
+ * @brief Import the state of a port
+ *
+ * The port resumes in the AUTHENTICATED state without exchanging any EAP
+ * message with the supplicant. This function must be called after the
+ * authenticator has been started, before the supplicant has initiated a new
+ * authentication session. The link is assumed to be up, and the port is
+ * unauthorized again if the link is found down
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[in] quietPeriod Value of the quietPeriod parameter
+ * @param[in] state Exported state of the port
  * @return Error code
  **/
 
-error_t authenticatorSetQuietPeriod(AuthenticatorContext *context,
-   uint_t portIndex, uint_t quietPeriod)
+error_t authenticatorImportPortState(AuthenticatorContext *context,
+   uint_t portIndex, const AuthenticatorPortState *state)
 {
    error_t error;
+   size_t n;
+   AuthenticatorPort *port;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || state == NULL)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetQuietPeriod(context, portIndex, quietPeriod,
-         TRUE);
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
+   //Invalid port index?
+   if(port == NULL)
+      return ERROR_INVALID_PORT;
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
+   //The state machines are reinitialized when the authenticator is started
+   if(!context->running)
+      return ERROR_WRONG_STATE;
+
+   //Unauthorized ports authenticate as usual
+   if(!state->authorized)
+      return NO_ERROR;
+
+   //Acquire exclusive access to the ports of the shard
+   osAcquireMutex(&port->shard->mutex);
+
+   //The state can only be restored on a port that is controlled by the
+   //authenticator and that has not started authenticating yet
+   if(port->portControl != AUTHENTICATOR_PORT_MODE_AUTO)
+   {
+      error = ERROR_WRONG_STATE;
+   }
+   else if(port->authPaeState != AUTHENTICATOR_PAE_STATE_INITIALIZE &&
+      port->authPaeState != AUTHENTICATOR_PAE_STATE_DISCONNECTED &&
+      port->authPaeState != AUTHENTICATOR_PAE_STATE_CONNECTING)
+   {
+      error = ERROR_WRONG_STATE;
+   }
+   else if(port->authBackendState != AUTHENTICATOR_BACKEND_STATE_INITIALIZE &&
+      port->authBackendState != AUTHENTICATOR_BACKEND_STATE_IDLE)
+   {
+      error = ERROR_WRONG_STATE;
    }
    else
    {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
+      //The link is assumed to be up. Should it be down, the port failure is
+      //detected the next time the link state is polled
+      port->portEnabled = TRUE;
+
+      //Restore the identity of the supplicant
+      macCopyAddr(&port->supplicantMacAddr, &state->supplicantMacAddr);
+      n = osStrlen(state->aaaIdentity);
+      n = MIN(n, AUTHENTICATOR_MAX_ID_LEN);
+      osMemcpy(port->data->aaaIdentity, state->aaaIdentity, n);
+      port->data->aaaIdentity[n] = '\0';
+
+      //Restore session statistics
+      port->data->sessionStats = state->sessionStats;
+
+      //The invariant RADIUS attributes must be formatted again
+      authenticatorInvalidateRadiusTemplate(port);
+
+      //Authorize the controlled port
+      authenticatorResumeSession(port);
+
+      //Resume the reauthentication timer where it was left
+      if(state->reAuthWhen > 0 &&
+         state->reAuthWhen < authenticatorGetReauthPeriod(port))
+      {
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+            state->reAuthWhen);
+      }
+
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
+
+      //Successful processing
+      error = NO_ERROR;
    }
 
+   //Release exclusive access to the ports of the shard
+   osReleaseMutex(&port->shard->mutex);
+
    //Return status code
    return error;
 }
 
 
 /**
- * @brief Set the value of the serverTimeout parameter
+ * @brief Get the current value of the AuthControlledPortControl parameter
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[in] serverTimeout Value of the serverTimeout parameter
+ * @param[out] portControl value of the AuthControlledPortControl parameter
  * @return Error code
  **/
 
-error_t authenticatorSetServerTimeout(AuthenticatorContext *context,
-   uint_t portIndex, uint_t serverTimeout)
+error_t authenticatorGetPortControl(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortMode *portControl)
 {
-   error_t error;
+   AuthenticatorPortSnapshot snapshot;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || portControl == NULL)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetServerTimeout(context, portIndex,
-         serverTimeout, TRUE);
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
-   }
-   else
-   {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
-   }
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current value of the parameter
+   *portControl = snapshot.portControl;
 
-   //Return status code
-   return error;
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Set the value of the reAuthEnabled parameter
+ * @brief Get the current value of the quietPeriod parameter
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[in] reAuthEnabled Value of the reAuthEnabled parameter
+ * @param[out] quietPeriod value of the quietPeriod parameter
  * @return Error code
  **/
 
-error_t authenticatorSetReAuthEnabled(AuthenticatorContext *context,
-   uint_t portIndex, bool_t reAuthEnabled)
+error_t authenticatorGetQuietPeriod(AuthenticatorContext *context,
+   uint_t portIndex, uint_t *quietPeriod)
 {
-   error_t error;
+   AuthenticatorPortSnapshot snapshot;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || quietPeriod == NULL)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetReAuthEnabled(context, portIndex,
-         reAuthEnabled, TRUE);
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
-   }
-   else
-   {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
-   }
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current value of the parameter
+   *quietPeriod = snapshot.quietPeriod;
 
-   //Return status code
-   return error;
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Set the value of the reAuthPeriod parameter
+ * @brief Get the current value of the serverTimeout parameter
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[in] reAuthPeriod Value of the reAuthPeriod parameter
+ * @param[out] serverTimeout value of the serverTimeout parameter
  * @return Error code
  **/
 
-error_t authenticatorSetReAuthPeriod(AuthenticatorContext *context,
-   uint_t portIndex, uint_t reAuthPeriod)
+error_t authenticatorGetServerTimeout(AuthenticatorContext *context,
+   uint_t portIndex, uint_t *serverTimeout)
 {
-   error_t error;
+   AuthenticatorPortSnapshot snapshot;
 
-   //Make sure the 802.1X authenticator context is valid
-   if(context != NULL)
-   {
-      //Acquire exclusive access to the 802.1X authenticator context
-      osAcquireMutex(&context->mutex);
+   //Check parameters
+   if(context == NULL || serverTimeout == NULL)
+      return ERROR_INVALID_PARAMETER;
 
-      //Perform management operation
-      error = authenticatorMgmtSetReAuthPeriod(context, portIndex,
-         reAuthPeriod, TRUE);
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
 
-      //Release exclusive access to the 802.1X authenticator context
-      osReleaseMutex(&context->mutex);
-   }
-   else
-   {
-      //Report an error
-      error = ERROR_INVALID_PARAMETER;
-   }
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current value of the parameter
+   *serverTimeout = snapshot.serverTimeout;
 
-   //Return status code
-   return error;
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Get the current value of the AuthControlledPortControl parameter
+ * @brief Get the current value of the reAuthEnabled parameter
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[out] portControl value of the AuthControlledPortControl parameter
+ * @param[out] reAuthEnabled value of the reAuthEnabled parameter
  * @return Error code
  **/
 
-error_t authenticatorGetPortControl(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorPortMode *portControl)
+error_t authenticatorGetReAuthEnabled(AuthenticatorContext *context,
+   uint_t portIndex, bool_t *reAuthEnabled)
 {
+   AuthenticatorPortSnapshot snapshot;
+
    //Check parameters
-   if(context == NULL || portControl == NULL)
+   if(context == NULL || reAuthEnabled == NULL)
       return ERROR_INVALID_PARAMETER;
 
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(authenticatorFindPort(context, portIndex) == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
    //Get the current value of the parameter
-   *portControl = context->ports[portIndex - 1].portControl;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   *reAuthEnabled = snapshot.reAuthEnabled;
 
    //Successful processing
    return NO_ERROR;
@@ -586,30 +2586,124 @@ error_t authenticatorGetPortControl(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current value of the quietPeriod parameter
+ * @brief Get the current value of the reAuthPeriod parameter
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[out] quietPeriod value of the quietPeriod parameter
+ * @param[out] reAuthPeriod value of the reAuthPeriod parameter
  * @return Error code
  **/
 
-error_t authenticatorGetQuietPeriod(AuthenticatorContext *context,
-   uint_t portIndex, uint_t *quietPeriod)
+error_t authenticatorGetReAuthPeriod(AuthenticatorContext *context,
+   uint_t portIndex, uint_t *reAuthPeriod)
+{
+   AuthenticatorPortSnapshot snapshot;
+
+   //Check parameters
+   if(context == NULL || reAuthPeriod == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current value of the parameter
+   *reAuthPeriod = snapshot.reAuthPeriod;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get the current value of the AuthControlledPortStatus variable
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[out] portStatus Current value of the AuthControlledPortStatus variable
+ * @return Error code
+ **/
+
+error_t authenticatorGetPortStatus(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortStatus *portStatus)
+{
+   AuthenticatorPortSnapshot snapshot;
+
+   //Check parameters
+   if(context == NULL || portStatus == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current value of the variable
+   *portStatus = snapshot.authPortStatus;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get the current state of the authenticator PAE state state machine
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[out] paeState Current state of the authenticator PAE state machine
+ * @return Error code
+ **/
+
+error_t authenticatorGetPaeState(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPaeState *paeState)
+{
+   AuthenticatorPortSnapshot snapshot;
+
+   //Check parameters
+   if(context == NULL || paeState == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid port index?
+   if(authenticatorFindPort(context, portIndex) == NULL)
+      return ERROR_INVALID_PORT;
+
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current state
+   *paeState = snapshot.authPaeState;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Get the current state of the backend authentication state machine
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @param[out] backendState Current state of the backend authentication state
+ *   machine
+ * @return Error code
+ **/
+
+error_t authenticatorGetBackendState(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorBackendState *backendState)
 {
+   AuthenticatorPortSnapshot snapshot;
+
    //Check parameters
-   if(context == NULL || quietPeriod == NULL)
+   if(context == NULL || backendState == NULL)
       return ERROR_INVALID_PARAMETER;
 
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(authenticatorFindPort(context, portIndex) == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current value of the parameter
-   *quietPeriod = context->ports[portIndex - 1].quietPeriod;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current state
+   *backendState = snapshot.authBackendState;
 
    //Successful processing
    return NO_ERROR;
@@ -617,30 +2711,31 @@ error_t authenticatorGetQuietPeriod(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current value of the serverTimeout parameter
+ * @brief Get the current state of the reauthentication timer state machine
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[out] serverTimeout value of the serverTimeout parameter
+ * @param[out] reauthTimerState Current state of the reauthentication timer state
+ *   machine
  * @return Error code
  **/
 
-error_t authenticatorGetServerTimeout(AuthenticatorContext *context,
-   uint_t portIndex, uint_t *serverTimeout)
+error_t authenticatorGetReauthTimerState(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorReauthTimerState *reauthTimerState)
 {
+   AuthenticatorPortSnapshot snapshot;
+
    //Check parameters
-   if(context == NULL || serverTimeout == NULL)
+   if(context == NULL || reauthTimerState == NULL)
       return ERROR_INVALID_PARAMETER;
 
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(authenticatorFindPort(context, portIndex) == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current value of the parameter
-   *serverTimeout = context->ports[portIndex - 1].serverTimeout;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current state
+   *reauthTimerState = snapshot.reauthTimerState;
 
    //Successful processing
    return NO_ERROR;
@@ -648,30 +2743,31 @@ error_t authenticatorGetServerTimeout(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current value of the reAuthEnabled parameter
+ * @brief Get the current state of the EAP full authenticator state machine
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[out] reAuthEnabled value of the reAuthEnabled parameter
+ * @param[out] eapFullAuthState Current state of the EAP full authenticator state
+ *   machine
  * @return Error code
  **/
 
-error_t authenticatorGetReAuthEnabled(AuthenticatorContext *context,
-   uint_t portIndex, bool_t *reAuthEnabled)
+error_t authenticatorGetEapFullAuthState(AuthenticatorContext *context,
+   uint_t portIndex, EapFullAuthState *eapFullAuthState)
 {
+   AuthenticatorPortSnapshot snapshot;
+
    //Check parameters
-   if(context == NULL || reAuthEnabled == NULL)
+   if(context == NULL || eapFullAuthState == NULL)
       return ERROR_INVALID_PARAMETER;
 
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(authenticatorFindPort(context, portIndex) == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current value of the parameter
-   *reAuthEnabled = context->ports[portIndex - 1].reAuthEnabled;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //Read the latest snapshot of the port
+   authenticatorGetPortSnapshot(context, portIndex, &snapshot);
+   //Get the current state
+   *eapFullAuthState = snapshot.eapFullAuthState;
 
    //Successful processing
    return NO_ERROR;
@@ -679,30 +2775,25 @@ error_t authenticatorGetReAuthEnabled(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current value of the reAuthPeriod parameter
+ * @brief Enable or disable the recording of trace events
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[out] reAuthPeriod value of the reAuthPeriod parameter
+ * @param[in] enabled Recording of trace events is enabled
  * @return Error code
  **/
 
-error_t authenticatorGetReAuthPeriod(AuthenticatorContext *context,
-   uint_t portIndex, uint_t *reAuthPeriod)
+error_t authenticatorSetTraceEnabled(AuthenticatorContext *context,
+   bool_t enabled)
 {
-   //Check parameters
-   if(context == NULL || reAuthPeriod == NULL)
+   //Make sure the 802.1X authenticator context is valid
+   if(context == NULL)
       return ERROR_INVALID_PARAMETER;
 
-   //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
-      return ERROR_INVALID_PORT;
-
    //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current value of the parameter
-   *reAuthPeriod = context->ports[portIndex - 1].reAuthPeriod;
+   authenticatorLock(context);
+   //Save the setting
+   context->traceEnabled = enabled;
    //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   authenticatorUnlock(context);
 
    //Successful processing
    return NO_ERROR;
@@ -710,30 +2801,61 @@ error_t authenticatorGetReAuthPeriod(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current value of the AuthControlledPortStatus variable
+ * @brief Read the trace ring of a port
+ *
+ * The records are returned from the oldest to the most recent one. Dumping
+ * the records in binary form lets offline tools decode them
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
  * @param[in] portIndex Port index
- * @param[out] portStatus Current value of the AuthControlledPortStatus variable
+ * @param[out] records Buffer where to copy the records
+ * @param[in] maxRecords Maximum number of records the buffer can hold
+ * @param[out] numRecords Number of records that have been copied
  * @return Error code
  **/
 
-error_t authenticatorGetPortStatus(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorPortStatus *portStatus)
+error_t authenticatorReadTraceRing(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorTraceRecord *records, uint_t maxRecords,
+   uint_t *numRecords)
 {
+   uint_t i;
+   uint_t n;
+   uint_t first;
+   AuthenticatorPort *port;
+
    //Check parameters
-   if(context == NULL || portStatus == NULL)
+   if(context == NULL || records == NULL || numRecords == NULL)
       return ERROR_INVALID_PARAMETER;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current value of the variable
-   *portStatus = context->ports[portIndex - 1].authPortStatus;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //The trace ring is updated by the task that owns the port
+   osAcquireMutex(&port->shard->mutex);
+
+   //Number of records available in the ring
+   n = MIN(port->data->traceCount, AUTHENTICATOR_TRACE_RING_SIZE);
+   //Only the most recent records are returned when the buffer is too small
+   n = MIN(n, maxRecords);
+
+   //Index of the oldest record to be returned
+   first = port->data->traceCount - n;
+
+   //Copy the records in chronological order
+   for(i = 0; i < n; i++)
+   {
+      records[i] = port->data->traceRing[(first + i) %
+         AUTHENTICATOR_TRACE_RING_SIZE];
+   }
+
+   //Release exclusive access to the ports of the shard
+   osReleaseMutex(&port->shard->mutex);
+
+   //Return the number of records
+   *numRecords = n;
 
    //Successful processing
    return NO_ERROR;
@@ -741,124 +2863,176 @@ error_t authenticatorGetPortStatus(AuthenticatorContext *context,
 
 
 /**
- * @brief Get the current state of the authenticator PAE state state machine
+ * @brief Get the cycle counts of the profiled code paths
+ *
+ * The cycle counts recorded by the authenticator task and by the shards are
+ * aggregated. A call to authenticatorPortFsm includes the cycles spent in
+ * authenticatorBuildRadiusRequest. The calls of authenticatorProcessEapolPdu
+ * and authenticatorProcessRadiusPacket that find the socket empty are also
+ * accounted for
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[out] paeState Current state of the authenticator PAE state machine
+ * @param[out] entries Cycle counts, indexed by profiled code path
+ *   (AUTHENTICATOR_NUM_PROFILE_POINTS entries)
  * @return Error code
  **/
 
-error_t authenticatorGetPaeState(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorPaeState *paeState)
+error_t authenticatorGetProfileStats(AuthenticatorContext *context,
+   AuthenticatorProfileEntry *entries)
 {
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   uint_t i;
+   uint_t j;
+   AuthenticatorProfileEntry shardEntries[AUTHENTICATOR_NUM_PROFILE_POINTS];
+
    //Check parameters
-   if(context == NULL || paeState == NULL)
+   if(context == NULL || entries == NULL)
       return ERROR_INVALID_PARAMETER;
 
-   //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
-      return ERROR_INVALID_PORT;
+   //Copy the cycle counts recorded by the authenticator task
+   authenticatorReadProfile(&context->profile, entries);
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current state
-   *paeState = context->ports[portIndex - 1].authPaeState;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      //Copy the cycle counts recorded by the shard
+      authenticatorReadProfile(&context->shards[i].profile, shardEntries);
+
+      //Aggregate the cycle counts
+      for(j = 0; j < AUTHENTICATOR_NUM_PROFILE_POINTS; j++)
+      {
+         authenticatorMergeProfile(&entries[j], &shardEntries[j]);
+      }
+   }
 
    //Successful processing
    return NO_ERROR;
+#else
+   //Profiling is not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
 }
 
 
 /**
- * @brief Get the current state of the backend authentication state machine
+ * @brief Get the latency histogram of a given interval
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[out] backendState Current state of the backend authentication state
- *   machine
+ * @param[in] portIndex Port index (0 to aggregate the histograms of all the
+ *   ports)
+ * @param[in] stage Measured interval
+ * @param[out] histogram Distribution of the measured latencies
  * @return Error code
  **/
 
-error_t authenticatorGetBackendState(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorBackendState *backendState)
+error_t authenticatorGetLatencyStats(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorLatencyStage stage,
+   AuthenticatorHistogram *histogram)
 {
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+   uint_t i;
+   AuthenticatorPort *port;
+
    //Check parameters
-   if(context == NULL || backendState == NULL)
+   if(context == NULL || histogram == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Invalid interval?
+   if(stage >= AUTHENTICATOR_NUM_LATENCY_STAGES)
       return ERROR_INVALID_PARAMETER;
 
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(portIndex != 0 && authenticatorFindPort(context, portIndex) == NULL)
       return ERROR_INVALID_PORT;
 
-   //Acquire exclusive access to the 802.1X authenticator context
-   osAcquireMutex(&context->mutex);
-   //Get the current state
-   *backendState = context->ports[portIndex - 1].authBackendState;
-   //Release exclusive access to the 802.1X authenticator context
-   osReleaseMutex(&context->mutex);
+   //Clear histogram
+   osMemset(histogram, 0, sizeof(AuthenticatorHistogram));
+
+   //Loop through the ports
+   for(i = 0; i < context->numPorts; i++)
+   {
+      //Point to the current port
+      port = &context->ports[i];
+
+      //Matching port?
+      if(portIndex == 0 || portIndex == port->portIndex)
+      {
+         //The histograms are updated by the task that owns the port
+         osAcquireMutex(&port->shard->mutex);
+         //Add the samples of the port
+         authenticatorMergeHistogram(histogram, &port->data->latency[stage]);
+         //Release exclusive access to the ports of the shard
+         osReleaseMutex(&port->shard->mutex);
+      }
+   }
 
    //Successful processing
    return NO_ERROR;
+#else
+   //Latency statistics are not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
 }
 
 
 /**
- * @brief Get the current state of the reauthentication timer state machine
+ * @brief Get the round-trip time histogram of a RADIUS server
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[out] reauthTimerState Current state of the reauthentication timer state
- *   machine
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[out] histogram Distribution of the measured round-trip times
  * @return Error code
  **/
 
-error_t authenticatorGetReauthTimerState(AuthenticatorContext *context,
-   uint_t portIndex, AuthenticatorReauthTimerState *reauthTimerState)
+error_t authenticatorGetServerRttStats(AuthenticatorContext *context,
+   uint_t serverIndex, AuthenticatorHistogram *histogram)
 {
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
    //Check parameters
-   if(context == NULL || reauthTimerState == NULL)
+   if(context == NULL || histogram == NULL)
       return ERROR_INVALID_PARAMETER;
 
-   //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
-      return ERROR_INVALID_PORT;
+   //Invalid server index?
+   if(serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
 
    //Acquire exclusive access to the 802.1X authenticator context
    osAcquireMutex(&context->mutex);
-   //Get the current state
-   *reauthTimerState = context->ports[portIndex - 1].reauthTimerState;
+   //Get the distribution of the round-trip times
+   *histogram = context->servers[serverIndex].rttHistogram;
    //Release exclusive access to the 802.1X authenticator context
    osReleaseMutex(&context->mutex);
 
    //Successful processing
    return NO_ERROR;
+#else
+   //Latency statistics are not supported
+   return ERROR_NOT_IMPLEMENTED;
+#endif
 }
 
 
 /**
- * @brief Get the current state of the EAP full authenticator state machine
+ * @brief Get the retransmission timeout of a RADIUS server
  * @param[in] context Pointer to the 802.1X authenticator context
- * @param[in] portIndex Port index
- * @param[out] eapFullAuthState Current state of the EAP full authenticator state
- *   machine
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[out] rto Initial retransmission timeout, in milliseconds
  * @return Error code
  **/
 
-error_t authenticatorGetEapFullAuthState(AuthenticatorContext *context,
-   uint_t portIndex, EapFullAuthState *eapFullAuthState)
+error_t authenticatorGetServerRto(AuthenticatorContext *context,
+   uint_t serverIndex, systime_t *rto)
 {
    //Check parameters
-   if(context == NULL || eapFullAuthState == NULL)
+   if(context == NULL || rto == NULL)
       return ERROR_INVALID_PARAMETER;
 
-   //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
-      return ERROR_INVALID_PORT;
+   //Invalid server index?
+   if(serverIndex >= AUTHENTICATOR_MAX_RADIUS_SERVERS)
+      return ERROR_INVALID_PARAMETER;
 
    //Acquire exclusive access to the 802.1X authenticator context
    osAcquireMutex(&context->mutex);
-   //Get the current state
-   *eapFullAuthState = context->ports[portIndex - 1].eapFullAuthState;
+   //Get the current value of the retransmission timeout
+   *rto = context->servers[serverIndex].rto;
    //Release exclusive access to the 802.1X authenticator context
    osReleaseMutex(&context->mutex);
 
@@ -876,6 +3050,7 @@ error_t authenticatorGetEapFullAuthState(AuthenticatorContext *context,
 error_t authenticatorStart(AuthenticatorContext *context)
 {
    error_t error;
+   uint_t i;
 
    //Make sure the 802.1X authenticator context is valid
    if(context == NULL)
@@ -888,14 +3063,68 @@ error_t authenticatorStart(AuthenticatorContext *context)
    if(context->running)
       return ERROR_ALREADY_RUNNING;
 
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   //The task must not be started while a capture is being replayed
+   osAcquireMutex(&context->mutex);
+   error = context->replaying ? ERROR_ALREADY_RUNNING : NO_ERROR;
+   osReleaseMutex(&context->mutex);
+
+   //A replay is in progress?
+   if(error)
+      return error;
+#endif
+
+   //Initialize status code
+   error = NO_ERROR;
+
    //Start of exception handling block
    do
    {
-      //Open a UDP socket
-      context->serverSocket = socketOpenEx(context->netContext,
+      //Each UDP socket provides its own 8-bit Identifier space, so that more
+      //than 256 Access-Requests can be outstanding at the same time
+      for(i = 0; i < AUTHENTICATOR_NUM_RADIUS_SOCKETS && !error; i++)
+      {
+         //Open a UDP socket
+         context->serverSocket[i] = socketOpenEx(context->netContext,
+            SOCKET_TYPE_DGRAM, SOCKET_IP_PROTO_UDP);
+         //Failed to open socket?
+         if(context->serverSocket[i] == NULL)
+         {
+            //Report an error
+            error = ERROR_OPEN_FAILED;
+            break;
+         }
+
+         //Force the socket to operate in non-blocking mode
+         error = socketSetTimeout(context->serverSocket[i], 0);
+
+         //Check status code
+         if(!error)
+         {
+            //Associate the socket with the relevant interface
+            error = socketBindToInterface(context->serverSocket[i],
+               context->serverInterface);
+         }
+      }
+
+      //Any error to report?
+      if(error)
+         break;
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+      //Acct-Session-Id values must be unique across reboots
+      error = context->prngAlgo->generate(context->prngContext,
+         (uint8_t *) &context->acctSessionId, sizeof(uint32_t));
+      //Any error to report?
+      if(error)
+         break;
+
+      //Accounting-Request packets are sent from a dedicated UDP socket, so
+      //that they never compete with the Access-Request packets
+      context->acctSocket = socketOpenEx(context->netContext,
          SOCKET_TYPE_DGRAM, SOCKET_IP_PROTO_UDP);
       //Failed to open socket?
-      if(context->serverSocket == NULL)
+      if(context->acctSocket == NULL)
       {
          //Report an error
          error = ERROR_OPEN_FAILED;
@@ -903,23 +3132,26 @@ error_t authenticatorStart(AuthenticatorContext *context)
       }
 
       //Force the socket to operate in non-blocking mode
-      error = socketSetTimeout(context->serverSocket, 0);
+      error = socketSetTimeout(context->acctSocket, 0);
       //Any error to report?
       if(error)
          break;
 
       //Associate the socket with the relevant interface
-      error = socketBindToInterface(context->serverSocket,
+      error = socketBindToInterface(context->acctSocket,
          context->serverInterface);
       //Any error to report?
       if(error)
          break;
+#endif
 
-      //Open a raw socket
-      context->peerSocket = socketOpenEx(context->netContext,
-         SOCKET_TYPE_RAW_ETH, ETH_TYPE_EAPOL);
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+      //Disconnect-Request and CoA-Request packets are received on a
+      //dedicated UDP socket (refer to RFC 5176, section 2.3)
+      context->daeSocket = socketOpenEx(context->netContext,
+         SOCKET_TYPE_DGRAM, SOCKET_IP_PROTO_UDP);
       //Failed to open socket?
-      if(context->peerSocket == NULL)
+      if(context->daeSocket == NULL)
       {
          //Report an error
          error = ERROR_OPEN_FAILED;
@@ -927,13 +3159,53 @@ error_t authenticatorStart(AuthenticatorContext *context)
       }
 
       //Force the socket to operate in non-blocking mode
-      error = socketSetTimeout(context->peerSocket, 0);
+      error = socketSetTimeout(context->daeSocket, 0);
       //Any error to report?
       if(error)
          break;
 
       //Associate the socket with the relevant interface
-      error = socketBindToInterface(context->peerSocket, context->interface);
+      error = socketBindToInterface(context->daeSocket,
+         context->serverInterface);
+      //Any error to report?
+      if(error)
+         break;
+
+      //The Dynamic Authorization server listens on UDP port 3799
+      error = socketBind(context->daeSocket, &IP_ADDR_ANY, context->daePort);
+      //Any error to report?
+      if(error)
+         break;
+#endif
+
+      //Each network interface has its own raw socket
+      for(i = 0; i < context->numInterfaces; i++)
+      {
+         //Open a raw socket
+         context->interfaces[i].socket = socketOpenEx(context->netContext,
+            SOCKET_TYPE_RAW_ETH, ETH_TYPE_EAPOL);
+         //Failed to open socket?
+         if(context->interfaces[i].socket == NULL)
+         {
+            //Report an error
+            error = ERROR_OPEN_FAILED;
+            break;
+         }
+
+         //Force the socket to operate in non-blocking mode
+         error = socketSetTimeout(context->interfaces[i].socket, 0);
+         //Any error to report?
+         if(error)
+            break;
+
+         //Associate the socket with the relevant interface
+         error = socketBindToInterface(context->interfaces[i].socket,
+            context->interfaces[i].interface);
+         //Any error to report?
+         if(error)
+            break;
+      }
+
       //Any error to report?
       if(error)
          break;
@@ -956,6 +3228,12 @@ error_t authenticatorStart(AuthenticatorContext *context)
       //Reinitialize authenticator state machine
       authenticatorInitFsm(context);
 
+      //Start the shard tasks
+      error = authenticatorStartShards(context);
+      //Any error to report?
+      if(error)
+         break;
+
       //Create a task
       context->taskId = osCreateTask("Authenticator", (OsTaskCode) authenticatorTask,
          context, &context->taskParams);
@@ -974,25 +3252,56 @@ error_t authenticatorStart(AuthenticatorContext *context)
    //Any error to report?
    if(error)
    {
+      //Terminate the shard tasks that have been started
+      context->stop = TRUE;
+      authenticatorStopShards(context);
+
       //Clean up side effects
       context->running = FALSE;
 
       //Remove the PAE group address from the static MAC table
       authenticatorDropPaeGroupAddr(context);
 
-      //Close the raw socket
-      if(context->peerSocket != NULL)
+      //Close the raw sockets
+      for(i = 0; i < context->numInterfaces; i++)
+      {
+         if(context->interfaces[i].socket != NULL)
+         {
+            socketClose(context->interfaces[i].socket);
+            context->interfaces[i].socket = NULL;
+         }
+      }
+
+      //Close the UDP sockets
+      for(i = 0; i < AUTHENTICATOR_NUM_RADIUS_SOCKETS; i++)
+      {
+         if(context->serverSocket[i] != NULL)
+         {
+            socketClose(context->serverSocket[i]);
+            context->serverSocket[i] = NULL;
+         }
+      }
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+      //Close the accounting socket
+      if(context->acctSocket != NULL)
       {
-         socketClose(context->peerSocket);
-         context->peerSocket = NULL;
+         socketClose(context->acctSocket);
+         context->acctSocket = NULL;
       }
+#endif
 
-      //Close the UDP socket
-      if(context->serverSocket != NULL)
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+      //Close the Dynamic Authorization socket
+      if(context->daeSocket != NULL)
       {
-         socketClose(context->serverSocket);
-         context->serverSocket = NULL;
+         socketClose(context->daeSocket);
+         context->daeSocket = NULL;
       }
+#endif
+
+      //Close the TLS connections to the RADIUS servers
+      authenticatorCloseRadsecConns(context);
    }
 
    //Return status code
@@ -1008,6 +3317,8 @@ error_t authenticatorStart(AuthenticatorContext *context)
 
 error_t authenticatorStop(AuthenticatorContext *context)
 {
+   uint_t i;
+
    //Make sure the 802.1X authenticator context is valid
    if(context == NULL)
       return ERROR_INVALID_PARAMETER;
@@ -1029,18 +3340,42 @@ error_t authenticatorStop(AuthenticatorContext *context)
       {
          osDelayTask(1);
       }
+
+      //Wait for the shard tasks to terminate
+      authenticatorStopShards(context);
 #endif
 
       //Remove the PAE group address from the static MAC table
       authenticatorDropPaeGroupAddr(context);
 
-      //Close the raw socket
-      socketClose(context->peerSocket);
-      context->peerSocket = NULL;
+      //Close the raw sockets
+      for(i = 0; i < context->numInterfaces; i++)
+      {
+         socketClose(context->interfaces[i].socket);
+         context->interfaces[i].socket = NULL;
+      }
+
+      //Close the UDP sockets
+      for(i = 0; i < AUTHENTICATOR_NUM_RADIUS_SOCKETS; i++)
+      {
+         socketClose(context->serverSocket[i]);
+         context->serverSocket[i] = NULL;
+      }
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+      //Close the accounting socket
+      socketClose(context->acctSocket);
+      context->acctSocket = NULL;
+#endif
+
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+      //Close the Dynamic Authorization socket
+      socketClose(context->daeSocket);
+      context->daeSocket = NULL;
+#endif
 
-      //Close the UDP socket
-      socketClose(context->serverSocket);
-      context->serverSocket = NULL;
+      //Close the TLS connections to the RADIUS servers
+      authenticatorCloseRadsecConns(context);
    }
 
    //Successful processing
@@ -1055,9 +3390,13 @@ error_t authenticatorStop(AuthenticatorContext *context)
 
 void authenticatorTask(AuthenticatorContext *context)
 {
+   uint_t i;
    systime_t time;
    systime_t timeout;
-   SocketEventDesc eventDesc[2];
+   SocketEventDesc eventDesc[AUTHENTICATOR_NUM_POLLED_SOCKETS];
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   uint32_t cycles;
+#endif
 
 #if (NET_RTOS_SUPPORT == ENABLED)
    //Task prologue
@@ -1080,16 +3419,77 @@ void authenticatorTask(AuthenticatorContext *context)
          timeout = 0;
       }
 
+#if (AUTHENTICATOR_NUM_SHARDS == 1)
+      //The ports are handled by the authenticator task itself
+      timeout = authenticatorGetShardTimeout(&context->shards[0], timeout);
+#endif
+
       //Specify the events the application is interested in
-      eventDesc[0].socket = context->peerSocket;
+      eventDesc[0].socket = context->interfaces[0].socket;
       eventDesc[0].eventMask = SOCKET_EVENT_RX_READY;
       eventDesc[0].eventFlags = 0;
-      eventDesc[1].socket = context->serverSocket;
-      eventDesc[1].eventMask = SOCKET_EVENT_RX_READY;
-      eventDesc[1].eventFlags = 0;
+
+      //The raw sockets of the other network interfaces come last
+      for(i = 1; i < AUTHENTICATOR_MAX_INTERFACES; i++)
+      {
+         if(i < context->numInterfaces)
+         {
+            eventDesc[AUTHENTICATOR_PEER_SOCKET_INDEX + i - 1].socket =
+               context->interfaces[i].socket;
+         }
+         else
+         {
+            eventDesc[AUTHENTICATOR_PEER_SOCKET_INDEX + i - 1].socket = NULL;
+         }
+
+         eventDesc[AUTHENTICATOR_PEER_SOCKET_INDEX + i - 1].eventMask =
+            SOCKET_EVENT_RX_READY;
+         eventDesc[AUTHENTICATOR_PEER_SOCKET_INDEX + i - 1].eventFlags = 0;
+      }
+
+      //Loop through the UDP sockets
+      for(i = 0; i < AUTHENTICATOR_NUM_RADIUS_SOCKETS; i++)
+      {
+         eventDesc[i + 1].socket = context->serverSocket[i];
+         eventDesc[i + 1].eventMask = SOCKET_EVENT_RX_READY;
+         eventDesc[i + 1].eventFlags = 0;
+      }
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+      //The accounting socket comes next
+      eventDesc[AUTHENTICATOR_ACCT_SOCKET_INDEX].socket = context->acctSocket;
+#else
+      //The accounting socket is not used
+      eventDesc[AUTHENTICATOR_ACCT_SOCKET_INDEX].socket = NULL;
+#endif
+      eventDesc[AUTHENTICATOR_ACCT_SOCKET_INDEX].eventMask = SOCKET_EVENT_RX_READY;
+      eventDesc[AUTHENTICATOR_ACCT_SOCKET_INDEX].eventFlags = 0;
+
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+      //Followed by the Dynamic Authorization socket
+      eventDesc[AUTHENTICATOR_DAE_SOCKET_INDEX].socket = context->daeSocket;
+#else
+      //The Dynamic Authorization socket is not used
+      eventDesc[AUTHENTICATOR_DAE_SOCKET_INDEX].socket = NULL;
+#endif
+      eventDesc[AUTHENTICATOR_DAE_SOCKET_INDEX].eventMask = SOCKET_EVENT_RX_READY;
+      eventDesc[AUTHENTICATOR_DAE_SOCKET_INDEX].eventFlags = 0;
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+      //The TLS connections to the RADIUS servers come last
+      timeout = authenticatorSetRadsecEvents(context,
+         eventDesc + AUTHENTICATOR_RADSEC_SOCKET_INDEX, timeout);
+#endif
 
       //Wait for an event
-      socketPoll(eventDesc, 2, &context->event, timeout);
+      socketPoll(eventDesc, AUTHENTICATOR_NUM_POLLED_SOCKETS, &context->event,
+         timeout);
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+      //Data may have been buffered by the TLS layer
+      authenticatorGetRadsecEvents(context,
+         eventDesc + AUTHENTICATOR_RADSEC_SOCKET_INDEX);
+#endif
 
       //Stop request?
       if(context->stop)
@@ -1102,40 +3502,43 @@ void authenticatorTask(AuthenticatorContext *context)
          osDeleteTask(OS_SELF_TASK_ID);
       }
 
-      //Any EAPOL packet received?
-      if(eventDesc[0].eventFlags != 0)
-      {
-         //Acquire exclusive access to the 802.1X authenticator context
-         osAcquireMutex(&context->mutex);
-         //Process incoming EAPOL packet
-         authenticatorProcessEapolPdu(context);
-         //Release exclusive access to the 802.1X authenticator context
-         osReleaseMutex(&context->mutex);
-      }
+#if (AUTHENTICATOR_NUM_SHARDS == 1)
+      //The frames are processed inline. The mutex is held for the whole
+      //batch
+      osAcquireMutex(&context->shards[0].mutex);
+#endif
+
+      //Receive the frames that are queued on the sockets
+      authenticatorReceiveFrames(context, eventDesc);
 
-      //Any RADIUS packet received?
-      if(eventDesc[1].eventFlags != 0)
+#if (AUTHENTICATOR_NUM_SHARDS == 1)
+      //Process the timers that have expired and update the state machines
+      //of the ports that have pending events
+      authenticatorProcessShardEvents(&context->shards[0]);
+      //Release exclusive access to the ports
+      osReleaseMutex(&context->shards[0].mutex);
+#endif
+
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+      //The queued state changes are delivered by the authenticator task
+      //unless a separate consumer has been registered
+      if(context->eventNotification == NULL)
       {
-         //Acquire exclusive access to the 802.1X authenticator context
-         osAcquireMutex(&context->mutex);
-         //Process incoming RADIUS packet
-         authenticatorProcessRadiusPacket(context);
-         //Release exclusive access to the 802.1X authenticator context
-         osReleaseMutex(&context->mutex);
+         authenticatorDeliverEvents(context);
       }
+#endif
 
       //Get current time
       time = osGetSystemTime();
 
-      //Timers have a resolution of one second
+      //Periodic operations are performed once per tick
       if((time - context->timestamp) >= AUTHENTICATOR_TICK_INTERVAL)
       {
-         //Acquire exclusive access to the 802.1X authenticator context
-         osAcquireMutex(&context->mutex);
          //Handle periodic operations
+         AUTHENTICATOR_PROFILE_START(cycles);
          authenticatorTick(context);
-         //Release exclusive access to the 802.1X authenticator context
-         osReleaseMutex(&context->mutex);
+         AUTHENTICATOR_PROFILE_STOP(&context->profile,
+            AUTHENTICATOR_PROFILE_TICK, cycles);
 
          //Save current time
          context->timestamp = time;
@@ -1154,6 +3557,8 @@ void authenticatorTask(AuthenticatorContext *context)
 
 void authenticatorDeinit(AuthenticatorContext *context)
 {
+   uint_t i;
+
    //Make sure the 802.1X authenticator context is valid
    if(context != NULL)
    {
@@ -1161,6 +3566,31 @@ void authenticatorDeinit(AuthenticatorContext *context)
       osDeleteMutex(&context->mutex);
       osDeleteEvent(&context->event);
 
+      //Loop through the shards
+      for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+      {
+         osDeleteMutex(&context->shards[i].mutex);
+         osDeleteEvent(&context->shards[i].event);
+      }
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+      //Loop through the TLS connections
+      for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+      {
+         osDeleteMutex(&context->radsecConns[i].mutex);
+      }
+#endif
+
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+      //Delete the mutex protecting the event queue
+      osDeleteMutex(&context->eventMutex);
+#endif
+
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+      //Delete the mutex serializing the blocks of the capture
+      osDeleteMutex(&context->captureMutex);
+#endif
+
       //Clear authenticator context
       osMemset(context, 0, sizeof(AuthenticatorContext));
    }
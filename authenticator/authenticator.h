@@ -39,13 +39,26 @@ struct _AuthenticatorContext;
 struct _AuthenticatorPort;
 #define AuthenticatorPort struct _AuthenticatorPort
 
+//Forward declaration of AuthenticatorTimer structure
+struct _AuthenticatorTimer;
+#define AuthenticatorTimer struct _AuthenticatorTimer
+
+//Forward declaration of AuthenticatorBuffer structure
+struct _AuthenticatorBuffer;
+#define AuthenticatorBuffer struct _AuthenticatorBuffer
+
+//Forward declaration of AuthenticatorShard structure
+struct _AuthenticatorShard;
+#define AuthenticatorShard struct _AuthenticatorShard
+
 //Dependencies
 #include "eap/eap.h"
 #include "eap/eap_full_auth_fsm.h"
 #include "authenticator/authenticator_pae_fsm.h"
 #include "authenticator/authenticator_backend_fsm.h"
 #include "authenticator/authenticator_reauth_timer_fsm.h"
-#include "mac/hmac.h"
+#include "radius/radius_attributes.h"
+#include "hash/md5.h"
 
 //802.1X authenticator support
 #ifndef AUTHENTICATOR_SUPPORT
@@ -73,7 +86,14 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_TICK_INTERVAL parameter is not valid
 #endif
 
-//Size of the transmission buffer
+//Maximum number of frames received per wakeup of the authenticator task
+#ifndef AUTHENTICATOR_RX_BATCH_SIZE
+   #define AUTHENTICATOR_RX_BATCH_SIZE 16
+#elif (AUTHENTICATOR_RX_BATCH_SIZE < 1)
+   #error AUTHENTICATOR_RX_BATCH_SIZE parameter is not valid
+#endif
+
+//Default size of the transmission buffers of the session buffers
 #ifndef AUTHENTICATOR_TX_BUFFER_SIZE
    #define AUTHENTICATOR_TX_BUFFER_SIZE 1500
 #elif (AUTHENTICATOR_TX_BUFFER_SIZE < 1)
@@ -87,6 +107,70 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_RX_BUFFER_SIZE parameter is not valid
 #endif
 
+//Minimum size of the transmission buffers (an Access-Request carrying the
+//invariant attributes, a full-length User-Name, a State attribute and the
+//Message-Authenticator must fit)
+#define AUTHENTICATOR_MIN_TX_BUFFER_SIZE (sizeof(RadiusPacket) + \
+   AUTHENTICATOR_RADIUS_TEMPLATE_SIZE + AUTHENTICATOR_MAX_ID_LEN + \
+   RADIUS_MAX_ATTR_VALUE_LEN + MD5_DIGEST_SIZE + 3 * sizeof(RadiusAttribute))
+
+//Size of the transmission buffers of the small-footprint profile (leaves
+//room for the EAP-Message attribute of an EAP-MD5 response)
+#define AUTHENTICATOR_SMALL_TX_BUFFER_SIZE (AUTHENTICATOR_MIN_TX_BUFFER_SIZE + 128)
+
+//Minimum value of the Framed-MTU attribute (refer to RFC 2865, section 5.12)
+#define AUTHENTICATOR_MIN_FRAMED_MTU 64
+//Framed-MTU of the small-footprint profile
+#define AUTHENTICATOR_SMALL_FRAMED_MTU 512
+
+//Size of the memory backing a pool of session buffers
+#define AUTHENTICATOR_BUFFER_MEMORY_SIZE(numBuffers, txBufferSize) \
+   ((numBuffers) * 2 * (txBufferSize))
+
+//Built-in session buffers (used when the caller supplies no pool)
+#ifndef AUTHENTICATOR_STATIC_BUFFER_SUPPORT
+   #define AUTHENTICATOR_STATIC_BUFFER_SUPPORT ENABLED
+#elif (AUTHENTICATOR_STATIC_BUFFER_SUPPORT != ENABLED && AUTHENTICATOR_STATIC_BUFFER_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_STATIC_BUFFER_SUPPORT parameter is not valid
+#endif
+
+//Number of buffers in the EAPOL receive ring
+#ifndef AUTHENTICATOR_EAPOL_RX_RING_SIZE
+   #define AUTHENTICATOR_EAPOL_RX_RING_SIZE 4
+#elif (AUTHENTICATOR_EAPOL_RX_RING_SIZE < 1)
+   #error AUTHENTICATOR_EAPOL_RX_RING_SIZE parameter is not valid
+#endif
+
+//Sustained rate of EAPOL-Start frames accepted per port, in frames per
+//second (0 disables rate limiting)
+#ifndef AUTHENTICATOR_EAPOL_START_RATE
+   #define AUTHENTICATOR_EAPOL_START_RATE 1
+#elif (AUTHENTICATOR_EAPOL_START_RATE < 0)
+   #error AUTHENTICATOR_EAPOL_START_RATE parameter is not valid
+#endif
+
+//Number of back-to-back EAPOL-Start frames accepted per port
+#ifndef AUTHENTICATOR_EAPOL_START_BURST
+   #define AUTHENTICATOR_EAPOL_START_BURST 4
+#elif (AUTHENTICATOR_EAPOL_START_BURST < 1)
+   #error AUTHENTICATOR_EAPOL_START_BURST parameter is not valid
+#endif
+
+//Sustained rate of EAP frames accepted per port, in frames per second
+//(0 disables rate limiting)
+#ifndef AUTHENTICATOR_EAP_FRAME_RATE
+   #define AUTHENTICATOR_EAP_FRAME_RATE 20
+#elif (AUTHENTICATOR_EAP_FRAME_RATE < 0)
+   #error AUTHENTICATOR_EAP_FRAME_RATE parameter is not valid
+#endif
+
+//Number of back-to-back EAP frames accepted per port
+#ifndef AUTHENTICATOR_EAP_FRAME_BURST
+   #define AUTHENTICATOR_EAP_FRAME_BURST 40
+#elif (AUTHENTICATOR_EAP_FRAME_BURST < 1)
+   #error AUTHENTICATOR_EAP_FRAME_BURST parameter is not valid
+#endif
+
 //Maximum length of the RADIUS server's key
 #ifndef AUTHENTICATOR_MAX_SERVER_KEY_LEN
    #define AUTHENTICATOR_MAX_SERVER_KEY_LEN 64
@@ -94,6 +178,13 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_MAX_SERVER_KEY_LEN parameter is not valid
 #endif
 
+//Size of the per-port block of invariant RADIUS attributes
+#ifndef AUTHENTICATOR_RADIUS_TEMPLATE_SIZE
+   #define AUTHENTICATOR_RADIUS_TEMPLATE_SIZE 128
+#elif (AUTHENTICATOR_RADIUS_TEMPLATE_SIZE < 0)
+   #error AUTHENTICATOR_RADIUS_TEMPLATE_SIZE parameter is not valid
+#endif
+
 //Default value for the quietPeriod parameter
 #ifndef AUTHENTICATOR_DEFAULT_QUIET_PERIOD
    #define AUTHENTICATOR_DEFAULT_QUIET_PERIOD 60
@@ -164,6 +255,13 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_MAX_REAUTH_PERIOD parameter is not valid
 #endif
 
+//Maximum acceptable value for the reauthentication jitter, in percent
+#ifndef AUTHENTICATOR_MAX_REAUTH_JITTER
+   #define AUTHENTICATOR_MAX_REAUTH_JITTER 50
+#elif (AUTHENTICATOR_MAX_REAUTH_JITTER < 0 || AUTHENTICATOR_MAX_REAUTH_JITTER > 100)
+   #error AUTHENTICATOR_MAX_REAUTH_JITTER parameter is not valid
+#endif
+
 //Maximum length of identity
 #ifndef AUTHENTICATOR_MAX_ID_LEN
    #define AUTHENTICATOR_MAX_ID_LEN 64
@@ -178,6 +276,22 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_MAX_STATE_SIZE parameter is not valid
 #endif
 
+//Number of lock-free attempts to read the snapshot of a port
+#ifndef AUTHENTICATOR_SNAPSHOT_MAX_RETRIES
+   #define AUTHENTICATOR_SNAPSHOT_MAX_RETRIES 4
+#elif (AUTHENTICATOR_SNAPSHOT_MAX_RETRIES < 1)
+   #error AUTHENTICATOR_SNAPSHOT_MAX_RETRIES parameter is not valid
+#endif
+
+//Memory barrier
+#ifndef AUTHENTICATOR_MEMORY_BARRIER
+   #if defined(__GNUC__)
+      #define AUTHENTICATOR_MEMORY_BARRIER() __sync_synchronize()
+   #else
+      #define AUTHENTICATOR_MEMORY_BARRIER()
+   #endif
+#endif
+
 //Method timeout
 #ifndef AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT
    #define AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT 5
@@ -199,12 +313,400 @@ struct _AuthenticatorPort;
    #error AUTHENTICATOR_RADIUS_TIMEOUT parameter is not valid
 #endif
 
+//Lower bound of the RADIUS retransmission timeout, in milliseconds
+#ifndef AUTHENTICATOR_RADIUS_MIN_RTO
+   #define AUTHENTICATOR_RADIUS_MIN_RTO 1000
+#elif (AUTHENTICATOR_RADIUS_MIN_RTO < 1)
+   #error AUTHENTICATOR_RADIUS_MIN_RTO parameter is not valid
+#endif
+
+//Upper bound of the RADIUS retransmission timeout, in milliseconds
+#ifndef AUTHENTICATOR_RADIUS_MAX_RTO
+   #define AUTHENTICATOR_RADIUS_MAX_RTO 16000
+#elif (AUTHENTICATOR_RADIUS_MAX_RTO < AUTHENTICATOR_RADIUS_MIN_RTO)
+   #error AUTHENTICATOR_RADIUS_MAX_RTO parameter is not valid
+#endif
+
+//Number of UDP sockets used to send RADIUS requests
+#ifndef AUTHENTICATOR_NUM_RADIUS_SOCKETS
+   #define AUTHENTICATOR_NUM_RADIUS_SOCKETS 1
+#elif (AUTHENTICATOR_NUM_RADIUS_SOCKETS < 1)
+   #error AUTHENTICATOR_NUM_RADIUS_SOCKETS parameter is not valid
+#endif
+
+//Maximum number of RADIUS servers
+#ifndef AUTHENTICATOR_MAX_RADIUS_SERVERS
+   #define AUTHENTICATOR_MAX_RADIUS_SERVERS 1
+#elif (AUTHENTICATOR_MAX_RADIUS_SERVERS < 1)
+   #error AUTHENTICATOR_MAX_RADIUS_SERVERS parameter is not valid
+#endif
+
+//Number of consecutive timeouts before a RADIUS server is declared dead
+#ifndef AUTHENTICATOR_RADIUS_MAX_FAILURES
+   #define AUTHENTICATOR_RADIUS_MAX_FAILURES 2
+#elif (AUTHENTICATOR_RADIUS_MAX_FAILURES < 1)
+   #error AUTHENTICATOR_RADIUS_MAX_FAILURES parameter is not valid
+#endif
+
+//Hold-down time before a dead RADIUS server is probed again
+#ifndef AUTHENTICATOR_RADIUS_DEAD_TIME
+   #define AUTHENTICATOR_RADIUS_DEAD_TIME 60
+#elif (AUTHENTICATOR_RADIUS_DEAD_TIME < 1)
+   #error AUTHENTICATOR_RADIUS_DEAD_TIME parameter is not valid
+#endif
+
+//Initial delay before a postponed reauthentication is attempted again
+#ifndef AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY
+   #define AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY 30
+#elif (AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY < 1)
+   #error AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY parameter is not valid
+#endif
+
+//Maximum delay before a postponed reauthentication is attempted again
+#ifndef AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY
+   #define AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY 600
+#elif (AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY < AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY)
+   #error AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY parameter is not valid
+#endif
+
+//Initial number of outstanding RADIUS requests per server
+#ifndef AUTHENTICATOR_RADIUS_INIT_WINDOW
+   #define AUTHENTICATOR_RADIUS_INIT_WINDOW 4
+#elif (AUTHENTICATOR_RADIUS_INIT_WINDOW < 1)
+   #error AUTHENTICATOR_RADIUS_INIT_WINDOW parameter is not valid
+#endif
+
+//Maximum number of outstanding RADIUS requests per server
+#ifndef AUTHENTICATOR_RADIUS_MAX_WINDOW
+   #define AUTHENTICATOR_RADIUS_MAX_WINDOW 64
+#elif (AUTHENTICATOR_RADIUS_MAX_WINDOW < AUTHENTICATOR_RADIUS_INIT_WINDOW)
+   #error AUTHENTICATOR_RADIUS_MAX_WINDOW parameter is not valid
+#endif
+
+//Resolution of the timers, in milliseconds
+#ifndef AUTHENTICATOR_TIMER_RESOLUTION
+   #define AUTHENTICATOR_TIMER_RESOLUTION 50
+#elif (AUTHENTICATOR_TIMER_RESOLUTION < 1)
+   #error AUTHENTICATOR_TIMER_RESOLUTION parameter is not valid
+#endif
+
+//Size of the timer wheel
+#ifndef AUTHENTICATOR_TIMER_WHEEL_SIZE
+   #define AUTHENTICATOR_TIMER_WHEEL_SIZE 256
+#elif (AUTHENTICATOR_TIMER_WHEEL_SIZE < 1)
+   #error AUTHENTICATOR_TIMER_WHEEL_SIZE parameter is not valid
+#endif
+
+//Number of shards the ports are split into
+#ifndef AUTHENTICATOR_NUM_SHARDS
+   #define AUTHENTICATOR_NUM_SHARDS 1
+#elif (AUTHENTICATOR_NUM_SHARDS < 1)
+   #error AUTHENTICATOR_NUM_SHARDS parameter is not valid
+#endif
+
+//Maximum number of network interfaces served by a single context
+#ifndef AUTHENTICATOR_MAX_INTERFACES
+   #define AUTHENTICATOR_MAX_INTERFACES 1
+#elif (AUTHENTICATOR_MAX_INTERFACES < 1)
+   #error AUTHENTICATOR_MAX_INTERFACES parameter is not valid
+#endif
+
+//Number of received frames that can be queued for each shard
+#ifndef AUTHENTICATOR_SHARD_QUEUE_SIZE
+   #define AUTHENTICATOR_SHARD_QUEUE_SIZE 4
+#elif (AUTHENTICATOR_SHARD_QUEUE_SIZE < 1)
+   #error AUTHENTICATOR_SHARD_QUEUE_SIZE parameter is not valid
+#endif
+
+//Size of the hash table used to look up the sessions of multi-supplicant
+//ports
+#ifndef AUTHENTICATOR_HOST_HASH_SIZE
+   #define AUTHENTICATOR_HOST_HASH_SIZE 64
+#elif (AUTHENTICATOR_HOST_HASH_SIZE < 1)
+   #error AUTHENTICATOR_HOST_HASH_SIZE parameter is not valid
+#endif
+
+//Number of recently authorized supplicants remembered per port
+#ifndef AUTHENTICATOR_AUTH_CACHE_SIZE
+   #define AUTHENTICATOR_AUTH_CACHE_SIZE 2
+#elif (AUTHENTICATOR_AUTH_CACHE_SIZE < 1)
+   #error AUTHENTICATOR_AUTH_CACHE_SIZE parameter is not valid
+#endif
+
+//Latency statistics
+#ifndef AUTHENTICATOR_LATENCY_STATS_SUPPORT
+   #define AUTHENTICATOR_LATENCY_STATS_SUPPORT ENABLED
+#elif (AUTHENTICATOR_LATENCY_STATS_SUPPORT != ENABLED && AUTHENTICATOR_LATENCY_STATS_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_LATENCY_STATS_SUPPORT parameter is not valid
+#endif
+
+//Cycle-counter profiling of the hot paths
+#ifndef AUTHENTICATOR_PROFILE_SUPPORT
+   #define AUTHENTICATOR_PROFILE_SUPPORT DISABLED
+#elif (AUTHENTICATOR_PROFILE_SUPPORT != ENABLED && AUTHENTICATOR_PROFILE_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_PROFILE_SUPPORT parameter is not valid
+#endif
+
+//Cycle counter read by the profiling hooks (DWT->CYCCNT, PMCCNTR...)
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED && !defined(AUTHENTICATOR_PROFILE_GET_CYCLES))
+   #error AUTHENTICATOR_PROFILE_GET_CYCLES must be defined when profiling is enabled
+#endif
+
+//Number of buckets of the latency histograms
+#ifndef AUTHENTICATOR_LATENCY_NUM_BUCKETS
+   #define AUTHENTICATOR_LATENCY_NUM_BUCKETS 16
+#elif (AUTHENTICATOR_LATENCY_NUM_BUCKETS < 2 || AUTHENTICATOR_LATENCY_NUM_BUCKETS > 32)
+   #error AUTHENTICATOR_LATENCY_NUM_BUCKETS parameter is not valid
+#endif
+
+//Number of records in the trace ring of each port
+#ifndef AUTHENTICATOR_TRACE_RING_SIZE
+   #define AUTHENTICATOR_TRACE_RING_SIZE 16
+#elif (AUTHENTICATOR_TRACE_RING_SIZE < 1)
+   #error AUTHENTICATOR_TRACE_RING_SIZE parameter is not valid
+#endif
+
+//RADIUS accounting support
+#ifndef AUTHENTICATOR_ACCT_SUPPORT
+   #define AUTHENTICATOR_ACCT_SUPPORT DISABLED
+#elif (AUTHENTICATOR_ACCT_SUPPORT != ENABLED && AUTHENTICATOR_ACCT_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_ACCT_SUPPORT parameter is not valid
+#endif
+
+//Number of Accounting-Request packets that can be queued
+#ifndef AUTHENTICATOR_ACCT_QUEUE_SIZE
+   #define AUTHENTICATOR_ACCT_QUEUE_SIZE 16
+#elif (AUTHENTICATOR_ACCT_QUEUE_SIZE < 1 || AUTHENTICATOR_ACCT_QUEUE_SIZE > 256)
+   #error AUTHENTICATOR_ACCT_QUEUE_SIZE parameter is not valid
+#endif
+
+//Size of the buffer holding an Accounting-Request packet
+#ifndef AUTHENTICATOR_ACCT_BUFFER_SIZE
+   #define AUTHENTICATOR_ACCT_BUFFER_SIZE 512
+#elif (AUTHENTICATOR_ACCT_BUFFER_SIZE < 384)
+   #error AUTHENTICATOR_ACCT_BUFFER_SIZE parameter is not valid
+#endif
+
+//Accounting retransmission timeout (in milliseconds)
+#ifndef AUTHENTICATOR_ACCT_RETRANS_TIMEOUT
+   #define AUTHENTICATOR_ACCT_RETRANS_TIMEOUT 3000
+#elif (AUTHENTICATOR_ACCT_RETRANS_TIMEOUT < 1000)
+   #error AUTHENTICATOR_ACCT_RETRANS_TIMEOUT parameter is not valid
+#endif
+
+//Maximum number of retransmissions of Accounting-Request packets
+#ifndef AUTHENTICATOR_ACCT_MAX_RETRANS
+   #define AUTHENTICATOR_ACCT_MAX_RETRANS 4
+#elif (AUTHENTICATOR_ACCT_MAX_RETRANS < 0)
+   #error AUTHENTICATOR_ACCT_MAX_RETRANS parameter is not valid
+#endif
+
+//Maximum number of Accounting-Request packets sent per tick
+#ifndef AUTHENTICATOR_ACCT_MAX_TX_PER_TICK
+   #define AUTHENTICATOR_ACCT_MAX_TX_PER_TICK 8
+#elif (AUTHENTICATOR_ACCT_MAX_TX_PER_TICK < 1)
+   #error AUTHENTICATOR_ACCT_MAX_TX_PER_TICK parameter is not valid
+#endif
+
+//Maximum number of ports examined per tick for interim updates
+#ifndef AUTHENTICATOR_ACCT_INTERIM_SCAN
+   #define AUTHENTICATOR_ACCT_INTERIM_SCAN 64
+#elif (AUTHENTICATOR_ACCT_INTERIM_SCAN < 1)
+   #error AUTHENTICATOR_ACCT_INTERIM_SCAN parameter is not valid
+#endif
+
+//Random data pool support
+#ifndef AUTHENTICATOR_RANDOM_POOL_SUPPORT
+   #define AUTHENTICATOR_RANDOM_POOL_SUPPORT DISABLED
+#elif (AUTHENTICATOR_RANDOM_POOL_SUPPORT != ENABLED && AUTHENTICATOR_RANDOM_POOL_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_RANDOM_POOL_SUPPORT parameter is not valid
+#endif
+
+//Size of the random data pool, in bytes
+#ifndef AUTHENTICATOR_RANDOM_POOL_SIZE
+   #define AUTHENTICATOR_RANDOM_POOL_SIZE 512
+#elif (AUTHENTICATOR_RANDOM_POOL_SIZE < 64)
+   #error AUTHENTICATOR_RANDOM_POOL_SIZE parameter is not valid
+#endif
+
+//Deferred delivery of the state change callbacks
+#ifndef AUTHENTICATOR_EVENT_QUEUE_SUPPORT
+   #define AUTHENTICATOR_EVENT_QUEUE_SUPPORT DISABLED
+#elif (AUTHENTICATOR_EVENT_QUEUE_SUPPORT != ENABLED && AUTHENTICATOR_EVENT_QUEUE_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_EVENT_QUEUE_SUPPORT parameter is not valid
+#endif
+
+//Number of ports that can have state changes waiting to be delivered
+#ifndef AUTHENTICATOR_EVENT_QUEUE_SIZE
+   #define AUTHENTICATOR_EVENT_QUEUE_SIZE 32
+#elif (AUTHENTICATOR_EVENT_QUEUE_SIZE < 1)
+   #error AUTHENTICATOR_EVENT_QUEUE_SIZE parameter is not valid
+#endif
+
+//Maximum number of queued entries delivered per batch
+#ifndef AUTHENTICATOR_EVENT_BATCH_SIZE
+   #define AUTHENTICATOR_EVENT_BATCH_SIZE 8
+#elif (AUTHENTICATOR_EVENT_BATCH_SIZE < 1)
+   #error AUTHENTICATOR_EVENT_BATCH_SIZE parameter is not valid
+#endif
+
+//Maximum number of ports reported per invocation of the port change callback
+#ifndef AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE
+   #define AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE 16
+#elif (AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE < 1)
+   #error AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE parameter is not valid
+#endif
+
+//Session event stream
+#ifndef AUTHENTICATOR_SESSION_STREAM_SUPPORT
+   #define AUTHENTICATOR_SESSION_STREAM_SUPPORT DISABLED
+#elif (AUTHENTICATOR_SESSION_STREAM_SUPPORT != ENABLED && AUTHENTICATOR_SESSION_STREAM_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_SESSION_STREAM_SUPPORT parameter is not valid
+#endif
+
+//Number of session events that can be buffered for each shard
+#ifndef AUTHENTICATOR_SESSION_STREAM_SIZE
+   #define AUTHENTICATOR_SESSION_STREAM_SIZE 16
+#elif (AUTHENTICATOR_SESSION_STREAM_SIZE < 2 || (AUTHENTICATOR_SESSION_STREAM_SIZE & (AUTHENTICATOR_SESSION_STREAM_SIZE - 1)) != 0)
+   #error AUTHENTICATOR_SESSION_STREAM_SIZE parameter is not valid
+#endif
+
+//Capture and replay of EAPOL/RADIUS exchanges
+#ifndef AUTHENTICATOR_CAPTURE_SUPPORT
+   #define AUTHENTICATOR_CAPTURE_SUPPORT DISABLED
+#elif (AUTHENTICATOR_CAPTURE_SUPPORT != ENABLED && AUTHENTICATOR_CAPTURE_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_CAPTURE_SUPPORT parameter is not valid
+#endif
+
+//Crypto provider support
+#ifndef AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT
+   #define AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT DISABLED
+#elif (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT != ENABLED && AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT parameter is not valid
+#endif
+
+//The Message-Authenticator must be the first attribute of RADIUS responses
+#ifndef AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST
+   #define AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST DISABLED
+#elif (AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST != ENABLED && AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST != DISABLED)
+   #error AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST parameter is not valid
+#endif
+
+//Interleaved computation of the Response and Message authenticators
+#ifndef AUTHENTICATOR_MD5_2WAY_SUPPORT
+   #define AUTHENTICATOR_MD5_2WAY_SUPPORT DISABLED
+#elif (AUTHENTICATOR_MD5_2WAY_SUPPORT != ENABLED && AUTHENTICATOR_MD5_2WAY_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_MD5_2WAY_SUPPORT parameter is not valid
+#endif
+
+//RADIUS over TLS support
+#ifndef AUTHENTICATOR_RADSEC_SUPPORT
+   #define AUTHENTICATOR_RADSEC_SUPPORT DISABLED
+#elif (AUTHENTICATOR_RADSEC_SUPPORT != ENABLED && AUTHENTICATOR_RADSEC_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_RADSEC_SUPPORT parameter is not valid
+#endif
+
+//Maximum time allowed to establish a TLS connection (in milliseconds)
+#ifndef AUTHENTICATOR_RADSEC_CONNECT_TIMEOUT
+   #define AUTHENTICATOR_RADSEC_CONNECT_TIMEOUT 10000
+#elif (AUTHENTICATOR_RADSEC_CONNECT_TIMEOUT < 1000)
+   #error AUTHENTICATOR_RADSEC_CONNECT_TIMEOUT parameter is not valid
+#endif
+
+//Minimum delay before reconnecting to a RADIUS server (in milliseconds)
+#ifndef AUTHENTICATOR_RADSEC_MIN_BACKOFF
+   #define AUTHENTICATOR_RADSEC_MIN_BACKOFF 1000
+#elif (AUTHENTICATOR_RADSEC_MIN_BACKOFF < 1000)
+   #error AUTHENTICATOR_RADSEC_MIN_BACKOFF parameter is not valid
+#endif
+
+//Maximum delay before reconnecting to a RADIUS server (in milliseconds)
+#ifndef AUTHENTICATOR_RADSEC_MAX_BACKOFF
+   #define AUTHENTICATOR_RADSEC_MAX_BACKOFF 60000
+#elif (AUTHENTICATOR_RADSEC_MAX_BACKOFF < AUTHENTICATOR_RADSEC_MIN_BACKOFF)
+   #error AUTHENTICATOR_RADSEC_MAX_BACKOFF parameter is not valid
+#endif
+
+//Dynamic Authorization server support
+#ifndef AUTHENTICATOR_DAE_SUPPORT
+   #define AUTHENTICATOR_DAE_SUPPORT DISABLED
+#elif (AUTHENTICATOR_DAE_SUPPORT != ENABLED && AUTHENTICATOR_DAE_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_DAE_SUPPORT parameter is not valid
+#endif
+
+//Local authentication fallback support
+#ifndef AUTHENTICATOR_LOCAL_AUTH_SUPPORT
+   #define AUTHENTICATOR_LOCAL_AUTH_SUPPORT DISABLED
+#elif (AUTHENTICATOR_LOCAL_AUTH_SUPPORT != ENABLED && AUTHENTICATOR_LOCAL_AUTH_SUPPORT != DISABLED)
+   #error AUTHENTICATOR_LOCAL_AUTH_SUPPORT parameter is not valid
+#endif
+
+//Maximum number of entries in the local credential store
+#ifndef AUTHENTICATOR_MAX_LOCAL_USERS
+   #define AUTHENTICATOR_MAX_LOCAL_USERS 16
+#elif (AUTHENTICATOR_MAX_LOCAL_USERS < 1)
+   #error AUTHENTICATOR_MAX_LOCAL_USERS parameter is not valid
+#endif
+
+//Maximum length of the passwords of the local credential store
+#ifndef AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN
+   #define AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN 32
+#elif (AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN < 1)
+   #error AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN parameter is not valid
+#endif
+
+//RADIUS over TLS supported?
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   #include "core/crypto.h"
+   #include "tls/tls.h"
+#endif
+
+//Number of timers per port
+#define AUTHENTICATOR_NUM_TIMERS 5
+//Number of measured latency intervals
+#define AUTHENTICATOR_NUM_LATENCY_STAGES 4
+//Number of profiled code paths
+#define AUTHENTICATOR_NUM_PROFILE_POINTS 5
+
+//Index of the accounting socket in the poll list
+#define AUTHENTICATOR_ACCT_SOCKET_INDEX (AUTHENTICATOR_NUM_RADIUS_SOCKETS + 1)
+//Index of the Dynamic Authorization socket in the poll list
+#define AUTHENTICATOR_DAE_SOCKET_INDEX (AUTHENTICATOR_NUM_RADIUS_SOCKETS + 2)
+//Index of the first TLS connection in the poll list
+#define AUTHENTICATOR_RADSEC_SOCKET_INDEX (AUTHENTICATOR_NUM_RADIUS_SOCKETS + 3)
+
+//Index of the raw socket of the second network interface in the poll list
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   #define AUTHENTICATOR_PEER_SOCKET_INDEX (AUTHENTICATOR_RADSEC_SOCKET_INDEX + \
+      AUTHENTICATOR_MAX_RADIUS_SERVERS)
+#else
+   #define AUTHENTICATOR_PEER_SOCKET_INDEX AUTHENTICATOR_RADSEC_SOCKET_INDEX
+#endif
+
+//Number of sockets polled by the authenticator task
+#define AUTHENTICATOR_NUM_POLLED_SOCKETS (AUTHENTICATOR_PEER_SOCKET_INDEX + \
+   AUTHENTICATOR_MAX_INTERFACES - 1)
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+/**
+ * @brief Timer identifiers
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_TIMER_A_WHILE           = 0, ///<aWhile timer
+   AUTHENTICATOR_TIMER_QUIET_WHILE       = 1, ///<quietWhile timer
+   AUTHENTICATOR_TIMER_REAUTH_WHEN       = 2, ///<reAuthWhen timer
+   AUTHENTICATOR_TIMER_RETRANS_WHILE     = 3, ///<retransWhile timer
+   AUTHENTICATOR_TIMER_AAA_RETRANS_TIMER = 4  ///<RADIUS retransmission timer
+} AuthenticatorTimerId;
+
+
 /**
  * @brief Session terminate cause
  **/
@@ -222,6 +724,111 @@ typedef enum
 } AuthenticatorTerminateCause;
 
 
+/**
+ * @brief Admission policy
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_ADMISSION_POLICY_FAIR       = 0, ///<Waiting ports are served in a round-robin fashion
+   AUTHENTICATOR_ADMISSION_POLICY_PREFER_NEW = 1  ///<New sessions are served before reauthentications
+} AuthenticatorAdmissionPolicy;
+
+
+/**
+ * @brief Footprint profile
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_FOOTPRINT_DEFAULT = 0, ///<Session buffers sized for EAP-TLS
+   AUTHENTICATOR_FOOTPRINT_SMALL   = 1  ///<Session buffers sized for EAP-MD5 and MAB
+} AuthenticatorFootprintProfile;
+
+
+/**
+ * @brief Critical authentication policy
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_CRITICAL_AUTH_DISABLED = 0, ///<Sessions fail when the RADIUS servers do not answer
+   AUTHENTICATOR_CRITICAL_AUTH_CACHED   = 1, ///<Recently authorized supplicants are authorized locally
+   AUTHENTICATOR_CRITICAL_AUTH_LOCAL    = 2  ///<Cached supplicants and local users are authorized locally
+} AuthenticatorCriticalAuthPolicy;
+
+
+/**
+ * @brief Trace events
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_TRACE_EVENT_PAE_STATE           = 1, ///<Authenticator PAE state transition
+   AUTHENTICATOR_TRACE_EVENT_BACKEND_STATE       = 2, ///<Backend authentication state transition
+   AUTHENTICATOR_TRACE_EVENT_REAUTH_TIMER_STATE  = 3, ///<Reauthentication timer state transition
+   AUTHENTICATOR_TRACE_EVENT_EAP_FULL_AUTH_STATE = 4, ///<EAP full authenticator state transition
+   AUTHENTICATOR_TRACE_EVENT_EAPOL_RX            = 5, ///<EAPOL PDU received
+   AUTHENTICATOR_TRACE_EVENT_EAPOL_TX            = 6, ///<EAPOL PDU sent
+   AUTHENTICATOR_TRACE_EVENT_RADIUS_RX           = 7, ///<RADIUS packet received
+   AUTHENTICATOR_TRACE_EVENT_RADIUS_TX           = 8  ///<RADIUS packet sent
+} AuthenticatorTraceEvent;
+
+
+/**
+ * @brief State machines whose transitions are reported through callbacks
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_EVENT_PAE_STATE           = 0x01, ///<Authenticator PAE state change
+   AUTHENTICATOR_EVENT_BACKEND_STATE       = 0x02, ///<Backend authentication state change
+   AUTHENTICATOR_EVENT_REAUTH_TIMER_STATE  = 0x04, ///<Reauthentication timer state change
+   AUTHENTICATOR_EVENT_EAP_FULL_AUTH_STATE = 0x08  ///<EAP full authenticator state change
+} AuthenticatorEventType;
+
+
+/**
+ * @brief Session events
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_SESSION_EVENT_AUTHORIZED = 0, ///<The supplicant has been authorized
+   AUTHENTICATOR_SESSION_EVENT_FAILED     = 1, ///<The authentication of the supplicant has failed
+   AUTHENTICATOR_SESSION_EVENT_TIMED_OUT  = 2, ///<The authentication server did not respond
+   AUTHENTICATOR_SESSION_EVENT_LOGOFF     = 3, ///<The supplicant has logged off
+   AUTHENTICATOR_SESSION_EVENT_TERMINATED = 4  ///<The session has been terminated for another reason
+} AuthenticatorSessionEventType;
+
+
+/**
+ * @brief Measured latency intervals
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_LATENCY_START_TO_REQ_ID      = 0, ///<EAPOL-Start to first EAP-Request/Identity
+   AUTHENTICATOR_LATENCY_RESP_TO_ACCESS_REQ   = 1, ///<EAP response to Access-Request sent
+   AUTHENTICATOR_LATENCY_RADIUS_RTT           = 2, ///<RADIUS round-trip time
+   AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH   = 3  ///<CONNECTING to AUTHENTICATED
+} AuthenticatorLatencyStage;
+
+
+/**
+ * @brief Profiled code paths
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_PROFILE_EAPOL_PDU      = 0, ///<authenticatorProcessEapolPdu
+   AUTHENTICATOR_PROFILE_RADIUS_PACKET  = 1, ///<authenticatorProcessRadiusPacket
+   AUTHENTICATOR_PROFILE_BUILD_REQUEST  = 2, ///<authenticatorBuildRadiusRequest
+   AUTHENTICATOR_PROFILE_PORT_FSM       = 3, ///<authenticatorPortFsm (includes authenticatorBuildRadiusRequest)
+   AUTHENTICATOR_PROFILE_TICK           = 4  ///<authenticatorTick
+} AuthenticatorProfilePoint;
+
+
 /**
  * @brief Authenticator PAE state change callback function
  **/
@@ -254,6 +861,54 @@ typedef void (*EapFullAuthStateChangeCallback)(AuthenticatorPort *port,
    EapFullAuthState state);
 
 
+/**
+ * @brief Host status callback function
+ *
+ * On multi-supplicant ports, each supplicant is authorized individually. The
+ * callback is invoked whenever the authorization state of a supplicant
+ * changes, so that traffic can be filtered by MAC address
+ *
+ **/
+
+typedef void (*AuthenticatorHostStatusCallback)(AuthenticatorPort *port,
+   const MacAddr *macAddr, AuthenticatorPortStatus status);
+
+
+/**
+ * @brief Event notification callback function
+ *
+ * The callback is invoked when state changes are waiting to be delivered. It
+ * must not block. The consumer then calls authenticatorProcessEvents()
+ *
+ **/
+
+typedef void (*AuthenticatorEventNotification)(AuthenticatorContext *context);
+
+
+/**
+ * @brief Capture callback function
+ *
+ * The callback receives the capture as a pcapng stream. Each block may be
+ * delivered in several consecutive chunks, which must be appended in order
+ *
+ **/
+
+typedef void (*AuthenticatorCaptureCallback)(AuthenticatorContext *context,
+   const uint8_t *data, size_t length);
+
+
+/**
+ * @brief Replay clock callback function
+ *
+ * The callback is invoked before a captured frame is replayed, so that the
+ * virtual clock returned by osGetSystemTime() can be moved to the time at
+ * which the frame was captured
+ *
+ **/
+
+typedef void (*AuthenticatorReplayClockCallback)(systime_t time);
+
+
 /**
  * @brief Tick callback function
  **/
@@ -261,6 +916,32 @@ typedef void (*EapFullAuthStateChangeCallback)(AuthenticatorPort *port,
 typedef void (*AuthenticatorTickCallback)(AuthenticatorContext *context);
 
 
+/**
+ * @brief Port change callback function
+ *
+ * The callback reports, once per tick, the ports whose authPaeState or
+ * authPortStatus has changed. Large sets of ports are split into several
+ * batches that carry the same generation
+ *
+ **/
+
+typedef void (*AuthenticatorPortChangeCallback)(AuthenticatorContext *context,
+   const uint_t *portIndexes, uint_t numPorts, uint32_t generation);
+
+
+/**
+ * @brief Link state callback function
+ *
+ * The callback returns the link state of up to 32 consecutive entries of the
+ * port table, starting from the port with the specified index. Bit 0
+ * corresponds to that port
+ *
+ **/
+
+typedef uint32_t (*AuthenticatorLinkStateCallback)(AuthenticatorContext *context,
+   uint_t portIndex);
+
+
 /**
  * @brief Statistics information
  **/
@@ -278,9 +959,29 @@ typedef struct
    uint32_t invalidEapolFramesRx;
    uint32_t eapLengthErrorFramesRx;
    uint32_t lastEapolFrameVersion;
+   uint32_t dupEapRespFramesRx;
+   uint32_t reauthDeferrals;
+   uint32_t rateLimitedStartFramesRx;
+   uint32_t rateLimitedEapFramesRx;
+   uint32_t eapIdMismatchFramesRx;
+   uint32_t invalidRadiusPacketsRx;
 } AuthenticatorStats;
 
 
+/**
+ * @brief Token bucket
+ *
+ * Tokens are counted in thousandths, so that low rates refill smoothly
+ *
+ **/
+
+typedef struct
+{
+   uint32_t tokens;     ///<Number of available tokens, in thousandths
+   systime_t timestamp; ///<Time of the last refill
+} AuthenticatorTokenBucket;
+
+
 /**
  * @brief Session statistics information
  **/
@@ -297,45 +998,617 @@ typedef struct
 
 
 /**
- * @brief Port context
+ * @brief Latency histogram
+ *
+ * Bucket 0 counts the samples below 1 ms. Bucket n counts the samples in the
+ * range [2^(n-1), 2^n) ms, the last bucket also counting all the larger
+ * samples
+ *
  **/
 
-struct _AuthenticatorPort
+typedef struct
 {
-   AuthenticatorContext *context;                     ///<802.1X authenticator context
-   uint8_t portIndex;                                 ///<Port index
-   MacAddr macAddr;                                   ///<MAC address of the port
+   uint32_t count;                                     ///<Number of samples
+   uint32_t sum;                                       ///<Sum of the samples, in milliseconds
+   uint32_t max;                                       ///<Largest sample, in milliseconds
+   uint32_t buckets[AUTHENTICATOR_LATENCY_NUM_BUCKETS]; ///<Number of samples per bucket
+} AuthenticatorHistogram;
 
-   AuthenticatorPaeState authPaeState;                ///<Authenticator PAE state
-   AuthenticatorBackendState authBackendState;        ///<Backend authentication state
-   AuthenticatorReauthTimerState reauthTimerState;    ///<Reauthentication timer state
 
-   uint_t aWhile;                                     ///<Timer used by the backend authentication state machine (8.2.2.1 a)
-   uint_t quietWhile;                                 ///<Timer used by the authenticator PAE state machine (8.2.2.1 d)
-   uint_t reAuthWhen;                                 ///<Timer used to determine when reauthentication takes place (8.2.2.1 e)
+/**
+ * @brief Cycle counts of a profiled code path
+ **/
+
+typedef struct
+{
+   uint32_t calls;       ///<Number of calls
+   uint32_t minCycles;   ///<Shortest call, in cycles
+   uint32_t maxCycles;   ///<Longest call, in cycles
+   uint64_t totalCycles; ///<Sum of the cycles spent in the calls
+} AuthenticatorProfileEntry;
+
+
+/**
+ * @brief Profiling table
+ *
+ * Each table is only updated by the task that owns it
+ *
+ **/
+
+typedef struct
+{
+   volatile uint_t seq;                                          ///<Sequence number (odd while an update is in progress)
+   AuthenticatorProfileEntry entries[AUTHENTICATOR_NUM_PROFILE_POINTS]; ///<Cycle counts of the profiled code paths
+} AuthenticatorProfileTable;
+
+
+/**
+ * @brief Trace record
+ *
+ * Records have a fixed size and are stored in binary form. They are meant
+ * to be decoded offline
+ *
+ **/
+
+typedef struct
+{
+   uint32_t timestamp;  ///<Time at which the event occurred, in milliseconds
+   uint16_t portIndex;  ///<Port number
+   uint16_t length;     ///<Length of the PDU or packet, in bytes
+   uint8_t event;       ///<Trace event
+   uint8_t fromState;   ///<Previous state (state transitions)
+   uint8_t toState;     ///<New state (state transitions)
+   uint8_t eapolType;   ///<EAPOL packet type
+   uint8_t eapCode;     ///<EAP code
+   uint8_t eapId;       ///<EAP identifier
+   uint8_t eapType;     ///<EAP method type
+   uint8_t radiusCode;  ///<RADIUS code
+   uint8_t radiusId;    ///<RADIUS identifier
+} AuthenticatorTraceRecord;
+
+
+/**
+ * @brief Snapshot of the state of a port
+ *
+ * The snapshot is published by the task that owns the port each time its
+ * state machines have been evaluated. Management reads do not need to lock
+ * the port
+ *
+ **/
+
+typedef struct
+{
+   AuthenticatorPaeState authPaeState;                ///<Authenticator PAE state
+   AuthenticatorBackendState authBackendState;        ///<Backend authentication state
+   AuthenticatorReauthTimerState reauthTimerState;    ///<Reauthentication timer state
+   EapFullAuthState eapFullAuthState;                 ///<EAP full authenticator state
+   AuthenticatorPortStatus authPortStatus;            ///<Current authorization state of the controlled port
+   AuthenticatorPortMode portControl;                 ///<Port control
+   uint_t quietPeriod;                                ///<Initialization value used for the quietWhile timer
+   uint_t serverTimeout;                              ///<Initialization value used for the aWhile timer
+   uint_t reAuthPeriod;                               ///<Number of seconds between periodic reauthentication
+   bool_t reAuthEnabled;                              ///<Enable or disable reauthentication
+   bool_t keyTxEnabled;                               ///<Transmission of key information is enabled
+   MacAddr supplicantMacAddr;                         ///<Supplicant's MAC address
+   char_t aaaIdentity[AUTHENTICATOR_MAX_ID_LEN + 1];  ///<Identity of the supplicant
+   AuthenticatorStats stats;                          ///<Statistics information
+   AuthenticatorSessionStats sessionStats;            ///<Session statistics information
+   uint32_t changeGeneration;                         ///<Generation of the last change of authPaeState or authPortStatus
+} AuthenticatorPortSnapshot;
+
+
+/**
+ * @brief Exported state of a port
+ *
+ * The state of the authorized ports can be saved before a restart of the
+ * authenticator and restored afterwards, so that the supplicants do not have
+ * to authenticate again
+ *
+ **/
+
+typedef struct
+{
+   bool_t authorized;                                 ///<The controlled port is authorized
+   MacAddr supplicantMacAddr;                         ///<Supplicant's MAC address
+   char_t aaaIdentity[AUTHENTICATOR_MAX_ID_LEN + 1];  ///<Identity of the supplicant
+   uint_t reAuthWhen;                                 ///<Time remaining before reauthentication, in milliseconds
+   AuthenticatorSessionStats sessionStats;            ///<Session statistics information
+} AuthenticatorPortState;
+
+
+/**
+ * @brief Authorization cache entry
+ **/
+
+typedef struct
+{
+   bool_t valid;        ///<Valid entry
+   MacAddr macAddr;     ///<MAC address of the authorized supplicant
+   systime_t timestamp; ///<Time at which the Access-Accept was received
+   systime_t lifetime;  ///<Lifetime of the entry, in milliseconds
+} AuthenticatorAuthCacheEntry;
+
+
+/**
+ * @brief State of an accounting record
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_ACCT_RECORD_FREE    = 0, ///<The record is not used
+   AUTHENTICATOR_ACCT_RECORD_BUSY    = 1, ///<The request is being formatted
+   AUTHENTICATOR_ACCT_RECORD_READY   = 2, ///<The request is waiting to be sent
+   AUTHENTICATOR_ACCT_RECORD_PENDING = 3  ///<The request has been sent and is waiting for a response
+} AuthenticatorAcctRecordState;
+
+
+/**
+ * @brief Accounting record
+ **/
+
+typedef struct
+{
+   AuthenticatorAcctRecordState state;            ///<State of the record
+   uint8_t statusType;                            ///<Value of the Acct-Status-Type attribute
+   systime_t eventTime;                           ///<Time at which the accounting event occurred
+   systime_t txTime;                              ///<Time at which the request was last sent
+   systime_t timeout;                             ///<Retransmission timeout
+   uint_t retransCount;                           ///<Number of retransmissions
+   size_t delayTimeOffset;                        ///<Offset to the value of the Acct-Delay-Time attribute
+   size_t length;                                 ///<Length of the Accounting-Request packet, in bytes
+   uint8_t buffer[AUTHENTICATOR_ACCT_BUFFER_SIZE]; ///<Accounting-Request packet
+} AuthenticatorAcctRecord;
+
+
+/**
+ * @brief Accounting statistics
+ **/
+
+typedef struct
+{
+   uint32_t requests;        ///<Number of Accounting-Request packets sent, excluding retransmissions
+   uint32_t retransmissions; ///<Number of Accounting-Request packets retransmitted
+   uint32_t responses;       ///<Number of valid Accounting-Response packets received
+   uint32_t malformed;       ///<Number of invalid Accounting-Response packets received
+   uint32_t timeouts;        ///<Number of requests abandoned after the last retransmission
+   uint32_t dropped;         ///<Number of records that could not be queued or were evicted
+} AuthenticatorAcctStats;
+
+
+/**
+ * @brief Entry of the local credential store
+ **/
+
+typedef struct
+{
+   char_t identity[AUTHENTICATOR_MAX_ID_LEN + 1];            ///<Identity of the user (empty if the entry is free)
+   char_t password[AUTHENTICATOR_MAX_LOCAL_PASSWORD_LEN + 1]; ///<Password of the user
+} AuthenticatorLocalUser;
+
+
+/**
+ * @brief Dynamic Authorization statistics
+ **/
+
+typedef struct
+{
+   uint32_t disconnectRequests; ///<Number of valid Disconnect-Request packets received
+   uint32_t disconnectAcks;     ///<Number of Disconnect-ACK packets sent
+   uint32_t disconnectNaks;     ///<Number of Disconnect-NAK packets sent
+   uint32_t coaRequests;        ///<Number of valid CoA-Request packets received
+   uint32_t coaAcks;            ///<Number of CoA-ACK packets sent
+   uint32_t coaNaks;            ///<Number of CoA-NAK packets sent
+   uint32_t unknownClients;     ///<Number of packets received from an unknown address
+   uint32_t badAuthenticators;  ///<Number of packets with an invalid Request Authenticator
+   uint32_t malformed;          ///<Number of malformed packets received
+} AuthenticatorDaeStats;
+
+
+/**
+ * @brief Transport protocol used to reach a RADIUS server
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_RADIUS_TRANSPORT_UDP = 0, ///<RADIUS over UDP (RFC 2865)
+   AUTHENTICATOR_RADIUS_TRANSPORT_TLS = 1  ///<RADIUS over TLS (RFC 6614)
+} AuthenticatorRadiusTransport;
+
+
+/**
+ * @brief State of a TLS connection to a RADIUS server
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_RADSEC_STATE_CLOSED     = 0,
+   AUTHENTICATOR_RADSEC_STATE_CONNECTING = 1,
+   AUTHENTICATOR_RADSEC_STATE_HANDSHAKE  = 2,
+   AUTHENTICATOR_RADSEC_STATE_OPEN       = 3,
+   AUTHENTICATOR_RADSEC_STATE_ERROR      = 4
+} AuthenticatorRadsecState;
+
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+
+/**
+ * @brief TLS initialization callback function
+ **/
+
+typedef error_t (*AuthenticatorRadsecInitCallback)(AuthenticatorContext *context,
+   uint_t serverIndex, TlsContext *tlsContext);
+
+
+/**
+ * @brief TLS connection to a RADIUS server
+ **/
+
+typedef struct
+{
+   OsMutex mutex;                                     ///<Mutex serializing the accesses to the connection
+   AuthenticatorRadsecState state;                    ///<State of the connection
+   Socket *socket;                                    ///<TCP socket
+   TlsContext *tlsContext;                            ///<TLS context
+   IpAddr ipAddr;                                     ///<IP address of the RADIUS server
+   uint16_t port;                                     ///<Port number of the RADIUS server
+   uint_t connId;                                     ///<Identifier of the current connection (incremented upon each connection)
+   systime_t timestamp;                               ///<Time at which the connection entered its current state
+   systime_t retryDelay;                              ///<Delay before the next connection attempt
+   systime_t backoff;                                 ///<Delay applied after the next failure
+   bool_t rxPending;                                  ///<More data may be available without any socket event
+   uint8_t rxBuffer[AUTHENTICATOR_RX_BUFFER_SIZE];    ///<Reassembly buffer for the incoming RADIUS packets
+   size_t rxLen;                                      ///<Number of bytes in the reassembly buffer
+} AuthenticatorRadsecConn;
+
+#endif
+
+
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+
+/**
+ * @brief Crypto operation waiting for the provider
+ **/
+
+typedef enum
+{
+   AUTHENTICATOR_CRYPTO_OP_NONE     = 0, ///<No pending operation
+   AUTHENTICATOR_CRYPTO_OP_RANDOM   = 1, ///<Generation of the Request Authenticator
+   AUTHENTICATOR_CRYPTO_OP_HMAC_MD5 = 2  ///<Calculation of the Message-Authenticator
+} AuthenticatorCryptoOp;
+
+
+/**
+ * @brief Data chunk processed by the crypto provider
+ **/
+
+typedef struct
+{
+   const void *data; ///<Pointer to the data
+   size_t length;    ///<Length of the data, in bytes
+} AuthenticatorCryptoVector;
+
+
+/**
+ * @brief MD5 calculation
+ **/
+
+typedef error_t (*AuthenticatorCryptoMd5)(void *param,
+   const AuthenticatorCryptoVector *vectors, uint_t count, uint8_t *digest,
+   AuthenticatorPort *port, uint_t id);
+
+
+/**
+ * @brief HMAC-MD5 calculation
+ **/
+
+typedef error_t (*AuthenticatorCryptoHmacMd5)(void *param, const uint8_t *key,
+   size_t keyLen, const AuthenticatorCryptoVector *vectors, uint_t count,
+   uint8_t *digest, AuthenticatorPort *port, uint_t id);
+
+
+/**
+ * @brief Random data generation
+ **/
+
+typedef error_t (*AuthenticatorCryptoRandom)(void *param, uint8_t *output,
+   size_t length, AuthenticatorPort *port, uint_t id);
+
+
+/**
+ * @brief Crypto provider
+ *
+ * Each operation returns NO_ERROR when the result is available on return. A
+ * provider that completes the operation asynchronously returns
+ * ERROR_IN_PROGRESS and later reports the outcome by calling
+ * authenticatorCompleteCrypto with the port and identifier it was given. A
+ * NULL port means that the operation must complete synchronously
+ *
+ **/
+
+typedef struct
+{
+   AuthenticatorCryptoMd5 md5;         ///<MD5 calculation
+   AuthenticatorCryptoHmacMd5 hmacMd5; ///<HMAC-MD5 calculation
+   AuthenticatorCryptoRandom random;   ///<Random data generation
+} AuthenticatorCryptoProvider;
+
+#endif
+
+
+/**
+ * @brief Timer
+ **/
+
+struct _AuthenticatorTimer
+{
+   AuthenticatorPort *port;  ///<Port the timer belongs to
+   uint_t *value;            ///<Timer variable, in milliseconds (reset to zero on expiry)
+   bool_t running;           ///<The timer is armed
+   uint_t expiry;            ///<Slot count at which the timer expires
+   AuthenticatorTimer *prev; ///<Previous timer in the same slot of the wheel
+   AuthenticatorTimer *next; ///<Next timer in the same slot of the wheel
+};
+
+
+/**
+ * @brief RADIUS server entry
+ **/
+
+typedef struct
+{
+   bool_t enabled;                                ///<The entry is in use
+   IpAddr ipAddr;                                 ///<IP address of the RADIUS server
+   uint16_t port;                                 ///<Port number of the RADIUS server
+   uint8_t key[AUTHENTICATOR_MAX_SERVER_KEY_LEN]; ///<Shared secret
+   size_t keyLen;                                 ///<Length of the shared secret, in bytes
+   uint_t priority;                               ///<Priority of the server (lower values are preferred)
+   uint_t weight;                                 ///<Share of new sessions among the servers of the same priority
+   uint_t maxSessions;                            ///<Maximum number of sessions assigned to the server (0 means no limit)
+   uint_t numSessions;                            ///<Number of sessions currently assigned to the server
+   int_t credit;                                  ///<Current credit (weighted round-robin)
+   bool_t dead;                                   ///<The server is considered unreachable
+   uint_t failures;                               ///<Number of consecutive timeouts
+   uint_t holdDownTimer;                          ///<Time remaining before the next Status-Server probe
+   systime_t srtt;                                ///<Smoothed round-trip time (0 if no sample yet)
+   systime_t rttVar;                              ///<Round-trip time variation
+   systime_t rto;                                 ///<Initial retransmission timeout
+   uint_t window;                                 ///<Maximum number of outstanding requests
+   uint_t windowCredit;                           ///<Responses received since the window was last increased
+   systime_t windowTimestamp;                     ///<Time at which the window was last decreased
+   uint_t inflight;                               ///<Number of outstanding requests
+   AuthenticatorPort *sendQueueHead;              ///<First port waiting for room in the window
+   AuthenticatorPort *sendQueueTail;              ///<Last port waiting for room in the window
+   AuthenticatorRadiusTransport transport;        ///<Transport protocol
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+   AuthenticatorHistogram rttHistogram;           ///<Distribution of the round-trip times
+#endif
+   bool_t probePending;                           ///<A Status-Server probe is outstanding
+   uint_t probeIndex;                             ///<(socket, Identifier) pair used by the probe
+   uint8_t probeAuthenticator[16];                ///<Request Authenticator of the probe
+   Md5Context hmacInnerContext;                   ///<MD5 state after processing the inner padded key
+   Md5Context hmacOuterContext;                   ///<MD5 state after processing the outer padded key
+} AuthenticatorRadiusServer;
+
+
+/**
+ * @brief Session buffer
+ *
+ * Session buffers are only needed while a supplicant is being authenticated.
+ * They are borrowed from a pool shared by all the ports
+ *
+ **/
+
+struct _AuthenticatorBuffer
+{
+   AuthenticatorBuffer *next;                         ///<Next buffer in the free list
+   uint8_t *eapTxBuffer;                              ///<Transmission buffer for EAP requests (txBufferSize bytes)
+   uint8_t *aaaTxBuffer;                              ///<Transmission buffer for RADIUS requests (txBufferSize bytes)
+};
+
+
+/**
+ * @brief EAPOL receive buffer
+ *
+ * A buffer of the EAPOL receive ring is handed over to the port an EAP
+ * response is received on. It is returned to the ring once the response has
+ * been consumed by the state machines of the port
+ *
+ **/
+
+typedef struct
+{
+   AuthenticatorPort *owner;                          ///<Port the buffer is handed over to (NULL if free)
+   uint8_t data[AUTHENTICATOR_RX_BUFFER_SIZE];        ///<EAPOL PDU
+} AuthenticatorRxBuffer;
+
+
+/**
+ * @brief State changes of a port waiting to be delivered
+ *
+ * Successive transitions of the same state machine are coalesced, so that
+ * only the latest state is reported
+ *
+ **/
+
+typedef struct
+{
+   AuthenticatorPort *port;                         ///<Port the state changes relate to
+   uint_t mask;                                     ///<State machines that have changed state (bitmask)
+   AuthenticatorPaeState paeState;                  ///<Latest authenticator PAE state
+   AuthenticatorBackendState backendState;          ///<Latest backend authentication state
+   AuthenticatorReauthTimerState reauthTimerState;  ///<Latest reauthentication timer state
+   EapFullAuthState eapFullAuthState;               ///<Latest EAP full authenticator state
+} AuthenticatorEvent;
+
+
+/**
+ * @brief Session event
+ **/
+
+typedef struct
+{
+   AuthenticatorSessionEventType type;              ///<Event type
+   uint16_t portIndex;                              ///<Port index
+   MacAddr supplicantMacAddr;                       ///<MAC address of the supplicant
+   uint32_t duration;                               ///<Time the supplicant has been authorized, in seconds
+   AuthenticatorTerminateCause terminateCause;      ///<Cause of the termination of the session
+   systime_t timestamp;                             ///<Time at which the event occurred
+} AuthenticatorSessionEvent;
+
+
+/**
+ * @brief Replay context
+ *
+ * The captured Access-Request packets are used to match each captured
+ * response with the session it is destined to
+ *
+ **/
+
+typedef struct
+{
+   AuthenticatorReplayClockCallback clockCallback; ///<Replay clock callback function
+   uint32_t reqNasPort[256];                        ///<NAS-Port of the captured requests, indexed by Identifier
+   MacAddr reqMacAddr[256];                         ///<Calling-Station-Id of the captured requests, indexed by Identifier
+   uint32_t framesReplayed;                         ///<Number of captured frames fed to the authenticator
+   uint32_t framesDropped;                          ///<Number of captured frames that could not be replayed
+} AuthenticatorReplayContext;
+
+
+/**
+ * @brief Cold record of a port
+ *
+ * Identity, RADIUS state, statistics and diagnostic data are not evaluated by
+ * the state machines. They are kept in a separate record so that the scans of
+ * the port contexts only touch the FSM variables
+ *
+ **/
+
+typedef struct
+{
+   char_t aaaIdentity[AUTHENTICATOR_MAX_ID_LEN + 1];  ///<Identity (5.1.2)
+   uint8_t reqAuthenticator[16];                      ///<Request Authenticator field
+   uint8_t serverState[AUTHENTICATOR_MAX_STATE_SIZE]; ///<State attribute received from the server
+   size_t serverStateLen;                             ///<Length of the state attribute, in byte
+   uint8_t radiusTemplate[AUTHENTICATOR_RADIUS_TEMPLATE_SIZE]; ///<Invariant attributes of the Access-Request packets
+   size_t radiusTemplateLen;                          ///<Length of the invariant attributes (0 if not yet computed)
+   AuthenticatorAuthCacheEntry authCache[AUTHENTICATOR_AUTH_CACHE_SIZE]; ///<Recently authorized supplicants
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   uint8_t localChallenge[MD5_DIGEST_SIZE];           ///<Value of the last EAP-MD5 challenge
+#endif
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   uint8_t cryptoOutput[MD5_DIGEST_SIZE];             ///<Result of the crypto operation
+#endif
+
+   AuthenticatorStats stats;                          ///<Statistics information
+   AuthenticatorSessionStats sessionStats;            ///<Session statistics information
+
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+   AuthenticatorHistogram latency[AUTHENTICATOR_NUM_LATENCY_STAGES];   ///<Latency histograms
+   systime_t latencyTimestamps[AUTHENTICATOR_NUM_LATENCY_STAGES];      ///<Start of the intervals being measured
+#endif
+
+   AuthenticatorTraceRecord traceRing[AUTHENTICATOR_TRACE_RING_SIZE]; ///<Trace ring
+   uint_t traceCount;                                 ///<Number of records written to the trace ring
+
+   volatile uint_t snapshotSeq;                       ///<Sequence number of the snapshot (odd while an update is in progress)
+   AuthenticatorPortSnapshot snapshot;                ///<Snapshot published for management reads
+
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   uint_t eventSlot;                                  ///<Entry of the event queue holding the pending state changes (0 if none)
+#endif
+#if (AUTHENTICATOR_SESSION_STREAM_SUPPORT == ENABLED)
+   bool_t streamAuthorized;                           ///<Authorization state last reported through the session event stream
+   systime_t streamAuthTime;                          ///<Time at which the supplicant was authorized
+#endif
+   uint_t interfaceIndex;                             ///<Network interface the port is attached to
+   AuthenticatorTokenBucket startBucket;              ///<Rate limiter of the EAPOL-Start frames
+   AuthenticatorTokenBucket eapBucket;                ///<Rate limiter of the EAP frames
+   uint32_t changeGeneration;                         ///<Generation of the last change of authPaeState or authPortStatus
+#if (AUTHENTICATOR_STATIC_BUFFER_SUPPORT == ENABLED)
+   AuthenticatorBuffer staticBuffer;                  ///<Built-in session buffer
+   uint8_t staticBufferMemory[2 * AUTHENTICATOR_TX_BUFFER_SIZE]; ///<Memory backing the built-in session buffer
+#endif
+} AuthenticatorPortData;
+
+
+/**
+ * @brief Port context
+ *
+ * The port context only holds the variables evaluated by the state machines.
+ * Boolean FSM variables are packed as bit fields
+ *
+ **/
+
+struct _AuthenticatorPort
+{
+   AuthenticatorContext *context;                     ///<802.1X authenticator context
+   AuthenticatorShard *shard;                         ///<Shard the port belongs to
+   AuthenticatorPortData *data;                       ///<Cold record of the port
+   uint16_t portIndex;                                ///<Port index
+   MacAddr macAddr;                                   ///<MAC address of the port
+
+   AuthenticatorPaeState authPaeState;                ///<Authenticator PAE state
+   AuthenticatorBackendState authBackendState;        ///<Backend authentication state
+   AuthenticatorReauthTimerState reauthTimerState;    ///<Reauthentication timer state
+   EapFullAuthState eapFullAuthState;                 ///<EAP full authenticator state
+
+   uint_t aWhile;                                     ///<Timer used by the backend authentication state machine (8.2.2.1 a)
+   uint_t quietWhile;                                 ///<Timer used by the authenticator PAE state machine (8.2.2.1 d)
+   uint_t reAuthWhen;                                 ///<Timer used to determine when reauthentication takes place (8.2.2.1 e)
+   uint_t retransWhile;                               ///<Timer (5.1.1)
+
+   uint_t authAbort : 1;                              ///<Abort authentication procedure (8.2.2.2 a)
+   uint_t authFail : 1;                               ///<Authentication process has failed (8.2.2.2 b)
+   uint_t authStart : 1;                              ///<Start authentication procedure (8.2.2.2 d)
+   uint_t authTimeout : 1;                            ///<Failed to obtain a response from the supplicant(8.2.2.2 e)
+   uint_t authSuccess : 1;                            ///<Successful authentication process (8.2.2.2 f)
+   uint_t eapFail : 1;                                ///<The authentication has failed (8.2.2.2 g)
+   uint_t eapolEap : 1;                               ///<EAPOL PDU carrying a packet Type of EAP-Packet is received (8.2.2.2 h)
+   uint_t eapSuccess : 1;                             ///<The authentication process succeeds (8.2.2.2 i)
+   uint_t eapTimeout : 1;                             ///<The supplicant is not responding to requests (8.2.2.2 j)
+   uint_t initialize : 1;                             ///<Forces all EAPOL state machines to their initial state (8.2.2.2 k)
+   uint_t keyDone : 1;                                ///<This variable is set by the key machine (8.2.2.2 m)
+   uint_t keyRun : 1;                                 ///<Run transmit key machine (8.2.2.2 n)
+   uint_t portValid : 1;                              ///<The value of this variable is set externally (8.2.2.2 s)
+   uint_t reAuthenticate : 1;                         ///<The reAuthWhen timer has expired (8.2.2.2 t)
+   uint_t eapolLogoff : 1;                            ///<EAPOL-Logoff received (8.2.4.1.1 a)
+   uint_t eapolStart : 1;                             ///<EAPOL-Start received (8.2.4.1.1 b)
+   uint_t eapRestart : 1;                             ///<Restart Authenticator state machine (8.2.4.1.1 d)
+   uint_t eapNoReq : 1;                               ///<No EAP frame to be sent to the supplicant (8.2.9.1.1 a)
+   uint_t eapReq : 1;                                 ///<An EAP frame to be sent to the supplicant (8.2.9.1.1 b)
+   uint_t eapResp : 1;                                ///<A new EAP frame available for the higher layer to process (8.2.9.1.1 c)
+   uint_t eapKeyAvailable : 1;                        ///<Keying material is available (5.1.2)
+   uint_t rxResp : 1;                                 ///<The current received packet is an EAP response (5.3.2)
+   uint_t ignore : 1;                                 ///<The method has decided to drop the current packet (5.3.2)
+   uint_t aaaEapReq : 1;                              ///<A new EAP request is ready to be sent (6.1.2)
+   uint_t aaaEapNoReq : 1;                            ///<No new request to send (6.1.2)
+   uint_t aaaSuccess : 1;                             ///<The state machine has reached the SUCCESS state (6.1.2)
+   uint_t aaaFail : 1;                                ///<The state machine has reached the FAILURE state (6.1.2)
+   uint_t aaaEapKeyAvailable : 1;                     ///<Keying material is available (6.1.2)
+   uint_t aaaEapResp : 1;                             ///<An EAP response is available for processing by the AAA server (7.1.2)
+   uint_t aaaTimeout : 1;                             ///<No response from the AAA layer (7.1.2)
+   uint_t scheduled : 1;                              ///<The port is waiting in the run queue
+   uint_t busy : 1;                                   ///<Busy flag
+
+   uint_t aaaServerBound : 1;                         ///<The session is counted against the RADIUS server
+   uint_t aaaInflight : 1;                            ///<The RADIUS request counts against the window of the server
+   uint_t aaaQueued : 1;                              ///<The RADIUS request is waiting for room in the window
+   uint_t bufferWait : 1;                             ///<The port is waiting for a free session buffer
+   uint_t bufferWaitReauth : 1;                       ///<The waiting port is already authorized (reauthentication)
+   uint_t host : 1;                                   ///<The context holds an additional session of a multi-supplicant port
+   uint_t hostConnected : 1;                          ///<The supplicant has been asked for its identity
+   uint_t hostReleasePending : 1;                     ///<The additional session is to be released
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   uint_t acctSessionActive : 1;                      ///<An accounting session is in progress
+#endif
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   uint_t localAuth : 1;                              ///<The supplicant is authenticated by the NAS itself
+   uint_t localAuthSuccess : 1;                       ///<The supplicant has proven the knowledge of its password
+#endif
 
-   bool_t authAbort;                                  ///<Abort authentication procedure (8.2.2.2 a)
-   bool_t authFail;                                   ///<Authentication process has failed (8.2.2.2 b)
    AuthenticatorPortStatus authPortStatus;            ///<Current authorization state of the authenticator PAE state machine (8.2.2.2 c)
-   bool_t authStart;                                  ///Start authentication procedure (8.2.2.2 d)
-   bool_t authTimeout;                                ///<Failed to obtain a response from the supplicant(8.2.2.2 e)
-   bool_t authSuccess;                                ///<Successful authentication process (8.2.2.2 f)
-   bool_t eapFail;                                    ///<The authentication has failed (8.2.2.2 g)
-   bool_t eapolEap;                                   ///<EAPOL PDU carrying a packet Type of EAP-Packet is received (8.2.2.2 h)
-   bool_t eapSuccess;                                 ///<The authentication process succeeds (8.2.2.2 i)
-   bool_t eapTimeout;                                 ///<The supplicant is not responding to requests (8.2.2.2 j)
-
-   bool_t initialize;                                 ///<Forces all EAPOL state machines to their initial state (8.2.2.2 k)
-   bool_t keyDone;                                    ///<This variable is set by the key machine (8.2.2.2 m)
-   bool_t keyRun;                                     ///<Run transmit key machine (8.2.2.2 n)
    AuthenticatorPortMode portControl;                 ///<Port control (8.2.2.2 p)
    bool_t portEnabled;                                ///<Operational state of the port (8.2.2.2 q)
-   bool_t portValid;                                  ///<The value of this variable is set externally (8.2.2.2 s)
-   bool_t reAuthenticate;                             ///<The reAuthWhen timer has expired (8.2.2.2 t)
-
-   bool_t eapolLogoff;                                ///<EAPOL-Logoff received (8.2.4.1.1 a)
-   bool_t eapolStart;                                 ///<EAPOL-Start received (8.2.4.1.1 b)
-   bool_t eapRestart;                                 ///<Restart Authenticator state machine (8.2.4.1.1 d)
    AuthenticatorPortMode portMode;                    ///<Port mode (8.2.4.1.1 e)
    uint_t reAuthCount;                                ///<Number of times the CONNECTING state is re-entered (8.2.4.1.1 f)
 
@@ -346,23 +1619,18 @@ struct _AuthenticatorPort
 
    uint_t reAuthPeriod;                               ///<Number of seconds between periodic reauthentication (8.2.8.1 a)
    bool_t reAuthEnabled;                              ///<Enable or disable reauthentication (8.2.8.1 b)
-
-   bool_t eapNoReq;                                   ///<No EAP frame to be sent to the supplicant (8.2.9.1.1 a)
-   bool_t eapReq;                                     ///<An EAP frame to be sent to the supplicant (8.2.9.1.1 b)
-   bool_t eapResp;                                    ///<A new EAP frame available for the higher layer to process (8.2.9.1.1 c)
+   uint_t reAuthDeferrals;                            ///<Number of consecutive reauthentications postponed during a RADIUS server outage
+   systime_t reAuthDeferDelay;                        ///<Delay before the postponed reauthentication is attempted again, in milliseconds
+   uint32_t sessionTimeout;                           ///<Session-Timeout attribute of the last Access-Accept, in seconds (0 if none)
 
    uint_t serverTimeout;                              ///<Initialization value used for the aWhile timer (8.2.9.1.2 a)
 
-   EapFullAuthState eapFullAuthState;                 ///<EAP full authenticator state
-
    const uint8_t *eapRespData;                        ///<The EAP packet to be processed (5.1.1)
    size_t eapRespDataLen;                             ///<Length of the EAP response
-   uint_t retransWhile;                               ///<Timer (5.1.1)
 
    uint8_t *eapReqData;                               ///<The actual EAP request to be sent (5.1.2)
    size_t eapReqDataLen;                              ///<Length of the EAP request
    uint8_t *eapKeyData;                               ///<EAP key (5.1.2)
-   bool_t eapKeyAvailable;                            ///<Keying material is available (5.1.2)
 
    EapMethodType currentMethod;                       ///<Current method (5.3.1)
    uint_t currentId;                                  ///<Identifier value of the currently outstanding EAP request (5.3.1)
@@ -370,51 +1638,158 @@ struct _AuthenticatorPort
    uint_t retransCount;                               ///<Current number of retransmissions (5.3.1)
    uint8_t *lastReqData;                              ///<EAP packet containing the last sent request (5.3.1)
    size_t lastReqDataLen;                             ///<Length of the last EAP request
-   uint_t methodTimeout;                              ///<Method-provided hint for suitable retransmission timeout (5.3.1)
+   uint_t methodTimeout;                              ///<Method-provided hint for suitable retransmission timeout, in milliseconds (5.3.1)
 
-   bool_t rxResp;                                     ///<The current received packet is an EAP response (5.3.2)
    uint_t respId;                                     ///<Identifier from the current EAP response (5.3.2)
    EapMethodType respMethod;                          ///<Method type of the current EAP response (5.3.2)
-   bool_t ignore;                                     ///<The method has decided to drop the current packet (5.3.2)
    EapDecision decision;                              ///<Decision (5.3.2)
 
-   bool_t aaaEapReq;                                  ///<A new EAP request is ready to be sent (6.1.2)
-   bool_t aaaEapNoReq;                                ///<No new request to send (6.1.2)
-   bool_t aaaSuccess;                                 ///<The state machine has reached the SUCCESS state (6.1.2)
-   bool_t aaaFail;                                    ///<The state machine has reached the FAILURE state (6.1.2)
    uint8_t *aaaEapReqData;                            ///<The actual EAP request to be sent (6.1.2)
    size_t aaaEapReqDataLen;                           ///<Length of the EAP request
    uint8_t *aaaEapKeyData;                            ///<EAP key (6.1.2)
-   bool_t aaaEapKeyAvailable;                         ///<Keying material is available (6.1.2)
-   uint_t aaaMethodTimeout;                           ///<Method-provided hint for suitable retransmission timeout (6.1.2)
+   uint_t aaaMethodTimeout;                           ///<Method-provided hint for suitable retransmission timeout, in milliseconds (6.1.2)
 
-   bool_t aaaEapResp;                                 ///<An EAP response is available for processing by the AAA server (7.1.2)
    const uint8_t *aaaEapRespData;                     ///<The EAP packet to be processed (5.1.2)
    size_t aaaEapRespDataLen;                          ///<Length of the EAP response
-   char_t aaaIdentity[AUTHENTICATOR_MAX_ID_LEN + 1];  ///<Identity (5.1.2)
 
    uint_t maxRetrans;                                 ///<Maximum number of retransmissions before aborting (5.1.3)
 
-   bool_t aaaTimeout;                                 ///<No response from the AAA layer (7.1.2)
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   AuthenticatorCryptoOp cryptoOp;                    ///<Crypto operation waiting for the provider
+   uint_t cryptoId;                                   ///<Identifier of the last crypto operation
+#endif
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+   uint_t latencyPending;                             ///<Intervals being measured (bitmask)
+#endif
 
+   AuthenticatorTimer timers[AUTHENTICATOR_NUM_TIMERS]; ///<Timers of the port
+   AuthenticatorPort *nextScheduledPort;              ///<Next port in the run queue
+
+   uint_t aaaServerIndex;                             ///<RADIUS server handling the current session
    uint8_t aaaReqId;                                  ///<Identifier value of the currently outstanding RADIUS request
+   uint_t aaaReqSocketIndex;                          ///<Index of the UDP socket used to send the RADIUS request
+   bool_t aaaAborted;                                 ///<The identifier of the RADIUS request has been evicted (protected by the context mutex)
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   uint_t aaaReqConnId;                               ///<TLS connection the RADIUS request has been written to (0 if none)
+#endif
+   AuthenticatorPort *nextQueuedPort;                 ///<Next port in the send queue of the server
    uint8_t *aaaReqData;                               ///<RADIUS request
    size_t aaaReqDataLen;                              ///<Length of the RADIUS request
    uint_t aaaRetransTimer;                            ///<RADIUS retransmission timer
    uint_t aaaRetransCount;                            ///<Current number of retransmissions or RADIUS requests
-   uint8_t reqAuthenticator[16];                      ///<Request Authenticator field
-   uint8_t serverState[AUTHENTICATOR_MAX_STATE_SIZE]; ///<State attribute received from the server
-   size_t serverStateLen;                             ///<Length of the state attribute, in byte
+   systime_t aaaRto;                                  ///<Current retransmission timeout of the RADIUS request
+   systime_t aaaReqTimestamp;                         ///<Time at which the RADIUS request was first sent
    MacAddr supplicantMacAddr;                         ///<Supplicant's MAC address
 
-   uint8_t eapTxBuffer[AUTHENTICATOR_TX_BUFFER_SIZE]; ///<Transmission buffer for EAP requests
-   uint8_t aaaTxBuffer[AUTHENTICATOR_TX_BUFFER_SIZE]; ///<Transmission buffer for RADIUS requests
+   AuthenticatorBuffer *buffer;                       ///<Session buffer borrowed from the pool
+   AuthenticatorBuffer *grantedBuffer;                ///<Session buffer handed over by another shard
+   AuthenticatorRxBuffer *rxBuffer;                   ///<Receive buffer holding the pending EAP response
 
-   AuthenticatorStats stats;                          ///<Statistics information
-   AuthenticatorSessionStats sessionStats;            ///<Session statistics information
+   AuthenticatorPort *parent;                         ///<Port the additional session is bound to (NULL if the session is free)
+   AuthenticatorPort *nextHost;                       ///<Next session in the same bucket of the hash table
+   uint_t numHosts;                                   ///<Number of additional sessions bound to the port
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   uint32_t acctSessionId;                            ///<Value of the Acct-Session-Id attribute
+   systime_t acctStartTime;                           ///<Time at which the accounting session started
+   systime_t acctUpdateTime;                          ///<Time at which the last accounting record was queued
+#endif
+};
+
+
+/**
+ * @brief Received frame waiting to be processed by a shard
+ **/
+
+typedef struct
+{
+   AuthenticatorPort *port;                        ///<Destination port
+   AuthenticatorRadiusServer *server;              ///<RADIUS server the packet comes from (NULL for EAPOL PDUs)
+   uint_t index;                                   ///<(socket, Identifier) pair of the RADIUS packet
+   MacAddr srcMacAddr;                             ///<Source MAC address of the EAPOL PDU
+   AuthenticatorRxBuffer *rxBuffer;                ///<Receive buffer holding the EAPOL PDU
+   size_t length;                                  ///<Length of the frame, in bytes
+   uint8_t data[AUTHENTICATOR_RX_BUFFER_SIZE];     ///<Contents of the RADIUS packet
+} AuthenticatorFrame;
+
+
+/**
+ * @brief Shard
+ *
+ * Each shard owns a contiguous range of ports, together with the run queue
+ * and the timer wheel that drive their state machines
+ *
+ **/
+
+struct _AuthenticatorShard
+{
+   AuthenticatorContext *context;                  ///<802.1X authenticator context
+   uint_t index;                                   ///<Shard index
+   uint_t firstPort;                               ///<Zero-based index of the first port of the shard
+   uint_t numPorts;                                ///<Number of ports handled by the shard
+   OsMutex mutex;                                  ///<Mutex preventing simultaneous access to the ports of the shard
+   OsEvent event;                                  ///<Event object used to wake up the shard task
+   OsTaskId taskId;                                ///<Task identifier
+   bool_t running;                                 ///<The shard task is running
+   systime_t timestamp;                            ///<Timestamp to manage periodic operations
+   AuthenticatorPort *runQueueHead;                ///<First port with pending events
+   AuthenticatorPort *runQueueTail;                ///<Last port with pending events
+   uint_t timerTicks;                              ///<Number of slots elapsed since the timer wheel was started
+   systime_t timerTimestamp;                       ///<Time at which the current slot of the timer wheel was entered
+   AuthenticatorTimer *timerWheel[AUTHENTICATOR_TIMER_WHEEL_SIZE]; ///<Timer wheel
+   bool_t bufferRetry;                             ///<A session buffer has been released by another shard
+   bool_t sendRetry;                               ///<Room has been made in the window of a RADIUS server
+   uint32_t reauthSeed;                            ///<State of the generator used to spread reauthentications
+   uint_t firstHost;                               ///<Zero-based index of the first additional session of the shard
+   uint_t numHosts;                                ///<Number of additional sessions handled by the shard
+   AuthenticatorPort *hostHash[AUTHENTICATOR_HOST_HASH_SIZE]; ///<Additional sessions, hashed by port and MAC address
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   AuthenticatorFrame frames[AUTHENTICATOR_SHARD_QUEUE_SIZE]; ///<Received frames waiting to be processed
+   uint_t frameHead;                               ///<Index of the oldest queued frame
+   uint_t numFrames;                               ///<Number of queued frames
+#endif
+#if (AUTHENTICATOR_SESSION_STREAM_SUPPORT == ENABLED)
+   AuthenticatorSessionEvent streamEvents[AUTHENTICATOR_SESSION_STREAM_SIZE]; ///<Session events waiting to be read
+   volatile uint_t streamHead;                     ///<Number of session events written (updated by the shard only)
+   volatile uint_t streamTail;                     ///<Number of session events read (updated by the reader only)
+   volatile uint32_t streamOverflows;              ///<Number of session events discarded because the stream was full
+#endif
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   AuthenticatorProfileTable profile;              ///<Cycle counts of the code paths run by the shard
+#endif
+   RadiusAttrIndex radiusAttrIndex;                ///<Attributes of the received RADIUS packet
+   Md5Context md5Context;                          ///<MD5 context
 };
 
 
+/**
+ * @brief Network interface settings
+ *
+ * The ports of a network interface are numbered from portOffset + 1. The
+ * switch port (or 1 on an interface without switch) is obtained by
+ * subtracting portOffset from the port index
+ *
+ **/
+
+typedef struct
+{
+   NetInterface *interface; ///<Network interface
+   uint_t portOffset;       ///<Offset between the port indexes and the switch ports of the interface
+} AuthenticatorInterfaceSettings;
+
+
+/**
+ * @brief Network interface served by the authenticator
+ **/
+
+typedef struct
+{
+   NetInterface *interface; ///<Network interface
+   uint_t portOffset;       ///<Offset between the port indexes and the switch ports of the interface
+   Socket *socket;          ///<Raw socket used to send/receive EAP packets on the interface
+} AuthenticatorInterface;
+
+
 /**
  * @brief 802.1X authenticator settings
  **/
@@ -423,19 +1798,59 @@ typedef struct
 {
    OsTaskParameters task;                                                      ///<Task parameters
    NetInterface *interface;                                                    ///<Underlying network interface
+   uint_t numInterfaces;                                                       ///<Number of network interfaces (0 means that only the underlying interface is used)
+   const AuthenticatorInterfaceSettings *interfaces;                           ///<Network interfaces, by ascending port offset
    uint_t numPorts;                                                            ///<Number of ports
    AuthenticatorPort *ports;                                                   ///<Ports
+   AuthenticatorPortData *portData;                                            ///<Cold records of the ports (numPorts entries)
+   const uint16_t *portNumbers;                                                ///<Port numbers, in ascending order (optional)
+   uint_t numHosts;                                                            ///<Number of additional sessions
+   AuthenticatorPort *hosts;                                                   ///<Additional sessions of multi-supplicant ports
+   AuthenticatorPortData *hostData;                                            ///<Cold records of the additional sessions (numHosts entries)
+   uint_t maxHostsPerPort;                                                     ///<Maximum number of supplicants per port
+   uint_t numBuffers;                                                          ///<Number of session buffers (0 selects the built-in session buffers)
+   AuthenticatorBuffer *buffers;                                               ///<Pool of session buffers
+   uint8_t *bufferMemory;                                                      ///<Memory backing the session buffers (AUTHENTICATOR_BUFFER_MEMORY_SIZE bytes)
+   size_t txBufferSize;                                                        ///<Size of each transmission buffer, in bytes
+   size_t framedMtu;                                                           ///<Value of the Framed-MTU attribute (largest EAP packet accepted from the server)
+   uint_t maxSessions;                                                         ///<Maximum number of concurrently authenticating ports (0 means no limit)
+   AuthenticatorAdmissionPolicy admissionPolicy;                               ///<Order in which the waiting ports are served
+   uint_t authCacheTtl;                                                        ///<Lifetime of the authorization cache entries, in seconds (0 means disabled)
+   uint_t reauthJitter;                                                        ///<Fraction of the reauthentication period over which the ports are spread, in percent
+   uint_t acctInterimInterval;                                                 ///<Interval between interim accounting updates, in seconds (0 means disabled)
+   uint16_t daePort;                                                           ///<UDP port on which Dynamic Authorization requests are received
+   AuthenticatorCriticalAuthPolicy criticalAuthPolicy;                         ///<Behavior when the RADIUS servers do not answer
+   uint_t criticalAuthDeadline;                                                ///<Time after which eligible supplicants are authenticated locally, in seconds (0 means after the last retransmission)
+   bool_t reauthDeferral;                                                      ///<Keep the sessions authorized when no RADIUS server can be reached at reauthentication time
+   uint_t reauthDrainRate;                                                     ///<Number of postponed reauthentications started per second once a RADIUS server has recovered (0 means no limit)
    NetInterface *serverInterface;                                              ///<RADIUS server interface
    uint_t serverPortIndex;                                                     ///<Switch port used to reach the RADIUS server
    IpAddr serverIpAddr;                                                        ///<RADIUS server's IP address
    uint16_t serverPort;                                                        ///<RADIUS server's port
    const PrngAlgo *prngAlgo;                                                   ///<Pseudo-random number generator to be used
    void *prngContext;                                                          ///<Pseudo-random number generator context
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   const AuthenticatorCryptoProvider *cryptoProvider;                          ///<Crypto provider (NULL selects the software implementation)
+   void *cryptoParam;                                                          ///<Opaque parameter passed to the crypto provider
+#endif
    AuthenticatorPaeStateChangeCallback paeStateChangeCallback;                 ///<Authenticator PAE state change callback function
    AuthenticatorBackendStateChangeCallback backendStateChangeCallback;         ///<Backend authentication state change callback function
    AuthenticatorReauthTimerStateChangeCallback reauthTimerStateChangeCallback; ///<Reauthentication timer state change callback function
    EapFullAuthStateChangeCallback eapFullAuthStateChangeCallback;              ///<EAP full authenticator state change callback function
+   AuthenticatorHostStatusCallback hostStatusCallback;                         ///<Host status callback function
    AuthenticatorTickCallback tickCallback;                                     ///<Tick callback function
+   AuthenticatorPortChangeCallback portChangeCallback;                         ///<Port change callback function
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   AuthenticatorRadsecInitCallback radsecInitCallback;                         ///<TLS initialization callback function
+#endif
+   AuthenticatorLinkStateCallback linkStateCallback;                           ///<Link state callback function
+   bool_t linkChangeNotification;                                              ///<Link state changes are reported by the driver
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   AuthenticatorEventNotification eventNotification;                           ///<Event notification callback (NULL to deliver the state changes from the authenticator task)
+#endif
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   AuthenticatorCaptureCallback captureCallback;                               ///<Capture callback function
+#endif
 } AuthenticatorSettings;
 
 
@@ -447,43 +1862,143 @@ struct _AuthenticatorContext
 {
    bool_t running;                                      ///<Operational state of the authenticator
    bool_t stop;                                         ///<Stop request
-   OsMutex mutex;                                       ///<Mutex preventing simultaneous access to 802.1X authenticator context
+   OsMutex mutex;                                       ///<Mutex preventing simultaneous access to the state shared by the shards
    OsEvent event;                                       ///<Event object used to poll the sockets
    OsTaskParameters taskParams;                         ///<Task parameters
    OsTaskId taskId;                                     ///<Task identifier
    NetContext *netContext;                              ///<TCP/IP stack context
-   NetInterface *interface;                             ///<Underlying network interface
+   NetInterface *interface;                             ///<Underlying network interface (first interface)
+   uint_t numInterfaces;                                ///<Number of network interfaces
+   AuthenticatorInterface interfaces[AUTHENTICATOR_MAX_INTERFACES]; ///<Network interfaces
    uint_t numPorts;                                     ///<Number of ports
    AuthenticatorPort *ports;                            ///<Ports
+   bool_t sparsePorts;                                  ///<The ports are not numbered from 1 to numPorts
+   uint_t numHosts;                                     ///<Number of additional sessions
+   AuthenticatorPort *hosts;                            ///<Additional sessions of multi-supplicant ports
+   uint_t maxHostsPerPort;                              ///<Maximum number of supplicants per port
+   uint_t numBuffers;                                   ///<Number of session buffers
+   AuthenticatorBuffer *buffers;                        ///<Pool of session buffers
+   uint8_t *bufferMemory;                               ///<Memory backing the session buffers
+   size_t txBufferSize;                                 ///<Size of each transmission buffer, in bytes
+   size_t framedMtu;                                    ///<Value of the Framed-MTU attribute
+   AuthenticatorBuffer *freeBuffers;                    ///<List of free session buffers
+   uint_t bufferWaitIndex;                              ///<Next port to be served when a session buffer is released
+   uint_t maxSessions;                                  ///<Maximum number of concurrently authenticating ports (0 means no limit)
+   uint_t numSessions;                                  ///<Number of ports currently authenticating
+   AuthenticatorAdmissionPolicy admissionPolicy;        ///<Order in which the waiting ports are served
+   uint_t authCacheTtl;                                 ///<Lifetime of the authorization cache entries, in seconds (0 means disabled)
+   uint_t reauthJitter;                                 ///<Fraction of the reauthentication period over which the ports are spread, in percent
+   bool_t reauthDeferral;                               ///<Keep the sessions authorized when no RADIUS server can be reached at reauthentication time
+   uint_t reauthDrainRate;                              ///<Number of postponed reauthentications started per second once a RADIUS server has recovered
+   uint_t reauthDrainTokens;                            ///<Number of postponed reauthentications that can still be started during the current tick
+   uint_t acctInterimInterval;                          ///<Interval between interim accounting updates, in seconds (0 means disabled)
    NetInterface *serverInterface;                       ///<RADIUS server interface
    uint_t serverPortIndex;                              ///<Switch port used to reach the RADIUS server
-   IpAddr serverIpAddr;                                 ///<RADIUS server's IP address
-   uint16_t serverPort;                                 ///<RADIUS server's port
-   uint8_t serverKey[AUTHENTICATOR_MAX_SERVER_KEY_LEN]; ///<RADIUS server's key
-   size_t serverKeyLen;                                 ///<Length of the RADIUS server's key, in bytes
+   AuthenticatorRadiusServer servers[AUTHENTICATOR_MAX_RADIUS_SERVERS]; ///<RADIUS servers
    const PrngAlgo *prngAlgo;                            ///<Pseudo-random number generator to be used
    void *prngContext;                                   ///<Pseudo-random number generator context
-   Socket *peerSocket;                                  ///<Raw socket used to send/receive EAP packets
-   Socket *serverSocket;                                ///<UDP socket used to send/receive RADIUS packets
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   const AuthenticatorCryptoProvider *cryptoProvider;   ///<Crypto provider
+   void *cryptoParam;                                   ///<Opaque parameter passed to the crypto provider
+#endif
+   Socket *serverSocket[AUTHENTICATOR_NUM_RADIUS_SOCKETS]; ///<UDP sockets used to send/receive RADIUS packets
    AuthenticatorPaeStateChangeCallback paeStateChangeCallback;                 ///<Authenticator PAE state change callback function
    AuthenticatorBackendStateChangeCallback backendStateChangeCallback;         ///<Backend authentication state change callback function
    AuthenticatorReauthTimerStateChangeCallback reauthTimerStateChangeCallback; ///<Reauthentication timer state change callback function
    EapFullAuthStateChangeCallback eapFullAuthStateChangeCallback;              ///<EAP full authenticator state change callback function
+   AuthenticatorHostStatusCallback hostStatusCallback;  ///<Host status callback function
    AuthenticatorTickCallback tickCallback;              ///<Tick callback function
+   AuthenticatorPortChangeCallback portChangeCallback;  ///<Port change callback function
+   volatile uint32_t changeGeneration;                  ///<Generation of the last change of authPaeState or authPortStatus on any port
+   uint32_t notifyGeneration;                           ///<Last generation reported through the port change callback
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   AuthenticatorRadsecInitCallback radsecInitCallback;  ///<TLS initialization callback function
+#endif
+   AuthenticatorLinkStateCallback linkStateCallback;    ///<Link state callback function
+   bool_t linkChangeNotification;                       ///<Link state changes are reported by the driver
+   bool_t traceEnabled;                                 ///<Recording of trace events is enabled
    systime_t timestamp;                                 ///<Timestamp to manage timeout
 
-   uint_t radiusId;                                     ///<RADIUS packet identifier
-   bool_t busy;                                         ///<Busy flag
+   uint_t radiusReqIndex;                               ///<Last allocated (socket, Identifier) pair
+   AuthenticatorPort *radiusReqTable[AUTHENTICATOR_NUM_RADIUS_SOCKETS * 256]; ///<Pending Access-Requests, indexed by (socket, Identifier)
+   uint32_t radiusIdBitmap[AUTHENTICATOR_NUM_RADIUS_SOCKETS * 8];             ///<Identifiers currently in use
+   AuthenticatorShard shards[AUTHENTICATOR_NUM_SHARDS]; ///<Shards the ports are split into
+
+   AuthenticatorRxBuffer eapolRxRing[AUTHENTICATOR_EAPOL_RX_RING_SIZE]; ///<Receive ring of the EAPOL path
+   uint_t eapolRxIndex;                                 ///<Next buffer of the EAPOL receive ring
+   uint8_t radiusRxBuffer[AUTHENTICATOR_RX_BUFFER_SIZE]; ///<Receive buffer of the RADIUS path
+   RadiusAttrIndex radiusAttrIndex;                     ///<Attributes of the received RADIUS packet
+   Md5Context md5Context;                               ///<MD5 context
+
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   IpAddr acctServerIpAddr;                             ///<IP address of the accounting server
+   uint16_t acctServerPort;                             ///<Port number of the accounting server (0 if accounting is disabled)
+   uint8_t acctKey[AUTHENTICATOR_MAX_SERVER_KEY_LEN];   ///<Shared secret of the accounting server
+   size_t acctKeyLen;                                   ///<Length of the shared secret, in bytes
+   Socket *acctSocket;                                  ///<UDP socket used to send/receive accounting packets
+   AuthenticatorAcctRecord acctQueue[AUTHENTICATOR_ACCT_QUEUE_SIZE]; ///<Accounting records waiting to be acknowledged
+   uint8_t acctIdentifier;                              ///<Last Identifier used for accounting packets
+   uint32_t acctSessionId;                              ///<Last allocated accounting session identifier
+   uint_t acctInterimIndex;                             ///<Next port to be examined for interim updates
+   AuthenticatorAcctStats acctStats;                    ///<Accounting statistics
+   Md5Context acctMd5Context;                           ///<MD5 context of the accounting path
+#endif
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   AuthenticatorRadsecConn radsecConns[AUTHENTICATOR_MAX_RADIUS_SERVERS]; ///<TLS connections to the RADIUS servers
+#endif
+
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+   uint16_t daePort;                                    ///<UDP port on which Dynamic Authorization requests are received
+   IpAddr daeClientIpAddr;                              ///<IP address of the Dynamic Authorization client
+   uint8_t daeKey[AUTHENTICATOR_MAX_SERVER_KEY_LEN];    ///<Shared secret of the Dynamic Authorization client
+   size_t daeKeyLen;                                    ///<Length of the shared secret, in bytes
+   Socket *daeSocket;                                   ///<UDP socket used to receive Dynamic Authorization requests
+   AuthenticatorDaeStats daeStats;                      ///<Dynamic Authorization statistics
+#endif
+
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   AuthenticatorCriticalAuthPolicy criticalAuthPolicy;  ///<Behavior when the RADIUS servers do not answer
+   uint_t criticalAuthDeadline;                         ///<Time after which eligible supplicants are authenticated locally, in seconds
+   AuthenticatorLocalUser localUsers[AUTHENTICATOR_MAX_LOCAL_USERS]; ///<Local credential store
+#endif
+
+#if (AUTHENTICATOR_RANDOM_POOL_SUPPORT == ENABLED)
+   uint8_t randomPool[AUTHENTICATOR_RANDOM_POOL_SIZE];  ///<Pregenerated random data
+   size_t randomPoolLen;                                ///<Number of bytes available in the pool
+   error_t randomPoolError;                             ///<Status of the last refill
+   uint32_t randomPoolRefills;                          ///<Number of successful refills
+   uint32_t randomPoolReseeds;                          ///<Number of times the PRNG has been reseeded
+#endif
+
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+   AuthenticatorEventNotification eventNotification;    ///<Event notification callback
+   OsMutex eventMutex;                                  ///<Mutex protecting the event queue
+   AuthenticatorEvent events[AUTHENTICATOR_EVENT_QUEUE_SIZE]; ///<State changes waiting to be delivered
+   uint_t eventHead;                                    ///<Index of the oldest queued entry
+   uint_t numEvents;                                    ///<Number of queued entries
+   uint32_t eventOverflows;                             ///<Number of state changes delivered synchronously because the queue was full
+#endif
 
-   uint8_t txBuffer[AUTHENTICATOR_TX_BUFFER_SIZE];      ///<Transmission buffer
-   uint8_t rxBuffer[AUTHENTICATOR_RX_BUFFER_SIZE];      ///<Reception buffer
-   HmacContext hmacContext;                             ///<HMAC context
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+   AuthenticatorCaptureCallback captureCallback;        ///<Capture callback function
+   OsMutex captureMutex;                                ///<Mutex preventing the blocks of the capture from being interleaved
+   bool_t captureStarted;                               ///<The header of the capture has been written
+   bool_t replaying;                                    ///<A capture is being replayed (protected by the mutex)
+#endif
+
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   AuthenticatorProfileTable profile;                   ///<Cycle counts of the code paths run by the authenticator task
+#endif
 };
 
 
 //Authenticator related functions
 void authenticatorGetDefaultSettings(AuthenticatorSettings *settings);
 
+error_t authenticatorSetFootprintProfile(AuthenticatorSettings *settings,
+   AuthenticatorFootprintProfile profile);
+
 error_t authenticatorInit(AuthenticatorContext *context,
    const AuthenticatorSettings *settings);
 
@@ -493,12 +2008,79 @@ error_t authenticatorSetServerAddr(AuthenticatorContext *context,
 error_t authenticatorSetServerKey(AuthenticatorContext *context,
    const uint8_t *key, size_t keyLen);
 
+error_t authenticatorSetServer(AuthenticatorContext *context,
+   uint_t serverIndex, const IpAddr *serverIpAddr, uint16_t serverPort,
+   const uint8_t *key, size_t keyLen, uint_t priority, uint_t weight);
+
+error_t authenticatorDeleteServer(AuthenticatorContext *context,
+   uint_t serverIndex);
+
+error_t authenticatorSetServerTransport(AuthenticatorContext *context,
+   uint_t serverIndex, AuthenticatorRadiusTransport transport);
+
+error_t authenticatorSetServerMaxSessions(AuthenticatorContext *context,
+   uint_t serverIndex, uint_t maxSessions);
+
+error_t authenticatorSetAdmissionControl(AuthenticatorContext *context,
+   uint_t maxSessions, AuthenticatorAdmissionPolicy policy);
+
+error_t authenticatorSetAuthCacheTtl(AuthenticatorContext *context,
+   uint_t ttl);
+
+error_t authenticatorFlushAuthCache(AuthenticatorContext *context,
+   uint_t portIndex);
+
+error_t authenticatorSetReauthJitter(AuthenticatorContext *context,
+   uint_t jitter);
+
+error_t authenticatorSetReauthDeferral(AuthenticatorContext *context,
+   bool_t enable, uint_t drainRate);
+
+error_t authenticatorSetAcctServer(AuthenticatorContext *context,
+   const IpAddr *ipAddr, uint16_t port, const uint8_t *key, size_t keyLen);
+
+error_t authenticatorSetAcctInterimInterval(AuthenticatorContext *context,
+   uint_t interval);
+
+error_t authenticatorGetAcctStats(AuthenticatorContext *context,
+   AuthenticatorAcctStats *stats);
+
+error_t authenticatorSetDaeClient(AuthenticatorContext *context,
+   const IpAddr *ipAddr, const uint8_t *key, size_t keyLen);
+
+error_t authenticatorGetDaeStats(AuthenticatorContext *context,
+   AuthenticatorDaeStats *stats);
+
+error_t authenticatorSetCriticalAuthPolicy(AuthenticatorContext *context,
+   AuthenticatorCriticalAuthPolicy policy, uint_t deadline);
+
+error_t authenticatorAddLocalUser(AuthenticatorContext *context,
+   const char_t *identity, const char_t *password);
+
+error_t authenticatorDeleteLocalUser(AuthenticatorContext *context,
+   const char_t *identity);
+
+error_t authenticatorNotifyPrngReseed(AuthenticatorContext *context);
+error_t authenticatorProcessEvents(AuthenticatorContext *context);
+
+error_t authenticatorReadSessionEvents(AuthenticatorContext *context,
+   AuthenticatorSessionEvent *events, uint_t maxEvents, uint_t *numEvents);
+
+error_t authenticatorGetSessionStreamOverflows(AuthenticatorContext *context,
+   uint32_t *overflows);
+
+error_t authenticatorReplayCapture(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, const uint8_t *data, size_t length);
+
 error_t authenticatorInitPort(AuthenticatorContext *context,
    uint_t portIndex);
 
 error_t authenticatorReauthenticate(AuthenticatorContext *context,
    uint_t portIndex);
 
+error_t authenticatorSetLinkState(AuthenticatorContext *context,
+   uint_t portIndex, bool_t linkState);
+
 error_t authenticatorSetPortControl(AuthenticatorContext *context,
    uint_t portIndex, AuthenticatorPortMode portControl);
 
@@ -514,6 +2096,22 @@ error_t authenticatorSetReAuthEnabled(AuthenticatorContext *context,
 error_t authenticatorSetReAuthPeriod(AuthenticatorContext *context,
    uint_t portIndex, uint_t reAuthPeriod);
 
+error_t authenticatorGetPortSnapshot(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortSnapshot *snapshot);
+
+error_t authenticatorGetChangeGeneration(AuthenticatorContext *context,
+   uint32_t *generation);
+
+error_t authenticatorGetChangedPorts(AuthenticatorContext *context,
+   uint32_t generation, uint_t *portIndexes, uint_t maxPorts, uint_t *numPorts,
+   uint32_t *currentGeneration);
+
+error_t authenticatorExportPortState(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorPortState *state);
+
+error_t authenticatorImportPortState(AuthenticatorContext *context,
+   uint_t portIndex, const AuthenticatorPortState *state);
+
 error_t authenticatorGetPortControl(AuthenticatorContext *context,
    uint_t portIndex, AuthenticatorPortMode *portControl);
 
@@ -544,6 +2142,26 @@ error_t authenticatorGetReauthTimerState(AuthenticatorContext *context,
 error_t authenticatorGetEapFullAuthState(AuthenticatorContext *context,
    uint_t portIndex, EapFullAuthState *eapFullAuthState);
 
+error_t authenticatorSetTraceEnabled(AuthenticatorContext *context,
+   bool_t enabled);
+
+error_t authenticatorReadTraceRing(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorTraceRecord *records, uint_t maxRecords,
+   uint_t *numRecords);
+
+error_t authenticatorGetLatencyStats(AuthenticatorContext *context,
+   uint_t portIndex, AuthenticatorLatencyStage stage,
+   AuthenticatorHistogram *histogram);
+
+error_t authenticatorGetProfileStats(AuthenticatorContext *context,
+   AuthenticatorProfileEntry *entries);
+
+error_t authenticatorGetServerRttStats(AuthenticatorContext *context,
+   uint_t serverIndex, AuthenticatorHistogram *histogram);
+
+error_t authenticatorGetServerRto(AuthenticatorContext *context,
+   uint_t serverIndex, systime_t *rto);
+
 error_t authenticatorStart(AuthenticatorContext *context);
 error_t authenticatorStop(AuthenticatorContext *context);
 
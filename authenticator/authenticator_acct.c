@@ -0,0 +1,805 @@
+/**
+ * @file authenticator_acct.c
+ * @brief RADIUS accounting
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_host.h"
+#include "authenticator/authenticator_acct.h"
+#include "radius/radius.h"
+#include "radius/radius_attributes.h"
+#include "radius/radius_debug.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Start or stop the accounting session of a port
+ *
+ * An accounting session starts when the supplicant is authorized, and stops
+ * when it loses its authorization. Reauthentications do not affect the
+ * session
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUpdateAcctSession(AuthenticatorPort *port)
+{
+   bool_t authorized;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Only the supplicants authenticated through the AAA server are accounted
+   if(port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+      port->authPortStatus == AUTHENTICATOR_PORT_STATUS_AUTH)
+   {
+      authorized = TRUE;
+   }
+   else
+   {
+      authorized = FALSE;
+   }
+
+   //Check whether the authorization state has changed
+   if(authorized && !port->acctSessionActive)
+   {
+      //Accounting is disabled?
+      if(context->acctServerPort == 0)
+         return;
+
+      //Acct-Session-Id values are shared by all the shards
+      osAcquireMutex(&context->mutex);
+      //Allocate a new accounting session identifier
+      port->acctSessionId = ++context->acctSessionId;
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
+
+      //The accounting session starts
+      port->acctSessionActive = TRUE;
+      port->acctStartTime = osGetSystemTime();
+      port->acctUpdateTime = port->acctStartTime;
+
+      //Notify the accounting server
+      authenticatorQueueAcctRequest(port, RADIUS_ACCT_STATUS_TYPE_START);
+   }
+   else if(!authorized && port->acctSessionActive)
+   {
+      //Notify the accounting server
+      authenticatorQueueAcctRequest(port, RADIUS_ACCT_STATUS_TYPE_STOP);
+
+      //The accounting session is over
+      port->acctSessionActive = FALSE;
+   }
+   else
+   {
+      //No change
+   }
+}
+
+
+/**
+ * @brief Queue an Accounting-Request packet
+ *
+ * The packet is formatted immediately, so that it reflects the state of the
+ * session at the time of the event, and sent later by the authenticator task.
+ * When the queue is full, Start and Stop records take precedence over interim
+ * updates that have not been sent yet
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] statusType Value of the Acct-Status-Type attribute
+ * @return Error code
+ **/
+
+error_t authenticatorQueueAcctRequest(AuthenticatorPort *port,
+   uint8_t statusType)
+{
+   error_t error;
+   uint_t i;
+   AuthenticatorContext *context;
+   AuthenticatorAcctRecord *record;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Accounting is disabled?
+   if(context->acctServerPort == 0)
+      return ERROR_WRONG_STATE;
+
+   //The accounting queue is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Initialize pointer
+   record = NULL;
+
+   //Search the queue for a free record
+   for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE && record == NULL; i++)
+   {
+      //Free record?
+      if(context->acctQueue[i].state == AUTHENTICATOR_ACCT_RECORD_FREE)
+      {
+         record = &context->acctQueue[i];
+      }
+   }
+
+   //Start and Stop records are required for billing, whereas a lost interim
+   //update is superseded by the next one
+   if(record == NULL && statusType != RADIUS_ACCT_STATUS_TYPE_INTERIM_UPDATE)
+   {
+      //Search the queue for an interim update that has not been sent yet
+      for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE && record == NULL; i++)
+      {
+         //Matching record?
+         if(context->acctQueue[i].state == AUTHENTICATOR_ACCT_RECORD_READY &&
+            context->acctQueue[i].statusType == RADIUS_ACCT_STATUS_TYPE_INTERIM_UPDATE)
+         {
+            //The interim update is evicted
+            record = &context->acctQueue[i];
+            context->acctStats.dropped++;
+         }
+      }
+   }
+
+   //Any record available?
+   if(record != NULL)
+   {
+      //The record is reserved while the packet is being formatted
+      record->state = AUTHENTICATOR_ACCT_RECORD_BUSY;
+   }
+   else
+   {
+      //The accounting record is lost
+      context->acctStats.dropped++;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The queue is full?
+   if(record == NULL)
+   {
+      //Debug message
+      TRACE_WARNING("Port %" PRIu16 ": Accounting queue is full!\r\n",
+         port->portIndex);
+      //Report an error
+      return ERROR_BUFFER_OVERFLOW;
+   }
+
+   //Format Accounting-Request packet
+   error = authenticatorFormatAcctRequest(port, record, statusType);
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Check status code
+   if(!error)
+   {
+      //The packet can be sent by the authenticator task
+      record->state = AUTHENTICATOR_ACCT_RECORD_READY;
+   }
+   else
+   {
+      //Return the record to the queue
+      record->state = AUTHENTICATOR_ACCT_RECORD_FREE;
+      context->acctStats.dropped++;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Format Accounting-Request packet
+ * @param[in] port Pointer to the port context
+ * @param[in] record Accounting record
+ * @param[in] statusType Value of the Acct-Status-Type attribute
+ * @return Error code
+ **/
+
+error_t authenticatorFormatAcctRequest(AuthenticatorPort *port,
+   AuthenticatorAcctRecord *record, uint8_t statusType)
+{
+   error_t error;
+   size_t n;
+   systime_t time;
+   RadiusPacket *packet;
+   AuthenticatorSessionStats *stats;
+   uint8_t buffer[16];
+
+   //Get current time
+   time = osGetSystemTime();
+   //Point to the session statistics
+   stats = &port->data->sessionStats;
+
+   //Point to the buffer where to format the RADIUS packet
+   packet = (RadiusPacket *) record->buffer;
+
+   //The Identifier and the Request Authenticator are computed when the packet
+   //is sent for the first time
+   packet->code = RADIUS_CODE_ACCOUNTING_REQUEST;
+   packet->identifier = 0;
+   packet->length = htons(sizeof(RadiusPacket));
+   osMemset(packet->authenticator, 0, 16);
+
+   //The Acct-Status-Type attribute indicates whether this Accounting-Request
+   //marks the beginning of the user service, the end, or an interim update
+   //(refer to RFC 2866, section 5.1 and RFC 2869, section 2.1)
+   STORE32BE(statusType, buffer);
+   radiusAddAttribute(packet, RADIUS_ATTR_ACCT_STATUS_TYPE, buffer,
+      sizeof(uint32_t));
+
+   //The Acct-Delay-Time attribute indicates how many seconds the client has
+   //been trying to send this record (refer to RFC 2866, section 5.2). Its
+   //value is filled in when the packet is sent
+   record->delayTimeOffset = ntohs(packet->length) + sizeof(RadiusAttribute);
+
+   STORE32BE(0, buffer);
+   radiusAddAttribute(packet, RADIUS_ATTR_ACCT_DELAY_TIME, buffer,
+      sizeof(uint32_t));
+
+   //The Acct-Session-Id attribute is a unique accounting ID to make it easy
+   //to match start and stop records (refer to RFC 2866, section 5.5)
+   osSprintf((char_t *) buffer, "%08" PRIX32, port->acctSessionId);
+   radiusAddAttribute(packet, RADIUS_ATTR_ACCT_SESSION_ID, buffer,
+      osStrlen((char_t *) buffer));
+
+   //The user has been authenticated by the RADIUS server (refer to RFC 2866,
+   //section 5.6)
+   STORE32BE(RADIUS_ACCT_AUTHENTIC_RADIUS, buffer);
+   radiusAddAttribute(packet, RADIUS_ATTR_ACCT_AUTHENTIC, buffer,
+      sizeof(uint32_t));
+
+   //The User-Name attribute is copied from the identity of the supplicant
+   //(refer to RFC 3580, section 3.1)
+   if(port->data->aaaIdentity[0] != '\0')
+   {
+      radiusAddAttribute(packet, RADIUS_ATTR_USER_NAME, port->data->aaaIdentity,
+         osStrlen(port->data->aaaIdentity));
+   }
+
+   //The attributes that describe the NAS and the port are the same as in the
+   //Access-Request packets
+   if(port->data->radiusTemplateLen > 0)
+   {
+      //Retrieve the actual length of the RADIUS packet
+      n = ntohs(packet->length);
+
+      //Copy the prebuilt block of invariant attributes
+      osMemcpy(record->buffer + n, port->data->radiusTemplate,
+         port->data->radiusTemplateLen);
+
+      //Fix the length field
+      packet->length = htons(n + port->data->radiusTemplateLen);
+   }
+   else
+   {
+      //Format the invariant attributes
+      error = authenticatorAddRadiusNasAttributes(port, packet);
+      //Any error to report?
+      if(error)
+         return error;
+   }
+
+   //Usage information is only present in Stop and Interim-Update records
+   if(statusType != RADIUS_ACCT_STATUS_TYPE_START)
+   {
+      //The Acct-Session-Time attribute indicates how many seconds the user
+      //has received service for (refer to RFC 2866, section 5.7)
+      STORE32BE((time - port->acctStartTime) / 1000, buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_SESSION_TIME, buffer,
+         sizeof(uint32_t));
+
+      //Number of octets received from the port over the course of the
+      //service (refer to RFC 2866, section 5.3)
+      STORE32BE((uint32_t) stats->sessionOctetsRx, buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_INPUT_OCTETS, buffer,
+         sizeof(uint32_t));
+
+      //Number of times the Acct-Input-Octets counter has wrapped around
+      //2^32 (refer to RFC 2869, section 5.1)
+      STORE32BE((uint32_t) (stats->sessionOctetsRx >> 32), buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_INPUT_GIGAWORDS, buffer,
+         sizeof(uint32_t));
+
+      //Number of octets sent to the port in the course of delivering this
+      //service (refer to RFC 2866, section 5.4)
+      STORE32BE((uint32_t) stats->sessionOctetsTx, buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_OUTPUT_OCTETS, buffer,
+         sizeof(uint32_t));
+
+      //Number of times the Acct-Output-Octets counter has wrapped around
+      //2^32 (refer to RFC 2869, section 5.2)
+      STORE32BE((uint32_t) (stats->sessionOctetsTx >> 32), buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_OUTPUT_GIGAWORDS, buffer,
+         sizeof(uint32_t));
+
+      //Number of packets received from the port (refer to RFC 2866,
+      //section 5.8)
+      STORE32BE(stats->sessionFramesRx, buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_INPUT_PACKETS, buffer,
+         sizeof(uint32_t));
+
+      //Number of packets sent to the port (refer to RFC 2866, section 5.9)
+      STORE32BE(stats->sessionFramesTx, buffer);
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_OUTPUT_PACKETS, buffer,
+         sizeof(uint32_t));
+   }
+
+   //The Acct-Terminate-Cause attribute indicates how the session was
+   //terminated (refer to RFC 2866, section 5.10)
+   if(statusType == RADIUS_ACCT_STATUS_TYPE_STOP)
+   {
+      STORE32BE(authenticatorGetAcctTerminateCause(
+         stats->sessionTerminateCause), buffer);
+
+      radiusAddAttribute(packet, RADIUS_ATTR_ACCT_TERMINATE_CAUSE, buffer,
+         sizeof(uint32_t));
+   }
+
+   //Save the parameters of the record
+   record->statusType = statusType;
+   record->eventTime = time;
+   record->retransCount = 0;
+   record->length = ntohs(packet->length);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Handle periodic accounting operations
+ *
+ * Interim updates are queued for a bounded number of ports per tick, and at
+ * most AUTHENTICATOR_ACCT_MAX_TX_PER_TICK packets are sent per tick, so that
+ * the accounting traffic is spread over time
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorTickAcct(AuthenticatorContext *context)
+{
+   //Accounting is disabled?
+   if(context->acctServerPort == 0)
+      return;
+
+   //Queue the interim updates that are due
+   authenticatorScanAcctInterim(context);
+   //Send the queued requests and retransmit the unanswered ones
+   authenticatorSendAcctRequests(context);
+}
+
+
+/**
+ * @brief Queue the interim updates that are due
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorScanAcctInterim(AuthenticatorContext *context)
+{
+   error_t error;
+   uint_t i;
+   uint_t k;
+   uint_t n;
+   systime_t time;
+   systime_t interval;
+   AuthenticatorPort *port;
+
+   //Interval between interim updates
+   interval = context->acctInterimInterval * 1000;
+
+   //Interim updates are disabled?
+   if(interval == 0)
+      return;
+
+   //Get current time
+   time = osGetSystemTime();
+   //Total number of sessions
+   n = context->numPorts + context->numHosts;
+
+   //A bounded number of sessions are examined per tick
+   for(k = 0; k < n && k < AUTHENTICATOR_ACCT_INTERIM_SCAN; k++)
+   {
+      //Index of the next session to be examined
+      i = context->acctInterimIndex;
+      context->acctInterimIndex = (i + 1) % n;
+
+      //The ports are examined first, then the additional sessions
+      if(i < context->numPorts)
+      {
+         port = &context->ports[i];
+      }
+      else
+      {
+         port = &context->hosts[i - context->numPorts];
+      }
+
+      //Acquire exclusive access to the ports of the shard
+      osAcquireMutex(&port->shard->mutex);
+
+      //Interim update due?
+      if(port->acctSessionActive && (time - port->acctUpdateTime) >= interval)
+      {
+         //Queue an Interim-Update record
+         error = authenticatorQueueAcctRequest(port,
+            RADIUS_ACCT_STATUS_TYPE_INTERIM_UPDATE);
+
+         //The update is attempted again on the next pass if the queue is full
+         if(!error)
+         {
+            port->acctUpdateTime = time;
+         }
+      }
+
+      //Release exclusive access to the ports of the shard
+      osReleaseMutex(&port->shard->mutex);
+   }
+}
+
+
+/**
+ * @brief Send the queued requests and retransmit the unanswered ones
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorSendAcctRequests(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint_t n;
+   systime_t time;
+   SocketMsg msg;
+   AuthenticatorAcctRecord *record;
+   AuthenticatorAcctRecord *records[AUTHENTICATOR_ACCT_MAX_TX_PER_TICK];
+
+   //Get current time
+   time = osGetSystemTime();
+   //Number of packets to be sent during this tick
+   n = 0;
+
+   //Format the UDP datagrams
+   msg = SOCKET_DEFAULT_MSG;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Loop through the accounting records
+   for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE &&
+      n < AUTHENTICATOR_ACCT_MAX_TX_PER_TICK; i++)
+   {
+      //Point to the current record
+      record = &context->acctQueue[i];
+
+      //Check the state of the record
+      if(record->state == AUTHENTICATOR_ACCT_RECORD_READY)
+      {
+         //Compute the Identifier and the Request Authenticator
+         authenticatorPrepareAcctRequest(context, record, time);
+
+         //The request is waiting for a response
+         record->state = AUTHENTICATOR_ACCT_RECORD_PENDING;
+         record->txTime = time;
+         records[n++] = record;
+
+         //Number of Accounting-Request packets sent
+         context->acctStats.requests++;
+      }
+      else if(record->state == AUTHENTICATOR_ACCT_RECORD_PENDING &&
+         (time - record->txTime) >= record->timeout)
+      {
+         //Any retransmission left?
+         if(record->retransCount < AUTHENTICATOR_ACCT_MAX_RETRANS)
+         {
+            //The retransmission timeout is doubled after each attempt
+            record->retransCount++;
+            record->timeout *= 2;
+            record->txTime = time;
+            records[n++] = record;
+
+            //Number of Accounting-Request packets retransmitted
+            context->acctStats.retransmissions++;
+         }
+         else
+         {
+            //Debug message
+            TRACE_WARNING("Accounting server is not responding!\r\n");
+
+            //The request is abandoned
+            record->state = AUTHENTICATOR_ACCT_RECORD_FREE;
+            context->acctStats.timeouts++;
+         }
+      }
+      else
+      {
+         //Just for sanity
+      }
+   }
+
+   //Accounting-Request packets are sent to the accounting server
+   msg.destIpAddr = context->acctServerIpAddr;
+   msg.destPort = context->acctServerPort;
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   //Specify the egress port
+   msg.switchPort = context->serverPortIndex;
+#endif
+
+   //The records are owned by the authenticator task while they are pending,
+   //so the datagrams can be sent without holding the mutex
+   for(i = 0; i < n; i++)
+   {
+      //Point to the Accounting-Request packet
+      msg.data = records[i]->buffer;
+      msg.length = records[i]->length;
+
+      //Debug message
+      TRACE_INFO("Sending RADIUS packet (%" PRIuSIZE " bytes)...\r\n",
+         msg.length);
+
+      //Dump RADIUS header contents for debugging purpose
+      radiusDumpPacket((RadiusPacket *) msg.data, msg.length);
+
+      //Send UDP datagram
+      socketSendMsg(context->acctSocket, &msg, 0);
+   }
+}
+
+
+/**
+ * @brief Compute the Identifier and the Request Authenticator of an
+ *   Accounting-Request packet
+ *
+ * The caller must hold the mutex of the 802.1X authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] record Accounting record
+ * @param[in] time Current time
+ **/
+
+void authenticatorPrepareAcctRequest(AuthenticatorContext *context,
+   AuthenticatorAcctRecord *record, systime_t time)
+{
+   uint_t i;
+   RadiusPacket *packet;
+
+   //Point to the RADIUS packet
+   packet = (RadiusPacket *) record->buffer;
+
+   //Select an Identifier that is not used by any pending request
+   do
+   {
+      //Increment identifier value
+      packet->identifier = ++context->acctIdentifier;
+
+      //Loop through the accounting records
+      for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE; i++)
+      {
+         //Identifier already in use?
+         if(context->acctQueue[i].state == AUTHENTICATOR_ACCT_RECORD_PENDING &&
+            context->acctQueue[i].buffer[1] == packet->identifier)
+         {
+            break;
+         }
+      }
+
+   } while(i < AUTHENTICATOR_ACCT_QUEUE_SIZE);
+
+   //Number of seconds the record has been waiting in the queue
+   STORE32BE((time - record->eventTime) / 1000,
+      record->buffer + record->delayTimeOffset);
+
+   //The Request Authenticator is an MD5 hash calculated over the packet,
+   //with the Authenticator field set to zero, followed by the shared secret
+   //(refer to RFC 2866, section 3)
+   osMemset(packet->authenticator, 0, 16);
+
+   md5Init(&context->acctMd5Context);
+   md5Update(&context->acctMd5Context, record->buffer, record->length);
+   md5Update(&context->acctMd5Context, context->acctKey, context->acctKeyLen);
+   md5Final(&context->acctMd5Context, packet->authenticator);
+
+   //Initial retransmission timeout
+   record->timeout = AUTHENTICATOR_ACCT_RETRANS_TIMEOUT;
+   record->retransCount = 0;
+}
+
+
+/**
+ * @brief Process incoming Accounting-Response packet
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Error code (an error is returned when no packet is available)
+ **/
+
+error_t authenticatorProcessAcctPacket(AuthenticatorContext *context)
+{
+   error_t error;
+   uint_t i;
+   size_t length;
+   SocketMsg msg;
+   AuthenticatorAcctRecord *record;
+   const RadiusPacket *packet;
+   const RadiusPacket *request;
+   uint8_t digest[MD5_DIGEST_SIZE];
+
+   //Point to the receive buffer of the RADIUS path
+   msg = SOCKET_DEFAULT_MSG;
+   msg.data = context->radiusRxBuffer;
+   msg.size = AUTHENTICATOR_RX_BUFFER_SIZE;
+
+   //Receive RADIUS packet
+   error = socketReceiveMsg(context->acctSocket, &msg, 0);
+   //Failed to receive packet
+   if(error)
+      return error;
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   //Check the port number on which the packet was received
+   if(msg.switchPort != context->serverPortIndex && context->serverPortIndex != 0)
+      return NO_ERROR;
+#endif
+
+   //Malformed RADIUS packet?
+   if(msg.length < sizeof(RadiusPacket))
+      return NO_ERROR;
+
+   //Point to the RADIUS packet
+   packet = (RadiusPacket *) context->radiusRxBuffer;
+   //Retrieve the length of the packet
+   length = ntohs(packet->length);
+
+   //If the packet is shorter than the Length field indicates, it must be
+   //silently discarded (refer to RFC 2866, section 3)
+   if(length < sizeof(RadiusPacket) || msg.length < length)
+      return NO_ERROR;
+
+   //Check RADIUS code
+   if(packet->code != RADIUS_CODE_ACCOUNTING_RESPONSE)
+      return NO_ERROR;
+
+   //Dump RADIUS header contents for debugging purpose
+   radiusDumpPacket(packet, length);
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Ensure the packet comes from the accounting server
+   if(ipCompAddr(&msg.srcIpAddr, &context->acctServerIpAddr) &&
+      msg.srcPort == context->acctServerPort)
+   {
+      //Loop through the accounting records
+      for(i = 0; i < AUTHENTICATOR_ACCT_QUEUE_SIZE; i++)
+      {
+         //Point to the current record
+         record = &context->acctQueue[i];
+         //Point to the Accounting-Request packet
+         request = (RadiusPacket *) record->buffer;
+
+         //The Identifier field aids in matching requests and replies
+         if(record->state == AUTHENTICATOR_ACCT_RECORD_PENDING &&
+            request->identifier == packet->identifier)
+         {
+            //The Response Authenticator is an MD5 hash calculated over the
+            //response, using the Request Authenticator of the request,
+            //followed by the shared secret (refer to RFC 2866, section 3)
+            md5Init(&context->acctMd5Context);
+            md5Update(&context->acctMd5Context, packet, 4);
+            md5Update(&context->acctMd5Context, request->authenticator, 16);
+            md5Update(&context->acctMd5Context, packet->attributes,
+               length - sizeof(RadiusPacket));
+            md5Update(&context->acctMd5Context, context->acctKey,
+               context->acctKeyLen);
+            md5Final(&context->acctMd5Context, digest);
+
+            //Invalid packets are silently discarded
+            if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) == 0)
+            {
+               //The record has been acknowledged by the accounting server
+               record->state = AUTHENTICATOR_ACCT_RECORD_FREE;
+               context->acctStats.responses++;
+            }
+            else
+            {
+               //Debug message
+               TRACE_WARNING("Invalid Response Authenticator value!\r\n");
+               //Number of invalid Accounting-Response packets
+               context->acctStats.malformed++;
+            }
+
+            //Exit immediately
+            break;
+         }
+      }
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The packet has been consumed
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Translate a session terminate cause into an Acct-Terminate-Cause value
+ * @param[in] cause Session terminate cause
+ * @return Value of the Acct-Terminate-Cause attribute
+ **/
+
+uint32_t authenticatorGetAcctTerminateCause(AuthenticatorTerminateCause cause)
+{
+   uint32_t value;
+
+   //The causes defined by IEEE 802.1X are mapped to their RADIUS
+   //equivalents (refer to RFC 3580, section 3.17)
+   switch(cause)
+   {
+   case AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_LOGOFF:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_USER_REQUEST;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_PORT_FAILURE:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_LOST_CARRIER;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_RESTART:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_SUPPLICANT_RESTART;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_REAUTH_FAILED:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_REAUTH_FAILURE;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_AUTH_CONTROL_FORCE_UNAUTH:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_ADMIN_RESET;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_PORT_REINIT:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_PORT_REINIT;
+      break;
+   case AUTHENTICATOR_TERMINATE_CAUSE_PORT_ADMIN_DISABLED:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_PORT_ADMIN_DISABLED;
+      break;
+   default:
+      value = RADIUS_ACCT_TERMINATE_CAUSE_NAS_REQUEST;
+      break;
+   }
+
+   //Return the value of the Acct-Terminate-Cause attribute
+   return value;
+}
+
+#endif
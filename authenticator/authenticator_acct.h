@@ -0,0 +1,78 @@
+/**
+ * @file authenticator_acct.h
+ * @brief RADIUS accounting
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_ACCT_H
+#define _AUTHENTICATOR_ACCT_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//RADIUS accounting
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+
+//Authenticator related functions
+void authenticatorUpdateAcctSession(AuthenticatorPort *port);
+
+error_t authenticatorQueueAcctRequest(AuthenticatorPort *port,
+   uint8_t statusType);
+
+error_t authenticatorFormatAcctRequest(AuthenticatorPort *port,
+   AuthenticatorAcctRecord *record, uint8_t statusType);
+
+void authenticatorTickAcct(AuthenticatorContext *context);
+void authenticatorScanAcctInterim(AuthenticatorContext *context);
+void authenticatorSendAcctRequests(AuthenticatorContext *context);
+
+void authenticatorPrepareAcctRequest(AuthenticatorContext *context,
+   AuthenticatorAcctRecord *record, systime_t time);
+
+error_t authenticatorProcessAcctPacket(AuthenticatorContext *context);
+
+uint32_t authenticatorGetAcctTerminateCause(AuthenticatorTerminateCause cause);
+
+#else
+
+//Stub functions
+#define authenticatorUpdateAcctSession(port)
+#define authenticatorTickAcct(context)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -37,6 +37,10 @@
 #include "authenticator/authenticator_backend_fsm.h"
 #include "authenticator/authenticator_procedures.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_trace.h"
+#include "authenticator/authenticator_event.h"
+#include "authenticator/authenticator_stream.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
 
@@ -57,6 +61,122 @@ const EapParamName authenticatorBackendStates[] =
 };
 
 
+//Global transition to the INITIALIZE state
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondInitialize,
+   port->portControl != AUTHENTICATOR_PORT_MODE_AUTO ||
+   port->initialize || port->authAbort)
+
+//IDLE to FAIL transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondStartFail,
+   port->eapFail && port->authStart)
+
+//IDLE to REQUEST transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondStartReq,
+   port->eapReq && port->authStart)
+
+//IDLE to SUCCESS transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondStartSuccess,
+   port->eapSuccess && port->authStart)
+
+//The supplicant is not responding to requests
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapTimeout,
+   port->eapTimeout)
+
+//An EAPOL PDU carrying an EAP-Packet has been received
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapolEap,
+   port->eapolEap)
+
+//An EAP frame is to be sent to the supplicant
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapReq,
+   port->eapReq)
+
+//No EAP frame is to be sent to the supplicant
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapNoReq,
+   port->eapNoReq)
+
+//The aWhile timer has expired
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondAwhile,
+   port->aWhile == 0)
+
+//The authentication has failed
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapFail,
+   port->eapFail)
+
+//The authentication process succeeds
+AUTHENTICATOR_FSM_CONDITION(authenticatorBackendCondEapSuccess,
+   port->eapSuccess)
+
+//Global transitions
+static const AuthenticatorFsmTransition authenticatorBackendGlobalTransitions[] =
+{
+   {authenticatorBackendCondInitialize, AUTHENTICATOR_BACKEND_STATE_INITIALIZE}
+};
+
+//Exit conditions of the INITIALIZE state
+static const AuthenticatorFsmTransition authenticatorBackendInitializeExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, AUTHENTICATOR_BACKEND_STATE_IDLE}
+};
+
+//Exit conditions of the IDLE state
+static const AuthenticatorFsmTransition authenticatorBackendIdleExits[] =
+{
+   {authenticatorBackendCondStartFail,    AUTHENTICATOR_BACKEND_STATE_FAIL},
+   {authenticatorBackendCondStartReq,     AUTHENTICATOR_BACKEND_STATE_REQUEST},
+   {authenticatorBackendCondStartSuccess, AUTHENTICATOR_BACKEND_STATE_SUCCESS}
+};
+
+//Exit conditions of the REQUEST state
+static const AuthenticatorFsmTransition authenticatorBackendRequestExits[] =
+{
+   {authenticatorBackendCondEapTimeout, AUTHENTICATOR_BACKEND_STATE_TIMEOUT},
+   {authenticatorBackendCondEapolEap,   AUTHENTICATOR_BACKEND_STATE_RESPONSE},
+   {authenticatorBackendCondEapReq,     AUTHENTICATOR_BACKEND_STATE_REQUEST}
+};
+
+//Exit conditions of the RESPONSE state
+static const AuthenticatorFsmTransition authenticatorBackendResponseExits[] =
+{
+   {authenticatorBackendCondEapNoReq,   AUTHENTICATOR_BACKEND_STATE_IGNORE},
+   {authenticatorBackendCondAwhile,     AUTHENTICATOR_BACKEND_STATE_TIMEOUT},
+   {authenticatorBackendCondEapFail,    AUTHENTICATOR_BACKEND_STATE_FAIL},
+   {authenticatorBackendCondEapSuccess, AUTHENTICATOR_BACKEND_STATE_SUCCESS},
+   {authenticatorBackendCondEapReq,     AUTHENTICATOR_BACKEND_STATE_REQUEST}
+};
+
+//Exit conditions of the IGNORE state
+static const AuthenticatorFsmTransition authenticatorBackendIgnoreExits[] =
+{
+   {authenticatorBackendCondEapolEap,   AUTHENTICATOR_BACKEND_STATE_RESPONSE},
+   {authenticatorBackendCondEapReq,     AUTHENTICATOR_BACKEND_STATE_REQUEST},
+   {authenticatorBackendCondEapTimeout, AUTHENTICATOR_BACKEND_STATE_TIMEOUT}
+};
+
+//Exit conditions of the FAIL, TIMEOUT and SUCCESS states
+static const AuthenticatorFsmTransition authenticatorBackendFinalExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, AUTHENTICATOR_BACKEND_STATE_IDLE}
+};
+
+//Exit conditions, listed in the order of the AuthenticatorBackendState values
+static const AuthenticatorFsmState authenticatorBackendExits[] =
+{
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendInitializeExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendIdleExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendRequestExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendResponseExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendIgnoreExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendFinalExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendFinalExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorBackendFinalExits)
+};
+
+//Transition table of the backend authentication state machine
+static const AuthenticatorFsmTable authenticatorBackendFsmTable =
+   AUTHENTICATOR_FSM_TABLE(authenticatorBackendGlobalTransitions,
+   authenticatorBackendExits);
+
+
 /**
  * @brief Backend authentication state machine initialization
  * @param[in] port Pointer to the port context
@@ -76,161 +196,16 @@ void authenticatorBackendInitFsm(AuthenticatorPort *port)
 
 void authenticatorBackendFsm(AuthenticatorPort *port)
 {
-   //A global transition can occur from any of the possible states. When the
-   //condition associated with a global transition is met, it supersedes all
-   //other exit conditions
-   if(port->portControl != AUTHENTICATOR_PORT_MODE_AUTO ||
-      port->initialize || port->authAbort)
-   {
-      //Switch to the INITIALIZE state
-      authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_INITIALIZE);
-   }
-   else
-   {
-      //All exit conditions for the state are evaluated continuously until one
-      //of the conditions is met (refer to IEEE Std 802.1X-2004, section 8.2.1)
-      switch(port->authBackendState)
-      {
-      //INITIALIZE state?
-      case AUTHENTICATOR_BACKEND_STATE_INITIALIZE:
-         //Unconditional transition (UCT) to IDLE state
-         authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_IDLE);
-         break;
-
-      //IDLE state?
-      case AUTHENTICATOR_BACKEND_STATE_IDLE:
-         //Evaluate conditions for the current state
-         if(port->eapFail && port->authStart)
-         {
-            //Switch to the FAIL state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_FAIL);
-         }
-         else if(port->eapReq && port->authStart)
-         {
-            //Switch to the REQUEST state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_REQUEST);
-         }
-         else if(port->eapSuccess && port->authStart)
-         {
-            //Switch to the SUCCESS state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_SUCCESS);
-         }
-         else
-         {
-            //Just for sanity
-         }
-
-         break;
-
-      //REQUEST state?
-      case AUTHENTICATOR_BACKEND_STATE_REQUEST:
-         //Evaluate conditions for the current state
-         if(port->eapTimeout)
-         {
-            //Switch to the TIMEOUT state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_TIMEOUT);
-         }
-         else if(port->eapolEap)
-         {
-            //Switch to the RESPONSE state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_RESPONSE);
-         }
-         else if(port->eapReq)
-         {
-            //Switch to the REQUEST state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_REQUEST);
-         }
-         else
-         {
-            //Just for sanity
-         }
-
-         break;
-
-      //RESPONSE state?
-      case AUTHENTICATOR_BACKEND_STATE_RESPONSE:
-         //Evaluate conditions for the current state
-         if(port->eapNoReq)
-         {
-            //Switch to the IGNORE state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_IGNORE);
-         }
-         else if(port->aWhile == 0)
-         {
-            //Switch to the TIMEOUT state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_TIMEOUT);
-         }
-         else if(port->eapFail)
-         {
-            //Switch to the FAIL state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_FAIL);
-         }
-         else if(port->eapSuccess)
-         {
-            //Switch to the SUCCESS state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_SUCCESS);
-         }
-         else if(port->eapReq)
-         {
-            //Switch to the REQUEST state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_REQUEST);
-         }
-         else
-         {
-            //Just for sanity
-         }
-
-         break;
-
-      //IGNORE state?
-      case AUTHENTICATOR_BACKEND_STATE_IGNORE:
-         //Evaluate conditions for the current state
-         if(port->eapolEap)
-         {
-            //Switch to the RESPONSE state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_RESPONSE);
-         }
-         else if(port->eapReq)
-         {
-            //Switch to the REQUEST state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_REQUEST);
-         }
-         else if(port->eapTimeout)
-         {
-            //Switch to the TIMEOUT state
-            authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_TIMEOUT);
-         }
-         else
-         {
-            //Just for sanity
-         }
+   uint_t newState;
 
-         break;
-
-      //FAIL state?
-      case AUTHENTICATOR_BACKEND_STATE_FAIL:
-         //Unconditional transition (UCT) to IDLE state
-         authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_IDLE);
-         break;
-
-      //TIMEOUT state?
-      case AUTHENTICATOR_BACKEND_STATE_TIMEOUT:
-         //Unconditional transition (UCT) to IDLE state
-         authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_IDLE);
-         break;
-
-      //SUCCESS state?
-      case AUTHENTICATOR_BACKEND_STATE_SUCCESS:
-         //Unconditional transition (UCT) to IDLE state
-         authenticatorBackendChangeState(port, AUTHENTICATOR_BACKEND_STATE_IDLE);
-         break;
-
-      //Invalid state?
-      default:
-         //Just for sanity
-         authenticatorFsmError(port->context);
-         break;
-      }
+   //Evaluate the exit conditions of the current state (refer to IEEE Std
+   //802.1X-2004, section 8.2.1)
+   if(authenticatorEvalFsm(port, &authenticatorBackendFsmTable,
+      port->authBackendState, &newState))
+   {
+      //Switch to the new state
+      authenticatorBackendChangeState(port,
+         (AuthenticatorBackendState) newState);
    }
 }
 
@@ -253,12 +228,15 @@ void authenticatorBackendChangeState(AuthenticatorPort *port,
    if(newState != oldState)
    {
       //Dump the state transition
-      TRACE_DEBUG("Port %" PRIu8 ": Backend authentication state machine %s -> %s\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": Backend authentication state machine %s -> %s\r\n",
          port->portIndex,
          eapGetParamName(oldState, authenticatorBackendStates,
          arraysize(authenticatorBackendStates)),
          eapGetParamName(newState, authenticatorBackendStates,
          arraysize(authenticatorBackendStates)));
+
+      //Record the state transition
+      authenticatorTraceStateChange(port, AUTHENTICATOR_TRACE_EVENT_BACKEND_STATE, oldState, newState);
    }
 
    //Switch to the new state
@@ -302,7 +280,8 @@ void authenticatorBackendChangeState(AuthenticatorPort *port,
       port->authTimeout = FALSE;
       port->eapolEap = FALSE;
       port->eapNoReq = FALSE;
-      port->aWhile = port->serverTimeout;
+      authenticatorStartTimer(port, AUTHENTICATOR_TIMER_A_WHILE,
+         port->serverTimeout * 1000);
       port->eapResp = TRUE;
       authenticatorSendRespToServer(port);
       break;
@@ -331,6 +310,10 @@ void authenticatorBackendChangeState(AuthenticatorPort *port,
       //to signal to the Authenticator state machine that the authentication
       //session has terminated with a timeout
       port->authTimeout = TRUE;
+
+      //Report the timeout through the session event stream
+      authenticatorWriteSessionEvent(port,
+         AUTHENTICATOR_SESSION_EVENT_TIMED_OUT);
       break;
 
    //SUCCESS state?
@@ -357,8 +340,13 @@ void authenticatorBackendChangeState(AuthenticatorPort *port,
       //Any registered callback?
       if(port->context->backendStateChangeCallback != NULL)
       {
-         //Invoke user callback function
-         port->context->backendStateChangeCallback(port, newState);
+         //The callback is either deferred or invoked synchronously
+         if(!authenticatorQueueEvent(port, AUTHENTICATOR_EVENT_BACKEND_STATE,
+            newState))
+         {
+            //Invoke user callback function
+            port->context->backendStateChangeCallback(port, newState);
+         }
       }
    }
 
@@ -367,7 +355,7 @@ void authenticatorBackendChangeState(AuthenticatorPort *port,
       !port->initialize && !port->authAbort)
    {
       //The backend authentication state machine is busy
-      port->context->busy = TRUE;
+      port->busy = TRUE;
    }
 }
 
@@ -0,0 +1,632 @@
+/**
+ * @file authenticator_buffer.c
+ * @brief Session buffer management
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_server.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Initialize the pool of session buffers
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorInitBufferPool(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint8_t *p;
+#if (AUTHENTICATOR_STATIC_BUFFER_SUPPORT == ENABLED)
+   AuthenticatorBuffer *buffer;
+   AuthenticatorPortData *data;
+#endif
+
+   //Initialize the free list
+   context->freeBuffers = NULL;
+
+#if (AUTHENTICATOR_STATIC_BUFFER_SUPPORT == ENABLED)
+   //No pool supplied by the caller?
+   if(context->buffers == NULL)
+   {
+      //The ports and the additional sessions contribute their built-in
+      //session buffer to the pool
+      context->numBuffers = context->numPorts + context->numHosts;
+
+      //Chain all the built-in session buffers together
+      for(i = context->numBuffers; i > 0; i--)
+      {
+         //Point to the cold record holding the session buffer
+         if(i > context->numPorts)
+         {
+            data = context->hosts[i - 1 - context->numPorts].data;
+         }
+         else
+         {
+            data = context->ports[i - 1].data;
+         }
+
+         //Each session buffer holds two transmission buffers
+         buffer = &data->staticBuffer;
+         buffer->eapTxBuffer = data->staticBufferMemory;
+         buffer->aaaTxBuffer = data->staticBufferMemory + context->txBufferSize;
+
+         //Add the session buffer to the free list
+         buffer->next = context->freeBuffers;
+         context->freeBuffers = buffer;
+      }
+
+      //Ports waiting for a session buffer are served in a round-robin fashion
+      context->bufferWaitIndex = 0;
+      //Exit immediately
+      return;
+   }
+#endif
+
+   //Chain all the session buffers together
+   for(i = context->numBuffers; i > 0; i--)
+   {
+      //Point to the memory backing the session buffer
+      p = context->bufferMemory + (i - 1) * 2 * context->txBufferSize;
+
+      //Each session buffer holds two transmission buffers
+      context->buffers[i - 1].eapTxBuffer = p;
+      context->buffers[i - 1].aaaTxBuffer = p + context->txBufferSize;
+
+      //Add the session buffer to the free list
+      context->buffers[i - 1].next = context->freeBuffers;
+      context->freeBuffers = &context->buffers[i - 1];
+   }
+
+   //Ports waiting for a session buffer are served in a round-robin fashion
+   context->bufferWaitIndex = 0;
+}
+
+
+/**
+ * @brief Bind a session buffer to the port
+ * @param[in] port Pointer to the port context
+ * @param[in] buffer Session buffer
+ **/
+
+void authenticatorBindPortBuffer(AuthenticatorPort *port,
+   AuthenticatorBuffer *buffer)
+{
+   //Attach the session buffer to the port
+   port->buffer = buffer;
+   port->bufferWait = FALSE;
+
+   //EAP requests are formatted right after the EAPOL header
+   port->eapReqData = buffer->eapTxBuffer + sizeof(EapolPdu);
+   port->eapReqDataLen = 0;
+   port->lastReqData = NULL;
+   port->lastReqDataLen = 0;
+   port->aaaEapReqData = buffer->eapTxBuffer + sizeof(EapolPdu);
+   port->aaaEapReqDataLen = 0;
+
+   //RADIUS requests are formatted in a separate buffer
+   port->aaaReqData = buffer->aaaTxBuffer;
+   port->aaaReqDataLen = 0;
+}
+
+
+/**
+ * @brief Borrow a session buffer from the pool
+ * @param[in] port Pointer to the port context
+ * @return TRUE if a session buffer is attached to the port, FALSE if the pool
+ *   is exhausted
+ **/
+
+bool_t authenticatorAllocPortBuffer(AuthenticatorPort *port)
+{
+   bool_t wait;
+   AuthenticatorBuffer *buffer;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //A session buffer is already attached to the port?
+   if(port->buffer != NULL)
+      return TRUE;
+
+   //The pool is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Check whether the port has already been waiting
+   wait = port->bufferWait;
+
+   //Any session buffer handed over by another shard?
+   if(port->grantedBuffer != NULL)
+   {
+      //The session has already been admitted
+      buffer = port->grantedBuffer;
+      port->grantedBuffer = NULL;
+   }
+   else if(authenticatorCheckAdmission(context))
+   {
+      //Remove the first free session buffer from the free list
+      buffer = context->freeBuffers;
+      context->freeBuffers = buffer->next;
+      buffer->next = NULL;
+
+      //One more port is authenticating
+      context->numSessions++;
+   }
+   else
+   {
+      //The session cannot be admitted for the moment
+      buffer = NULL;
+   }
+
+   //Any session buffer available?
+   if(buffer != NULL)
+   {
+      //Attach the session buffer to the port
+      authenticatorBindPortBuffer(port, buffer);
+   }
+   else
+   {
+      //The port will be served as soon as a session buffer is released.
+      //Reauthentications of authorized ports may be given a lower priority
+      port->bufferWait = TRUE;
+      port->bufferWaitReauth = (port->authPortStatus ==
+         AUTHENTICATOR_PORT_STATUS_AUTH) ? TRUE : FALSE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The session cannot be admitted?
+   if(buffer == NULL)
+   {
+      //Debug message
+      if(!wait)
+      {
+         TRACE_WARNING("Port %" PRIu16 ": No session buffer available!\r\n",
+            port->portIndex);
+      }
+
+      //Report an error
+      return FALSE;
+   }
+
+   //Successful processing
+   return TRUE;
+}
+
+
+/**
+ * @brief Return the session buffer of the port to the pool
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorFreePortBuffer(AuthenticatorPort *port)
+{
+   uint_t index;
+   AuthenticatorBuffer *buffer;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Index of the (socket, Identifier) pair used by the pending request
+   index = port->aaaReqSocketIndex * 256 + port->aaaReqId;
+
+   //The pool is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //The port is no longer waiting for a session buffer
+   port->bufferWait = FALSE;
+
+   //The Access-Request held by the session buffer can no longer be answered,
+   //so that a late response is not routed to the port
+   if(context->radiusReqTable[index] == port)
+   {
+      authenticatorReleaseRadiusIndex(context, index);
+   }
+
+   //The request no longer counts against the window of the server
+   authenticatorReleaseRadiusSlot(port);
+
+   //The session no longer counts against its RADIUS server
+   authenticatorUnbindRadiusServer(port);
+
+   //Any session buffer attached to the port?
+   if(port->buffer != NULL)
+   {
+      //Detach the session buffer from the port
+      buffer = port->buffer;
+      port->buffer = NULL;
+   }
+   else if(port->grantedBuffer != NULL)
+   {
+      //The port gave up before the granted session buffer was claimed
+      buffer = port->grantedBuffer;
+      port->grantedBuffer = NULL;
+   }
+   else
+   {
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
+      //Exit immediately
+      return;
+   }
+
+   //The transmission buffers can no longer be referenced
+   port->eapReqData = NULL;
+   port->eapReqDataLen = 0;
+   port->lastReqData = NULL;
+   port->lastReqDataLen = 0;
+   port->aaaEapReqData = NULL;
+   port->aaaEapReqDataLen = 0;
+   port->aaaReqData = NULL;
+   port->aaaReqDataLen = 0;
+
+   //Return the session buffer to the free list
+   buffer->next = context->freeBuffers;
+   context->freeBuffers = buffer;
+
+   //The port is no longer authenticating
+   if(context->numSessions > 0)
+   {
+      context->numSessions--;
+   }
+
+   //Serve the ports that are waiting for a session buffer
+   authenticatorGrantPortBuffers(context, port->shard);
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+
+/**
+ * @brief Check whether a new session can be admitted
+ *
+ * The number of concurrently authenticating ports is bounded by the size of
+ * the pool, by the global limit and by the sum of the limits of the RADIUS
+ * servers. The caller is responsible for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return TRUE if the session can be admitted, else FALSE
+ **/
+
+bool_t authenticatorCheckAdmission(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint_t capacity;
+   AuthenticatorRadiusServer *server;
+
+   //The pool is exhausted?
+   if(context->freeBuffers == NULL)
+      return FALSE;
+
+   //The global limit has been reached?
+   if(context->maxSessions != 0 && context->numSessions >= context->maxSessions)
+      return FALSE;
+
+   //Initialize variable
+   capacity = 0;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the current entry
+      server = &context->servers[i];
+
+      //Enabled server?
+      if(server->enabled)
+      {
+         //A server without limit can absorb any number of sessions
+         if(server->maxSessions == 0)
+            return TRUE;
+
+         //Add the capacity of the server
+         capacity += server->maxSessions;
+      }
+   }
+
+   //Sessions that have been admitted but not yet assigned to a server are
+   //taken into account
+   return (context->numSessions < capacity) ? TRUE : FALSE;
+}
+
+
+/**
+ * @brief Select the next port to be served among the waiting ports
+ *
+ * Waiting ports are served in a round-robin fashion, starting from the one
+ * following the port that was served last. When new sessions are preferred,
+ * reauthentications of authorized ports are only served once no unauthorized
+ * port is waiting. The caller is responsible for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Pointer to the selected port (NULL if no port is waiting)
+ **/
+
+AuthenticatorPort *authenticatorSelectWaitingPort(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint_t j;
+   uint_t k;
+   uint_t n;
+   bool_t reauth;
+   AuthenticatorPort *port;
+
+   //The additional sessions of multi-supplicant ports are served after the
+   //ports
+   n = context->numPorts + context->numHosts;
+
+   //New sessions are considered during the first pass when they are preferred
+   for(j = 0; j < 2; j++)
+   {
+      //Skip the first pass if all the waiting ports are treated alike
+      if(j == 0 && context->admissionPolicy == AUTHENTICATOR_ADMISSION_POLICY_FAIR)
+         continue;
+
+      //Consider reauthentications during the second pass only
+      reauth = (j == 0) ? FALSE : TRUE;
+
+      //Loop through the ports, starting from the one following the port that
+      //was served last
+      for(i = 0; i < n; i++)
+      {
+         //Index of the current port
+         k = (context->bufferWaitIndex + i) % n;
+
+         //Point to the current port
+         if(k < context->numPorts)
+         {
+            port = &context->ports[k];
+         }
+         else
+         {
+            port = &context->hosts[k - context->numPorts];
+         }
+
+         //Is the port waiting for a session buffer that has not been granted
+         //yet?
+         if(port->bufferWait && port->grantedBuffer == NULL &&
+            (reauth || !port->bufferWaitReauth))
+         {
+            //Update round-robin index
+            context->bufferWaitIndex = (k + 1) % n;
+            //Return a pointer to the selected port
+            return port;
+         }
+      }
+   }
+
+   //No port is waiting
+   return NULL;
+}
+
+
+/**
+ * @brief Hand the free session buffers over to the waiting ports
+ *
+ * The ports of the specified shard are served directly. The ports of other
+ * shards can only be modified by the task that owns them, so the session
+ * buffer is set aside and the shard is notified. The caller is responsible
+ * for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] shard Shard owned by the calling task (NULL if none)
+ **/
+
+void authenticatorGrantPortBuffers(AuthenticatorContext *context,
+   AuthenticatorShard *shard)
+{
+   AuthenticatorBuffer *buffer;
+   AuthenticatorPort *port;
+
+   //Admit as many waiting sessions as possible
+   while(authenticatorCheckAdmission(context))
+   {
+      //Select the next port to be served
+      port = authenticatorSelectWaitingPort(context);
+
+      //No port is waiting?
+      if(port == NULL)
+         break;
+
+      //Remove the first free session buffer from the free list
+      buffer = context->freeBuffers;
+      context->freeBuffers = buffer->next;
+      buffer->next = NULL;
+
+      //One more port is authenticating
+      context->numSessions++;
+
+      //Check whether the port belongs to the calling task
+      if(port->shard == shard)
+      {
+         //Hand the session buffer over to the waiting port
+         authenticatorBindPortBuffer(port, buffer);
+
+         //The deferred restart can now proceed
+         port->eapRestart = TRUE;
+         authenticatorSchedulePort(port);
+      }
+      else
+      {
+         //The session buffer is set aside for the port
+         port->grantedBuffer = buffer;
+
+         //The shard will attach the session buffer on its own
+         port->shard->bufferRetry = TRUE;
+         osSetEvent(&port->shard->event);
+      }
+   }
+}
+
+
+/**
+ * @brief Retrieve a free buffer of the EAPOL receive ring
+ *
+ * Only the reception task takes buffers from the ring. A free buffer hence
+ * remains free until it is claimed by the reception task
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Pointer to the receive buffer (NULL if all the buffers are owned
+ *   by a port)
+ **/
+
+AuthenticatorRxBuffer *authenticatorGetRxBuffer(AuthenticatorContext *context)
+{
+   uint_t i;
+   AuthenticatorRxBuffer *buffer;
+   AuthenticatorRxBuffer *freeBuffer;
+
+   //Initialize pointer
+   freeBuffer = NULL;
+
+   //The ring is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Loop through the ring, starting from the buffer following the one that
+   //was used last
+   for(i = 0; i < AUTHENTICATOR_EAPOL_RX_RING_SIZE; i++)
+   {
+      //Point to the current buffer
+      buffer = &context->eapolRxRing[(context->eapolRxIndex + i) %
+         AUTHENTICATOR_EAPOL_RX_RING_SIZE];
+
+      //Free buffer?
+      if(buffer->owner == NULL)
+      {
+         //Update ring index
+         context->eapolRxIndex = (context->eapolRxIndex + i + 1) %
+            AUTHENTICATOR_EAPOL_RX_RING_SIZE;
+
+         //We are done
+         freeBuffer = buffer;
+         break;
+      }
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return a pointer to the receive buffer
+   return freeBuffer;
+}
+
+
+/**
+ * @brief Reserve a receive buffer for the port a PDU is destined to
+ * @param[in] port Pointer to the port context
+ * @param[in] buffer Receive buffer
+ **/
+
+void authenticatorClaimRxBuffer(AuthenticatorPort *port,
+   AuthenticatorRxBuffer *buffer)
+{
+   //The ring is shared by all the shards
+   osAcquireMutex(&port->context->mutex);
+   //The buffer can no longer be used by the reception task
+   buffer->owner = port;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&port->context->mutex);
+}
+
+
+/**
+ * @brief Return a receive buffer to the EAPOL receive ring
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] buffer Receive buffer
+ **/
+
+void authenticatorReleaseRxBuffer(AuthenticatorContext *context,
+   AuthenticatorRxBuffer *buffer)
+{
+   //The ring is shared by all the shards
+   osAcquireMutex(&context->mutex);
+   //The buffer can be reused by the reception task
+   buffer->owner = NULL;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+
+/**
+ * @brief Hand a receive buffer over to the port
+ *
+ * The buffer holds the EAP response to be processed by the state machines of
+ * the port. Any previous response that has not been consumed yet is discarded
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] buffer Receive buffer
+ **/
+
+void authenticatorAttachRxBuffer(AuthenticatorPort *port,
+   AuthenticatorRxBuffer *buffer)
+{
+   //Any receive buffer already attached to the port?
+   if(port->rxBuffer != NULL && port->rxBuffer != buffer)
+   {
+      //Return the previous buffer to the ring
+      authenticatorReleaseRxBuffer(port->context, port->rxBuffer);
+   }
+
+   //The port now owns the receive buffer
+   port->rxBuffer = buffer;
+}
+
+
+/**
+ * @brief Return the receive buffer of the port to the EAPOL receive ring
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorDetachRxBuffer(AuthenticatorPort *port)
+{
+   //Any receive buffer attached to the port?
+   if(port->rxBuffer != NULL)
+   {
+      //Return the buffer to the ring
+      authenticatorReleaseRxBuffer(port->context, port->rxBuffer);
+      port->rxBuffer = NULL;
+   }
+
+   //The EAP response can no longer be referenced
+   port->eapRespData = NULL;
+   port->eapRespDataLen = 0;
+}
+
+#endif
@@ -0,0 +1,282 @@
+/**
+ * @file authenticator_cache.c
+ * @brief Authorization cache
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_pae_fsm.h"
+#include "authenticator/authenticator_reauth_timer_fsm.h"
+#include "authenticator/authenticator_cache.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_latency.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Record a successful authentication
+ *
+ * The entry is valid for the configured lifetime, which is further bounded
+ * by the Session-Timeout attribute of the Access-Accept
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] sessionTimeout Value of the Session-Timeout attribute, in
+ *   seconds (0 if the attribute is not present)
+ **/
+
+void authenticatorUpdateAuthCache(AuthenticatorPort *port,
+   uint32_t sessionTimeout)
+{
+   uint_t i;
+   systime_t time;
+   systime_t lifetime;
+   AuthenticatorAuthCacheEntry *entry;
+   AuthenticatorAuthCacheEntry *oldestEntry;
+
+   //Lifetime of the cache entries
+   lifetime = port->context->authCacheTtl * 1000;
+
+   //The authorization cache is disabled?
+   if(lifetime == 0)
+      return;
+
+   //Additional sessions are released when their supplicant disconnects
+   if(port->host)
+      return;
+
+   //The cached authorization must not outlive the session
+   if(sessionTimeout > 0)
+   {
+      lifetime = MIN(lifetime, (systime_t) sessionTimeout * 1000);
+   }
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Keep track of the oldest entry
+   oldestEntry = &port->data->authCache[0];
+
+   //Loop through the cache entries
+   for(i = 0; i < AUTHENTICATOR_AUTH_CACHE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &port->data->authCache[i];
+
+      //Matching entry?
+      if(entry->valid && macCompAddr(&entry->macAddr, &port->supplicantMacAddr))
+      {
+         oldestEntry = entry;
+         break;
+      }
+      else if(!entry->valid)
+      {
+         //Free entries are used first
+         if(oldestEntry->valid)
+         {
+            oldestEntry = entry;
+         }
+      }
+      else if(oldestEntry->valid &&
+         (time - entry->timestamp) > (time - oldestEntry->timestamp))
+      {
+         //Keep track of the oldest entry
+         oldestEntry = entry;
+      }
+      else
+      {
+         //Just for sanity
+      }
+   }
+
+   //Save the MAC address of the supplicant
+   oldestEntry->valid = TRUE;
+   oldestEntry->macAddr = port->supplicantMacAddr;
+   oldestEntry->timestamp = time;
+   oldestEntry->lifetime = lifetime;
+}
+
+
+/**
+ * @brief Remove the entry of the current supplicant from the cache
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorRemoveAuthCacheEntry(AuthenticatorPort *port)
+{
+   uint_t i;
+   AuthenticatorAuthCacheEntry *entry;
+
+   //Loop through the cache entries
+   for(i = 0; i < AUTHENTICATOR_AUTH_CACHE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &port->data->authCache[i];
+
+      //Matching entry?
+      if(entry->valid && macCompAddr(&entry->macAddr, &port->supplicantMacAddr))
+      {
+         //Invalidate the entry
+         entry->valid = FALSE;
+      }
+   }
+}
+
+
+/**
+ * @brief Flush the authorization cache of a port
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorFlushPortAuthCache(AuthenticatorPort *port)
+{
+   uint_t i;
+
+   //Loop through the cache entries
+   for(i = 0; i < AUTHENTICATOR_AUTH_CACHE_SIZE; i++)
+   {
+      //Invalidate the current entry
+      port->data->authCache[i].valid = FALSE;
+   }
+}
+
+
+/**
+ * @brief Check whether the current supplicant has been recently authorized
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the cache holds a valid entry for the supplicant
+ **/
+
+bool_t authenticatorCheckAuthCache(AuthenticatorPort *port)
+{
+   uint_t i;
+   bool_t found;
+   systime_t time;
+   AuthenticatorAuthCacheEntry *entry;
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Initialize flag
+   found = FALSE;
+
+   //Loop through the cache entries
+   for(i = 0; i < AUTHENTICATOR_AUTH_CACHE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &port->data->authCache[i];
+
+      //Valid entry?
+      if(entry->valid)
+      {
+         //Expired entries are removed from the cache
+         if((time - entry->timestamp) >= entry->lifetime)
+         {
+            entry->valid = FALSE;
+         }
+         else if(macCompAddr(&entry->macAddr, &port->supplicantMacAddr))
+         {
+            found = TRUE;
+         }
+         else
+         {
+            //Just for sanity
+         }
+      }
+   }
+
+   //Return TRUE if the supplicant has been recently authorized
+   return found;
+}
+
+
+/**
+ * @brief Re-admit a recently authorized supplicant
+ *
+ * When the supplicant comes back after a link flap, the port is authorized
+ * immediately. A reauthentication takes place in the background to confirm
+ * the decision with the authentication server
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorReadmitPort(AuthenticatorPort *port)
+{
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": Supplicant re-admitted from authorization cache\r\n",
+      port->portIndex);
+
+   //Authorize the controlled port
+   authenticatorResumeSession(port);
+
+   //The authentication server confirms the decision
+   port->reAuthenticate = TRUE;
+   //The event will be processed by the state machines of the port
+   authenticatorSchedulePort(port);
+}
+
+
+/**
+ * @brief Authorize a port without exchanging any EAP message
+ *
+ * The state machines of the port are moved to the states they reach after
+ * a successful authentication
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorResumeSession(AuthenticatorPort *port)
+{
+   //The Request-Identity that may have been sent is not retransmitted
+   authenticatorStopTimer(port, AUTHENTICATOR_TIMER_RETRANS_WHILE);
+
+   //The EAP conversation is considered complete
+   port->aaaEapReqData = NULL;
+   port->aaaEapReqDataLen = 0;
+   port->aaaEapKeyData = NULL;
+   port->aaaEapKeyAvailable = FALSE;
+   eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SUCCESS2);
+
+   //No authentication time is measured for the resumed session
+   authenticatorCancelLatency(port, AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+
+   //The controlled port is authorized
+   authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_AUTHENTICATED);
+
+   //The reauthentication timer is restarted
+   authenticatorReauthTimerChangeState(port,
+      AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE);
+}
+
+#endif
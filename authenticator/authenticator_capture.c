@@ -0,0 +1,749 @@
+/**
+ * @file authenticator_capture.c
+ * @brief Capture and replay of EAPOL/RADIUS exchanges
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_capture.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_shard.h"
+#include "authenticator/authenticator_host.h"
+#include "radius/radius_attributes.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Write the Section Header Block and the Interface Description Blocks
+ *
+ * Interface i describes the EAPOL traffic of the (i + 1)th port. The last
+ * interface carries the RADIUS traffic
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+static void authenticatorWriteCaptureHeader(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint8_t block[32];
+
+   //Format the Section Header Block
+   STORE32LE(PCAPNG_BLOCK_TYPE_SHB, block);
+   STORE32LE(28, block + 4);
+   STORE32LE(PCAPNG_BYTE_ORDER_MAGIC, block + 8);
+   STORE16LE(1, block + 12);
+   STORE16LE(0, block + 14);
+
+   //The length of the section is not specified
+   osMemset(block + 16, 0xFF, 8);
+   STORE32LE(28, block + 24);
+
+   //Write the Section Header Block
+   context->captureCallback(context, block, 28);
+
+   //Loop through the interfaces
+   for(i = 0; i <= context->numPorts; i++)
+   {
+      //Format the Interface Description Block
+      STORE32LE(PCAPNG_BLOCK_TYPE_IDB, block);
+      STORE32LE(32, block + 4);
+      STORE16LE((i < context->numPorts) ? PCAPNG_LINKTYPE_ETHERNET :
+         PCAPNG_LINKTYPE_RAW, block + 8);
+      STORE16LE(0, block + 10);
+      STORE32LE(0, block + 12);
+
+      //Timestamps are expressed in milliseconds
+      STORE16LE(PCAPNG_OPT_IF_TSRESOL, block + 16);
+      STORE16LE(1, block + 18);
+      osMemset(block + 20, 0, 4);
+      block[20] = 3;
+
+      //Terminate the list of options
+      STORE16LE(PCAPNG_OPT_ENDOFOPT, block + 24);
+      STORE16LE(0, block + 26);
+      STORE32LE(32, block + 28);
+
+      //Write the Interface Description Block
+      context->captureCallback(context, block, 32);
+   }
+}
+
+
+/**
+ * @brief Write an Enhanced Packet Block
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] interfaceId Interface the packet relates to
+ * @param[in] inbound Direction of the packet
+ * @param[in] header Pseudo header preceding the packet
+ * @param[in] headerLen Length of the pseudo header, in bytes
+ * @param[in] data Pointer to the packet
+ * @param[in] length Length of the packet, in bytes
+ **/
+
+static void authenticatorWriteCaptureBlock(AuthenticatorContext *context,
+   uint_t interfaceId, bool_t inbound, const uint8_t *header,
+   size_t headerLen, const uint8_t *data, size_t length)
+{
+   size_t n;
+   size_t padding;
+   uint64_t time;
+   uint8_t block[28];
+   uint8_t trailer[19];
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Length of the captured packet, including the pseudo header
+   n = headerLen + length;
+   //The packet data is padded to a 32-bit boundary
+   padding = (4 - (n % 4)) % 4;
+
+   //Format the fixed part of the Enhanced Packet Block
+   STORE32LE(PCAPNG_BLOCK_TYPE_EPB, block);
+   STORE32LE(n + padding + 44, block + 4);
+   STORE32LE(interfaceId, block + 8);
+   STORE32LE((uint32_t) (time >> 32), block + 12);
+   STORE32LE((uint32_t) time, block + 16);
+   STORE32LE(n, block + 20);
+   STORE32LE(n, block + 24);
+
+   //Format the padding, the options and the trailing length
+   osMemset(trailer, 0, padding);
+   STORE16LE(PCAPNG_OPT_EPB_FLAGS, trailer + padding);
+   STORE16LE(4, trailer + padding + 2);
+   STORE32LE(inbound ? PCAPNG_EPB_FLAGS_INBOUND : PCAPNG_EPB_FLAGS_OUTBOUND,
+      trailer + padding + 4);
+   STORE16LE(PCAPNG_OPT_ENDOFOPT, trailer + padding + 8);
+   STORE16LE(0, trailer + padding + 10);
+   STORE32LE(n + padding + 44, trailer + padding + 12);
+
+   //Acquire exclusive access to the capture
+   osAcquireMutex(&context->captureMutex);
+
+   //The capture starts with the Section Header Block
+   if(!context->captureStarted)
+   {
+      authenticatorWriteCaptureHeader(context);
+      context->captureStarted = TRUE;
+   }
+
+   //Write the Enhanced Packet Block in consecutive chunks
+   context->captureCallback(context, block, sizeof(block));
+   context->captureCallback(context, header, headerLen);
+   context->captureCallback(context, data, length);
+   context->captureCallback(context, trailer, padding + 16);
+
+   //Release exclusive access to the capture
+   osReleaseMutex(&context->captureMutex);
+}
+
+
+/**
+ * @brief Capture an EAPOL PDU
+ * @param[in] port Pointer to the port context
+ * @param[in] srcMacAddr Source MAC address
+ * @param[in] destMacAddr Destination MAC address
+ * @param[in] inbound TRUE for a received PDU, FALSE for a transmitted PDU
+ * @param[in] pdu Pointer to the EAPOL PDU
+ * @param[in] length Length of the EAPOL PDU, in bytes
+ **/
+
+void authenticatorCaptureEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, const MacAddr *destMacAddr, bool_t inbound,
+   const uint8_t *pdu, size_t length)
+{
+   AuthenticatorContext *context;
+   uint8_t header[sizeof(EthHeader)];
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Capture disabled?
+   if(context->captureCallback == NULL)
+      return;
+
+   //The PDU is preceded by an Ethernet header
+   osMemcpy(header, destMacAddr, sizeof(MacAddr));
+   osMemcpy(header + 6, srcMacAddr, sizeof(MacAddr));
+   STORE16BE(ETH_TYPE_EAPOL, header + 12);
+
+   //Each port is captured on its own interface
+   authenticatorWriteCaptureBlock(context,
+      authenticatorGetPhysicalPort(port) - context->ports, inbound, header,
+      sizeof(header), pdu, length);
+}
+
+
+/**
+ * @brief Capture a RADIUS packet
+ *
+ * The packet is encapsulated in an IP/UDP pseudo header. The local endpoint
+ * is left unspecified
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIpAddr IP address of the RADIUS server
+ * @param[in] serverPort Port number of the RADIUS server
+ * @param[in] inbound TRUE for a received packet, FALSE for a transmitted
+ *   packet
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ **/
+
+void authenticatorCaptureRadiusPacket(AuthenticatorContext *context,
+   const IpAddr *serverIpAddr, uint16_t serverPort, bool_t inbound,
+   const uint8_t *packet, size_t length)
+{
+   size_t n;
+   uint16_t checksum;
+   uint8_t *udpHeader;
+   uint8_t header[48];
+
+   //Capture disabled?
+   if(context->captureCallback == NULL)
+      return;
+
+   //Clear the pseudo header
+   osMemset(header, 0, sizeof(header));
+
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 server?
+   if(serverIpAddr->length == sizeof(Ipv6Addr))
+   {
+      //Format the IPv6 header
+      header[0] = 0x60;
+      STORE16BE(length + 8, header + 4);
+      header[6] = 17;
+      header[7] = 64;
+
+      //The server is either the source or the destination of the packet
+      osMemcpy(header + (inbound ? 8 : 24), &serverIpAddr->ipv6Addr,
+         sizeof(Ipv6Addr));
+
+      //Length of the IPv6 header
+      n = 40;
+   }
+   else
+#endif
+   {
+      //Format the IPv4 header
+      header[0] = 0x45;
+      STORE16BE(length + 28, header + 2);
+      header[8] = 64;
+      header[9] = 17;
+
+#if (IPV4_SUPPORT == ENABLED)
+      //The server is either the source or the destination of the packet
+      if(serverIpAddr->length == sizeof(Ipv4Addr))
+      {
+         osMemcpy(header + (inbound ? 12 : 16), &serverIpAddr->ipv4Addr,
+            sizeof(Ipv4Addr));
+      }
+#endif
+
+      //Calculate the header checksum
+      checksum = ipCalcChecksum(header, 20);
+      osMemcpy(header + 10, &checksum, sizeof(uint16_t));
+
+      //Length of the IPv4 header
+      n = 20;
+   }
+
+   //Point to the UDP header
+   udpHeader = header + n;
+
+   //Format the UDP header. The checksum is not calculated
+   STORE16BE(inbound ? serverPort : 0, udpHeader);
+   STORE16BE(inbound ? 0 : serverPort, udpHeader + 2);
+   STORE16BE(length + 8, udpHeader + 4);
+
+   //The RADIUS traffic is captured on the last interface
+   authenticatorWriteCaptureBlock(context, context->numPorts, inbound,
+      header, n + 8, packet, length);
+}
+
+
+/**
+ * @brief Recompute the authenticators of a captured RADIUS response
+ *
+ * The response is bound to the pending request of the session. The captured
+ * signatures are replaced with the ones computed from the shared secret of the
+ * RADIUS server the session is currently assigned to
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in,out] packet Pointer to the RADIUS packet
+ **/
+
+static void authenticatorResignRadiusResponse(AuthenticatorPort *port,
+   RadiusPacket *packet)
+{
+   size_t length;
+   Md5Context md5Context;
+   RadiusAttribute *attribute;
+   const AuthenticatorRadiusServer *server;
+
+   //Point to the RADIUS server the session is assigned to
+   server = &port->context->servers[port->aaaServerIndex];
+   //Retrieve the length of the packet
+   length = ntohs(packet->length);
+
+   //The response must match the identifier and the Request Authenticator of
+   //the pending request
+   packet->identifier = port->aaaReqId;
+   osMemcpy(packet->authenticator, port->data->reqAuthenticator, 16);
+
+   //Search for the Message-Authenticator attribute
+   attribute = (RadiusAttribute *) radiusGetAttribute(packet,
+      RADIUS_ATTR_MESSAGE_AUTHENTICATOR, 0);
+
+   //Valid Message-Authenticator attribute?
+   if(attribute != NULL &&
+      attribute->length == (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+   {
+      //The signature is calculated over sixteen octets of zero (refer to
+      //RFC 2869, section 5.14)
+      osMemset(attribute->value, 0, MD5_DIGEST_SIZE);
+
+      //Calculate the Message-Authenticator
+      authenticatorHmacInit(&md5Context, server);
+      md5Update(&md5Context, packet, length);
+      authenticatorHmacFinal(&md5Context, server, attribute->value);
+   }
+
+   //Calculate the Response Authenticator (refer to RFC 2865, section 3)
+   md5Init(&md5Context);
+   md5Update(&md5Context, packet, length);
+   md5Update(&md5Context, server->key, server->keyLen);
+   md5Final(&md5Context, packet->authenticator);
+}
+
+
+/**
+ * @brief Record the session a captured Access-Request relates to
+ * @param[in] replay Pointer to the replay context
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ **/
+
+static void authenticatorReplayRadiusRequest(AuthenticatorReplayContext *replay,
+   const RadiusPacket *packet, size_t length)
+{
+   char_t buffer[18];
+   const RadiusAttribute *attribute;
+
+   //Malformed RADIUS packet?
+   if(length < sizeof(RadiusPacket) || length < ntohs(packet->length))
+      return;
+
+   //Only Access-Request packets are matched with responses
+   if(packet->code != RADIUS_CODE_ACCESS_REQUEST)
+      return;
+
+   //The NAS-Port attribute carries the physical port number
+   attribute = radiusGetAttribute(packet, RADIUS_ATTR_NAS_PORT, 0);
+
+   //Save the port number
+   if(attribute != NULL && attribute->length == 6)
+   {
+      replay->reqNasPort[packet->identifier] = LOAD32BE(attribute->value);
+   }
+   else
+   {
+      replay->reqNasPort[packet->identifier] = 0;
+   }
+
+   //The Calling-Station-Id attribute carries the supplicant MAC address
+   attribute = radiusGetAttribute(packet, RADIUS_ATTR_CALLING_STATION_ID, 0);
+
+   //Clear the MAC address
+   replay->reqMacAddr[packet->identifier] = MAC_UNSPECIFIED_ADDR;
+
+   //The MAC address is stored in ASCII format (refer to RFC 3580,
+   //section 3.21)
+   if(attribute != NULL && attribute->length == (sizeof(buffer) + 1))
+   {
+      //Copy the MAC address
+      osMemcpy(buffer, attribute->value, sizeof(buffer) - 1);
+      //Properly terminate the string with a NULL character
+      buffer[sizeof(buffer) - 1] = '\0';
+
+      //Convert the string to a MAC address
+      macStringToAddr(buffer, &replay->reqMacAddr[packet->identifier]);
+   }
+}
+
+
+/**
+ * @brief Feed a captured RADIUS response to the authenticator
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] replay Pointer to the replay context
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ * @return TRUE if the packet has been replayed, else FALSE
+ **/
+
+static bool_t authenticatorReplayRadiusResponse(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, const RadiusPacket *packet,
+   size_t length)
+{
+   AuthenticatorPort *port;
+   AuthenticatorPort *host;
+   AuthenticatorRadiusServer *server;
+   MacAddr *macAddr;
+
+   //Malformed RADIUS packet?
+   if(length < sizeof(RadiusPacket) || length < ntohs(packet->length) ||
+      length > AUTHENTICATOR_RX_BUFFER_SIZE)
+   {
+      return FALSE;
+   }
+
+   //Retrieve the port that issued the captured request
+   port = authenticatorFindPort(context,
+      replay->reqNasPort[packet->identifier]);
+   //No matching port?
+   if(port == NULL)
+      return FALSE;
+
+   //Point to the MAC address of the supplicant
+   macAddr = &replay->reqMacAddr[packet->identifier];
+
+   //The request may have been issued by an additional session of the port
+   if(!macCompAddr(macAddr, &MAC_UNSPECIFIED_ADDR) &&
+      !macCompAddr(macAddr, &port->supplicantMacAddr))
+   {
+      //Search the additional sessions of the port
+      host = authenticatorFindHostSession(port, macAddr);
+
+      //Matching session?
+      if(host != NULL)
+      {
+         port = host;
+      }
+   }
+
+   //The session must have a pending request
+   if(port->aaaReqDataLen == 0)
+      return FALSE;
+
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //Copy the packet to the receive buffer of the RADIUS path. The buffer is
+   //owned by the authenticator task, which cannot run during the replay (the
+   //mutex is not held because authenticatorAcceptRadiusPacket acquires it)
+   osMemcpy(context->radiusRxBuffer, packet, length);
+
+   //Bind the packet to the pending request
+   authenticatorResignRadiusResponse(port,
+      (RadiusPacket *) context->radiusRxBuffer);
+
+   //Process the RADIUS packet as if it had been received from the server
+   authenticatorAcceptRadiusPacket(context, port->aaaReqSocketIndex,
+      &server->ipAddr, server->port, length);
+
+   //The packet has been replayed
+   return TRUE;
+}
+
+
+/**
+ * @brief Feed a captured EAPOL PDU to the authenticator
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] port Pointer to the port the PDU was received on
+ * @param[in] frame Pointer to the captured Ethernet frame
+ * @param[in] length Length of the captured frame, in bytes
+ * @return TRUE if the PDU has been replayed, else FALSE
+ **/
+
+static bool_t authenticatorReplayEapolPdu(AuthenticatorContext *context,
+   AuthenticatorPort *port, const uint8_t *frame, size_t length)
+{
+   MacAddr srcMacAddr;
+   AuthenticatorRxBuffer *buffer;
+
+   //Malformed frame?
+   if(length < (sizeof(EthHeader) + sizeof(EapolPdu)))
+      return FALSE;
+
+   //Retrieve the length of the EAPOL PDU
+   length -= sizeof(EthHeader);
+
+   //The PDU must fit in a receive buffer
+   if(length > AUTHENTICATOR_RX_BUFFER_SIZE)
+      return FALSE;
+
+   //Retrieve a free buffer of the EAPOL receive ring
+   buffer = authenticatorGetRxBuffer(context);
+   //All the buffers are still owned by the ports?
+   if(buffer == NULL)
+      return FALSE;
+
+   //Extract the source MAC address
+   osMemcpy(&srcMacAddr, frame + 6, sizeof(MacAddr));
+   //Copy the PDU to the receive buffer
+   osMemcpy(buffer->data, frame + sizeof(EthHeader), length);
+
+   //The buffer is reserved until the PDU has been processed
+   authenticatorClaimRxBuffer(port, buffer);
+
+   //The PDU is processed by the shard the port belongs to
+   authenticatorDispatchEapolPdu(port, &srcMacAddr, buffer, length);
+
+   //The PDU has been replayed
+   return TRUE;
+}
+
+
+/**
+ * @brief Feed a captured packet to the authenticator
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] replay Pointer to the replay context
+ * @param[in] interfaceId Interface the packet was captured on
+ * @param[in] inbound Direction of the packet
+ * @param[in] data Pointer to the captured packet
+ * @param[in] length Length of the captured packet, in bytes
+ **/
+
+static void authenticatorReplayPacket(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, uint_t interfaceId, bool_t inbound,
+   const uint8_t *data, size_t length)
+{
+   uint_t i;
+   size_t n;
+   bool_t replayed;
+
+   //Initialize flag
+   replayed = FALSE;
+
+#if (AUTHENTICATOR_NUM_SHARDS == 1)
+   //The frames are processed inline
+   osAcquireMutex(&context->shards[0].mutex);
+#endif
+
+   //Check the interface the packet was captured on
+   if(interfaceId < context->numPorts)
+   {
+      //Only the received EAPOL PDUs are replayed
+      if(inbound)
+      {
+         replayed = authenticatorReplayEapolPdu(context,
+            &context->ports[interfaceId], data, length);
+      }
+   }
+   else if(interfaceId == context->numPorts && length >= 28)
+   {
+      //Retrieve the length of the IP header
+      n = ((data[0] >> 4) == 6) ? 40 : 20;
+      n += 8;
+
+      //Malformed packet?
+      if(length >= n)
+      {
+         //The responses are bound to the requests issued by the replay
+         if(inbound)
+         {
+            replayed = authenticatorReplayRadiusResponse(context, replay,
+               (const RadiusPacket *) (data + n), length - n);
+         }
+         else
+         {
+            //The captured requests are only used for matching
+            authenticatorReplayRadiusRequest(replay,
+               (const RadiusPacket *) (data + n), length - n);
+         }
+      }
+   }
+   else
+   {
+      //Unknown interface
+   }
+
+#if (AUTHENTICATOR_NUM_SHARDS == 1)
+   //Release exclusive access to the ports
+   osReleaseMutex(&context->shards[0].mutex);
+#endif
+
+   //Update statistics
+   if(replayed)
+   {
+      replay->framesReplayed++;
+   }
+   else if(inbound)
+   {
+      replay->framesDropped++;
+   }
+   else
+   {
+   }
+
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      //Process the timers that have expired and update the state machines
+      //of the ports that have pending events
+      osAcquireMutex(&context->shards[i].mutex);
+      authenticatorProcessShardEvents(&context->shards[i]);
+      osReleaseMutex(&context->shards[i].mutex);
+   }
+}
+
+
+/**
+ * @brief Feed a pcapng capture to the authenticator
+ *
+ * The received frames are replayed as fast as possible, in the order they
+ * were captured. The transmitted RADIUS requests are used to steer each
+ * response to the session that awaits it. The caller must make sure that the
+ * authenticator task is not running, as the responses are replayed through
+ * the receive buffer of the RADIUS path
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] replay Pointer to the replay context
+ * @param[in] data Pointer to the capture
+ * @param[in] length Length of the capture, in bytes
+ * @return Error code
+ **/
+
+error_t authenticatorReplayCaptureData(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, const uint8_t *data, size_t length)
+{
+   size_t n;
+   size_t i;
+   uint16_t code;
+   size_t optionLen;
+   uint32_t type;
+   uint32_t flags;
+   uint32_t interfaceId;
+   uint32_t captureLen;
+   uint64_t time;
+
+   //Parse the blocks of the capture
+   while(length > 0)
+   {
+      //Malformed block?
+      if(length < 12)
+         return ERROR_INVALID_SYNTAX;
+
+      //Retrieve the type and the length of the block
+      type = LOAD32LE(data);
+      n = LOAD32LE(data + 4);
+
+      //Malformed block?
+      if(n < 12 || n > length || (n % 4) != 0)
+         return ERROR_INVALID_SYNTAX;
+
+      //Check the type of the block
+      if(type == PCAPNG_BLOCK_TYPE_SHB)
+      {
+         //Only the captures written by the authenticator are supported
+         if(n < 28 || LOAD32LE(data + 8) != PCAPNG_BYTE_ORDER_MAGIC)
+            return ERROR_INVALID_SYNTAX;
+      }
+      else if(type == PCAPNG_BLOCK_TYPE_EPB)
+      {
+         //Malformed block?
+         if(n < 32)
+            return ERROR_INVALID_SYNTAX;
+
+         //Parse the fixed part of the block
+         interfaceId = LOAD32LE(data + 8);
+         time = ((uint64_t) LOAD32LE(data + 12) << 32) | LOAD32LE(data + 16);
+         captureLen = LOAD32LE(data + 20);
+
+         //Malformed block?
+         if(captureLen > (n - 32))
+            return ERROR_INVALID_SYNTAX;
+
+         //The packets of unknown direction are ignored
+         flags = 0;
+
+         //Point to the options that follow the packet data
+         i = 28 + ((captureLen + 3) & ~3U);
+
+         //Parse the options
+         while((i + 4) <= (n - 4))
+         {
+            //Retrieve the code and the length of the option
+            code = LOAD16LE(data + i);
+            optionLen = LOAD16LE(data + i + 2);
+
+            //End of options?
+            if(code == PCAPNG_OPT_ENDOFOPT)
+               break;
+
+            //Malformed option?
+            if((i + 4 + optionLen) > (n - 4))
+               break;
+
+            //Flags option?
+            if(code == PCAPNG_OPT_EPB_FLAGS && optionLen == 4)
+            {
+               flags = LOAD32LE(data + i + 4);
+            }
+
+            //Jump to the next option
+            i += 4 + ((optionLen + 3) & ~3U);
+         }
+
+         //Known direction?
+         if((flags & PCAPNG_EPB_FLAGS_DIR_MASK) != 0)
+         {
+            //Move the virtual clock to the time the packet was captured
+            if(replay->clockCallback != NULL)
+            {
+               replay->clockCallback((systime_t) time);
+            }
+
+            //Feed the packet to the authenticator
+            authenticatorReplayPacket(context, replay, interfaceId,
+               (flags & PCAPNG_EPB_FLAGS_DIR_MASK) == PCAPNG_EPB_FLAGS_INBOUND,
+               data + 28, captureLen);
+         }
+      }
+      else
+      {
+         //Other blocks are ignored
+      }
+
+      //Jump to the next block
+      data += n;
+      length -= n;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file authenticator_capture.h
+ * @brief Capture and replay of EAPOL/RADIUS exchanges
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_CAPTURE_H
+#define _AUTHENTICATOR_CAPTURE_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//pcapng block types
+#define PCAPNG_BLOCK_TYPE_SHB 0x0A0D0D0A
+#define PCAPNG_BLOCK_TYPE_IDB 0x00000001
+#define PCAPNG_BLOCK_TYPE_EPB 0x00000006
+
+//Byte-order magic of the Section Header Block
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+//pcapng options
+#define PCAPNG_OPT_ENDOFOPT 0
+#define PCAPNG_OPT_IF_TSRESOL 9
+#define PCAPNG_OPT_EPB_FLAGS 2
+
+//Direction of the captured packets
+#define PCAPNG_EPB_FLAGS_INBOUND  0x00000001
+#define PCAPNG_EPB_FLAGS_OUTBOUND 0x00000002
+#define PCAPNG_EPB_FLAGS_DIR_MASK 0x00000003
+
+//Link-layer header types
+#define PCAPNG_LINKTYPE_ETHERNET 1
+#define PCAPNG_LINKTYPE_RAW      101
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Capture supported?
+#if (AUTHENTICATOR_CAPTURE_SUPPORT == ENABLED)
+
+//Authenticator related functions
+void authenticatorCaptureEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, const MacAddr *destMacAddr, bool_t inbound,
+   const uint8_t *pdu, size_t length);
+
+void authenticatorCaptureRadiusPacket(AuthenticatorContext *context,
+   const IpAddr *serverIpAddr, uint16_t serverPort, bool_t inbound,
+   const uint8_t *packet, size_t length);
+
+error_t authenticatorReplayCaptureData(AuthenticatorContext *context,
+   AuthenticatorReplayContext *replay, const uint8_t *data, size_t length);
+
+#else
+
+//The exchanges are not captured
+#define authenticatorCaptureEapolPdu(port, src, dest, inbound, pdu, length)
+#define authenticatorCaptureRadiusPacket(context, ipAddr, port, inbound, packet, length)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
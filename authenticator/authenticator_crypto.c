@@ -0,0 +1,352 @@
+/**
+ * @file authenticator_crypto.c
+ * @brief Crypto provider interface
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_crypto.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Report the completion of an asynchronous crypto operation
+ *
+ * This function is called by the crypto provider, from a task context, once
+ * an operation for which ERROR_IN_PROGRESS has been returned is complete. It
+ * must not be called from within the provider callbacks themselves
+ *
+ * @param[in] port Pointer to the port the operation was started for
+ * @param[in] id Identifier of the operation
+ * @param[in] error Status of the operation
+ **/
+
+void authenticatorCompleteCrypto(AuthenticatorPort *port, uint_t id,
+   error_t error)
+{
+   size_t n;
+   AuthenticatorCryptoOp op;
+
+   //Make sure the port is valid
+   if(port == NULL)
+      return;
+
+   //Acquire exclusive access to the port
+   osAcquireMutex(&port->shard->mutex);
+
+   //The port may have been reinitialized while the operation was pending
+   if(port->cryptoOp != AUTHENTICATOR_CRYPTO_OP_NONE && port->cryptoId == id)
+   {
+      //Save the type of the completed operation
+      op = port->cryptoOp;
+      //The port no longer waits for the crypto provider
+      port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_NONE;
+
+      //Check status code
+      if(!error)
+      {
+         //Check the type of the completed operation
+         if(op == AUTHENTICATOR_CRYPTO_OP_RANDOM)
+         {
+            //Save the Request Authenticator
+            osMemcpy(port->data->reqAuthenticator, port->data->cryptoOutput,
+               MD5_DIGEST_SIZE);
+
+            //Format the remaining part of the Access-Request packet
+            error = authenticatorFormatRadiusRequest(port);
+         }
+         else if(port->aaaReqData != NULL)
+         {
+            //Retrieve the total length of the RADIUS packet
+            n = ntohs(((RadiusPacket *) port->aaaReqData)->length);
+
+            //Copy the resulting HMAC-MD5 hash
+            osMemcpy(port->aaaReqData + n - MD5_DIGEST_SIZE,
+               port->data->cryptoOutput, MD5_DIGEST_SIZE);
+
+            //Save the total length of the RADIUS packet
+            port->aaaReqDataLen = n;
+            //Initialize retransmission counter
+            port->aaaRetransCount = 0;
+         }
+         else
+         {
+            //The session buffer has been released
+            error = ERROR_WRONG_STATE;
+         }
+      }
+
+      //Check status code
+      if(!error)
+      {
+         //The request is queued if the window of the server is full
+         if(authenticatorAcquireRadiusSlot(port))
+         {
+            authenticatorSendRadiusRequest(port);
+         }
+      }
+      else if(error != ERROR_IN_PROGRESS)
+      {
+         //Debug message
+         TRACE_WARNING("Port %" PRIu16 ": Crypto operation failed!\r\n",
+            port->portIndex);
+
+         //The Access-Request cannot be sent
+         port->aaaTimeout = TRUE;
+
+         //Update the state machines of the port
+         authenticatorSchedulePort(port);
+         authenticatorRunFsm(port->shard);
+      }
+      else
+      {
+         //The next operation has been submitted to the crypto provider
+      }
+   }
+
+   //Release exclusive access to the port
+   osReleaseMutex(&port->shard->mutex);
+}
+
+
+/**
+ * @brief Generate the Request Authenticator of an Access-Request
+ * @param[in] port Pointer to the port context
+ * @return Error code (ERROR_IN_PROGRESS if the value is not available yet)
+ **/
+
+error_t authenticatorGenerateCryptoRandom(AuthenticatorPort *port)
+{
+   error_t error;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Each operation is identified by a sequence number, so that late
+   //completions can be told apart from the current one
+   port->cryptoId++;
+   port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_RANDOM;
+
+   //The Request Authenticator must be unpredictable and unique (refer to
+   //RFC 2865, section 3)
+   error = context->cryptoProvider->random(context->cryptoParam,
+      port->data->cryptoOutput, MD5_DIGEST_SIZE, port, port->cryptoId);
+
+   //Check status code
+   if(error != ERROR_IN_PROGRESS)
+   {
+      //The operation is complete
+      port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_NONE;
+
+      //Save the Request Authenticator
+      if(!error)
+      {
+         osMemcpy(port->data->reqAuthenticator, port->data->cryptoOutput,
+            MD5_DIGEST_SIZE);
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Calculate the Message-Authenticator of an Access-Request
+ * @param[in] port Pointer to the port context
+ * @param[in] length Total length of the RADIUS packet
+ * @return Error code (ERROR_IN_PROGRESS if the value is not available yet)
+ **/
+
+error_t authenticatorComputeCryptoHmac(AuthenticatorPort *port, size_t length)
+{
+   error_t error;
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+   AuthenticatorCryptoVector vector;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //When present in an Access-Request packet, Message-Authenticator is an
+   //HMAC-MD5 hash of the entire Access-Request packet (refer to RFC 3579,
+   //section 3.2)
+   vector.data = port->aaaReqData;
+   vector.length = length;
+
+   //Start a new operation
+   port->cryptoId++;
+   port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_HMAC_MD5;
+
+   //Transactions between the client and RADIUS server are authenticated
+   //through the use of a shared secret (refer to RFC 2865, section 1)
+   error = context->cryptoProvider->hmacMd5(context->cryptoParam, server->key,
+      server->keyLen, &vector, 1, port->data->cryptoOutput, port,
+      port->cryptoId);
+
+   //Check status code
+   if(error != ERROR_IN_PROGRESS)
+   {
+      //The operation is complete
+      port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_NONE;
+
+      //Copy the resulting HMAC-MD5 hash
+      if(!error)
+      {
+         osMemcpy(port->aaaReqData + length - MD5_DIGEST_SIZE,
+            port->data->cryptoOutput, MD5_DIGEST_SIZE);
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Verify the authenticators of a RADIUS response using the provider
+ *
+ * Responses are verified synchronously, while the receive buffer is still
+ * available. The provider is expected to complete the operations on return
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server the request was sent to
+ * @param[in] packet Pointer to the received RADIUS packet
+ * @param[in] index Attributes of the received RADIUS packet
+ * @param[in] reqAuthenticator Request Authenticator of the pending request
+ * @return Error code
+ **/
+
+error_t authenticatorCheckCryptoResponse(AuthenticatorContext *context,
+   const AuthenticatorRadiusServer *server, const RadiusPacket *packet,
+   const RadiusAttrIndex *index, const uint8_t *reqAuthenticator)
+{
+   error_t error;
+   size_t n;
+   size_t length;
+   const RadiusAttribute *attribute;
+   AuthenticatorCryptoVector vectors[5];
+   uint8_t digest[MD5_DIGEST_SIZE];
+   uint8_t zero[MD5_DIGEST_SIZE];
+
+   //Octets outside the range of the Length field must be treated as padding
+   //and ignored on reception
+   length = ntohs(packet->length) - sizeof(RadiusPacket);
+
+   //Access-Challenge, Access-Accept, or Access-Reject packets including
+   //EAP-Message attribute(s) without a Message-Authenticator attribute should
+   //be silently discarded by the NAS (refer to RFC 3579, section 3.1)
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_MESSAGE_AUTHENTICATOR,
+      NULL);
+
+   //Missing or malformed Message-Authenticator attribute?
+   if(attribute == NULL ||
+      attribute->length != (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+   {
+      return ERROR_INVALID_MESSAGE;
+   }
+
+   //Save the offset to the Message-Authenticator value
+   n = attribute->value - packet->attributes;
+
+   //The Response Authenticator is calculated over the Code, Identifier and
+   //Length fields, the Request Authenticator, the response attributes and
+   //the shared secret (refer to RFC 2865, section 3)
+   vectors[0].data = packet;
+   vectors[0].length = 4;
+   vectors[1].data = reqAuthenticator;
+   vectors[1].length = MD5_DIGEST_SIZE;
+   vectors[2].data = packet->attributes;
+   vectors[2].length = length;
+   vectors[3].data = server->key;
+   vectors[3].length = server->keyLen;
+
+   //Calculate the Response Authenticator
+   error = context->cryptoProvider->md5(context->cryptoParam, vectors, 4,
+      digest, NULL, 0);
+   //Any error to report?
+   if(error)
+      return ERROR_INVALID_MESSAGE;
+
+   //The Response Authenticator field must contain the correct response for the
+   //pending Access-Request. Invalid packets are silently discarded
+   if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Response Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+
+   //When the checksum is calculated the signature string should be considered
+   //to be sixteen octets of zero (refer to RFC 2869, section 5.14)
+   osMemset(zero, 0, MD5_DIGEST_SIZE);
+
+   //The Message-Authenticator covers the same fields, the signature string
+   //being replaced with zeroes (refer to RFC 3579, section 3.2)
+   vectors[2].length = n;
+   vectors[3].data = zero;
+   vectors[3].length = MD5_DIGEST_SIZE;
+   vectors[4].data = packet->attributes + n + MD5_DIGEST_SIZE;
+   vectors[4].length = length - n - MD5_DIGEST_SIZE;
+
+   //Calculate the Message-Authenticator
+   error = context->cryptoProvider->hmacMd5(context->cryptoParam, server->key,
+      server->keyLen, vectors, 5, digest, NULL, 0);
+   //Any error to report?
+   if(error)
+      return ERROR_INVALID_MESSAGE;
+
+   //A NAS supporting the EAP-Message attribute must calculate the correct
+   //value of the Message-Authenticator and must silently discard the packet
+   //if it does not match the value sent (refer to RFC 3579, section 3.1)
+   if(osMemcmp(digest, attribute->value, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Message Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+
+   //The packet is authentic
+   return NO_ERROR;
+}
+
+#endif
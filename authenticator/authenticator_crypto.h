@@ -0,0 +1,72 @@
+/**
+ * @file authenticator_crypto.h
+ * @brief Crypto provider interface
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_CRYPTO_H
+#define _AUTHENTICATOR_CRYPTO_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Crypto provider supported?
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+
+//Check whether the port waits for the crypto provider
+#define authenticatorIsCryptoPending(port) \
+   ((port)->cryptoOp != AUTHENTICATOR_CRYPTO_OP_NONE)
+
+//Authenticator related functions
+void authenticatorCompleteCrypto(AuthenticatorPort *port, uint_t id,
+   error_t error);
+
+error_t authenticatorGenerateCryptoRandom(AuthenticatorPort *port);
+error_t authenticatorComputeCryptoHmac(AuthenticatorPort *port, size_t length);
+
+error_t authenticatorCheckCryptoResponse(AuthenticatorContext *context,
+   const AuthenticatorRadiusServer *server, const RadiusPacket *packet,
+   const RadiusAttrIndex *index, const uint8_t *reqAuthenticator);
+
+#else
+
+//Crypto provider is not supported
+#define authenticatorIsCryptoPending(port) FALSE
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
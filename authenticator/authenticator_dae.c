@@ -0,0 +1,553 @@
+/**
+ * @file authenticator_dae.c
+ * @brief Dynamic Authorization server (RFC 5176)
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_mgmt.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_host.h"
+#include "authenticator/authenticator_dae.h"
+#include "radius/radius.h"
+#include "radius/radius_attributes.h"
+#include "radius/radius_debug.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+
+//The Request Authenticator is computed over a zeroed authenticator field
+static const uint8_t zeroAuthenticator[MD5_DIGEST_SIZE] = {0};
+
+
+/**
+ * @brief Process incoming Disconnect-Request or CoA-Request packet
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Error code (an error is returned when no packet is available)
+ **/
+
+error_t authenticatorProcessDaePacket(AuthenticatorContext *context)
+{
+   error_t error;
+   size_t length;
+   uint8_t code;
+   uint16_t errorCause;
+   SocketMsg msg;
+   const RadiusPacket *packet;
+
+   //Point to the receive buffer of the RADIUS path
+   msg = SOCKET_DEFAULT_MSG;
+   msg.data = context->radiusRxBuffer;
+   msg.size = AUTHENTICATOR_RX_BUFFER_SIZE;
+
+   //Receive RADIUS packet
+   error = socketReceiveMsg(context->daeSocket, &msg, 0);
+   //Failed to receive packet
+   if(error)
+      return error;
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   //Check the port number on which the packet was received
+   if(msg.switchPort != context->serverPortIndex && context->serverPortIndex != 0)
+      return NO_ERROR;
+#endif
+
+   //Malformed RADIUS packet?
+   if(msg.length < sizeof(RadiusPacket))
+      return NO_ERROR;
+
+   //Point to the RADIUS packet
+   packet = (RadiusPacket *) context->radiusRxBuffer;
+   //Retrieve the length of the packet
+   length = ntohs(packet->length);
+
+   //If the packet is shorter than the Length field indicates, it must be
+   //silently discarded
+   if(length < sizeof(RadiusPacket) || msg.length < length)
+      return NO_ERROR;
+
+   //Check RADIUS code
+   if(packet->code != RADIUS_CODE_DISCONNECT_REQUEST &&
+      packet->code != RADIUS_CODE_COA_REQUEST)
+   {
+      return NO_ERROR;
+   }
+
+   //Debug message
+   TRACE_INFO("Dynamic Authorization request received from %s port %" PRIu16
+      " (%" PRIuSIZE " bytes)...\r\n", ipAddrToString(&msg.srcIpAddr, NULL),
+      msg.srcPort, length);
+
+   //Dump RADIUS header contents for debugging purpose
+   radiusDumpPacket(packet, length);
+
+   //Requests that do not come from the Dynamic Authorization client or that
+   //carry an invalid Request Authenticator are silently discarded
+   error = authenticatorCheckDaeRequest(context, packet, length,
+      &msg.srcIpAddr);
+   //Any error to report?
+   if(error)
+      return NO_ERROR;
+
+   //Locate the session identified by the request and perform the requested
+   //action
+   errorCause = authenticatorApplyDaeRequest(context, packet);
+
+   //Successful processing?
+   if(errorCause == 0)
+   {
+      //Disconnect-ACK or CoA-ACK
+      code = packet->code + 1;
+   }
+   else
+   {
+      //Disconnect-NAK or CoA-NAK
+      code = packet->code + 2;
+   }
+
+   //The response is sent to the source address and port of the request
+   //(refer to RFC 5176, section 2.3)
+   authenticatorSendDaeResponse(context, packet, code, errorCause,
+      &msg.srcIpAddr, msg.srcPort);
+
+   //The packet has been consumed
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Check the origin and the Request Authenticator of a request
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] packet Pointer to the Disconnect-Request or CoA-Request packet
+ * @param[in] length Length of the packet, in bytes
+ * @param[in] srcIpAddr Source IP address of the packet
+ * @return Error code
+ **/
+
+error_t authenticatorCheckDaeRequest(AuthenticatorContext *context,
+   const RadiusPacket *packet, size_t length, const IpAddr *srcIpAddr)
+{
+   error_t error;
+   uint8_t digest[MD5_DIGEST_SIZE];
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Requests are only accepted from the configured client
+   if(ipCompAddr(&context->daeClientIpAddr, &IP_ADDR_UNSPECIFIED) ||
+      !ipCompAddr(srcIpAddr, &context->daeClientIpAddr))
+   {
+      //Debug message
+      TRACE_WARNING("Dynamic Authorization request from unknown client!\r\n");
+      //Number of packets received from an unknown address
+      context->daeStats.unknownClients++;
+      //Report an error
+      error = ERROR_INVALID_ADDRESS;
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //The Request Authenticator is calculated the same way as for an
+      //Accounting-Request (refer to RFC 5176, section 3.5)
+      md5Init(&context->md5Context);
+      md5Update(&context->md5Context, packet, 4);
+      md5Update(&context->md5Context, zeroAuthenticator, MD5_DIGEST_SIZE);
+      md5Update(&context->md5Context, packet->attributes,
+         length - sizeof(RadiusPacket));
+      md5Update(&context->md5Context, context->daeKey, context->daeKeyLen);
+      md5Final(&context->md5Context, digest);
+
+      //Invalid Request Authenticator?
+      if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) != 0)
+      {
+         //Debug message
+         TRACE_WARNING("Invalid Request Authenticator value!\r\n");
+         //Number of packets with an invalid Request Authenticator
+         context->daeStats.badAuthenticators++;
+         //Report an error
+         error = ERROR_INVALID_MESSAGE;
+      }
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Valid request
+      if(packet->code == RADIUS_CODE_DISCONNECT_REQUEST)
+      {
+         context->daeStats.disconnectRequests++;
+      }
+      else
+      {
+         context->daeStats.coaRequests++;
+      }
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Locate the session identified by a request and perform the action
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] packet Pointer to the Disconnect-Request or CoA-Request packet
+ * @return Value of the Error-Cause attribute (0 on success)
+ **/
+
+uint16_t authenticatorApplyDaeRequest(AuthenticatorContext *context,
+   const RadiusPacket *packet)
+{
+   uint_t i;
+   uint16_t errorCause;
+   char_t buffer[18];
+   MacAddr macAddr;
+   AuthenticatorPort *port;
+   AuthenticatorPort *session;
+   const MacAddr *supplicantMacAddr;
+   const RadiusAttribute *nasPortAttr;
+   const RadiusAttribute *callingStationIdAttr;
+
+   //The session is identified by the NAS-Port and/or the Calling-Station-Id
+   //attributes (refer to RFC 5176, section 3)
+   nasPortAttr = radiusGetAttribute(packet, RADIUS_ATTR_NAS_PORT, 0);
+   callingStationIdAttr = radiusGetAttribute(packet,
+      RADIUS_ATTR_CALLING_STATION_ID, 0);
+
+   //No session identification attribute?
+   if(nasPortAttr == NULL && callingStationIdAttr == NULL)
+      return RADIUS_ERROR_CAUSE_MISSING_ATTRIBUTE;
+
+   //Check the length of the NAS-Port attribute
+   if(nasPortAttr != NULL && nasPortAttr->length != 6)
+      return RADIUS_ERROR_CAUSE_INVALID_ATTRIBUTE_VALUE;
+
+   //Calling-Station-Id attribute present?
+   if(callingStationIdAttr != NULL)
+   {
+      //The supplicant MAC address is stored in ASCII format (refer to
+      //RFC 3580, section 3.21)
+      if(callingStationIdAttr->length != (sizeof(buffer) + 1))
+         return RADIUS_ERROR_CAUSE_INVALID_ATTRIBUTE_VALUE;
+
+      //Copy the MAC address
+      osMemcpy(buffer, callingStationIdAttr->value, sizeof(buffer) - 1);
+      //Properly terminate the string with a NULL character
+      buffer[sizeof(buffer) - 1] = '\0';
+
+      //Convert the string to a MAC address
+      if(macStringToAddr(buffer, &macAddr))
+         return RADIUS_ERROR_CAUSE_INVALID_ATTRIBUTE_VALUE;
+
+      //Match the supplicant MAC address
+      supplicantMacAddr = &macAddr;
+   }
+   else
+   {
+      //Any session of the port matches
+      supplicantMacAddr = NULL;
+   }
+
+   //Initialize the Error-Cause value
+   errorCause = RADIUS_ERROR_CAUSE_SESSION_CONTEXT_NOT_FOUND;
+
+   //NAS-Port attribute present?
+   if(nasPortAttr != NULL)
+   {
+      //The NAS-Port attribute carries the physical port number
+      port = authenticatorFindPort(context, LOAD32BE(nasPortAttr->value));
+
+      //Valid port number?
+      if(port != NULL)
+      {
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+         //Acquire exclusive access to the port
+         osAcquireMutex(&port->shard->mutex);
+#endif
+         //Search the port for a matching session
+         session = authenticatorFindDaeSession(port, supplicantMacAddr);
+
+         //Session found?
+         if(session != NULL)
+         {
+            //Perform the requested action
+            authenticatorApplyDaeAction(session, packet->code);
+            errorCause = 0;
+         }
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+         //Release exclusive access to the port
+         osReleaseMutex(&port->shard->mutex);
+#endif
+      }
+   }
+   else
+   {
+      //Loop through the ports
+      for(i = 0; i < context->numPorts && errorCause != 0; i++)
+      {
+         //Point to the current port
+         port = &context->ports[i];
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+         //Acquire exclusive access to the port
+         osAcquireMutex(&port->shard->mutex);
+#endif
+         //Search the port for a matching session
+         session = authenticatorFindDaeSession(port, supplicantMacAddr);
+
+         //Session found?
+         if(session != NULL)
+         {
+            //Perform the requested action
+            authenticatorApplyDaeAction(session, packet->code);
+            errorCause = 0;
+         }
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+         //Release exclusive access to the port
+         osReleaseMutex(&port->shard->mutex);
+#endif
+      }
+   }
+
+   //Debug message
+   if(errorCause != 0)
+   {
+      TRACE_INFO("Dynamic Authorization: session not found!\r\n");
+   }
+
+   //Return the value of the Error-Cause attribute
+   return errorCause;
+}
+
+
+/**
+ * @brief Search a port for the session of a given supplicant
+ * @param[in] port Pointer to the port context
+ * @param[in] macAddr MAC address of the supplicant (NULL to select the port
+ *   itself)
+ * @return Pointer to the matching session (NULL if not found)
+ **/
+
+AuthenticatorPort *authenticatorFindDaeSession(AuthenticatorPort *port,
+   const MacAddr *macAddr)
+{
+   AuthenticatorPort *session;
+
+   //Check whether a supplicant MAC address is specified
+   if(macAddr == NULL)
+   {
+      //The request applies to the port as a whole
+      session = port;
+   }
+   else if(macCompAddr(&port->supplicantMacAddr, macAddr))
+   {
+      //The supplicant is handled by the port itself
+      session = port;
+   }
+   else if(port->numHosts > 0)
+   {
+      //Search the additional sessions of the port
+      session = authenticatorFindHostSession(port, macAddr);
+   }
+   else
+   {
+      //No matching session
+      session = NULL;
+   }
+
+   //Return a pointer to the matching session, if any
+   return session;
+}
+
+
+/**
+ * @brief Disconnect or reauthenticate a session
+ * @param[in] session Pointer to the session
+ * @param[in] code Code of the request (Disconnect-Request or CoA-Request)
+ **/
+
+void authenticatorApplyDaeAction(AuthenticatorPort *session, uint8_t code)
+{
+   //Check the code of the request
+   if(code == RADIUS_CODE_DISCONNECT_REQUEST)
+   {
+      //Debug message
+      TRACE_INFO("Port %" PRIu16 ": Disconnecting supplicant %s...\r\n",
+         authenticatorGetPhysicalPort(session)->portIndex,
+         macAddrToString(&session->supplicantMacAddr, NULL));
+
+      //This variable indicates how the session was terminated. It is set
+      //before the session is torn down, so that the cause is reported along
+      //with the change of the authorization state
+      session->data->sessionStats.sessionTerminateCause =
+         AUTHENTICATOR_TERMINATE_CAUSE_AUTH_CONTROL_FORCE_UNAUTH;
+
+      //Additional session of a multi-supplicant port?
+      if(session->host)
+      {
+         //The session is released once its state machines have been
+         //evaluated
+         session->portEnabled = FALSE;
+         session->hostReleasePending = TRUE;
+      }
+      else
+      {
+         //Force the supplicant to be unauthorized and restart the state
+         //machines of the port
+         authenticatorInitPortFsm(session);
+         authenticatorFlushHostSessions(session);
+         session->initialize = FALSE;
+      }
+   }
+   else
+   {
+      //Debug message
+      TRACE_INFO("Port %" PRIu16 ": Reauthenticating supplicant %s...\r\n",
+         authenticatorGetPhysicalPort(session)->portIndex,
+         macAddrToString(&session->supplicantMacAddr, NULL));
+
+      //The new authorization attributes are retrieved by reauthenticating
+      //the supplicant
+      session->reAuthenticate = TRUE;
+   }
+
+   //Update the state machines of the session
+   authenticatorSchedulePort(session);
+   authenticatorRunFsm(session->shard);
+}
+
+
+/**
+ * @brief Send Disconnect-ACK/NAK or CoA-ACK/NAK packet
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] request Pointer to the Disconnect-Request or CoA-Request packet
+ * @param[in] code Code of the response
+ * @param[in] errorCause Value of the Error-Cause attribute (0 if none)
+ * @param[in] destIpAddr Destination IP address
+ * @param[in] destPort Destination port number
+ **/
+
+void authenticatorSendDaeResponse(AuthenticatorContext *context,
+   const RadiusPacket *request, uint8_t code, uint16_t errorCause,
+   const IpAddr *destIpAddr, uint16_t destPort)
+{
+   size_t length;
+   SocketMsg msg;
+   RadiusPacket *packet;
+   uint8_t buffer[sizeof(RadiusPacket) + 8];
+   uint8_t value[4];
+
+   //Point to the buffer where to format the response
+   packet = (RadiusPacket *) buffer;
+
+   //Format RADIUS packet header
+   packet->code = code;
+   packet->identifier = request->identifier;
+   packet->length = HTONS(sizeof(RadiusPacket));
+
+   //NAK packets should include the Error-Cause attribute (refer to RFC 5176,
+   //section 3.6)
+   if(errorCause != 0)
+   {
+      STORE32BE(errorCause, value);
+      radiusAddAttribute(packet, RADIUS_ATTR_ERROR_CAUSE, value, sizeof(value));
+   }
+
+   //Retrieve the length of the packet
+   length = ntohs(packet->length);
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //The Response Authenticator is calculated over the response, using the
+   //Request Authenticator of the request, followed by the shared secret
+   md5Init(&context->md5Context);
+   md5Update(&context->md5Context, packet, 4);
+   md5Update(&context->md5Context, request->authenticator, MD5_DIGEST_SIZE);
+   md5Update(&context->md5Context, packet->attributes,
+      length - sizeof(RadiusPacket));
+   md5Update(&context->md5Context, context->daeKey, context->daeKeyLen);
+   md5Final(&context->md5Context, packet->authenticator);
+
+   //Update statistics
+   if(code == RADIUS_CODE_DISCONNECT_ACK)
+   {
+      context->daeStats.disconnectAcks++;
+   }
+   else if(code == RADIUS_CODE_DISCONNECT_NAK)
+   {
+      context->daeStats.disconnectNaks++;
+   }
+   else if(code == RADIUS_CODE_COA_ACK)
+   {
+      context->daeStats.coaAcks++;
+   }
+   else
+   {
+      context->daeStats.coaNaks++;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Format the datagram
+   msg = SOCKET_DEFAULT_MSG;
+   msg.data = packet;
+   msg.length = length;
+   msg.destIpAddr = *destIpAddr;
+   msg.destPort = destPort;
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   //Specify the egress port
+   msg.switchPort = context->serverPortIndex;
+#endif
+
+   //Debug message
+   TRACE_INFO("Sending RADIUS packet (%" PRIuSIZE " bytes)...\r\n", length);
+   //Dump RADIUS header contents for debugging purpose
+   radiusDumpPacket(packet, length);
+
+   //Send UDP datagram
+   socketSendMsg(context->daeSocket, &msg, 0);
+}
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file authenticator_dae.h
+ * @brief Dynamic Authorization server (RFC 5176)
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_DAE_H
+#define _AUTHENTICATOR_DAE_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Dynamic Authorization server
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+
+//Authenticator related functions
+error_t authenticatorProcessDaePacket(AuthenticatorContext *context);
+
+error_t authenticatorCheckDaeRequest(AuthenticatorContext *context,
+   const RadiusPacket *packet, size_t length, const IpAddr *srcIpAddr);
+
+uint16_t authenticatorApplyDaeRequest(AuthenticatorContext *context,
+   const RadiusPacket *packet);
+
+AuthenticatorPort *authenticatorFindDaeSession(AuthenticatorPort *port,
+   const MacAddr *macAddr);
+
+void authenticatorApplyDaeAction(AuthenticatorPort *session, uint8_t code);
+
+void authenticatorSendDaeResponse(AuthenticatorContext *context,
+   const RadiusPacket *request, uint8_t code, uint16_t errorCause,
+   const IpAddr *destIpAddr, uint16_t destPort);
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
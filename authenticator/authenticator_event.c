@@ -0,0 +1,235 @@
+/**
+ * @file authenticator_event.c
+ * @brief Deferred delivery of the state change callbacks
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_event.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Queue a state change for deferred delivery
+ *
+ * The state changes of a given port are coalesced into a single entry of the
+ * event queue, so that only the latest state of each state machine is
+ * reported. The caller must hold the mutex of the shard the port belongs to
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] type State machine that has changed state
+ * @param[in] state New state
+ * @return TRUE if the state change has been queued, FALSE if the callback
+ *   must be invoked synchronously
+ **/
+
+bool_t authenticatorQueueEvent(AuthenticatorPort *port,
+   AuthenticatorEventType type, uint_t state)
+{
+   uint_t i;
+   bool_t queued;
+   AuthenticatorEvent *event;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Acquire exclusive access to the event queue
+   osAcquireMutex(&context->eventMutex);
+
+   //Any state change of the port already waiting to be delivered?
+   if(port->data->eventSlot != 0)
+   {
+      //Coalesce the state changes
+      event = &context->events[port->data->eventSlot - 1];
+   }
+   else if(context->numEvents < AUTHENTICATOR_EVENT_QUEUE_SIZE)
+   {
+      //Allocate a new entry at the tail of the queue
+      i = (context->eventHead + context->numEvents) %
+         AUTHENTICATOR_EVENT_QUEUE_SIZE;
+
+      //Initialize the entry
+      event = &context->events[i];
+      event->port = port;
+      event->mask = 0;
+
+      //Link the entry to the port
+      port->data->eventSlot = i + 1;
+      context->numEvents++;
+   }
+   else
+   {
+      //The queue is full
+      event = NULL;
+   }
+
+   //Check whether the state change can be deferred
+   if(event != NULL)
+   {
+      //Record the latest state of the state machine
+      if(type == AUTHENTICATOR_EVENT_PAE_STATE)
+      {
+         event->paeState = (AuthenticatorPaeState) state;
+      }
+      else if(type == AUTHENTICATOR_EVENT_BACKEND_STATE)
+      {
+         event->backendState = (AuthenticatorBackendState) state;
+      }
+      else if(type == AUTHENTICATOR_EVENT_REAUTH_TIMER_STATE)
+      {
+         event->reauthTimerState = (AuthenticatorReauthTimerState) state;
+      }
+      else
+      {
+         event->eapFullAuthState = (EapFullAuthState) state;
+      }
+
+      //The state machine has a pending state change
+      event->mask |= type;
+      queued = TRUE;
+   }
+   else
+   {
+      //The callback is invoked synchronously rather than losing the state
+      //change
+      context->eventOverflows++;
+      queued = FALSE;
+   }
+
+   //Release exclusive access to the event queue
+   osReleaseMutex(&context->eventMutex);
+
+   //Wake up the consumer
+   if(queued)
+   {
+      //Any registered consumer?
+      if(context->eventNotification != NULL)
+      {
+         context->eventNotification(context);
+      }
+      else
+      {
+         osSetEvent(&context->event);
+      }
+   }
+
+   //Return TRUE if the state change has been queued
+   return queued;
+}
+
+
+/**
+ * @brief Deliver the queued state changes
+ *
+ * The queued entries are removed in batches, then the callbacks are invoked
+ * without holding any lock, so that slow consumers do not stall the ports
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorDeliverEvents(AuthenticatorContext *context)
+{
+   uint_t i;
+   uint_t n;
+   AuthenticatorEvent *event;
+   AuthenticatorEvent batch[AUTHENTICATOR_EVENT_BATCH_SIZE];
+
+   //Process the queue until it is empty
+   do
+   {
+      //Acquire exclusive access to the event queue
+      osAcquireMutex(&context->eventMutex);
+
+      //Remove a batch of entries from the head of the queue
+      for(n = 0; n < AUTHENTICATOR_EVENT_BATCH_SIZE &&
+         context->numEvents > 0; n++)
+      {
+         //Point to the oldest entry
+         event = &context->events[context->eventHead];
+
+         //Copy the entry
+         batch[n] = *event;
+         //Further state changes of the port are queued in a new entry
+         event->port->data->eventSlot = 0;
+
+         //Advance the head of the queue
+         context->eventHead = (context->eventHead + 1) %
+            AUTHENTICATOR_EVENT_QUEUE_SIZE;
+         context->numEvents--;
+      }
+
+      //Release exclusive access to the event queue
+      osReleaseMutex(&context->eventMutex);
+
+      //Loop through the entries of the batch
+      for(i = 0; i < n; i++)
+      {
+         //Point to the current entry
+         event = &batch[i];
+
+         //Report the latest state of each state machine that has changed
+         if((event->mask & AUTHENTICATOR_EVENT_PAE_STATE) != 0 &&
+            context->paeStateChangeCallback != NULL)
+         {
+            context->paeStateChangeCallback(event->port, event->paeState);
+         }
+
+         if((event->mask & AUTHENTICATOR_EVENT_BACKEND_STATE) != 0 &&
+            context->backendStateChangeCallback != NULL)
+         {
+            context->backendStateChangeCallback(event->port,
+               event->backendState);
+         }
+
+         if((event->mask & AUTHENTICATOR_EVENT_REAUTH_TIMER_STATE) != 0 &&
+            context->reauthTimerStateChangeCallback != NULL)
+         {
+            context->reauthTimerStateChangeCallback(event->port,
+               event->reauthTimerState);
+         }
+
+         if((event->mask & AUTHENTICATOR_EVENT_EAP_FULL_AUTH_STATE) != 0 &&
+            context->eapFullAuthStateChangeCallback != NULL)
+         {
+            context->eapFullAuthStateChangeCallback(event->port,
+               event->eapFullAuthState);
+         }
+      }
+
+      //A full batch may be followed by further entries
+   } while(n == AUTHENTICATOR_EVENT_BATCH_SIZE);
+}
+
+#endif
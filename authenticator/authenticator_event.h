@@ -0,0 +1,64 @@
+/**
+ * @file authenticator_event.h
+ * @brief Deferred delivery of the state change callbacks
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_EVENT_H
+#define _AUTHENTICATOR_EVENT_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Deferred delivery of the state change callbacks?
+#if (AUTHENTICATOR_EVENT_QUEUE_SUPPORT == ENABLED)
+
+//Authenticator related functions
+bool_t authenticatorQueueEvent(AuthenticatorPort *port,
+   AuthenticatorEventType type, uint_t state);
+
+void authenticatorDeliverEvents(AuthenticatorContext *context);
+
+#else
+
+//The state change callbacks are invoked synchronously
+#define authenticatorQueueEvent(port, type, state) FALSE
+#define authenticatorDeliverEvents(context)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
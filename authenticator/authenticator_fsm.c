@@ -38,6 +38,14 @@
 #include "authenticator/authenticator_backend_fsm.h"
 #include "authenticator/authenticator_reauth_timer_fsm.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_latency.h"
+#include "authenticator/authenticator_host.h"
+#include "authenticator/authenticator_local.h"
+#include "authenticator/authenticator_crypto.h"
+#include "authenticator/authenticator_profile.h"
 #include "eap/eap_full_auth_fsm.h"
 #include "debug.h"
 
@@ -54,6 +62,9 @@ void authenticatorInitFsm(AuthenticatorContext *context)
 {
    uint_t i;
 
+   //The additional sessions are no longer bound to any port
+   authenticatorInitHostSessions(context);
+
    //The state machines are defined on a per-port basis (refer to IEEE Std
    //802.1X-2004, section 8.2)
    for(i = 0; i < context->numPorts; i++)
@@ -62,6 +73,12 @@ void authenticatorInitFsm(AuthenticatorContext *context)
       authenticatorInitPortFsm(&context->ports[i]);
    }
 
+   //Initialize the additional sessions
+   for(i = 0; i < context->numHosts; i++)
+   {
+      authenticatorInitPortFsm(&context->hosts[i]);
+   }
+
    //Update authenticator state machines
    authenticatorFsm(context);
 
@@ -71,6 +88,11 @@ void authenticatorInitFsm(AuthenticatorContext *context)
    {
       context->ports[i].initialize = FALSE;
    }
+
+   for(i = 0; i < context->numHosts; i++)
+   {
+      context->hosts[i].initialize = FALSE;
+   }
 }
 
 
@@ -81,16 +103,10 @@ void authenticatorInitFsm(AuthenticatorContext *context)
 
 void authenticatorInitPortFsm(AuthenticatorPort *port)
 {
-   AuthenticatorContext *context;
-
-   //Point to the 802.1X authenticator context
-   context = port->context;
+   //Stop all the timers of the port
+   authenticatorInitTimers(port);
 
    //Initialize variables
-   port->aWhile = 0;
-   port->quietWhile = 0;
-   port->reAuthWhen = 0;
-
    port->authAbort = FALSE;
    port->authFail = FALSE;
    port->authPortStatus = AUTHENTICATOR_PORT_STATUS_UNKNOWN;
@@ -118,11 +134,18 @@ void authenticatorInitPortFsm(AuthenticatorPort *port)
    port->eapReq = FALSE;
    port->eapResp = FALSE;
 
-   port->eapRespData = context->rxBuffer + sizeof(EapolPdu);
-   port->eapRespDataLen = 0;
-   port->retransWhile = 0;
+   //Return the receive buffer to the EAPOL receive ring
+   authenticatorDetachRxBuffer(port);
+
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+   //Abandon the intervals being measured
+   port->latencyPending = 0;
+#endif
+
+   //Return the session buffer to the pool
+   authenticatorFreePortBuffer(port);
 
-   port->eapReqData = port->eapTxBuffer + sizeof(EapolPdu);
+   port->eapReqData = NULL;
    port->eapReqDataLen = 0;
    port->eapKeyData = NULL;
    port->eapKeyAvailable = 0;
@@ -143,23 +166,36 @@ void authenticatorInitPortFsm(AuthenticatorPort *port)
    port->aaaEapNoReq = FALSE;
    port->aaaSuccess = FALSE;
    port->aaaFail = FALSE;
-   port->aaaEapReqData = port->eapTxBuffer + sizeof(EapolPdu);
+   port->aaaEapReqData = NULL;
    port->aaaEapReqDataLen = 0;
    port->aaaEapKeyData = NULL;
    port->aaaEapKeyAvailable = FALSE;
-   port->aaaMethodTimeout = AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT;
+   port->aaaMethodTimeout = AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT * 1000;
 
    port->aaaEapResp = FALSE;
    port->aaaEapRespData = NULL;
    port->aaaEapRespDataLen = 0;
-   port->aaaIdentity[0] = '\0';
+   port->data->aaaIdentity[0] = '\0';
    port->aaaTimeout = FALSE;
 
+   authenticatorReleaseRadiusId(port);
+   port->aaaServerIndex = 0;
    port->aaaReqId = 0;
-   port->aaaReqData = port->aaaTxBuffer;
+   port->aaaReqSocketIndex = 0;
+   port->aaaAborted = FALSE;
+   port->aaaReqData = NULL;
    port->aaaReqDataLen = 0;
-   port->aaaRetransTimer = 0;
    port->aaaRetransCount = 0;
+   port->aaaRto = 0;
+   port->aaaReqTimestamp = 0;
+   port->data->radiusTemplateLen = 0;
+
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   //Late completions of pending crypto operations are ignored
+   port->cryptoOp = AUTHENTICATOR_CRYPTO_OP_NONE;
+#endif
+
+   port->busy = FALSE;
 
    //Initialize authenticator PAE state machine
    authenticatorPaeInitFsm(port);
@@ -180,71 +216,394 @@ void authenticatorInitPortFsm(AuthenticatorPort *port)
 void authenticatorFsm(AuthenticatorContext *context)
 {
    uint_t i;
+
+   //The run queues are superseded by the evaluation of all the ports
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      authenticatorFlushRunQueue(&context->shards[i]);
+   }
+
+   //The state machines are defined on a per-port basis (refer to IEEE Std
+   //802.1X-2004, section 8.2)
+   for(i = 0; i < context->numPorts; i++)
+   {
+      //Update the state machines of the current port
+      authenticatorPortFsm(&context->ports[i]);
+   }
+
+   //Loop through the additional sessions
+   for(i = 0; i < context->numHosts; i++)
+   {
+      //Update the state machines of the current session
+      authenticatorPortFsm(&context->hosts[i]);
+   }
+}
+
+
+/**
+ * @brief Update the state machines of the ports that have pending events
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorRunFsm(AuthenticatorShard *shard)
+{
    AuthenticatorPort *port;
 
+   //Process the ports in the order in which they have been scheduled
+   while(shard->runQueueHead != NULL)
+   {
+      //Remove the first port from the run queue
+      port = shard->runQueueHead;
+      shard->runQueueHead = port->nextScheduledPort;
+
+      //Last port in the run queue?
+      if(shard->runQueueHead == NULL)
+      {
+         shard->runQueueTail = NULL;
+      }
+
+      //The port is no longer scheduled
+      port->nextScheduledPort = NULL;
+      port->scheduled = FALSE;
+
+      //Update the state machines of the current port
+      authenticatorPortFsm(port);
+
+      //The additional session of a multi-supplicant port is released once
+      //the supplicant is gone
+      if(port->hostReleasePending)
+      {
+         authenticatorReleaseHostSession(port);
+      }
+   }
+}
+
+
+/**
+ * @brief Schedule a port for state machine evaluation
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorSchedulePort(AuthenticatorPort *port)
+{
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //A port appears at most once in the run queue
+   if(!port->scheduled)
+   {
+      //Append the port to the run queue
+      if(shard->runQueueTail != NULL)
+      {
+         shard->runQueueTail->nextScheduledPort = port;
+      }
+      else
+      {
+         shard->runQueueHead = port;
+      }
+
+      //Update the tail of the run queue
+      shard->runQueueTail = port;
+
+      //The port is now scheduled
+      port->nextScheduledPort = NULL;
+      port->scheduled = TRUE;
+   }
+}
+
+
+/**
+ * @brief Remove a port from the run queue
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUnschedulePort(AuthenticatorPort *port)
+{
+   AuthenticatorPort *prevPort;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //Check whether the port is waiting in the run queue
+   if(port->scheduled)
+   {
+      //Search the run queue for the preceding port
+      if(shard->runQueueHead == port)
+      {
+         prevPort = NULL;
+         shard->runQueueHead = port->nextScheduledPort;
+      }
+      else
+      {
+         prevPort = shard->runQueueHead;
+
+         while(prevPort->nextScheduledPort != port)
+         {
+            prevPort = prevPort->nextScheduledPort;
+         }
+
+         prevPort->nextScheduledPort = port->nextScheduledPort;
+      }
+
+      //Last port in the run queue?
+      if(shard->runQueueTail == port)
+      {
+         shard->runQueueTail = prevPort;
+      }
+
+      //The port is no longer scheduled
+      port->nextScheduledPort = NULL;
+      port->scheduled = FALSE;
+   }
+}
+
+
+/**
+ * @brief Remove all the ports from the run queue
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorFlushRunQueue(AuthenticatorShard *shard)
+{
+   AuthenticatorPort *port;
+
+   //Loop through the scheduled ports
+   while(shard->runQueueHead != NULL)
+   {
+      //Remove the first port from the run queue
+      port = shard->runQueueHead;
+      shard->runQueueHead = port->nextScheduledPort;
+
+      //The port is no longer scheduled
+      port->nextScheduledPort = NULL;
+      port->scheduled = FALSE;
+   }
+
+   //The run queue is now empty
+   shard->runQueueTail = NULL;
+}
+
+
+/**
+ * @brief Update the state machines of a given port
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorPortFsm(AuthenticatorPort *port)
+{
+   error_t error;
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   uint32_t cycles;
+   uint32_t buildCycles;
+#endif
+
+   //Read the cycle counter
+   AUTHENTICATOR_PROFILE_START(cycles);
+
    //The behavior of the 802.1X authenticator is specified by a number of
    //cooperating state machines
    do
    {
       //Clear the busy flag
-      context->busy = FALSE;
-
-      //The state machines are defined on a per-port basis (refer to IEEE Std
-      //802.1X-2004, section 8.2)
-      for(i = 0; i < context->numPorts; i++)
+      port->busy = FALSE;
+
+      //Update the authenticator PAE state machine
+      authenticatorPaeFsm(port);
+      //Update the backend authentication state machine
+      authenticatorBackendFsm(port);
+      //Update the reauthentication timer state machine
+      authenticatorReauthTimerFsm(port);
+      //Update the EAP full authenticator state machine
+      eapFullAuthFsm(port);
+
+      //Check the state of the EAP full authenticator state machine
+      if(port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE)
       {
-         //Point to the current port
-         port = &context->ports[i];
-
-         //Update the authenticator PAE state machine
-         authenticatorPaeFsm(port);
-         //Update the backend authentication state machine
-         authenticatorBackendFsm(port);
-         //Update the reauthentication timer state machine
-         authenticatorReauthTimerFsm(port);
-         //Update the EAP full authenticator state machine
-         eapFullAuthFsm(port);
-
-         //Check the state of the EAP full authenticator state machine
-         if(port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE)
+         //Any EAP response available for processing by the AAA server?
+         if(port->aaaEapResp)
          {
-            //Any EAP response available for processing by the AAA server?
-            if(port->aaaEapResp)
+            //Forward the EAP response to the AAA server. The request is
+            //queued if the window of the server is full
+            AUTHENTICATOR_PROFILE_START(buildCycles);
+            error = authenticatorBuildRadiusRequest(port);
+            AUTHENTICATOR_PROFILE_STOP(&port->shard->profile,
+               AUTHENTICATOR_PROFILE_BUILD_REQUEST, buildCycles);
+
+            //Clear flags
+            port->aaaEapResp = FALSE;
+            port->aaaTimeout = FALSE;
+
+            //Check status code
+            if(!error)
             {
-               //Forward the EAP response to the AAA server
-               authenticatorBuildRadiusRequest(port);
-               authenticatorSendRadiusRequest(port);
-
-               //Clear flags
-               port->aaaEapResp = FALSE;
-               port->aaaTimeout = FALSE;
-            }
-            else if(port->aaaRetransTimer == 0)
-            {
-               //Check retransmission counter
-               if(port->aaaRetransCount < AUTHENTICATOR_MAX_RADIUS_RETRANS)
+               //The request is queued if the window of the server is full
+               if(authenticatorAcquireRadiusSlot(port))
                {
-                  //Retransmit RADIUS Access-Request packet
                   authenticatorSendRadiusRequest(port);
                }
-               else
-               {
-                  //Set the aaaTimeout flag if, after a configurable amount of
-                  //time, there is no response from the AAA layer
-                  port->aaaTimeout = TRUE;
-                  context->busy = TRUE;
-               }
+            }
+            else if(error != ERROR_IN_PROGRESS)
+            {
+               //Debug message
+               TRACE_WARNING("Port %" PRIu16 ": Failed to build "
+                  "Access-Request!\r\n", port->portIndex);
+
+               //The Access-Request cannot be sent, so no slot is taken in the
+               //window of the server
+               port->aaaTimeout = TRUE;
+               port->busy = TRUE;
             }
             else
             {
-               //Just for sanity
+               //The request is sent once the crypto provider has completed
             }
          }
+         else if(authenticatorIsCryptoPending(port))
+         {
+            //The Access-Request is not ready yet
+         }
+         else if(port->aaaRetransTimer == 0 && !port->aaaQueued)
+         {
+            //Eligible supplicants do not wait for the last retransmission
+            //once the critical authentication deadline has elapsed. Else,
+            //check retransmission counter. A queued request is sent for the
+            //first time once room has been made in the window
+            if(authenticatorCheckCriticalAuthDeadline(port))
+            {
+               //Give up waiting for the RADIUS server
+               port->aaaTimeout = TRUE;
+               port->busy = TRUE;
+            }
+            else if(authenticatorIsRadiusRequestAborted(port))
+            {
+               //The identifier has been handed over to another request, so
+               //the response could not be matched. The server is not blamed
+               port->aaaTimeout = TRUE;
+               port->busy = TRUE;
+            }
+            else if(port->aaaRetransCount < AUTHENTICATOR_MAX_RADIUS_RETRANS)
+            {
+               //Retransmit RADIUS Access-Request packet
+               authenticatorSendRadiusRequest(port);
+            }
+            else
+            {
+               //Set the aaaTimeout flag if, after a configurable amount of
+               //time, there is no response from the AAA layer
+               port->aaaTimeout = TRUE;
+               port->busy = TRUE;
+
+               //Keep track of the servers that fail to answer
+               authenticatorRadiusServerTimeout(port);
+            }
+         }
+         else
+         {
+            //Just for sanity
+         }
       }
 
       //Transition conditions are evaluated continuously as long as the
-      //authenticator state machine is busy
-   } while(context->busy);
+      //state machines of the port are busy
+   } while(port->busy);
+
+   //The EAP response has been consumed by the state machines? The eapResp
+   //variable is left set once the response has been processed, so it only
+   //denotes a pending response while the EAP state machine is idle
+   if(port->rxBuffer != NULL && !port->eapolEap && !port->aaaEapResp &&
+      (!port->eapResp || (port->eapFullAuthState != EAP_FULL_AUTH_STATE_IDLE &&
+      port->eapFullAuthState != EAP_FULL_AUTH_STATE_IDLE2)))
+   {
+      //Return the receive buffer to the EAPOL receive ring
+      authenticatorDetachRxBuffer(port);
+
+      //The response has been copied into the Access-Request if it has been
+      //forwarded to the server
+      if(port->eapFullAuthState != EAP_FULL_AUTH_STATE_AAA_IDLE)
+      {
+         //The response has not been forwarded to the server
+         authenticatorCancelLatency(port,
+            AUTHENTICATOR_LATENCY_RESP_TO_ACCESS_REQ);
+      }
+   }
+
+   //Publish the new state of the port
+   authenticatorUpdatePortSnapshot(port);
+
+   //Account for the cycles spent in the state machines
+   AUTHENTICATOR_PROFILE_STOP(&port->shard->profile,
+      AUTHENTICATOR_PROFILE_PORT_FSM, cycles);
+}
+
+
+/**
+ * @brief Evaluate the exit conditions of the current state
+ *
+ * Only the global transitions and the transitions listed for the current
+ * state are evaluated, by order of precedence
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] table Transition table of the state machine
+ * @param[in] state Current state
+ * @param[out] newState State to switch to
+ * @return TRUE if a transition must take place, FALSE if the state is stable
+ **/
+
+bool_t authenticatorEvalFsm(AuthenticatorPort *port,
+   const AuthenticatorFsmTable *table, uint_t state, uint_t *newState)
+{
+   uint_t i;
+   const AuthenticatorFsmState *desc;
+   const AuthenticatorFsmTransition *transition;
+
+   //A global transition can occur from any of the possible states. When the
+   //condition associated with a global transition is met, it supersedes all
+   //other exit conditions
+   for(i = 0; i < table->numGlobalTransitions; i++)
+   {
+      //Point to the current transition
+      transition = &table->globalTransitions[i];
+
+      //Check the condition associated with the transition
+      if(transition->condition(port))
+      {
+         *newState = transition->newState;
+         return TRUE;
+      }
+   }
+
+   //Invalid state?
+   if(state >= table->numStates)
+   {
+      //Just for sanity
+      authenticatorFsmError(port->context);
+      return FALSE;
+   }
+
+   //Point to the exit conditions of the current state
+   desc = &table->states[state];
+
+   //All exit conditions for the state are evaluated continuously until one
+   //of the conditions is met
+   for(i = 0; i < desc->numTransitions; i++)
+   {
+      //Point to the current transition
+      transition = &desc->transitions[i];
+
+      //Unconditional transition or condition met?
+      if(transition->condition == AUTHENTICATOR_FSM_UCT ||
+         transition->condition(port))
+      {
+         *newState = transition->newState;
+         return TRUE;
+      }
+   }
+
+   //None of the exit conditions is met
+   return FALSE;
 }
 
 
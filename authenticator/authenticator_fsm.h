@@ -39,10 +39,81 @@
 extern "C" {
 #endif
 
+//Define the condition of a transition
+#define AUTHENTICATOR_FSM_CONDITION(name, expr) \
+   static bool_t name(AuthenticatorPort *port) \
+   { \
+      return (expr) ? TRUE : FALSE; \
+   }
+
+//Unconditional transition (UCT)
+#define AUTHENTICATOR_FSM_UCT NULL
+
+//Exit conditions of a state
+#define AUTHENTICATOR_FSM_STATE(transitions) {transitions, arraysize(transitions)}
+//State that can only be left through a global transition
+#define AUTHENTICATOR_FSM_FINAL_STATE {NULL, 0}
+
+//Transition table of a state machine
+#define AUTHENTICATOR_FSM_TABLE(globalTransitions, states) \
+   {globalTransitions, arraysize(globalTransitions), states, arraysize(states)}
+
+
+/**
+ * @brief Transition condition
+ **/
+
+typedef bool_t (*AuthenticatorFsmCondition)(AuthenticatorPort *port);
+
+
+/**
+ * @brief State transition
+ **/
+
+typedef struct
+{
+   AuthenticatorFsmCondition condition; ///<Condition of the transition (NULL for an unconditional transition)
+   uint_t newState;                     ///<State to switch to
+} AuthenticatorFsmTransition;
+
+
+/**
+ * @brief Exit conditions of a state
+ **/
+
+typedef struct
+{
+   const AuthenticatorFsmTransition *transitions; ///<Transitions the state reacts to, by order of precedence
+   uint_t numTransitions;                         ///<Number of transitions
+} AuthenticatorFsmState;
+
+
+/**
+ * @brief Transition table of a state machine
+ **/
+
+typedef struct
+{
+   const AuthenticatorFsmTransition *globalTransitions; ///<Global transitions, by order of precedence
+   uint_t numGlobalTransitions;                         ///<Number of global transitions
+   const AuthenticatorFsmState *states;                 ///<Exit conditions, indexed by state
+   uint_t numStates;                                    ///<Number of states
+} AuthenticatorFsmTable;
+
+
 //Authenticator related functions
 void authenticatorInitFsm(AuthenticatorContext *context);
 void authenticatorInitPortFsm(AuthenticatorPort *port);
 void authenticatorFsm(AuthenticatorContext *context);
+void authenticatorRunFsm(AuthenticatorShard *shard);
+void authenticatorSchedulePort(AuthenticatorPort *port);
+void authenticatorUnschedulePort(AuthenticatorPort *port);
+void authenticatorFlushRunQueue(AuthenticatorShard *shard);
+void authenticatorPortFsm(AuthenticatorPort *port);
+
+bool_t authenticatorEvalFsm(AuthenticatorPort *port,
+   const AuthenticatorFsmTable *table, uint_t state, uint_t *newState);
+
 void authenticatorFsmError(AuthenticatorContext *context);
 
 //C++ guard
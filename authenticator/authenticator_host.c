@@ -0,0 +1,534 @@
+/**
+ * @file authenticator_host.c
+ * @brief Multi-supplicant ports
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_procedures.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_host.h"
+#include "authenticator/authenticator_acct.h"
+#include "authenticator/authenticator_stream.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Unbind all the additional sessions
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorInitHostSessions(AuthenticatorContext *context)
+{
+   uint_t i;
+   AuthenticatorPort *host;
+
+   //Clear the hash tables
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      osMemset(context->shards[i].hostHash, 0,
+         sizeof(context->shards[i].hostHash));
+   }
+
+   //No additional session is bound to the ports
+   for(i = 0; i < context->numPorts; i++)
+   {
+      context->ports[i].numHosts = 0;
+   }
+
+   //Loop through the additional sessions
+   for(i = 0; i < context->numHosts; i++)
+   {
+      //Point to the current session
+      host = &context->hosts[i];
+
+      //The session is free
+      host->parent = NULL;
+      host->nextHost = NULL;
+      host->hostConnected = FALSE;
+      host->hostReleasePending = FALSE;
+      host->portEnabled = FALSE;
+      host->portControl = AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH;
+      host->supplicantMacAddr = MAC_UNSPECIFIED_ADDR;
+   }
+}
+
+
+/**
+ * @brief Hash function used to index the additional sessions
+ * @param[in] port Pointer to the port context
+ * @param[in] macAddr MAC address of the supplicant
+ * @return Index of the bucket
+ **/
+
+uint_t authenticatorHashHost(AuthenticatorPort *port, const MacAddr *macAddr)
+{
+   uint_t i;
+   uint_t h;
+
+   //The hash combines the port number and the MAC address of the supplicant
+   h = port->portIndex;
+
+   //Process the MAC address
+   for(i = 0; i < sizeof(MacAddr); i++)
+   {
+      h = (h * 31) + macAddr->b[i];
+   }
+
+   //Return the index of the bucket
+   return h % AUTHENTICATOR_HOST_HASH_SIZE;
+}
+
+
+/**
+ * @brief Select the session that processes the frames of a given supplicant
+ *
+ * On multi-supplicant ports, the first supplicant is handled by the port
+ * itself. Each subsequent supplicant is assigned an additional session, with
+ * its own state machines and RADIUS transaction
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] macAddr MAC address of the supplicant
+ * @param[in] packetType EAPOL packet type
+ * @return Pointer to the selected session (NULL if the frame must be
+ *   discarded)
+ **/
+
+AuthenticatorPort *authenticatorSelectHostSession(AuthenticatorPort *port,
+   const MacAddr *macAddr, uint8_t packetType)
+{
+   AuthenticatorPort *host;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Multi-supplicant operation is only relevant for the ports controlled by
+   //the authenticator
+   if(context->maxHostsPerPort <= 1 ||
+      port->portControl != AUTHENTICATOR_PORT_MODE_AUTO)
+   {
+      return port;
+   }
+
+   //Frame sent by the supplicant the port is bound to?
+   if(macCompAddr(&port->supplicantMacAddr, macAddr))
+      return port;
+
+   //The port has not heard from any supplicant yet. The EAP-Request/Identity
+   //sent on link up already moves it to the AUTHENTICATING state, so the
+   //first supplicant must be bound to the port regardless of its state
+   if(macCompAddr(&port->supplicantMacAddr, &MAC_UNSPECIFIED_ADDR))
+      return port;
+
+   //Search the hash table for a matching session
+   host = authenticatorFindHostSession(port, macAddr);
+   //Any session found?
+   if(host != NULL)
+      return host;
+
+   //The first supplicant is handled by the port itself. The port is bound
+   //to its supplicant as long as an authentication is in progress or the
+   //supplicant is authorized
+   if(port->authPortStatus != AUTHENTICATOR_PORT_STATUS_AUTH &&
+      (port->authPaeState == AUTHENTICATOR_PAE_STATE_INITIALIZE ||
+      port->authPaeState == AUTHENTICATOR_PAE_STATE_DISCONNECTED ||
+      port->authPaeState == AUTHENTICATOR_PAE_STATE_CONNECTING))
+   {
+      return port;
+   }
+
+   //A supplicant that has no session cannot log off
+   if(packetType == EAPOL_TYPE_LOGOFF)
+      return NULL;
+
+   //Enforce the maximum number of supplicants per port
+   if((port->numHosts + 1) >= context->maxHostsPerPort)
+   {
+      //Debug message
+      TRACE_WARNING("Port %" PRIu16 ": Too many supplicants!\r\n",
+         port->portIndex);
+      //The frame is discarded
+      return NULL;
+   }
+
+   //Assign an additional session to the supplicant
+   return authenticatorAllocHostSession(port, macAddr);
+}
+
+
+/**
+ * @brief Search the hash table for the session of a given supplicant
+ * @param[in] port Pointer to the port context
+ * @param[in] macAddr MAC address of the supplicant
+ * @return Pointer to the matching session (NULL if not found)
+ **/
+
+AuthenticatorPort *authenticatorFindHostSession(AuthenticatorPort *port,
+   const MacAddr *macAddr)
+{
+   AuthenticatorPort *host;
+
+   //Point to the relevant bucket
+   host = port->shard->hostHash[authenticatorHashHost(port, macAddr)];
+
+   //Loop through the sessions of the bucket
+   while(host != NULL)
+   {
+      //Matching session?
+      if(host->parent == port && macCompAddr(&host->supplicantMacAddr, macAddr))
+         break;
+
+      //Point to the next session
+      host = host->nextHost;
+   }
+
+   //Return a pointer to the matching session, if any
+   return host;
+}
+
+
+/**
+ * @brief Assign an additional session to a supplicant
+ * @param[in] port Pointer to the port context
+ * @param[in] macAddr MAC address of the supplicant
+ * @return Pointer to the new session (NULL if no session is available)
+ **/
+
+AuthenticatorPort *authenticatorAllocHostSession(AuthenticatorPort *port,
+   const MacAddr *macAddr)
+{
+   uint_t i;
+   uint_t h;
+   AuthenticatorPort *host;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //Sessions are only bound to the ports of their own shard
+   for(i = 0; i < shard->numHosts; i++)
+   {
+      //Point to the current session
+      host = &port->context->hosts[shard->firstHost + i];
+
+      //Free session?
+      if(host->parent == NULL)
+         break;
+   }
+
+   //No session available?
+   if(i >= shard->numHosts)
+   {
+      //Debug message
+      TRACE_WARNING("Port %" PRIu16 ": No free session!\r\n", port->portIndex);
+      //Report an error
+      return NULL;
+   }
+
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": New supplicant %s...\r\n", port->portIndex,
+      macAddrToString(macAddr, NULL));
+
+   //Bind the session to the port
+   host->parent = port;
+   host->supplicantMacAddr = *macAddr;
+   host->macAddr = port->macAddr;
+   host->hostConnected = FALSE;
+   host->hostReleasePending = FALSE;
+   host->sessionTimeout = 0;
+   host->reAuthDeferrals = 0;
+   host->reAuthDeferDelay = 0;
+
+   //The session inherits the parameters of the port
+   host->portControl = port->portControl;
+   host->quietPeriod = port->quietPeriod;
+   host->serverTimeout = port->serverTimeout;
+   host->maxRetrans = port->maxRetrans;
+   host->reAuthMax = port->reAuthMax;
+   host->reAuthPeriod = port->reAuthPeriod;
+   host->reAuthEnabled = port->reAuthEnabled;
+   host->keyTxEnabled = port->keyTxEnabled;
+
+   //The link is shared with the port
+   host->portEnabled = TRUE;
+
+   //Clear statistics
+   osMemset(&host->data->stats, 0, sizeof(AuthenticatorStats));
+   osMemset(&host->data->sessionStats, 0, sizeof(AuthenticatorSessionStats));
+
+   //The rate limiters of the session start full
+   osMemset(&host->data->startBucket, 0, sizeof(AuthenticatorTokenBucket));
+   osMemset(&host->data->eapBucket, 0, sizeof(AuthenticatorTokenBucket));
+
+   //The invariant RADIUS attributes depend on the supplicant
+   authenticatorInvalidateRadiusTemplate(host);
+
+   //Insert the session at the head of the bucket
+   h = authenticatorHashHost(port, macAddr);
+   host->nextHost = shard->hostHash[h];
+   shard->hostHash[h] = host;
+
+   //Update the number of additional sessions bound to the port
+   port->numHosts++;
+
+   //The state machines are held in their initial state until initialize is
+   //deasserted
+   authenticatorInitPortFsm(host);
+   authenticatorPortFsm(host);
+   host->initialize = FALSE;
+
+   //The state machines of the session must be evaluated
+   authenticatorSchedulePort(host);
+
+   //Return a pointer to the new session
+   return host;
+}
+
+
+/**
+ * @brief Release an additional session
+ * @param[in] host Pointer to the session
+ **/
+
+void authenticatorReleaseHostSession(AuthenticatorPort *host)
+{
+   uint_t h;
+   AuthenticatorPort *port;
+   AuthenticatorPort **p;
+
+   //Point to the port the session is bound to
+   port = host->parent;
+
+   //Free session?
+   if(port == NULL)
+   {
+      host->hostReleasePending = FALSE;
+      return;
+   }
+
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": Releasing session of supplicant %s...\r\n",
+      port->portIndex, macAddrToString(&host->supplicantMacAddr, NULL));
+
+   //Point to the relevant bucket
+   h = authenticatorHashHost(port, &host->supplicantMacAddr);
+   p = &port->shard->hostHash[h];
+
+   //Remove the session from the hash table
+   while(*p != NULL)
+   {
+      //Matching session?
+      if(*p == host)
+      {
+         *p = host->nextHost;
+         break;
+      }
+
+      //Point to the next session
+      p = &(*p)->nextHost;
+   }
+
+   //Update the number of additional sessions bound to the port
+   if(port->numHosts > 0)
+   {
+      port->numHosts--;
+   }
+
+   //The supplicant is no longer authorized
+   if(host->authPortStatus == AUTHENTICATOR_PORT_STATUS_AUTH)
+   {
+      authenticatorSetAuthPortStatus(host, AUTHENTICATOR_PORT_STATUS_UNAUTH);
+   }
+
+   //The accounting session of the supplicant is over
+   authenticatorUpdateAcctSession(host);
+   //Report the end of the session
+   authenticatorUpdateSessionStream(host);
+
+   //Unbind the session
+   host->parent = NULL;
+   host->nextHost = NULL;
+   host->hostConnected = FALSE;
+   host->portEnabled = FALSE;
+   host->portControl = AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH;
+
+   //Stop the timers and return the session buffer, the receive buffer and
+   //the RADIUS identifier
+   authenticatorInitPortFsm(host);
+   host->initialize = FALSE;
+
+   //Make sure the session is no longer present in the run queue
+   authenticatorUnschedulePort(host);
+
+   //The session is now free
+   host->hostReleasePending = FALSE;
+   host->supplicantMacAddr = MAC_UNSPECIFIED_ADDR;
+
+   //Publish the new state of the session
+   authenticatorUpdatePortSnapshot(host);
+}
+
+
+/**
+ * @brief Release all the additional sessions of a port
+ *
+ * The sessions are released once their state machines have been evaluated
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorFlushHostSessions(AuthenticatorPort *port)
+{
+   uint_t i;
+   AuthenticatorPort *host;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //Loop through the additional sessions of the shard
+   for(i = 0; i < shard->numHosts && port->numHosts > 0; i++)
+   {
+      //Point to the current session
+      host = &port->context->hosts[shard->firstHost + i];
+
+      //Session bound to the port?
+      if(host->parent == port)
+      {
+         //The supplicant can no longer reach the authenticator
+         host->portEnabled = FALSE;
+         host->hostReleasePending = TRUE;
+
+         //The state machines of the session must be evaluated
+         authenticatorSchedulePort(host);
+      }
+   }
+}
+
+
+/**
+ * @brief Report the authorization state of a supplicant
+ *
+ * The port forwards traffic as long as one of its supplicants is authorized.
+ * Traffic can be further filtered by MAC address using the host status
+ * callback
+ *
+ * @param[in] port Pointer to the port context or to the additional session
+ **/
+
+void authenticatorUpdateHostStatus(AuthenticatorPort *port)
+{
+   uint_t i;
+   bool_t authorized;
+   AuthenticatorPort *host;
+   AuthenticatorShard *shard;
+   AuthenticatorContext *context;
+   NetInterface *interface;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the network interface the port is attached to
+   interface = authenticatorGetPortInterface(port)->interface;
+
+   //Free session?
+   if(port->host && port->parent == NULL)
+      return;
+
+   //Any supplicant?
+   if(!macCompAddr(&port->supplicantMacAddr, &MAC_UNSPECIFIED_ADDR))
+   {
+      //Any registered callback?
+      if(context->hostStatusCallback != NULL)
+      {
+         //Invoke user callback function
+         context->hostStatusCallback(authenticatorGetPhysicalPort(port),
+            &port->supplicantMacAddr, port->authPortStatus);
+      }
+   }
+
+   //Point to the port the supplicant is attached to
+   port = authenticatorGetPhysicalPort(port);
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //Check whether the supplicant handled by the port itself is authorized
+   authorized = (port->authPortStatus == AUTHENTICATOR_PORT_STATUS_AUTH) ?
+      TRUE : FALSE;
+
+   //Loop through the additional sessions of the shard
+   for(i = 0; i < shard->numHosts && !authorized; i++)
+   {
+      //Point to the current session
+      host = &context->hosts[shard->firstHost + i];
+
+      //Authorized supplicant attached to the same port?
+      if(host->parent == port &&
+         host->authPortStatus == AUTHENTICATOR_PORT_STATUS_AUTH)
+      {
+         authorized = TRUE;
+      }
+   }
+
+   //Update the state of the port
+   if(interface->switchDriver != NULL &&
+      interface->switchDriver->setPortState != NULL)
+   {
+      interface->switchDriver->setPortState(interface,
+         authenticatorGetSwitchPort(port), authorized ? SWITCH_PORT_STATE_FORWARDING : SWITCH_PORT_STATE_BLOCKING);
+   }
+}
+
+
+/**
+ * @brief Get the port a session is attached to
+ * @param[in] port Pointer to the port context or to the additional session
+ * @return Pointer to the port context
+ **/
+
+AuthenticatorPort *authenticatorGetPhysicalPort(AuthenticatorPort *port)
+{
+   //Additional sessions share the port they are bound to
+   if(port->host && port->parent != NULL)
+   {
+      return port->parent;
+   }
+   else
+   {
+      return port;
+   }
+}
+
+#endif
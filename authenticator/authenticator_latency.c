@@ -0,0 +1,178 @@
+/**
+ * @file authenticator_latency.c
+ * @brief Latency statistics
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_latency.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Add a sample to a latency histogram
+ * @param[in] histogram Pointer to the histogram
+ * @param[in] value Measured latency, in milliseconds
+ **/
+
+void authenticatorUpdateHistogram(AuthenticatorHistogram *histogram,
+   systime_t value)
+{
+   uint_t i;
+   systime_t n;
+
+   //The bucket index is the position of the most significant bit
+   for(i = 0, n = value; n > 0 && i < (AUTHENTICATOR_LATENCY_NUM_BUCKETS - 1); i++)
+   {
+      n >>= 1;
+   }
+
+   //Update the histogram
+   histogram->buckets[i]++;
+   histogram->count++;
+   histogram->sum += (uint32_t) value;
+
+   //Keep track of the largest sample
+   if(value > histogram->max)
+   {
+      histogram->max = (uint32_t) value;
+   }
+}
+
+
+/**
+ * @brief Merge two latency histograms
+ * @param[in,out] histogram Pointer to the resulting histogram
+ * @param[in] other Histogram to be added
+ **/
+
+void authenticatorMergeHistogram(AuthenticatorHistogram *histogram,
+   const AuthenticatorHistogram *other)
+{
+   uint_t i;
+
+   //Add the samples of both histograms
+   for(i = 0; i < AUTHENTICATOR_LATENCY_NUM_BUCKETS; i++)
+   {
+      histogram->buckets[i] += other->buckets[i];
+   }
+
+   //Update totals
+   histogram->count += other->count;
+   histogram->sum += other->sum;
+   histogram->max = MAX(histogram->max, other->max);
+}
+
+
+/**
+ * @brief Start measuring an interval
+ *
+ * The interval runs from the first event that starts it. Subsequent events
+ * are ignored until the interval is stopped or cancelled
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] stage Interval to be measured
+ **/
+
+void authenticatorStartLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage)
+{
+   //The interval is not being measured yet?
+   if((port->latencyPending & (1U << stage)) == 0)
+   {
+      //Save the start of the interval
+      port->data->latencyTimestamps[stage] = osGetSystemTime();
+      port->latencyPending |= (1U << stage);
+   }
+}
+
+
+/**
+ * @brief Stop measuring an interval and record its duration
+ * @param[in] port Pointer to the port context
+ * @param[in] stage Measured interval
+ **/
+
+void authenticatorStopLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage)
+{
+   //Is the interval being measured?
+   if((port->latencyPending & (1U << stage)) != 0)
+   {
+      //Record the duration of the interval
+      authenticatorUpdateHistogram(&port->data->latency[stage],
+         osGetSystemTime() - port->data->latencyTimestamps[stage]);
+
+      //The measurement is complete
+      port->latencyPending &= ~(1U << stage);
+   }
+}
+
+
+/**
+ * @brief Abandon the measurement of an interval
+ * @param[in] port Pointer to the port context
+ * @param[in] stage Measured interval
+ **/
+
+void authenticatorCancelLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage)
+{
+   //The interval will not be recorded
+   port->latencyPending &= ~(1U << stage);
+}
+
+
+/**
+ * @brief Record the round-trip time of a RADIUS exchange
+ *
+ * The caller must hold the mutex of the 802.1X authenticator context
+ *
+ * @param[in] port Pointer to the port that issued the request
+ * @param[in] server RADIUS server that answered
+ * @param[in] rtt Round-trip time, in milliseconds
+ **/
+
+void authenticatorRecordRadiusRtt(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, systime_t rtt)
+{
+   //Update the histogram of the port
+   authenticatorUpdateHistogram(
+      &port->data->latency[AUTHENTICATOR_LATENCY_RADIUS_RTT], rtt);
+
+   //Update the histogram of the server
+   authenticatorUpdateHistogram(&server->rttHistogram, rtt);
+}
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file authenticator_latency.h
+ * @brief Latency statistics
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_LATENCY_H
+#define _AUTHENTICATOR_LATENCY_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Latency statistics supported?
+#if (AUTHENTICATOR_LATENCY_STATS_SUPPORT == ENABLED)
+
+//Authenticator related functions
+void authenticatorUpdateHistogram(AuthenticatorHistogram *histogram,
+   systime_t value);
+
+void authenticatorMergeHistogram(AuthenticatorHistogram *histogram,
+   const AuthenticatorHistogram *other);
+
+void authenticatorStartLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage);
+
+void authenticatorStopLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage);
+
+void authenticatorCancelLatency(AuthenticatorPort *port,
+   AuthenticatorLatencyStage stage);
+
+void authenticatorRecordRadiusRtt(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, systime_t rtt);
+
+#else
+
+//Latency statistics are not supported
+#define authenticatorStartLatency(port, stage)
+#define authenticatorStopLatency(port, stage)
+#define authenticatorCancelLatency(port, stage)
+#define authenticatorRecordRadiusRtt(port, server, rtt)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,458 @@
+/**
+ * @file authenticator_local.c
+ * @brief Local authentication fallback
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_local.h"
+#include "authenticator/authenticator_cache.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_random.h"
+#include "eap/eap_debug.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Search the local credential store for a given identity
+ *
+ * The caller is responsible for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] identity NULL-terminated string containing the identity (an
+ *   empty string selects a free entry)
+ * @return Pointer to the matching entry (NULL if not found)
+ **/
+
+AuthenticatorLocalUser *authenticatorFindLocalUser(
+   AuthenticatorContext *context, const char_t *identity)
+{
+   uint_t i;
+
+   //Loop through the entries of the credential store
+   for(i = 0; i < AUTHENTICATOR_MAX_LOCAL_USERS; i++)
+   {
+      //Matching entry?
+      if(osStrcmp(context->localUsers[i].identity, identity) == 0)
+      {
+         return &context->localUsers[i];
+      }
+   }
+
+   //No matching entry
+   return NULL;
+}
+
+
+/**
+ * @brief Save the identity of the supplicant
+ *
+ * The identity is needed to authenticate the supplicant locally, before any
+ * Access-Request has been built
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorSaveLocalIdentity(AuthenticatorPort *port)
+{
+   size_t n;
+
+   //Malformed EAP-Response/Identity?
+   if(port->eapRespDataLen < sizeof(EapResponse))
+      return;
+
+   //Determine the length of the identity
+   n = port->eapRespDataLen - sizeof(EapResponse);
+   //Limit the length of the string
+   n = MIN(n, AUTHENTICATOR_MAX_ID_LEN);
+
+   //Copy the Type-Data field of the EAP-Response/Identity
+   osMemcpy(port->data->aaaIdentity, port->eapRespData + sizeof(EapResponse),
+      n);
+   port->data->aaaIdentity[n] = '\0';
+}
+
+
+/**
+ * @brief Check whether the supplicant can be authenticated locally
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the critical authentication policy applies to the
+ *   supplicant, else FALSE
+ **/
+
+bool_t authenticatorCheckCriticalAuth(AuthenticatorPort *port)
+{
+   bool_t eligible;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The policy is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Check critical authentication policy
+   if(context->criticalAuthPolicy == AUTHENTICATOR_CRITICAL_AUTH_DISABLED)
+   {
+      //The supplicant must be authenticated by a RADIUS server
+      eligible = FALSE;
+   }
+   else if(authenticatorCheckAuthCache(port))
+   {
+      //The supplicant has been recently authorized by a RADIUS server
+      eligible = TRUE;
+   }
+   else if(context->criticalAuthPolicy == AUTHENTICATOR_CRITICAL_AUTH_LOCAL &&
+      port->data->aaaIdentity[0] != '\0' &&
+      authenticatorFindLocalUser(context, port->data->aaaIdentity) != NULL)
+   {
+      //The identity is present in the local credential store
+      eligible = TRUE;
+   }
+   else
+   {
+      //The supplicant is unknown to the NAS
+      eligible = FALSE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return TRUE if the supplicant can be authenticated locally
+   return eligible;
+}
+
+
+/**
+ * @brief Switch the session to local authentication, if permitted
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the supplicant is to be authenticated locally, else FALSE
+ **/
+
+bool_t authenticatorStartCriticalAuth(AuthenticatorPort *port)
+{
+   //Check whether the supplicant is eligible
+   if(!authenticatorCheckCriticalAuth(port))
+      return FALSE;
+
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": RADIUS servers unavailable, authenticating "
+      "supplicant locally...\r\n", port->portIndex);
+
+   //The NAS answers on behalf of the RADIUS servers
+   port->localAuth = TRUE;
+   port->localAuthSuccess = FALSE;
+
+   //The conversation resumes right after the EAP-Response/Identity
+   port->currentMethod = EAP_METHOD_TYPE_IDENTITY;
+
+   //The supplicant is authenticated locally
+   return TRUE;
+}
+
+
+/**
+ * @brief Check whether the local authentication must be used right away
+ *
+ * When no RADIUS server is believed to be reachable, there is no point in
+ * sending an Access-Request that will not be answered
+ *
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the supplicant is to be authenticated locally, else FALSE
+ **/
+
+bool_t authenticatorSelectLocalAuth(AuthenticatorPort *port)
+{
+   //The decision is made once the identity of the supplicant is known
+   if(port->currentMethod != EAP_METHOD_TYPE_IDENTITY)
+      return FALSE;
+
+   //Any RADIUS server available?
+   if(authenticatorIsRadiusReachable(port->context))
+      return FALSE;
+
+   //Switch to local authentication, if permitted
+   return authenticatorStartCriticalAuth(port);
+}
+
+
+/**
+ * @brief Check whether the critical authentication deadline has elapsed
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the supplicant is to be authenticated locally without
+ *   waiting any longer for the RADIUS server, else FALSE
+ **/
+
+bool_t authenticatorCheckCriticalAuthDeadline(AuthenticatorPort *port)
+{
+   systime_t deadline;
+
+   //Retrieve the deadline
+   osAcquireMutex(&port->context->mutex);
+   deadline = port->context->criticalAuthDeadline * 1000;
+   osReleaseMutex(&port->context->mutex);
+
+   //The deadline is disabled?
+   if(deadline == 0)
+      return FALSE;
+
+   //The request has not been sent yet?
+   if(port->aaaRetransCount == 0)
+      return FALSE;
+
+   //The deadline runs from the first transmission of the Access-Request
+   if((osGetSystemTime() - port->aaaReqTimestamp) < deadline)
+      return FALSE;
+
+   //Only eligible supplicants stop waiting for the RADIUS server
+   return authenticatorCheckCriticalAuth(port);
+}
+
+
+/**
+ * @brief Determine the policy decision of a locally authenticated session
+ * @param[in] port Pointer to the port context
+ * @return Decision enumeration
+ **/
+
+EapDecision authenticatorGetLocalDecision(AuthenticatorPort *port)
+{
+   bool_t known;
+   EapDecision decision;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Check current method
+   if(port->currentMethod == EAP_METHOD_TYPE_IDENTITY)
+   {
+      //Recently authorized supplicants are not challenged
+      if(authenticatorCheckAuthCache(port))
+      {
+         decision = EAP_DECISION_SUCCESS;
+      }
+      else
+      {
+         //Search the local credential store for the identity
+         osAcquireMutex(&context->mutex);
+
+         known = (context->criticalAuthPolicy == AUTHENTICATOR_CRITICAL_AUTH_LOCAL &&
+            port->data->aaaIdentity[0] != '\0' &&
+            authenticatorFindLocalUser(context,
+            port->data->aaaIdentity) != NULL) ? TRUE : FALSE;
+
+         osReleaseMutex(&context->mutex);
+
+         //Local users are authenticated using EAP-MD5
+         decision = known ? EAP_DECISION_CONTINUE : EAP_DECISION_FAILURE;
+      }
+   }
+   else if(port->currentMethod == EAP_METHOD_TYPE_MD5_CHALLENGE)
+   {
+      //The supplicant must have proven the knowledge of its password
+      decision = port->localAuthSuccess ? EAP_DECISION_SUCCESS :
+         EAP_DECISION_FAILURE;
+   }
+   else
+   {
+      //No other method is supported locally
+      decision = EAP_DECISION_FAILURE;
+   }
+
+   //Debug message
+   if(decision == EAP_DECISION_SUCCESS)
+   {
+      TRACE_INFO("Port %" PRIu16 ": Supplicant authenticated locally\r\n",
+         port->portIndex);
+   }
+   else if(decision == EAP_DECISION_FAILURE)
+   {
+      TRACE_INFO("Port %" PRIu16 ": Local authentication failed\r\n",
+         port->portIndex);
+   }
+   else
+   {
+      //Just for sanity
+   }
+
+   //Return policy decision
+   return decision;
+}
+
+
+/**
+ * @brief Build EAP-Request/MD5-Challenge packet
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorBuildMd5Challenge(AuthenticatorPort *port)
+{
+   error_t error;
+   size_t n;
+   EapRequest *request;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The challenge must be unpredictable (refer to RFC 1994, section 2.3)
+   osAcquireMutex(&context->mutex);
+   error = authenticatorGetRandomData(context, port->data->localChallenge,
+      MD5_DIGEST_SIZE);
+   osReleaseMutex(&context->mutex);
+
+   //Failed to generate the challenge?
+   if(error)
+   {
+      //The request cannot be formatted
+      port->eapReqDataLen = 0;
+      return;
+   }
+
+   //Point to the buffer where to format the EAP packet
+   request = (EapRequest *) port->eapReqData;
+
+   //Format EAP packet
+   request->code = EAP_CODE_REQUEST;
+   request->identifier = port->currentId;
+   request->type = EAP_METHOD_TYPE_MD5_CHALLENGE;
+
+   //The Value-Size field is followed by the challenge value (refer to
+   //RFC 3748, section 5.4)
+   request->data[0] = MD5_DIGEST_SIZE;
+   osMemcpy(request->data + 1, port->data->localChallenge, MD5_DIGEST_SIZE);
+
+   //Total length of the EAP packet
+   n = sizeof(EapRequest) + 1 + MD5_DIGEST_SIZE;
+   //Convert the length field to network byte order
+   request->length = htons(n);
+
+   //Debug message
+   TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+      port->portIndex, n);
+
+   //Dump EAP header contents for debugging purpose
+   eapDumpHeader((EapPacket *) request);
+
+   //Save the length of the EAP request
+   port->eapReqDataLen = n;
+}
+
+
+/**
+ * @brief Check the format of an EAP-Response/MD5-Challenge packet
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the message is invalid and must be ignored, else FALSE
+ **/
+
+bool_t authenticatorCheckMd5Response(AuthenticatorPort *port)
+{
+   const EapResponse *response;
+
+   //Malformed packet?
+   if(port->eapRespDataLen < (sizeof(EapResponse) + 1))
+      return TRUE;
+
+   //Point to the EAP response
+   response = (EapResponse *) port->eapRespData;
+
+   //The response value is the MD5 hash of the Identifier, the password and
+   //the challenge value
+   if(response->data[0] != MD5_DIGEST_SIZE)
+      return TRUE;
+
+   //Check the length of the response value
+   if(port->eapRespDataLen < (sizeof(EapResponse) + 1 + MD5_DIGEST_SIZE))
+      return TRUE;
+
+   //The response is well-formed
+   return FALSE;
+}
+
+
+/**
+ * @brief Verify an EAP-Response/MD5-Challenge packet
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorProcessMd5Response(AuthenticatorPort *port)
+{
+   uint8_t identifier;
+   uint8_t digest[MD5_DIGEST_SIZE];
+   const EapResponse *response;
+   AuthenticatorLocalUser *user;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the EAP response
+   response = (EapResponse *) port->eapRespData;
+
+   //The Identifier of the request is part of the hashed data
+   identifier = (uint8_t) port->currentId;
+
+   //The credential store is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Search the local credential store for the identity
+   user = authenticatorFindLocalUser(context, port->data->aaaIdentity);
+
+   //Known user?
+   if(user != NULL && port->data->aaaIdentity[0] != '\0')
+   {
+      //Compute the expected response value (refer to RFC 1994, section 4.1)
+      md5Init(&port->shard->md5Context);
+      md5Update(&port->shard->md5Context, &identifier, sizeof(uint8_t));
+      md5Update(&port->shard->md5Context, user->password,
+         osStrlen(user->password));
+      md5Update(&port->shard->md5Context, port->data->localChallenge,
+         MD5_DIGEST_SIZE);
+      md5Final(&port->shard->md5Context, digest);
+
+      //Compare the response value with the expected one
+      port->localAuthSuccess = (osMemcmp(response->data + 1, digest,
+         MD5_DIGEST_SIZE) == 0) ? TRUE : FALSE;
+   }
+   else
+   {
+      //The user has been removed from the credential store
+      port->localAuthSuccess = FALSE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file authenticator_local.h
+ * @brief Local authentication fallback
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_LOCAL_H
+#define _AUTHENTICATOR_LOCAL_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Local authentication fallback
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+
+//Authenticator related functions
+AuthenticatorLocalUser *authenticatorFindLocalUser(
+   AuthenticatorContext *context, const char_t *identity);
+
+void authenticatorSaveLocalIdentity(AuthenticatorPort *port);
+
+bool_t authenticatorCheckCriticalAuth(AuthenticatorPort *port);
+bool_t authenticatorStartCriticalAuth(AuthenticatorPort *port);
+bool_t authenticatorSelectLocalAuth(AuthenticatorPort *port);
+bool_t authenticatorCheckCriticalAuthDeadline(AuthenticatorPort *port);
+
+EapDecision authenticatorGetLocalDecision(AuthenticatorPort *port);
+
+void authenticatorBuildMd5Challenge(AuthenticatorPort *port);
+bool_t authenticatorCheckMd5Response(AuthenticatorPort *port);
+void authenticatorProcessMd5Response(AuthenticatorPort *port);
+
+#else
+
+//Stub functions
+#define authenticatorStartCriticalAuth(port) FALSE
+#define authenticatorCheckCriticalAuthDeadline(port) FALSE
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
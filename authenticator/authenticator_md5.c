@@ -0,0 +1,272 @@
+/**
+ * @file authenticator_md5.c
+ * @brief Two-lane MD5 computation
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_md5.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_MD5_2WAY_SUPPORT == ENABLED)
+
+//MD5 auxiliary functions
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
+#define H(x, y, z) ((x) ^ (y) ^ (z))
+#define I(x, y, z) ((y) ^ ((x) | ~(z)))
+
+//Perform one MD5 step on both lanes
+#define STEP2(f, g, i) \
+{ \
+   t1 = a1 + f(b1, c1, d1) + x1[g] + k[i]; \
+   t2 = a2 + f(b2, c2, d2) + x2[g] + k[i]; \
+   a1 = d1; \
+   a2 = d2; \
+   d1 = c1; \
+   d2 = c2; \
+   c1 = b1; \
+   c2 = b2; \
+   b1 += ROL32(t1, s[i]); \
+   b2 += ROL32(t2, s[i]); \
+}
+
+//Per-step shift amounts
+static const uint8_t s[64] =
+{
+   7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+   5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20, 5, 9,  14, 20,
+   4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+   6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+//Per-step additive constants
+static const uint32_t k[64] =
+{
+   0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE,
+   0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+   0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE,
+   0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+   0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA,
+   0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+   0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED,
+   0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+   0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C,
+   0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+   0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05,
+   0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+   0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039,
+   0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+   0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1,
+   0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391
+};
+
+
+/**
+ * @brief Feed the same data to two MD5 computations
+ *
+ * The two contexts are updated in lockstep and each completed block is
+ * processed by a single pass of the interleaved compression function. When
+ * the mask flag is set, the second context receives zeroes instead of the
+ * actual data
+ *
+ * @param[in] context1 Pointer to the first MD5 context
+ * @param[in] context2 Pointer to the second MD5 context
+ * @param[in] data Pointer to the buffer being hashed
+ * @param[in] length Length of the buffer
+ * @param[in] mask Replace the data with zeroes in the second context
+ **/
+
+void authenticatorMd5Update2(Md5Context *context1, Md5Context *context2,
+   const void *data, size_t length, bool_t mask)
+{
+   size_t n;
+   const uint8_t *p;
+
+   //Point to the data
+   p = (const uint8_t *) data;
+
+   //Both contexts must be aligned on the same block boundary
+   if(context1->size != context2->size)
+   {
+      //Fall back to separate computations
+      md5Update(context1, p, length);
+
+      //Check whether the data must be masked
+      if(mask)
+      {
+         //Process the data as zeroes
+         while(length > 0)
+         {
+            n = MIN(length, MD5_BLOCK_SIZE - context2->size);
+            osMemset(context2->buffer + context2->size, 0, n);
+
+            context2->size += n;
+            context2->totalSize += n;
+            length -= n;
+
+            //Process message in 16-word blocks
+            if(context2->size == MD5_BLOCK_SIZE)
+            {
+               md5ProcessBlock(context2);
+               context2->size = 0;
+            }
+         }
+      }
+      else
+      {
+         md5Update(context2, p, length);
+      }
+   }
+   else
+   {
+      //Process the incoming data
+      while(length > 0)
+      {
+         //The buffers can hold at most 64 bytes
+         n = MIN(length, MD5_BLOCK_SIZE - context1->size);
+
+         //Copy the data to the buffers
+         osMemcpy(context1->buffer + context1->size, p, n);
+
+         //Check whether the data must be masked
+         if(mask)
+         {
+            osMemset(context2->buffer + context2->size, 0, n);
+         }
+         else
+         {
+            osMemcpy(context2->buffer + context2->size, p, n);
+         }
+
+         //Update the MD5 contexts
+         context1->size += n;
+         context2->size += n;
+         context1->totalSize += n;
+         context2->totalSize += n;
+
+         //Advance the data pointer
+         p += n;
+         //Remaining bytes to process
+         length -= n;
+
+         //Process message in 16-word blocks
+         if(context1->size == MD5_BLOCK_SIZE)
+         {
+            //Transform the 16-word blocks
+            authenticatorMd5ProcessBlock2(context1, context2);
+
+            //Empty the buffers
+            context1->size = 0;
+            context2->size = 0;
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Process a 16-word block in two MD5 contexts
+ *
+ * The steps of both compressions are interleaved so that the two independent
+ * dependency chains can be executed in parallel by superscalar cores
+ *
+ * @param[in] context1 Pointer to the first MD5 context
+ * @param[in] context2 Pointer to the second MD5 context
+ **/
+
+void authenticatorMd5ProcessBlock2(Md5Context *context1,
+   Md5Context *context2)
+{
+   uint_t i;
+   uint32_t t1;
+   uint32_t t2;
+   uint32_t x1[16];
+   uint32_t x2[16];
+
+   //Initialize the 4 working registers of the first lane
+   uint32_t a1 = context1->h[0];
+   uint32_t b1 = context1->h[1];
+   uint32_t c1 = context1->h[2];
+   uint32_t d1 = context1->h[3];
+
+   //Initialize the 4 working registers of the second lane
+   uint32_t a2 = context2->h[0];
+   uint32_t b2 = context2->h[1];
+   uint32_t c2 = context2->h[2];
+   uint32_t d2 = context2->h[3];
+
+   //Convert from little-endian byte order to host byte order
+   for(i = 0; i < 16; i++)
+   {
+      x1[i] = LOAD32LE(context1->buffer + i * 4);
+      x2[i] = LOAD32LE(context2->buffer + i * 4);
+   }
+
+   //Round 1
+   for(i = 0; i < 16; i++)
+   {
+      STEP2(F, i, i);
+   }
+
+   //Round 2
+   for(i = 16; i < 32; i++)
+   {
+      STEP2(G, (5 * i + 1) & 15, i);
+   }
+
+   //Round 3
+   for(i = 32; i < 48; i++)
+   {
+      STEP2(H, (3 * i + 5) & 15, i);
+   }
+
+   //Round 4
+   for(i = 48; i < 64; i++)
+   {
+      STEP2(I, (7 * i) & 15, i);
+   }
+
+   //Update the hash values of the first lane
+   context1->h[0] += a1;
+   context1->h[1] += b1;
+   context1->h[2] += c1;
+   context1->h[3] += d1;
+
+   //Update the hash values of the second lane
+   context2->h[0] += a2;
+   context2->h[1] += b2;
+   context2->h[2] += c2;
+   context2->h[3] += d2;
+}
+
+#endif
@@ -35,6 +35,11 @@
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_mgmt.h"
 #include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_reauth_timer_fsm.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_shard.h"
+#include "authenticator/authenticator_host.h"
 #include "debug.h"
 
 //Check TCP/IP stack configuration
@@ -48,8 +53,8 @@
 
 void authenticatorMgmtLock(AuthenticatorContext *context)
 {
-   //Acquire exclusive access
-   osAcquireMutex(&context->mutex);
+   //Acquire exclusive access to all the ports
+   authenticatorLock(context);
 }
 
 
@@ -60,8 +65,8 @@ void authenticatorMgmtLock(AuthenticatorContext *context)
 
 void authenticatorMgmtUnlock(AuthenticatorContext *context)
 {
-   //Release exclusive access
-   osReleaseMutex(&context->mutex);
+   //Release exclusive access to all the ports
+   authenticatorUnlock(context);
 }
 
 
@@ -86,32 +91,34 @@ error_t authenticatorMgmtSetInitialize(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
       //Setting this variable to FALSE has no effect
       if(initialize)
       {
+         //This variable indicates how the session was terminated
+         port->data->sessionStats.sessionTerminateCause =
+            AUTHENTICATOR_TERMINATE_CAUSE_PORT_REINIT;
+
          //Initialize port
          authenticatorInitPortFsm(port);
-         //Update authenticator state machines
-         authenticatorFsm(context);
+         //Release the additional sessions of the port
+         authenticatorFlushHostSessions(port);
+         //Update the state machines of the port
+         authenticatorSchedulePort(port);
+         authenticatorRunFsm(port->shard);
 
          //The PACP state machines are held in their initial state until
          //initialize is deasserted (refer to IEEE Std 802.1X-2004, section
          //8.2.2.2)
          port->initialize = FALSE;
-
-         //This variable indicates how the session was terminated
-         port->sessionStats.sessionTerminateCause =
-            AUTHENTICATOR_TERMINATE_CAUSE_PORT_REINIT;
       }
    }
 
@@ -141,13 +148,12 @@ error_t authenticatorMgmtSetReauthenticate(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
@@ -156,8 +162,9 @@ error_t authenticatorMgmtSetReauthenticate(AuthenticatorContext *context,
       {
          //The reAuthenticate variable may be set TRUE by management action
          port->reAuthenticate = TRUE;
-         //Update authenticator state machines
-         authenticatorFsm(context);
+         //Update the state machines of the port
+         authenticatorSchedulePort(port);
+         authenticatorRunFsm(port->shard);
       }
    }
 
@@ -187,20 +194,22 @@ error_t authenticatorMgmtSetPortControl(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
       //Save the value of the parameter
       port->portControl = portControl;
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Release the additional sessions of the port
+      authenticatorFlushHostSessions(port);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
@@ -229,8 +238,10 @@ error_t authenticatorMgmtSetQuietPeriod(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
    //The quietPeriod parameter can be set by management to any value in the
@@ -238,9 +249,6 @@ error_t authenticatorMgmtSetQuietPeriod(AuthenticatorContext *context,
    if(quietPeriod > AUTHENTICATOR_MAX_QUIET_PERIOD)
       return ERROR_WRONG_VALUE;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
@@ -251,11 +259,13 @@ error_t authenticatorMgmtSetQuietPeriod(AuthenticatorContext *context,
       if(port->quietWhile > 0)
       {
          //Reinitialize quietWhile timer
-         port->quietWhile = port->quietPeriod;
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_QUIET_WHILE,
+            port->quietPeriod * 1000);
       }
 
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
@@ -284,8 +294,10 @@ error_t authenticatorMgmtSetServerTimeout(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
    //The serverTimeout parameter can be set by management to any value in the
@@ -297,9 +309,6 @@ error_t authenticatorMgmtSetServerTimeout(AuthenticatorContext *context,
       return ERROR_WRONG_VALUE;
    }
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
@@ -310,11 +319,13 @@ error_t authenticatorMgmtSetServerTimeout(AuthenticatorContext *context,
       if(port->aWhile > 0)
       {
          //Reinitialize aWhile timer
-         port->aWhile = port->serverTimeout;
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_A_WHILE,
+            port->serverTimeout * 1000);
       }
 
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
@@ -343,8 +354,10 @@ error_t authenticatorMgmtSetReAuthPeriod(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
    //If the value of the reAuthPeriod parameter is outside the specified range,
@@ -355,9 +368,6 @@ error_t authenticatorMgmtSetReAuthPeriod(AuthenticatorContext *context,
       return ERROR_WRONG_VALUE;
    }
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
@@ -368,11 +378,13 @@ error_t authenticatorMgmtSetReAuthPeriod(AuthenticatorContext *context,
       if(port->reAuthWhen > 0)
       {
          //Reinitialize reAuthWhen timer
-         port->reAuthWhen = port->reAuthPeriod;
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+            authenticatorGetReauthDelay(port));
       }
 
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
@@ -401,20 +413,20 @@ error_t authenticatorMgmtSetReAuthEnabled(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
       //Save the value of the parameter
       port->reAuthEnabled = reAuthEnabled;
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
@@ -443,20 +455,20 @@ error_t authenticatorMgmtSetKeyTxEnabled(AuthenticatorContext *context,
    if(context == NULL)
       return ERROR_WRITE_FAILED;
 
+   //Point to the port that matches the specified port index
+   port = authenticatorFindPort(context, portIndex);
    //Invalid port index?
-   if(portIndex < 1 || portIndex > context->numPorts)
+   if(port == NULL)
       return ERROR_INVALID_PORT;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
-
    //Commit phase?
    if(commit)
    {
       //Save the value of the parameter
       port->keyTxEnabled = keyTxEnabled;
-      //Update authenticator state machines
-      authenticatorFsm(context);
+      //Update the state machines of the port
+      authenticatorSchedulePort(port);
+      authenticatorRunFsm(port->shard);
    }
 
    //Successful processing
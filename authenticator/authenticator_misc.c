@@ -36,6 +36,22 @@
 #include "authenticator/authenticator_fsm.h"
 #include "authenticator/authenticator_procedures.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_cache.h"
+#include "authenticator/authenticator_shard.h"
+#include "authenticator/authenticator_latency.h"
+#include "authenticator/authenticator_host.h"
+#include "authenticator/authenticator_acct.h"
+#include "authenticator/authenticator_radsec.h"
+#include "authenticator/authenticator_dae.h"
+#include "authenticator/authenticator_trace.h"
+#include "authenticator/authenticator_md5.h"
+#include "authenticator/authenticator_crypto.h"
+#include "authenticator/authenticator_random.h"
+#include "authenticator/authenticator_capture.h"
+#include "authenticator/authenticator_profile.h"
 #include "radius/radius.h"
 #include "radius/radius_attributes.h"
 #include "radius/radius_debug.h"
@@ -51,119 +67,433 @@ static const MacAddr PAE_GROUP_ADDR = {{{0x01, 0x80, 0xC2, 0x00, 0x00, 0x03}}};
 
 /**
  * @brief Handle periodic operations
+ *
+ * The periodic operations that relate to the ports are performed by each
+ * shard (refer to authenticatorShardTick)
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
  **/
 
 void authenticatorTick(AuthenticatorContext *context)
+{
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+   //Probe the RADIUS servers that are considered dead
+   authenticatorTickRadiusServers(context);
+   //Generate random data ahead of the Access-Requests
+   authenticatorRefillRandomPool(context);
+   //Postponed reauthentications are started at a controlled rate
+   context->reauthDrainTokens = (context->reauthDrainRate *
+      AUTHENTICATOR_TICK_INTERVAL + 999) / 1000;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Queue the interim accounting updates and send the Accounting-Request
+   //packets that are pending
+   authenticatorTickAcct(context);
+
+   //Open the TLS connections to the RADIUS servers
+   authenticatorTickRadsec(context);
+
+   //Any registered callback?
+   if(context->tickCallback != NULL)
+   {
+      //Acquire exclusive access to all the ports
+      authenticatorLock(context);
+      //Invoke user callback function
+      context->tickCallback(context);
+      //Release exclusive access to all the ports
+      authenticatorUnlock(context);
+   }
+
+   //Report the ports that have changed since the previous tick
+   authenticatorNotifyPortChanges(context);
+}
+
+
+/**
+ * @brief Record a change of authPaeState or authPortStatus
+ *
+ * The change is stamped with a new generation of the context. The caller
+ * must hold the mutex of the shard the port belongs to
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorRecordPortChange(AuthenticatorPort *port)
+{
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //The MIB tables are indexed by physical port
+   port = authenticatorGetPhysicalPort(port);
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Advance the generation of the context
+   context->changeGeneration++;
+   //Stamp the port with the new generation
+   port->data->changeGeneration = context->changeGeneration;
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+
+/**
+ * @brief Report the ports that have changed through the port change callback
+ *
+ * The ports are reported in batches of AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE
+ * entries. The callback is invoked without holding any lock
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorNotifyPortChanges(AuthenticatorContext *context)
 {
    uint_t i;
-   bool_t macOpState;
+   uint_t n;
+   uint32_t generation;
+   uint32_t lastGeneration;
    AuthenticatorPort *port;
+   uint_t batch[AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE];
+
+   //No registered callback?
+   if(context->portChangeCallback == NULL)
+      return;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+   //Retrieve the generations that delimit the changes to be reported
+   lastGeneration = context->notifyGeneration;
+   generation = context->changeGeneration;
+   //The changes will be reported
+   context->notifyGeneration = generation;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //No change since the previous tick?
+   if(generation == lastGeneration)
+      return;
 
    //Loop through the ports
-   for(i = 0; i < context->numPorts; i++)
+   for(i = 0; i < context->numPorts; )
    {
-      //Point to the current port
-      port = &context->ports[i];
+      //Acquire exclusive access to the shared state
+      osAcquireMutex(&context->mutex);
+
+      //Collect a batch of ports that have changed
+      for(n = 0; i < context->numPorts &&
+         n < AUTHENTICATOR_PORT_CHANGE_BATCH_SIZE; i++)
+      {
+         //Point to the current port
+         port = &context->ports[i];
+
+         //The generations wrap around
+         if((int32_t) (port->data->changeGeneration - lastGeneration) > 0)
+         {
+            batch[n++] = port->portIndex;
+         }
+      }
 
-      //Poll link state
-      macOpState = authenticatorGetLinkState(port);
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
 
-      //Link state change detected?
-      if(macOpState && !port->portEnabled)
+      //Report the batch
+      if(n > 0)
       {
-         //Session statistics for a port can be retained by the system until a
-         //new session begins on that port
-         port->sessionStats.sessionOctetsRx = 0;
-         port->sessionStats.sessionOctetsTx = 0;
-         port->sessionStats.sessionFramesRx = 0;
-         port->sessionStats.sessionFramesTx = 0;
-         port->sessionStats.sessionTime = 0;
-
-         //The port is up
-         port->sessionStats.sessionTerminateCause =
-            AUTHENTICATOR_TERMINATE_CAUSE_NOT_TERMINATED_YET;
+         context->portChangeCallback(context, batch, n, generation);
       }
-      else if(!macOpState && port->portEnabled)
+   }
+}
+
+
+/**
+ * @brief Port's MAC address generation
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorGeneratePortAddr(AuthenticatorPort *port)
+{
+   int_t i;
+   uint_t c;
+   uint_t sum;
+   MacAddr *macAddr;
+
+   //Get the MAC address of the network interface the port is attached to
+   macAddr = &authenticatorGetPortInterface(port)->interface->macAddr;
+
+   //Retrieve the index of the port on the interface
+   c = authenticatorGetSwitchPort(port);
+
+   //Generate a unique MAC address for the port
+   for(i = 5; i >= 0; i--)
+   {
+      //Add the relevant byte of the port index
+      sum = macAddr->b[i] + (c & 0xFF);
+      //Generate current byte
+      port->macAddr.b[i] = (uint8_t) sum;
+
+      //Propagate the remaining bytes of the port index and the carry
+      c = (c >> 8) + (sum >> 8);
+   }
+}
+
+
+/**
+ * @brief Retrieve the port that matches a given port index
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index
+ * @return Pointer to the port context (NULL if no port matches)
+ **/
+
+AuthenticatorPort *authenticatorFindPort(AuthenticatorContext *context,
+   uint_t portIndex)
+{
+   uint_t i;
+   uint_t j;
+   uint_t k;
+
+   //Ports are numbered from 1 to numPorts?
+   if(!context->sparsePorts)
+   {
+      //Invalid port index?
+      if(portIndex < 1 || portIndex > context->numPorts)
+         return NULL;
+
+      //Direct lookup
+      return &context->ports[portIndex - 1];
+   }
+
+   //The port table is sorted by ascending port index
+   i = 0;
+   j = context->numPorts;
+
+   //Binary search
+   while(i < j)
+   {
+      //Point to the middle of the range
+      k = i + (j - i) / 2;
+
+      //Compare port indexes
+      if(context->ports[k].portIndex == portIndex)
       {
-         //The port is down
-         port->sessionStats.sessionTerminateCause =
-            AUTHENTICATOR_TERMINATE_CAUSE_PORT_FAILURE;
+         return &context->ports[k];
       }
-      else if(macOpState)
+      else if(context->ports[k].portIndex < portIndex)
       {
-         //Duration of the session in seconds
-         port->sessionStats.sessionTime++;
+         i = k + 1;
       }
       else
       {
-         //No link state change
+         j = k;
       }
+   }
+
+   //No matching port
+   return NULL;
+}
+
+
+/**
+ * @brief Get the index of the port that follows a given port index
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] portIndex Port index (0 to get the first port)
+ * @return Index of the next port (0 if no port follows)
+ **/
 
-      //The portEnabled variable is externally controlled. Its value reflects
-      //the operational state of the MAC service supporting the port
-      port->portEnabled = macOpState;
+uint_t authenticatorGetNextPortIndex(AuthenticatorContext *context,
+   uint_t portIndex)
+{
+   uint_t i;
+   uint_t j;
+   uint_t k;
+
+   //Ports are numbered from 1 to numPorts?
+   if(!context->sparsePorts)
+   {
+      //Last port?
+      if(portIndex >= context->numPorts)
+         return 0;
 
-      //Timers are decremented once per second
-      authenticatorDecrementTimer(&port->aWhile);
-      authenticatorDecrementTimer(&port->quietWhile);
-      authenticatorDecrementTimer(&port->reAuthWhen);
-      authenticatorDecrementTimer(&port->retransWhile);
-      authenticatorDecrementTimer(&port->aaaRetransTimer);
+      //Return the index of the next port
+      return portIndex + 1;
    }
 
-   //Update authenticator state machines
-   authenticatorFsm(context);
+   //The port table is sorted by ascending port index
+   i = 0;
+   j = context->numPorts;
 
-   //Any registered callback?
-   if(context->tickCallback != NULL)
+   //Search for the first port whose index is greater than the specified one
+   while(i < j)
    {
-      //Invoke user callback function
-      context->tickCallback(context);
+      //Point to the middle of the range
+      k = i + (j - i) / 2;
+
+      //Compare port indexes
+      if(context->ports[k].portIndex <= portIndex)
+      {
+         i = k + 1;
+      }
+      else
+      {
+         j = k;
+      }
    }
+
+   //No port follows?
+   if(i >= context->numPorts)
+      return 0;
+
+   //Return the index of the next port
+   return context->ports[i].portIndex;
 }
 
 
 /**
- * @brief Port's MAC address generation
- * @param[in] port Pointer to the port context
+ * @brief Poll the link state of the ports of a shard
+ * @param[in] shard Pointer to the shard
  **/
 
-void authenticatorGeneratePortAddr(AuthenticatorPort *port)
+void authenticatorPollLinkState(AuthenticatorShard *shard)
 {
-   int_t i;
-   uint8_t c;
-   MacAddr *macAddr;
+   uint_t i;
+   uint_t j;
+   uint_t n;
+   uint32_t linkStates;
    AuthenticatorContext *context;
 
    //Point to the 802.1X authenticator context
-   context = port->context;
+   context = shard->context;
+   //Index of the port following the last port of the shard
+   n = shard->firstPort + shard->numPorts;
 
-   //Get the MAC address of the underlying network interface
-   macAddr = &context->interface->macAddr;
+   //Any registered callback?
+   if(context->linkStateCallback != NULL)
+   {
+      //The link states are retrieved 32 ports at a time
+      for(i = shard->firstPort; i < n; i += 32)
+      {
+         //Get exclusive access
+         netLock(context->netContext);
 
-   //Retrieve port index
-   c = port->portIndex;
+         //Invoke user callback function
+         linkStates = context->linkStateCallback(context,
+            context->ports[i].portIndex);
 
-   //Generate a unique MAC address for the port
-   for(i = 5; i >= 0; i--)
-   {
-      //Generate current byte
-      port->macAddr.b[i] = macAddr->b[i] + c;
+         //Release exclusive access
+         netUnlock(context->netContext);
 
-      //Propagate the carry if necessary
-      if(port->macAddr.b[i] < macAddr->b[i])
-      {
-         c = 1;
+         //Bit j reflects the link state of the port i + j of the table
+         for(j = 0; j < 32 && (i + j) < n; j++)
+         {
+            authenticatorUpdateLinkState(&context->ports[i + j],
+               (linkStates & (1U << j)) ? TRUE : FALSE);
+         }
       }
-      else
+   }
+   else
+   {
+      //Loop through the ports of the shard
+      for(i = shard->firstPort; i < n; i++)
       {
-         c = 0;
+         //Poll link state
+         authenticatorUpdateLinkState(&context->ports[i],
+            authenticatorGetLinkState(&context->ports[i]));
       }
    }
 }
 
 
+/**
+ * @brief Process a change of the link state of a port
+ * @param[in] port Pointer to the port context
+ * @param[in] macOpState Operational state of the MAC service
+ **/
+
+void authenticatorUpdateLinkState(AuthenticatorPort *port, bool_t macOpState)
+{
+   //Link state change detected?
+   if(macOpState && !port->portEnabled)
+   {
+      //The state machines of the port must be evaluated
+      authenticatorSchedulePort(port);
+
+      //Session statistics for a port can be retained by the system until a
+      //new session begins on that port
+      port->data->sessionStats.sessionOctetsRx = 0;
+      port->data->sessionStats.sessionOctetsTx = 0;
+      port->data->sessionStats.sessionFramesRx = 0;
+      port->data->sessionStats.sessionFramesTx = 0;
+      port->data->sessionStats.sessionTime = 0;
+
+      //The port is up
+      port->data->sessionStats.sessionTerminateCause =
+         AUTHENTICATOR_TERMINATE_CAUSE_NOT_TERMINATED_YET;
+   }
+   else if(!macOpState && port->portEnabled)
+   {
+      //The state machines of the port must be evaluated
+      authenticatorSchedulePort(port);
+
+      //The port is down
+      port->data->sessionStats.sessionTerminateCause =
+         AUTHENTICATOR_TERMINATE_CAUSE_PORT_FAILURE;
+
+      //The supplicants attached to the port are no longer reachable
+      authenticatorFlushHostSessions(port);
+   }
+   else
+   {
+      //No link state change
+      return;
+   }
+
+   //The invariant RADIUS attributes are formatted again after a link state
+   //change
+   authenticatorInvalidateRadiusTemplate(port);
+
+   //The portEnabled variable is externally controlled. Its value reflects
+   //the operational state of the MAC service supporting the port
+   port->portEnabled = macOpState;
+}
+
+
+/**
+ * @brief Get the network interface a port is attached to
+ * @param[in] port Pointer to the port context or to the additional session
+ * @return Pointer to the network interface
+ **/
+
+AuthenticatorInterface *authenticatorGetPortInterface(AuthenticatorPort *port)
+{
+   //Additional sessions share the interface of the port they are bound to
+   port = authenticatorGetPhysicalPort(port);
+
+   //Return a pointer to the network interface
+   return &port->context->interfaces[port->data->interfaceIndex];
+}
+
+
+/**
+ * @brief Get the switch port a port is mapped to
+ * @param[in] port Pointer to the port context or to the additional session
+ * @return Index of the port on its network interface
+ **/
+
+uint_t authenticatorGetSwitchPort(AuthenticatorPort *port)
+{
+   //Additional sessions share the switch port of the port they are bound to
+   port = authenticatorGetPhysicalPort(port);
+
+   //The port indexes of an interface are offset from its switch ports
+   return port->portIndex -
+      port->context->interfaces[port->data->interfaceIndex].portOffset;
+}
+
+
 /**
  * @brief Get link state
  * @param[in] port Pointer to the port context
@@ -178,8 +508,8 @@ bool_t authenticatorGetLinkState(AuthenticatorPort *port)
 
    //Point to the 802.1X authenticator context
    context = port->context;
-   //Point to the underlying network interface
-   interface = context->interface;
+   //Point to the network interface the port is attached to
+   interface = authenticatorGetPortInterface(port)->interface;
 
    //Valid switch driver?
    if(interface->switchDriver != NULL &&
@@ -190,7 +520,7 @@ bool_t authenticatorGetLinkState(AuthenticatorPort *port)
 
       //Retrieve the link state of the specified port
       linkState = interface->switchDriver->getLinkState(interface,
-         port->portIndex);
+         authenticatorGetSwitchPort(port));
 
       //Release exclusive access
       netUnlock(context->netContext);
@@ -215,37 +545,43 @@ bool_t authenticatorGetLinkState(AuthenticatorPort *port)
 error_t authenticatorAcceptPaeGroupAddr(AuthenticatorContext *context)
 {
    error_t error;
+   uint_t i;
    SwitchFdbEntry entry;
    NetInterface *interface;
 
    //Initialize status code
    error = NO_ERROR;
 
-   //Point to the underlying network interface
-   interface = context->interface;
-
    //Get exclusive access
    netLock(context->netContext);
 
-   //Valid switch driver?
-   if(interface->switchDriver != NULL &&
-      interface->switchDriver->addStaticFdbEntry != NULL)
+   //Loop through the network interfaces
+   for(i = 0; i < context->numInterfaces && !error; i++)
    {
-      //Format forwarding database entry
-      entry.macAddr = PAE_GROUP_ADDR;
-      entry.srcPort = 0;
-      entry.destPorts = SWITCH_CPU_PORT_MASK;
-      entry.override = TRUE;
+      //Point to the current network interface
+      interface = context->interfaces[i].interface;
 
-      //Update the static MAC table of the switch
-      error = interface->switchDriver->addStaticFdbEntry(interface, &entry);
-   }
+      //Valid switch driver?
+      if(interface->switchDriver != NULL &&
+         interface->switchDriver->addStaticFdbEntry != NULL)
+      {
+         //Format forwarding database entry
+         entry.macAddr = PAE_GROUP_ADDR;
+         entry.srcPort = 0;
+         entry.destPorts = SWITCH_CPU_PORT_MASK;
+         entry.override = TRUE;
+
+         //Update the static MAC table of the switch
+         error = interface->switchDriver->addStaticFdbEntry(interface,
+            &entry);
+      }
 
-   //Check status code
-   if(!error)
-   {
-      //Add the PAE group address to the MAC filter table
-      error = ethAcceptMacAddr(interface, &PAE_GROUP_ADDR);
+      //Check status code
+      if(!error)
+      {
+         //Add the PAE group address to the MAC filter table
+         error = ethAcceptMacAddr(interface, &PAE_GROUP_ADDR);
+      }
    }
 
    //Release exclusive access
@@ -265,37 +601,43 @@ error_t authenticatorAcceptPaeGroupAddr(AuthenticatorContext *context)
 error_t authenticatorDropPaeGroupAddr(AuthenticatorContext *context)
 {
    error_t error;
+   uint_t i;
    SwitchFdbEntry entry;
    NetInterface *interface;
 
    //Initialize status code
    error = NO_ERROR;
 
-   //Point to the underlying network interface
-   interface = context->interface;
-
    //Get exclusive access
    netLock(context->netContext);
 
-   //Valid switch driver?
-   if(interface->switchDriver != NULL &&
-      interface->switchDriver->deleteStaticFdbEntry != NULL)
+   //Loop through the network interfaces
+   for(i = 0; i < context->numInterfaces && !error; i++)
    {
-      //Format forwarding database entry
-      entry.macAddr = PAE_GROUP_ADDR;
-      entry.srcPort = 0;
-      entry.destPorts = 0;
-      entry.override = FALSE;
+      //Point to the current network interface
+      interface = context->interfaces[i].interface;
 
-      //Update the static MAC table of the switch
-      error = interface->switchDriver->deleteStaticFdbEntry(interface, &entry);
-   }
+      //Valid switch driver?
+      if(interface->switchDriver != NULL &&
+         interface->switchDriver->deleteStaticFdbEntry != NULL)
+      {
+         //Format forwarding database entry
+         entry.macAddr = PAE_GROUP_ADDR;
+         entry.srcPort = 0;
+         entry.destPorts = 0;
+         entry.override = FALSE;
+
+         //Update the static MAC table of the switch
+         error = interface->switchDriver->deleteStaticFdbEntry(interface,
+            &entry);
+      }
 
-   //Check status code
-   if(!error)
-   {
-      //Remove the PAE group address to the MAC filter table
-      ethDropMacAddr(interface, &PAE_GROUP_ADDR);
+      //Check status code
+      if(!error)
+      {
+         //Remove the PAE group address to the MAC filter table
+         ethDropMacAddr(interface, &PAE_GROUP_ADDR);
+      }
    }
 
    //Release exclusive access
@@ -319,6 +661,10 @@ error_t authenticatorSendEapolPdu(AuthenticatorPort *port, const uint8_t *pdu,
 {
    SocketMsg msg;
 
+   //Record the transmitted PDU
+   authenticatorTraceEapolPdu(port, AUTHENTICATOR_TRACE_EVENT_EAPOL_TX, pdu,
+      length);
+
    //Point to the PDU to be transmitted
    msg = SOCKET_DEFAULT_MSG;
    msg.data = (uint8_t *) pdu;
@@ -329,6 +675,14 @@ error_t authenticatorSendEapolPdu(AuthenticatorPort *port, const uint8_t *pdu,
    //default for those clients (refer to IEEE Std 802.1X-2010, section 11.1.1)
    msg.destMacAddr = PAE_GROUP_ADDR;
 
+   //On multi-supplicant ports, frames are addressed to the individual
+   //supplicant so that each of them only sees its own conversation
+   if(port->host || (port->context->maxHostsPerPort > 1 &&
+      !macCompAddr(&port->supplicantMacAddr, &MAC_UNSPECIFIED_ADDR)))
+   {
+      msg.destMacAddr = port->supplicantMacAddr;
+   }
+
    //The source address for each MAC service request used to transmit an EAPOL
    //MPDU shall be an individual address associated with the service access
    //point at which the request is made (refer to IEEE Std 802.1X-2010,
@@ -341,86 +695,293 @@ error_t authenticatorSendEapolPdu(AuthenticatorPort *port, const uint8_t *pdu,
 
 #if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
    //Specify the egress port
-   msg.switchPort = port->portIndex;
+   msg.switchPort = authenticatorGetSwitchPort(port);
 #endif
 
    //Number of EAPOL frames of any type that have been transmitted
-   port->stats.eapolFramesTx++;
+   port->data->stats.eapolFramesTx++;
 
-   //Send EAPOL MPDU
-   return socketSendMsg(port->context->peerSocket, &msg, 0);
+   //Capture the transmitted PDU
+   authenticatorCaptureEapolPdu(port, &msg.srcMacAddr, &msg.destMacAddr,
+      FALSE, pdu, length);
+
+   //Send EAPOL MPDU on the interface the port is attached to
+   return socketSendMsg(authenticatorGetPortInterface(port)->socket, &msg, 0);
 }
 
 
 /**
- * @brief Process incoming EAPOL PDU
+ * @brief Receive the frames that are queued on the sockets
+ *
+ * The sockets reported as ready by socketPoll() are drained in a round-robin
+ * fashion, until they are empty or AUTHENTICATOR_RX_BATCH_SIZE frames have
+ * been received. Any remaining frame is processed on the next call
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in,out] eventDesc Events returned by socketPoll(). The first entry
+ *   relates to the raw socket, the following ones to the UDP sockets. The
+ *   raw sockets of the other network interfaces come last. The event flags
+ *   of a socket are cleared once it has been drained
  **/
 
-void authenticatorProcessEapolPdu(AuthenticatorContext *context)
+void authenticatorReceiveFrames(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc)
 {
    error_t error;
-   size_t length;
-   uint_t portIndex;
-   SocketMsg msg;
-   EapolPdu *pdu;
-   AuthenticatorPort *port;
-
-   //Point to the receive buffer
-   msg = SOCKET_DEFAULT_MSG;
-   msg.data = context->rxBuffer;
-   msg.size = AUTHENTICATOR_RX_BUFFER_SIZE;
+   uint_t i;
+   uint_t n;
+   bool_t ready;
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+   uint32_t cycles;
+#endif
 
-   //Receive EAPOL MPDU
-   error = socketReceiveMsg(context->peerSocket, &msg, 0);
-   //Failed to receive packet
-   if(error)
-      return;
+   //Process frames until the budget is exhausted
+   for(n = 0; n < AUTHENTICATOR_RX_BATCH_SIZE; )
+   {
+      //No frame received yet during this round
+      ready = FALSE;
 
-#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
-   //Save the port number on which the EAPOL PDU was received
-   portIndex = MAX(msg.switchPort, 1);
-#else
-   //The station has a single port
-   portIndex = 1;
+      //Loop through the sockets. The accounting socket is served once the
+      //other sockets have been drained
+      for(i = 0; i < AUTHENTICATOR_NUM_POLLED_SOCKETS &&
+         n < AUTHENTICATOR_RX_BATCH_SIZE; i++)
+      {
+         //Any frame pending on the current socket?
+         if(eventDesc[i].eventFlags != 0 &&
+            i != AUTHENTICATOR_ACCT_SOCKET_INDEX)
+         {
+            //Check socket type
+            if(i == 0)
+            {
+               //Process incoming EAPOL packet
+               AUTHENTICATOR_PROFILE_START(cycles);
+               error = authenticatorProcessEapolPdu(context, 0);
+               AUTHENTICATOR_PROFILE_STOP(&context->profile,
+                  AUTHENTICATOR_PROFILE_EAPOL_PDU, cycles);
+            }
+            else if(i >= AUTHENTICATOR_PEER_SOCKET_INDEX)
+            {
+               //Process incoming EAPOL packet received on another interface
+               AUTHENTICATOR_PROFILE_START(cycles);
+               error = authenticatorProcessEapolPdu(context,
+                  i - AUTHENTICATOR_PEER_SOCKET_INDEX + 1);
+               AUTHENTICATOR_PROFILE_STOP(&context->profile,
+                  AUTHENTICATOR_PROFILE_EAPOL_PDU, cycles);
+            }
+#if (AUTHENTICATOR_DAE_SUPPORT == ENABLED)
+            else if(i == AUTHENTICATOR_DAE_SOCKET_INDEX)
+            {
+               //Process incoming Disconnect-Request or CoA-Request packet
+               error = authenticatorProcessDaePacket(context);
+            }
 #endif
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+            else if(i >= AUTHENTICATOR_RADSEC_SOCKET_INDEX)
+            {
+               //Process the events of the TLS connection
+               error = authenticatorProcessRadsecEvent(context,
+                  i - AUTHENTICATOR_RADSEC_SOCKET_INDEX);
+            }
+#endif
+            else
+            {
+               //Process incoming RADIUS packet
+               AUTHENTICATOR_PROFILE_START(cycles);
+               error = authenticatorProcessRadiusPacket(context, i - 1);
+               AUTHENTICATOR_PROFILE_STOP(&context->profile,
+                  AUTHENTICATOR_PROFILE_RADIUS_PACKET, cycles);
+            }
 
-   //The destination MAC address field must contain the PAE group address
-   if(!macCompAddr(&msg.destMacAddr, &PAE_GROUP_ADDR))
-      return;
+            //Check status code
+            if(error)
+            {
+               //The socket has been drained
+               eventDesc[i].eventFlags = 0;
+            }
+            else
+            {
+               //One more frame has been received
+               ready = TRUE;
+               n++;
+            }
+         }
+      }
 
-   //The received MPDU must contain the PAE EtherType
-   if(msg.ethType != ETH_TYPE_EAPOL)
-      return;
+      //All the sockets have been drained?
+      if(!ready)
+         break;
+   }
 
-   //Malformed EAPOL packet?
-   if(msg.length < sizeof(EapolPdu))
-      return;
+#if (AUTHENTICATOR_ACCT_SUPPORT == ENABLED)
+   //Accounting-Response packets are only processed once the EAPOL and
+   //Access-Request paths have been drained
+   if(!ready && eventDesc[AUTHENTICATOR_ACCT_SOCKET_INDEX].eventFlags != 0)
+   {
+      //Limit the number of packets processed per round
+      for(n = 0; n < AUTHENTICATOR_ACCT_QUEUE_SIZE; n++)
+      {
+         //Process incoming Accounting-Response packet
+         error = authenticatorProcessAcctPacket(context);
+         //The socket has been drained?
+         if(error)
+            break;
+      }
+   }
+#endif
+}
 
-   //Point to the EAPOL packet
-   pdu = (EapolPdu *) context->rxBuffer;
 
-   //Debug message
-   TRACE_INFO("Port %" PRIu8 ": EAPOL packet received (%" PRIuSIZE " bytes)...\r\n",
-      portIndex, msg.length);
+/**
+ * @brief Process incoming EAPOL PDU
+ *
+ * The PDU is received in a buffer of the EAPOL receive ring and handed over
+ * to the shard of the port it was received on
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] interfaceIndex Network interface the PDU is received on
+ * @return Error code (an error is returned when no PDU is available)
+ **/
+
+error_t authenticatorProcessEapolPdu(AuthenticatorContext *context,
+   uint_t interfaceIndex)
+{
+   error_t error;
+   uint_t portIndex;
+   SocketMsg msg;
+   AuthenticatorPort *port;
+   AuthenticatorRxBuffer *buffer;
+   AuthenticatorInterface *interface;
+
+   //Point to the network interface
+   interface = &context->interfaces[interfaceIndex];
+
+   //Retrieve a free buffer of the EAPOL receive ring
+   buffer = authenticatorGetRxBuffer(context);
+
+   //All the buffers are still owned by the ports?
+   if(buffer == NULL)
+   {
+      //The PDU is dequeued and dropped, so that the socket does not remain
+      //readable
+      msg = SOCKET_DEFAULT_MSG;
+      msg.data = &portIndex;
+      msg.size = 0;
+
+      //Discard EAPOL MPDU
+      error = socketReceiveMsg(interface->socket, &msg, 0);
+
+      //Debug message
+      if(!error)
+      {
+         TRACE_WARNING("EAPOL receive ring is full!\r\n");
+      }
+
+      //Return status code
+      return error;
+   }
+
+   //Point to the receive buffer
+   msg = SOCKET_DEFAULT_MSG;
+   msg.data = buffer->data;
+   msg.size = AUTHENTICATOR_RX_BUFFER_SIZE;
+
+   //Receive EAPOL MPDU
+   error = socketReceiveMsg(interface->socket, &msg, 0);
+   //Failed to receive packet
+   if(error)
+      return error;
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   //Save the port number on which the EAPOL PDU was received
+   portIndex = interface->portOffset + MAX(msg.switchPort, 1);
+#else
+   //The interface has a single port
+   portIndex = interface->portOffset + 1;
+#endif
+
+   //The destination MAC address field must contain the PAE group address
+   if(!macCompAddr(&msg.destMacAddr, &PAE_GROUP_ADDR))
+      return NO_ERROR;
+
+   //The received MPDU must contain the PAE EtherType
+   if(msg.ethType != ETH_TYPE_EAPOL)
+      return NO_ERROR;
+
+   //Malformed EAPOL packet?
+   if(msg.length < sizeof(EapolPdu))
+      return NO_ERROR;
+
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": EAPOL packet received (%" PRIuSIZE " bytes)...\r\n",
+      portIndex, msg.length);
 
    //Dump EAPOL header contents for debugging purpose
-   eapolDumpHeader(pdu);
+   eapolDumpHeader((EapolPdu *) buffer->data);
 
+   //Point to the port the PDU is destined to
+   port = authenticatorFindPort(context, portIndex);
    //Sanity check
-   if(portIndex > context->numPorts)
-      return;
+   if(port == NULL)
+      return NO_ERROR;
+
+   //The port must be attached to the interface the PDU was received on
+   if(port->data->interfaceIndex != interfaceIndex)
+      return NO_ERROR;
+
+   //Capture the received PDU
+   authenticatorCaptureEapolPdu(port, &msg.srcMacAddr, &msg.destMacAddr,
+      TRUE, buffer->data, msg.length);
+
+   //The buffer is reserved until the PDU has been processed
+   authenticatorClaimRxBuffer(port, buffer);
+
+   //The PDU is processed by the shard the port belongs to
+   authenticatorDispatchEapolPdu(port, &msg.srcMacAddr, buffer, msg.length);
+
+   //The PDU has been consumed
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Process an EAPOL PDU received on a given port
+ *
+ * The receive buffer is kept by the port when the PDU carries an EAP
+ * response. Otherwise it is returned to the EAPOL receive ring
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] srcMacAddr Source MAC address
+ * @param[in] buffer Receive buffer holding the EAPOL PDU
+ * @param[in] length Length of the EAPOL PDU, in bytes
+ **/
+
+void authenticatorProcessPortEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, AuthenticatorRxBuffer *buffer, size_t length)
+{
+   const EapolPdu *pdu;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[portIndex - 1];
+   //Point to the EAPOL packet
+   pdu = (const EapolPdu *) buffer->data;
+
+   //Record the received PDU
+   authenticatorTraceEapolPdu(port, AUTHENTICATOR_TRACE_EVENT_EAPOL_RX,
+      buffer->data, length);
 
    //Malformed EAPOL packet?
-   if(msg.length < ntohs(pdu->packetBodyLen))
+   if(length < ntohs(pdu->packetBodyLen))
    {
       //Number of EAPOL frames that have been received by this authenticator
       //in which the Packet Body Length field is invalid
-      port->stats.eapLengthErrorFramesRx++;
+      port->data->stats.eapLengthErrorFramesRx++;
+      //Publish the updated statistics
+      authenticatorUpdatePortSnapshot(port);
 
+      //Return the receive buffer to the ring
+      authenticatorReleaseRxBuffer(port->context, buffer);
       //Exit immediately
       return;
    }
@@ -429,45 +990,190 @@ void authenticatorProcessEapolPdu(AuthenticatorContext *context)
    //EAPOL PDU shall be ignored (refer to IEEE Std 802.1X-2004, section 11.4)
    length = ntohs(pdu->packetBodyLen);
 
+   //Select the session that handles the supplicant
+   port = authenticatorSelectHostSession(port, srcMacAddr, pdu->packetType);
+
+   //No session available for the supplicant?
+   if(port == NULL)
+   {
+      //Return the receive buffer to the ring
+      authenticatorReleaseRxBuffer(context, buffer);
+      //Exit immediately
+      return;
+   }
+
    //Number of valid EAPOL frames of any type that have been received
-   port->stats.eapolFramesRx++;
+   port->data->stats.eapolFramesRx++;
    //Protocol version number carried in the most recently received EAPOL frame
-   port->stats.lastEapolFrameVersion = pdu->protocolVersion;
+   port->data->stats.lastEapolFrameVersion = pdu->protocolVersion;
+
+   //Floods of EAPOL-Start frames are dropped before they reach the state
+   //machines
+   if(pdu->packetType == EAPOL_TYPE_START &&
+      !authenticatorConsumeToken(&port->data->startBucket,
+      AUTHENTICATOR_EAPOL_START_RATE, AUTHENTICATOR_EAPOL_START_BURST))
+   {
+      //Number of EAPOL-Start frames that have been dropped by the rate
+      //limiter
+      port->data->stats.rateLimitedStartFramesRx++;
+      //Publish the updated statistics
+      authenticatorUpdatePortSnapshot(port);
+
+      //Return the receive buffer to the ring
+      authenticatorReleaseRxBuffer(context, buffer);
+      //Exit immediately
+      return;
+   }
+
+   //Floods of EAP frames are dropped before any RADIUS transaction is
+   //started on their behalf
+   if(pdu->packetType == EAPOL_TYPE_EAP &&
+      !authenticatorConsumeToken(&port->data->eapBucket,
+      AUTHENTICATOR_EAP_FRAME_RATE, AUTHENTICATOR_EAP_FRAME_BURST))
+   {
+      //Number of EAP frames that have been dropped by the rate limiter
+      port->data->stats.rateLimitedEapFramesRx++;
+      //Publish the updated statistics
+      authenticatorUpdatePortSnapshot(port);
+
+      //Return the receive buffer to the ring
+      authenticatorReleaseRxBuffer(context, buffer);
+      //Exit immediately
+      return;
+   }
+
+   //The Calling-Station-Id attribute depends on the supplicant's MAC address
+   if(!macCompAddr(&port->supplicantMacAddr, srcMacAddr))
+   {
+      authenticatorInvalidateRadiusTemplate(port);
+   }
 
    //Save the MAC address of the supplicant
-   port->supplicantMacAddr = msg.srcMacAddr;
+   port->supplicantMacAddr = *srcMacAddr;
+
+   //A supplicant that comes back after a link flap may have been authorized
+   //recently. Its first frame re-admits it immediately
+   if(port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+      port->authPaeState == AUTHENTICATOR_PAE_STATE_CONNECTING &&
+      port->authPortStatus == AUTHENTICATOR_PORT_STATUS_UNAUTH &&
+      pdu->packetType != EAPOL_TYPE_LOGOFF)
+   {
+      //Search the authorization cache for the supplicant
+      if(authenticatorCheckAuthCache(port))
+      {
+         authenticatorReadmitPort(port);
+      }
+   }
 
    //Check packet type
    if(pdu->packetType == EAPOL_TYPE_EAP)
    {
       //Process incoming EAP packet
-      authenticatorProcessEapPacket(port, (EapPacket *) pdu->packetBody,
+      authenticatorProcessEapPacket(port, (const EapPacket *) pdu->packetBody,
          length);
    }
    else if(pdu->packetType == EAPOL_TYPE_START)
    {
       //Number of EAPOL Start frames that have been received
-      port->stats.eapolStartFramesRx++;
+      port->data->stats.eapolStartFramesRx++;
+      //Measure the time until the supplicant is asked for its identity
+      authenticatorStartLatency(port, AUTHENTICATOR_LATENCY_START_TO_REQ_ID);
 
       //The eapolStart variable is set TRUE if an EAPOL PDU carrying a packet
       //type of EAPOL-Start is received
       port->eapolStart = TRUE;
+      //The event will be processed by the state machines of the port
+      authenticatorSchedulePort(port);
    }
    else if(pdu->packetType == EAPOL_TYPE_LOGOFF)
    {
       //Number of EAPOL Logoff frames that have been received
-      port->stats.eapolLogoffFramesRx++;
+      port->data->stats.eapolLogoffFramesRx++;
+      //A supplicant that logs off must authenticate again
+      authenticatorRemoveAuthCacheEntry(port);
 
       //The Logoff variable is set TRUE if an EAPOL PDU carrying a packet type
       //of EAPOL-Logoff is received
       port->eapolLogoff = TRUE;
+      //The event will be processed by the state machines of the port
+      authenticatorSchedulePort(port);
    }
    else
    {
       //Number of EAPOL frames that have been received by this authenticator
       //in which the frame type is not recognized
-      port->stats.invalidEapolFramesRx++;
+      port->data->stats.invalidEapolFramesRx++;
+   }
+
+   //Publish the updated statistics
+   authenticatorUpdatePortSnapshot(port);
+
+   //Check whether the PDU carries an EAP response that is pending
+   if(port->eapolEap && port->eapRespData == pdu->packetBody)
+   {
+      //The port owns the receive buffer until the response is consumed
+      authenticatorAttachRxBuffer(port, buffer);
+   }
+   else
+   {
+      //Return the receive buffer to the ring
+      authenticatorReleaseRxBuffer(port->context, buffer);
+   }
+}
+
+
+/**
+ * @brief Take a token from a token bucket
+ *
+ * The bucket holds up to burst tokens and is refilled at the specified rate
+ *
+ * @param[in] bucket Pointer to the token bucket
+ * @param[in] rate Refill rate, in tokens per second (0 disables the limit)
+ * @param[in] burst Capacity of the bucket, in tokens
+ * @return TRUE if a token has been taken, FALSE if the bucket is empty
+ **/
+
+bool_t authenticatorConsumeToken(AuthenticatorTokenBucket *bucket, uint_t rate,
+   uint_t burst)
+{
+   systime_t time;
+   systime_t elapsed;
+   uint32_t capacity;
+
+   //Rate limiting disabled?
+   if(rate == 0)
+      return TRUE;
+
+   //Tokens are counted in thousandths
+   capacity = burst * 1000;
+
+   //Get current time
+   time = osGetSystemTime();
+   //Time elapsed since the last refill, in milliseconds
+   elapsed = time - bucket->timestamp;
+   //Save the time of the refill
+   bucket->timestamp = time;
+
+   //Refill the bucket (one millisecond brings one thousandth of token per
+   //unit of rate)
+   if(elapsed >= (capacity / rate))
+   {
+      bucket->tokens = capacity;
    }
+   else
+   {
+      bucket->tokens = MIN(bucket->tokens + elapsed * rate, capacity);
+   }
+
+   //Empty bucket?
+   if(bucket->tokens < 1000)
+      return FALSE;
+
+   //Take a token
+   bucket->tokens -= 1000;
+
+   //Successful processing
+   return TRUE;
 }
 
 
@@ -486,7 +1192,7 @@ void authenticatorProcessEapPacket(AuthenticatorPort *port,
       return;
 
    //Debug message
-   TRACE_DEBUG("Port %" PRIu8 ": EAP packet received (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_DEBUG("Port %" PRIu16 ": EAP packet received (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, length);
 
    //Dump EAP header contents for debugging purpose
@@ -505,16 +1211,50 @@ void authenticatorProcessEapPacket(AuthenticatorPort *port,
    //to the EAP peer and authenticator layers
    if(packet->code == EAP_CODE_RESPONSE)
    {
+      //While a request is outstanding, a response whose Identifier does not
+      //match it is dropped before it wakes up the state machines (refer to
+      //RFC 3748, section 4.1)
+      if((port->eapFullAuthState == EAP_FULL_AUTH_STATE_IDLE ||
+         port->eapFullAuthState == EAP_FULL_AUTH_STATE_IDLE2 ||
+         port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE) &&
+         port->currentId != EAP_CURRENT_ID_NONE &&
+         packet->identifier != port->currentId)
+      {
+         //Debug message
+         TRACE_DEBUG("Port %" PRIu16 ": Unexpected EAP response discarded\r\n",
+            port->portIndex);
+
+         //Number of EAP responses that do not match the outstanding request
+         port->data->stats.eapIdMismatchFramesRx++;
+         return;
+      }
+
+      //A retransmission of the response the server is working on must not
+      //start a new RADIUS transaction
+      if(authenticatorIsDuplicateResp(port, packet, length))
+      {
+         //Debug message
+         TRACE_DEBUG("Port %" PRIu16 ": Duplicate EAP response discarded\r\n",
+            port->portIndex);
+
+         //Number of duplicate EAP responses that have been absorbed
+         port->data->stats.dupEapRespFramesRx++;
+         return;
+      }
+
       //Point to the EAP response
       port->eapRespData = (uint8_t *) packet;
       port->eapRespDataLen = length;
 
+      //Measure the time until the response is forwarded to the server
+      authenticatorStartLatency(port, AUTHENTICATOR_LATENCY_RESP_TO_ACCESS_REQ);
+
       //The eapolEap variable is set TRUE by an external entity if an EAPOL
       //PDU carrying a Packet Type of EAP-Packet is received
       port->eapolEap = TRUE;
 
       //Invoke EAP to perform whatever processing is needed
-      authenticatorFsm(port->context);
+      authenticatorSchedulePort(port);
    }
    else
    {
@@ -525,6 +1265,77 @@ void authenticatorProcessEapPacket(AuthenticatorPort *port,
 }
 
 
+/**
+ * @brief Check whether an EAP response duplicates the outstanding one
+ *
+ * While the server has not answered, the Access-Request in the session buffer
+ * carries the last EAP response forwarded by the port. A response with the
+ * same identifier and contents is a retransmission from the supplicant
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] packet Pointer to the received EAP response
+ * @param[in] length Length of the response, in bytes
+ * @return TRUE if the response has already been forwarded, else FALSE
+ **/
+
+bool_t authenticatorIsDuplicateResp(AuthenticatorPort *port,
+   const EapPacket *packet, size_t length)
+{
+   size_t i;
+   size_t n;
+   const RadiusAttribute *attribute;
+
+   //The EAP layer must be waiting for the server
+   if(port->eapFullAuthState != EAP_FULL_AUTH_STATE_AAA_IDLE)
+      return FALSE;
+
+   //The response must relate to the outstanding request
+   if(packet->identifier != port->currentId)
+      return FALSE;
+
+   //Make sure the Access-Request is still available
+   if(port->aaaReqData == NULL || port->aaaReqDataLen < sizeof(RadiusPacket))
+      return FALSE;
+
+   //Number of bytes of the response that have been matched
+   n = 0;
+
+   //Loop through the attributes of the Access-Request
+   for(i = sizeof(RadiusPacket); (i + sizeof(RadiusAttribute)) <=
+      port->aaaReqDataLen; i += attribute->length)
+   {
+      //Point to the current attribute
+      attribute = (const RadiusAttribute *) (port->aaaReqData + i);
+
+      //Malformed attribute?
+      if(attribute->length < sizeof(RadiusAttribute) ||
+         (i + attribute->length) > port->aaaReqDataLen)
+      {
+         return FALSE;
+      }
+
+      //The EAP response may be split across several EAP-Message attributes
+      //(refer to RFC 3579, section 3.1)
+      if(attribute->type == RADIUS_ATTR_EAP_MESSAGE)
+      {
+         //Compare the attribute value with the relevant part of the response
+         if((n + attribute->length - sizeof(RadiusAttribute)) > length ||
+            osMemcmp(attribute->value, (const uint8_t *) packet + n,
+            attribute->length - sizeof(RadiusAttribute)) != 0)
+         {
+            return FALSE;
+         }
+
+         //Advance to the next part of the response
+         n += attribute->length - sizeof(RadiusAttribute);
+      }
+   }
+
+   //The whole response must have been matched
+   return (n == length) ? TRUE : FALSE;
+}
+
+
 /**
  * @brief Build RADIUS Access-Request packet
  * @param[in] port Pointer to the port context
@@ -533,13 +1344,7 @@ void authenticatorProcessEapPacket(AuthenticatorPort *port,
 error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
 {
    error_t error;
-   size_t i;
-   size_t n;
-   IpAddr ipAddr;
-   MacAddr macAddr;
-   RadiusPacket *packet;
    AuthenticatorContext *context;
-   uint8_t buffer[32];
 
    //Point to the 802.1X authenticator context
    context = port->context;
@@ -547,16 +1352,73 @@ error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
    //Total length of the RADIUS packet
    port->aaaReqDataLen = 0;
 
-   //The Request Authenticator value must be changed each time a new
-   //Identifier is used (refer to RFC 2865, section 4.1)
-   error = context->prngAlgo->generate(context->prngContext,
-      port->reqAuthenticator, 16);
+   //No session buffer attached to the port?
+   if(port->aaaReqData == NULL)
+      return ERROR_WRONG_STATE;
+
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   //Random data generation offloaded to the crypto provider?
+   if(context->cryptoProvider != NULL)
+   {
+      //The Request Authenticator value must be changed each time a new
+      //Identifier is used (refer to RFC 2865, section 4.1)
+      error = authenticatorGenerateCryptoRandom(port);
+   }
+   else
+#endif
+   {
+      //The PRNG is shared by all the shards
+      osAcquireMutex(&context->mutex);
+
+      //The Request Authenticator value must be changed each time a new
+      //Identifier is used (refer to RFC 2865, section 4.1)
+      error = authenticatorGetRandomData(context,
+         port->data->reqAuthenticator, 16);
+
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
+   }
+
    //Any error to report?
    if(error)
       return error;
 
+   //Format the Access-Request packet
+   return authenticatorFormatRadiusRequest(port);
+}
+
+
+/**
+ * @brief Format RADIUS Access-Request packet
+ *
+ * The Request Authenticator has been generated and the packet is formatted
+ * in the session buffer attached to the port
+ *
+ * @param[in] port Pointer to the port context
+ * @return Error code
+ **/
+
+error_t authenticatorFormatRadiusRequest(AuthenticatorPort *port)
+{
+   error_t error;
+   size_t i;
+   size_t n;
+   RadiusPacket *packet;
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+   uint8_t buffer[32];
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //No session buffer attached to the port?
+   if(port->aaaReqData == NULL)
+      return ERROR_WRONG_STATE;
+
    //Generate a new RADIUS packet identifier
-   port->aaaReqId = authenticatorGetNextRadiusId(context);
+   authenticatorAllocRadiusId(port);
 
    //Point to the buffer where to format the RADIUS packet
    packet = (RadiusPacket *) port->aaaReqData;
@@ -572,42 +1434,185 @@ error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
 
    //The Authenticator field is 16 octets. This value is used to authenticate
    //the reply from the RADIUS server (refer to RFC 2865, section 3)
-   osMemcpy(packet->authenticator, port->reqAuthenticator, 16);
+   osMemcpy(packet->authenticator, port->data->reqAuthenticator, 16);
+
+   //The attributes that describe the NAS and the port do not change during
+   //the session. Check whether they have already been serialized
+   if(port->data->radiusTemplateLen > 0)
+   {
+      //Copy the prebuilt block of invariant attributes
+      osMemcpy(packet->attributes, port->data->radiusTemplate,
+         port->data->radiusTemplateLen);
+
+      //Adjust the length of the RADIUS packet
+      n += port->data->radiusTemplateLen;
+      //Fix the length field
+      packet->length = htons(n);
+   }
+   else
+   {
+      //Format the invariant attributes
+      error = authenticatorAddRadiusNasAttributes(port, packet);
+      //Any error to report?
+      if(error)
+         return error;
+
+      //Calculate the length of the invariant attributes
+      n = htons(packet->length) - sizeof(RadiusPacket);
+
+      //Save them for subsequent Access-Request packets
+      if(n <= AUTHENTICATOR_RADIUS_TEMPLATE_SIZE)
+      {
+         osMemcpy(port->data->radiusTemplate, packet->attributes, n);
+         port->data->radiusTemplateLen = n;
+      }
+   }
 
    //The NAS must include the Type-Data field of the EAP-Response/Identity
    //in the User-Name attribute in every subsequent Access-Request (refer to
    //RFC 3579, section 2.1)
-   radiusAddAttribute(packet, RADIUS_ATTR_USER_NAME, port->aaaIdentity,
-      osStrlen(port->aaaIdentity));
-
-   //The Service-Type attribute indicates the type of service the user has
-   //requested, or the type of service to be provided (refer to RFC 2865,
-   //section 5.6)
-   STORE32BE(RADIUS_SERVICE_TYPE_FRAMED, buffer);
-
-   //Add Service-Type attribute
-   radiusAddAttribute(packet, RADIUS_ATTR_SERVICE_TYPE, buffer,
-      sizeof(uint32_t));
+   radiusAddAttribute(packet, RADIUS_ATTR_USER_NAME, port->data->aaaIdentity,
+      osStrlen(port->data->aaaIdentity));
 
-   //The Framed-MTU attribute indicates the Maximum Transmission Unit to be
-   //configured for the user (refer to RFC 2865, section 5.12)
-   STORE32BE(EAP_MAX_FRAG_SIZE, buffer);
+   //Any State attribute received from previous Access-Challenge?
+   if(port->data->serverStateLen > 0)
+   {
+      //The NAS must include the State attribute unchanged in that
+      //Access-Request (refer to RFC 2865, section 5.24)
+      radiusAddAttribute(packet, RADIUS_ATTR_STATE, port->data->serverState,
+         port->data->serverStateLen);
+   }
 
-   //Add Framed-MTU attribute
-   radiusAddAttribute(packet, RADIUS_ATTR_FRAMED_MTU, buffer,
-      sizeof(uint32_t));
+   //The NAS places EAP messages received from the authenticating peer into
+   //one or more EAP-Message attributes and forwards them to the RADIUS server
+   //within an Access-Request message (refer to RFC 3579, section 3.1)
+   for(i = 0; i < port->eapRespDataLen; i += n)
+   {
+      //Each attribute can contain up to 253 octets of binary data
+      n = MIN(port->eapRespDataLen - i, RADIUS_MAX_ATTR_VALUE_LEN);
 
-   //Get exclusive access
-   netLock(context->netContext);
+      //Make sure the buffer is large enough to hold the EAP-Message attribute
+      if((htons(packet->length) + sizeof(RadiusAttribute) + n) >
+         context->txBufferSize)
+      {
+         return ERROR_BUFFER_OVERFLOW;
+      }
 
-   //Retrieve the IP address of the NAS
-   error = ipSelectSourceAddr(context->netContext, &context->serverInterface,
-      &context->serverIpAddr, &ipAddr);
+      //If multiple EAP-Message attributes are contained within an Access-
+      //Request, they must be in order and they must be consecutive attributes
+      radiusAddAttribute(packet, RADIUS_ATTR_EAP_MESSAGE,
+         port->eapRespData + i, n);
+   }
 
-   //Release exclusive access
-   netUnlock(context->netContext);
+   //When the checksum is calculated the signature string should be considered
+   //to be sixteen octets of zero (refer to RFC 2869, section 5.14)
+   osMemset(buffer, 0, MD5_DIGEST_SIZE);
 
-   //Any error to report?
+   //Make sure the buffer is large enough to hold the Message-Authenticator
+   //attribute
+   if((htons(packet->length) + sizeof(RadiusAttribute) + MD5_DIGEST_SIZE) >
+      context->txBufferSize)
+   {
+      return ERROR_BUFFER_OVERFLOW;
+   }
+
+   //Add Message-Authenticator attribute
+   radiusAddAttribute(packet, RADIUS_ATTR_MESSAGE_AUTHENTICATOR, buffer,
+      MD5_DIGEST_SIZE);
+
+   //Retrieve the total length of the RADIUS packet
+   n = htons(packet->length);
+
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   //Hashing offloaded to the crypto provider?
+   if(context->cryptoProvider != NULL)
+   {
+      //The packet is sent once the Message-Authenticator is available
+      error = authenticatorComputeCryptoHmac(port, n);
+      //Any error to report?
+      if(error)
+         return error;
+   }
+   else
+#endif
+   {
+      //Transactions between the client and RADIUS server are authenticated
+      //through the use of a shared secret (refer to RFC 2865, section 1)
+      authenticatorHmacInit(&port->shard->md5Context, server);
+
+      //When present in an Access-Request packet, Message-Authenticator is an
+      //HMAC-MD5 hash of the entire Access-Request packet, including Type, ID,
+      //Length and Authenticator, using the shared secret as the key (refer to
+      //RFC 3579, section 3.2)
+      md5Update(&port->shard->md5Context, port->aaaReqData, n);
+      authenticatorHmacFinal(&port->shard->md5Context, server, buffer);
+
+      //Copy the resulting HMAC-MD5 hash
+      osMemcpy(port->aaaReqData + n - MD5_DIGEST_SIZE, buffer,
+         MD5_DIGEST_SIZE);
+   }
+
+   //Save the total length of the RADIUS packet
+   port->aaaReqDataLen = n;
+   //Initialize retransmission counter
+   port->aaaRetransCount = 0;
+
+   //Sucessful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Format the attributes describing the NAS and the port
+ *
+ * These attributes remain the same for all the Access-Request packets sent on
+ * behalf of a given supplicant
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] packet Pointer to the RADIUS packet
+ * @return Error code
+ **/
+
+error_t authenticatorAddRadiusNasAttributes(AuthenticatorPort *port,
+   RadiusPacket *packet)
+{
+   error_t error;
+   IpAddr ipAddr;
+   MacAddr macAddr;
+   AuthenticatorContext *context;
+   uint8_t buffer[32];
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The Service-Type attribute indicates the type of service the user has
+   //requested, or the type of service to be provided (refer to RFC 2865,
+   //section 5.6)
+   STORE32BE(RADIUS_SERVICE_TYPE_FRAMED, buffer);
+
+   //Add Service-Type attribute
+   radiusAddAttribute(packet, RADIUS_ATTR_SERVICE_TYPE, buffer,
+      sizeof(uint32_t));
+
+   //The Framed-MTU attribute indicates the Maximum Transmission Unit to be
+   //configured for the user (refer to RFC 2865, section 5.12)
+   STORE32BE(context->framedMtu, buffer);
+
+   //Add Framed-MTU attribute
+   radiusAddAttribute(packet, RADIUS_ATTR_FRAMED_MTU, buffer,
+      sizeof(uint32_t));
+
+   //Get exclusive access
+   netLock(context->netContext);
+
+   //Retrieve the IP address of the NAS
+   error = ipSelectSourceAddr(context->netContext, &context->serverInterface,
+      &context->servers[port->aaaServerIndex].ipAddr, &ipAddr);
+
+   //Release exclusive access
+   netUnlock(context->netContext);
+
+   //Any error to report?
    if(error)
       return error;
 
@@ -630,7 +1635,7 @@ error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
 
    //The NAS-Port attribute indicates the physical port number of the NAS which
    //is authenticating the user (refer to RFC 2865, section 5.5)
-   STORE32BE(port->portIndex, buffer);
+   STORE32BE(authenticatorGetPhysicalPort(port)->portIndex, buffer);
 
    //Add NAS-Port attribute
    radiusAddAttribute(packet, RADIUS_ATTR_NAS_PORT, buffer, sizeof(uint32_t));
@@ -647,8 +1652,9 @@ error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
    //The NAS-Port-Id attribute contains a text string which identifies the
    //port of the NAS which is authenticating the user (refer to RFC 2869,
    //section 5.17)
-   osSprintf((char_t *) buffer, "%s_%" PRIu8, context->interface->name,
-      port->portIndex);
+   osSprintf((char_t *) buffer, "%s_%u",
+      authenticatorGetPortInterface(port)->interface->name,
+      port->portIndex - authenticatorGetPortInterface(port)->portOffset);
 
    radiusAddAttribute(packet, RADIUS_ATTR_NAS_PORT_ID, buffer,
       osStrlen((char_t *) buffer));
@@ -670,80 +1676,20 @@ error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port)
    radiusAddAttribute(packet, RADIUS_ATTR_CALLING_STATION_ID, buffer,
       osStrlen((char_t *) buffer));
 
-   //Any State attribute received from previous Access-Challenge?
-   if(port->serverStateLen > 0)
-   {
-      //The NAS must include the State attribute unchanged in that
-      //Access-Request (refer to RFC 2865, section 5.24)
-      radiusAddAttribute(packet, RADIUS_ATTR_STATE, port->serverState,
-         port->serverStateLen);
-   }
-
-   //The NAS places EAP messages received from the authenticating peer into
-   //one or more EAP-Message attributes and forwards them to the RADIUS server
-   //within an Access-Request message (refer to RFC 3579, section 3.1)
-   for(i = 0; i < port->eapRespDataLen; i += n)
-   {
-      //Each attribute can contain up to 253 octets of binary data
-      n = MIN(port->eapRespDataLen - i, RADIUS_MAX_ATTR_VALUE_LEN);
-
-      //Make sure the buffer is large enough to hold the EAP-Message attribute
-      if((htons(packet->length) + sizeof(RadiusAttribute) + n) >
-         AUTHENTICATOR_TX_BUFFER_SIZE)
-      {
-         return ERROR_BUFFER_OVERFLOW;
-      }
-
-      //If multiple EAP-Message attributes are contained within an Access-
-      //Request, they must be in order and they must be consecutive attributes
-      radiusAddAttribute(packet, RADIUS_ATTR_EAP_MESSAGE,
-         port->eapRespData + i, n);
-   }
-
-   //When the checksum is calculated the signature string should be considered
-   //to be sixteen octets of zero (refer to RFC 2869, section 5.14)
-   osMemset(buffer, 0, MD5_DIGEST_SIZE);
-
-   //Make sure the buffer is large enough to hold the Message-Authenticator
-   //attribute
-   if((htons(packet->length) + sizeof(RadiusAttribute) + MD5_DIGEST_SIZE) >
-      AUTHENTICATOR_TX_BUFFER_SIZE)
-   {
-      return ERROR_BUFFER_OVERFLOW;
-   }
-
-   //Add Message-Authenticator attribute
-   radiusAddAttribute(packet, RADIUS_ATTR_MESSAGE_AUTHENTICATOR, buffer,
-      MD5_DIGEST_SIZE);
-
-   //Retrieve the total length of the RADIUS packet
-   n = htons(packet->length);
-
-   //Transactions between the client and RADIUS server are authenticated through
-   //the use of a shared secret (refer to RFC 2865, section 1)
-   error = hmacInit(&context->hmacContext, MD5_HASH_ALGO, context->serverKey,
-      context->serverKeyLen);
-   //Any error to report?
-   if(error)
-      return error;
-
-   //When present in an Access-Request packet, Message-Authenticator is an
-   //HMAC-MD5 hash of the entire Access-Request packet, including Type, ID,
-   //Length and Authenticator, using the shared secret as the key (refer to
-   //RFC 3579, section 3.2)
-   hmacUpdate(&context->hmacContext, port->aaaReqData, n);
-   hmacFinal(&context->hmacContext, buffer);
+   //Sucessful processing
+   return NO_ERROR;
+}
 
-   //Copy the resulting HMAC-MD5 hash
-   osMemcpy(port->aaaReqData + n - MD5_DIGEST_SIZE, buffer, MD5_DIGEST_SIZE);
 
-   //Save the total length of the RADIUS packet
-   port->aaaReqDataLen = n;
-   //Initialize retransmission counter
-   port->aaaRetransCount = 0;
+/**
+ * @brief Invalidate the block of invariant RADIUS attributes
+ * @param[in] port Pointer to the port context
+ **/
 
-   //Sucessful processing
-   return NO_ERROR;
+void authenticatorInvalidateRadiusTemplate(AuthenticatorPort *port)
+{
+   //The attributes will be formatted again on the next Access-Request
+   port->data->radiusTemplateLen = 0;
 }
 
 
@@ -757,44 +1703,95 @@ error_t authenticatorSendRadiusRequest(AuthenticatorPort *port)
    error_t error;
    SocketMsg msg;
    AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
 
    //Initialize status code
    error = NO_ERROR;
 
    //Point to the 802.1X authenticator context
    context = port->context;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
 
    //Valid RADIUS packet?
    if(port->aaaReqDataLen > 0)
    {
-      //Exactly one RADIUS packet is encapsulated in the UDP data field,
-      //where the UDP destination Port field indicates 1812 (refer to
-      //RFC 2865, section 3)
-      msg = SOCKET_DEFAULT_MSG;
-      msg.data = port->aaaReqData;
-      msg.length = port->aaaReqDataLen;
-      msg.destIpAddr = context->serverIpAddr;
-      msg.destPort = context->serverPort;
+      //Dump RADIUS header contents for debugging purpose
+      radiusDumpPacket((RadiusPacket *) port->aaaReqData, port->aaaReqDataLen);
+
+      //Record the transmitted packet
+      authenticatorTraceRadiusPacket(port, AUTHENTICATOR_TRACE_EVENT_RADIUS_TX,
+         port->aaaReqData, port->aaaReqDataLen);
+
+      //Capture the transmitted packet
+      authenticatorCaptureRadiusPacket(context, &server->ipAddr, server->port,
+         FALSE, port->aaaReqData, port->aaaReqDataLen);
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+      //RADIUS over TLS?
+      if(server->transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+      {
+         //A new request has not been written to any connection yet
+         if(port->aaaRetransCount == 0)
+         {
+            port->aaaReqConnId = 0;
+         }
+
+         //The request is only written again if the connection has been
+         //reopened in the meantime. The retransmission timer then acts as
+         //a deadline for the response
+         error = authenticatorSendRadsecPacket(context, port->aaaServerIndex,
+            port->aaaReqData, port->aaaReqDataLen, &port->aaaReqConnId);
+      }
+      else
+#endif
+      {
+         //Exactly one RADIUS packet is encapsulated in the UDP data field,
+         //where the UDP destination Port field indicates 1812 (refer to
+         //RFC 2865, section 3)
+         msg = SOCKET_DEFAULT_MSG;
+         msg.data = port->aaaReqData;
+         msg.length = port->aaaReqDataLen;
+         msg.destIpAddr = server->ipAddr;
+         msg.destPort = server->port;
 
 #if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
-      //Specify the egress port
-      msg.switchPort = context->serverPortIndex;
+         //Specify the egress port
+         msg.switchPort = context->serverPortIndex;
 #endif
 
-      //Debug message
-      TRACE_INFO("Sending RADIUS packet (%" PRIuSIZE " bytes)...\r\n",
-         port->aaaReqDataLen);
+         //Debug message
+         TRACE_INFO("Sending RADIUS packet (%" PRIuSIZE " bytes)...\r\n",
+            port->aaaReqDataLen);
 
-      //Dump RADIUS header contents for debugging purpose
-      radiusDumpPacket((RadiusPacket *) port->aaaReqData, port->aaaReqDataLen);
+         //Send UDP datagram
+         error = socketSendMsg(context->serverSocket[port->aaaReqSocketIndex],
+            &msg, 0);
+      }
+
+      //First transmission of the request?
+      if(port->aaaRetransCount == 0)
+      {
+         //Save the time at which the request is sent
+         port->aaaReqTimestamp = osGetSystemTime();
+         //The EAP response has been forwarded to the server
+         authenticatorStopLatency(port, AUTHENTICATOR_LATENCY_RESP_TO_ACCESS_REQ);
+      }
+      else
+      {
+         //The previous transmission has not been answered in time
+         authenticatorRadiusWindowLoss(port);
+      }
 
-      //Send UDP datagram
-      error = socketSendMsg(context->serverSocket, &msg, 0);
+      //Calculate the retransmission timeout
+      authenticatorUpdateRadiusRto(port);
 
       //Increment retransmission counter
       port->aaaRetransCount++;
+
       //Set retransmission timeout
-      port->aaaRetransTimer = AUTHENTICATOR_RADIUS_TIMEOUT;
+      authenticatorStartTimer(port, AUTHENTICATOR_TIMER_AAA_RETRANS_TIMER,
+         port->aaaRto);
    }
 
    //Return status code
@@ -804,34 +1801,32 @@ error_t authenticatorSendRadiusRequest(AuthenticatorPort *port)
 
 /**
  * @brief Process incoming RADIUS packet
+ *
+ * The packet is received by the reception task and handed over to the shard
+ * of the port that issued the request
+ *
  * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] socketIndex Index of the UDP socket on which the packet is
+ *   received
+ * @return Error code (an error is returned when no packet is available)
  **/
 
-void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
+error_t authenticatorProcessRadiusPacket(AuthenticatorContext *context,
+   uint_t socketIndex)
 {
    error_t error;
-   uint_t i;
-   size_t n;
-   size_t length;
    SocketMsg msg;
-   AuthenticatorPort *port;
-   EapPacket *eapPacket;
-   const RadiusPacket *packet;
-   const RadiusAttribute *attribute;
-   Md5Context *md5Context;
-   HmacContext *hmacContext;
-   uint8_t digest[MD5_DIGEST_SIZE];
 
-   //Point to the receive buffer
+   //Point to the receive buffer of the RADIUS path
    msg = SOCKET_DEFAULT_MSG;
-   msg.data = context->rxBuffer;
+   msg.data = context->radiusRxBuffer;
    msg.size = AUTHENTICATOR_RX_BUFFER_SIZE;
 
-   //Receive EAPOL MPDU
-   error = socketReceiveMsg(context->serverSocket, &msg, 0);
+   //Receive RADIUS packet
+   error = socketReceiveMsg(context->serverSocket[socketIndex], &msg, 0);
    //Failed to receive packet
    if(error)
-      return;
+      return error;
 
    //Debug message
    TRACE_INFO("RADIUS packet received (%" PRIuSIZE " bytes)...\r\n",
@@ -840,37 +1835,60 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
 #if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
    //Check the port number on which the EAPOL PDU was received
    if(msg.switchPort != context->serverPortIndex && context->serverPortIndex != 0)
-      return;
+      return NO_ERROR;
 #endif
 
-   //Ensure the source IP address matches the RADIUS server's IP address
-   if(!ipCompAddr(&msg.srcIpAddr, &context->serverIpAddr))
-      return;
+   //Capture the received packet
+   authenticatorCaptureRadiusPacket(context, &msg.srcIpAddr, msg.srcPort,
+      TRUE, context->radiusRxBuffer, msg.length);
 
-   //The officially assigned port number for RADIUS is 1812 (refer to RFC 2865,
-   //section 3)
-   if(msg.srcPort != context->serverPort)
-      return;
+   //Process the RADIUS packet
+   authenticatorAcceptRadiusPacket(context, socketIndex, &msg.srcIpAddr,
+      msg.srcPort, msg.length);
+
+   //The packet has been consumed
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Process a RADIUS packet held in the receive buffer of the RADIUS
+ *   path
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] socketIndex Index of the Identifier space the packet belongs to
+ * @param[in] srcIpAddr IP address of the sender
+ * @param[in] srcPort Port number of the sender
+ * @param[in] length Number of bytes received
+ **/
+
+void authenticatorAcceptRadiusPacket(AuthenticatorContext *context,
+   uint_t socketIndex, const IpAddr *srcIpAddr, uint16_t srcPort,
+   size_t length)
+{
+   uint_t i;
+   AuthenticatorPort *port;
+   AuthenticatorRadiusServer *server;
+   const RadiusPacket *packet;
 
    //Malformed RADIUS packet?
-   if(msg.length < sizeof(RadiusPacket))
+   if(length < sizeof(RadiusPacket))
       return;
 
    //Point to the RADIUS packet
-   packet = (RadiusPacket *) context->rxBuffer;
+   packet = (RadiusPacket *) context->radiusRxBuffer;
 
    //If the packet is shorter than the Length field indicates, it must be
    //silently discarded (refer to RFC 2865, section 3)
-   if(msg.length < ntohs(packet->length))
+   if(length < ntohs(packet->length))
+      return;
+
+   //The Length field must cover the header of the packet
+   if(ntohs(packet->length) < sizeof(RadiusPacket))
       return;
 
    //Dump RADIUS header contents for debugging purpose
    radiusDumpPacket(packet, ntohs(packet->length));
 
-   //Octets outside the range of the Length field must be treated as padding
-   //and ignored on reception
-   length = ntohs(packet->length) - sizeof(RadiusPacket);
-
    //The RADIUS packet type is determined by the Code field
    if(packet->code != RADIUS_CODE_ACCESS_ACCEPT &&
       packet->code != RADIUS_CODE_ACCESS_REJECT &&
@@ -880,118 +1898,162 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
    }
 
    //The Identifier field aids in matching requests and replies
-   for(i = 0; i < context->numPorts; i++)
-   {
-      //Point to the current port
-      port = &context->ports[i];
+   i = socketIndex * 256 + packet->identifier;
 
-      //The Identifier field is matched with a pending Access-Request
-      if(port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE &&
-         !port->aaaEapResp)
-      {
-         //Matching identifier?
-         if(port->aaaReqId == packet->identifier)
-         {
-            break;
-         }
-      }
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Ensure the source IP address and port number match one of the
+   //configured RADIUS servers
+   server = authenticatorFindRadiusServer(context, srcIpAddr, srcPort);
+
+   //Unknown server?
+   if(server == NULL)
+   {
+      //The packet is silently discarded
+      port = NULL;
+   }
+   else if(server->probePending && server->probeIndex == i)
+   {
+      //Check whether the server is alive
+      authenticatorProcessStatusServerResponse(context, server, packet);
+      //The packet has been consumed
+      port = NULL;
+   }
+   else
+   {
+      //Retrieve the port that issued the request
+      port = context->radiusReqTable[i];
    }
 
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
    //No matching request found?
-   if(i >= context->numPorts)
+   if(port == NULL)
       return;
 
-   //Point to the MD5 context
-   md5Context = &context->hmacContext.hashContext.md5Context;
-   //Initialize MD5 calculation
-   md5Init(md5Context);
+   //The packet is processed by the shard the port belongs to
+   authenticatorDispatchRadiusPacket(port, server, i, context->radiusRxBuffer,
+      ntohs(packet->length));
+}
 
-   //The Response Authenticator contains a one-way MD5 hash calculated over the
-   //RADIUS packet, beginning with the Code field, including the Identifier, the
-   //Length, the Request Authenticator field from the Access-Request packet, and
-   //the response Attributes, followed by the shared secret (refer to RFC 2865,
-   //section 3)
-   md5Update(md5Context, packet, 4);
-   md5Update(md5Context, port->reqAuthenticator, 16);
-   md5Update(md5Context, packet->attributes, length);
-   md5Update(md5Context, context->serverKey, context->serverKeyLen);
-   md5Final(md5Context, digest);
 
-   //Debug message
-   TRACE_DEBUG("Calculated Response Authenticator:\r\n");
-   TRACE_DEBUG_ARRAY("  ", digest, MD5_DIGEST_SIZE);
+/**
+ * @brief Process a RADIUS response on behalf of the port that issued the
+ *   request
+ * @param[in] port Pointer to the port context
+ * @param[in] server RADIUS server the packet comes from
+ * @param[in] reqIndex (socket, Identifier) pair of the packet
+ * @param[in] packet Pointer to the received RADIUS packet
+ **/
 
-   //The Response Authenticator field must contain the correct response for the
-   //pending Access-Request. Invalid packets are silently discarded
-   if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) != 0)
+void authenticatorProcessRadiusResponse(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, uint_t reqIndex,
+   const RadiusPacket *packet)
+{
+   error_t error;
+   uint_t i;
+   size_t n;
+   size_t length;
+   bool_t pending;
+   systime_t rtt;
+   AuthenticatorContext *context;
+   EapPacket *eapPacket;
+   const RadiusAttribute *attribute;
+   RadiusAttrIndex *index;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+   //The request may have been evicted while the packet was queued
+   pending = (context->radiusReqTable[reqIndex] == port) ? TRUE : FALSE;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //No matching request found?
+   if(!pending)
+      return;
+
+   //The session buffer may have been returned to the pool while the packet
+   //was in flight
+   if(port->buffer == NULL)
+      return;
+
+   //Record the received packet
+   authenticatorTraceRadiusPacket(port, AUTHENTICATOR_TRACE_EVENT_RADIUS_RX,
+      (const uint8_t *) packet, ntohs(packet->length));
+
+   //The Identifier field is matched with a pending Access-Request
+   if(port->eapFullAuthState != EAP_FULL_AUTH_STATE_AAA_IDLE ||
+      port->aaaEapResp)
    {
-      //Debug message
-      TRACE_WARNING("Invalid Response Authenticator value!\r\n");
-      //Exit immediately
       return;
    }
 
-   //The Message-Authenticator attribute must be used to protect all
-   //Access-Request, Access-Challenge, Access-Accept, and Access-Reject
-   //packets containing an EAP-Message attribute (refer to RFC 3579,
-   //section 3.2)
-   attribute = radiusGetAttribute(packet, RADIUS_ATTR_MESSAGE_AUTHENTICATOR, 0);
-
-   //Access-Challenge, Access-Accept, or Access-Reject packets including
-   //EAP-Message attribute(s) without a Message-Authenticator attribute should
-   //be silently discarded by the NAS (refer to RFC 3579, section 3.1)
-   if(attribute == NULL)
-      return;
-
-   //Malformed Message-Authenticator attribute?
-   if(attribute->length != (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+   //The response must come from the server the request was sent to
+   if(&context->servers[port->aaaServerIndex] != server)
       return;
 
-   //Save the offset to the Message-Authenticator value
-   n = attribute->value - packet->attributes;
+   //Point to the attribute index
+   index = &port->shard->radiusAttrIndex;
 
-   //When the checksum is calculated the signature string should be considered
-   //to be sixteen octets of zero (refer to RFC 2869, section 5.14)
-   osMemset(digest, 0, MD5_DIGEST_SIZE);
+   //Validate the attributes and locate them in a single pass
+   error = radiusParseAttributes(packet, index);
+   //Malformed attributes?
+   if(error)
+      return;
 
-   //Point to the HMAC context
-   hmacContext = &context->hmacContext;
+   //Cheap structural checks are performed before any hashing
+   error = authenticatorFilterRadiusResponse(port, packet, index);
+   //Inconsistent packet?
+   if(error)
+   {
+      //Number of RADIUS responses that have been discarded before their
+      //authenticators were verified
+      port->data->stats.invalidRadiusPacketsRx++;
+      //Publish the updated statistics
+      authenticatorUpdatePortSnapshot(port);
+      //Exit immediately
+      return;
+   }
 
-   //Initialize HMAC-MD5 calculation
-   error = hmacInit(hmacContext, MD5_HASH_ALGO, context->serverKey,
-      context->serverKeyLen);
-   //Any error to report?
+   //Verify the Response Authenticator and the Message-Authenticator
+   error = authenticatorCheckRadiusResponse(context,
+      &port->shard->md5Context, server, packet, index,
+      port->data->reqAuthenticator);
+   //Invalid packet?
    if(error)
       return;
 
-   //For Access-Challenge, Access-Accept, and Access-Reject packets, the
-   //Message-Authenticator is calculated as follows, using the Request-
-   //Authenticator from the Access-Request this packet is in reply to (refer
-   //to RFC 3579, section 3.2)
-   hmacUpdate(hmacContext, packet, 4);
-   hmacUpdate(hmacContext, port->reqAuthenticator, 16);
-   hmacUpdate(hmacContext, packet->attributes, n);
-   hmacUpdate(hmacContext, digest, 16);
-   hmacUpdate(hmacContext, packet->attributes + n + 16, length - n - 16);
-   hmacFinal(hmacContext, digest);
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
 
-   //Debug message
-   TRACE_DEBUG("Calculated Message Authenticator:\r\n");
-   TRACE_DEBUG_ARRAY("  ", digest, MD5_DIGEST_SIZE);
+   //The server has answered
+   server->failures = 0;
 
-   //A NAS supporting the EAP-Message attribute must calculate the correct
-   //value of the Message-Authenticator and must silently discard the packet
-   //if it does not match the value sent (refer to RFC 3579, section 3.1)
-   if(osMemcmp(digest, attribute->value, MD5_DIGEST_SIZE) != 0)
+   //Round-trip times are only measured for requests that have not been
+   //retransmitted (Karn's algorithm)
+   if(port->aaaRetransCount == 1)
    {
-      //Debug message
-      TRACE_WARNING("Invalid Message Authenticator value!\r\n");
-      //Exit immediately
-      return;
+      //Measure the round-trip time
+      rtt = osGetSystemTime() - port->aaaReqTimestamp;
+
+      //Adjust the window before the estimator absorbs the measurement
+      authenticatorUpdateRadiusWindow(context, server, rtt);
+      //Update the retransmission timeout estimator
+      authenticatorUpdateRadiusRtt(server, rtt);
+      //Update latency statistics
+      authenticatorRecordRadiusRtt(port, server, rtt);
    }
 
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
    //Search the RADIUS packet for the State attribute
-   attribute = radiusGetAttribute(packet, RADIUS_ATTR_STATE, 0);
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_STATE, NULL);
 
    //State attribute found?
    if(attribute != NULL)
@@ -1005,58 +2067,59 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
          //The actual format of the information is site or application
          //specific, and a robust implementation should support the field
          //as undistinguished octets (refer to RFC 2865, section 5.24)
-         osMemcpy(port->serverState, attribute->value, n);
-         port->serverStateLen = n;
+         osMemcpy(port->data->serverState, attribute->value, n);
+         port->data->serverStateLen = n;
       }
    }
 
-   //EAP-Message attribute(s) encapsulate a single EAP packet which the NAS
-   //decapsulates and passes on to the authenticating peer
-   port->aaaEapReqDataLen = 0;
-
-   //Decapsulate the EAP packet
-   for(i = 0; ; i++)
+   //The Session-Timeout attribute sets the maximum number of seconds of
+   //service to be provided to the user (refer to RFC 2865, section 5.27)
+   if(packet->code == RADIUS_CODE_ACCESS_ACCEPT)
    {
-      //Point to the next EAP-Message attribute
-      attribute = radiusGetAttribute(packet, RADIUS_ATTR_EAP_MESSAGE, i);
+      //Search the RADIUS packet for the Session-Timeout attribute
+      attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_SESSION_TIMEOUT,
+         NULL);
 
-      //EAP-Message attribute found?
-      if(attribute != NULL)
+      //Session-Timeout attribute found?
+      if(attribute != NULL &&
+         attribute->length == (sizeof(RadiusAttribute) + sizeof(uint32_t)))
       {
-         //Retrieve the length of the fragment
-         n = attribute->length - sizeof(RadiusAttribute);
-
-         //Make sure the buffer is large enough to hold the reconstructed EAP
-         //packet
-         if((port->aaaEapReqDataLen + n) <= AUTHENTICATOR_TX_BUFFER_SIZE)
-         {
-            //Copy the current fragment
-            osMemcpy(context->txBuffer + port->aaaEapReqDataLen,
-               attribute->value, n);
-
-            //Adjust the length of the reconstructed EAP packet
-            port->aaaEapReqDataLen += n;
-         }
-         else
-         {
-            //The reassembly process failed
-            port->aaaEapReqDataLen = 0;
-            break;
-         }
+         port->sessionTimeout = LOAD32BE(attribute->value);
       }
       else
       {
-         //The reassembly process is now complete
-         break;
+         port->sessionTimeout = 0;
       }
    }
 
+   //EAP-Message attribute(s) encapsulate a single EAP packet which the NAS
+   //decapsulates and passes on to the authenticating peer
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_EAP_MESSAGE, &i);
+
    //Malformed EAP packet?
-   if(port->aaaEapReqDataLen < sizeof(EapPacket))
+   if(attribute == NULL || attribute->length <= sizeof(RadiusAttribute))
       return;
 
-   //Point to the EAP packet
-   eapPacket = (EapPacket *) context->txBuffer;
+   //The first fragment starts with the Code field of the EAP packet
+   eapPacket = (EapPacket *) attribute->value;
+
+   //Calculate the length of the reconstructed EAP packet
+   for(length = 0; attribute != NULL; )
+   {
+      //Add the length of the current fragment
+      length += attribute->length - sizeof(RadiusAttribute);
+      //Point to the next EAP-Message attribute
+      attribute = radiusGetNextAttribute(index, &i);
+   }
+
+   //Malformed EAP packet?
+   if(length < sizeof(EapPacket))
+      return;
+
+   //Make sure the buffer is large enough to hold the reconstructed EAP
+   //packet, leaving room for the EAPOL header
+   if(length > (port->context->txBufferSize - sizeof(EapolPdu)))
+      return;
 
    //Check Code field
    if(eapPacket->code == EAP_CODE_REQUEST ||
@@ -1064,11 +2127,36 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
       eapPacket->code == EAP_CODE_FAILURE)
    {
       //The corresponding request (or success/failure) packet is stored in
-      //aaaEapReqData
-      osMemcpy(port->aaaEapReqData, context->txBuffer, port->aaaEapReqDataLen);
+      //aaaEapReqData, which points past the EAPOL header in the transmit
+      //buffer of the port. The fragments are reassembled in place so that
+      //txReq() only has to prepend the EAPOL header
+      port->aaaEapReqDataLen = 0;
+
+      //Point to the first EAP-Message attribute
+      attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_EAP_MESSAGE, &i);
+
+      //Decapsulate the EAP packet
+      while(attribute != NULL)
+      {
+         //Retrieve the length of the fragment
+         n = attribute->length - sizeof(RadiusAttribute);
+
+         //Copy the current fragment
+         osMemcpy(port->aaaEapReqData + port->aaaEapReqDataLen,
+            attribute->value, n);
+
+         //Adjust the length of the reconstructed EAP packet
+         port->aaaEapReqDataLen += n;
+
+         //Point to the next EAP-Message attribute
+         attribute = radiusGetNextAttribute(index, &i);
+      }
+
+      //Point to the EAP packet
+      eapPacket = (EapPacket *) port->aaaEapReqData;
 
       //Debug message
-      TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
          port->portIndex, port->aaaEapReqDataLen);
 
       //Dump EAP header contents for debugging purpose
@@ -1083,10 +2171,19 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
       else if(eapPacket->code == EAP_CODE_SUCCESS)
       {
          port->aaaSuccess = TRUE;
+
+         //Remember the supplicant that has been authorized
+         if(packet->code == RADIUS_CODE_ACCESS_ACCEPT)
+         {
+            authenticatorUpdateAuthCache(port, port->sessionTimeout);
+         }
       }
       else
       {
          port->aaaFail = TRUE;
+
+         //The supplicant is no longer authorized
+         authenticatorRemoveAuthCacheEntry(port);
       }
 
    }
@@ -1097,51 +2194,678 @@ void authenticatorProcessRadiusPacket(AuthenticatorContext *context)
       port->aaaEapNoReq = TRUE;
    }
 
-   //Invoke EAP to perform whatever processing is needed
-   authenticatorFsm(port->context);
+   //Invoke EAP to perform whatever processing is needed. The state machines
+   //of the port are updated once the whole batch of frames has been received
+   authenticatorSchedulePort(port);
+}
+
+
+/**
+ * @brief Check the structure of a RADIUS response before it is hashed
+ *
+ * A forged response that cannot be valid is discarded without spending
+ * any MD5 computation on it
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] packet Pointer to the received RADIUS packet
+ * @param[in] index Attributes of the received RADIUS packet
+ * @return Error code
+ **/
+
+error_t authenticatorFilterRadiusResponse(AuthenticatorPort *port,
+   const RadiusPacket *packet, const RadiusAttrIndex *index)
+{
+   const EapPacket *eapPacket;
+   const RadiusAttribute *attribute;
+
+   //Search the RADIUS packet for the Message-Authenticator attribute
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_MESSAGE_AUTHENTICATOR,
+      NULL);
+
+   //The Message-Authenticator attribute is mandatory (refer to RFC 3579,
+   //section 3.1)
+   if(attribute == NULL)
+      return ERROR_INVALID_MESSAGE;
+
+   //Malformed Message-Authenticator attribute?
+   if(attribute->length != (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+      return ERROR_INVALID_MESSAGE;
+
+#if (AUTHENTICATOR_RADIUS_MSG_AUTH_FIRST == ENABLED)
+   //The Message-Authenticator attribute must be the first attribute of the
+   //packet (mitigation against Blast-RADIUS attacks)
+   if((const uint8_t *) attribute != packet->attributes)
+      return ERROR_INVALID_MESSAGE;
+#endif
+
+   //Search the RADIUS packet for the first EAP-Message attribute
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_EAP_MESSAGE, NULL);
+
+   //No EAP-Message attribute?
+   if(attribute == NULL)
+   {
+      //An Access-Challenge is useless without an EAP request to forward
+      if(packet->code == RADIUS_CODE_ACCESS_CHALLENGE)
+         return ERROR_INVALID_MESSAGE;
+
+      //Nothing more to check
+      return NO_ERROR;
+   }
+
+   //The first fragment must hold the header of the EAP packet
+   if(attribute->length < (sizeof(RadiusAttribute) + sizeof(EapPacket)))
+      return ERROR_INVALID_MESSAGE;
+
+   //Point to the EAP packet
+   eapPacket = (const EapPacket *) attribute->value;
+
+   //The Code field of the EAP packet must be consistent with the RADIUS
+   //packet type
+   if(packet->code == RADIUS_CODE_ACCESS_CHALLENGE)
+   {
+      //An Access-Challenge carries an EAP-Request
+      if(eapPacket->code != EAP_CODE_REQUEST)
+         return ERROR_INVALID_MESSAGE;
+
+      //The Identifier must change for each new request (refer to RFC 3748,
+      //section 4.1)
+      if(eapPacket->identifier == port->currentId)
+         return ERROR_INVALID_MESSAGE;
+   }
+   else
+   {
+      //An Access-Accept carries an EAP-Success, and an Access-Reject an
+      //EAP-Failure
+      if(packet->code == RADIUS_CODE_ACCESS_ACCEPT &&
+         eapPacket->code != EAP_CODE_SUCCESS)
+      {
+         return ERROR_INVALID_MESSAGE;
+      }
+      else if(packet->code == RADIUS_CODE_ACCESS_REJECT &&
+         eapPacket->code != EAP_CODE_FAILURE)
+      {
+         return ERROR_INVALID_MESSAGE;
+      }
+      else
+      {
+         //Just for sanity
+      }
+
+      //The Identifier of a Success or Failure packet must match the
+      //Identifier of the response (refer to RFC 3748, section 4.2)
+      if(eapPacket->identifier != port->currentId)
+         return ERROR_INVALID_MESSAGE;
+   }
+
+   //Successful processing
+   return NO_ERROR;
 }
 
 
 /**
- * @brief Generate a new RADIUS packet identifier
+ * @brief Verify the authenticators of a RADIUS response
  * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] md5Context MD5 context used for the calculations
+ * @param[in] server RADIUS server the request was sent to
+ * @param[in] packet Pointer to the received RADIUS packet
+ * @param[in] index Attributes of the received RADIUS packet
+ * @param[in] reqAuthenticator Request Authenticator of the pending request
+ * @return Error code
  **/
 
-uint8_t authenticatorGetNextRadiusId(AuthenticatorContext *context)
+error_t authenticatorCheckRadiusResponse(AuthenticatorContext *context,
+   Md5Context *md5Context, const AuthenticatorRadiusServer *server,
+   const RadiusPacket *packet, const RadiusAttrIndex *index,
+   const uint8_t *reqAuthenticator)
+{
+   size_t n;
+   size_t length;
+   const RadiusAttribute *attribute;
+   uint8_t digest[MD5_DIGEST_SIZE];
+#if (AUTHENTICATOR_MD5_2WAY_SUPPORT == ENABLED)
+   Md5Context hmacContext;
+   uint8_t hmacDigest[MD5_DIGEST_SIZE];
+#endif
+
+   //Octets outside the range of the Length field must be treated as padding
+   //and ignored on reception
+   length = ntohs(packet->length) - sizeof(RadiusPacket);
+
+#if (AUTHENTICATOR_CRYPTO_PROVIDER_SUPPORT == ENABLED)
+   //Hashing offloaded to the crypto provider?
+   if(context->cryptoProvider != NULL)
+   {
+      return authenticatorCheckCryptoResponse(context, server, packet, index,
+         reqAuthenticator);
+   }
+#endif
+
+#if (AUTHENTICATOR_MD5_2WAY_SUPPORT == ENABLED)
+   //The Message-Authenticator attribute must be used to protect all
+   //Access-Request, Access-Challenge, Access-Accept, and Access-Reject
+   //packets containing an EAP-Message attribute (refer to RFC 3579,
+   //section 3.2)
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_MESSAGE_AUTHENTICATOR,
+      NULL);
+
+   //Access-Challenge, Access-Accept, or Access-Reject packets including
+   //EAP-Message attribute(s) without a Message-Authenticator attribute should
+   //be silently discarded by the NAS (refer to RFC 3579, section 3.1)
+   if(attribute == NULL)
+      return ERROR_INVALID_MESSAGE;
+
+   //Malformed Message-Authenticator attribute?
+   if(attribute->length != (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+      return ERROR_INVALID_MESSAGE;
+
+   //Save the offset to the Message-Authenticator value
+   n = attribute->value - packet->attributes;
+
+   //Both authenticators are computed over the same octets, except for the
+   //shared secret that terminates the Response Authenticator and for the
+   //Message-Authenticator value that is considered to be sixteen octets of
+   //zero (refer to RFC 2869, section 5.14). The inner HMAC state starts on a
+   //block boundary, so that the two hashes can be processed in lockstep
+   md5Init(md5Context);
+   authenticatorHmacInit(&hmacContext, server);
+
+   //Feed the common part of the RADIUS packet to both computations
+   authenticatorMd5Update2(md5Context, &hmacContext, packet, 4, FALSE);
+   authenticatorMd5Update2(md5Context, &hmacContext, reqAuthenticator, 16,
+      FALSE);
+   authenticatorMd5Update2(md5Context, &hmacContext, packet->attributes, n,
+      FALSE);
+   authenticatorMd5Update2(md5Context, &hmacContext, attribute->value, 16,
+      TRUE);
+   authenticatorMd5Update2(md5Context, &hmacContext, packet->attributes + n +
+      16, length - n - 16, FALSE);
+
+   //Finalize the Response Authenticator
+   md5Update(md5Context, server->key, server->keyLen);
+   md5Final(md5Context, digest);
+
+   //Finalize the Message-Authenticator
+   authenticatorHmacFinal(&hmacContext, server, hmacDigest);
+
+   //Debug message
+   TRACE_DEBUG("Calculated Response Authenticator:\r\n");
+   TRACE_DEBUG_ARRAY("  ", digest, MD5_DIGEST_SIZE);
+
+   //The Response Authenticator field must contain the correct response for the
+   //pending Access-Request. Invalid packets are silently discarded
+   if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Response Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+
+   //Debug message
+   TRACE_DEBUG("Calculated Message Authenticator:\r\n");
+   TRACE_DEBUG_ARRAY("  ", hmacDigest, MD5_DIGEST_SIZE);
+
+   //A NAS supporting the EAP-Message attribute must calculate the correct
+   //value of the Message-Authenticator and must silently discard the packet
+   //if it does not match the value sent (refer to RFC 3579, section 3.1)
+   if(osMemcmp(hmacDigest, attribute->value, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Message Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+#else
+   //Initialize MD5 calculation
+   md5Init(md5Context);
+
+   //The Response Authenticator contains a one-way MD5 hash calculated over the
+   //RADIUS packet, beginning with the Code field, including the Identifier, the
+   //Length, the Request Authenticator field from the Access-Request packet, and
+   //the response Attributes, followed by the shared secret (refer to RFC 2865,
+   //section 3)
+   md5Update(md5Context, packet, 4);
+   md5Update(md5Context, reqAuthenticator, 16);
+   md5Update(md5Context, packet->attributes, length);
+   md5Update(md5Context, server->key, server->keyLen);
+   md5Final(md5Context, digest);
+
+   //Debug message
+   TRACE_DEBUG("Calculated Response Authenticator:\r\n");
+   TRACE_DEBUG_ARRAY("  ", digest, MD5_DIGEST_SIZE);
+
+   //The Response Authenticator field must contain the correct response for the
+   //pending Access-Request. Invalid packets are silently discarded
+   if(osMemcmp(digest, packet->authenticator, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Response Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+
+   //The Message-Authenticator attribute must be used to protect all
+   //Access-Request, Access-Challenge, Access-Accept, and Access-Reject
+   //packets containing an EAP-Message attribute (refer to RFC 3579,
+   //section 3.2)
+   attribute = radiusGetFirstAttribute(index, RADIUS_ATTR_MESSAGE_AUTHENTICATOR,
+      NULL);
+
+   //Access-Challenge, Access-Accept, or Access-Reject packets including
+   //EAP-Message attribute(s) without a Message-Authenticator attribute should
+   //be silently discarded by the NAS (refer to RFC 3579, section 3.1)
+   if(attribute == NULL)
+      return ERROR_INVALID_MESSAGE;
+
+   //Malformed Message-Authenticator attribute?
+   if(attribute->length != (sizeof(RadiusAttribute) + MD5_DIGEST_SIZE))
+      return ERROR_INVALID_MESSAGE;
+
+   //Save the offset to the Message-Authenticator value
+   n = attribute->value - packet->attributes;
+
+   //When the checksum is calculated the signature string should be considered
+   //to be sixteen octets of zero (refer to RFC 2869, section 5.14)
+   osMemset(digest, 0, MD5_DIGEST_SIZE);
+
+   //Initialize HMAC-MD5 calculation
+   authenticatorHmacInit(md5Context, server);
+
+   //For Access-Challenge, Access-Accept, and Access-Reject packets, the
+   //Message-Authenticator is calculated as follows, using the Request-
+   //Authenticator from the Access-Request this packet is in reply to (refer
+   //to RFC 3579, section 3.2)
+   md5Update(md5Context, packet, 4);
+   md5Update(md5Context, reqAuthenticator, 16);
+   md5Update(md5Context, packet->attributes, n);
+   md5Update(md5Context, digest, 16);
+   md5Update(md5Context, packet->attributes + n + 16, length - n - 16);
+   authenticatorHmacFinal(md5Context, server, digest);
+
+   //Debug message
+   TRACE_DEBUG("Calculated Message Authenticator:\r\n");
+   TRACE_DEBUG_ARRAY("  ", digest, MD5_DIGEST_SIZE);
+
+   //A NAS supporting the EAP-Message attribute must calculate the correct
+   //value of the Message-Authenticator and must silently discard the packet
+   //if it does not match the value sent (refer to RFC 3579, section 3.1)
+   if(osMemcmp(digest, attribute->value, MD5_DIGEST_SIZE) != 0)
+   {
+      //Debug message
+      TRACE_WARNING("Invalid Message Authenticator value!\r\n");
+      //Report an error
+      return ERROR_INVALID_MESSAGE;
+   }
+#endif
+
+   //The packet is authentic
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Precompute the HMAC-MD5 key schedule of a RADIUS shared secret
+ *
+ * The inner and outer padded keys only depend on the shared secret. The MD5
+ * states obtained after processing them are computed once and cloned for
+ * each Message-Authenticator calculation
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ **/
+
+void authenticatorInitHmacKey(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server)
 {
    uint_t i;
-   bool_t acceptable;
-   AuthenticatorPort *port;
+   uint8_t key[MD5_BLOCK_SIZE];
 
-   //Generate a new RADIUS packet identifier
-   do
+   //Keys longer than the block size are first hashed (refer to RFC 2104,
+   //section 2)
+   if(server->keyLen > MD5_BLOCK_SIZE)
+   {
+      //Hash the key using MD5
+      md5Init(&context->md5Context);
+      md5Update(&context->md5Context, server->key, server->keyLen);
+      md5Final(&context->md5Context, key);
+
+      //Pad the resulting digest with zeroes
+      osMemset(key + MD5_DIGEST_SIZE, 0, MD5_BLOCK_SIZE - MD5_DIGEST_SIZE);
+   }
+   else
+   {
+      //Copy the key and pad it with zeroes
+      osMemcpy(key, server->key, server->keyLen);
+      osMemset(key + server->keyLen, 0, MD5_BLOCK_SIZE - server->keyLen);
+   }
+
+   //XOR the resulting key with ipad
+   for(i = 0; i < MD5_BLOCK_SIZE; i++)
+   {
+      key[i] ^= 0x36;
+   }
+
+   //Save the MD5 state after processing the inner padded key
+   md5Init(&server->hmacInnerContext);
+   md5Update(&server->hmacInnerContext, key, MD5_BLOCK_SIZE);
+
+   //XOR the original key with opad
+   for(i = 0; i < MD5_BLOCK_SIZE; i++)
+   {
+      key[i] ^= 0x36 ^ 0x5C;
+   }
+
+   //Save the MD5 state after processing the outer padded key
+   md5Init(&server->hmacOuterContext);
+   md5Update(&server->hmacOuterContext, key, MD5_BLOCK_SIZE);
+
+   //Clear the padded key from memory
+   osMemset(key, 0, MD5_BLOCK_SIZE);
+}
+
+
+/**
+ * @brief Initialize HMAC-MD5 calculation
+ * @param[out] md5Context MD5 context used for the calculation
+ * @param[in] server RADIUS server entry
+ **/
+
+void authenticatorHmacInit(Md5Context *md5Context,
+   const AuthenticatorRadiusServer *server)
+{
+   //Restore the precomputed inner hash state
+   *md5Context = server->hmacInnerContext;
+}
+
+
+/**
+ * @brief Finish HMAC-MD5 calculation
+ * @param[in] md5Context MD5 context used for the calculation
+ * @param[in] server RADIUS server entry
+ * @param[out] digest Calculated HMAC value
+ **/
+
+void authenticatorHmacFinal(Md5Context *md5Context,
+   const AuthenticatorRadiusServer *server, uint8_t *digest)
+{
+   //Finish the inner hash
+   md5Final(md5Context, digest);
+
+   //Restore the precomputed outer hash state
+   *md5Context = server->hmacOuterContext;
+
+   //Compute the outer hash over the inner digest
+   md5Update(md5Context, digest, MD5_DIGEST_SIZE);
+   md5Final(md5Context, digest);
+}
+
+
+/**
+ * @brief Allocate a new RADIUS packet identifier
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorAllocRadiusId(AuthenticatorPort *port)
+{
+   uint_t index;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The identifier space is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Index of the (socket, Identifier) pair used by the previous request
+   index = port->aaaReqSocketIndex * 256 + port->aaaReqId;
+
+   //Release the identifier of the previous request, if any
+   if(context->radiusReqTable[index] == port)
+   {
+      authenticatorReleaseRadiusIndex(context, index);
+   }
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   //A TLS connection provides a single Identifier space, so the requests
+   //sent over TLS draw their identifiers from the space of the first socket
+   if(context->servers[port->aaaServerIndex].transport ==
+      AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+   {
+      index = authenticatorAllocRadiusIndex(context, 1);
+   }
+   else
+#endif
+   {
+      //Select a free (socket, Identifier) pair
+      index = authenticatorAllocRadiusIndex(context,
+         AUTHENTICATOR_NUM_RADIUS_SOCKETS);
+   }
+
+   //Save the identifier value
+   port->aaaReqSocketIndex = index / 256;
+   port->aaaReqId = index % 256;
+
+   //Map the (socket, Identifier) pair to the port
+   context->radiusReqTable[index] = port;
+   //The new request can be answered
+   port->aaaAborted = FALSE;
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+
+/**
+ * @brief Check whether the pending RADIUS request has been evicted
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the identifier of the request has been reused, else FALSE
+ **/
+
+bool_t authenticatorIsRadiusRequestAborted(AuthenticatorPort *port)
+{
+   bool_t aborted;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The flag is set by the shard that evicted the request
+   osAcquireMutex(&context->mutex);
+   aborted = port->aaaAborted;
+   osReleaseMutex(&context->mutex);
+
+   //Return TRUE if the response can no longer be matched
+   return aborted;
+}
+
+
+/**
+ * @brief Allocate a (socket, Identifier) pair
+ *
+ * Pending requests are identified by the UDP socket they were sent from
+ * together with the value of the Identifier field. The (socket, Identifier)
+ * pair is selected among the values that are not used by any pending
+ * request. If all of them are exhausted, the request that holds the next
+ * pair is evicted. The caller must hold the mutex of the 802.1X
+ * authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] numSockets Number of sockets the pair can be drawn from,
+ *   starting from the first socket
+ * @return Index of the (socket, Identifier) pair
+ **/
+
+uint_t authenticatorAllocRadiusIndex(AuthenticatorContext *context,
+   uint_t numSockets)
+{
+   uint_t i;
+   uint_t n;
+   uint_t index;
+
+   //Each socket provides 256 distinct identifiers
+   n = numSockets * 256;
+   //Start searching after the last identifier that has been allocated
+   index = context->radiusReqIndex;
+
+   //Search the bitmap for a free identifier
+   for(i = 0; i < n; i++)
    {
       //Increment identifier value
-      context->radiusId++;
+      index = (index + 1) % n;
 
-      //Loop through the ports
-      for(acceptable = TRUE, i = 0; i < context->numPorts; i++)
+      //Skip the remaining bits of a fully allocated word
+      if(context->radiusIdBitmap[index / 32] == 0xFFFFFFFF)
       {
-         //Point to the current port
-         port = &context->ports[i];
+         i += 31 - (index % 32);
+         index |= 31;
+      }
+      else if((context->radiusIdBitmap[index / 32] & (1U << (index % 32))) == 0)
+      {
+         //A free identifier has been found
+         break;
+      }
+      else
+      {
+         //The identifier is in use
+      }
+   }
 
-         //Pending Access-Request?
-         if(port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE &&
-            !port->aaaEapResp)
+   //All identifiers are in use?
+   if(i >= n)
+   {
+      //Reuse the identifier that follows the last allocated one
+      index = (context->radiusReqIndex + 1) % n;
+
+      //The corresponding request is no longer tracked
+      if(context->radiusReqTable[index] != NULL)
+      {
+         //The port owning the request may belong to another shard. It stops
+         //retransmitting and gives up when its retransmission timer expires
+         context->radiusReqTable[index]->aaaAborted = TRUE;
+
+         //Evict the pending Access-Request
+         authenticatorReleaseRadiusIndex(context, index);
+      }
+      else
+      {
+         //The identifier is held by a Status-Server probe
+         for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
          {
-            //Check whether the identifier is a duplicate
-            if(port->aaaReqId == context->radiusId)
+            //Matching probe?
+            if(context->servers[i].probePending &&
+               context->servers[i].probeIndex == index)
             {
-               acceptable = FALSE;
+               authenticatorCancelStatusServer(context, &context->servers[i]);
             }
          }
       }
+   }
+
+   //Save the identifier value
+   context->radiusReqIndex = index;
+   //The identifier is now in use
+   context->radiusIdBitmap[index / 32] |= (1U << (index % 32));
+
+   //Return the index of the (socket, Identifier) pair
+   return index;
+}
+
+
+/**
+ * @brief Release a (socket, Identifier) pair
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] index Index of the (socket, Identifier) pair
+ **/
+
+void authenticatorReleaseRadiusIndex(AuthenticatorContext *context,
+   uint_t index)
+{
+   //The identifier can be reused by subsequent requests
+   context->radiusReqTable[index] = NULL;
+   context->radiusIdBitmap[index / 32] &= ~(1U << (index % 32));
+}
 
-      //Repeat as necessary until a unique identifier value is generated
-   } while(!acceptable);
 
-   //Return the identifier value
-   return context->radiusId;
+/**
+ * @brief Release the identifier of the pending RADIUS request
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorReleaseRadiusId(AuthenticatorPort *port)
+{
+   uint_t index;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Index of the (socket, Identifier) pair used by the pending request
+   index = port->aaaReqSocketIndex * 256 + port->aaaReqId;
+
+   //The identifier space is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Check whether the identifier is owned by the port
+   if(context->radiusReqTable[index] == port)
+   {
+      //The identifier can be reused by subsequent requests
+      authenticatorReleaseRadiusIndex(context, index);
+   }
+
+   //The request no longer counts against the window of the server
+   authenticatorReleaseRadiusSlot(port);
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+/**
+ * @brief Publish the snapshot of a port
+ *
+ * The caller must hold the mutex of the shard the port belongs to. Readers
+ * detect a concurrent update by checking the sequence number
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUpdatePortSnapshot(AuthenticatorPort *port)
+{
+   AuthenticatorPortSnapshot *snapshot;
+
+   //Point to the snapshot of the port
+   snapshot = &port->data->snapshot;
+
+   //An odd sequence number indicates that an update is in progress
+   port->data->snapshotSeq++;
+   AUTHENTICATOR_MEMORY_BARRIER();
+
+   //Save the state of the port
+   snapshot->authPaeState = port->authPaeState;
+   snapshot->authBackendState = port->authBackendState;
+   snapshot->reauthTimerState = port->reauthTimerState;
+   snapshot->eapFullAuthState = port->eapFullAuthState;
+   snapshot->authPortStatus = port->authPortStatus;
+
+   //Save the configuration of the port
+   snapshot->portControl = port->portControl;
+   snapshot->quietPeriod = port->quietPeriod;
+   snapshot->serverTimeout = port->serverTimeout;
+   snapshot->reAuthPeriod = port->reAuthPeriod;
+   snapshot->reAuthEnabled = port->reAuthEnabled;
+   snapshot->keyTxEnabled = port->keyTxEnabled;
+
+   //Save the identity of the supplicant
+   snapshot->supplicantMacAddr = port->supplicantMacAddr;
+   osStrcpy(snapshot->aaaIdentity, port->data->aaaIdentity);
+
+   //Save statistics
+   snapshot->stats = port->data->stats;
+   snapshot->sessionStats = port->data->sessionStats;
+   snapshot->changeGeneration =
+      authenticatorGetPhysicalPort(port)->data->changeGeneration;
+
+   //The snapshot is now consistent
+   AUTHENTICATOR_MEMORY_BARRIER();
+   port->data->snapshotSeq++;
 }
 
 #endif
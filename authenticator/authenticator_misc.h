@@ -41,7 +41,22 @@ extern "C" {
 
 //Authenticator related functions
 void authenticatorTick(AuthenticatorContext *context);
+
+void authenticatorRecordPortChange(AuthenticatorPort *port);
+void authenticatorNotifyPortChanges(AuthenticatorContext *context);
 void authenticatorGeneratePortAddr(AuthenticatorPort *port);
+
+AuthenticatorInterface *authenticatorGetPortInterface(AuthenticatorPort *port);
+uint_t authenticatorGetSwitchPort(AuthenticatorPort *port);
+
+AuthenticatorPort *authenticatorFindPort(AuthenticatorContext *context,
+   uint_t portIndex);
+
+uint_t authenticatorGetNextPortIndex(AuthenticatorContext *context,
+   uint_t portIndex);
+
+void authenticatorPollLinkState(AuthenticatorShard *shard);
+void authenticatorUpdateLinkState(AuthenticatorPort *port, bool_t macOpState);
 bool_t authenticatorGetLinkState(AuthenticatorPort *port);
 
 error_t authenticatorAcceptPaeGroupAddr(AuthenticatorContext *context);
@@ -50,17 +65,73 @@ error_t authenticatorDropPaeGroupAddr(AuthenticatorContext *context);
 error_t authenticatorSendEapolPdu(AuthenticatorPort *port, const uint8_t *pdu,
    size_t length);
 
-void authenticatorProcessEapolPdu(AuthenticatorContext *context);
+void authenticatorReceiveFrames(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc);
+
+error_t authenticatorProcessEapolPdu(AuthenticatorContext *context,
+   uint_t interfaceIndex);
+
+void authenticatorUpdatePortSnapshot(AuthenticatorPort *port);
+
+void authenticatorProcessPortEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, AuthenticatorRxBuffer *buffer, size_t length);
 
 void authenticatorProcessEapPacket(AuthenticatorPort *port,
    const EapPacket *packet, size_t length);
 
+bool_t authenticatorConsumeToken(AuthenticatorTokenBucket *bucket, uint_t rate,
+   uint_t burst);
+
+bool_t authenticatorIsDuplicateResp(AuthenticatorPort *port,
+   const EapPacket *packet, size_t length);
+
 error_t authenticatorBuildRadiusRequest(AuthenticatorPort *port);
+error_t authenticatorFormatRadiusRequest(AuthenticatorPort *port);
+
+error_t authenticatorAddRadiusNasAttributes(AuthenticatorPort *port,
+   RadiusPacket *packet);
+
+void authenticatorInvalidateRadiusTemplate(AuthenticatorPort *port);
+
 error_t authenticatorSendRadiusRequest(AuthenticatorPort *port);
 
-void authenticatorProcessRadiusPacket(AuthenticatorContext *context);
+error_t authenticatorProcessRadiusPacket(AuthenticatorContext *context,
+   uint_t socketIndex);
+
+void authenticatorAcceptRadiusPacket(AuthenticatorContext *context,
+   uint_t socketIndex, const IpAddr *srcIpAddr, uint16_t srcPort,
+   size_t length);
+
+void authenticatorProcessRadiusResponse(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, uint_t reqIndex,
+   const RadiusPacket *packet);
+
+error_t authenticatorFilterRadiusResponse(AuthenticatorPort *port,
+   const RadiusPacket *packet, const RadiusAttrIndex *index);
+
+error_t authenticatorCheckRadiusResponse(AuthenticatorContext *context,
+   Md5Context *md5Context, const AuthenticatorRadiusServer *server,
+   const RadiusPacket *packet, const RadiusAttrIndex *index,
+   const uint8_t *reqAuthenticator);
+
+void authenticatorInitHmacKey(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server);
+
+void authenticatorHmacInit(Md5Context *md5Context,
+   const AuthenticatorRadiusServer *server);
+
+void authenticatorHmacFinal(Md5Context *md5Context,
+   const AuthenticatorRadiusServer *server, uint8_t *digest);
+
+void authenticatorAllocRadiusId(AuthenticatorPort *port);
+void authenticatorReleaseRadiusId(AuthenticatorPort *port);
+bool_t authenticatorIsRadiusRequestAborted(AuthenticatorPort *port);
+
+uint_t authenticatorAllocRadiusIndex(AuthenticatorContext *context,
+   uint_t numSockets);
 
-uint8_t authenticatorGetNextRadiusId(AuthenticatorContext *context);
+void authenticatorReleaseRadiusIndex(AuthenticatorContext *context,
+   uint_t index);
 
 //C++ guard
 #ifdef __cplusplus
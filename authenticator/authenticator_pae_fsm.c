@@ -35,8 +35,17 @@
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_fsm.h"
 #include "authenticator/authenticator_pae_fsm.h"
+#include "authenticator/authenticator_reauth_timer_fsm.h"
 #include "authenticator/authenticator_procedures.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_latency.h"
+#include "authenticator/authenticator_acct.h"
+#include "authenticator/authenticator_trace.h"
+#include "authenticator/authenticator_event.h"
+#include "authenticator/authenticator_stream.h"
+#include "eap/eap_full_auth_fsm.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
 
@@ -59,207 +68,206 @@ const EapParamName authenticatorPaeStates[] =
 };
 
 
-/**
- * @brief Authenticator PAE state machine initialization
- * @param[in] port Pointer to the port context
- **/
-
-void authenticatorPaeInitFsm(AuthenticatorPort *port)
+//Global transition to the INITIALIZE state
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondInitialize,
+   (port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+   port->portMode != port->portControl) ||
+   port->initialize || !port->portEnabled)
+
+//Global transition to the FORCE_AUTH state
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondForceAuth,
+   port->portControl == AUTHENTICATOR_PORT_MODE_FORCE_AUTH &&
+   port->portMode != port->portControl &&
+   !(port->initialize || !port->portEnabled))
+
+//Global transition to the FORCE_UNAUTH state
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondForceUnauth,
+   port->portControl == AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH &&
+   port->portMode != port->portControl &&
+   !(port->initialize || !port->portEnabled))
+
+//This state will exit to CONNECTING when EAP has acknowledged the restart
+//by resetting eapRestart to FALSE. The restart is deferred as long as no
+//session buffer is available
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondRestartDone,
+   !port->eapRestart && !port->bufferWait)
+
+//CONNECTING to DISCONNECTED transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondConnectingAbort,
+   port->eapolLogoff || port->reAuthCount > port->reAuthMax)
+
+//CONNECTING to AUTHENTICATING transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondConnectingDone,
+   (port->eapReq && port->reAuthCount <= port->reAuthMax) ||
+   port->eapSuccess || port->eapFail)
+
+//AUTHENTICATING to AUTHENTICATED transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAuthSuccess,
+   port->authSuccess && port->portValid)
+
+//The reauthentication of an authorized session that times out while no
+//RADIUS server can be reached does not terminate the session
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAuthDefer,
+   port->authTimeout && !port->eapolStart && !port->eapolLogoff &&
+   authenticatorCheckReauthDeferral(port))
+
+//AUTHENTICATING to ABORTING transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAuthAbort,
+   port->eapolStart || port->eapolLogoff || port->authTimeout)
+
+//AUTHENTICATING to HELD transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAuthFail,
+   port->authFail || (port->keyDone && !port->portValid))
+
+//AUTHENTICATED to RESTART transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondReauth,
+   port->eapolStart || port->reAuthenticate)
+
+//AUTHENTICATED to DISCONNECTED transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondLogoff,
+   port->eapolLogoff || !port->portValid)
+
+//ABORTING to DISCONNECTED transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAbortLogoff,
+   port->eapolLogoff && !port->authAbort)
+
+//ABORTING to RESTART transition
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondAbortRestart,
+   !port->eapolLogoff && !port->authAbort)
+
+//At the expiration of the quietWhile timer, the state machine transitions
+//to the RESTART state
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondQuietWhile,
+   port->quietWhile == 0)
+
+//If an EAPOL-Start message is received from the supplicant, the FORCE_AUTH
+//or FORCE_UNAUTH state is re-entered and a further EAP message is sent
+AUTHENTICATOR_FSM_CONDITION(authenticatorPaeCondEapolStart,
+   port->eapolStart)
+
+//Global transitions
+static const AuthenticatorFsmTransition authenticatorPaeGlobalTransitions[] =
 {
-   //Enter initial state
-   authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_INITIALIZE);
-}
+   {authenticatorPaeCondInitialize,  AUTHENTICATOR_PAE_STATE_INITIALIZE},
+   {authenticatorPaeCondForceAuth,   AUTHENTICATOR_PAE_STATE_FORCE_AUTH},
+   {authenticatorPaeCondForceUnauth, AUTHENTICATOR_PAE_STATE_FORCE_UNAUTH}
+};
 
+//Exit conditions of the INITIALIZE state
+static const AuthenticatorFsmTransition authenticatorPaeInitializeExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, AUTHENTICATOR_PAE_STATE_DISCONNECTED}
+};
 
-/**
- * @brief Authenticator PAE state machine implementation
- * @param[in] port Pointer to the port context
- **/
+//Exit conditions of the DISCONNECTED state
+static const AuthenticatorFsmTransition authenticatorPaeDisconnectedExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, AUTHENTICATOR_PAE_STATE_RESTART}
+};
 
-void authenticatorPaeFsm(AuthenticatorPort *port)
+//Exit conditions of the RESTART state
+static const AuthenticatorFsmTransition authenticatorPaeRestartExits[] =
 {
-   //A global transition can occur from any of the possible states. When the
-   //condition associated with a global transition is met, it supersedes all
-   //other exit conditions
-   if((port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
-      port->portMode != port->portControl) ||
-      port->initialize || !port->portEnabled)
-   {
-      //Switch to the INITIALIZE state
-      authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_INITIALIZE);
-   }
-   else if(port->portControl == AUTHENTICATOR_PORT_MODE_FORCE_AUTH &&
-      port->portMode != port->portControl &&
-      !(port->initialize || !port->portEnabled))
-   {
-      //Switch to the FORCE_AUTH state
-      authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_FORCE_AUTH);
-   }
-   else if(port->portControl == AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH &&
-      port->portMode != port->portControl &&
-      !(port->initialize || !port->portEnabled))
-   {
-      //Switch to the FORCE_UNAUTH state
-      authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_FORCE_UNAUTH);
-   }
-   else
-   {
-      //All exit conditions for the state are evaluated continuously until one
-      //of the conditions is met (refer to IEEE Std 802.1X-2004, section 8.2.1)
-      switch(port->authPaeState)
-      {
-      //INITIALIZE state?
-      case AUTHENTICATOR_PAE_STATE_INITIALIZE:
-         //Unconditional transition (UCT) to DISCONNECTED state
-         authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_DISCONNECTED);
-         break;
-
-      //DISCONNECTED state?
-      case AUTHENTICATOR_PAE_STATE_DISCONNECTED:
-         //Unconditional transition (UCT) to RESTART state
-         authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_RESTART);
-         break;
-
-      //RESTART state?
-      case AUTHENTICATOR_PAE_STATE_RESTART:
-         //This state will exit to CONNECTING when EAP has acknowledged the
-         //restart by resetting eapRestart to FALSE
-         if(!port->eapRestart)
-         {
-            //Switch to the CONNECTING state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_CONNECTING);
-         }
+   {authenticatorPaeCondRestartDone, AUTHENTICATOR_PAE_STATE_CONNECTING}
+};
 
-         break;
+//Exit conditions of the CONNECTING state
+static const AuthenticatorFsmTransition authenticatorPaeConnectingExits[] =
+{
+   {authenticatorPaeCondConnectingAbort, AUTHENTICATOR_PAE_STATE_DISCONNECTED},
+   {authenticatorPaeCondConnectingDone,  AUTHENTICATOR_PAE_STATE_AUTHENTICATING}
+};
 
-      //CONNECTING state?
-      case AUTHENTICATOR_PAE_STATE_CONNECTING:
-         //Evaluate conditions for the current state
-         if(port->eapolLogoff || port->reAuthCount > port->reAuthMax)
-         {
-            //Switch to the DISCONNECTED state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_DISCONNECTED);
-         }
-         else if((port->eapReq && port->reAuthCount <= port->reAuthMax) ||
-            port->eapSuccess || port->eapFail)
-         {
-            //Switch to the AUTHENTICATING state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_AUTHENTICATING);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions of the AUTHENTICATING state
+static const AuthenticatorFsmTransition authenticatorPaeAuthenticatingExits[] =
+{
+   {authenticatorPaeCondAuthSuccess, AUTHENTICATOR_PAE_STATE_AUTHENTICATED},
+   {authenticatorPaeCondAuthDefer,   AUTHENTICATOR_PAE_STATE_AUTHENTICATED},
+   {authenticatorPaeCondAuthAbort,   AUTHENTICATOR_PAE_STATE_ABORTING},
+   {authenticatorPaeCondAuthFail,    AUTHENTICATOR_PAE_STATE_HELD}
+};
 
-         break;
+//Exit conditions of the AUTHENTICATED state
+static const AuthenticatorFsmTransition authenticatorPaeAuthenticatedExits[] =
+{
+   {authenticatorPaeCondReauth, AUTHENTICATOR_PAE_STATE_RESTART},
+   {authenticatorPaeCondLogoff, AUTHENTICATOR_PAE_STATE_DISCONNECTED}
+};
 
-      //AUTHENTICATING state?
-      case AUTHENTICATOR_PAE_STATE_AUTHENTICATING:
-         //Evaluate conditions for the current state
-         if(port->authSuccess && port->portValid)
-         {
-            //Switch to the AUTHENTICATED state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_AUTHENTICATED);
-         }
-         else if(port->eapolStart || port->eapolLogoff || port->authTimeout)
-         {
-            //Switch to the ABORTING state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_ABORTING);
-         }
-         else if(port->authFail || (port->keyDone && !port->portValid))
-         {
-            //Switch to the HELD state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_HELD);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions of the ABORTING state
+static const AuthenticatorFsmTransition authenticatorPaeAbortingExits[] =
+{
+   {authenticatorPaeCondAbortLogoff,  AUTHENTICATOR_PAE_STATE_DISCONNECTED},
+   {authenticatorPaeCondAbortRestart, AUTHENTICATOR_PAE_STATE_RESTART}
+};
 
-         break;
+//Exit conditions of the HELD state
+static const AuthenticatorFsmTransition authenticatorPaeHeldExits[] =
+{
+   {authenticatorPaeCondQuietWhile, AUTHENTICATOR_PAE_STATE_RESTART}
+};
 
-      //AUTHENTICATED state?
-      case AUTHENTICATOR_PAE_STATE_AUTHENTICATED:
-         //Evaluate conditions for the current state
-         if(port->eapolStart || port->reAuthenticate)
-         {
-            //Switch to the RESTART state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_RESTART);
-         }
-         else if(port->eapolLogoff || !port->portValid)
-         {
-            //Switch to the DISCONNECTED state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_DISCONNECTED);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions of the FORCE_AUTH state
+static const AuthenticatorFsmTransition authenticatorPaeForceAuthExits[] =
+{
+   {authenticatorPaeCondEapolStart, AUTHENTICATOR_PAE_STATE_FORCE_AUTH}
+};
 
-         break;
+//Exit conditions of the FORCE_UNAUTH state
+static const AuthenticatorFsmTransition authenticatorPaeForceUnauthExits[] =
+{
+   {authenticatorPaeCondEapolStart, AUTHENTICATOR_PAE_STATE_FORCE_UNAUTH}
+};
 
-      //ABORTING state?
-      case AUTHENTICATOR_PAE_STATE_ABORTING:
-         //Evaluate conditions for the current state
-         if(port->eapolLogoff && !port->authAbort)
-         {
-            //Switch to the DISCONNECTED state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_DISCONNECTED);
-         }
-         else if(!port->eapolLogoff && !port->authAbort)
-         {
-            //Switch to the RESTART state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_RESTART);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions, listed in the order of the AuthenticatorPaeState values
+static const AuthenticatorFsmState authenticatorPaeExits[] =
+{
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeInitializeExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeDisconnectedExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeRestartExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeConnectingExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeAuthenticatingExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeAuthenticatedExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeAbortingExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeHeldExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeForceAuthExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorPaeForceUnauthExits)
+};
 
-         break;
+//Transition table of the authenticator PAE state machine
+static const AuthenticatorFsmTable authenticatorPaeFsmTable =
+   AUTHENTICATOR_FSM_TABLE(authenticatorPaeGlobalTransitions,
+   authenticatorPaeExits);
 
-      //HELD state?
-      case AUTHENTICATOR_PAE_STATE_HELD:
-         //At the expiration of the quietWhile timer, the state machine
-         //transitions to the RESTART state
-         if(port->quietWhile == 0)
-         {
-            //Switch to the RESTART state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_RESTART);
-         }
 
-         break;
+/**
+ * @brief Authenticator PAE state machine initialization
+ * @param[in] port Pointer to the port context
+ **/
 
-      //FORCE_AUTH state?
-      case AUTHENTICATOR_PAE_STATE_FORCE_AUTH:
-         //If an EAPOL-Start message is received from the supplicant, the state
-         //is re-entered and a further EAP success message is sent
-         if(port->eapolStart)
-         {
-            //Switch to the FORCE_AUTH state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_FORCE_AUTH);
-         }
+void authenticatorPaeInitFsm(AuthenticatorPort *port)
+{
+   //Enter initial state
+   authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_INITIALIZE);
+}
 
-         break;
 
-      //FORCE_UNAUTH state?
-      case AUTHENTICATOR_PAE_STATE_FORCE_UNAUTH:
-         //If an EAPOL-Start message is received from the supplicant, the state
-         //is re-entered and a further EAP failure message is sent
-         if(port->eapolStart)
-         {
-            //Switch to the FORCE_UNAUTH state
-            authenticatorPaeChangeState(port, AUTHENTICATOR_PAE_STATE_FORCE_UNAUTH);
-         }
+/**
+ * @brief Authenticator PAE state machine implementation
+ * @param[in] port Pointer to the port context
+ **/
 
-         break;
+void authenticatorPaeFsm(AuthenticatorPort *port)
+{
+   uint_t newState;
 
-      //Invalid state?
-      default:
-         //Just for sanity
-         authenticatorFsmError(port->context);
-         break;
-      }
+   //Evaluate the exit conditions of the current state (refer to IEEE Std
+   //802.1X-2004, section 8.2.1)
+   if(authenticatorEvalFsm(port, &authenticatorPaeFsmTable,
+      port->authPaeState, &newState))
+   {
+      //Switch to the new state
+      authenticatorPaeChangeState(port, (AuthenticatorPaeState) newState);
    }
 }
 
@@ -273,6 +281,7 @@ void authenticatorPaeFsm(AuthenticatorPort *port)
 void authenticatorPaeChangeState(AuthenticatorPort *port,
    AuthenticatorPaeState newState)
 {
+   systime_t delay;
    AuthenticatorPaeState oldState;
 
    //Retrieve current state
@@ -282,12 +291,17 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
    if(newState != oldState)
    {
       //Dump the state transition
-      TRACE_DEBUG("Port %" PRIu8 ": Authenticator PAE state machine %s -> %s\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": Authenticator PAE state machine %s -> %s\r\n",
          port->portIndex,
          eapGetParamName(oldState, authenticatorPaeStates,
          arraysize(authenticatorPaeStates)),
          eapGetParamName(newState, authenticatorPaeStates,
          arraysize(authenticatorPaeStates)));
+
+      //Record the state transition
+      authenticatorTraceStateChange(port, AUTHENTICATOR_TRACE_EVENT_PAE_STATE, oldState, newState);
+      //Stamp the port with a new change generation
+      authenticatorRecordPortChange(port);
    }
 
    //Switch to the new state
@@ -302,30 +316,44 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       //The value of the portMode variable is set to Auto
       port->portMode = AUTHENTICATOR_PORT_MODE_AUTO;
 
+      //Return the session buffer to the pool
+      authenticatorFreePortBuffer(port);
+      //Abandon the measurement of the authentication time
+      authenticatorCancelLatency(port, AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+
       //Errata
       if(port->authPortStatus != AUTHENTICATOR_PORT_STATUS_UNAUTH)
       {
          authenticatorSetAuthPortStatus(port, AUTHENTICATOR_PORT_STATUS_UNAUTH);
       }
 
+      //An additional session is released when its supplicant goes away
+      if(port->host && port->hostConnected)
+      {
+         port->hostReleasePending = TRUE;
+      }
+
       break;
 
    //DISCONNECTED state?
    case AUTHENTICATOR_PAE_STATE_DISCONNECTED:
+      //Abandon the measurement of the authentication time
+      authenticatorCancelLatency(port, AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+
       //Errata
       if(port->eapolStart)
       {
-         port->sessionStats.sessionTerminateCause =
+         port->data->sessionStats.sessionTerminateCause =
             AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_RESTART;
       }
       else if(port->eapolLogoff)
       {
-         port->sessionStats.sessionTerminateCause =
+         port->data->sessionStats.sessionTerminateCause =
             AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_LOGOFF;
       }
       else if(port->reAuthCount > port->reAuthMax)
       {
-         port->sessionStats.sessionTerminateCause =
+         port->data->sessionStats.sessionTerminateCause =
             AUTHENTICATOR_TERMINATE_CAUSE_REAUTH_FAILED;
       }
       else
@@ -338,13 +366,26 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       authenticatorSetAuthPortStatus(port, AUTHENTICATOR_PORT_STATUS_UNAUTH);
       port->reAuthCount = 0;
       port->eapolLogoff = FALSE;
+
+      //An additional session is released when its supplicant goes away
+      if(port->host && port->hostConnected)
+      {
+         port->hostReleasePending = TRUE;
+      }
+
       break;
 
    //RESTART state?
    case AUTHENTICATOR_PAE_STATE_RESTART:
-      //The RESTART state is entered when the authenticator PAE needs to
-      //inform the higher layer that it has restarted
-      port->eapRestart = TRUE;
+      //A session buffer is borrowed from the pool for the duration of the
+      //authentication exchange
+      if(authenticatorAllocPortBuffer(port))
+      {
+         //The RESTART state is entered when the authenticator PAE needs to
+         //inform the higher layer that it has restarted
+         port->eapRestart = TRUE;
+      }
+
       break;
 
    //CONNECTING state?
@@ -353,6 +394,11 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       //ready to attempt to establish communication with a supplicant
       port->reAuthenticate = FALSE;
       port->reAuthCount++;
+
+      //Start measuring the authentication time
+      authenticatorStartLatency(port, AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+      //The supplicant has been seen by the session
+      port->hostConnected = TRUE;
       break;
 
    //AUTHENTICATING state?
@@ -374,8 +420,64 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       authenticatorSetAuthPortStatus(port, AUTHENTICATOR_PORT_STATUS_AUTH);
       port->reAuthCount = 0;
 
+      //Return the session buffer to the pool
+      authenticatorFreePortBuffer(port);
+
+      //The reauthentication has timed out while no RADIUS server could be
+      //reached?
+      if(port->authTimeout)
+      {
+         //Abandon the measurement of the authentication time
+         authenticatorCancelLatency(port,
+            AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+
+         //The Access-Request that has timed out is abandoned, so that a
+         //late answer from the server cannot be matched against it
+         authenticatorStopTimer(port, AUTHENTICATOR_TIMER_AAA_RETRANS_TIMER);
+         authenticatorReleaseRadiusId(port);
+
+         //The EAP conversation is over. The session buffer has been returned
+         //to the pool, so the EAP layer is left in a final state until the
+         //next reauthentication restarts it through eapRestart
+         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2);
+
+         //The supplicant keeps its access to the network
+         port->authTimeout = FALSE;
+         authenticatorTxCannedSuccess(port);
+
+         //The reauthentication is attempted again after a backoff delay
+         delay = authenticatorPostponeReauth(port);
+
+         //Periodic reauthentication enabled?
+         if(port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+            port->reAuthEnabled)
+         {
+            authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+               delay);
+         }
+      }
+      else
+      {
+         //Record the authentication time
+         authenticatorStopLatency(port,
+            AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
+
+         //The server has answered
+         port->reAuthDeferrals = 0;
+
+         //The reauthentication period is counted from the completion of the
+         //authentication, so that the Session-Timeout attribute of the latest
+         //Access-Accept is honored
+         if(port->portControl == AUTHENTICATOR_PORT_MODE_AUTO &&
+            port->reAuthEnabled)
+         {
+            authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+               authenticatorGetReauthDelay(port));
+         }
+      }
+
       //Errata
-      port->sessionStats.sessionTerminateCause =
+      port->data->sessionStats.sessionTerminateCause =
          AUTHENTICATOR_TERMINATE_CAUSE_NOT_TERMINATED_YET;
 
       break;
@@ -395,8 +497,14 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       //In this state, the state machine ignores and discards all EAPOL
       //packets, so as to discourage brute force attacks
       authenticatorSetAuthPortStatus(port, AUTHENTICATOR_PORT_STATUS_UNAUTH);
-      port->quietWhile = port->quietPeriod;
+      authenticatorStartTimer(port, AUTHENTICATOR_TIMER_QUIET_WHILE,
+         port->quietPeriod * 1000);
       port->eapolLogoff = FALSE;
+
+      //Return the session buffer to the pool
+      authenticatorFreePortBuffer(port);
+      //Abandon the measurement of the authentication time
+      authenticatorCancelLatency(port, AUTHENTICATOR_LATENCY_CONNECTING_TO_AUTH);
       break;
 
    //FORCE_AUTH state?
@@ -408,8 +516,11 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       port->eapolStart = FALSE;
       authenticatorTxCannedSuccess(port);
 
+      //Return the session buffer to the pool
+      authenticatorFreePortBuffer(port);
+
       //Errata
-      port->sessionStats.sessionTerminateCause =
+      port->data->sessionStats.sessionTerminateCause =
          AUTHENTICATOR_TERMINATE_CAUSE_NOT_TERMINATED_YET;
 
       break;
@@ -423,8 +534,11 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       port->eapolStart = FALSE;
       authenticatorTxCannedFail(port);
 
+      //Return the session buffer to the pool
+      authenticatorFreePortBuffer(port);
+
       //Errata
-      port->sessionStats.sessionTerminateCause =
+      port->data->sessionStats.sessionTerminateCause =
          AUTHENTICATOR_TERMINATE_CAUSE_AUTH_CONTROL_FORCE_UNAUTH;
 
       break;
@@ -435,14 +549,30 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
       break;
    }
 
+   //Start or stop the accounting session
+   authenticatorUpdateAcctSession(port);
+   //Report the authorization state of the session
+   authenticatorUpdateSessionStream(port);
+
+   //An authentication failure is reported once the port has been blocked
+   if(newState == AUTHENTICATOR_PAE_STATE_HELD && newState != oldState)
+   {
+      authenticatorWriteSessionEvent(port, AUTHENTICATOR_SESSION_EVENT_FAILED);
+   }
+
    //Any state change?
    if(newState != oldState)
    {
       //Any registered callback?
       if(port->context->paeStateChangeCallback != NULL)
       {
-         //Invoke user callback function
-         port->context->paeStateChangeCallback(port, newState);
+         //The callback is either deferred or invoked synchronously
+         if(!authenticatorQueueEvent(port, AUTHENTICATOR_EVENT_PAE_STATE,
+            newState))
+         {
+            //Invoke user callback function
+            port->context->paeStateChangeCallback(port, newState);
+         }
       }
    }
 
@@ -450,7 +580,7 @@ void authenticatorPaeChangeState(AuthenticatorPort *port,
    if(!port->initialize && port->portEnabled)
    {
       //The authenticator PAE state machine is busy
-      port->context->busy = TRUE;
+      port->busy = TRUE;
    }
 }
 
@@ -35,6 +35,8 @@
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_procedures.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_latency.h"
+#include "authenticator/authenticator_host.h"
 #include "eap/eap_auth_procedures.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
@@ -52,16 +54,39 @@
 void authenticatorSetAuthPortStatus(AuthenticatorPort *port,
    AuthenticatorPortStatus status)
 {
+   uint_t switchPort;
    NetInterface *interface;
 
-   //Point to the underlying network interface
-   interface = port->context->interface;
+   //Point to the network interface the port is attached to
+   interface = authenticatorGetPortInterface(port)->interface;
+   //Retrieve the corresponding switch port
+   switchPort = authenticatorGetSwitchPort(port);
 
-   //Update the state of the specified port
-   if(status == AUTHENTICATOR_PORT_STATUS_AUTH)
+   //Stamp the port with a new change generation
+   if(status != port->authPortStatus)
+   {
+      authenticatorRecordPortChange(port);
+   }
+
+   //Several supplicants may share the same port
+   if(port->host || port->context->maxHostsPerPort > 1)
    {
       //Debug message
-      TRACE_INFO("Port %" PRIu8 ": Set port status to Authorized\r\n",
+      TRACE_INFO("Port %" PRIu16 ": Set status of supplicant %s to %s\r\n",
+         authenticatorGetPhysicalPort(port)->portIndex,
+         macAddrToString(&port->supplicantMacAddr, NULL),
+         (status == AUTHENTICATOR_PORT_STATUS_AUTH) ? "Authorized" :
+         "Unauthorized");
+
+      //Save authorization state
+      port->authPortStatus = status;
+      //The port is authorized as long as one of its supplicants is
+      authenticatorUpdateHostStatus(port);
+   }
+   else if(status == AUTHENTICATOR_PORT_STATUS_AUTH)
+   {
+      //Debug message
+      TRACE_INFO("Port %" PRIu16 ": Set port status to Authorized\r\n",
          port->portIndex);
 
       //A port in the authorized state effectively means that the
@@ -69,14 +94,14 @@ void authenticatorSetAuthPortStatus(AuthenticatorPort *port,
       if(interface->switchDriver != NULL &&
          interface->switchDriver->setPortState != NULL)
       {
-         interface->switchDriver->setPortState(interface, port->portIndex,
+         interface->switchDriver->setPortState(interface, switchPort,
             SWITCH_PORT_STATE_FORWARDING);
       }
    }
    else
    {
       //Debug message
-      TRACE_INFO("Port %" PRIu8 ": Set port status to Unauthorized\r\n",
+      TRACE_INFO("Port %" PRIu16 ": Set port status to Unauthorized\r\n",
          port->portIndex);
 
       //If the port is in the unauthorized state, then the client is not
@@ -84,7 +109,7 @@ void authenticatorSetAuthPortStatus(AuthenticatorPort *port,
       if(interface->switchDriver != NULL &&
          interface->switchDriver->setPortState != NULL)
       {
-         interface->switchDriver->setPortState(interface, port->portIndex,
+         interface->switchDriver->setPortState(interface, switchPort,
             SWITCH_PORT_STATE_BLOCKING);
       }
    }
@@ -104,6 +129,7 @@ void authenticatorTxCannedFail(AuthenticatorPort *port)
    size_t n;
    EapolPdu *pdu;
    EapPacket *packet;
+   uint8_t buffer[sizeof(EapolPdu) + sizeof(EapPacket)];
 
    //Debug message
    TRACE_DEBUG("txCannedFail() procedure...\r\n");
@@ -116,8 +142,8 @@ void authenticatorTxCannedFail(AuthenticatorPort *port)
    //(refer to IEEE Std 802.1X-2004, section 8.2.4.1.3)
    port->currentId = eapNextId(port->currentId);
 
-   //Point to the buffer where to format the EAPOL packet
-   pdu = (EapolPdu *) port->eapTxBuffer;
+   //Canned packets do not require a session buffer
+   pdu = (EapolPdu *) buffer;
    //Point to the buffer where to format the EAP packet
    packet = (EapPacket *) pdu->packetBody;
 
@@ -130,7 +156,7 @@ void authenticatorTxCannedFail(AuthenticatorPort *port)
    packet->length = htons(n);
 
    //Debug message
-   TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAP header contents for debugging purpose
@@ -145,14 +171,14 @@ void authenticatorTxCannedFail(AuthenticatorPort *port)
    pdu->packetBodyLen = ntohs(n);
 
    //Debug message
-   TRACE_INFO("Port %" PRIu8 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_INFO("Port %" PRIu16 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAPOL header contents for debugging purpose
    eapolDumpHeader(pdu);
 
    //Send EAPOL PDU
-   authenticatorSendEapolPdu(port, port->eapTxBuffer, n);
+   authenticatorSendEapolPdu(port, buffer, n);
 }
 
 
@@ -166,6 +192,7 @@ void authenticatorTxCannedSuccess(AuthenticatorPort *port)
    size_t n;
    EapolPdu *pdu;
    EapPacket *packet;
+   uint8_t buffer[sizeof(EapolPdu) + sizeof(EapPacket)];
 
    //Debug message
    TRACE_DEBUG("txCannedSuccess() procedure...\r\n");
@@ -178,8 +205,8 @@ void authenticatorTxCannedSuccess(AuthenticatorPort *port)
    //(refer to IEEE Std 802.1X-2004, section 8.2.4.1.3)
    port->currentId = eapNextId(port->currentId);
 
-   //Point to the buffer where to format the EAPOL packet
-   pdu = (EapolPdu *) port->eapTxBuffer;
+   //Canned packets do not require a session buffer
+   pdu = (EapolPdu *) buffer;
    //Point to the buffer where to format the EAP packet
    packet = (EapPacket *) pdu->packetBody;
 
@@ -192,7 +219,7 @@ void authenticatorTxCannedSuccess(AuthenticatorPort *port)
    packet->length = htons(n);
 
    //Debug message
-   TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAP header contents for debugging purpose
@@ -207,14 +234,14 @@ void authenticatorTxCannedSuccess(AuthenticatorPort *port)
    pdu->packetBodyLen = ntohs(n);
 
    //Debug message
-   TRACE_INFO("Port %" PRIu8 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_INFO("Port %" PRIu16 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAPOL header contents for debugging purpose
    eapolDumpHeader(pdu);
 
    //Send EAPOL PDU
-   authenticatorSendEapolPdu(port, port->eapTxBuffer, n);
+   authenticatorSendEapolPdu(port, buffer, n);
 }
 
 
@@ -232,13 +259,11 @@ void authenticatorTxReq(AuthenticatorPort *port)
    //Debug message
    TRACE_DEBUG("txReq() procedure...\r\n");
 
-   //Point to the buffer where to format the EAPOL packet
-   pdu = (EapolPdu *) port->eapTxBuffer;
    //Retrieve the length of the EAP request
    length = port->eapReqDataLen;
 
    //Valid EAP packet?
-   if(length >= sizeof(EapPacket))
+   if(port->buffer != NULL && length >= sizeof(EapPacket))
    {
       //EAP request?
       if(port->eapReqData[0] == EAP_CODE_REQUEST &&
@@ -251,16 +276,22 @@ void authenticatorTxReq(AuthenticatorPort *port)
          if(request->type == EAP_METHOD_TYPE_IDENTITY)
          {
             //Number of EAP Req/Id frames that have been transmitted
-            port->stats.eapolReqIdFramesTx++;
+            port->data->stats.eapolReqIdFramesTx++;
+
+            //The supplicant's EAPOL-Start has been answered
+            authenticatorStopLatency(port, AUTHENTICATOR_LATENCY_START_TO_REQ_ID);
          }
          else
          {
             //Number of EAP Request frames (other than Rq/Id frames) that have
             //been transmitted
-            port->stats.eapolReqFramesTx++;
+            port->data->stats.eapolReqFramesTx++;
          }
       }
 
+      //The EAPOL header is prepended to the EAP request
+      pdu = (EapolPdu *) port->buffer->eapTxBuffer;
+
       //Format EAPOL packet
       pdu->protocolVersion = EAPOL_VERSION_2;
       pdu->packetType = EAPOL_TYPE_EAP;
@@ -270,14 +301,14 @@ void authenticatorTxReq(AuthenticatorPort *port)
       length += sizeof(EapolPdu);
 
       //Debug message
-      TRACE_INFO("Port %" PRIu8 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
+      TRACE_INFO("Port %" PRIu16 ": Sending EAPOL packet (%" PRIuSIZE " bytes)...\r\n",
          port->portIndex, length);
 
       //Dump EAPOL header contents for debugging purpose
       eapolDumpHeader(pdu);
 
       //Send EAPOL PDU
-      authenticatorSendEapolPdu(port, port->eapTxBuffer, length);
+      authenticatorSendEapolPdu(port, port->buffer->eapTxBuffer, length);
    }
 }
 
@@ -303,20 +334,4 @@ void authenticatorAbortAuth(AuthenticatorPort *port)
 {
 }
 
-
-/**
- * @brief Decrement timer value
- * @param[in,out] x Actual timer value
- **/
-
-void authenticatorDecrementTimer(uint_t *x)
-{
-   //If the variable has a non-zero value, this procedure decrements the value
-   //of the variable by 1
-   if(*x > 0)
-   {
-      *x -= 1;
-   }
-}
-
 #endif
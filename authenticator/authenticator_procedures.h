@@ -50,8 +50,6 @@ void authenticatorTxReq(AuthenticatorPort *port);
 void authenticatorSendRespToServer(AuthenticatorPort *port);
 void authenticatorAbortAuth(AuthenticatorPort *port);
 
-void authenticatorDecrementTimer(uint_t *x);
-
 //C++ guard
 #ifdef __cplusplus
 }
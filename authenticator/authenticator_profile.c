@@ -0,0 +1,153 @@
+/**
+ * @file authenticator_profile.c
+ * @brief Cycle-counter profiling of the hot paths
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_profile.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Account for the cycles spent in a profiled code path
+ *
+ * The table is only updated by the task that owns it. The sequence number
+ * lets the readers detect an update that is in progress
+ *
+ * @param[in] table Pointer to the profiling table
+ * @param[in] point Profiled code path
+ * @param[in] start Value of the cycle counter at the beginning of the call
+ **/
+
+void authenticatorRecordProfile(AuthenticatorProfileTable *table,
+   AuthenticatorProfilePoint point, uint32_t start)
+{
+   uint32_t cycles;
+   AuthenticatorProfileEntry *entry;
+
+   //The difference is computed modulo 2^32, so that a wrap-around of the
+   //cycle counter is harmless
+   cycles = (uint32_t) AUTHENTICATOR_PROFILE_GET_CYCLES() - start;
+
+   //Point to the relevant entry
+   entry = &table->entries[point];
+
+   //An odd sequence number indicates that an update is in progress
+   table->seq++;
+   AUTHENTICATOR_MEMORY_BARRIER();
+
+   //Update the shortest and longest calls
+   if(entry->calls == 0 || cycles < entry->minCycles)
+   {
+      entry->minCycles = cycles;
+   }
+
+   if(cycles > entry->maxCycles)
+   {
+      entry->maxCycles = cycles;
+   }
+
+   //Update totals
+   entry->totalCycles += cycles;
+   entry->calls++;
+
+   //The update is complete
+   AUTHENTICATOR_MEMORY_BARRIER();
+   table->seq++;
+}
+
+
+/**
+ * @brief Take a consistent copy of a profiling table
+ * @param[in] table Pointer to the profiling table
+ * @param[out] entries Cycle counts of the profiled code paths
+ **/
+
+void authenticatorReadProfile(const AuthenticatorProfileTable *table,
+   AuthenticatorProfileEntry *entries)
+{
+   uint_t seq;
+
+   //Loop until the copy is not torn by an update
+   while(1)
+   {
+      //Retrieve the sequence number before reading the table
+      seq = table->seq;
+      AUTHENTICATOR_MEMORY_BARRIER();
+
+      //Copy the entries
+      osMemcpy(entries, table->entries, sizeof(table->entries));
+
+      //The copy is consistent if no update took place in the meantime
+      AUTHENTICATOR_MEMORY_BARRIER();
+      if((seq & 1) == 0 && seq == table->seq)
+         break;
+
+      //Let the owner of the table complete its update
+      osDelayTask(1);
+   }
+}
+
+
+/**
+ * @brief Merge the cycle counts of a code path
+ * @param[in,out] entry Cycle counts to be updated
+ * @param[in] other Cycle counts to be added
+ **/
+
+void authenticatorMergeProfile(AuthenticatorProfileEntry *entry,
+   const AuthenticatorProfileEntry *other)
+{
+   //Any call to account for?
+   if(other->calls > 0)
+   {
+      //Update the shortest and longest calls
+      if(entry->calls == 0 || other->minCycles < entry->minCycles)
+      {
+         entry->minCycles = other->minCycles;
+      }
+
+      if(other->maxCycles > entry->maxCycles)
+      {
+         entry->maxCycles = other->maxCycles;
+      }
+
+      //Update totals
+      entry->totalCycles += other->totalCycles;
+      entry->calls += other->calls;
+   }
+}
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file authenticator_profile.h
+ * @brief Cycle-counter profiling of the hot paths
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_PROFILE_H
+#define _AUTHENTICATOR_PROFILE_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Profiling supported?
+#if (AUTHENTICATOR_PROFILE_SUPPORT == ENABLED)
+
+//Read the cycle counter at the beginning of a profiled code path
+#define AUTHENTICATOR_PROFILE_START(cycles) \
+   cycles = (uint32_t) AUTHENTICATOR_PROFILE_GET_CYCLES()
+
+//Account for the cycles spent since the beginning of the code path
+#define AUTHENTICATOR_PROFILE_STOP(table, point, cycles) \
+   authenticatorRecordProfile(table, point, cycles)
+
+//Authenticator related functions
+void authenticatorRecordProfile(AuthenticatorProfileTable *table,
+   AuthenticatorProfilePoint point, uint32_t start);
+
+void authenticatorReadProfile(const AuthenticatorProfileTable *table,
+   AuthenticatorProfileEntry *entries);
+
+void authenticatorMergeProfile(AuthenticatorProfileEntry *entry,
+   const AuthenticatorProfileEntry *other);
+
+#else
+
+//Profiling is not supported
+#define AUTHENTICATOR_PROFILE_START(cycles)
+#define AUTHENTICATOR_PROFILE_STOP(table, point, cycles)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
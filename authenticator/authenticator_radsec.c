@@ -0,0 +1,803 @@
+/**
+ * @file authenticator_radsec.c
+ * @brief RADIUS over TLS transport
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_radsec.h"
+#include "radius/radius.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Manage the TLS connections to the RADIUS servers
+ *
+ * A long-lived connection is maintained to each server that uses the TLS
+ * transport. A connection that fails is reopened after an exponentially
+ * increasing delay
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorTickRadsec(AuthenticatorContext *context)
+{
+   uint_t i;
+   bool_t enabled;
+   uint16_t port;
+   IpAddr ipAddr;
+   systime_t time;
+   AuthenticatorRadsecConn *conn;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the TLS connection to the server
+      conn = &context->radsecConns[i];
+
+      //Acquire exclusive access to the shared state
+      osAcquireMutex(&context->mutex);
+
+      //Check whether the server uses the TLS transport
+      if(context->servers[i].enabled &&
+         context->servers[i].transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+      {
+         enabled = TRUE;
+         ipAddr = context->servers[i].ipAddr;
+         port = context->servers[i].port;
+      }
+      else
+      {
+         enabled = FALSE;
+         ipAddr = IP_ADDR_ANY;
+         port = 0;
+      }
+
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
+
+      //Acquire exclusive access to the connection
+      osAcquireMutex(&conn->mutex);
+
+      //Get current time
+      time = osGetSystemTime();
+
+      //Check the state of the connection
+      if(!enabled)
+      {
+         //The server no longer uses the TLS transport
+         if(conn->state != AUTHENTICATOR_RADSEC_STATE_CLOSED)
+         {
+            authenticatorCloseRadsecConn(conn);
+         }
+
+         //The first connection attempt takes place immediately
+         conn->retryDelay = 0;
+         conn->backoff = 0;
+      }
+      else if(conn->state == AUTHENTICATOR_RADSEC_STATE_ERROR)
+      {
+         //The connection has been lost while sending a request
+         authenticatorFailRadsecConn(conn);
+      }
+      else if(conn->state == AUTHENTICATOR_RADSEC_STATE_CLOSED)
+      {
+         //Time to reconnect?
+         if((time - conn->timestamp) >= conn->retryDelay)
+         {
+            //Open a new connection
+            authenticatorOpenRadsecConn(context, i, &ipAddr, port);
+         }
+      }
+      else if(conn->state == AUTHENTICATOR_RADSEC_STATE_CONNECTING ||
+         conn->state == AUTHENTICATOR_RADSEC_STATE_HANDSHAKE)
+      {
+         //The connection must be established within a bounded time
+         if((time - conn->timestamp) >= AUTHENTICATOR_RADSEC_CONNECT_TIMEOUT)
+         {
+            //Debug message
+            TRACE_WARNING("RADIUS server %u: TLS connection timeout!\r\n", i);
+            //Close the connection
+            authenticatorFailRadsecConn(conn);
+         }
+      }
+      else
+      {
+         //The connection is open
+      }
+
+      //Release exclusive access to the connection
+      osReleaseMutex(&conn->mutex);
+   }
+}
+
+
+/**
+ * @brief Force the TLS connection to a RADIUS server to be reopened
+ *
+ * The connection is closed by the authenticator task, and a new connection
+ * is opened immediately
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ **/
+
+void authenticatorResetRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex)
+{
+   AuthenticatorRadsecConn *conn;
+
+   //Point to the TLS connection to the server
+   conn = &context->radsecConns[serverIndex];
+
+   //Acquire exclusive access to the connection
+   osAcquireMutex(&conn->mutex);
+
+   //The socket is only closed by the authenticator task
+   if(conn->state != AUTHENTICATOR_RADSEC_STATE_CLOSED)
+   {
+      conn->state = AUTHENTICATOR_RADSEC_STATE_ERROR;
+   }
+
+   //Reconnect without delay
+   conn->retryDelay = 0;
+   conn->backoff = 0;
+
+   //Release exclusive access to the connection
+   osReleaseMutex(&conn->mutex);
+}
+
+
+/**
+ * @brief Open a TLS connection to a RADIUS server
+ *
+ * The caller must hold the mutex of the connection
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[in] ipAddr IP address of the RADIUS server
+ * @param[in] port Port number of the RADIUS server
+ **/
+
+void authenticatorOpenRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex, const IpAddr *ipAddr, uint16_t port)
+{
+   error_t error;
+   AuthenticatorRadsecConn *conn;
+
+   //Point to the TLS connection to the server
+   conn = &context->radsecConns[serverIndex];
+
+   //Debug message
+   TRACE_INFO("RADIUS server %u: Opening TLS connection...\r\n", serverIndex);
+
+   //Save the address of the server
+   conn->ipAddr = *ipAddr;
+   conn->port = port;
+
+   //Flush the reassembly buffer
+   conn->rxLen = 0;
+   conn->rxPending = FALSE;
+
+   //Start of exception handling block
+   do
+   {
+      //Open a TCP socket
+      conn->socket = socketOpenEx(context->netContext, SOCKET_TYPE_STREAM,
+         SOCKET_IP_PROTO_TCP);
+      //Failed to open socket?
+      if(conn->socket == NULL)
+      {
+         //Report an error
+         error = ERROR_OPEN_FAILED;
+         break;
+      }
+
+      //Force the socket to operate in non-blocking mode
+      error = socketSetTimeout(conn->socket, 0);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Associate the socket with the relevant interface
+      error = socketBindToInterface(conn->socket, context->serverInterface);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Initialize TLS context
+      conn->tlsContext = tlsInit();
+      //Initialization failed?
+      if(conn->tlsContext == NULL)
+      {
+         //Report an error
+         error = ERROR_OUT_OF_MEMORY;
+         break;
+      }
+
+      //Bind TLS to the relevant socket
+      error = tlsSetSocket(conn->tlsContext, conn->socket);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Select client operation mode
+      error = tlsSetConnectionEnd(conn->tlsContext, TLS_CONNECTION_END_CLIENT);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Set the PRNG algorithm to be used
+      error = tlsSetPrng(conn->tlsContext, context->prngAlgo,
+         context->prngContext);
+      //Any error to report?
+      if(error)
+         break;
+
+      //Invoke user-defined callback, if any
+      if(context->radsecInitCallback != NULL)
+      {
+         //Load the trusted CA certificates and the client certificate
+         error = context->radsecInitCallback(context, serverIndex,
+            conn->tlsContext);
+         //Any error to report?
+         if(error)
+            break;
+      }
+
+      //The three-way handshake completes asynchronously
+      conn->state = AUTHENTICATOR_RADSEC_STATE_CONNECTING;
+      conn->timestamp = osGetSystemTime();
+
+      //Establish the TCP connection
+      error = authenticatorContinueRadsecConn(context, serverIndex);
+
+      //End of exception handling block
+   } while(0);
+
+   //Failed to open the connection?
+   if(error && error != ERROR_WOULD_BLOCK)
+   {
+      //Debug message
+      TRACE_WARNING("RADIUS server %u: Failed to open TLS connection!\r\n",
+         serverIndex);
+
+      //Try again later
+      authenticatorFailRadsecConn(conn);
+   }
+}
+
+
+/**
+ * @brief Make progress with the establishment of a TLS connection
+ *
+ * The caller must hold the mutex of the connection
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @return Error code (ERROR_WOULD_BLOCK is returned while the connection is
+ *   being established)
+ **/
+
+error_t authenticatorContinueRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex)
+{
+   error_t error;
+   AuthenticatorRadsecConn *conn;
+
+   //Point to the TLS connection to the server
+   conn = &context->radsecConns[serverIndex];
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Waiting for the TCP connection to be established?
+   if(conn->state == AUTHENTICATOR_RADSEC_STATE_CONNECTING)
+   {
+      //Establish the TCP connection
+      error = socketConnect(conn->socket, &conn->ipAddr, conn->port);
+
+      //Check status code
+      if(!error)
+      {
+         //The TLS handshake can start
+         conn->state = AUTHENTICATOR_RADSEC_STATE_HANDSHAKE;
+      }
+   }
+
+   //TLS handshake in progress?
+   if(conn->state == AUTHENTICATOR_RADSEC_STATE_HANDSHAKE)
+   {
+      //Perform TLS handshake
+      error = tlsConnect(conn->tlsContext);
+
+      //Check status code
+      if(!error)
+      {
+         //Debug message
+         TRACE_INFO("RADIUS server %u: TLS connection established\r\n",
+            serverIndex);
+
+         //The connection is ready to carry RADIUS packets
+         conn->state = AUTHENTICATOR_RADSEC_STATE_OPEN;
+         conn->timestamp = osGetSystemTime();
+
+         //Requests that have been written to the previous connection must
+         //be written again
+         conn->connId++;
+
+         //Skip the value reserved for requests that have not been sent
+         if(conn->connId == 0)
+         {
+            conn->connId++;
+         }
+
+         //The next failure is followed by an immediate reconnection
+         conn->retryDelay = 0;
+         conn->backoff = 0;
+      }
+   }
+
+   //The operation would block?
+   if(error == ERROR_TIMEOUT)
+   {
+      error = ERROR_WOULD_BLOCK;
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Close a TLS connection after a failure
+ *
+ * The connection is reopened after the current backoff delay, and the delay
+ * applied after the next failure is doubled. The caller must hold the mutex
+ * of the connection
+ *
+ * @param[in] conn Pointer to the TLS connection
+ **/
+
+void authenticatorFailRadsecConn(AuthenticatorRadsecConn *conn)
+{
+   //Release the socket and the TLS context
+   authenticatorCloseRadsecConn(conn);
+
+   //Delay before the next connection attempt
+   conn->retryDelay = conn->backoff;
+
+   //Exponential backoff
+   conn->backoff = MAX(conn->backoff * 2, AUTHENTICATOR_RADSEC_MIN_BACKOFF);
+   conn->backoff = MIN(conn->backoff, AUTHENTICATOR_RADSEC_MAX_BACKOFF);
+}
+
+
+/**
+ * @brief Close a TLS connection
+ *
+ * The caller must hold the mutex of the connection
+ *
+ * @param[in] conn Pointer to the TLS connection
+ **/
+
+void authenticatorCloseRadsecConn(AuthenticatorRadsecConn *conn)
+{
+   //Valid TLS context?
+   if(conn->tlsContext != NULL)
+   {
+      //Send a close notify alert if the connection is open
+      if(conn->state == AUTHENTICATOR_RADSEC_STATE_OPEN)
+      {
+         tlsShutdown(conn->tlsContext);
+      }
+
+      //Release TLS context
+      tlsFree(conn->tlsContext);
+      conn->tlsContext = NULL;
+   }
+
+   //Valid socket?
+   if(conn->socket != NULL)
+   {
+      //Close the TCP socket
+      socketClose(conn->socket);
+      conn->socket = NULL;
+   }
+
+   //The connection is closed
+   conn->state = AUTHENTICATOR_RADSEC_STATE_CLOSED;
+   conn->timestamp = osGetSystemTime();
+   conn->rxLen = 0;
+   conn->rxPending = FALSE;
+}
+
+
+/**
+ * @brief Close all the TLS connections
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorCloseRadsecConns(AuthenticatorContext *context)
+{
+   uint_t i;
+   AuthenticatorRadsecConn *conn;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the TLS connection to the server
+      conn = &context->radsecConns[i];
+
+      //Acquire exclusive access to the connection
+      osAcquireMutex(&conn->mutex);
+
+      //Release the socket and the TLS context
+      authenticatorCloseRadsecConn(conn);
+
+      //The first connection attempt takes place immediately
+      conn->retryDelay = 0;
+      conn->backoff = 0;
+
+      //Release exclusive access to the connection
+      osReleaseMutex(&conn->mutex);
+   }
+}
+
+
+/**
+ * @brief Write a RADIUS packet to the TLS connection of a server
+ *
+ * A request that has already been written to the current connection is not
+ * written again, since the transport is reliable. It is only retransmitted
+ * once the connection has been reopened
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @param[in] data Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ * @param[in,out] connId Connection the packet has been written to (NULL if
+ *   the packet is not tracked)
+ * @return Error code
+ **/
+
+error_t authenticatorSendRadsecPacket(AuthenticatorContext *context,
+   uint_t serverIndex, const uint8_t *data, size_t length, uint_t *connId)
+{
+   error_t error;
+   size_t n;
+   AuthenticatorRadsecConn *conn;
+
+   //Point to the TLS connection to the server
+   conn = &context->radsecConns[serverIndex];
+
+   //Acquire exclusive access to the connection
+   osAcquireMutex(&conn->mutex);
+
+   //Check the state of the connection
+   if(conn->state != AUTHENTICATOR_RADSEC_STATE_OPEN)
+   {
+      //The request will be written once the connection is open
+      error = ERROR_NOT_CONNECTED;
+   }
+   else if(connId != NULL && *connId == conn->connId)
+   {
+      //The packet has already been written to this connection
+      error = NO_ERROR;
+   }
+   else
+   {
+      //Debug message
+      TRACE_INFO("Sending RADIUS packet over TLS (%" PRIuSIZE " bytes)...\r\n",
+         length);
+
+      //The RADIUS packets are sent back to back. The Length field of the
+      //RADIUS header delimits each packet in the stream
+      error = tlsWrite(conn->tlsContext, data, length, &n, 0);
+
+      //Check status code
+      if(!error && n == length)
+      {
+         //Save the connection the packet has been written to
+         if(connId != NULL)
+         {
+            *connId = conn->connId;
+         }
+      }
+      else
+      {
+         //A partially written packet would corrupt the stream. The socket
+         //is closed by the authenticator task
+         conn->state = AUTHENTICATOR_RADSEC_STATE_ERROR;
+         error = ERROR_WRITE_FAILED;
+      }
+   }
+
+   //Release exclusive access to the connection
+   osReleaseMutex(&conn->mutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Register the TLS connections with the socket event descriptors
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] eventDesc Socket event descriptors of the TLS connections
+ * @param[in] timeout Maximum time to wait for an event
+ * @return Maximum time to wait for an event, taking into account the data
+ *   that is already available
+ **/
+
+systime_t authenticatorSetRadsecEvents(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc, systime_t timeout)
+{
+   uint_t i;
+   AuthenticatorRadsecConn *conn;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the TLS connection to the server
+      conn = &context->radsecConns[i];
+
+      //The socket is only opened and closed by the authenticator task
+      if(conn->state == AUTHENTICATOR_RADSEC_STATE_CONNECTING)
+      {
+         //Wait for the three-way handshake to complete
+         eventDesc[i].socket = conn->socket;
+         eventDesc[i].eventMask = SOCKET_EVENT_CONNECTED | SOCKET_EVENT_CLOSED;
+      }
+      else if(conn->state == AUTHENTICATOR_RADSEC_STATE_HANDSHAKE ||
+         conn->state == AUTHENTICATOR_RADSEC_STATE_OPEN)
+      {
+         //Wait for incoming data
+         eventDesc[i].socket = conn->socket;
+         eventDesc[i].eventMask = SOCKET_EVENT_RX_READY;
+      }
+      else
+      {
+         //The connection is not polled
+         eventDesc[i].socket = NULL;
+         eventDesc[i].eventMask = 0;
+      }
+
+      //Clear event flags
+      eventDesc[i].eventFlags = 0;
+
+      //Data may already be buffered by the TLS layer
+      if(conn->rxPending)
+      {
+         timeout = 0;
+      }
+   }
+
+   //Return the maximum time to wait for an event
+   return timeout;
+}
+
+
+/**
+ * @brief Report the TLS connections that may have data available
+ *
+ * Data that has already been read from the socket by the TLS layer does not
+ * trigger any socket event
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in,out] eventDesc Socket event descriptors of the TLS connections
+ **/
+
+void authenticatorGetRadsecEvents(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc)
+{
+   uint_t i;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //More data may be available?
+      if(context->radsecConns[i].rxPending)
+      {
+         eventDesc[i].eventFlags |= SOCKET_EVENT_RX_READY;
+      }
+   }
+}
+
+
+/**
+ * @brief Process the events of a TLS connection
+ *
+ * The establishment of the connection proceeds as the socket events are
+ * received. Once the connection is open, one RADIUS packet is extracted
+ * from the stream and processed per call
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] serverIndex Zero-based index of the server entry
+ * @return Error code (an error is returned when no packet is available)
+ **/
+
+error_t authenticatorProcessRadsecEvent(AuthenticatorContext *context,
+   uint_t serverIndex)
+{
+   error_t error;
+   size_t n;
+   size_t length;
+   uint16_t port;
+   IpAddr ipAddr;
+   AuthenticatorRadsecConn *conn;
+
+   //Point to the TLS connection to the server
+   conn = &context->radsecConns[serverIndex];
+
+   //Initialize variables
+   length = 0;
+
+   //Acquire exclusive access to the connection
+   osAcquireMutex(&conn->mutex);
+
+   //Check the state of the connection
+   if(conn->state == AUTHENTICATOR_RADSEC_STATE_CONNECTING ||
+      conn->state == AUTHENTICATOR_RADSEC_STATE_HANDSHAKE)
+   {
+      //Make progress with the establishment of the connection
+      error = authenticatorContinueRadsecConn(context, serverIndex);
+
+      //Check status code
+      if(!error)
+      {
+         //Application data may follow the handshake
+         conn->rxPending = TRUE;
+         error = ERROR_WOULD_BLOCK;
+      }
+      else if(error != ERROR_WOULD_BLOCK)
+      {
+         //Debug message
+         TRACE_WARNING("RADIUS server %u: TLS handshake failed!\r\n",
+            serverIndex);
+
+         //Try again later
+         authenticatorFailRadsecConn(conn);
+      }
+      else
+      {
+         //The handshake is still in progress
+      }
+   }
+   else if(conn->state == AUTHENTICATOR_RADSEC_STATE_OPEN)
+   {
+      //Read data until a complete RADIUS packet is available
+      while(1)
+      {
+         //Complete RADIUS header received?
+         if(conn->rxLen >= sizeof(RadiusPacket))
+         {
+            //The Length field delimits the packet within the stream
+            length = LOAD16BE(conn->rxBuffer + 2);
+
+            //Malformed packet?
+            if(length < sizeof(RadiusPacket) || length > sizeof(conn->rxBuffer))
+            {
+               //The stream can no longer be parsed
+               error = ERROR_INVALID_LENGTH;
+               break;
+            }
+
+            //Complete packet received?
+            if(conn->rxLen >= length)
+            {
+               error = NO_ERROR;
+               break;
+            }
+         }
+
+         //Read as much data as possible
+         error = tlsRead(conn->tlsContext, conn->rxBuffer + conn->rxLen,
+            sizeof(conn->rxBuffer) - conn->rxLen, &n, 0);
+
+         //No more data available?
+         if(error == ERROR_TIMEOUT || error == ERROR_WOULD_BLOCK)
+         {
+            error = ERROR_WOULD_BLOCK;
+            break;
+         }
+
+         //Any error to report?
+         if(error)
+            break;
+
+         //Update the length of the reassembly buffer
+         conn->rxLen += n;
+      }
+
+      //Check status code
+      if(!error)
+      {
+         //Copy the packet to the receive buffer of the RADIUS path
+         osMemcpy(context->radiusRxBuffer, conn->rxBuffer, length);
+
+         //Remove the packet from the reassembly buffer
+         conn->rxLen -= length;
+         osMemmove(conn->rxBuffer, conn->rxBuffer + length, conn->rxLen);
+
+         //More packets may be available
+         conn->rxPending = TRUE;
+      }
+      else if(error == ERROR_WOULD_BLOCK)
+      {
+         //Wait for the next socket event
+         conn->rxPending = FALSE;
+      }
+      else
+      {
+         //Debug message
+         TRACE_WARNING("RADIUS server %u: TLS connection closed!\r\n",
+            serverIndex);
+
+         //Reconnect
+         authenticatorFailRadsecConn(conn);
+      }
+   }
+   else
+   {
+      //The connection is not in use
+      conn->rxPending = FALSE;
+      error = ERROR_WOULD_BLOCK;
+   }
+
+   //Save the address of the server
+   ipAddr = conn->ipAddr;
+   port = conn->port;
+
+   //Release exclusive access to the connection
+   osReleaseMutex(&conn->mutex);
+
+   //Any packet received?
+   if(!error)
+   {
+      //Debug message
+      TRACE_INFO("RADIUS packet received over TLS (%" PRIuSIZE " bytes)...\r\n",
+         length);
+
+      //The identifiers of the requests sent over TLS are drawn from the
+      //space of the first UDP socket
+      authenticatorAcceptRadiusPacket(context, 0, &ipAddr, port, length);
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file authenticator_radsec.h
+ * @brief RADIUS over TLS transport
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_RADSEC_H
+#define _AUTHENTICATOR_RADSEC_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//RADIUS over TLS
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+
+//Authenticator related functions
+void authenticatorTickRadsec(AuthenticatorContext *context);
+
+void authenticatorResetRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex);
+
+void authenticatorOpenRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex, const IpAddr *ipAddr, uint16_t port);
+
+error_t authenticatorContinueRadsecConn(AuthenticatorContext *context,
+   uint_t serverIndex);
+
+void authenticatorFailRadsecConn(AuthenticatorRadsecConn *conn);
+void authenticatorCloseRadsecConn(AuthenticatorRadsecConn *conn);
+void authenticatorCloseRadsecConns(AuthenticatorContext *context);
+
+error_t authenticatorSendRadsecPacket(AuthenticatorContext *context,
+   uint_t serverIndex, const uint8_t *data, size_t length, uint_t *connId);
+
+systime_t authenticatorSetRadsecEvents(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc, systime_t timeout);
+
+void authenticatorGetRadsecEvents(AuthenticatorContext *context,
+   SocketEventDesc *eventDesc);
+
+error_t authenticatorProcessRadsecEvent(AuthenticatorContext *context,
+   uint_t serverIndex);
+
+#else
+
+//Stub functions
+#define authenticatorTickRadsec(context)
+#define authenticatorResetRadsecConn(context, serverIndex)
+#define authenticatorCloseRadsecConns(context)
+
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file authenticator_random.c
+ * @brief Random data pool
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_random.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_RANDOM_POOL_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Refill the random data pool
+ *
+ * The pool is refilled in a single call to the PRNG once half of its content
+ * has been consumed, so that the fixed per-call overhead of the generator is
+ * spread over many Request Authenticators. The caller must hold the mutex of
+ * the 802.1X authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorRefillRandomPool(AuthenticatorContext *context)
+{
+   error_t error;
+   size_t n;
+
+   //Check whether the pool is running low
+   if(context->randomPoolLen <= (AUTHENTICATOR_RANDOM_POOL_SIZE / 2))
+   {
+      //Number of bytes to generate
+      n = AUTHENTICATOR_RANDOM_POOL_SIZE - context->randomPoolLen;
+
+      //Generate a new chunk of random data
+      error = context->prngAlgo->generate(context->prngContext,
+         context->randomPool + context->randomPoolLen, n);
+
+      //Check status code
+      if(!error)
+      {
+         //The pool is full
+         context->randomPoolLen = AUTHENTICATOR_RANDOM_POOL_SIZE;
+         //Number of successful refills
+         context->randomPoolRefills++;
+      }
+      else
+      {
+         //Discard the partially generated data
+         osMemset(context->randomPool + context->randomPoolLen, 0, n);
+
+         //The PRNG may need to be reseeded. Subsequent requests are served
+         //directly by the generator, which reports the error to the caller
+         if(context->randomPoolError == NO_ERROR)
+         {
+            //Debug message
+            TRACE_WARNING("Failed to refill the random data pool!\r\n");
+         }
+      }
+
+      //Save the status of the last refill
+      context->randomPoolError = error;
+   }
+}
+
+
+/**
+ * @brief Discard the content of the random data pool
+ *
+ * This function is called once the PRNG has been reseeded, so that the data
+ * generated from the previous state is no longer used. The caller must hold
+ * the mutex of the 802.1X authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorFlushRandomPool(AuthenticatorContext *context)
+{
+   //Erase the buffered random data
+   osMemset(context->randomPool, 0, AUTHENTICATOR_RANDOM_POOL_SIZE);
+   context->randomPoolLen = 0;
+
+   //The generator is expected to be operational again
+   context->randomPoolError = NO_ERROR;
+   //Number of times the PRNG has been reseeded
+   context->randomPoolReseeds++;
+}
+
+
+/**
+ * @brief Get random data
+ *
+ * The data is drawn from the pool when possible. Else it is directly generated
+ * by the PRNG. The pool is bypassed while the last refill has failed, so that
+ * the error of the generator is reported to the caller instead of serving the
+ * data buffered before the failure. The caller must hold the mutex of the
+ * 802.1X authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[out] output Buffer where to store the random data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+error_t authenticatorGetRandomData(AuthenticatorContext *context,
+   uint8_t *output, size_t length)
+{
+   error_t error;
+
+   //Enough random data available in the pool?
+   if(context->randomPoolError == NO_ERROR &&
+      context->randomPoolLen >= length)
+   {
+      //Data is consumed from the end of the pool
+      context->randomPoolLen -= length;
+
+      //Copy the random data
+      osMemcpy(output, context->randomPool + context->randomPoolLen, length);
+      //Each byte is only used once
+      osMemset(context->randomPool + context->randomPoolLen, 0, length);
+
+      //Successful processing
+      error = NO_ERROR;
+   }
+   else
+   {
+      //The pool is refilled by the periodic task. While the PRNG is failing,
+      //its error code is returned to the caller
+      error = context->prngAlgo->generate(context->prngContext, output,
+         length);
+   }
+
+   //Return status code
+   return error;
+}
+
+#endif
@@ -37,6 +37,10 @@
 #include "authenticator/authenticator_reauth_timer_fsm.h"
 #include "authenticator/authenticator_procedures.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_trace.h"
+#include "authenticator/authenticator_event.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
 
@@ -51,6 +55,51 @@ const EapParamName authenticatorReauthTimerStates[] =
 };
 
 
+//Global transition to the INITIALIZE state
+AUTHENTICATOR_FSM_CONDITION(authenticatorReauthTimerCondInitialize,
+   port->portControl != AUTHENTICATOR_PORT_MODE_AUTO || port->initialize ||
+   port->authPortStatus == AUTHENTICATOR_PORT_STATUS_UNAUTH ||
+   !port->reAuthEnabled)
+
+//When the reAuthWhen timer expires, the state machine will then
+//transition to the REAUTHENTICATE state
+AUTHENTICATOR_FSM_CONDITION(authenticatorReauthTimerCondReAuthWhen,
+   port->reAuthWhen == 0)
+
+//Global transitions
+static const AuthenticatorFsmTransition authenticatorReauthTimerGlobalTransitions[] =
+{
+   {authenticatorReauthTimerCondInitialize,
+      AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE}
+};
+
+//Exit conditions of the INITIALIZE state
+static const AuthenticatorFsmTransition authenticatorReauthTimerInitializeExits[] =
+{
+   {authenticatorReauthTimerCondReAuthWhen,
+      AUTHENTICATOR_REAUTH_TIMER_STATE_REAUTHENTICATE}
+};
+
+//Exit conditions of the REAUTHENTICATE state
+static const AuthenticatorFsmTransition authenticatorReauthTimerReauthenticateExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE}
+};
+
+//Exit conditions, listed in the order of the AuthenticatorReauthTimerState
+//values
+static const AuthenticatorFsmState authenticatorReauthTimerExits[] =
+{
+   AUTHENTICATOR_FSM_STATE(authenticatorReauthTimerInitializeExits),
+   AUTHENTICATOR_FSM_STATE(authenticatorReauthTimerReauthenticateExits)
+};
+
+//Transition table of the reauthentication timer state machine
+static const AuthenticatorFsmTable authenticatorReauthTimerFsmTable =
+   AUTHENTICATOR_FSM_TABLE(authenticatorReauthTimerGlobalTransitions,
+   authenticatorReauthTimerExits);
+
+
 /**
  * @brief Authenticator PAE state machine initialization
  * @param[in] port Pointer to the port context
@@ -70,50 +119,16 @@ void authenticatorReauthTimerInitFsm(AuthenticatorPort *port)
 
 void authenticatorReauthTimerFsm(AuthenticatorPort *port)
 {
-   //A global transition can occur from any of the possible states. When the
-   //condition associated with a global transition is met, it supersedes all
-   //other exit conditions
-   if(port->portControl != AUTHENTICATOR_PORT_MODE_AUTO || port->initialize ||
-      port->authPortStatus == AUTHENTICATOR_PORT_STATUS_UNAUTH ||
-      !port->reAuthEnabled)
+   uint_t newState;
+
+   //Evaluate the exit conditions of the current state (refer to IEEE Std
+   //802.1X-2004, section 8.2.1)
+   if(authenticatorEvalFsm(port, &authenticatorReauthTimerFsmTable,
+      port->reauthTimerState, &newState))
    {
-      //Switch to the INITIALIZE state
+      //Switch to the new state
       authenticatorReauthTimerChangeState(port,
-         AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE);
-   }
-   else
-   {
-      //All exit conditions for the state are evaluated continuously until one
-      //of the conditions is met (refer to IEEE Std 802.1X-2004, section 8.2.1)
-      switch(port->reauthTimerState)
-      {
-      //INITIALIZE state?
-      case AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE:
-         //When the reAuthWhen timer expires, the state machine will then
-         //transition to the REAUTHENTICATE state
-         if(port->reAuthWhen == 0)
-         {
-            //Switch to the REAUTHENTICATE state
-            authenticatorReauthTimerChangeState(port,
-               AUTHENTICATOR_REAUTH_TIMER_STATE_REAUTHENTICATE);
-         }
-
-         break;
-
-      //REAUTHENTICATE state?
-      case AUTHENTICATOR_REAUTH_TIMER_STATE_REAUTHENTICATE:
-         //Unconditional transition (UCT) to INITIALIZE state
-         authenticatorReauthTimerChangeState(port,
-            AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE);
-
-         break;
-
-      //Invalid state?
-      default:
-         //Just for sanity
-         authenticatorFsmError(port->context);
-         break;
-      }
+         (AuthenticatorReauthTimerState) newState);
    }
 }
 
@@ -136,12 +151,15 @@ void authenticatorReauthTimerChangeState(AuthenticatorPort *port,
    if(newState != oldState)
    {
       //Dump the state transition
-      TRACE_DEBUG("Port %" PRIu8 ": Reauthentication timer state machine %s -> %s\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": Reauthentication timer state machine %s -> %s\r\n",
          port->portIndex,
          eapGetParamName(oldState, authenticatorReauthTimerStates,
          arraysize(authenticatorReauthTimerStates)),
          eapGetParamName(newState, authenticatorReauthTimerStates,
          arraysize(authenticatorReauthTimerStates)));
+
+      //Record the state transition
+      authenticatorTraceStateChange(port, AUTHENTICATOR_TRACE_EVENT_REAUTH_TIMER_STATE, oldState, newState);
    }
 
    //Switch to the new state
@@ -153,15 +171,37 @@ void authenticatorReauthTimerChangeState(AuthenticatorPort *port,
    {
    //INITIALIZE state?
    case AUTHENTICATOR_REAUTH_TIMER_STATE_INITIALIZE:
-      //The reAuthWhen timer is set to its initial value
-      port->reAuthWhen = port->reAuthPeriod;
+      //A postponed reauthentication is attempted again after a shorter delay
+      if(port->reAuthDeferDelay > 0)
+      {
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+            port->reAuthDeferDelay);
+
+         //The delay has been consumed
+         port->reAuthDeferDelay = 0;
+      }
+      else
+      {
+         //The reAuthWhen timer is set to its initial value
+         authenticatorStartTimer(port, AUTHENTICATOR_TIMER_REAUTH_WHEN,
+            authenticatorGetReauthDelay(port));
+      }
+
       break;
 
    //REAUTHENTICATE state?
    case AUTHENTICATOR_REAUTH_TIMER_STATE_REAUTHENTICATE:
+      //The reauthentication is postponed as long as no RADIUS server can be
+      //reached, so that the session remains authorized
+      port->reAuthDeferDelay = authenticatorDeferReauth(port);
+
       //The reAuthenticate variable is set TRUE by the reauthentication timer
       //state machine on expiry of the reAuthWhen timer
-      port->reAuthenticate = TRUE;
+      if(port->reAuthDeferDelay == 0)
+      {
+         port->reAuthenticate = TRUE;
+      }
+
       break;
 
    //Invalid state?
@@ -176,8 +216,13 @@ void authenticatorReauthTimerChangeState(AuthenticatorPort *port,
       //Any registered callback?
       if(port->context->reauthTimerStateChangeCallback != NULL)
       {
-         //Invoke user callback function
-         port->context->reauthTimerStateChangeCallback(port, newState);
+         //The callback is either deferred or invoked synchronously
+         if(!authenticatorQueueEvent(port, AUTHENTICATOR_EVENT_REAUTH_TIMER_STATE,
+            newState))
+         {
+            //Invoke user callback function
+            port->context->reauthTimerStateChangeCallback(port, newState);
+         }
       }
    }
 
@@ -187,8 +232,247 @@ void authenticatorReauthTimerChangeState(AuthenticatorPort *port,
       !port->initialize && port->reAuthEnabled)
    {
       //The authenticator PAE state machine is busy
-      port->context->busy = TRUE;
+      port->busy = TRUE;
+   }
+}
+
+
+/**
+ * @brief Get the reauthentication period of a port
+ *
+ * The Session-Timeout attribute of the Access-Accept, when present, takes
+ * precedence over the reAuthPeriod parameter (refer to RFC 3580, section
+ * 3.17)
+ *
+ * @param[in] port Pointer to the port context
+ * @return Reauthentication period, in milliseconds
+ **/
+
+systime_t authenticatorGetReauthPeriod(AuthenticatorPort *port)
+{
+   systime_t period;
+
+   //Check whether the server has specified the length of the session
+   if(port->sessionTimeout > 0)
+   {
+      period = MIN(port->sessionTimeout, AUTHENTICATOR_MAX_REAUTH_PERIOD);
+      period = MAX(period, AUTHENTICATOR_MIN_REAUTH_PERIOD);
+   }
+   else
+   {
+      period = port->reAuthPeriod;
+   }
+
+   //Convert the period to milliseconds
+   return period * 1000;
+}
+
+
+/**
+ * @brief Get the initial value of the reAuthWhen timer
+ *
+ * The reauthentication is scheduled at a random time within the last
+ * reauthJitter percent of the period, so that the ports that authenticated
+ * together are progressively spread over the period
+ *
+ * @param[in] port Pointer to the port context
+ * @return Initial value of the reAuthWhen timer, in milliseconds
+ **/
+
+systime_t authenticatorGetReauthDelay(AuthenticatorPort *port)
+{
+   systime_t delay;
+   systime_t range;
+
+   //Retrieve the reauthentication period
+   delay = authenticatorGetReauthPeriod(port);
+   //Calculate the range over which the reauthentications are spread
+   range = (delay / 100) * port->context->reauthJitter;
+
+   //Any jitter to apply?
+   if(range > 0)
+   {
+      //The reauthentication never takes place later than the period
+      delay -= authenticatorGetReauthRandom(port->shard) % (range + 1);
    }
+
+   //Return the initial value of the timer
+   return delay;
+}
+
+
+/**
+ * @brief Check whether the reauthentication of a port must be postponed
+ *
+ * A reauthentication is postponed when the session is authorized and every
+ * RADIUS server is known to be dead
+ *
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the session is to remain authorized without being
+ *   reauthenticated, else FALSE
+ **/
+
+bool_t authenticatorCheckReauthDeferral(AuthenticatorPort *port)
+{
+   bool_t defer;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Only authorized sessions are concerned
+   if(port->portControl != AUTHENTICATOR_PORT_MODE_AUTO ||
+      port->authPortStatus != AUTHENTICATOR_PORT_STATUS_AUTH)
+   {
+      return FALSE;
+   }
+
+   //The policy and the server list are shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Check whether the outage is confirmed
+   defer = (context->reauthDeferral && authenticatorIsRadiusOutage(context)) ?
+      TRUE : FALSE;
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return TRUE if the reauthentication must be postponed
+   return defer;
+}
+
+
+/**
+ * @brief Decide whether a reauthentication can take place right now
+ *
+ * The reauthentication is postponed during a server outage. Once a server
+ * has recovered, the reauthentications that have been postponed are
+ * started at the configured rate
+ *
+ * @param[in] port Pointer to the port context
+ * @return Delay before the reauthentication is attempted again, in
+ *   milliseconds (0 if the reauthentication can take place right now)
+ **/
+
+systime_t authenticatorDeferReauth(AuthenticatorPort *port)
+{
+   bool_t allowed;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //No RADIUS server can be reached?
+   if(authenticatorCheckReauthDeferral(port))
+      return authenticatorPostponeReauth(port);
+
+   //The reauthentication has not been postponed before?
+   if(port->reAuthDeferrals == 0)
+      return 0;
+
+   //The drain rate is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Check whether the postponed reauthentication can be started
+   if(context->reauthDrainRate == 0)
+   {
+      //The rate is not limited
+      allowed = TRUE;
+   }
+   else if(context->reauthDrainTokens > 0)
+   {
+      //Consume one token
+      context->reauthDrainTokens--;
+      allowed = TRUE;
+   }
+   else
+   {
+      //The budget of the current tick has been exhausted
+      allowed = FALSE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The reauthentication can take place right now?
+   if(allowed)
+      return 0;
+
+   //Try again during one of the next ticks
+   return AUTHENTICATOR_TICK_INTERVAL + (authenticatorGetReauthRandom(
+      port->shard) % AUTHENTICATOR_TICK_INTERVAL);
+}
+
+
+/**
+ * @brief Postpone the reauthentication of a port
+ *
+ * The delay doubles with each consecutive attempt, up to
+ * AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY, and is randomized so that the
+ * ports do not reauthenticate together once a server has recovered
+ *
+ * @param[in] port Pointer to the port context
+ * @return Delay before the reauthentication is attempted again, in
+ *   milliseconds
+ **/
+
+systime_t authenticatorPostponeReauth(AuthenticatorPort *port)
+{
+   uint_t n;
+   systime_t delay;
+
+   //Debug message
+   TRACE_INFO("Port %" PRIu16 ": RADIUS servers unavailable, postponing "
+      "reauthentication...\r\n", port->portIndex);
+
+   //Number of reauthentications already postponed in a row
+   n = MIN(port->reAuthDeferrals, 16);
+
+   //Exponential backoff
+   delay = (systime_t) AUTHENTICATOR_REAUTH_DEFER_MIN_DELAY << n;
+   delay = MIN(delay, AUTHENTICATOR_REAUTH_DEFER_MAX_DELAY);
+   //Convert the delay to milliseconds
+   delay *= 1000;
+
+   //The actual delay is chosen in the upper half of the interval
+   delay -= authenticatorGetReauthRandom(port->shard) % (delay / 2 + 1);
+
+   //Update the number of consecutive deferrals
+   port->reAuthDeferrals++;
+   //Update statistics
+   port->data->stats.reauthDeferrals++;
+
+   //Return the delay before the next attempt
+   return delay;
+}
+
+
+/**
+ * @brief Draw a random value used to spread the reauthentications
+ *
+ * The generator is owned by the shard, so that no lock is needed
+ *
+ * @param[in] shard Pointer to the shard the port belongs to
+ * @return Pseudo-random value
+ **/
+
+uint32_t authenticatorGetReauthRandom(AuthenticatorShard *shard)
+{
+   uint32_t value;
+
+   //Retrieve the state of the generator
+   value = shard->reauthSeed;
+
+   //Xorshift generator
+   value ^= value << 13;
+   value ^= value >> 17;
+   value ^= value << 5;
+
+   //Save the state of the generator
+   shard->reauthSeed = value;
+
+   //Return the pseudo-random value
+   return value;
 }
 
 #endif
@@ -57,6 +57,15 @@ void authenticatorReauthTimerFsm(AuthenticatorPort *port);
 void authenticatorReauthTimerChangeState(AuthenticatorPort *port,
    AuthenticatorReauthTimerState newState);
 
+systime_t authenticatorGetReauthPeriod(AuthenticatorPort *port);
+systime_t authenticatorGetReauthDelay(AuthenticatorPort *port);
+
+bool_t authenticatorCheckReauthDeferral(AuthenticatorPort *port);
+systime_t authenticatorDeferReauth(AuthenticatorPort *port);
+systime_t authenticatorPostponeReauth(AuthenticatorPort *port);
+
+uint32_t authenticatorGetReauthRandom(AuthenticatorShard *shard);
+
 //C++ guard
 #ifdef __cplusplus
 }
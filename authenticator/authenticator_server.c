@@ -0,0 +1,1073 @@
+/**
+ * @file authenticator_server.c
+ * @brief RADIUS server pool management
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_shard.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_radsec.h"
+#include "authenticator/authenticator_random.h"
+#include "radius/radius.h"
+#include "radius/radius_attributes.h"
+#include "radius/radius_debug.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Select the RADIUS server to be used by a new session
+ *
+ * The session is assigned to one of the live servers having the lowest
+ * priority value. Servers of the same priority are selected in proportion
+ * to their weight (smooth weighted round-robin). Servers that have reached
+ * their session limit are skipped as long as another live server can take
+ * the session. When every server is dead, the configured servers are tried
+ * anyway
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorSelectRadiusServer(AuthenticatorPort *port)
+{
+   uint_t i;
+   uint_t j;
+   uint_t index;
+   uint_t priority;
+   int_t totalWeight;
+   bool_t live;
+   bool_t limit;
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //Initialize variables
+   index = port->aaaServerIndex;
+   server = NULL;
+
+   //The server list is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //A session that fails over no longer counts against its previous server
+   authenticatorUnbindRadiusServer(port);
+
+   //Live servers that have not reached their session limit are preferred.
+   //If there is none, the limits are ignored, and dead servers are only
+   //considered as a last resort
+   for(j = 0; j < 3 && server == NULL; j++)
+   {
+      //Enforce the session limits during the first pass only
+      limit = (j == 0) ? TRUE : FALSE;
+      //Consider dead servers during the last pass only
+      live = (j < 2) ? TRUE : FALSE;
+
+      //Initialize variables
+      priority = UINT_MAX;
+      totalWeight = 0;
+
+      //Determine the lowest priority value among the candidate servers
+      for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+      {
+         //Candidate server?
+         if(authenticatorIsCandidateServer(&context->servers[i], live, limit))
+         {
+            priority = MIN(priority, context->servers[i].priority);
+         }
+      }
+
+      //Loop through the candidate servers of the selected priority
+      for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+      {
+         //Candidate server?
+         if(authenticatorIsCandidateServer(&context->servers[i], live, limit) &&
+            context->servers[i].priority == priority)
+         {
+            //Each server earns credit in proportion to its weight
+            context->servers[i].credit += context->servers[i].weight;
+            totalWeight += context->servers[i].weight;
+
+            //Select the server with the highest credit
+            if(server == NULL || context->servers[i].credit > server->credit)
+            {
+               server = &context->servers[i];
+               index = i;
+            }
+         }
+      }
+   }
+
+   //Any server selected?
+   if(server != NULL)
+   {
+      //The selected server gives back the credit earned by all candidates
+      server->credit -= totalWeight;
+
+      //The session counts against the selected server
+      server->numSessions++;
+      port->aaaServerBound = TRUE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The NAS-IP-Address attribute depends on the route to the server
+   if(index != port->aaaServerIndex)
+   {
+      authenticatorInvalidateRadiusTemplate(port);
+   }
+
+   //Assign the session to the server
+   port->aaaServerIndex = index;
+}
+
+
+/**
+ * @brief Check whether a RADIUS server can be assigned new sessions
+ * @param[in] server Pointer to the RADIUS server entry
+ * @param[in] live Only consider servers that are not known to be dead
+ * @param[in] limit Only consider servers that have not reached their session
+ *   limit
+ * @return TRUE if the server is a candidate, else FALSE
+ **/
+
+bool_t authenticatorIsCandidateServer(const AuthenticatorRadiusServer *server,
+   bool_t live, bool_t limit)
+{
+   //The entry must be in use
+   if(!server->enabled)
+      return FALSE;
+
+   //Dead servers are excluded if requested
+   if(live && server->dead)
+      return FALSE;
+
+   //Servers that have reached their session limit are excluded if requested
+   if(limit && server->maxSessions != 0 &&
+      server->numSessions >= server->maxSessions)
+   {
+      return FALSE;
+   }
+
+   //The server is a candidate
+   return TRUE;
+}
+
+
+/**
+ * @brief Check whether any RADIUS server is believed to be reachable
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return TRUE if at least one configured server is not known to be dead
+ **/
+
+bool_t authenticatorIsRadiusReachable(AuthenticatorContext *context)
+{
+   uint_t i;
+   bool_t reachable;
+
+   //Initialize flag
+   reachable = FALSE;
+
+   //The server list is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //Loop through the RADIUS servers
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS && !reachable; i++)
+   {
+      //Live server?
+      if(authenticatorIsCandidateServer(&context->servers[i], TRUE, FALSE))
+      {
+         reachable = TRUE;
+      }
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Return TRUE if at least one server is reachable
+   return reachable;
+}
+
+
+/**
+ * @brief Check whether all the RADIUS servers are known to be dead
+ *
+ * The caller is responsible for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return TRUE if at least one server is configured and every configured
+ *   server has been declared dead, else FALSE
+ **/
+
+bool_t authenticatorIsRadiusOutage(AuthenticatorContext *context)
+{
+   uint_t i;
+   bool_t outage;
+
+   //Initialize flag
+   outage = FALSE;
+
+   //Loop through the RADIUS servers
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Configured server?
+      if(context->servers[i].enabled)
+      {
+         //A single live server is enough to end the outage
+         if(!context->servers[i].dead)
+            return FALSE;
+
+         //The server has been declared dead
+         outage = TRUE;
+      }
+   }
+
+   //Return TRUE if no configured server is reachable
+   return outage;
+}
+
+
+/**
+ * @brief Stop counting the session of the port against its RADIUS server
+ *
+ * The caller is responsible for holding the global mutex
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUnbindRadiusServer(AuthenticatorPort *port)
+{
+   AuthenticatorRadiusServer *server;
+
+   //Is the session counted against a server?
+   if(port->aaaServerBound)
+   {
+      //Point to the RADIUS server the session is assigned to
+      server = &port->context->servers[port->aaaServerIndex];
+
+      //Update the number of sessions assigned to the server
+      if(server->numSessions > 0)
+      {
+         server->numSessions--;
+      }
+
+      //The session is no longer counted
+      port->aaaServerBound = FALSE;
+   }
+}
+
+
+/**
+ * @brief Search the server list for a given IP address and port number
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] ipAddr IP address of the RADIUS server
+ * @param[in] port Port number of the RADIUS server
+ * @return Pointer to the matching server entry, if any
+ **/
+
+AuthenticatorRadiusServer *authenticatorFindRadiusServer(
+   AuthenticatorContext *context, const IpAddr *ipAddr, uint16_t port)
+{
+   uint_t i;
+   AuthenticatorRadiusServer *server;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the current entry
+      server = &context->servers[i];
+
+      //Matching entry?
+      if(server->enabled && server->port == port &&
+         ipCompAddr(&server->ipAddr, ipAddr))
+      {
+         return server;
+      }
+   }
+
+   //No matching entry
+   return NULL;
+}
+
+
+/**
+ * @brief Report a RADIUS request that has not been answered
+ *
+ * A server that fails to answer a configurable number of consecutive
+ * requests is declared dead. The pending sessions of the server that belong
+ * to the same shard are aborted so that they can be restarted on another
+ * server. The sessions of the other shards time out on their own
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorRadiusServerTimeout(AuthenticatorPort *port)
+{
+   uint_t i;
+   bool_t dead;
+   AuthenticatorPort *otherPort;
+   AuthenticatorShard *shard;
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the shard the port belongs to
+   shard = port->shard;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //The server list is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //The server is already known to be dead?
+   if(server->dead)
+   {
+      //Nothing to do
+      dead = FALSE;
+   }
+   else
+   {
+      //Increment the number of consecutive timeouts
+      server->failures++;
+
+      //Check whether the threshold has been reached
+      if(server->failures >= AUTHENTICATOR_RADIUS_MAX_FAILURES)
+      {
+         //The server is no longer selected for new sessions
+         server->dead = TRUE;
+         //Status-Server probes are sent once the hold-down time has elapsed
+         server->holdDownTimer = AUTHENTICATOR_RADIUS_DEAD_TIME;
+      }
+
+      //The server has just been declared dead?
+      dead = server->dead;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Check whether the server has been declared dead
+   if(dead)
+   {
+      //Debug message
+      TRACE_WARNING("RADIUS server %u is not responding!\r\n",
+         port->aaaServerIndex);
+
+      //Loop through the ports and the additional sessions of the shard
+      for(i = 0; i < (shard->numPorts + shard->numHosts); i++)
+      {
+         //Point to the current port
+         otherPort = authenticatorGetShardPort(shard, i);
+
+         //Any request pending on the same server?
+         if(otherPort != port &&
+            otherPort->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE &&
+            otherPort->aaaServerIndex == port->aaaServerIndex &&
+            !otherPort->aaaTimeout)
+         {
+            //There is no point in waiting for a response
+            otherPort->aaaTimeout = TRUE;
+            //The event will be processed by the state machines of the port
+            authenticatorSchedulePort(otherPort);
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Manage the hold-down timers of the dead RADIUS servers
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorTickRadiusServers(AuthenticatorContext *context)
+{
+   uint_t i;
+   AuthenticatorRadiusServer *server;
+
+   //Loop through the server list
+   for(i = 0; i < AUTHENTICATOR_MAX_RADIUS_SERVERS; i++)
+   {
+      //Point to the current entry
+      server = &context->servers[i];
+
+      //Dead server?
+      if(server->enabled && server->dead)
+      {
+         //Decrement the hold-down timer
+         if(server->holdDownTimer > 0)
+         {
+            server->holdDownTimer--;
+         }
+
+         //Timer expired?
+         if(server->holdDownTimer == 0)
+         {
+            //Outstanding probe?
+            if(server->probePending)
+            {
+               //The probe has not been answered
+               authenticatorCancelStatusServer(context, server);
+               //Restart the hold-down timer
+               server->holdDownTimer = AUTHENTICATOR_RADIUS_DEAD_TIME;
+            }
+            else
+            {
+               //Check whether the server is alive
+               authenticatorSendStatusServer(context, server);
+               //Wait for the response
+               server->holdDownTimer = AUTHENTICATOR_RADIUS_TIMEOUT;
+            }
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Reset the round-trip time estimator of a RADIUS server
+ * @param[in] server RADIUS server entry
+ **/
+
+void authenticatorResetRadiusRtt(AuthenticatorRadiusServer *server)
+{
+   //Until a round-trip time measurement has been made, the retransmission
+   //timeout is set to its default value
+   server->srtt = 0;
+   server->rttVar = 0;
+   server->rto = MIN(AUTHENTICATOR_RADIUS_TIMEOUT * 1000,
+      AUTHENTICATOR_RADIUS_MAX_RTO);
+   server->rto = MAX(server->rto, AUTHENTICATOR_RADIUS_MIN_RTO);
+}
+
+
+/**
+ * @brief Update the round-trip time estimator of a RADIUS server
+ *
+ * The smoothed round-trip time and its variation are maintained as specified
+ * in RFC 6298, section 2
+ *
+ * @param[in] server RADIUS server entry
+ * @param[in] rtt Round-trip time measurement, in milliseconds
+ **/
+
+void authenticatorUpdateRadiusRtt(AuthenticatorRadiusServer *server,
+   systime_t rtt)
+{
+   systime_t delta;
+
+   //First measurement?
+   if(server->srtt == 0)
+   {
+      //Initialize SRTT and RTTVAR
+      server->srtt = MAX(rtt, 1);
+      server->rttVar = rtt / 2;
+   }
+   else
+   {
+      //Compute the absolute difference between SRTT and the measurement
+      delta = (server->srtt > rtt) ? server->srtt - rtt : rtt - server->srtt;
+
+      //RTTVAR <- (1 - beta) * RTTVAR + beta * |SRTT - R'| (beta = 1/4)
+      server->rttVar = (3 * server->rttVar + delta) / 4;
+      //SRTT <- (1 - alpha) * SRTT + alpha * R' (alpha = 1/8)
+      server->srtt = MAX((7 * server->srtt + rtt) / 8, 1);
+   }
+
+   //RTO <- SRTT + max (G, K*RTTVAR) (K = 4)
+   server->rto = server->srtt + MAX(AUTHENTICATOR_TIMER_RESOLUTION,
+      4 * server->rttVar);
+
+   //Clamp the retransmission timeout
+   server->rto = MAX(server->rto, AUTHENTICATOR_RADIUS_MIN_RTO);
+   server->rto = MIN(server->rto, AUTHENTICATOR_RADIUS_MAX_RTO);
+}
+
+
+/**
+ * @brief Reset the window of a RADIUS server
+ * @param[in] server RADIUS server entry
+ **/
+
+void authenticatorResetRadiusWindow(AuthenticatorRadiusServer *server)
+{
+   //Start with a small number of outstanding requests. The requests that are
+   //already outstanding are still accounted for
+   server->window = AUTHENTICATOR_RADIUS_INIT_WINDOW;
+   server->windowCredit = 0;
+   server->windowTimestamp = osGetSystemTime();
+}
+
+
+/**
+ * @brief Reserve room in the window of the RADIUS server
+ *
+ * The number of outstanding requests per server is bounded by a window. A
+ * request that does not fit in the window is appended to the send queue of
+ * the server and is sent as soon as room is made
+ *
+ * @param[in] port Pointer to the port context
+ * @return TRUE if the request can be sent immediately, FALSE if it has been
+ *   queued
+ **/
+
+bool_t authenticatorAcquireRadiusSlot(AuthenticatorPort *port)
+{
+   bool_t acquired;
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //The server list is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //The request already counts against the window?
+   if(port->aaaInflight)
+   {
+      //The previous request has been superseded
+      acquired = TRUE;
+   }
+   else if(port->aaaQueued)
+   {
+      //The request keeps its position in the send queue
+      acquired = FALSE;
+   }
+   else if(server->sendQueueHead == NULL && server->inflight < server->window)
+   {
+      //The request fits in the window
+      server->inflight++;
+      port->aaaInflight = TRUE;
+      acquired = TRUE;
+   }
+   else
+   {
+      //Append the port to the send queue. Requests are sent in the order in
+      //which they became ready
+      port->nextQueuedPort = NULL;
+      port->aaaQueued = TRUE;
+
+      if(server->sendQueueTail != NULL)
+      {
+         server->sendQueueTail->nextQueuedPort = port;
+      }
+      else
+      {
+         server->sendQueueHead = port;
+      }
+
+      server->sendQueueTail = port;
+      acquired = FALSE;
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //The retransmission timer of the previous request may still be running.
+   //It must not hold the queued request back once room has been made
+   if(!acquired)
+   {
+      authenticatorStopTimer(port, AUTHENTICATOR_TIMER_AAA_RETRANS_TIMER);
+   }
+
+   //Return TRUE if the request can be sent immediately
+   return acquired;
+}
+
+
+/**
+ * @brief Release the room held by the request of the port
+ *
+ * The request is removed from the send queue if it has not been sent yet.
+ * Otherwise, the room is handed over to the queued requests. The caller is
+ * responsible for holding the global mutex
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorReleaseRadiusSlot(AuthenticatorPort *port)
+{
+   AuthenticatorPort *p;
+   AuthenticatorRadiusServer *server;
+
+   //Point to the RADIUS server the session is assigned to
+   server = &port->context->servers[port->aaaServerIndex];
+
+   //Is the request waiting in the send queue?
+   if(port->aaaQueued)
+   {
+      //Unlink the port from the send queue
+      if(server->sendQueueHead == port)
+      {
+         server->sendQueueHead = port->nextQueuedPort;
+         p = NULL;
+      }
+      else
+      {
+         //Search the send queue for the preceding port
+         p = server->sendQueueHead;
+
+         //Loop through the send queue
+         while(p != NULL && p->nextQueuedPort != port)
+         {
+            p = p->nextQueuedPort;
+         }
+
+         //Found?
+         if(p != NULL)
+         {
+            p->nextQueuedPort = port->nextQueuedPort;
+         }
+      }
+
+      //Update the tail of the send queue
+      if(server->sendQueueTail == port)
+      {
+         server->sendQueueTail = p;
+      }
+
+      //The port is no longer queued
+      port->nextQueuedPort = NULL;
+      port->aaaQueued = FALSE;
+   }
+   else if(port->aaaInflight)
+   {
+      //The request no longer counts against the window
+      if(server->inflight > 0)
+      {
+         server->inflight--;
+      }
+
+      port->aaaInflight = FALSE;
+
+      //Queued requests may now be sent
+      authenticatorGrantRadiusSlots(port->context, server, port->shard);
+   }
+   else
+   {
+      //Just for sanity
+   }
+}
+
+
+/**
+ * @brief Hand the room available in the window over to the queued requests
+ *
+ * The ports of the specified shard are scheduled directly. The ports of
+ * other shards are picked up by the task that owns them. The caller is
+ * responsible for holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ * @param[in] shard Shard owned by the calling task (NULL if none)
+ **/
+
+void authenticatorGrantRadiusSlots(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, AuthenticatorShard *shard)
+{
+   AuthenticatorPort *port;
+
+   //Send as many queued requests as the window allows
+   while(server->sendQueueHead != NULL && server->inflight < server->window)
+   {
+      //Remove the first port from the send queue
+      port = server->sendQueueHead;
+      server->sendQueueHead = port->nextQueuedPort;
+
+      //Last port of the queue?
+      if(server->sendQueueHead == NULL)
+      {
+         server->sendQueueTail = NULL;
+      }
+
+      //The request now counts against the window
+      port->nextQueuedPort = NULL;
+      port->aaaQueued = FALSE;
+      port->aaaInflight = TRUE;
+      server->inflight++;
+
+      //Check whether the port belongs to the calling task
+      if(port->shard == shard)
+      {
+         //The request will be sent by the state machines of the port
+         authenticatorSchedulePort(port);
+      }
+      else
+      {
+         //The shard will schedule the port on its own
+         port->shard->sendRetry = TRUE;
+         osSetEvent(&port->shard->event);
+      }
+   }
+}
+
+
+/**
+ * @brief Open the window of a RADIUS server upon receipt of a response
+ *
+ * The window grows by one request each time a full window of requests has
+ * been answered (additive increase). It shrinks by one request when the
+ * round-trip time rises well above its smoothed value, which indicates
+ * that the server is queuing requests. The caller is responsible for
+ * holding the global mutex
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ * @param[in] rtt Round-trip time measurement, in milliseconds
+ **/
+
+void authenticatorUpdateRadiusWindow(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, systime_t rtt)
+{
+   //The server is slowing down?
+   if(server->srtt != 0 && rtt > server->srtt + 4 * server->rttVar &&
+      rtt > 2 * server->srtt)
+   {
+      //Shrink the window
+      if(server->window > 1)
+      {
+         server->window--;
+      }
+
+      //Start counting again
+      server->windowCredit = 0;
+   }
+   else
+   {
+      //Count the responses received with the current window
+      server->windowCredit++;
+
+      //A full window of requests has been answered?
+      if(server->windowCredit >= server->window)
+      {
+         //Grow the window
+         if(server->window < AUTHENTICATOR_RADIUS_MAX_WINDOW)
+         {
+            server->window++;
+         }
+
+         //Start counting again
+         server->windowCredit = 0;
+      }
+   }
+
+   //Queued requests may benefit from a larger window. The port that
+   //received the response releases its own room right afterwards
+   authenticatorGrantRadiusSlots(context, server, NULL);
+}
+
+
+/**
+ * @brief Close the window of a RADIUS server upon loss of a request
+ *
+ * The window is halved (multiplicative decrease). Requests that were first
+ * sent before the last decrease do not shrink the window again, so that a
+ * burst of losses is only accounted for once
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorRadiusWindowLoss(AuthenticatorPort *port)
+{
+   AuthenticatorContext *context;
+   AuthenticatorRadiusServer *server;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the RADIUS server the session is assigned to
+   server = &context->servers[port->aaaServerIndex];
+
+   //The server list is shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //The request was sent after the last decrease?
+   if(timeCompare(port->aaaReqTimestamp, server->windowTimestamp) >= 0)
+   {
+      //Halve the window
+      server->window = MAX(server->window / 2, 1);
+      server->windowCredit = 0;
+
+      //Save the time at which the window was decreased
+      server->windowTimestamp = osGetSystemTime();
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+
+/**
+ * @brief Calculate the retransmission timeout of a RADIUS request
+ *
+ * The first transmission uses the timeout of the server. Each retransmission
+ * doubles the previous timeout, up to an upper bound. A random factor of up
+ * to +/-10% is added so that the retransmissions of the ports do not
+ * synchronize (refer to RFC 5080, section 2.2.1)
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUpdateRadiusRto(AuthenticatorPort *port)
+{
+   error_t error;
+   systime_t rto;
+   uint8_t value;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+
+   //The server list and the PRNG are shared by all the shards
+   osAcquireMutex(&context->mutex);
+
+   //First transmission of the request?
+   if(port->aaaRetransCount == 0)
+   {
+      //RT = IRT + RAND * IRT
+      rto = context->servers[port->aaaServerIndex].rto;
+   }
+   else
+   {
+      //RT = 2 * RTprev + RAND * RTprev
+      rto = MIN(2 * port->aaaRto, AUTHENTICATOR_RADIUS_MAX_RTO);
+   }
+
+   //Generate a random value
+   error = authenticatorGetRandomData(context, &value, 1);
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Check status code
+   if(!error)
+   {
+      //RAND is a random number picked uniformly between -0.1 and +0.1
+      rto = rto + (rto * value) / 1275 - rto / 10;
+   }
+
+   //Save the retransmission timeout
+   port->aaaRto = MAX(rto, AUTHENTICATOR_RADIUS_MIN_RTO);
+}
+
+
+/**
+ * @brief Send Status-Server packet
+ *
+ * Status-Server packets are used to query the status of a RADIUS server
+ * without triggering an authentication (refer to RFC 5997, section 2). The
+ * caller must hold the mutex of the 802.1X authenticator context
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ * @return Error code
+ **/
+
+error_t authenticatorSendStatusServer(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server)
+{
+   error_t error;
+   size_t n;
+   uint_t index;
+   SocketMsg msg;
+   RadiusPacket *packet;
+   uint8_t buffer[sizeof(RadiusPacket) + sizeof(RadiusAttribute) +
+      MD5_DIGEST_SIZE];
+
+   //The Request Authenticator field must contain a random value (refer to
+   //RFC 5997, section 3)
+   error = authenticatorGetRandomData(context, server->probeAuthenticator, 16);
+   //Any error to report?
+   if(error)
+      return error;
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   //The probes sent over TLS use the Identifier space of the first socket
+   if(server->transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+   {
+      index = authenticatorAllocRadiusIndex(context, 1);
+   }
+   else
+#endif
+   {
+      //Select a free (socket, Identifier) pair
+      index = authenticatorAllocRadiusIndex(context,
+         AUTHENTICATOR_NUM_RADIUS_SOCKETS);
+   }
+
+   //Save the identifier value
+   server->probeIndex = index;
+   server->probePending = TRUE;
+
+   //Point to the buffer where to format the RADIUS packet
+   packet = (RadiusPacket *) buffer;
+
+   //Format RADIUS packet
+   packet->code = RADIUS_CODE_STATUS_SERVER;
+   packet->identifier = index % 256;
+   packet->length = htons(sizeof(RadiusPacket));
+   osMemcpy(packet->authenticator, server->probeAuthenticator, 16);
+
+   //Status-Server packets must include a Message-Authenticator attribute
+   //(refer to RFC 5997, section 3)
+   osMemset(buffer + sizeof(RadiusPacket) + sizeof(RadiusAttribute), 0,
+      MD5_DIGEST_SIZE);
+
+   //Add Message-Authenticator attribute
+   radiusAddAttribute(packet, RADIUS_ATTR_MESSAGE_AUTHENTICATOR,
+      buffer + sizeof(RadiusPacket) + sizeof(RadiusAttribute),
+      MD5_DIGEST_SIZE);
+
+   //Retrieve the total length of the RADIUS packet
+   n = htons(packet->length);
+
+   //Calculate the HMAC-MD5 hash of the entire packet
+   authenticatorHmacInit(&context->md5Context, server);
+   md5Update(&context->md5Context, buffer, n);
+   authenticatorHmacFinal(&context->md5Context, server,
+      buffer + n - MD5_DIGEST_SIZE);
+
+   //Dump RADIUS header contents for debugging purpose
+   radiusDumpPacket(packet, n);
+
+#if (AUTHENTICATOR_RADSEC_SUPPORT == ENABLED)
+   //RADIUS over TLS?
+   if(server->transport == AUTHENTICATOR_RADIUS_TRANSPORT_TLS)
+   {
+      //The probe also checks that the connection is still usable
+      error = authenticatorSendRadsecPacket(context,
+         server - context->servers, buffer, n, NULL);
+   }
+   else
+#endif
+   {
+      //Format the UDP datagram
+      msg = SOCKET_DEFAULT_MSG;
+      msg.data = buffer;
+      msg.length = n;
+      msg.destIpAddr = server->ipAddr;
+      msg.destPort = server->port;
+
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+      //Specify the egress port
+      msg.switchPort = context->serverPortIndex;
+#endif
+
+      //Debug message
+      TRACE_INFO("Sending RADIUS packet (%" PRIuSIZE " bytes)...\r\n", n);
+
+      //Send UDP datagram
+      error = socketSendMsg(context->serverSocket[index / 256], &msg, 0);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Process the response to a Status-Server packet
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ * @param[in] packet Pointer to the received RADIUS packet
+ **/
+
+void authenticatorProcessStatusServerResponse(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, const RadiusPacket *packet)
+{
+   error_t error;
+
+   //A server supporting Status-Server responds with an Access-Accept (refer
+   //to RFC 5997, section 4.1)
+   if(packet->code != RADIUS_CODE_ACCESS_ACCEPT)
+      return;
+
+   //Validate the attributes and locate them in a single pass
+   error = radiusParseAttributes(packet, &context->radiusAttrIndex);
+   //Malformed attributes?
+   if(error)
+      return;
+
+   //Verify the Response Authenticator and the Message-Authenticator
+   error = authenticatorCheckRadiusResponse(context, &context->md5Context,
+      server, packet, &context->radiusAttrIndex, server->probeAuthenticator);
+   //Invalid packet?
+   if(error)
+      return;
+
+   //Debug message
+   TRACE_INFO("RADIUS server is alive\r\n");
+
+   //Release the identifier used by the probe
+   authenticatorCancelStatusServer(context, server);
+
+   //The server can be selected again for new sessions
+   server->dead = FALSE;
+   server->failures = 0;
+   server->holdDownTimer = 0;
+   server->credit = 0;
+
+   //Network conditions may have changed while the server was dead
+   authenticatorResetRadiusRtt(server);
+   authenticatorResetRadiusWindow(server);
+}
+
+
+/**
+ * @brief Cancel the outstanding Status-Server probe, if any
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] server RADIUS server entry
+ **/
+
+void authenticatorCancelStatusServer(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server)
+{
+   //Outstanding probe?
+   if(server->probePending)
+   {
+      //The identifier can be reused by subsequent requests
+      authenticatorReleaseRadiusIndex(context, server->probeIndex);
+      //The probe is no longer pending
+      server->probePending = FALSE;
+   }
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file authenticator_server.h
+ * @brief RADIUS server pool management
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_SERVER_H
+#define _AUTHENTICATOR_SERVER_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Authenticator related functions
+void authenticatorSelectRadiusServer(AuthenticatorPort *port);
+
+bool_t authenticatorIsCandidateServer(const AuthenticatorRadiusServer *server,
+   bool_t live, bool_t limit);
+
+bool_t authenticatorIsRadiusReachable(AuthenticatorContext *context);
+bool_t authenticatorIsRadiusOutage(AuthenticatorContext *context);
+
+void authenticatorUnbindRadiusServer(AuthenticatorPort *port);
+
+AuthenticatorRadiusServer *authenticatorFindRadiusServer(
+   AuthenticatorContext *context, const IpAddr *ipAddr, uint16_t port);
+
+void authenticatorRadiusServerTimeout(AuthenticatorPort *port);
+void authenticatorTickRadiusServers(AuthenticatorContext *context);
+
+void authenticatorResetRadiusRtt(AuthenticatorRadiusServer *server);
+
+void authenticatorUpdateRadiusRtt(AuthenticatorRadiusServer *server,
+   systime_t rtt);
+
+void authenticatorResetRadiusWindow(AuthenticatorRadiusServer *server);
+
+bool_t authenticatorAcquireRadiusSlot(AuthenticatorPort *port);
+void authenticatorReleaseRadiusSlot(AuthenticatorPort *port);
+
+void authenticatorGrantRadiusSlots(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, AuthenticatorShard *shard);
+
+void authenticatorUpdateRadiusWindow(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, systime_t rtt);
+
+void authenticatorRadiusWindowLoss(AuthenticatorPort *port);
+
+void authenticatorUpdateRadiusRto(AuthenticatorPort *port);
+
+error_t authenticatorSendStatusServer(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server);
+
+void authenticatorProcessStatusServerResponse(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server, const RadiusPacket *packet);
+
+void authenticatorCancelStatusServer(AuthenticatorContext *context,
+   AuthenticatorRadiusServer *server);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,659 @@
+/**
+ * @file authenticator_shard.c
+ * @brief Port sharding
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_buffer.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_shard.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+//The shard tasks require an RTOS
+#if (AUTHENTICATOR_NUM_SHARDS > 1 && NET_RTOS_SUPPORT == DISABLED)
+   #error AUTHENTICATOR_NUM_SHARDS parameter is not valid
+#endif
+
+
+/**
+ * @brief Split the ports into shards
+ *
+ * Each shard is assigned a contiguous range of ports. All the ports of a
+ * shard are handled by the same task
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorInitShards(AuthenticatorContext *context)
+{
+   error_t error;
+   uint_t i;
+   uint_t j;
+   AuthenticatorShard *shard;
+
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      //Point to the current shard
+      shard = &context->shards[i];
+
+      //Attach authenticator context to each shard
+      shard->context = context;
+      //Set shard index
+      shard->index = i;
+      shard->taskId = OS_INVALID_TASK_ID;
+
+      //The ports are evenly distributed among the shards
+      shard->firstPort = (i * context->numPorts) / AUTHENTICATOR_NUM_SHARDS;
+      shard->numPorts = ((i + 1) * context->numPorts) /
+         AUTHENTICATOR_NUM_SHARDS - shard->firstPort;
+
+      //Timer deadlines are relative to the current slot of the timer wheel
+      shard->timerTimestamp = osGetSystemTime();
+
+      //Seed the generator used to spread reauthentications
+      error = context->prngAlgo->generate(context->prngContext,
+         (uint8_t *) &shard->reauthSeed, sizeof(uint32_t));
+
+      //The state of the generator must not be zero
+      if(error || shard->reauthSeed == 0)
+      {
+         shard->reauthSeed = i + 1;
+      }
+
+      //Attach the ports to the shard
+      for(j = 0; j < shard->numPorts; j++)
+      {
+         context->ports[shard->firstPort + j].shard = shard;
+      }
+
+      //The additional sessions are distributed in the same way. A session
+      //is only bound to the ports of the shard it belongs to
+      shard->firstHost = (i * context->numHosts) / AUTHENTICATOR_NUM_SHARDS;
+      shard->numHosts = ((i + 1) * context->numHosts) /
+         AUTHENTICATOR_NUM_SHARDS - shard->firstHost;
+
+      //Attach the additional sessions to the shard
+      for(j = 0; j < shard->numHosts; j++)
+      {
+         context->hosts[shard->firstHost + j].shard = shard;
+      }
+   }
+}
+
+
+/**
+ * @brief Get the port or additional session that matches a given index
+ *
+ * The ports of the shard come first, followed by its additional sessions
+ *
+ * @param[in] shard Pointer to the shard
+ * @param[in] index Zero-based index, in the range 0 to numPorts + numHosts - 1
+ * @return Pointer to the port context
+ **/
+
+AuthenticatorPort *authenticatorGetShardPort(AuthenticatorShard *shard,
+   uint_t index)
+{
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = shard->context;
+
+   //Return a pointer to the relevant port context
+   if(index < shard->numPorts)
+   {
+      return &context->ports[shard->firstPort + index];
+   }
+   else
+   {
+      return &context->hosts[shard->firstHost + index - shard->numPorts];
+   }
+}
+
+
+/**
+ * @brief Acquire exclusive access to all the ports
+ *
+ * The mutexes of the shards are always acquired in ascending order. The
+ * mutex of the 802.1X authenticator context, which protects the state shared
+ * by the shards, must be acquired last
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorLock(AuthenticatorContext *context)
+{
+   uint_t i;
+
+   //Acquire exclusive access to the ports of each shard
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      osAcquireMutex(&context->shards[i].mutex);
+   }
+}
+
+
+/**
+ * @brief Release exclusive access to all the ports
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorUnlock(AuthenticatorContext *context)
+{
+   uint_t i;
+
+   //Release exclusive access to the ports of each shard
+   for(i = AUTHENTICATOR_NUM_SHARDS; i > 0; i--)
+   {
+      osReleaseMutex(&context->shards[i - 1].mutex);
+   }
+}
+
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+
+/**
+ * @brief Queue a received frame for processing by the shard of a port
+ * @param[in] port Pointer to the destination port
+ * @param[in] server RADIUS server the packet comes from (NULL for EAPOL PDUs)
+ * @param[in] index (socket, Identifier) pair of the RADIUS packet
+ * @param[in] srcMacAddr Source MAC address of the EAPOL PDU
+ * @param[in] rxBuffer Receive buffer holding the EAPOL PDU. EAPOL PDUs are
+ *   not copied, the buffer being owned by the port until it is released
+ * @param[in] data Pointer to the RADIUS packet
+ * @param[in] length Length of the frame, in bytes
+ **/
+
+static void authenticatorQueueFrame(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, uint_t index, const MacAddr *srcMacAddr,
+   AuthenticatorRxBuffer *rxBuffer, const uint8_t *data, size_t length)
+{
+   AuthenticatorFrame *frame;
+   AuthenticatorShard *shard;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = port->context;
+   //Point to the shard the port belongs to
+   shard = port->shard;
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+
+   //Make sure the queue is not full
+   if(shard->numFrames < AUTHENTICATOR_SHARD_QUEUE_SIZE)
+   {
+      //Point to the first free slot
+      frame = &shard->frames[(shard->frameHead + shard->numFrames) %
+         AUTHENTICATOR_SHARD_QUEUE_SIZE];
+
+      //Copy the frame
+      frame->port = port;
+      frame->server = server;
+      frame->index = index;
+      frame->srcMacAddr = (srcMacAddr != NULL) ? *srcMacAddr : MAC_UNSPECIFIED_ADDR;
+      frame->rxBuffer = rxBuffer;
+      frame->length = length;
+
+      //RADIUS packets are received in a single buffer
+      if(rxBuffer == NULL)
+      {
+         osMemcpy(frame->data, data, length);
+      }
+
+      //The frame is now queued
+      shard->numFrames++;
+
+      //Wake up the shard task
+      osSetEvent(&shard->event);
+   }
+   else
+   {
+      //Debug message
+      TRACE_WARNING("Shard %u: Frame queue is full!\r\n", shard->index);
+
+      //The EAPOL PDU is dropped
+      if(rxBuffer != NULL)
+      {
+         rxBuffer->owner = NULL;
+      }
+   }
+
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+}
+
+#endif
+
+
+/**
+ * @brief Hand a received EAPOL PDU over to the shard of a port
+ *
+ * When the ports are not sharded, the PDU is processed immediately. The
+ * caller must then hold the mutex of the shard
+ *
+ * @param[in] port Pointer to the destination port
+ * @param[in] srcMacAddr Source MAC address
+ * @param[in] buffer Receive buffer holding the EAPOL PDU
+ * @param[in] length Length of the EAPOL PDU, in bytes
+ **/
+
+void authenticatorDispatchEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, AuthenticatorRxBuffer *buffer, size_t length)
+{
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   //The PDU will be processed by the shard task
+   authenticatorQueueFrame(port, NULL, 0, srcMacAddr, buffer, NULL, length);
+#else
+   //Process the EAPOL PDU immediately
+   authenticatorProcessPortEapolPdu(port, srcMacAddr, buffer, length);
+#endif
+}
+
+
+/**
+ * @brief Hand a received RADIUS packet over to the shard of a port
+ *
+ * When the ports are not sharded, the packet is processed immediately. The
+ * caller must then hold the mutex of the shard
+ *
+ * @param[in] port Pointer to the port that issued the request
+ * @param[in] server RADIUS server the packet comes from
+ * @param[in] index (socket, Identifier) pair of the packet
+ * @param[in] data Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ **/
+
+void authenticatorDispatchRadiusPacket(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, uint_t index, const uint8_t *data,
+   size_t length)
+{
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   //The packet will be processed by the shard task
+   authenticatorQueueFrame(port, server, index, NULL, NULL, data, length);
+#else
+   //Process the RADIUS packet immediately
+   authenticatorProcessRadiusResponse(port, server, index,
+      (const RadiusPacket *) data);
+#endif
+}
+
+
+/**
+ * @brief Process the pending events of a shard
+ *
+ * The state machines of the ports are evaluated once all the pending events
+ * have been taken into account. The caller must hold the mutex of the shard
+ *
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorProcessShardEvents(AuthenticatorShard *shard)
+{
+   uint_t i;
+   bool_t retry;
+   bool_t sendRetry;
+   systime_t time;
+   AuthenticatorPort *port;
+   AuthenticatorContext *context;
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   uint_t n;
+   AuthenticatorFrame *frame;
+#endif
+
+   //Point to the 802.1X authenticator context
+   context = shard->context;
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+   //Retrieve the number of frames queued by the reception task
+   n = shard->numFrames;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Process the queued frames
+   for(i = 0; i < n; i++)
+   {
+      //Point to the current frame
+      frame = &shard->frames[(shard->frameHead + i) %
+         AUTHENTICATOR_SHARD_QUEUE_SIZE];
+
+      //Check the type of the frame
+      if(frame->rxBuffer != NULL)
+      {
+         //Process incoming EAPOL PDU
+         authenticatorProcessPortEapolPdu(frame->port, &frame->srcMacAddr,
+            frame->rxBuffer, frame->length);
+      }
+      else
+      {
+         //Process incoming RADIUS packet
+         authenticatorProcessRadiusResponse(frame->port, frame->server,
+            frame->index, (const RadiusPacket *) frame->data);
+      }
+
+   }
+
+   //Any frame processed?
+   if(n > 0)
+   {
+      //Acquire exclusive access to the shared state
+      osAcquireMutex(&context->mutex);
+      //Release the slots
+      shard->frameHead = (shard->frameHead + n) % AUTHENTICATOR_SHARD_QUEUE_SIZE;
+      shard->numFrames -= n;
+      //Release exclusive access to the shared state
+      osReleaseMutex(&context->mutex);
+   }
+#endif
+
+   //Process the timers that have expired
+   authenticatorProcessTimers(shard);
+
+   //Acquire exclusive access to the shared state
+   osAcquireMutex(&context->mutex);
+   //Check whether a session buffer has been released by another shard
+   retry = shard->bufferRetry;
+   shard->bufferRetry = FALSE;
+   //Check whether queued RADIUS requests have been granted room
+   sendRetry = shard->sendRetry;
+   shard->sendRetry = FALSE;
+   //Release exclusive access to the shared state
+   osReleaseMutex(&context->mutex);
+
+   //Schedule the ports whose queued RADIUS request can now be sent
+   for(i = 0; sendRetry && i < (shard->numPorts + shard->numHosts); i++)
+   {
+      //Point to the current port
+      port = authenticatorGetShardPort(shard, i);
+
+      //The request counts against the window but has not been sent yet?
+      if(port->aaaInflight && port->aaaRetransCount == 0 &&
+         port->eapFullAuthState == EAP_FULL_AUTH_STATE_AAA_IDLE)
+      {
+         authenticatorSchedulePort(port);
+      }
+   }
+
+   //Serve the ports that are waiting for a session buffer
+   for(i = 0; retry && i < (shard->numPorts + shard->numHosts); i++)
+   {
+      //Point to the current port
+      port = authenticatorGetShardPort(shard, i);
+
+      //Is the port waiting for a session buffer? Only the ports a session
+      //buffer has been granted to are expected to succeed
+      if(port->bufferWait && authenticatorAllocPortBuffer(port))
+      {
+         //The deferred restart can now proceed
+         port->eapRestart = TRUE;
+         authenticatorSchedulePort(port);
+      }
+   }
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Periodic operations are performed once per tick
+   if((time - shard->timestamp) >= AUTHENTICATOR_TICK_INTERVAL)
+   {
+      //Handle periodic operations
+      authenticatorShardTick(shard);
+      //Save current time
+      shard->timestamp = time;
+   }
+
+   //Update the state machines of the ports that have pending events
+   authenticatorRunFsm(shard);
+}
+
+
+/**
+ * @brief Handle periodic operations of a shard
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorShardTick(AuthenticatorShard *shard)
+{
+   uint_t i;
+   AuthenticatorPort *port;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = shard->context;
+
+   //Link state changes may be reported by the driver. Otherwise the link
+   //state of the ports is polled
+   if(!context->linkChangeNotification)
+   {
+      authenticatorPollLinkState(shard);
+   }
+
+   //Loop through the ports and the additional sessions of the shard
+   for(i = 0; i < (shard->numPorts + shard->numHosts); i++)
+   {
+      //Point to the current port
+      port = authenticatorGetShardPort(shard, i);
+
+      //Check whether the port is up
+      if(port->portEnabled)
+      {
+         //Duration of the session in seconds
+         port->data->sessionStats.sessionTime++;
+         //Publish the new session statistics
+         authenticatorUpdatePortSnapshot(port);
+      }
+   }
+
+   //Update the state machines of the ports that have pending events
+   authenticatorRunFsm(shard);
+}
+
+
+/**
+ * @brief Get the time remaining before the next event of a shard
+ * @param[in] shard Pointer to the shard
+ * @param[in] timeout Maximum value to be returned, in milliseconds
+ * @return Time remaining before the next tick or timer expiry, in
+ *   milliseconds
+ **/
+
+systime_t authenticatorGetShardTimeout(AuthenticatorShard *shard,
+   systime_t timeout)
+{
+   systime_t time;
+
+   //Acquire exclusive access to the ports of the shard
+   osAcquireMutex(&shard->mutex);
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Wake up for the next tick
+   if((time - shard->timestamp) < AUTHENTICATOR_TICK_INTERVAL)
+   {
+      timeout = MIN(timeout, shard->timestamp + AUTHENTICATOR_TICK_INTERVAL -
+         time);
+   }
+   else
+   {
+      timeout = 0;
+   }
+
+   //Wake up when the nearest timer expires
+   timeout = authenticatorGetTimerTimeout(shard, timeout);
+
+   //Release exclusive access to the ports of the shard
+   osReleaseMutex(&shard->mutex);
+
+   //Return the time remaining before the next event
+   return timeout;
+}
+
+
+/**
+ * @brief Start the shard tasks
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @return Error code
+ **/
+
+error_t authenticatorStartShards(AuthenticatorContext *context)
+{
+   error_t error;
+   uint_t i;
+   AuthenticatorShard *shard;
+
+   //Initialize status code
+   error = NO_ERROR;
+
+   //Loop through the shards
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      //Point to the current shard
+      shard = &context->shards[i];
+
+      //Save current time
+      shard->timestamp = osGetSystemTime();
+      shard->timerTimestamp = shard->timestamp;
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+      //Start the shard
+      shard->running = TRUE;
+
+      //Create a task
+      shard->taskId = osCreateTask("Authenticator Shard",
+         (OsTaskCode) authenticatorShardTask, shard, &context->taskParams);
+
+      //Failed to create task?
+      if(shard->taskId == OS_INVALID_TASK_ID)
+      {
+         //Report an error
+         shard->running = FALSE;
+         error = ERROR_OUT_OF_RESOURCES;
+         break;
+      }
+#endif
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Wait for the shard tasks to terminate
+ *
+ * The stop flag of the 802.1X authenticator context must be set before
+ * calling this function
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ **/
+
+void authenticatorStopShards(AuthenticatorContext *context)
+{
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+   uint_t i;
+
+   //Send a signal to each shard task
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      osSetEvent(&context->shards[i].event);
+   }
+
+   //Wait for the shard tasks to terminate
+   for(i = 0; i < AUTHENTICATOR_NUM_SHARDS; i++)
+   {
+      while(context->shards[i].running)
+      {
+         osDelayTask(1);
+      }
+   }
+#endif
+}
+
+
+#if (AUTHENTICATOR_NUM_SHARDS > 1)
+
+/**
+ * @brief Shard task
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorShardTask(AuthenticatorShard *shard)
+{
+   systime_t timeout;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = shard->context;
+
+   //Task prologue
+   osEnterTask();
+
+   //Process events
+   while(1)
+   {
+      //Wake up for the next tick or when the nearest timer expires
+      timeout = authenticatorGetShardTimeout(shard, INFINITE_DELAY);
+
+      //Wait for an event
+      osWaitForEvent(&shard->event, timeout);
+
+      //Stop request?
+      if(context->stop)
+      {
+         //Stop shard operation
+         shard->running = FALSE;
+         //Task epilogue
+         osExitTask();
+         //Kill ourselves
+         osDeleteTask(OS_SELF_TASK_ID);
+      }
+
+      //Acquire exclusive access to the ports of the shard
+      osAcquireMutex(&shard->mutex);
+      //Process the pending events of the shard
+      authenticatorProcessShardEvents(shard);
+      //Release exclusive access to the ports of the shard
+      osReleaseMutex(&shard->mutex);
+   }
+}
+
+#endif
+#endif
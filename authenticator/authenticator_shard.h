@@ -0,0 +1,74 @@
+/**
+ * @file authenticator_shard.h
+ * @brief Port sharding
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_SHARD_H
+#define _AUTHENTICATOR_SHARD_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Authenticator related functions
+void authenticatorInitShards(AuthenticatorContext *context);
+
+AuthenticatorPort *authenticatorGetShardPort(AuthenticatorShard *shard,
+   uint_t index);
+
+void authenticatorLock(AuthenticatorContext *context);
+void authenticatorUnlock(AuthenticatorContext *context);
+
+void authenticatorDispatchEapolPdu(AuthenticatorPort *port,
+   const MacAddr *srcMacAddr, AuthenticatorRxBuffer *buffer, size_t length);
+
+void authenticatorDispatchRadiusPacket(AuthenticatorPort *port,
+   AuthenticatorRadiusServer *server, uint_t index, const uint8_t *data,
+   size_t length);
+
+void authenticatorProcessShardEvents(AuthenticatorShard *shard);
+void authenticatorShardTick(AuthenticatorShard *shard);
+
+systime_t authenticatorGetShardTimeout(AuthenticatorShard *shard,
+   systime_t timeout);
+
+error_t authenticatorStartShards(AuthenticatorContext *context);
+void authenticatorStopShards(AuthenticatorContext *context);
+
+void authenticatorShardTask(AuthenticatorShard *shard);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file authenticator_stream.c
+ * @brief Session event stream
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_stream.h"
+#include "authenticator/authenticator_host.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED && AUTHENTICATOR_SESSION_STREAM_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Report the changes of the authorization state of a session
+ *
+ * The caller must hold the mutex of the shard the port belongs to
+ *
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorUpdateSessionStream(AuthenticatorPort *port)
+{
+   AuthenticatorTerminateCause cause;
+
+   //Check whether the authorization state has changed
+   if(port->authPortStatus == AUTHENTICATOR_PORT_STATUS_AUTH &&
+      !port->data->streamAuthorized)
+   {
+      //The supplicant has been authorized
+      authenticatorWriteSessionEvent(port,
+         AUTHENTICATOR_SESSION_EVENT_AUTHORIZED);
+
+      //Start measuring the duration of the session
+      port->data->streamAuthorized = TRUE;
+      port->data->streamAuthTime = osGetSystemTime();
+   }
+   else if(port->authPortStatus != AUTHENTICATOR_PORT_STATUS_AUTH &&
+      port->data->streamAuthorized)
+   {
+      //Retrieve the cause of the termination of the session
+      cause = port->data->sessionStats.sessionTerminateCause;
+
+      //Report the end of the session
+      if(cause == AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_LOGOFF)
+      {
+         authenticatorWriteSessionEvent(port,
+            AUTHENTICATOR_SESSION_EVENT_LOGOFF);
+      }
+      else
+      {
+         authenticatorWriteSessionEvent(port,
+            AUTHENTICATOR_SESSION_EVENT_TERMINATED);
+      }
+
+      //The session is over
+      port->data->streamAuthorized = FALSE;
+   }
+   else
+   {
+      //No change
+   }
+}
+
+
+/**
+ * @brief Write an event to the session event stream
+ *
+ * Each shard owns a single-producer single-consumer ring. The producers are
+ * serialized by the mutex of the shard, whereas the reader does not take any
+ * lock. When the ring is full, the event is discarded and counted
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] type Event type
+ **/
+
+void authenticatorWriteSessionEvent(AuthenticatorPort *port,
+   AuthenticatorSessionEventType type)
+{
+   uint_t head;
+   systime_t time;
+   AuthenticatorShard *shard;
+   AuthenticatorSessionEvent *event;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+   //Only the producer updates the head of the ring
+   head = shard->streamHead;
+
+   //Make sure the ring is not full
+   if((head - shard->streamTail) >= AUTHENTICATOR_SESSION_STREAM_SIZE)
+   {
+      //The event is discarded
+      shard->streamOverflows++;
+      return;
+   }
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Point to the free entry
+   event = &shard->streamEvents[head &
+      (AUTHENTICATOR_SESSION_STREAM_SIZE - 1)];
+
+   //Format the event
+   event->type = type;
+   event->portIndex = authenticatorGetPhysicalPort(port)->portIndex;
+   event->supplicantMacAddr = port->supplicantMacAddr;
+   event->terminateCause = port->data->sessionStats.sessionTerminateCause;
+   event->timestamp = time;
+
+   //The duration is only meaningful when the session ends
+   if(port->data->streamAuthorized &&
+      type != AUTHENTICATOR_SESSION_EVENT_AUTHORIZED)
+   {
+      event->duration = (time - port->data->streamAuthTime) / 1000;
+   }
+   else
+   {
+      event->duration = 0;
+   }
+
+   //The contents of the entry must be visible before the entry is published
+   AUTHENTICATOR_MEMORY_BARRIER();
+   shard->streamHead = head + 1;
+}
+
+
+/**
+ * @brief Read events from the session event stream of a shard
+ *
+ * This function must be called from a single task. It does not take the mutex
+ * of the shard
+ *
+ * @param[in] shard Pointer to the shard
+ * @param[out] events Buffer where to copy the events
+ * @param[in] maxEvents Maximum number of events to read
+ * @return Number of events read
+ **/
+
+uint_t authenticatorReadSessionStream(AuthenticatorShard *shard,
+   AuthenticatorSessionEvent *events, uint_t maxEvents)
+{
+   uint_t n;
+   uint_t head;
+   uint_t tail;
+
+   //Only the reader updates the tail of the ring
+   tail = shard->streamTail;
+   head = shard->streamHead;
+
+   //The entries must not be read before the head has been loaded
+   AUTHENTICATOR_MEMORY_BARRIER();
+
+   //Copy the published events
+   for(n = 0; n < maxEvents && tail != head; n++, tail++)
+   {
+      events[n] = shard->streamEvents[tail &
+         (AUTHENTICATOR_SESSION_STREAM_SIZE - 1)];
+   }
+
+   //The entries must have been copied before they are released
+   AUTHENTICATOR_MEMORY_BARRIER();
+   shard->streamTail = tail;
+
+   //Return the number of events read
+   return n;
+}
+
+#endif
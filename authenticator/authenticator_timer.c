@@ -0,0 +1,395 @@
+/**
+ * @file authenticator_timer.c
+ * @brief Timer management
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_fsm.h"
+#include "authenticator/authenticator_timer.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Initialize the timers of a given port
+ * @param[in] port Pointer to the port context
+ **/
+
+void authenticatorInitTimers(AuthenticatorPort *port)
+{
+   uint_t i;
+
+   //Stop all the timers of the port
+   for(i = 0; i < AUTHENTICATOR_NUM_TIMERS; i++)
+   {
+      //Make sure the timer is no longer present in the timer wheel
+      if(port->timers[i].port != NULL)
+      {
+         authenticatorStopTimer(port, (AuthenticatorTimerId) i);
+      }
+   }
+
+   //Bind each timer to the corresponding state machine variable
+   port->timers[AUTHENTICATOR_TIMER_A_WHILE].value = &port->aWhile;
+   port->timers[AUTHENTICATOR_TIMER_QUIET_WHILE].value = &port->quietWhile;
+   port->timers[AUTHENTICATOR_TIMER_REAUTH_WHEN].value = &port->reAuthWhen;
+   port->timers[AUTHENTICATOR_TIMER_RETRANS_WHILE].value = &port->retransWhile;
+   port->timers[AUTHENTICATOR_TIMER_AAA_RETRANS_TIMER].value = &port->aaaRetransTimer;
+
+   //Initialize timers
+   for(i = 0; i < AUTHENTICATOR_NUM_TIMERS; i++)
+   {
+      port->timers[i].port = port;
+      port->timers[i].running = FALSE;
+      port->timers[i].expiry = 0;
+      port->timers[i].prev = NULL;
+      port->timers[i].next = NULL;
+
+      //The timer is not running
+      *port->timers[i].value = 0;
+   }
+}
+
+
+/**
+ * @brief Start a timer
+ *
+ * The timer variable keeps a non-zero value as long as the timer is running.
+ * When the timer expires, the variable is reset to zero and the port is
+ * scheduled for state machine evaluation
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] id Timer identifier
+ * @param[in] delay Initial value of the timer, in milliseconds
+ **/
+
+void authenticatorStartTimer(AuthenticatorPort *port, AuthenticatorTimerId id,
+   systime_t delay)
+{
+   uint_t slot;
+   systime_t time;
+   AuthenticatorTimer *timer;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+   //Point to the relevant timer
+   timer = &port->timers[id];
+
+   //Stop the timer if it is already running
+   authenticatorStopTimer(port, id);
+
+   //Set the initial value of the timer
+   *timer->value = delay;
+
+   //A timer initialized with a zero value has already expired
+   if(delay > 0)
+   {
+      //Get current time
+      time = osGetSystemTime();
+
+      //The deadline is rounded up to the end of a slot of the timer wheel.
+      //Slots are counted from the last processed one, so that the wheel is
+      //not affected by the wrap-around of the system time
+      timer->expiry = shard->timerTicks + 1 + (time - shard->timerTimestamp +
+         delay - 1) / AUTHENTICATOR_TIMER_RESOLUTION;
+
+      //Timers are hashed by expiry time into the slots of the timer wheel
+      slot = timer->expiry % AUTHENTICATOR_TIMER_WHEEL_SIZE;
+
+      //Insert the timer at the head of the slot
+      timer->prev = NULL;
+      timer->next = shard->timerWheel[slot];
+
+      if(timer->next != NULL)
+      {
+         timer->next->prev = timer;
+      }
+
+      shard->timerWheel[slot] = timer;
+
+      //The timer is now running
+      timer->running = TRUE;
+   }
+}
+
+
+/**
+ * @brief Stop a timer
+ * @param[in] port Pointer to the port context
+ * @param[in] id Timer identifier
+ **/
+
+void authenticatorStopTimer(AuthenticatorPort *port, AuthenticatorTimerId id)
+{
+   uint_t slot;
+   AuthenticatorTimer *timer;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+   //Point to the relevant timer
+   timer = &port->timers[id];
+
+   //Check whether the timer is running
+   if(timer->running)
+   {
+      //Retrieve the slot the timer belongs to
+      slot = timer->expiry % AUTHENTICATOR_TIMER_WHEEL_SIZE;
+
+      //Remove the timer from the timer wheel
+      if(timer->prev != NULL)
+      {
+         timer->prev->next = timer->next;
+      }
+      else
+      {
+         shard->timerWheel[slot] = timer->next;
+      }
+
+      if(timer->next != NULL)
+      {
+         timer->next->prev = timer->prev;
+      }
+
+      timer->prev = NULL;
+      timer->next = NULL;
+
+      //The timer is no longer running
+      timer->running = FALSE;
+   }
+
+   //Reset the timer variable
+   *timer->value = 0;
+}
+
+
+/**
+ * @brief Get the time remaining before a timer expires
+ *
+ * The timer variable holds the initial value of the timer. The remaining
+ * time is derived from the slot of the timer wheel the timer belongs to
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] id Timer identifier
+ * @return Time remaining before the timer expires, in milliseconds (0 if the
+ *   timer is not running)
+ **/
+
+systime_t authenticatorGetTimerRemaining(AuthenticatorPort *port,
+   AuthenticatorTimerId id)
+{
+   systime_t time;
+   systime_t elapsed;
+   systime_t remaining;
+   AuthenticatorTimer *timer;
+   AuthenticatorShard *shard;
+
+   //Point to the shard the port belongs to
+   shard = port->shard;
+   //Point to the relevant timer
+   timer = &port->timers[id];
+
+   //Check whether the timer is running
+   if(timer->running)
+   {
+      //Get current time
+      time = osGetSystemTime();
+      //Time elapsed since the current slot was entered
+      elapsed = time - shard->timerTimestamp;
+
+      //The timer expires at the end of its slot
+      remaining = (timer->expiry - shard->timerTicks) *
+         AUTHENTICATOR_TIMER_RESOLUTION;
+
+      //A running timer has not expired yet
+      if(remaining > elapsed)
+      {
+         remaining -= elapsed;
+      }
+      else
+      {
+         remaining = 1;
+      }
+   }
+   else
+   {
+      //The timer is not running
+      remaining = 0;
+   }
+
+   //Return the remaining time
+   return remaining;
+}
+
+
+/**
+ * @brief Process the slots of the timer wheel that have elapsed
+ *
+ * Each slot of the timer wheel spans AUTHENTICATOR_TIMER_RESOLUTION
+ * milliseconds. Expired timers are removed from the wheel and the ports they
+ * belong to are scheduled for state machine evaluation
+ *
+ * @param[in] shard Pointer to the shard
+ **/
+
+void authenticatorProcessTimers(AuthenticatorShard *shard)
+{
+   uint_t slot;
+   systime_t time;
+   AuthenticatorTimer *timer;
+   AuthenticatorTimer *next;
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Loop through the slots that have elapsed since the last call
+   while((time - shard->timerTimestamp) >= AUTHENTICATOR_TIMER_RESOLUTION)
+   {
+      //Move to the next slot
+      shard->timerTimestamp += AUTHENTICATOR_TIMER_RESOLUTION;
+      shard->timerTicks++;
+
+      //Point to the slot that corresponds to the current tick
+      slot = shard->timerTicks % AUTHENTICATOR_TIMER_WHEEL_SIZE;
+
+      //Loop through the timers of the slot
+      for(timer = shard->timerWheel[slot]; timer != NULL; timer = next)
+      {
+         //Save the pointer to the next timer
+         next = timer->next;
+
+         //Timers that expire in a later revolution of the wheel are left
+         //untouched
+         if(timer->expiry == shard->timerTicks)
+         {
+            //Remove the timer from the timer wheel
+            if(timer->prev != NULL)
+            {
+               timer->prev->next = timer->next;
+            }
+            else
+            {
+               shard->timerWheel[slot] = timer->next;
+            }
+
+            if(timer->next != NULL)
+            {
+               timer->next->prev = timer->prev;
+            }
+
+            timer->prev = NULL;
+            timer->next = NULL;
+            timer->running = FALSE;
+
+            //The timer has expired
+            *timer->value = 0;
+
+            //The state machines of the port must be evaluated
+            authenticatorSchedulePort(timer->port);
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Get the time remaining before the next timer expires
+ *
+ * Only the slots that elapse within the specified time are examined, which
+ * bounds the cost of the search
+ *
+ * @param[in] shard Pointer to the shard
+ * @param[in] timeout Maximum value to be returned, in milliseconds
+ * @return Time remaining before the nearest deadline, in milliseconds
+ **/
+
+systime_t authenticatorGetTimerTimeout(AuthenticatorShard *shard,
+   systime_t timeout)
+{
+   uint_t i;
+   uint_t n;
+   uint_t tick;
+   systime_t time;
+   systime_t elapsed;
+   AuthenticatorTimer *timer;
+
+   //Get current time
+   time = osGetSystemTime();
+   //Time elapsed since the current slot was entered
+   elapsed = time - shard->timerTimestamp;
+
+   //Number of slots to examine
+   n = (elapsed + timeout) / AUTHENTICATOR_TIMER_RESOLUTION;
+   n = MIN(n, AUTHENTICATOR_TIMER_WHEEL_SIZE);
+
+   //Loop through the upcoming slots
+   for(i = 1; i <= n; i++)
+   {
+      //Tick count of the slot
+      tick = shard->timerTicks + i;
+
+      //Search the slot for a timer expiring during this revolution
+      for(timer = shard->timerWheel[tick % AUTHENTICATOR_TIMER_WHEEL_SIZE];
+         timer != NULL; timer = timer->next)
+      {
+         //Matching timer?
+         if(timer->expiry == tick)
+            break;
+      }
+
+      //The nearest deadline is the end of the slot
+      if(timer != NULL)
+      {
+         //Any slot that has already elapsed must be processed immediately
+         if((i * AUTHENTICATOR_TIMER_RESOLUTION) > elapsed)
+         {
+            timeout = MIN(timeout, i * AUTHENTICATOR_TIMER_RESOLUTION -
+               elapsed);
+         }
+         else
+         {
+            timeout = 0;
+         }
+
+         //We are done
+         break;
+      }
+   }
+
+   //Return the time remaining before the nearest deadline
+   return timeout;
+}
+
+#endif
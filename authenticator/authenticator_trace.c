@@ -0,0 +1,193 @@
+/**
+ * @file authenticator_trace.c
+ * @brief Binary trace ring
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL AUTHENTICATOR_TRACE_LEVEL
+
+//Dependencies
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_trace.h"
+#include "radius/radius.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Allocate a new record in the trace ring of a port
+ *
+ * The oldest record is overwritten when the ring is full
+ *
+ * @param[in] port Pointer to the port context
+ * @param[in] event Trace event
+ * @param[in] length Length of the PDU or packet, in bytes
+ * @return Pointer to the record
+ **/
+
+AuthenticatorTraceRecord *authenticatorAddTraceRecord(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, size_t length)
+{
+   AuthenticatorTraceRecord *record;
+
+   //Point to the next record
+   record = &port->data->traceRing[port->data->traceCount %
+      AUTHENTICATOR_TRACE_RING_SIZE];
+
+   //Clear the record
+   osMemset(record, 0, sizeof(AuthenticatorTraceRecord));
+
+   //Format the common fields
+   record->timestamp = (uint32_t) osGetSystemTime();
+   record->portIndex = (uint16_t) port->portIndex;
+   record->length = (uint16_t) MIN(length, 0xFFFF);
+   record->event = (uint8_t) event;
+
+   //One more record has been written
+   port->data->traceCount++;
+
+   //Return a pointer to the record
+   return record;
+}
+
+
+/**
+ * @brief Record a state transition
+ * @param[in] port Pointer to the port context
+ * @param[in] event Trace event identifying the state machine
+ * @param[in] oldState Previous state
+ * @param[in] newState New state
+ **/
+
+void authenticatorTraceStateChange(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, uint_t oldState, uint_t newState)
+{
+   AuthenticatorTraceRecord *record;
+
+   //Recording is enabled at runtime
+   if(port->context->traceEnabled)
+   {
+      //Allocate a new record
+      record = authenticatorAddTraceRecord(port, event, 0);
+
+      //Save the state transition
+      record->fromState = (uint8_t) oldState;
+      record->toState = (uint8_t) newState;
+   }
+}
+
+
+/**
+ * @brief Record a received or transmitted EAPOL PDU
+ * @param[in] port Pointer to the port context
+ * @param[in] event Trace event (direction of the PDU)
+ * @param[in] pdu Pointer to the EAPOL PDU
+ * @param[in] length Length of the EAPOL PDU, in bytes
+ **/
+
+void authenticatorTraceEapolPdu(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, const uint8_t *pdu, size_t length)
+{
+   const EapolPdu *eapolPdu;
+   const EapPacket *eapPacket;
+   AuthenticatorTraceRecord *record;
+
+   //Recording is enabled at runtime
+   if(port->context->traceEnabled)
+   {
+      //Allocate a new record
+      record = authenticatorAddTraceRecord(port, event, length);
+
+      //Valid EAPOL header?
+      if(length >= sizeof(EapolPdu))
+      {
+         //Point to the EAPOL header
+         eapolPdu = (const EapolPdu *) pdu;
+         //Save the packet type
+         record->eapolType = eapolPdu->packetType;
+
+         //EAP packet?
+         if(eapolPdu->packetType == EAPOL_TYPE_EAP &&
+            length >= (sizeof(EapolPdu) + sizeof(EapPacket)))
+         {
+            //Point to the EAP packet
+            eapPacket = (const EapPacket *) eapolPdu->packetBody;
+
+            //Save the code and the identifier
+            record->eapCode = eapPacket->code;
+            record->eapId = eapPacket->identifier;
+
+            //EAP requests and responses carry a Type field
+            if((eapPacket->code == EAP_CODE_REQUEST ||
+               eapPacket->code == EAP_CODE_RESPONSE) &&
+               length >= (sizeof(EapolPdu) + sizeof(EapRequest)))
+            {
+               record->eapType = ((const EapRequest *) eapPacket)->type;
+            }
+         }
+      }
+   }
+}
+
+
+/**
+ * @brief Record a received or transmitted RADIUS packet
+ * @param[in] port Pointer to the port context
+ * @param[in] event Trace event (direction of the packet)
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[in] length Length of the RADIUS packet, in bytes
+ **/
+
+void authenticatorTraceRadiusPacket(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, const uint8_t *packet, size_t length)
+{
+   const RadiusPacket *radiusPacket;
+   AuthenticatorTraceRecord *record;
+
+   //Recording is enabled at runtime
+   if(port->context->traceEnabled)
+   {
+      //Allocate a new record
+      record = authenticatorAddTraceRecord(port, event, length);
+
+      //Valid RADIUS header?
+      if(length >= sizeof(RadiusPacket))
+      {
+         //Point to the RADIUS header
+         radiusPacket = (const RadiusPacket *) packet;
+
+         //Save the code and the identifier
+         record->radiusCode = radiusPacket->code;
+         record->radiusId = radiusPacket->identifier;
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file authenticator_trace.h
+ * @brief Binary trace ring
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _AUTHENTICATOR_TRACE_H
+#define _AUTHENTICATOR_TRACE_H
+
+//Dependencies
+#include "authenticator/authenticator.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Authenticator related functions
+AuthenticatorTraceRecord *authenticatorAddTraceRecord(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, size_t length);
+
+void authenticatorTraceStateChange(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, uint_t oldState, uint_t newState);
+
+void authenticatorTraceEapolPdu(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, const uint8_t *pdu, size_t length);
+
+void authenticatorTraceRadiusPacket(AuthenticatorPort *port,
+   AuthenticatorTraceEvent event, const uint8_t *packet, size_t length);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,6 +34,7 @@
 //Dependencies
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_procedures.h"
+#include "authenticator/authenticator_local.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
 
@@ -44,7 +45,7 @@
 /**
  * @brief Calculate retransmission timeout
  * @param[in] port Pointer to the port context
- * @return Timeout value
+ * @return Timeout value, in milliseconds
  **/
 
 uint_t eapCalculateTimeout(AuthenticatorPort *port)
@@ -101,13 +102,13 @@ void eapParseResp(AuthenticatorPort *port)
          if(response->type == EAP_METHOD_TYPE_IDENTITY)
          {
             //Number of EAP Resp/Id frames that have been received
-            port->stats.eapolRespIdFramesRx++;
+            port->data->stats.eapolRespIdFramesRx++;
          }
          else
          {
             //Number of valid EAP Response frames (other than Resp/Id frames)
             //that have been received
-            port->stats.eapolRespFramesRx++;
+            port->data->stats.eapolRespFramesRx++;
          }
       }
    }
@@ -131,6 +132,13 @@ void eapBuildSuccess(AuthenticatorPort *port)
    //Debug message
    TRACE_DEBUG("buildSuccess() procedure...\r\n");
 
+   //No session buffer attached to the port?
+   if(port->eapReqData == NULL)
+   {
+      port->eapReqDataLen = 0;
+      return;
+   }
+
    //Point to the buffer where to format the EAP packet
    packet = (EapPacket *) port->eapReqData;
 
@@ -143,7 +151,7 @@ void eapBuildSuccess(AuthenticatorPort *port)
    packet->length = htons(n);
 
    //Debug message
-   TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAP header contents for debugging purpose
@@ -167,6 +175,13 @@ void eapBuildFailure(AuthenticatorPort *port)
    //Debug message
    TRACE_DEBUG("buildFailure() procedure...\r\n");
 
+   //No session buffer attached to the port?
+   if(port->eapReqData == NULL)
+   {
+      port->eapReqDataLen = 0;
+      return;
+   }
+
    //Point to the buffer where to format the EAP packet
    packet = (EapPacket *) port->eapReqData;
 
@@ -179,7 +194,7 @@ void eapBuildFailure(AuthenticatorPort *port)
    packet->length = htons(n);
 
    //Debug message
-   TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+   TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
       port->portIndex, n);
 
    //Dump EAP header contents for debugging purpose
@@ -239,6 +254,12 @@ EapMethodType eapPolicyGetNextMethod(AuthenticatorPort *port)
    //Debug message
    TRACE_DEBUG("Policy.getNextMethod() procedure...\r\n");
 
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   //Local users are authenticated by the NAS itself using EAP-MD5
+   if(port->localAuth)
+      return EAP_METHOD_TYPE_MD5_CHALLENGE;
+#endif
+
    //The NAS initiates the conversation by sending an EAP-Request/Identity
    return EAP_METHOD_TYPE_IDENTITY;
 }
@@ -264,6 +285,14 @@ EapDecision eapPolicyGetDecision(AuthenticatorPort *port)
       //peer (refer to RFC 3579, section 2.1)
       decision = EAP_DECISION_CONTINUE;
    }
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   else if(port->localAuth || authenticatorSelectLocalAuth(port))
+   {
+      //The RADIUS servers are unavailable and the critical authentication
+      //policy applies to the supplicant
+      decision = authenticatorGetLocalDecision(port);
+   }
+#endif
    else
    {
       //The NAS acts as a pass-through for subsequent messages
@@ -293,6 +322,13 @@ bool_t eapCheckResp(AuthenticatorPort *port)
    {
       ignore = FALSE;
    }
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   else if(port->currentMethod == EAP_METHOD_TYPE_MD5_CHALLENGE)
+   {
+      //Check the format of the MD5-Challenge response
+      ignore = authenticatorCheckMd5Response(port);
+   }
+#endif
    else
    {
       ignore = TRUE;
@@ -312,6 +348,24 @@ void eapProcessResp(AuthenticatorPort *port)
 {
    //Debug message
    TRACE_DEBUG("m.process() procedure...\r\n");
+
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   //Check current method
+   if(port->currentMethod == EAP_METHOD_TYPE_IDENTITY)
+   {
+      //The identity is needed should the supplicant be authenticated locally
+      authenticatorSaveLocalIdentity(port);
+   }
+   else if(port->currentMethod == EAP_METHOD_TYPE_MD5_CHALLENGE)
+   {
+      //Verify the response value
+      authenticatorProcessMd5Response(port);
+   }
+   else
+   {
+      //Just for sanity
+   }
+#endif
 }
 
 
@@ -358,7 +412,7 @@ bool_t eapIsDone(AuthenticatorPort *port)
 /**
  * @brief Determine an appropriate timeout hint for the method
  * @param[in] port Pointer to the port context
- * @return Timeout value
+ * @return Timeout value, in milliseconds
  **/
 
 uint_t eapGetTimeout(AuthenticatorPort *port)
@@ -367,7 +421,7 @@ uint_t eapGetTimeout(AuthenticatorPort *port)
    TRACE_DEBUG("m.getTimeout() procedure...\r\n");
 
    //Return default timeout
-   return AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT;
+   return AUTHENTICATOR_DEFAULT_METHOD_TIMEOUT * 1000;
 }
 
 
@@ -400,8 +454,13 @@ void eapBuildReq(AuthenticatorPort *port)
    //Debug message
    TRACE_DEBUG("m.buildReq() procedure...\r\n");
 
-   //Identity method?
-   if(port->currentMethod == EAP_METHOD_TYPE_IDENTITY)
+   //No session buffer attached to the port?
+   if(port->eapReqData == NULL)
+   {
+      //The request cannot be formatted
+      port->eapReqDataLen = 0;
+   }
+   else if(port->currentMethod == EAP_METHOD_TYPE_IDENTITY)
    {
       //Point to the buffer where to format the EAP packet
       request = (EapRequest *) port->eapReqData;
@@ -422,7 +481,7 @@ void eapBuildReq(AuthenticatorPort *port)
       request->length = htons(n);
 
       //Debug message
-      TRACE_DEBUG("Port %" PRIu8 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": Sending EAP packet (%" PRIuSIZE " bytes)...\r\n",
          port->portIndex, n);
 
       //Dump EAP header contents for debugging purpose
@@ -431,6 +490,13 @@ void eapBuildReq(AuthenticatorPort *port)
       //Save the length of the EAP request
       port->eapReqDataLen = n;
    }
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+   else if(port->currentMethod == EAP_METHOD_TYPE_MD5_CHALLENGE)
+   {
+      //Format EAP-Request/MD5-Challenge packet
+      authenticatorBuildMd5Challenge(port);
+   }
+#endif
    else
    {
       //Unknown EAP method
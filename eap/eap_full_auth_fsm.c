@@ -35,6 +35,11 @@
 #include "authenticator/authenticator.h"
 #include "authenticator/authenticator_fsm.h"
 #include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_server.h"
+#include "authenticator/authenticator_timer.h"
+#include "authenticator/authenticator_trace.h"
+#include "authenticator/authenticator_event.h"
+#include "authenticator/authenticator_local.h"
 #include "eap/eap_full_auth_fsm.h"
 #include "eap/eap_auth_procedures.h"
 #include "eap/eap_debug.h"
@@ -77,381 +82,306 @@ const EapParamName eapFullAuthStates[] =
 };
 
 
-/**
- * @brief EAP full authenticator state machine initialization
- * @param[in] port Pointer to the port context
- **/
+//Global transition to the DISABLED state
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondPortDisabled,
+   !port->portEnabled)
 
-void eapFullAuthInitFsm(AuthenticatorPort *port)
+//Global transition to the INITIALIZE state
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondRestart,
+   port->eapRestart && port->portEnabled)
+
+//Errata
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondNotAuto,
+   port->portControl != AUTHENTICATOR_PORT_MODE_AUTO)
+
+//DISABLED to INITIALIZE transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondPortEnabled,
+   port->portEnabled)
+
+//The retransmission timer has expired
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondRetransWhile,
+   port->retransWhile == 0)
+
+//A new EAP response is available
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondEapResp,
+   port->eapResp)
+
+//The maximum number of retransmissions has been exceeded
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondMaxRetrans,
+   port->retransCount > port->maxRetrans)
+
+//RECEIVED to NAK transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondNak,
+   port->rxResp && port->respId == port->currentId &&
+   (port->respMethod == EAP_METHOD_TYPE_NAK ||
+   port->respMethod == EAP_METHOD_TYPE_EXPANDED_NAK) &&
+   port->methodState == EAP_METHOD_STATE_PROPOSED)
+
+//RECEIVED to INTEGRITY_CHECK transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondValidResp,
+   port->rxResp && port->respId == port->currentId &&
+   port->respMethod == port->currentMethod)
+
+//SELECT_ACTION to FAILURE transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondDecisionFailure,
+   port->decision == EAP_DECISION_FAILURE)
+
+//SELECT_ACTION to SUCCESS transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondDecisionSuccess,
+   port->decision == EAP_DECISION_SUCCESS)
+
+//SELECT_ACTION to INITIALIZE_PASSTHROUGH transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondDecisionPassthrough,
+   port->decision == EAP_DECISION_PASSTHROUGH)
+
+//The method has decided to drop the current packet
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondIgnore,
+   port->ignore)
+
+//METHOD_RESPONSE to SELECT_ACTION transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondMethodEnd,
+   port->methodState == EAP_METHOD_STATE_END)
+
+//INITIALIZE_PASSTHROUGH to AAA_REQUEST transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondCurrentId,
+   port->currentId != EAP_CURRENT_ID_NONE)
+
+//RECEIVED2 to AAA_REQUEST transition
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondRespId,
+   port->rxResp && port->respId == port->currentId)
+
+//No new request to send
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondAaaEapNoReq,
+   port->aaaEapNoReq)
+
+//A new EAP request is ready to be sent
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondAaaEapReq,
+   port->aaaEapReq)
+
+//The critical authentication policy may allow the NAS to answer on behalf
+//of the RADIUS servers
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondCriticalAuth,
+   port->aaaTimeout && authenticatorStartCriticalAuth(port))
+
+//No response from the AAA layer
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondAaaTimeout,
+   port->aaaTimeout)
+
+//The AAA layer has reached the FAILURE state
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondAaaFail,
+   port->aaaFail)
+
+//The AAA layer has reached the SUCCESS state
+AUTHENTICATOR_FSM_CONDITION(eapFullAuthCondAaaSuccess,
+   port->aaaSuccess)
+
+//Global transitions
+static const AuthenticatorFsmTransition eapFullAuthGlobalTransitions[] =
 {
-   //Enter initial state
-   eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISABLED);
-}
+   {eapFullAuthCondPortDisabled, EAP_FULL_AUTH_STATE_DISABLED},
+   {eapFullAuthCondRestart,      EAP_FULL_AUTH_STATE_INITIALIZE},
+   {eapFullAuthCondNotAuto,      EAP_FULL_AUTH_STATE_INITIALIZE}
+};
 
+//Exit conditions of the DISABLED state
+static const AuthenticatorFsmTransition eapFullAuthDisabledExits[] =
+{
+   {eapFullAuthCondPortEnabled, EAP_FULL_AUTH_STATE_INITIALIZE}
+};
 
-/**
- * @brief EAP full authenticator state machine implementation
- * @param[in] port Pointer to the port context
- **/
+//Exit conditions of the INITIALIZE and NAK states
+static const AuthenticatorFsmTransition eapFullAuthSelectActionExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_SELECT_ACTION}
+};
 
-void eapFullAuthFsm(AuthenticatorPort *port)
+//Exit conditions of the IDLE state
+static const AuthenticatorFsmTransition eapFullAuthIdleExits[] =
 {
-   //A global transition can occur from any of the possible states. When the
-   //condition associated with a global transition is met, it supersedes all
-   //other exit conditions
-   if(!port->portEnabled)
-   {
-      //Switch to the DISABLED state
-      eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISABLED);
-   }
-   else if(port->eapRestart && port->portEnabled)
-   {
-      //Switch to the INITIALIZE state
-      eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_INITIALIZE);
-   }
-   //Errata
-   else if(port->portControl != AUTHENTICATOR_PORT_MODE_AUTO)
-   {
-      //Switch to the INITIALIZE state
-      eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_INITIALIZE);
-   }
-   else
-   {
-      //All exit conditions for the state are evaluated continuously until one
-      //of the conditions is met (refer to RFC 4137, section 3.1)
-      switch(port->eapFullAuthState)
-      {
-      //DISABLED state?
-      case EAP_FULL_AUTH_STATE_DISABLED:
-         //Evaluate conditions for the current state
-         if(port->portEnabled)
-         {
-            //Switch to the INITIALIZE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_INITIALIZE);
-         }
+   {eapFullAuthCondRetransWhile, EAP_FULL_AUTH_STATE_RETRANSMIT},
+   {eapFullAuthCondEapResp,      EAP_FULL_AUTH_STATE_RECEIVED}
+};
 
-         break;
+//Exit conditions of the RETRANSMIT state
+static const AuthenticatorFsmTransition eapFullAuthRetransmitExits[] =
+{
+   {eapFullAuthCondMaxRetrans, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE},
+   {AUTHENTICATOR_FSM_UCT,     EAP_FULL_AUTH_STATE_IDLE}
+};
 
-      //INITIALIZE state?
-      case EAP_FULL_AUTH_STATE_INITIALIZE:
-         //Unconditional transition (UCT) to SELECT_ACTION state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SELECT_ACTION);
-         break;
+//Exit conditions of the RECEIVED state
+static const AuthenticatorFsmTransition eapFullAuthReceivedExits[] =
+{
+   {eapFullAuthCondNak,       EAP_FULL_AUTH_STATE_NAK},
+   {eapFullAuthCondValidResp, EAP_FULL_AUTH_STATE_INTEGRITY_CHECK},
+   {AUTHENTICATOR_FSM_UCT,    EAP_FULL_AUTH_STATE_DISCARD}
+};
 
-      //IDLE state?
-      case EAP_FULL_AUTH_STATE_IDLE:
-         //The state machine spends most of its time here, waiting for
-         //something to happen
-         if(port->retransWhile == 0)
-         {
-            //Switch to the RETRANSMIT state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_RETRANSMIT);
-         }
-         else if(port->eapResp)
-         {
-            //Switch to the RECEIVED state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_RECEIVED);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions of the SELECT_ACTION state
+static const AuthenticatorFsmTransition eapFullAuthDecisionExits[] =
+{
+   {eapFullAuthCondDecisionFailure,     EAP_FULL_AUTH_STATE_FAILURE},
+   {eapFullAuthCondDecisionSuccess,     EAP_FULL_AUTH_STATE_SUCCESS},
+   {eapFullAuthCondDecisionPassthrough, EAP_FULL_AUTH_STATE_INITIALIZE_PASSTHROUGH},
+   {AUTHENTICATOR_FSM_UCT,              EAP_FULL_AUTH_STATE_PROPOSE_METHOD}
+};
 
-         break;
+//Exit conditions of the INTEGRITY_CHECK state
+static const AuthenticatorFsmTransition eapFullAuthIntegrityCheckExits[] =
+{
+   {eapFullAuthCondIgnore, EAP_FULL_AUTH_STATE_DISCARD},
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_METHOD_RESPONSE}
+};
 
-      //RETRANSMIT state?
-      case EAP_FULL_AUTH_STATE_RETRANSMIT:
-         //Evaluate conditions for the current state
-         if(port->retransCount > port->maxRetrans)
-         {
-            //Switch to the TIMEOUT_FAILURE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE);
-         }
-         else
-         {
-            //Switch to the IDLE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE);
-         }
+//Exit conditions of the METHOD_RESPONSE state
+static const AuthenticatorFsmTransition eapFullAuthMethodResponseExits[] =
+{
+   {eapFullAuthCondMethodEnd, EAP_FULL_AUTH_STATE_SELECT_ACTION},
+   {AUTHENTICATOR_FSM_UCT,    EAP_FULL_AUTH_STATE_METHOD_REQUEST}
+};
 
-         break;
+//Exit conditions of the PROPOSE_METHOD state
+static const AuthenticatorFsmTransition eapFullAuthProposeMethodExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_METHOD_REQUEST}
+};
 
-      //RECEIVED state?
-      case EAP_FULL_AUTH_STATE_RECEIVED:
-         //Evaluate conditions for the current state
-         if(port->rxResp && port->respId == port->currentId &&
-            (port->respMethod == EAP_METHOD_TYPE_NAK ||
-            port->respMethod == EAP_METHOD_TYPE_EXPANDED_NAK) &&
-            port->methodState == EAP_METHOD_STATE_PROPOSED)
-         {
-            //Switch to the NAK state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_NAK);
-         }
-         else if(port->rxResp && port->respId == port->currentId &&
-            port->respMethod == port->currentMethod)
-         {
-            //Switch to the INTEGRITY_CHECK state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_INTEGRITY_CHECK);
-         }
-         else
-         {
-            //Switch to the DISCARD state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISCARD);
-         }
+//Exit conditions of the METHOD_REQUEST state
+static const AuthenticatorFsmTransition eapFullAuthMethodRequestExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_SEND_REQUEST}
+};
 
-         break;
+//Exit conditions of the DISCARD and SEND_REQUEST states
+static const AuthenticatorFsmTransition eapFullAuthIdleReturnExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_IDLE}
+};
 
-      //NAK state?
-      case EAP_FULL_AUTH_STATE_NAK:
-         //Unconditional transition (UCT) to SELECT_ACTION state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SELECT_ACTION);
-         break;
+//Exit conditions of the INITIALIZE_PASSTHROUGH state
+static const AuthenticatorFsmTransition eapFullAuthPassthroughExits[] =
+{
+   {eapFullAuthCondCurrentId, EAP_FULL_AUTH_STATE_AAA_REQUEST},
+   {AUTHENTICATOR_FSM_UCT,    EAP_FULL_AUTH_STATE_AAA_IDLE}
+};
 
-      //SELECT_ACTION state?
-      case EAP_FULL_AUTH_STATE_SELECT_ACTION:
-         //Evaluate conditions for the current state
-         if(port->decision == EAP_DECISION_FAILURE)
-         {
-            //Switch to the FAILURE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_FAILURE);
-         }
-         else if(port->decision == EAP_DECISION_SUCCESS)
-         {
-            //Switch to the SUCCESS state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SUCCESS);
-         }
-         else if(port->decision == EAP_DECISION_PASSTHROUGH)
-         {
-            //Switch to the INITIALIZE_PASSTHROUGH state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_INITIALIZE_PASSTHROUGH);
-         }
-         else
-         {
-            //Switch to the PROPOSE_METHOD state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_PROPOSE_METHOD);
-         }
+//Exit conditions of the IDLE2 state
+static const AuthenticatorFsmTransition eapFullAuthIdle2Exits[] =
+{
+   {eapFullAuthCondRetransWhile, EAP_FULL_AUTH_STATE_RETRANSMIT2},
+   {eapFullAuthCondEapResp,      EAP_FULL_AUTH_STATE_RECEIVED2}
+};
 
-         break;
+//Exit conditions of the RETRANSMIT2 state
+static const AuthenticatorFsmTransition eapFullAuthRetransmit2Exits[] =
+{
+   {eapFullAuthCondMaxRetrans, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2},
+   {AUTHENTICATOR_FSM_UCT,     EAP_FULL_AUTH_STATE_IDLE2}
+};
 
-      //INTEGRITY_CHECK state?
-      case EAP_FULL_AUTH_STATE_INTEGRITY_CHECK:
-         //Evaluate conditions for the current state
-         if(port->ignore)
-         {
-            //Switch to the DISCARD state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISCARD);
-         }
-         else
-         {
-            //Switch to the METHOD_RESPONSE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_METHOD_RESPONSE);
-         }
+//Exit conditions of the RECEIVED2 state
+static const AuthenticatorFsmTransition eapFullAuthReceived2Exits[] =
+{
+   {eapFullAuthCondRespId, EAP_FULL_AUTH_STATE_AAA_REQUEST},
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_DISCARD2}
+};
 
-         break;
+//Exit conditions of the AAA_REQUEST state
+static const AuthenticatorFsmTransition eapFullAuthAaaRequestExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_AAA_IDLE}
+};
 
-      //METHOD_RESPONSE state?
-      case EAP_FULL_AUTH_STATE_METHOD_RESPONSE:
-         //Evaluate conditions for the current state
-         if(port->methodState == EAP_METHOD_STATE_END)
-         {
-            //Switch to the SELECT_ACTION state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SELECT_ACTION);
-         }
-         else
-         {
-            //Switch to the METHOD_REQUEST state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_METHOD_REQUEST);
-         }
+//Exit conditions of the AAA_IDLE state
+static const AuthenticatorFsmTransition eapFullAuthAaaIdleExits[] =
+{
+   {eapFullAuthCondAaaEapNoReq,  EAP_FULL_AUTH_STATE_DISCARD2},
+   {eapFullAuthCondAaaEapReq,    EAP_FULL_AUTH_STATE_AAA_RESPONSE},
+   {eapFullAuthCondCriticalAuth, EAP_FULL_AUTH_STATE_SELECT_ACTION},
+   {eapFullAuthCondAaaTimeout,   EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2},
+   {eapFullAuthCondAaaFail,      EAP_FULL_AUTH_STATE_FAILURE2},
+   {eapFullAuthCondAaaSuccess,   EAP_FULL_AUTH_STATE_SUCCESS2}
+};
 
-         break;
-
-      //PROPOSE_METHOD state?
-      case EAP_FULL_AUTH_STATE_PROPOSE_METHOD:
-         //Unconditional transition (UCT) to METHOD_REQUEST state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_METHOD_REQUEST);
-         break;
-
-      //METHOD_REQUEST state?
-      case EAP_FULL_AUTH_STATE_METHOD_REQUEST:
-         //Unconditional transition (UCT) to SEND_REQUEST state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SEND_REQUEST);
-         break;
-
-      //DISCARD state?
-      case EAP_FULL_AUTH_STATE_DISCARD:
-         //Unconditional transition (UCT) to IDLE state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE);
-         break;
-
-      //SEND_REQUEST state?
-      case EAP_FULL_AUTH_STATE_SEND_REQUEST:
-         //Unconditional transition (UCT) to IDLE state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE);
-         break;
-
-      //TIMEOUT_FAILURE state?
-      case EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE:
-         //Final state indicating failure because no response has been received
-         break;
-
-      //FAILURE state?
-      case EAP_FULL_AUTH_STATE_FAILURE:
-         //Final state indicating failure
-         break;
-
-      //SUCCESS state?
-      case EAP_FULL_AUTH_STATE_SUCCESS:
-         //Final state indicating success
-         break;
-
-      //INITIALIZE_PASSTHROUGH state?
-      case EAP_FULL_AUTH_STATE_INITIALIZE_PASSTHROUGH:
-         //Evaluate conditions for the current state
-         if(port->currentId != EAP_CURRENT_ID_NONE)
-         {
-            //Switch to the AAA_REQUEST state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_AAA_REQUEST);
-         }
-         else
-         {
-            //Switch to the AAA_IDLE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_AAA_IDLE);
-         }
+//Exit conditions of the AAA_RESPONSE state
+static const AuthenticatorFsmTransition eapFullAuthAaaResponseExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_SEND_REQUEST2}
+};
 
-         break;
+//Exit conditions of the DISCARD2 and SEND_REQUEST2 states
+static const AuthenticatorFsmTransition eapFullAuthIdle2ReturnExits[] =
+{
+   {AUTHENTICATOR_FSM_UCT, EAP_FULL_AUTH_STATE_IDLE2}
+};
 
-      //IDLE2 state?
-      case EAP_FULL_AUTH_STATE_IDLE2:
-         //The state machine waits for a response from the primary lower layer,
-         //which transports EAP traffic from the peer
-         if(port->retransWhile == 0)
-         {
-            //Switch to the RETRANSMIT2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_RETRANSMIT2);
-         }
-         else if(port->eapResp)
-         {
-            //Switch to the RECEIVED2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_RECEIVED2);
-         }
-         else
-         {
-            //Just for sanity
-         }
+//Exit conditions, listed in the order of the EapFullAuthState values. The
+//final states can only be left through a global transition
+static const AuthenticatorFsmState eapFullAuthExits[] =
+{
+   AUTHENTICATOR_FSM_STATE(eapFullAuthDisabledExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthSelectActionExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdleExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthRetransmitExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthReceivedExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthSelectActionExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthDecisionExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIntegrityCheckExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthMethodResponseExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthProposeMethodExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthMethodRequestExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdleReturnExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdleReturnExits),
+   AUTHENTICATOR_FSM_FINAL_STATE,
+   AUTHENTICATOR_FSM_FINAL_STATE,
+   AUTHENTICATOR_FSM_FINAL_STATE,
+   AUTHENTICATOR_FSM_STATE(eapFullAuthPassthroughExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdle2Exits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthRetransmit2Exits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthReceived2Exits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthAaaRequestExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthAaaIdleExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthAaaResponseExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdle2ReturnExits),
+   AUTHENTICATOR_FSM_STATE(eapFullAuthIdle2ReturnExits),
+   AUTHENTICATOR_FSM_FINAL_STATE,
+   AUTHENTICATOR_FSM_FINAL_STATE,
+   AUTHENTICATOR_FSM_FINAL_STATE
+};
 
-         break;
+//Transition table of the EAP full authenticator state machine
+static const AuthenticatorFsmTable eapFullAuthFsmTable =
+   AUTHENTICATOR_FSM_TABLE(eapFullAuthGlobalTransitions, eapFullAuthExits);
 
-      //RETRANSMIT2 state?
-      case EAP_FULL_AUTH_STATE_RETRANSMIT2:
-         //Evaluate conditions for the current state
-         if(port->retransCount > port->maxRetrans)
-         {
-            //Switch to the TIMEOUT_FAILURE2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2);
-         }
-         else
-         {
-            //Switch to the IDLE2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE2);
-         }
 
-         break;
+/**
+ * @brief EAP full authenticator state machine initialization
+ * @param[in] port Pointer to the port context
+ **/
 
-      //RECEIVED2 state?
-      case EAP_FULL_AUTH_STATE_RECEIVED2:
-         //Evaluate conditions for the current state
-         if(port->rxResp && port->respId == port->currentId)
-         {
-            //Switch to the AAA_REQUEST state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_AAA_REQUEST);
-         }
-         else
-         {
-            //Switch to the DISCARD2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISCARD2);
-         }
+void eapFullAuthInitFsm(AuthenticatorPort *port)
+{
+   //Enter initial state
+   eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISABLED);
+}
 
-         break;
 
-      //AAA_REQUEST state?
-      case EAP_FULL_AUTH_STATE_AAA_REQUEST:
-         //Unconditional transition (UCT) to AAA_IDLE state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_AAA_IDLE);
-         break;
+/**
+ * @brief EAP full authenticator state machine implementation
+ * @param[in] port Pointer to the port context
+ **/
 
-      //AAA_IDLE state?
-      case EAP_FULL_AUTH_STATE_AAA_IDLE:
-         //Evaluate conditions for the current state
-         if(port->aaaEapNoReq)
-         {
-            //Switch to the DISCARD2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_DISCARD2);
-         }
-         else if(port->aaaEapReq)
-         {
-            //Switch to the AAA_RESPONSE state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_AAA_RESPONSE);
-         }
-         else if(port->aaaTimeout)
-         {
-            //Switch to the TIMEOUT_FAILURE2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2);
-         }
-         else if(port->aaaFail)
-         {
-            //Switch to the FAILURE2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_FAILURE2);
-         }
-         else if(port->aaaSuccess)
-         {
-            //Switch to the SUCCESS2 state
-            eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SUCCESS2);
-         }
-         else
-         {
-            //Just for sanity
-         }
+void eapFullAuthFsm(AuthenticatorPort *port)
+{
+   uint_t newState;
 
-         break;
-
-      //AAA_RESPONSE state?
-      case EAP_FULL_AUTH_STATE_AAA_RESPONSE:
-         //Unconditional transition (UCT) to SEND_REQUEST2 state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_SEND_REQUEST2);
-         break;
-
-      //DISCARD2 state?
-      case EAP_FULL_AUTH_STATE_DISCARD2:
-         //Unconditional transition (UCT) to IDLE2 state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE2);
-         break;
-
-      //SEND_REQUEST2 state?
-      case EAP_FULL_AUTH_STATE_SEND_REQUEST2:
-         //Unconditional transition (UCT) to IDLE2 state
-         eapFullAuthChangeState(port, EAP_FULL_AUTH_STATE_IDLE2);
-         break;
-
-      //TIMEOUT_FAILURE2 state?
-      case EAP_FULL_AUTH_STATE_TIMEOUT_FAILURE2:
-         //Final state indicating failure because no response has been received
-         break;
-
-      //FAILURE2 state?
-      case EAP_FULL_AUTH_STATE_FAILURE2:
-         //Final state indicating failure
-         break;
-
-      //SUCCESS2 state?
-      case EAP_FULL_AUTH_STATE_SUCCESS2:
-         //Final state indicating success
-         break;
-
-      //Invalid state?
-      default:
-         //Just for sanity
-         authenticatorFsmError(port->context);
-         break;
-      }
+   //Evaluate the exit conditions of the current state (refer to RFC 4137,
+   //section 3.1)
+   if(authenticatorEvalFsm(port, &eapFullAuthFsmTable,
+      port->eapFullAuthState, &newState))
+   {
+      //Switch to the new state
+      eapFullAuthChangeState(port, (EapFullAuthState) newState);
    }
 }
 
@@ -475,12 +405,23 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
    if(newState != oldState)
    {
       //Dump the state transition
-      TRACE_DEBUG("Port %" PRIu8 ": EAP full authenticator state machine %s -> %s\r\n",
+      TRACE_DEBUG("Port %" PRIu16 ": EAP full authenticator state machine %s -> %s\r\n",
          port->portIndex,
          eapGetParamName(oldState, eapFullAuthStates,
          arraysize(eapFullAuthStates)),
          eapGetParamName(newState, eapFullAuthStates,
          arraysize(eapFullAuthStates)));
+
+      //Record the state transition
+      authenticatorTraceStateChange(port, AUTHENTICATOR_TRACE_EVENT_EAP_FULL_AUTH_STATE, oldState, newState);
+   }
+
+   //The RADIUS request is no longer outstanding once the AAA_IDLE state
+   //has been left
+   if(oldState == EAP_FULL_AUTH_STATE_AAA_IDLE && newState != oldState)
+   {
+      //Release the identifier of the pending Access-Request
+      authenticatorReleaseRadiusId(port);
    }
 
    //Switch to the new state
@@ -508,7 +449,13 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
 
       //Errata
       port->currentMethod = EAP_METHOD_TYPE_NONE;
-      port->serverStateLen = 0;
+      port->data->serverStateLen = 0;
+
+#if (AUTHENTICATOR_LOCAL_AUTH_SUPPORT == ENABLED)
+      //The RADIUS servers are tried first
+      port->localAuth = FALSE;
+      port->localAuthSuccess = FALSE;
+#endif
       break;
 
    //IDLE state?
@@ -516,7 +463,8 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
       //Calculate the retransmission timeout, taking into account the
       //retransmission count, round-trip time measurements, and method-specific
       //timeout hint
-      port->retransWhile = eapCalculateTimeout(port);
+      authenticatorStartTimer(port, AUTHENTICATOR_TIMER_RETRANS_WHILE,
+         eapCalculateTimeout(port));
       break;
 
    //RETRANSMIT state?
@@ -664,6 +612,9 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
       //is activated
       port->aaaEapRespData = NULL;
       port->aaaEapRespDataLen = 0;
+
+      //Assign the session to one of the RADIUS servers
+      authenticatorSelectRadiusServer(port);
       break;
 
    //IDLE2 state?
@@ -671,7 +622,8 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
       //Calculate the retransmission timeout, taking into account the
       //retransmission count, round-trip time measurements, and method-specific
       //timeout hint
-      port->retransWhile = eapCalculateTimeout(port);
+      authenticatorStartTimer(port, AUTHENTICATOR_TIMER_RETRANS_WHILE,
+         eapCalculateTimeout(port));
       break;
 
    //RETRANSMIT2 state?
@@ -711,8 +663,9 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
          //The NAS must copy the contents of the Type-Data field of the
          //EAP-Response/Identity received from the peer (refer to RFC 3579,
          //section 2.1)
-         osMemcpy(port->aaaIdentity, port->eapRespData + sizeof(EapResponse), n);
-         port->aaaIdentity[n] = '\0';
+         osMemcpy(port->data->aaaIdentity, port->eapRespData +
+            sizeof(EapResponse), n);
+         port->data->aaaIdentity[n] = '\0';
       }
 
       //The incoming EAP packet is parsed for sending to the AAA server
@@ -798,8 +751,13 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
       //Any registered callback?
       if(port->context->eapFullAuthStateChangeCallback != NULL)
       {
-         //Invoke user callback function
-         port->context->eapFullAuthStateChangeCallback(port, newState);
+         //The callback is either deferred or invoked synchronously
+         if(!authenticatorQueueEvent(port, AUTHENTICATOR_EVENT_EAP_FULL_AUTH_STATE,
+            newState))
+         {
+            //Invoke user callback function
+            port->context->eapFullAuthStateChangeCallback(port, newState);
+         }
       }
    }
 
@@ -808,7 +766,7 @@ void eapFullAuthChangeState(AuthenticatorPort *port,
       !port->initialize && port->portEnabled)
    {
       //The EAP full authenticator state machine is busy
-      port->context->busy = TRUE;
+      port->busy = TRUE;
    }
 }
 
@@ -369,7 +369,8 @@ void eapPeerChangeState(SupplicantContext *context,
       context->methodState = EAP_METHOD_STATE_NONE;
       context->allowNotifications = TRUE;
       context->decision = EAP_DECISION_FAIL;
-      context->idleWhile = context->clientTimeout;
+      supplicantStartTimer(context, SUPPLICANT_TIMER_IDLE_WHILE,
+         context->clientTimeout * 1000);
       context->lastId = EAP_LAST_ID_NONE;
       context->eapSuccess = FALSE;
       context->eapFail = FALSE;
@@ -388,6 +389,10 @@ void eapPeerChangeState(SupplicantContext *context,
    case EAP_PEER_STATE_RECEIVED:
       //This state is entered when an EAP packet is received
       eapParseReq(context);
+
+      //Responses are formatted right after the EAPOL header, unless the
+      //method sends its data in place
+      context->eapRespData = context->txBuffer + sizeof(EapolPdu);
       break;
 
    //METHOD state?
@@ -465,7 +470,8 @@ void eapPeerChangeState(SupplicantContext *context,
       context->lastRespDataLen = context->eapRespDataLen;
       context->eapReq = FALSE;
       context->eapResp = TRUE;
-      context->idleWhile = context->clientTimeout;
+      supplicantStartTimer(context, SUPPLICANT_TIMER_IDLE_WHILE,
+         context->clientTimeout * 1000);
       break;
 
    //SUCCESS state?
@@ -472,6 +472,14 @@ bool_t eapAllowMethod(SupplicantContext *context, EapMethodType method)
       {
          acceptable = TRUE;
       }
+
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+      //The virtual supplicants do not have their own TLS context
+      if(context->loadGen != NULL)
+      {
+         acceptable = FALSE;
+      }
+#endif
    }
    else
 #endif
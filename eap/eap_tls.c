@@ -90,11 +90,15 @@ void eapTlsProcessRequest(SupplicantContext *context,
       context->txBufferWritePos = EAP_TLS_TX_BUFFER_START_POS;
       context->txBufferReadPos = EAP_TLS_TX_BUFFER_START_POS;
       context->txBufferLen = 0;
-      context->rxBufferPos = 0;
-      context->rxBufferLen = 0;
+      context->tlsRxLen = 0;
+      context->tlsRxPos = 0;
+      context->tlsRxReady = 0;
+      context->tlsRxTotal = 0;
 
       //Abort previous TLS session, if any
       eapCloseTls(context, ERROR_CONNECTION_RESET);
+      //No cached session is resumed so far
+      context->tlsSession = NULL;
 
       //The S flag is set only within the EAP-TLS start message sent from the
       //EAP server to the peer (refer to RFC 5216, section 2.1.5)
@@ -106,9 +110,18 @@ void eapTlsProcessRequest(SupplicantContext *context,
          //Check status code
          if(!error)
          {
-            //Restore TLS session
-            error = tlsRestoreSessionState(context->tlsContext,
-               &context->tlsSession);
+            //Retrieve the session previously established through the same
+            //authenticator, if any
+            context->tlsSession = eapTlsLookupSession(context,
+               &context->authAddr);
+
+            //Any cached session?
+            if(context->tlsSession != NULL)
+            {
+               //Attempt an abbreviated handshake
+               error = tlsRestoreSessionState(context->tlsContext,
+                  &context->tlsSession->session);
+            }
          }
 
          //Check status code
@@ -128,27 +141,26 @@ void eapTlsProcessRequest(SupplicantContext *context,
    else if(context->methodState == EAP_METHOD_STATE_CONT ||
       context->methodState == EAP_METHOD_STATE_MAY_CONT)
    {
-      //The data consists of the encapsulated TLS packet in TLS record format
-      //(refer to RFC 5216, section 3.2)
-      context->rxBufferPos = request->data - context->rxBuffer;
-      context->rxBufferLen = length - sizeof(EapTlsPacket);
+      //Append the fragment to the reassembly buffer
+      error = eapTlsReassemble(context, request, length);
 
-      //The L flag is set to indicate the presence of the four-octet TLS
-      //Message Length field (refer to RFC 5216, section 2.1.5)
-      if((request->flags & EAP_TLS_FLAGS_L) != 0)
+      //Check status code
+      if(!error)
       {
-         //The TLS Message Length field provides the total length of the TLS
-         //message or set of messages that is being fragmented
-         n = LOAD32BE(request->data);
-
-         //Point to the next field
-         context->rxBufferPos += sizeof(uint32_t);
-         context->rxBufferLen -= sizeof(uint32_t);
+         //Any complete TLS record available?
+         if(context->tlsRxReady > context->tlsRxPos)
+         {
+            //Perform TLS handshake
+            error = tlsConnect(context->tlsContext);
+         }
+         else
+         {
+            //The fragment is acknowledged right away with an empty EAP-TLS
+            //response
+            error = ERROR_WOULD_BLOCK;
+         }
       }
 
-      //Perform TLS handshake
-      error = tlsConnect(context->tlsContext);
-
       //Check status code
       if(!error)
       {
@@ -178,8 +190,7 @@ void eapTlsProcessRequest(SupplicantContext *context,
       if(!error)
       {
          //Save TLS session
-         error = tlsSaveSessionState(context->tlsContext,
-            &context->tlsSession);
+         error = eapTlsCacheSession(context, &context->authAddr);
       }
    }
    else
@@ -218,14 +229,121 @@ void eapTlsProcessRequest(SupplicantContext *context,
          //access, or we're not willing to talk to this authenticator, set
          //decision to FAIL
          context->decision = EAP_DECISION_FAIL;
+
+         //The cached session, if any, must not be resumed again
+         eapTlsDropSession(context, context->tlsSession);
       }
 
+      //The cache entry is no longer used by the current handshake
+      context->tlsSession = NULL;
+
       //Close TLS session
       eapCloseTls(context, error);
    }
 }
 
 
+/**
+ * @brief Append an incoming EAP-TLS fragment to the reassembly buffer
+ *
+ * The space needed by a fragmented TLS message is checked against the TLS
+ * Message Length field of the first fragment. Only complete TLS records are
+ * handed over to the TLS engine, so that a handshake flight spanning several
+ * fragments is processed without stalling on record boundaries
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] request Pointer to the received request
+ * @param[in] length Length of the request, in bytes
+ * @return Error code
+ **/
+
+error_t eapTlsReassemble(SupplicantContext *context,
+   const EapTlsPacket *request, size_t length)
+{
+   size_t n;
+   size_t m;
+   const uint8_t *p;
+
+   //The data consists of the encapsulated TLS packet in TLS record format
+   //(refer to RFC 5216, section 3.2)
+   p = request->data;
+   n = length - sizeof(EapTlsPacket);
+
+   //The L flag is set to indicate the presence of the four-octet TLS
+   //Message Length field (refer to RFC 5216, section 2.1.5)
+   if((request->flags & EAP_TLS_FLAGS_L) != 0)
+   {
+      //The TLS Message Length field provides the total length of the TLS
+      //message or set of messages that is being fragmented
+      m = LOAD32BE(p);
+
+      //Point to the next field
+      p += sizeof(uint32_t);
+      n -= sizeof(uint32_t);
+
+      //Reserve room for the whole message
+      if((context->tlsRxLen - context->tlsRxPos + m) > SUPPLICANT_TLS_RX_BUFFER_SIZE)
+         return ERROR_BUFFER_OVERFLOW;
+
+      //Save the length of the message
+      context->tlsRxTotal = m;
+   }
+
+   //Discard the data that have already been consumed by the TLS engine
+   if(context->tlsRxPos > 0)
+   {
+      //Move the incomplete record, if any, to the beginning of the buffer
+      osMemmove(context->tlsRxBuffer, context->tlsRxBuffer + context->tlsRxPos,
+         context->tlsRxLen - context->tlsRxPos);
+
+      //Adjust indices
+      context->tlsRxLen -= context->tlsRxPos;
+      context->tlsRxReady -= context->tlsRxPos;
+      context->tlsRxPos = 0;
+   }
+
+   //Make sure the fragment fits in the reassembly buffer
+   if((context->tlsRxLen + n) > SUPPLICANT_TLS_RX_BUFFER_SIZE)
+      return ERROR_BUFFER_OVERFLOW;
+
+   //Append the fragment
+   osMemcpy(context->tlsRxBuffer + context->tlsRxLen, p, n);
+   context->tlsRxLen += n;
+
+   //Update the number of bytes left in the fragmented message
+   context->tlsRxTotal -= MIN(context->tlsRxTotal, n);
+
+   //The M flag is set on all but the last fragment (refer to RFC 5216,
+   //section 2.1.5)
+   if((request->flags & EAP_TLS_FLAGS_M) != 0 && context->tlsRxTotal > 0)
+   {
+      //Loop through the complete TLS records
+      while((context->tlsRxLen - context->tlsRxReady) >= sizeof(TlsRecord))
+      {
+         //Retrieve the length of the current record
+         m = sizeof(TlsRecord) + LOAD16BE(context->tlsRxBuffer +
+            context->tlsRxReady + 3);
+
+         //Incomplete record?
+         if((context->tlsRxLen - context->tlsRxReady) < m)
+            break;
+
+         //The record can be handed over to the TLS engine
+         context->tlsRxReady += m;
+      }
+   }
+   else
+   {
+      //The message is complete
+      context->tlsRxReady = context->tlsRxLen;
+      context->tlsRxTotal = 0;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
 /**
  * @brief Build EAP-TLS response
  * @param[in] context Pointer to the 802.1X supplicant context
@@ -234,25 +352,23 @@ void eapTlsProcessRequest(SupplicantContext *context,
 void eapTlsBuildResponse(SupplicantContext *context)
 {
    size_t n;
+   size_t maxFragLen;
    size_t fragLen;
+   uint8_t flags;
    uint8_t *p;
    EapTlsPacket *response;
 
-   //Point to the buffer where to format the EAP packet
-   response = (EapTlsPacket *) context->eapRespData;
-
-   //Format EAP packet
-   response->code = EAP_CODE_RESPONSE;
-   response->identifier = context->reqId;
-   response->type = EAP_METHOD_TYPE_TLS;
-   response->flags = 0;
+   //Maximum number of TLS data bytes in a fragment
+   maxFragLen = eapTlsGetMaxFragSize(context) - sizeof(EapolPdu) -
+      sizeof(EapTlsPacket);
 
-   //Point to the next field
-   p = response->data;
+   //Initialize flags
+   flags = 0;
+   //Size of the EAP-TLS header
    n = sizeof(EapTlsPacket);
 
    //Check the length of the TLS handshake message
-   if(context->txBufferLen < EAP_TLS_MAX_FRAG_SIZE)
+   if(context->txBufferLen <= maxFragLen)
    {
       //TLS handshake messages should not be fragmented into multiple TLS
       //records if they fit within a single TLS record (refer to RFC 5216,
@@ -263,7 +379,7 @@ void eapTlsBuildResponse(SupplicantContext *context)
    {
       //The M bit is set on all but the last fragment (refer to RFC 5216,
       //section 3.2)
-      response->flags |= EAP_TLS_FLAGS_M;
+      flags |= EAP_TLS_FLAGS_M;
 
       //First fragment?
       if(context->txBufferReadPos == EAP_TLS_TX_BUFFER_START_POS)
@@ -271,29 +387,44 @@ void eapTlsBuildResponse(SupplicantContext *context)
          //The L bit is set to indicate the presence of the four-octet TLS
          //Message Length field, and must be set for the first fragment of a
          //fragmented TLS message or set of messages
-         response->flags |= EAP_TLS_FLAGS_L;
-
-         //The TLS Message Length field provides the total length of the TLS
-         //message or set of messages that is being fragmented
-         STORE32BE(context->txBufferLen, p);
-
-         //Point to the next field
-         p += sizeof(uint32_t);
+         flags |= EAP_TLS_FLAGS_L;
          n += sizeof(uint32_t);
 
          //Calculate the length of the first fragment
-         fragLen = MIN(context->txBufferLen, EAP_TLS_MAX_INIT_FRAG_SIZE);
+         fragLen = MIN(context->txBufferLen, maxFragLen - sizeof(uint32_t));
       }
       else
       {
          //Calculate the length of subsequent fragments
-         fragLen = MIN(context->txBufferLen, EAP_TLS_MAX_FRAG_SIZE);
+         fragLen = MIN(context->txBufferLen, maxFragLen);
       }
    }
 
-   //The data consists of the encapsulated TLS packet in TLS record format
-   //(refer to RFC 5216, section 3.1)
-   osMemmove(p, context->txBuffer + context->txBufferReadPos, fragLen);
+   //The TLS records have been written with enough room in front of them for
+   //the EAPOL and EAP-TLS headers. The fragment is sent in place, and the
+   //headers overwrite the tail of the previous fragment, which has already
+   //been acknowledged
+   context->eapRespData = context->txBuffer + context->txBufferReadPos - n;
+
+   //Point to the buffer where to format the EAP packet
+   response = (EapTlsPacket *) context->eapRespData;
+
+   //Format EAP packet
+   response->code = EAP_CODE_RESPONSE;
+   response->identifier = context->reqId;
+   response->type = EAP_METHOD_TYPE_TLS;
+   response->flags = flags;
+
+   //L flag set?
+   if((flags & EAP_TLS_FLAGS_L) != 0)
+   {
+      //Point to the TLS Message Length field
+      p = response->data;
+
+      //The TLS Message Length field provides the total length of the TLS
+      //message or set of messages that is being fragmented
+      STORE32BE(context->txBufferLen, p);
+   }
 
    //Total length of the EAP packet
    n += fragLen;
@@ -323,8 +454,267 @@ void eapTlsBuildResponse(SupplicantContext *context)
 }
 
 
+/**
+ * @brief Get the maximum size of the EAPOL frames carrying EAP-TLS fragments
+ *
+ * Unless a fragment size has been configured, the fragments are sized so
+ * that each EAPOL frame fills the MTU of the link
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @return Maximum size of the EAPOL PDU, in bytes
+ **/
+
+size_t eapTlsGetMaxFragSize(SupplicantContext *context)
+{
+   size_t n;
+   NetInterface *physicalInterface;
+
+   //Any fragment size configured by the user?
+   if(context->eapMaxFragSize != 0)
+   {
+      //Use the configured value
+      n = context->eapMaxFragSize;
+   }
+   else
+   {
+      //Point to the physical interface
+      physicalInterface = nicGetPhysicalInterface(context->interface);
+
+      //Retrieve the MTU of the link
+      if(physicalInterface != NULL && physicalInterface->nicDriver != NULL)
+      {
+         n = physicalInterface->nicDriver->mtu;
+      }
+      else
+      {
+         n = EAP_MAX_FRAG_SIZE;
+      }
+   }
+
+   //The EAPOL frame (headers included) must fit in the transmit buffer
+   n = MIN(n, context->txBufferSize - EAP_TLS_TX_BUFFER_START_POS +
+      sizeof(EapolPdu) + sizeof(EapTlsPacket));
+
+   //The link is required to carry frames of at least 100 bytes
+   n = MAX(n, EAP_MIN_FRAG_SIZE);
+
+   //Return the maximum size of the EAPOL PDU
+   return n;
+}
+
+
+/**
+ * @brief Search the TLS session cache for a given authenticator
+ *
+ * On a cache miss, the session is loaded from non-volatile storage, if the
+ * user has provided the relevant callback
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] authAddr MAC address of the authenticator
+ * @return Pointer to the matching cache entry, if any
+ **/
+
+SupplicantTlsSessionEntry *eapTlsLookupSession(SupplicantContext *context,
+   const MacAddr *authAddr)
+{
+   error_t error;
+   uint_t i;
+   SupplicantTlsSessionEntry *entry;
+
+   //Loop through the TLS session cache
+   for(i = 0; i < SUPPLICANT_TLS_SESSION_CACHE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &context->tlsSessionCache[i];
+
+      //Matching entry?
+      if(entry->valid && macCompAddr(&entry->authAddr, authAddr))
+      {
+         //Update the age of the entry
+         entry->lastUsed = ++context->tlsSessionCounter;
+         //Return a pointer to the matching entry
+         return entry;
+      }
+   }
+
+   //Any session saved to non-volatile storage?
+   if(context->tlsSessionLoadCallback != NULL)
+   {
+      //Select the entry to be reused
+      entry = eapTlsAllocSession(context);
+
+      //Invoke user-defined callback
+      error = context->tlsSessionLoadCallback(context, authAddr,
+         &entry->session);
+
+      //Check status code
+      if(!error)
+      {
+         //The entry is now in use
+         entry->valid = TRUE;
+         entry->authAddr = *authAddr;
+         entry->lastUsed = ++context->tlsSessionCounter;
+
+         //Return a pointer to the loaded entry
+         return entry;
+      }
+
+      //Release the partially loaded session
+      tlsFreeSessionState(&entry->session);
+   }
+
+   //No matching entry
+   return NULL;
+}
+
+
+/**
+ * @brief Save the current TLS session to the cache
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] authAddr MAC address of the authenticator
+ * @return Error code
+ **/
+
+error_t eapTlsCacheSession(SupplicantContext *context, const MacAddr *authAddr)
+{
+   error_t error;
+   SupplicantTlsSessionEntry *entry;
+
+   //The session that has been resumed, if any, is updated in place
+   entry = context->tlsSession;
+
+   //The authenticator may have changed in the course of the handshake
+   if(entry == NULL || !entry->valid ||
+      !macCompAddr(&entry->authAddr, authAddr))
+   {
+      //Select the entry to be reused
+      entry = eapTlsAllocSession(context);
+   }
+
+   //Save TLS session
+   error = tlsSaveSessionState(context->tlsContext, &entry->session);
+
+   //Check status code
+   if(!error)
+   {
+      //The entry is now in use
+      entry->valid = TRUE;
+      entry->authAddr = *authAddr;
+      entry->lastUsed = ++context->tlsSessionCounter;
+
+      //Save the session to non-volatile storage, if requested
+      if(context->tlsSessionSaveCallback != NULL)
+      {
+         context->tlsSessionSaveCallback(context, authAddr, &entry->session);
+      }
+   }
+   else
+   {
+      //The entry no longer holds a valid session
+      eapTlsDropSession(context, entry);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Select the TLS session cache entry to be reused
+ *
+ * A free entry is used if any. Otherwise, the least recently used entry is
+ * evicted
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @return Pointer to the selected (empty) entry
+ **/
+
+SupplicantTlsSessionEntry *eapTlsAllocSession(SupplicantContext *context)
+{
+   uint_t i;
+   SupplicantTlsSessionEntry *entry;
+   SupplicantTlsSessionEntry *oldestEntry;
+
+   //Initialize pointer
+   oldestEntry = NULL;
+
+   //Loop through the TLS session cache
+   for(i = 0; i < SUPPLICANT_TLS_SESSION_CACHE_SIZE; i++)
+   {
+      //Point to the current entry
+      entry = &context->tlsSessionCache[i];
+
+      //Free entry?
+      if(!entry->valid)
+      {
+         oldestEntry = entry;
+         break;
+      }
+
+      //Keep track of the least recently used entry
+      if(oldestEntry == NULL ||
+         (int_t) (entry->lastUsed - oldestEntry->lastUsed) < 0)
+      {
+         oldestEntry = entry;
+      }
+   }
+
+   //Release the previous contents of the entry
+   eapTlsDropSession(context, oldestEntry);
+
+   //Return a pointer to the selected entry
+   return oldestEntry;
+}
+
+
+/**
+ * @brief Remove an entry from the TLS session cache
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] entry Pointer to the cache entry (may be NULL)
+ **/
+
+void eapTlsDropSession(SupplicantContext *context,
+   SupplicantTlsSessionEntry *entry)
+{
+   //Valid entry?
+   if(entry != NULL)
+   {
+      //Release the session state (ticket, server name)
+      tlsFreeSessionState(&entry->session);
+      //The entry is now free
+      entry->valid = FALSE;
+   }
+}
+
+
+/**
+ * @brief Discard all the cached TLS sessions
+ * @param[in] context Pointer to the 802.1X supplicant context
+ **/
+
+void eapTlsFlushSessionCache(SupplicantContext *context)
+{
+   uint_t i;
+
+   //Loop through the TLS session cache
+   for(i = 0; i < SUPPLICANT_TLS_SESSION_CACHE_SIZE; i++)
+   {
+      //Release the current entry
+      eapTlsDropSession(context, &context->tlsSessionCache[i]);
+   }
+
+   //No entry is used by the current handshake
+   context->tlsSession = NULL;
+}
+
+
 /**
  * @brief Open TLS session
+ *
+ * A new TLS context is allocated for each authentication attempt, and the
+ * credentials are registered again by the TLS initialization callback. The
+ * TLS library cannot reset a context in place once a handshake has been run
+ *
  * @param[in] context Pointer to the 802.1X supplicant context
  * @return Error code
  **/
@@ -419,7 +809,7 @@ error_t eapTlsSendCallback(void *handle, const void *data, size_t length,
    context = (SupplicantContext *) handle;
 
    //Make sure the datagram is large enough to hold the TLS message
-   if((context->txBufferWritePos + length) <= SUPPLICANT_TX_BUFFER_SIZE)
+   if((context->txBufferWritePos + length) <= context->txBufferSize)
    {
       //The data consists of the encapsulated TLS packet in TLS record format
       //(refer to RFC 5216, section 3.1)
@@ -467,19 +857,18 @@ error_t eapTlsReceiveCallback(void *handle, void *data, size_t size,
    //Point to the 802.1X supplicant context
    context = (SupplicantContext *) handle;
 
-   //Any data pending in the receive buffer?
-   if(context->rxBufferLen > 0)
+   //Any complete TLS record pending in the reassembly buffer?
+   if(context->tlsRxReady > context->tlsRxPos)
    {
       //Limit the number of bytes to copy
-      n = MIN(context->rxBufferLen, size);
+      n = MIN(context->tlsRxReady - context->tlsRxPos, size);
 
       //The data consists of the encapsulated TLS packet in TLS record format
       //(refer to RFC 5216, section 3.2)
-      osMemcpy(data, context->rxBuffer + context->rxBufferPos, n);
+      osMemcpy(data, context->tlsRxBuffer + context->tlsRxPos, n);
 
       //Number of bytes left to process
-      context->rxBufferPos += n;
-      context->rxBufferLen -= n;
+      context->tlsRxPos += n;
 
       //Total number of data that have been received
       *received = n;
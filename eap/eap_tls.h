@@ -39,13 +39,8 @@
 #define EAP_TLS_TX_BUFFER_START_POS (sizeof(EapolPdu) + \
    sizeof(EapTlsPacket) + sizeof(uint32_t))
 
-//Maximum fragment size (for first fragment)
-#define EAP_TLS_MAX_INIT_FRAG_SIZE (EAP_MAX_FRAG_SIZE - sizeof(EapolPdu) - \
-   sizeof(EapTlsPacket) - sizeof(uint32_t))
-
-//Maximum fragment size (for subsequent fragments)
-#define EAP_TLS_MAX_FRAG_SIZE (EAP_MAX_FRAG_SIZE - sizeof(EapolPdu) - \
-   sizeof(EapTlsPacket))
+//Minimum fragment size
+#define EAP_MIN_FRAG_SIZE 100
 
 
 //C++ guard
@@ -60,7 +55,22 @@ error_t eapTlsCheckRequest(SupplicantContext *context,
 void eapTlsProcessRequest(SupplicantContext *context,
    const EapTlsPacket *request, size_t length);
 
+error_t eapTlsReassemble(SupplicantContext *context,
+   const EapTlsPacket *request, size_t length);
+
 void eapTlsBuildResponse(SupplicantContext *context);
+size_t eapTlsGetMaxFragSize(SupplicantContext *context);
+
+SupplicantTlsSessionEntry *eapTlsLookupSession(SupplicantContext *context,
+   const MacAddr *authAddr);
+
+error_t eapTlsCacheSession(SupplicantContext *context, const MacAddr *authAddr);
+SupplicantTlsSessionEntry *eapTlsAllocSession(SupplicantContext *context);
+
+void eapTlsDropSession(SupplicantContext *context,
+   SupplicantTlsSessionEntry *entry);
+
+void eapTlsFlushSessionCache(SupplicantContext *context);
 
 error_t eapOpenTls(SupplicantContext *context);
 void eapCloseTls(SupplicantContext *context, error_t error);
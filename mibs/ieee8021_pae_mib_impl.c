@@ -40,6 +40,7 @@
 #include "encoding/asn1.h"
 #include "encoding/oid.h"
 #include "authenticator/authenticator_mgmt.h"
+#include "authenticator/authenticator_misc.h"
 #include "debug.h"
 
 //Check TCP/IP stack configuration
@@ -70,8 +71,12 @@ error_t ieee8021PaeMibInit(void)
 
 void ieee8021PaeMibLock(void)
 {
-   //Acquire exclusive access to the 802.1X authenticator context
-   authenticatorMgmtLock(ieee8021PaeMibBase.authContext);
+   //Read accesses rely on the snapshots published by the authenticator, so
+   //that polling the MIB never blocks the state machines. Write accesses
+   //acquire exclusive access to the 802.1X authenticator context on their own
+
+   //Rows are cached for the duration of a single request
+   ieee8021PaeMibBase.rowCachePortNum = 0;
 }
 
 
@@ -81,8 +86,10 @@ void ieee8021PaeMibLock(void)
 
 void ieee8021PaeMibUnlock(void)
 {
-   //Release exclusive access to the 802.1X authenticator context
-   authenticatorMgmtUnlock(ieee8021PaeMibBase.authContext);
+   //The 802.1X authenticator context is not locked by ieee8021PaeMibLock
+
+   //Invalidate the row cache
+   ieee8021PaeMibBase.rowCachePortNum = 0;
 }
 
 
@@ -101,4 +108,176 @@ error_t ieee8021PaeMibSetAuthenticatorContext(AuthenticatorContext *context)
    return NO_ERROR;
 }
 
+
+/**
+ * @brief Get the contents of a row of the port tables
+ *
+ * The snapshot of the port is taken once per request and cached, so that
+ * the columns of a row are all served from the same copy
+ *
+ * @param[in] portNum Port number
+ * @return Pointer to the snapshot of the port (NULL if the port does not
+ *   exist)
+ **/
+
+const AuthenticatorPortSnapshot *ieee8021PaeMibGetPortRow(uint_t portNum)
+{
+   error_t error;
+
+   //Cache miss?
+   if(ieee8021PaeMibBase.rowCachePortNum != portNum || portNum == 0)
+   {
+      //Read the latest snapshot of the port. The port itself is not locked
+      error = authenticatorGetPortSnapshot(ieee8021PaeMibBase.authContext,
+         portNum, &ieee8021PaeMibBase.rowCache);
+
+      //Invalid port number?
+      if(error)
+      {
+         ieee8021PaeMibBase.rowCachePortNum = 0;
+         return NULL;
+      }
+
+      //Save the port number of the cached row
+      ieee8021PaeMibBase.rowCachePortNum = portNum;
+   }
+
+   //Return a pointer to the cached row
+   return &ieee8021PaeMibBase.rowCache;
+}
+
+
+/**
+ * @brief Get the port that follows a given instance in lexicographic order
+ *
+ * The tables of the MIB are indexed by dot1xPaePortNumber. The port table of
+ * the authenticator is sorted by port number, and the BER encoding of the
+ * instance identifier preserves numerical order. The successor is then
+ * determined from the decoded instance identifier, with no need to compare
+ * the OID of every row
+ *
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier
+ * @param[in] oidLen Length of the OID, in bytes
+ * @return Number of the next port (0 if no port follows the specified OID)
+ **/
+
+uint_t ieee8021PaeMibGetNextPortNum(const MibObject *object,
+   const uint8_t *oid, size_t oidLen)
+{
+   error_t error;
+   int_t res;
+   size_t n;
+   uint_t portNum;
+   AuthenticatorContext *context;
+
+   //Point to the 802.1X authenticator context
+   context = ieee8021PaeMibBase.authContext;
+
+   //Make sure the context is valid
+   if(context == NULL || context->numPorts == 0)
+      return 0;
+
+   //Compare the specified OID with the OID prefix of the table
+   if(oidLen <= object->oidLen)
+   {
+      res = oidComp(oid, oidLen, object->oid, object->oidLen);
+   }
+   else
+   {
+      res = osMemcmp(oid, object->oid, object->oidLen);
+   }
+
+   //The specified OID precedes all the rows of the table?
+   if(res < 0 || (res == 0 && oidLen <= object->oidLen))
+      return context->ports[0].portIndex;
+
+   //The specified OID follows all the rows of the table?
+   if(res > 0)
+      return 0;
+
+   //Point to the instance identifier
+   n = object->oidLen;
+
+   //dot1xPaePortNumber is used as instance identifier
+   error = mibDecodeIndex(oid, oidLen, &n, &portNum);
+
+   //Malformed or truncated instance identifier?
+   if(error)
+   {
+      //The instance identifier still has a lexicographic successor, which
+      //is searched by comparing it with the instance identifier of the rows
+      return ieee8021PaeMibSearchNextPortNum(context, oid + object->oidLen,
+         oidLen - object->oidLen);
+   }
+
+   //Any OID that starts with the instance identifier of a row precedes the
+   //next row
+   return authenticatorGetNextPortIndex(context, portNum);
+}
+
+
+/**
+ * @brief Search the port table for the successor of an instance identifier
+ *
+ * The instance identifier is compared with the encoded port number of the
+ * rows, so that the successor is found even if the instance identifier
+ * cannot be decoded. The port table is sorted by port number, and so are the
+ * encoded instance identifiers of the rows
+ *
+ * @param[in] context Pointer to the 802.1X authenticator context
+ * @param[in] instance Instance identifier
+ * @param[in] instanceLen Length of the instance identifier, in bytes
+ * @return Number of the first port whose instance identifier follows the
+ *   specified one (0 if none)
+ **/
+
+uint_t ieee8021PaeMibSearchNextPortNum(AuthenticatorContext *context,
+   const uint8_t *instance, size_t instanceLen)
+{
+   error_t error;
+   uint_t i;
+   uint_t j;
+   uint_t k;
+   size_t n;
+   uint8_t buffer[8];
+
+   //Initialize the search range
+   i = 0;
+   j = context->numPorts;
+
+   //Search for the first row whose instance identifier follows the
+   //specified one
+   while(i < j)
+   {
+      //Point to the middle of the range
+      k = i + (j - i) / 2;
+
+      //Encode the instance identifier of the row
+      n = 0;
+      error = mibEncodeIndex(buffer, sizeof(buffer), &n,
+         context->ports[k].portIndex);
+      //Any error to report?
+      if(error)
+         return 0;
+
+      //Compare instance identifiers
+      if(oidComp(buffer, n, instance, instanceLen) <= 0)
+      {
+         i = k + 1;
+      }
+      else
+      {
+         j = k;
+      }
+   }
+
+   //No row follows?
+   if(i >= context->numPorts)
+      return 0;
+
+   //Return the number of the next port
+   return context->ports[i].portIndex;
+}
+
 #endif
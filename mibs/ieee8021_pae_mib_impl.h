@@ -48,6 +48,14 @@ void ieee8021PaeMibUnlock(void);
 
 error_t ieee8021PaeMibSetAuthenticatorContext(AuthenticatorContext *context);
 
+const AuthenticatorPortSnapshot *ieee8021PaeMibGetPortRow(uint_t portNum);
+
+uint_t ieee8021PaeMibGetNextPortNum(const MibObject *object,
+   const uint8_t *oid, size_t oidLen);
+
+uint_t ieee8021PaeMibSearchNextPortNum(AuthenticatorContext *context,
+   const uint8_t *instance, size_t instanceLen);
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -40,6 +40,7 @@
 #include "encoding/asn1.h"
 #include "encoding/oid.h"
 #include "authenticator/authenticator_mgmt.h"
+#include "authenticator/authenticator_misc.h"
 #include "debug.h"
 
 //Check TCP/IP stack configuration
@@ -78,6 +79,9 @@ error_t ieee8021PaeMibSetDot1xAuthConfigEntry(const MibObject *object, const uin
    if(n != oidLen)
       return ERROR_INSTANCE_NOT_FOUND;
 
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorMgmtLock(ieee8021PaeMibBase.authContext);
+
    //dot1xAuthAdminControlledDirections object?
    if(osStrcmp(object->name, "dot1xAuthAdminControlledDirections") == 0)
    {
@@ -203,6 +207,11 @@ error_t ieee8021PaeMibSetDot1xAuthConfigEntry(const MibObject *object, const uin
       error = ERROR_OBJECT_NOT_FOUND;
    }
 
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorMgmtUnlock(ieee8021PaeMibBase.authContext);
+   //The cached row may no longer be up to date
+   ieee8021PaeMibBase.rowCachePortNum = 0;
+
    //Return status code
    return error;
 }
@@ -225,7 +234,7 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    size_t n;
    uint_t dot1xPaePortNumber;
    AuthenticatorContext *context;
-   AuthenticatorPort *port;
+   const AuthenticatorPortSnapshot *row;
 
    //Point to the instance identifier
    n = object->oidLen;
@@ -247,17 +256,20 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
       return ERROR_INSTANCE_NOT_FOUND;
 
    //Invalid port index?
-   if(dot1xPaePortNumber < 1 || dot1xPaePortNumber > context->numPorts)
+   if(authenticatorFindPort(context, dot1xPaePortNumber) == NULL)
       return ERROR_INSTANCE_NOT_FOUND;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[dot1xPaePortNumber - 1];
+   //The columns of the row are served from the same snapshot
+   row = ieee8021PaeMibGetPortRow(dot1xPaePortNumber);
+   //Sanity check
+   if(row == NULL)
+      return ERROR_INSTANCE_NOT_FOUND;
 
    //dot1xAuthPaeState object?
    if(osStrcmp(object->name, "dot1xAuthPaeState") == 0)
    {
       //This object indicates the current value of the authenticator PAE state
-      switch(port->authPaeState)
+      switch(row->authPaeState)
       {
       case AUTHENTICATOR_PAE_STATE_INITIALIZE:
          value->integer = IEEE8021_PAE_MIB_AUTH_PAE_STATE_INITIALIZE;
@@ -299,7 +311,7 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    {
       //This object indicates the current value of the backend authentication
       //state machine
-      switch(port->authBackendState)
+      switch(row->authBackendState)
       {
       case AUTHENTICATOR_BACKEND_STATE_REQUEST:
          value->integer = IEEE8021_PAE_MIB_AUTH_BACKEND_STATE_REQUEST;
@@ -349,7 +361,7 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    {
       //This object indicates the current value of the controlled port status
       //parameter for the port
-      switch(port->authPortStatus)
+      switch(row->authPortStatus)
       {
       case AUTHENTICATOR_PORT_STATUS_UNAUTH:
          value->integer = IEEE8021_PAE_MIB_PORT_STATUS_UNAUTH;
@@ -367,7 +379,7 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    {
       //This object indicates the current value of the controlled port control
       //parameter for the port
-      switch(port->portControl)
+      switch(row->portControl)
       {
       case AUTHENTICATOR_PORT_MODE_FORCE_UNAUTH:
          value->integer = IEEE8021_PAE_MIB_PORT_CONTROL_FORCE_UNAUTH;
@@ -388,28 +400,28 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    {
       //This object indicates the value, in seconds, of the quietPeriod constant
       //currently in use by the authenticator PAE state machine
-      value->unsigned32 = port->quietPeriod;
+      value->unsigned32 = row->quietPeriod;
    }
    //dot1xAuthServerTimeout object?
    else if(osStrcmp(object->name, "dot1xAuthServerTimeout") == 0)
    {
       //This object indicates The value, in seconds, of the serverTimeout
       //constant currently in use by the backend authentication state machine
-      value->unsigned32 = port->serverTimeout;
+      value->unsigned32 = row->serverTimeout;
    }
    //dot1xAuthReAuthPeriod object?
    else if(osStrcmp(object->name, "dot1xAuthReAuthPeriod") == 0)
    {
       //This object indicates the value, in seconds, of the reAuthPeriod
       //constant currently in use by the reauthentication timer state machine
-      value->unsigned32 = port->reAuthPeriod;
+      value->unsigned32 = row->reAuthPeriod;
    }
    //dot1xAuthReAuthEnabled object?
    else if(osStrcmp(object->name, "dot1xAuthReAuthEnabled") == 0)
    {
       //This object indicates the enable/disable control used by the
       //reauthentication timer state machine
-      if(port->reAuthEnabled)
+      if(row->reAuthEnabled)
       {
          value->integer = MIB_TRUTH_VALUE_TRUE;
       }
@@ -423,7 +435,7 @@ error_t ieee8021PaeMibGetDot1xAuthConfigEntry(const MibObject *object, const uin
    {
       //This object indicates the value of the keyTransmissionEnabled constant
       //currently in use by the authenticator PAE state machine
-      if(port->keyTxEnabled)
+      if(row->keyTxEnabled)
       {
          value->integer = MIB_TRUTH_VALUE_TRUE;
       }
@@ -458,15 +470,10 @@ error_t ieee8021PaeMibGetNextDot1xAuthConfigEntry(const MibObject *object, const
    size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
 {
    error_t error;
-   uint_t i;
    size_t n;
-   uint16_t portNum;
-   uint16_t curPortNum;
+   uint_t portNum;
    AuthenticatorContext *context;
 
-   //Initialize variable
-   portNum = 0;
-
    //Point to the 802.1X authenticator context
    context = ieee8021PaeMibBase.authContext;
    //Make sure the context is valid
@@ -480,33 +487,8 @@ error_t ieee8021PaeMibGetNextDot1xAuthConfigEntry(const MibObject *object, const
    //Copy OID prefix
    osMemcpy(nextOid, object->oid, object->oidLen);
 
-   //Loop through the ports of the bridge
-   for(i = 0; i < context->numPorts; i++)
-   {
-      //Retrieve the port number associated with the current port
-      curPortNum = context->ports[i].portIndex;
-
-      //Append the instance identifier to the OID prefix
-      n = object->oidLen;
-
-      //dot1xPaePortNumber is used as instance identifier
-      error = mibEncodeIndex(nextOid, *nextOidLen, &n, curPortNum);
-      //Any error to report?
-      if(error)
-         return error;
-
-      //Check whether the resulting object identifier lexicographically
-      //follows the specified OID
-      if(oidComp(nextOid, n, oid, oidLen) > 0)
-      {
-         //Save the closest object identifier that follows the specified
-         //OID in lexicographic order
-         if(portNum == 0 || curPortNum < portNum)
-         {
-            portNum = curPortNum;
-         }
-      }
-   }
+   //Retrieve the port that follows the specified OID in lexicographic order
+   portNum = ieee8021PaeMibGetNextPortNum(object, oid, oidLen);
 
    //The specified OID does not lexicographically precede the name
    //of some object?
@@ -546,7 +528,7 @@ error_t ieee8021PaeMibGetDot1xAuthStatsEntry(const MibObject *object, const uint
    size_t n;
    uint_t dot1xPaePortNumber;
    AuthenticatorContext *context;
-   AuthenticatorPort *port;
+   const AuthenticatorPortSnapshot *row;
 
    //Point to the instance identifier
    n = object->oidLen;
@@ -568,88 +550,91 @@ error_t ieee8021PaeMibGetDot1xAuthStatsEntry(const MibObject *object, const uint
       return ERROR_INSTANCE_NOT_FOUND;
 
    //Invalid port index?
-   if(dot1xPaePortNumber < 1 || dot1xPaePortNumber > context->numPorts)
+   if(authenticatorFindPort(context, dot1xPaePortNumber) == NULL)
       return ERROR_INSTANCE_NOT_FOUND;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[dot1xPaePortNumber - 1];
+   //The columns of the row are served from the same snapshot
+   row = ieee8021PaeMibGetPortRow(dot1xPaePortNumber);
+   //Sanity check
+   if(row == NULL)
+      return ERROR_INSTANCE_NOT_FOUND;
 
    //dot1xAuthEapolFramesRx object?
    if(osStrcmp(object->name, "dot1xAuthEapolFramesRx") == 0)
    {
       //Number of valid EAPOL frames of any type that have been received by this
       //authenticator
-      value->counter32 = port->stats.eapolFramesRx;
+      value->counter32 = row->stats.eapolFramesRx;
    }
    //dot1xAuthEapolFramesTx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolFramesTx") == 0)
    {
       //Number of EAPOL frames of any type that have been transmitted by this
       //authenticator
-      value->counter32 = port->stats.eapolFramesTx;
+      value->counter32 = row->stats.eapolFramesTx;
    }
    //dot1xAuthEapolStartFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolStartFramesRx") == 0)
    {
       //Number of EAPOL Start frames that have been received by this
       //authenticator
-      value->counter32 = port->stats.eapolStartFramesRx;
+      value->counter32 = row->stats.eapolStartFramesRx;
    }
    //dot1xAuthEapolLogoffFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolLogoffFramesRx") == 0)
    {
       //Number of EAPOL Logoff frames that have been received by this
       //authenticator
-      value->counter32 = port->stats.eapolLogoffFramesRx;
+      value->counter32 = row->stats.eapolLogoffFramesRx;
    }
    //dot1xAuthEapolRespIdFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolRespIdFramesRx") == 0)
    {
       //Number of EAP Resp/Id frames that have been received by this
       //authenticator
-      value->counter32 = port->stats.eapolRespIdFramesRx;
+      value->counter32 = row->stats.eapolRespIdFramesRx;
    }
    //dot1xAuthEapolRespFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolRespFramesRx") == 0)
    {
       //Number of valid EAP Response frames (other than Resp/Id frames) that
       //have been received by this authenticator
-      value->counter32 = port->stats.eapolRespFramesRx;
+      value->counter32 = row->stats.eapolRespFramesRx;
    }
    //dot1xAuthEapolReqIdFramesTx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolReqIdFramesTx") == 0)
    {
       //Number of EAP Req/Id frames that have been transmitted by this
       //authenticator
-      value->counter32 = port->stats.eapolReqIdFramesTx;
+      value->counter32 = row->stats.eapolReqIdFramesTx;
    }
    //dot1xAuthEapolReqFramesTx object?
    else if(osStrcmp(object->name, "dot1xAuthEapolReqFramesTx") == 0)
    {
       //Number of EAP Request frames (other than Rq/Id frames) that have been
       //transmitted by this authenticator
-      value->counter32 = port->stats.eapolReqFramesTx;
+      value->counter32 = row->stats.eapolReqFramesTx;
    }
    //dot1xAuthInvalidEapolFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthInvalidEapolFramesRx") == 0)
    {
       //Number of EAPOL frames that have been received by this authenticator
       //in which the frame type is not recognized
-      value->counter32 = port->stats.invalidEapolFramesRx;
+      value->counter32 = row->stats.invalidEapolFramesRx;
    }
    //dot1xAuthEapLengthErrorFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthEapLengthErrorFramesRx") == 0)
    {
       //Number of EAPOL frames that have been received by this authenticator
       //in which the Packet Body Length field is invalid
-      value->counter32 = port->stats.eapLengthErrorFramesRx;
+      value->counter32 = row->stats.eapLengthErrorFramesRx;
    }
    //dot1xAuthLastEapolFrameVersion object?
    else if(osStrcmp(object->name, "dot1xAuthLastEapolFrameVersion") == 0)
    {
       //Protocol version number carried in the most recently received EAPOL
       //frame
-      value->unsigned32 = port->stats.lastEapolFrameVersion;
+      value->unsigned32 = row->stats.lastEapolFrameVersion;
    }
    //dot1xAuthLastEapolFrameSource object?
    else if(osStrcmp(object->name, "dot1xAuthLastEapolFrameSource") == 0)
@@ -659,7 +644,7 @@ error_t ieee8021PaeMibGetDot1xAuthStatsEntry(const MibObject *object, const uint
       if(*valueLen >= sizeof(MacAddr))
       {
          //Copy object value
-         macCopyAddr(value->octetString, &port->supplicantMacAddr);
+         macCopyAddr(value->octetString, &row->supplicantMacAddr);
          //Return object length
          *valueLen = sizeof(MacAddr);
       }
@@ -695,15 +680,10 @@ error_t ieee8021PaeMibGetNextDot1xAuthStatsEntry(const MibObject *object, const
    size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
 {
    error_t error;
-   uint_t i;
    size_t n;
-   uint16_t portNum;
-   uint16_t curPortNum;
+   uint_t portNum;
    AuthenticatorContext *context;
 
-   //Initialize variable
-   portNum = 0;
-
    //Point to the 802.1X authenticator context
    context = ieee8021PaeMibBase.authContext;
    //Make sure the context is valid
@@ -717,33 +697,8 @@ error_t ieee8021PaeMibGetNextDot1xAuthStatsEntry(const MibObject *object, const
    //Copy OID prefix
    osMemcpy(nextOid, object->oid, object->oidLen);
 
-   //Loop through the ports of the bridge
-   for(i = 0; i < context->numPorts; i++)
-   {
-      //Retrieve the port number associated with the current port
-      curPortNum = context->ports[i].portIndex;
-
-      //Append the instance identifier to the OID prefix
-      n = object->oidLen;
-
-      //dot1xPaePortNumber is used as instance identifier
-      error = mibEncodeIndex(nextOid, *nextOidLen, &n, curPortNum);
-      //Any error to report?
-      if(error)
-         return error;
-
-      //Check whether the resulting object identifier lexicographically
-      //follows the specified OID
-      if(oidComp(nextOid, n, oid, oidLen) > 0)
-      {
-         //Save the closest object identifier that follows the specified
-         //OID in lexicographic order
-         if(portNum == 0 || curPortNum < portNum)
-         {
-            portNum = curPortNum;
-         }
-      }
-   }
+   //Retrieve the port that follows the specified OID in lexicographic order
+   portNum = ieee8021PaeMibGetNextPortNum(object, oid, oidLen);
 
    //The specified OID does not lexicographically precede the name
    //of some object?
@@ -783,7 +738,7 @@ error_t ieee8021PaeMibGetDot1xAuthSessionStatsEntry(const MibObject *object, con
    size_t n;
    uint_t dot1xPaePortNumber;
    AuthenticatorContext *context;
-   AuthenticatorPort *port;
+   const AuthenticatorPortSnapshot *row;
 
    //Point to the instance identifier
    n = object->oidLen;
@@ -805,37 +760,40 @@ error_t ieee8021PaeMibGetDot1xAuthSessionStatsEntry(const MibObject *object, con
       return ERROR_INSTANCE_NOT_FOUND;
 
    //Invalid port index?
-   if(dot1xPaePortNumber < 1 || dot1xPaePortNumber > context->numPorts)
+   if(authenticatorFindPort(context, dot1xPaePortNumber) == NULL)
       return ERROR_INSTANCE_NOT_FOUND;
 
-   //Point to the port that matches the specified port index
-   port = &context->ports[dot1xPaePortNumber - 1];
+   //The columns of the row are served from the same snapshot
+   row = ieee8021PaeMibGetPortRow(dot1xPaePortNumber);
+   //Sanity check
+   if(row == NULL)
+      return ERROR_INSTANCE_NOT_FOUND;
 
    //dot1xAuthSessionOctetsRx object?
    if(osStrcmp(object->name, "dot1xAuthSessionOctetsRx") == 0)
    {
       //Number of octets received in user data frames on this port during the
       //session
-      value->counter64 = port->sessionStats.sessionOctetsRx;
+      value->counter64 = row->sessionStats.sessionOctetsRx;
    }
    //dot1xAuthSessionOctetsTx object?
    else if(osStrcmp(object->name, "dot1xAuthSessionOctetsTx") == 0)
    {
       //Number of octets transmitted in user data frames on this port during
       //the session
-      value->counter64 = port->sessionStats.sessionOctetsTx;
+      value->counter64 = row->sessionStats.sessionOctetsTx;
    }
    //dot1xAuthSessionFramesRx object?
    else if(osStrcmp(object->name, "dot1xAuthSessionFramesRx") == 0)
    {
       //Number of user data frames received on this port during the session
-      value->counter32 = port->sessionStats.sessionFramesRx;
+      value->counter32 = row->sessionStats.sessionFramesRx;
    }
    //dot1xAuthSessionFramesTx object?
    else if(osStrcmp(object->name, "dot1xAuthSessionFramesTx") == 0)
    {
       //Number of user data frames transmitted on this port during the session
-      value->counter32 = port->sessionStats.sessionFramesTx;
+      value->counter32 = row->sessionStats.sessionFramesTx;
    }
    //dot1xAuthSessionId object?
    else if(osStrcmp(object->name, "dot1xAuthSessionId") == 0)
@@ -854,13 +812,13 @@ error_t ieee8021PaeMibGetDot1xAuthSessionStatsEntry(const MibObject *object, con
    else if(osStrcmp(object->name, "dot1xAuthSessionTime") == 0)
    {
       //Duration of the session in seconds
-      value->timeTicks = port->sessionStats.sessionTime * 100;
+      value->timeTicks = row->sessionStats.sessionTime * 100;
    }
    //dot1xAuthSessionTerminateCause object?
    else if(osStrcmp(object->name, "dot1xAuthSessionTerminateCause") == 0)
    {
       //Reason for the session termination
-      switch(port->sessionStats.sessionTerminateCause)
+      switch(row->sessionStats.sessionTerminateCause)
       {
       case AUTHENTICATOR_TERMINATE_CAUSE_SUPPLICANT_LOGOFF:
          value->integer = IEEE8021_PAE_MIB_TERMINATE_CAUSE_SUPPLICANT_LOGOFF;
@@ -895,13 +853,13 @@ error_t ieee8021PaeMibGetDot1xAuthSessionStatsEntry(const MibObject *object, con
    else if(osStrcmp(object->name, "dot1xAuthSessionUserName") == 0)
    {
       //Retrieve the length of the user name
-      n = osStrlen(port->aaaIdentity);
+      n = osStrlen(row->aaaIdentity);
 
       //Make sure the buffer is large enough to hold the entire object
       if(*valueLen >= n)
       {
          //Copy object value
-         osMemcpy(value->octetString, port->aaaIdentity, n);
+         osMemcpy(value->octetString, row->aaaIdentity, n);
          //Return object length
          *valueLen = n;
       }
@@ -937,15 +895,10 @@ error_t ieee8021PaeMibGetNextDot1xAuthSessionStatsEntry(const MibObject *object,
    size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
 {
    error_t error;
-   uint_t i;
    size_t n;
-   uint16_t portNum;
-   uint16_t curPortNum;
+   uint_t portNum;
    AuthenticatorContext *context;
 
-   //Initialize variable
-   portNum = 0;
-
    //Point to the 802.1X authenticator context
    context = ieee8021PaeMibBase.authContext;
    //Make sure the context is valid
@@ -959,33 +912,8 @@ error_t ieee8021PaeMibGetNextDot1xAuthSessionStatsEntry(const MibObject *object,
    //Copy OID prefix
    osMemcpy(nextOid, object->oid, object->oidLen);
 
-   //Loop through the ports of the bridge
-   for(i = 0; i < context->numPorts; i++)
-   {
-      //Retrieve the port number associated with the current port
-      curPortNum = context->ports[i].portIndex;
-
-      //Append the instance identifier to the OID prefix
-      n = object->oidLen;
-
-      //dot1xPaePortNumber is used as instance identifier
-      error = mibEncodeIndex(nextOid, *nextOidLen, &n, curPortNum);
-      //Any error to report?
-      if(error)
-         return error;
-
-      //Check whether the resulting object identifier lexicographically
-      //follows the specified OID
-      if(oidComp(nextOid, n, oid, oidLen) > 0)
-      {
-         //Save the closest object identifier that follows the specified
-         //OID in lexicographic order
-         if(portNum == 0 || curPortNum < portNum)
-         {
-            portNum = curPortNum;
-         }
-      }
-   }
+   //Retrieve the port that follows the specified OID in lexicographic order
+   portNum = ieee8021PaeMibGetNextPortNum(object, oid, oidLen);
 
    //The specified OID does not lexicographically precede the name
    //of some object?
@@ -1007,4 +935,25 @@ error_t ieee8021PaeMibGetNextDot1xAuthSessionStatsEntry(const MibObject *object,
    return NO_ERROR;
 }
 
+
+/**
+ * @brief Get dot1xExtChangeGeneration object value
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] oid Object identifier (object name and instance identifier)
+ * @param[in] oidLen Length of the OID, in bytes
+ * @param[out] value Object value
+ * @param[in,out] valueLen Length of the object value, in bytes
+ * @return Error code
+ **/
+
+error_t ieee8021PaeMibGetDot1xExtChangeGeneration(const MibObject *object, const uint8_t *oid,
+   size_t oidLen, MibVariant *value, size_t *valueLen)
+{
+   //Generation of the last change of authPaeState or authPortStatus on any
+   //port. A manager fetches the rows of the changed ports only when the
+   //value differs from the one it saw on the previous poll
+   return authenticatorGetChangeGeneration(ieee8021PaeMibBase.authContext,
+      &value->counter32);
+}
+
 #endif
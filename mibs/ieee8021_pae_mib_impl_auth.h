@@ -61,6 +61,9 @@ error_t ieee8021PaeMibGetDot1xAuthSessionStatsEntry(const MibObject *object, con
 error_t ieee8021PaeMibGetNextDot1xAuthSessionStatsEntry(const MibObject *object, const uint8_t *oid,
    size_t oidLen, uint8_t *nextOid, size_t *nextOidLen);
 
+error_t ieee8021PaeMibGetDot1xExtChangeGeneration(const MibObject *object, const uint8_t *oid,
+   size_t oidLen, MibVariant *value, size_t *valueLen);
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -148,6 +148,9 @@ error_t ieee8021PaeMibSetDot1xPaePortEntry(const MibObject *object, const uint8_
    if(n != oidLen)
       return ERROR_INSTANCE_NOT_FOUND;
 
+   //Acquire exclusive access to the 802.1X authenticator context
+   authenticatorMgmtLock(ieee8021PaeMibBase.authContext);
+
    //dot1xPaePortInitialize object?
    if(osStrcmp(object->name, "dot1xPaePortInitialize") == 0)
    {
@@ -198,6 +201,11 @@ error_t ieee8021PaeMibSetDot1xPaePortEntry(const MibObject *object, const uint8_
       error = ERROR_OBJECT_NOT_FOUND;
    }
 
+   //Release exclusive access to the 802.1X authenticator context
+   authenticatorMgmtUnlock(ieee8021PaeMibBase.authContext);
+   //The cached row may no longer be up to date
+   ieee8021PaeMibBase.rowCachePortNum = 0;
+
    //Return status code
    return error;
 #else
@@ -290,15 +298,10 @@ error_t ieee8021PaeMibGetNextDot1xPaePortEntry(const MibObject *object, const ui
    size_t oidLen, uint8_t *nextOid, size_t *nextOidLen)
 {
    error_t error;
-   uint_t i;
    size_t n;
-   uint16_t portNum;
-   uint16_t curPortNum;
+   uint_t portNum;
    AuthenticatorContext *context;
 
-   //Initialize variable
-   portNum = 0;
-
    //Point to the 802.1X authenticator context
    context = ieee8021PaeMibBase.authContext;
    //Make sure the context is valid
@@ -312,33 +315,8 @@ error_t ieee8021PaeMibGetNextDot1xPaePortEntry(const MibObject *object, const ui
    //Copy OID prefix
    osMemcpy(nextOid, object->oid, object->oidLen);
 
-   //Loop through the ports of the bridge
-   for(i = 0; i < context->numPorts; i++)
-   {
-      //Retrieve the port number associated with the current port
-      curPortNum = context->ports[i].portIndex;
-
-      //Append the instance identifier to the OID prefix
-      n = object->oidLen;
-
-      //dot1xPaePortNumber is used as instance identifier
-      error = mibEncodeIndex(nextOid, *nextOidLen, &n, curPortNum);
-      //Any error to report?
-      if(error)
-         return error;
-
-      //Check whether the resulting object identifier lexicographically
-      //follows the specified OID
-      if(oidComp(nextOid, n, oid, oidLen) > 0)
-      {
-         //Save the closest object identifier that follows the specified
-         //OID in lexicographic order
-         if(portNum == 0 || curPortNum < portNum)
-         {
-            portNum = curPortNum;
-         }
-      }
-   }
+   //Retrieve the port that follows the specified OID in lexicographic order
+   portNum = ieee8021PaeMibGetNextPortNum(object, oid, oidLen);
 
    //The specified OID does not lexicographically precede the name
    //of some object?
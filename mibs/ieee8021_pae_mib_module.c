@@ -880,4 +880,54 @@ const MibModule ieee8021PaeMibModule =
    ieee8021PaeMibUnlock
 };
 
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+
+/**
+ * @brief Port Access Control extension MIB objects
+ **/
+
+const MibObject ieee8021PaeExtMibObjects[] =
+{
+   //dot1xExtChangeGeneration object
+   {
+      "dot1xExtChangeGeneration",
+      {IEEE8021_PAE_EXT_MIB_OID, 1, 1},
+      IEEE8021_PAE_EXT_MIB_OID_LEN + 2,
+      ASN1_CLASS_APPLICATION,
+      MIB_TYPE_COUNTER32,
+      MIB_ACCESS_READ_ONLY,
+      NULL,
+      NULL,
+      sizeof(uint32_t),
+      NULL,
+      ieee8021PaeMibGetDot1xExtChangeGeneration,
+      NULL
+   }
+};
+
+
+/**
+ * @brief Port Access Control extension MIB module
+ *
+ * The module shares its base with the Port Access Control MIB module and
+ * must be registered along with it
+ *
+ **/
+
+const MibModule ieee8021PaeExtMibModule =
+{
+   "IEEE8021-PAE-EXT-MIB",
+   {IEEE8021_PAE_EXT_MIB_OID},
+   IEEE8021_PAE_EXT_MIB_OID_LEN,
+   ieee8021PaeExtMibObjects,
+   arraysize(ieee8021PaeExtMibObjects),
+   NULL,
+   NULL,
+   NULL,
+   ieee8021PaeMibLock,
+   ieee8021PaeMibUnlock
+};
+
+#endif
+
 #endif
@@ -50,6 +50,16 @@
    #error IEEE8021_PAE_MIB_SET_SUPPORT parameter is not valid
 #endif
 
+//Enterprise subtree of the extension MIB module, in BER encoding. The
+//default value is the experimentation subtree of the Net-SNMP project
+//(1.3.6.1.4.1.8072.9999.9999) and should be replaced by the vendor's own
+#ifndef IEEE8021_PAE_EXT_MIB_OID
+   #define IEEE8021_PAE_EXT_MIB_OID 43, 6, 1, 4, 1, 191, 8, 206, 15, 206, 15
+   #define IEEE8021_PAE_EXT_MIB_OID_LEN 11
+#elif !defined(IEEE8021_PAE_EXT_MIB_OID_LEN)
+   #error IEEE8021_PAE_EXT_MIB_OID_LEN parameter is not defined
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -184,6 +194,8 @@ typedef struct
 {
 #if (AUTHENTICATOR_SUPPORT == ENABLED)
    AuthenticatorContext *authContext;
+   uint_t rowCachePortNum;
+   AuthenticatorPortSnapshot rowCache;
 #endif
 } Ieee8021PaeMibBase;
 
@@ -193,6 +205,11 @@ extern Ieee8021PaeMibBase ieee8021PaeMibBase;
 extern const MibObject ieee8021PaeMibObjects[];
 extern const MibModule ieee8021PaeMibModule;
 
+#if (AUTHENTICATOR_SUPPORT == ENABLED)
+extern const MibObject ieee8021PaeExtMibObjects[];
+extern const MibModule ieee8021PaeExtMibModule;
+#endif
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -43,6 +43,12 @@
 
 //RADIUS port number
 #define RADIUS_PORT 1812
+//RADIUS accounting port number
+#define RADIUS_ACCT_PORT 1813
+//RADIUS over TLS port number
+#define RADIUS_TLS_PORT 2083
+//Dynamic Authorization server port number
+#define RADIUS_DAE_PORT 3799
 
 //C++ guard
 #ifdef __cplusplus
@@ -63,7 +69,13 @@ typedef enum
    RADIUS_CODE_ACCOUNTING_RESPONSE  = 5,  ///<Accounting-Response
    RADIUS_CODE_ACCESS_CHALLENGE     = 11, ///<Access-Challenge
    RADIUS_CODE_STATUS_SERVER        = 12, ///<Status-Server (experimental)
-   RADIUS_CODE_STATUS_CLIENT        = 13  ///<Status-Client (experimental)
+   RADIUS_CODE_STATUS_CLIENT        = 13, ///<Status-Client (experimental)
+   RADIUS_CODE_DISCONNECT_REQUEST   = 40, ///<Disconnect-Request
+   RADIUS_CODE_DISCONNECT_ACK       = 41, ///<Disconnect-ACK
+   RADIUS_CODE_DISCONNECT_NAK       = 42, ///<Disconnect-NAK
+   RADIUS_CODE_COA_REQUEST          = 43, ///<CoA-Request
+   RADIUS_CODE_COA_ACK              = 44, ///<CoA-ACK
+   RADIUS_CODE_COA_NAK              = 45  ///<CoA-NAK
 } RadiusCode;
 
 
@@ -139,5 +139,237 @@ const RadiusAttribute *radiusGetAttribute(const RadiusPacket *packet,
    return NULL;
 }
 
+
+/**
+ * @brief Validate the attributes of a RADIUS packet and build an index
+ *
+ * The attribute list is walked once. Each attribute is recorded in order of
+ * appearance, and the entries sharing the same type are chained together so
+ * that any given attribute, or a run of attributes such as EAP-Message, can be
+ * retrieved without rescanning the packet. When the packet carries more
+ * attributes than the index can hold, the remaining attributes are still
+ * validated, and the lookups fall back to a linear scan past the last indexed
+ * attribute
+ *
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[out] index Attribute index
+ * @return Error code
+ **/
+
+error_t radiusParseAttributes(const RadiusPacket *packet,
+   RadiusAttrIndex *index)
+{
+   size_t i;
+   size_t n;
+   uint_t k;
+   const RadiusAttribute *attribute;
+
+   //Retrieve the actual length of the RADIUS packet
+   n = ntohs(packet->length);
+
+   //Malformed RADIUS packet?
+   if(n < sizeof(RadiusPacket))
+      return ERROR_INVALID_LENGTH;
+
+   //Calculate the length of the RADIUS attributes
+   n -= sizeof(RadiusPacket);
+
+   //Initialize the attribute index
+   index->packet = packet;
+   index->length = n;
+   index->unindexedOffset = n;
+   index->numEntries = 0;
+   osMemset(index->first, RADIUS_ATTR_INDEX_NONE, sizeof(index->first));
+
+   //Loop through the attributes
+   for(i = 0; i < n; i += attribute->length)
+   {
+      //Malformed attribute?
+      if((n - i) < sizeof(RadiusAttribute))
+         return ERROR_INVALID_SYNTAX;
+
+      //Point to the attribute
+      attribute = (RadiusAttribute *) (packet->attributes + i);
+
+      //Malformed attribute?
+      if(attribute->length < sizeof(RadiusAttribute) ||
+         attribute->length > (n - i))
+      {
+         return ERROR_INVALID_SYNTAX;
+      }
+
+      //The index is full?
+      if(index->numEntries >= RADIUS_MAX_INDEXED_ATTRIBUTES)
+      {
+         //Remember where the unindexed attributes start
+         if(index->unindexedOffset == n)
+         {
+            index->unindexedOffset = i;
+         }
+
+         //Keep validating the remaining attributes
+         continue;
+      }
+
+      //Allocate a new entry
+      k = index->numEntries++;
+
+      //Save the location of the attribute
+      index->entries[k].offset = (uint16_t) i;
+      index->entries[k].type = attribute->type;
+      index->entries[k].next = RADIUS_ATTR_INDEX_NONE;
+
+      //Chain the entry to the previous attribute of the same type, if any
+      if(index->first[attribute->type] == RADIUS_ATTR_INDEX_NONE)
+      {
+         index->first[attribute->type] = (uint8_t) k;
+      }
+      else
+      {
+         index->entries[index->last[attribute->type]].next = (uint8_t) k;
+      }
+
+      //Keep track of the most recent attribute of this type
+      index->last[attribute->type] = (uint8_t) k;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve the first occurrence of a given attribute
+ * @param[in] index Attribute index
+ * @param[in] type Attribute type
+ * @param[out] entry Position in the index (optional parameter)
+ * @return If the specified attribute is found, a pointer to the corresponding
+ *   attribute is returned. Otherwise NULL pointer is returned
+ **/
+
+const RadiusAttribute *radiusGetFirstAttribute(const RadiusAttrIndex *index,
+   uint8_t type, uint_t *entry)
+{
+   uint_t k;
+
+   //Retrieve the first entry with the specified type
+   k = index->first[type];
+
+   //Save the position in the index
+   if(entry != NULL)
+   {
+      *entry = k;
+   }
+
+   //The specified attribute type was not found in the index?
+   if(k == RADIUS_ATTR_INDEX_NONE)
+   {
+      //Search the attributes that could not be indexed
+      return radiusFindUnindexedAttribute(index, type,
+         index->unindexedOffset, entry);
+   }
+
+   //Point to the attribute
+   return (RadiusAttribute *) (index->packet->attributes +
+      index->entries[k].offset);
+}
+
+
+/**
+ * @brief Retrieve the next occurrence of an attribute
+ * @param[in] index Attribute index
+ * @param[in,out] entry Position in the index
+ * @return If another occurrence of the attribute is found, a pointer to the
+ *   corresponding attribute is returned. Otherwise NULL pointer is returned
+ **/
+
+const RadiusAttribute *radiusGetNextAttribute(const RadiusAttrIndex *index,
+   uint_t *entry)
+{
+   uint_t k;
+   const RadiusAttribute *attribute;
+
+   //End of the chain?
+   if(*entry == RADIUS_ATTR_INDEX_NONE)
+      return NULL;
+
+   //The current attribute lies past the index?
+   if(*entry >= RADIUS_ATTR_INDEX_UNINDEXED)
+   {
+      //Point to the current attribute
+      attribute = (RadiusAttribute *) (index->packet->attributes +
+         *entry - RADIUS_ATTR_INDEX_UNINDEXED);
+
+      //Search the subsequent attributes
+      return radiusFindUnindexedAttribute(index, attribute->type,
+         *entry - RADIUS_ATTR_INDEX_UNINDEXED + attribute->length, entry);
+   }
+
+   //Retrieve the next entry with the same type
+   k = index->entries[*entry].next;
+
+   //Last indexed occurrence?
+   if(k == RADIUS_ATTR_INDEX_NONE)
+   {
+      //Search the attributes that could not be indexed
+      return radiusFindUnindexedAttribute(index, index->entries[*entry].type,
+         index->unindexedOffset, entry);
+   }
+
+   //Save the position in the index
+   *entry = k;
+
+   //Point to the attribute
+   return (RadiusAttribute *) (index->packet->attributes +
+      index->entries[k].offset);
+}
+
+
+/**
+ * @brief Search the attributes that could not be indexed
+ * @param[in] index Attribute index
+ * @param[in] type Attribute type
+ * @param[in] offset Offset from which to start the linear scan
+ * @param[out] entry Position past the index (optional parameter)
+ * @return If the specified attribute is found, a pointer to the corresponding
+ *   attribute is returned. Otherwise NULL pointer is returned
+ **/
+
+const RadiusAttribute *radiusFindUnindexedAttribute(const RadiusAttrIndex *index,
+   uint8_t type, size_t offset, uint_t *entry)
+{
+   size_t i;
+   const RadiusAttribute *attribute;
+
+   //The attribute list was validated when the index was built
+   for(i = offset; i < index->length; i += attribute->length)
+   {
+      //Point to the current attribute
+      attribute = (RadiusAttribute *) (index->packet->attributes + i);
+
+      //Matching attribute type?
+      if(attribute->type == type)
+      {
+         //Save the position of the attribute
+         if(entry != NULL)
+         {
+            *entry = RADIUS_ATTR_INDEX_UNINDEXED + (uint_t) i;
+         }
+
+         //Return a pointer to the attribute
+         return attribute;
+      }
+   }
+
+   //Save the position
+   if(entry != NULL)
+   {
+      *entry = RADIUS_ATTR_INDEX_NONE;
+   }
+
+   //The specified attribute type was not found
+   return NULL;
+}
+
 #endif
 
@@ -34,9 +34,21 @@
 //Dependencies
 #include "radius/radius.h"
 
+//Maximum number of attributes in the attribute index
+#ifndef RADIUS_MAX_INDEXED_ATTRIBUTES
+   #define RADIUS_MAX_INDEXED_ATTRIBUTES 64
+#elif (RADIUS_MAX_INDEXED_ATTRIBUTES < 1 || RADIUS_MAX_INDEXED_ATTRIBUTES > 254)
+   #error RADIUS_MAX_INDEXED_ATTRIBUTES parameter is not valid
+#endif
+
 //Maximum length of attribute value
 #define RADIUS_MAX_ATTR_VALUE_LEN 253
 
+//Invalid entry in the attribute index
+#define RADIUS_ATTR_INDEX_NONE 0xFF
+//Positions past the attribute index (offset of the attribute, plus 256)
+#define RADIUS_ATTR_INDEX_UNINDEXED 0x100
+
 //C++ guard
 #ifdef __cplusplus
 extern "C" {
@@ -292,6 +304,87 @@ typedef enum
 } RadiusPortType;
 
 
+/**
+ * @brief Accounting status types
+ **/
+
+typedef enum
+{
+   RADIUS_ACCT_STATUS_TYPE_START          = 1, ///<Start
+   RADIUS_ACCT_STATUS_TYPE_STOP           = 2, ///<Stop
+   RADIUS_ACCT_STATUS_TYPE_INTERIM_UPDATE = 3, ///<Interim-Update
+   RADIUS_ACCT_STATUS_TYPE_ACCOUNTING_ON  = 7, ///<Accounting-On
+   RADIUS_ACCT_STATUS_TYPE_ACCOUNTING_OFF = 8  ///<Accounting-Off
+} RadiusAcctStatusType;
+
+
+/**
+ * @brief Accounting authentication methods
+ **/
+
+typedef enum
+{
+   RADIUS_ACCT_AUTHENTIC_RADIUS = 1, ///<RADIUS
+   RADIUS_ACCT_AUTHENTIC_LOCAL  = 2, ///<Local
+   RADIUS_ACCT_AUTHENTIC_REMOTE = 3  ///<Remote
+} RadiusAcctAuthentic;
+
+
+/**
+ * @brief Error-Cause values
+ **/
+
+typedef enum
+{
+   RADIUS_ERROR_CAUSE_RESIDUAL_CONTEXT_REMOVED      = 201, ///<Residual Session Context Removed
+   RADIUS_ERROR_CAUSE_UNSUPPORTED_ATTRIBUTE         = 401, ///<Unsupported Attribute
+   RADIUS_ERROR_CAUSE_MISSING_ATTRIBUTE             = 402, ///<Missing Attribute
+   RADIUS_ERROR_CAUSE_NAS_ID_MISMATCH               = 403, ///<NAS Identification Mismatch
+   RADIUS_ERROR_CAUSE_INVALID_REQUEST               = 404, ///<Invalid Request
+   RADIUS_ERROR_CAUSE_UNSUPPORTED_SERVICE           = 405, ///<Unsupported Service
+   RADIUS_ERROR_CAUSE_UNSUPPORTED_EXTENSION         = 406, ///<Unsupported Extension
+   RADIUS_ERROR_CAUSE_INVALID_ATTRIBUTE_VALUE       = 407, ///<Invalid Attribute Value
+   RADIUS_ERROR_CAUSE_ADMINISTRATIVELY_PROHIBITED   = 501, ///<Administratively Prohibited
+   RADIUS_ERROR_CAUSE_REQUEST_NOT_ROUTABLE          = 502, ///<Request Not Routable (Proxy)
+   RADIUS_ERROR_CAUSE_SESSION_CONTEXT_NOT_FOUND     = 503, ///<Session Context Not Found
+   RADIUS_ERROR_CAUSE_SESSION_CONTEXT_NOT_REMOVABLE = 504, ///<Session Context Not Removable
+   RADIUS_ERROR_CAUSE_OTHER_PROXY_PROCESSING_ERROR  = 505, ///<Other Proxy Processing Error
+   RADIUS_ERROR_CAUSE_RESOURCES_UNAVAILABLE         = 506, ///<Resources Unavailable
+   RADIUS_ERROR_CAUSE_REQUEST_INITIATED             = 507  ///<Request Initiated
+} RadiusErrorCause;
+
+
+/**
+ * @brief Accounting terminate causes
+ **/
+
+typedef enum
+{
+   RADIUS_ACCT_TERMINATE_CAUSE_USER_REQUEST          = 1,  ///<User Request
+   RADIUS_ACCT_TERMINATE_CAUSE_LOST_CARRIER          = 2,  ///<Lost Carrier
+   RADIUS_ACCT_TERMINATE_CAUSE_LOST_SERVICE          = 3,  ///<Lost Service
+   RADIUS_ACCT_TERMINATE_CAUSE_IDLE_TIMEOUT          = 4,  ///<Idle Timeout
+   RADIUS_ACCT_TERMINATE_CAUSE_SESSION_TIMEOUT       = 5,  ///<Session Timeout
+   RADIUS_ACCT_TERMINATE_CAUSE_ADMIN_RESET           = 6,  ///<Admin Reset
+   RADIUS_ACCT_TERMINATE_CAUSE_ADMIN_REBOOT          = 7,  ///<Admin Reboot
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_ERROR            = 8,  ///<Port Error
+   RADIUS_ACCT_TERMINATE_CAUSE_NAS_ERROR             = 9,  ///<NAS Error
+   RADIUS_ACCT_TERMINATE_CAUSE_NAS_REQUEST           = 10, ///<NAS Request
+   RADIUS_ACCT_TERMINATE_CAUSE_NAS_REBOOT            = 11, ///<NAS Reboot
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_UNNEEDED         = 12, ///<Port Unneeded
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_PREEMPTED        = 13, ///<Port Preempted
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_SUSPENDED        = 14, ///<Port Suspended
+   RADIUS_ACCT_TERMINATE_CAUSE_SERVICE_UNAVAILABLE   = 15, ///<Service Unavailable
+   RADIUS_ACCT_TERMINATE_CAUSE_CALLBACK              = 16, ///<Callback
+   RADIUS_ACCT_TERMINATE_CAUSE_USER_ERROR            = 17, ///<User Error
+   RADIUS_ACCT_TERMINATE_CAUSE_HOST_REQUEST          = 18, ///<Host Request
+   RADIUS_ACCT_TERMINATE_CAUSE_SUPPLICANT_RESTART    = 19, ///<Supplicant Restart
+   RADIUS_ACCT_TERMINATE_CAUSE_REAUTH_FAILURE        = 20, ///<Reauthentication Failure
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_REINIT           = 21, ///<Port Reinitialized
+   RADIUS_ACCT_TERMINATE_CAUSE_PORT_ADMIN_DISABLED   = 22  ///<Port Administratively Disabled
+} RadiusAcctTerminateCause;
+
+
 //CC-RX, CodeWarrior or Win32 compiler?
 #if defined(__CCRX__)
    #pragma pack
@@ -319,6 +412,35 @@ typedef __packed_struct
    #pragma pack(pop)
 #endif
 
+
+/**
+ * @brief Attribute index entry
+ **/
+
+typedef struct
+{
+   uint16_t offset; ///<Offset of the attribute from the beginning of the attribute list
+   uint8_t type;    ///<Attribute type
+   uint8_t next;    ///<Next entry with the same attribute type
+} RadiusAttrIndexEntry;
+
+
+/**
+ * @brief Attribute index
+ **/
+
+typedef struct
+{
+   const RadiusPacket *packet;                                     ///<Indexed RADIUS packet
+   size_t length;                                                  ///<Length of the attribute list
+   size_t unindexedOffset;                                         ///<Offset of the first attribute that could not be indexed
+   uint_t numEntries;                                              ///<Number of indexed attributes
+   uint8_t first[256];                                             ///<First entry for each attribute type
+   uint8_t last[256];                                              ///<Last entry for each attribute type
+   RadiusAttrIndexEntry entries[RADIUS_MAX_INDEXED_ATTRIBUTES];    ///<Attributes, in order of appearance
+} RadiusAttrIndex;
+
+
 //RADIUS related functions
 void radiusAddAttribute(RadiusPacket *packet, uint8_t type, const void *value,
    size_t length);
@@ -326,6 +448,18 @@ void radiusAddAttribute(RadiusPacket *packet, uint8_t type, const void *value,
 const RadiusAttribute *radiusGetAttribute(const RadiusPacket *packet,
    uint8_t type, uint_t index);
 
+error_t radiusParseAttributes(const RadiusPacket *packet,
+   RadiusAttrIndex *index);
+
+const RadiusAttribute *radiusGetFirstAttribute(const RadiusAttrIndex *index,
+   uint8_t type, uint_t *entry);
+
+const RadiusAttribute *radiusGetNextAttribute(const RadiusAttrIndex *index,
+   uint_t *entry);
+
+const RadiusAttribute *radiusFindUnindexedAttribute(const RadiusAttrIndex *index,
+   uint8_t type, size_t offset, uint_t *entry);
+
 //C++ guard
 #ifdef __cplusplus
 }
@@ -49,7 +49,13 @@ static const RadiusParamName radiusCodeList[] =
    {RADIUS_CODE_ACCOUNTING_RESPONSE, "Accounting-Response"},
    {RADIUS_CODE_ACCESS_CHALLENGE,    "Access-Challenge"},
    {RADIUS_CODE_STATUS_SERVER,       "Status-Server"},
-   {RADIUS_CODE_STATUS_CLIENT,       "Status-Client"}
+   {RADIUS_CODE_STATUS_CLIENT,       "Status-Client"},
+   {RADIUS_CODE_DISCONNECT_REQUEST,  "Disconnect-Request"},
+   {RADIUS_CODE_DISCONNECT_ACK,      "Disconnect-ACK"},
+   {RADIUS_CODE_DISCONNECT_NAK,      "Disconnect-NAK"},
+   {RADIUS_CODE_COA_REQUEST,         "CoA-Request"},
+   {RADIUS_CODE_COA_ACK,             "CoA-ACK"},
+   {RADIUS_CODE_COA_NAK,             "CoA-NAK"}
 };
 
 //RADIUS codes
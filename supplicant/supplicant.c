@@ -35,6 +35,8 @@
 #include "supplicant/supplicant.h"
 #include "supplicant/supplicant_fsm.h"
 #include "supplicant/supplicant_misc.h"
+#include "supplicant/supplicant_manager.h"
+#include "supplicant/supplicant_loadgen.h"
 #include "eap/eap_tls.h"
 #include "debug.h"
 
@@ -54,16 +56,29 @@ void supplicantGetDefaultSettings(SupplicantSettings *settings)
    settings->task.stackSize = SUPPLICANT_STACK_SIZE;
    settings->task.priority = SUPPLICANT_PRIORITY;
 
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   //The instance must be attached to a supplicant manager
+   settings->manager = NULL;
+#endif
+
    //The supplicant is not bound to any interface
    settings->interface = NULL;
    //Port index
    settings->portIndex = 0;
+   //Transmission buffer
+   settings->txBuffer = NULL;
+   settings->txBufferSize = SUPPLICANT_TX_BUFFER_SIZE;
 
 #if (EAP_TLS_SUPPORT == ENABLED)
    //TLS negotiation initialization callback function
    settings->tlsInitCallback = NULL;
    //TLS negotiation completion callback function
    settings->tlsCompleteCallback = NULL;
+   //TLS sessions are not saved to non-volatile storage
+   settings->tlsSessionLoadCallback = NULL;
+   settings->tlsSessionSaveCallback = NULL;
+   //EAP-TLS fragments are sized according to the link MTU
+   settings->eapMaxFragSize = 0;
 #endif
 
    //Supplicant PAE state change callback function
@@ -77,6 +92,49 @@ void supplicantGetDefaultSettings(SupplicantSettings *settings)
 }
 
 
+/**
+ * @brief Size the transmission buffer according to a footprint profile
+ *
+ * The small-footprint profile is validated against the largest
+ * EAP-Response/Identity. It does not leave enough room for the TLS
+ * handshake messages of EAP-TLS. The built-in buffer keeps its full size, so
+ * the memory is only saved when the caller supplies txBuffer and
+ * SUPPLICANT_STATIC_TX_BUFFER_SUPPORT is disabled
+ *
+ * @param[in,out] settings Structure that contains 802.1X supplicant settings
+ * @param[in] profile Footprint profile
+ * @return Error code
+ **/
+
+error_t supplicantSetFootprintProfile(SupplicantSettings *settings,
+   SupplicantFootprintProfile profile)
+{
+   //Check parameters
+   if(settings == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check footprint profile
+   if(profile == SUPPLICANT_FOOTPRINT_DEFAULT)
+   {
+      //The transmission buffer is sized for EAP-TLS
+      settings->txBufferSize = SUPPLICANT_TX_BUFFER_SIZE;
+   }
+   else if(profile == SUPPLICANT_FOOTPRINT_SMALL)
+   {
+      //The transmission buffer is sized for EAP-MD5
+      settings->txBufferSize = SUPPLICANT_SMALL_TX_BUFFER_SIZE;
+   }
+   else
+   {
+      //Unknown profile
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
 /**
  * @brief Initialize 802.1X supplicant context
  * @param[in] context Pointer to the 802.1X supplicant context
@@ -96,9 +154,38 @@ error_t supplicantInit(SupplicantContext *context,
    if(context == NULL || settings == NULL)
       return ERROR_INVALID_PARAMETER;
 
+   //Make sure the transmission buffer can hold an EAP-Response/Identity
+   if(settings->txBufferSize < SUPPLICANT_MIN_TX_BUFFER_SIZE)
+      return ERROR_INVALID_PARAMETER;
+
+#if (SUPPLICANT_STATIC_TX_BUFFER_SUPPORT == ENABLED)
+   //The built-in buffer is used when the caller does not supply one
+   if(settings->txBuffer == NULL &&
+      settings->txBufferSize > SUPPLICANT_TX_BUFFER_SIZE)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+#else
+   //The transmission buffer must be supplied by the caller
+   if(settings->txBuffer == NULL)
+      return ERROR_INVALID_PARAMETER;
+#endif
+
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   //The instances are driven by the task of a supplicant manager
+   if(settings->manager == NULL)
+      return ERROR_INVALID_PARAMETER;
+#endif
+
    //Clear supplicant context
    osMemset(context, 0, sizeof(SupplicantContext));
 
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   //The reception buffer is shared by all the instances of the manager
+   context->manager = settings->manager;
+   context->rxBuffer = settings->manager->rxBuffer;
+#endif
+
    //Initialize task parameters
    context->taskParams = settings->task;
    context->taskId = OS_INVALID_TASK_ID;
@@ -116,6 +203,16 @@ error_t supplicantInit(SupplicantContext *context,
    //Save user settings
    context->interface = settings->interface;
    context->portIndex = settings->portIndex;
+   context->txBuffer = settings->txBuffer;
+   context->txBufferSize = settings->txBufferSize;
+
+#if (SUPPLICANT_STATIC_TX_BUFFER_SUPPORT == ENABLED)
+   //Fall back to the built-in transmission buffer
+   if(context->txBuffer == NULL)
+   {
+      context->txBuffer = context->staticTxBuffer;
+   }
+#endif
    context->paeStateChangeCallback = settings->paeStateChangeCallback;
    context->backendStateChangeCallback = settings->backendStateChangeCallback;
    context->eapPeerStateChangeCallback = settings->eapPeerStateChangeCallback;
@@ -126,6 +223,12 @@ error_t supplicantInit(SupplicantContext *context,
    context->tlsInitCallback = settings->tlsInitCallback;
    //TLS negotiation completion callback function
    context->tlsCompleteCallback = settings->tlsCompleteCallback;
+   //TLS session load callback function
+   context->tlsSessionLoadCallback = settings->tlsSessionLoadCallback;
+   //TLS session save callback function
+   context->tlsSessionSaveCallback = settings->tlsSessionSaveCallback;
+   //Maximum size of the EAPOL frames carrying EAP-TLS fragments
+   context->eapMaxFragSize = settings->eapMaxFragSize;
 #endif
 
    //Default value of parameters
@@ -135,6 +238,10 @@ error_t supplicantInit(SupplicantContext *context,
    context->authPeriod = SUPPLICANT_DEFAULT_AUTH_PERIOD;
    context->startPeriod = SUPPLICANT_DEFAULT_START_PERIOD;
    context->maxStart = SUPPLICANT_DEFAULT_MAX_START;
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   context->fastStart = TRUE;
+   context->fastStartDelay = SUPPLICANT_FAST_START_INITIAL_DELAY;
+#endif
    context->clientTimeout = EAP_DEFAULT_CLIENT_TIMEOUT;
 
    //Initialize supplicant state machine
@@ -160,6 +267,14 @@ error_t supplicantInit(SupplicantContext *context,
          break;
       }
 
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+      //Register the instance with the supplicant manager
+      error = supplicantManagerAttach(context->manager, context);
+      //Any error to report?
+      if(error)
+         break;
+#endif
+
       //Successful initialization
       error = NO_ERROR;
 
@@ -343,6 +458,41 @@ error_t supplicantSetMaxStart(SupplicantContext *context, uint_t maxStart)
 }
 
 
+/**
+ * @brief Enable or disable the fast-start policy
+ *
+ * When the policy is enabled, link-up events are detected without waiting for
+ * the next tick and the first EAPOL-Start messages are retransmitted on an
+ * exponential schedule capped at startPeriod
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] enable Enable or disable the fast-start policy
+ * @return Error code
+ **/
+
+error_t supplicantSetFastStart(SupplicantContext *context, bool_t enable)
+{
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   //Make sure the supplicant context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X supplicant context
+   osAcquireMutex(&context->mutex);
+   //Save parameter value
+   context->fastStart = enable;
+   //Release exclusive access to the 802.1X supplicant context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Fast-start policy is not implemented
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
 /**
  * @brief Set the value of the clientTimeout parameter
  * @param[in] context Pointer to the 802.1X supplicant context
@@ -404,6 +554,74 @@ error_t supplicantSetPortControl(SupplicantContext *context,
 }
 
 
+/**
+ * @brief Set the maximum size of the EAPOL frames carrying EAP-TLS fragments
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] maxFragSize Maximum size of the EAPOL PDU, in bytes (0 means
+ *   the fragments are sized according to the link MTU)
+ * @return Error code
+ **/
+
+error_t supplicantSetMaxFragSize(SupplicantContext *context,
+   size_t maxFragSize)
+{
+#if (EAP_TLS_SUPPORT == ENABLED)
+   //Make sure the 802.1X supplicant context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the fragment size
+   if(maxFragSize != 0 && maxFragSize < EAP_MIN_FRAG_SIZE)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X supplicant context
+   osAcquireMutex(&context->mutex);
+   //Save the fragment size. It applies to the next fragment
+   context->eapMaxFragSize = maxFragSize;
+   //Release exclusive access to the 802.1X supplicant context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Not implemented
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
+/**
+ * @brief Discard the cached TLS sessions
+ *
+ * The sessions saved to non-volatile storage, if any, are not affected
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @return Error code
+ **/
+
+error_t supplicantFlushTlsSessionCache(SupplicantContext *context)
+{
+#if (EAP_TLS_SUPPORT == ENABLED)
+   //Make sure the 802.1X supplicant context is valid
+   if(context == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Acquire exclusive access to the 802.1X supplicant context
+   osAcquireMutex(&context->mutex);
+   //Release the cached TLS sessions
+   eapTlsFlushSessionCache(context);
+   //Release exclusive access to the 802.1X supplicant context
+   osReleaseMutex(&context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+#else
+   //Not implemented
+   return ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+
 /**
  * @brief Perform user logon
  * @param[in] context Pointer to the 802.1X supplicant context
@@ -534,9 +752,24 @@ error_t supplicantStart(SupplicantContext *context)
       //Save current time
       context->timestamp = osGetSystemTime();
 
-      //Reinitialize supplicant state machine
-      supplicantInitFsm(context);
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+      //Virtual supplicants emulated on top of the instance?
+      if(context->loadGen != NULL)
+      {
+         //The virtual supplicants arrive according to the arrival rate
+         supplicantLoadGenStart(context->loadGen);
+      }
+      else
+#endif
+      {
+         //Reinitialize supplicant state machine
+         supplicantInitFsm(context);
+      }
 
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+      //The socket is added to the poll set of the manager task
+      osSetEvent(&context->manager->event);
+#else
       //Create a task
       context->taskId = osCreateTask("Supplicant", (OsTaskCode) supplicantTask,
          context, &context->taskParams);
@@ -548,6 +781,7 @@ error_t supplicantStart(SupplicantContext *context)
          error = ERROR_OUT_OF_RESOURCES;
          break;
       }
+#endif
 
       //End of exception handling block
    } while(0);
@@ -589,7 +823,21 @@ error_t supplicantStop(SupplicantContext *context)
    //Check whether the supplicant is running
    if(context->running)
    {
-#if (NET_RTOS_SUPPORT == ENABLED)
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+      //Stop the supplicant
+      context->stop = TRUE;
+      //Send a signal to the manager task to abort any blocking operation
+      osSetEvent(&context->manager->event);
+
+      //Wait for the manager task to remove the socket from its poll set
+      while(context->running && context->manager->running)
+      {
+         osDelayTask(1);
+      }
+
+      //The instance is no longer processed by the manager task
+      context->running = FALSE;
+#elif (NET_RTOS_SUPPORT == ENABLED)
       //Stop the supplicant
       context->stop = TRUE;
       //Send a signal to the task to abort any blocking operation
@@ -652,6 +900,13 @@ void supplicantTask(SupplicantContext *context)
          timeout = 0;
       }
 
+      //Acquire exclusive access to the 802.1X supplicant context
+      osAcquireMutex(&context->mutex);
+      //Wake up when the nearest timer expires
+      timeout = supplicantGetTimerTimeout(context, timeout);
+      //Release exclusive access to the 802.1X supplicant context
+      osReleaseMutex(&context->mutex);
+
       //Specify the events the application is interested in
       eventDesc.socket = context->socket;
       eventDesc.eventMask = SOCKET_EVENT_RX_READY;
@@ -682,10 +937,17 @@ void supplicantTask(SupplicantContext *context)
          osReleaseMutex(&context->mutex);
       }
 
+      //Acquire exclusive access to the 802.1X supplicant context
+      osAcquireMutex(&context->mutex);
+      //Process the timers that have expired
+      supplicantProcessTimers(context);
+      //Release exclusive access to the 802.1X supplicant context
+      osReleaseMutex(&context->mutex);
+
       //Get current time
       time = osGetSystemTime();
 
-      //Timers have a resolution of one second
+      //Periodic operations are performed once per tick
       if((time - context->timestamp) >= SUPPLICANT_TICK_INTERVAL)
       {
          //Acquire exclusive access to the 802.1X supplicant context
@@ -715,6 +977,19 @@ void supplicantDeinit(SupplicantContext *context)
    //Make sure the 802.1X supplicant context is valid
    if(context != NULL)
    {
+#if (EAP_TLS_SUPPORT == ENABLED)
+      //Release the cached TLS sessions
+      eapTlsFlushSessionCache(context);
+#endif
+
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+      //Unregister the instance from the supplicant manager
+      if(context->manager != NULL)
+      {
+         supplicantManagerDetach(context->manager, context);
+      }
+#endif
+
       //Free previously allocated resources
       osDeleteMutex(&context->mutex);
       osDeleteEvent(&context->event);
@@ -35,6 +35,14 @@
 struct _SupplicantContext;
 #define SupplicantContext struct _SupplicantContext
 
+//Forward declaration of SupplicantManager structure
+struct _SupplicantManager;
+#define SupplicantManager struct _SupplicantManager
+
+//Forward declaration of SupplicantLoadGen structure
+struct _SupplicantLoadGen;
+#define SupplicantLoadGen struct _SupplicantLoadGen
+
 //Dependencies
 #include "eap/eap.h"
 #include "eap/eap_peer_fsm.h"
@@ -67,7 +75,7 @@ struct _SupplicantContext;
    #error SUPPLICANT_TICK_INTERVAL parameter is not valid
 #endif
 
-//Size of the transmission buffer
+//Default size of the transmission buffer
 #ifndef SUPPLICANT_TX_BUFFER_SIZE
    #define SUPPLICANT_TX_BUFFER_SIZE 3000
 #elif (SUPPLICANT_TX_BUFFER_SIZE < 1)
@@ -81,6 +89,49 @@ struct _SupplicantContext;
    #error SUPPLICANT_RX_BUFFER_SIZE parameter is not valid
 #endif
 
+//Minimum size of the transmission buffer (a full-length
+//EAP-Response/Identity must fit)
+#define SUPPLICANT_MIN_TX_BUFFER_SIZE (sizeof(EapolPdu) + \
+   sizeof(EapResponse) + SUPPLICANT_MAX_USERNAME_LEN)
+
+//Size of the transmission buffer of the small-footprint profile
+#define SUPPLICANT_SMALL_TX_BUFFER_SIZE (SUPPLICANT_MIN_TX_BUFFER_SIZE + 32)
+
+//Built-in transmission buffer (used when the caller supplies none)
+#ifndef SUPPLICANT_STATIC_TX_BUFFER_SUPPORT
+   #define SUPPLICANT_STATIC_TX_BUFFER_SUPPORT ENABLED
+#elif (SUPPLICANT_STATIC_TX_BUFFER_SUPPORT != ENABLED && SUPPLICANT_STATIC_TX_BUFFER_SUPPORT != DISABLED)
+   #error SUPPLICANT_STATIC_TX_BUFFER_SUPPORT parameter is not valid
+#endif
+
+//Supplicant manager support
+#ifndef SUPPLICANT_MANAGER_SUPPORT
+   #define SUPPLICANT_MANAGER_SUPPORT DISABLED
+#elif (SUPPLICANT_MANAGER_SUPPORT != ENABLED && SUPPLICANT_MANAGER_SUPPORT != DISABLED)
+   #error SUPPLICANT_MANAGER_SUPPORT parameter is not valid
+#endif
+
+//Maximum number of instances driven by a supplicant manager
+#ifndef SUPPLICANT_MAX_INSTANCES
+   #define SUPPLICANT_MAX_INSTANCES 8
+#elif (SUPPLICANT_MAX_INSTANCES < 1)
+   #error SUPPLICANT_MAX_INSTANCES parameter is not valid
+#endif
+
+//Load generator support
+#ifndef SUPPLICANT_LOADGEN_SUPPORT
+   #define SUPPLICANT_LOADGEN_SUPPORT DISABLED
+#elif (SUPPLICANT_LOADGEN_SUPPORT != ENABLED && SUPPLICANT_LOADGEN_SUPPORT != DISABLED)
+   #error SUPPLICANT_LOADGEN_SUPPORT parameter is not valid
+#endif
+
+//Size of the last EAP response kept by each virtual supplicant
+#ifndef SUPPLICANT_LOADGEN_MAX_RESP_LEN
+   #define SUPPLICANT_LOADGEN_MAX_RESP_LEN 32
+#elif (SUPPLICANT_LOADGEN_MAX_RESP_LEN < 4 || SUPPLICANT_LOADGEN_MAX_RESP_LEN > 255)
+   #error SUPPLICANT_LOADGEN_MAX_RESP_LEN parameter is not valid
+#endif
+
 //Maximum length of user name
 #ifndef SUPPLICANT_MAX_USERNAME_LEN
    #define SUPPLICANT_MAX_USERNAME_LEN 64
@@ -123,6 +174,41 @@ struct _SupplicantContext;
    #error SUPPLICANT_DEFAULT_MAX_START parameter is not valid
 #endif
 
+//Fast-start support
+#ifndef SUPPLICANT_FAST_START_SUPPORT
+   #define SUPPLICANT_FAST_START_SUPPORT DISABLED
+#elif (SUPPLICANT_FAST_START_SUPPORT != ENABLED && SUPPLICANT_FAST_START_SUPPORT != DISABLED)
+   #error SUPPLICANT_FAST_START_SUPPORT parameter is not valid
+#endif
+
+//Interval between the first two EAPOL-Start messages (in milliseconds)
+#ifndef SUPPLICANT_FAST_START_INITIAL_DELAY
+   #define SUPPLICANT_FAST_START_INITIAL_DELAY 250
+#elif (SUPPLICANT_FAST_START_INITIAL_DELAY < 10)
+   #error SUPPLICANT_FAST_START_INITIAL_DELAY parameter is not valid
+#endif
+
+//Link state polling interval while the port is down (in milliseconds)
+#ifndef SUPPLICANT_LINK_POLL_INTERVAL
+   #define SUPPLICANT_LINK_POLL_INTERVAL 100
+#elif (SUPPLICANT_LINK_POLL_INTERVAL < 10)
+   #error SUPPLICANT_LINK_POLL_INTERVAL parameter is not valid
+#endif
+
+//Size of the buffer used to reassemble incoming EAP-TLS fragments
+#ifndef SUPPLICANT_TLS_RX_BUFFER_SIZE
+   #define SUPPLICANT_TLS_RX_BUFFER_SIZE 8192
+#elif (SUPPLICANT_TLS_RX_BUFFER_SIZE < SUPPLICANT_RX_BUFFER_SIZE)
+   #error SUPPLICANT_TLS_RX_BUFFER_SIZE parameter is not valid
+#endif
+
+//Number of entries in the TLS session cache
+#ifndef SUPPLICANT_TLS_SESSION_CACHE_SIZE
+   #define SUPPLICANT_TLS_SESSION_CACHE_SIZE 4
+#elif (SUPPLICANT_TLS_SESSION_CACHE_SIZE < 1)
+   #error SUPPLICANT_TLS_SESSION_CACHE_SIZE parameter is not valid
+#endif
+
 //EAP-TLS supported?
 #if (EAP_TLS_SUPPORT == ENABLED)
    #include "core/crypto.h"
@@ -151,6 +237,33 @@ typedef error_t (*SupplicantTlsInitCallback)(SupplicantContext *context,
 typedef void (*SupplicantTlsCompleteCallback)(SupplicantContext *context,
    TlsContext *tlsContext, error_t error);
 
+/**
+ * @brief TLS session load callback function
+ **/
+
+typedef error_t (*SupplicantTlsSessionLoadCallback)(SupplicantContext *context,
+   const MacAddr *authAddr, TlsSessionState *session);
+
+/**
+ * @brief TLS session save callback function
+ **/
+
+typedef void (*SupplicantTlsSessionSaveCallback)(SupplicantContext *context,
+   const MacAddr *authAddr, const TlsSessionState *session);
+
+
+/**
+ * @brief TLS session cache entry
+ **/
+
+typedef struct
+{
+   bool_t valid;             ///<The entry is in use
+   MacAddr authAddr;         ///<MAC address of the authenticator the session was established through
+   uint_t lastUsed;          ///<Value of the use counter when the entry was last used (LRU eviction)
+   TlsSessionState session;  ///<TLS session state
+} SupplicantTlsSessionEntry;
+
 #endif
 
 
@@ -178,6 +291,31 @@ typedef void (*EapPeerStateChangeCallback)(SupplicantContext *context,
    EapPeerState state);
 
 
+/**
+ * @brief Footprint profile
+ **/
+
+typedef enum
+{
+   SUPPLICANT_FOOTPRINT_DEFAULT = 0, ///<Transmission buffer sized for EAP-TLS
+   SUPPLICANT_FOOTPRINT_SMALL   = 1  ///<Transmission buffer sized for EAP-MD5
+} SupplicantFootprintProfile;
+
+
+/**
+ * @brief Timer identifiers
+ **/
+
+typedef enum
+{
+   SUPPLICANT_TIMER_AUTH_WHILE  = 0, ///<authWhile timer
+   SUPPLICANT_TIMER_HELD_WHILE  = 1, ///<heldWhile timer
+   SUPPLICANT_TIMER_START_WHEN  = 2, ///<startWhen timer
+   SUPPLICANT_TIMER_IDLE_WHILE  = 3, ///<idleWhile timer
+   SUPPLICANT_NUM_TIMERS        = 4  ///<Number of timers
+} SupplicantTimerId;
+
+
 /**
  * @brief Tick callback function
  **/
@@ -185,6 +323,18 @@ typedef void (*EapPeerStateChangeCallback)(SupplicantContext *context,
 typedef void (*SupplicantTickCallback)(SupplicantContext *context);
 
 
+/**
+ * @brief Timer
+ **/
+
+typedef struct
+{
+   uint_t *value;      ///<Timer variable, in milliseconds (reset to zero on expiry)
+   bool_t running;     ///<The timer is armed
+   systime_t deadline; ///<Time at which the timer expires
+} SupplicantTimer;
+
+
 /**
  * @brief 802.1X supplicant settings
  **/
@@ -192,11 +342,19 @@ typedef void (*SupplicantTickCallback)(SupplicantContext *context);
 typedef struct
 {
    OsTaskParameters task;                                           ///<Task parameters
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   SupplicantManager *manager;                                      ///<Supplicant manager driving the instance
+#endif
    NetInterface *interface;                                         ///<Underlying network interface
    uint_t portIndex;                                                ///<Port index
+   uint8_t *txBuffer;                                               ///<Transmission buffer (NULL selects the built-in buffer)
+   size_t txBufferSize;                                             ///<Size of the transmission buffer, in bytes
 #if (EAP_TLS_SUPPORT == ENABLED)
    SupplicantTlsInitCallback tlsInitCallback;                       ///<TLS negotiation initialization callback function
    SupplicantTlsCompleteCallback tlsCompleteCallback;               ///<TLS negotiation completion callback function
+   SupplicantTlsSessionLoadCallback tlsSessionLoadCallback;         ///<TLS session load callback function
+   SupplicantTlsSessionSaveCallback tlsSessionSaveCallback;         ///<TLS session save callback function
+   size_t eapMaxFragSize;                                           ///<Maximum size of the EAPOL frames carrying EAP-TLS fragments (0 means link MTU)
 #endif
    SupplicantPaeStateChangeCallback paeStateChangeCallback;         ///<Supplicant PAE state change callback function
    SupplicantBackendStateChangeCallback backendStateChangeCallback; ///<Supplicant backend state change callback function
@@ -217,10 +375,17 @@ struct _SupplicantContext
    OsEvent event;                                    ///<Event object used to poll the underlying socket
    OsTaskParameters taskParams;                      ///<Task parameters
    OsTaskId taskId;                                  ///<Task identifier
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   SupplicantManager *manager;                       ///<Supplicant manager driving the instance
+#endif
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+   SupplicantLoadGen *loadGen;                       ///<Load generator emulating virtual supplicants on top of the instance
+#endif
    NetContext *netContext;                           ///<TCP/IP stack context
    NetInterface *interface;                          ///<Underlying network interface
    uint_t portIndex;                                 ///<Port index
    Socket *socket;                                   ///<Underlying socket
+   MacAddr authAddr;                                 ///<MAC address of the authenticator
    char_t username[SUPPLICANT_MAX_USERNAME_LEN + 1]; ///<User name
 #if (EAP_MD5_SUPPORT == ENABLED)
    char_t password[SUPPLICANT_MAX_PASSWORD_LEN + 1]; ///<Password
@@ -228,23 +393,42 @@ struct _SupplicantContext
 #endif
 #if (EAP_TLS_SUPPORT == ENABLED)
    TlsContext *tlsContext;                           ///<TLS context
-   TlsSessionState tlsSession;                       ///<TLS session state
+   SupplicantTlsSessionEntry tlsSessionCache[SUPPLICANT_TLS_SESSION_CACHE_SIZE]; ///<TLS session cache
+   SupplicantTlsSessionEntry *tlsSession;            ///<Cache entry used by the current handshake
+   uint_t tlsSessionCounter;                         ///<Use counter of the TLS session cache
    SupplicantTlsInitCallback tlsInitCallback;        ///<TLS negotiation initialization callback function
    SupplicantTlsCompleteCallback tlsCompleteCallback;               ///<TLS negotiation completion callback function
+   SupplicantTlsSessionLoadCallback tlsSessionLoadCallback;         ///<TLS session load callback function
+   SupplicantTlsSessionSaveCallback tlsSessionSaveCallback;         ///<TLS session save callback function
+   size_t eapMaxFragSize;                            ///<Maximum size of the EAPOL frames carrying EAP-TLS fragments (0 means link MTU)
 #endif
    SupplicantPaeStateChangeCallback paeStateChangeCallback;         ///<Supplicant PAE state change callback function
    SupplicantBackendStateChangeCallback backendStateChangeCallback; ///<Supplicant backend state change callback function
    EapPeerStateChangeCallback eapPeerStateChangeCallback;           ///<EAP peer state change callback function
    SupplicantTickCallback tickCallback;              ///<Tick callback function
    systime_t timestamp;                              ///<Timestamp to manage timeout
+   SupplicantTimer timers[SUPPLICANT_NUM_TIMERS];    ///<Timers
 
-   uint8_t txBuffer[SUPPLICANT_TX_BUFFER_SIZE];      ///<Transmission buffer
+   uint8_t *txBuffer;                                ///<Transmission buffer
+   size_t txBufferSize;                              ///<Size of the transmission buffer, in bytes
    size_t txBufferWritePos;
    size_t txBufferReadPos;
    size_t txBufferLen;
+#if (SUPPLICANT_STATIC_TX_BUFFER_SUPPORT == ENABLED)
+   uint8_t staticTxBuffer[SUPPLICANT_TX_BUFFER_SIZE]; ///<Built-in transmission buffer
+#endif
+#if (SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+   uint8_t *rxBuffer;                                ///<Reception buffer (shared by the instances of the manager)
+#else
    uint8_t rxBuffer[SUPPLICANT_RX_BUFFER_SIZE];      ///<Reception buffer
-   size_t rxBufferPos;
-   size_t rxBufferLen;
+#endif
+#if (EAP_TLS_SUPPORT == ENABLED)
+   uint8_t tlsRxBuffer[SUPPLICANT_TLS_RX_BUFFER_SIZE]; ///<Reassembly buffer for the incoming TLS records
+   size_t tlsRxLen;                                  ///<Number of bytes in the reassembly buffer
+   size_t tlsRxPos;                                  ///<Number of bytes already consumed by the TLS engine
+   size_t tlsRxReady;                                ///<Number of bytes forming complete TLS records
+   size_t tlsRxTotal;                                ///<Remaining length of the fragmented TLS message (0 if not fragmented)
+#endif
 
    SupplicantPaeState suppPaeState;                  ///<Supplicant PAE state
    SupplicantBackendState suppBackendState;          ///<Supplicant backend state
@@ -278,6 +462,10 @@ struct _SupplicantContext
    uint_t heldPeriod;                                ///<Initialization value used for the heldWhile timer (8.2.11.1.2 a)
    uint_t startPeriod;                               ///<Initialization value used for the startWhen timer (8.2.11.1.2 b)
    uint_t maxStart;                                  ///<Maximum number of successive EAPOL-Start messages that will be sent (8.2.11.1.2 c)
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   bool_t fastStart;                                 ///<Fast-start policy
+   systime_t fastStartDelay;                         ///<Interval before the next EAPOL-Start retransmission, in milliseconds
+#endif
 
    bool_t eapNoResp;                                 ///<No EAP Response for the last EAP frame delivered to EAP (8.2.12.1.1 a)
    bool_t eapReq;                                    ///<An EAP frame is available for processing by EAP (8.2.12.1.1 b)
@@ -321,6 +509,9 @@ struct _SupplicantContext
 //Supplicant related functions
 void supplicantGetDefaultSettings(SupplicantSettings *settings);
 
+error_t supplicantSetFootprintProfile(SupplicantSettings *settings,
+   SupplicantFootprintProfile profile);
+
 error_t supplicantInit(SupplicantContext *context,
    const SupplicantSettings *settings);
 
@@ -334,6 +525,7 @@ error_t supplicantSetHeldPeriod(SupplicantContext *context, uint_t heldPeriod);
 error_t supplicantSetAuthPeriod(SupplicantContext *context, uint_t authPeriod);
 error_t supplicantSetStartPeriod(SupplicantContext *context, uint_t startPeriod);
 error_t supplicantSetMaxStart(SupplicantContext *context, uint_t maxStart);
+error_t supplicantSetFastStart(SupplicantContext *context, bool_t enable);
 
 error_t supplicantSetClientTimeout(SupplicantContext *context,
    uint_t clientTimeout);
@@ -341,6 +533,11 @@ error_t supplicantSetClientTimeout(SupplicantContext *context,
 error_t supplicantSetPortControl(SupplicantContext *context,
    SupplicantPortMode portControl);
 
+error_t supplicantSetMaxFragSize(SupplicantContext *context,
+   size_t maxFragSize);
+
+error_t supplicantFlushTlsSessionCache(SupplicantContext *context);
+
 error_t supplicantLogOn(SupplicantContext *context);
 error_t supplicantLogOff(SupplicantContext *context);
 
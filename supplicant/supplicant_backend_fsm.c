@@ -267,7 +267,7 @@ void supplicantBackendChangeState(SupplicantContext *context,
       //The state machine has received an EAP request from the authenticator,
       //and invokes EAP to perform whatever processing is needed in order to
       //acquire the information that will form the response
-      context->authWhile = 0;
+      supplicantStopTimer(context, SUPPLICANT_TIMER_AUTH_WHILE);
       context->eapReq = TRUE;
       supplicantGetSuppRsp(context);
       break;
@@ -284,7 +284,8 @@ void supplicantBackendChangeState(SupplicantContext *context,
    case SUPPLICANT_BACKEND_STATE_RECEIVE:
       //The supplicant is waiting for the next EAP request from the
       //authenticator
-      context->authWhile = context->authPeriod;
+      supplicantStartTimer(context, SUPPLICANT_TIMER_AUTH_WHILE,
+         context->authPeriod * 1000);
       context->eapolEap = FALSE;
       context->eapNoResp = FALSE;
       break;
@@ -34,6 +34,7 @@
 //Dependencies
 #include "supplicant/supplicant.h"
 #include "supplicant/supplicant_fsm.h"
+#include "supplicant/supplicant_misc.h"
 #include "supplicant/supplicant_pae_fsm.h"
 #include "supplicant/supplicant_backend_fsm.h"
 #include "eap/eap_peer_fsm.h"
@@ -50,10 +51,10 @@
 
 void supplicantInitFsm(SupplicantContext *context)
 {
+   //Stop all the timers
+   supplicantInitTimers(context);
+
    //Initialize variables
-   context->authWhile = 0;
-   context->heldWhile = 0;
-   context->startWhen = 0;
 
    context->eapFail = FALSE;
    context->eapolEap = FALSE;
@@ -82,7 +83,6 @@ void supplicantInitFsm(SupplicantContext *context)
    context->allowNotifications = TRUE;
    context->eapReqData = context->rxBuffer + sizeof(EapolPdu);
    context->eapReqDataLen = 0;
-   context->idleWhile = 0;
    context->altAccept = FALSE;
    context->altReject = FALSE;
    context->eapRespData = context->txBuffer + sizeof(EapolPdu);
@@ -0,0 +1,891 @@
+/**
+ * @file supplicant_loadgen.c
+ * @brief Load generator emulating virtual supplicants
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL SUPPLICANT_TRACE_LEVEL
+
+//Dependencies
+#include "supplicant/supplicant.h"
+#include "supplicant/supplicant_loadgen.h"
+#include "supplicant/supplicant_fsm.h"
+#include "supplicant/supplicant_misc.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (SUPPLICANT_SUPPORT == ENABLED && SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+
+//PAE group address (refer to IEEE Std 802.1X-2010, section 11.1.1)
+static const MacAddr PAE_GROUP_ADDR = {{{0x01, 0x80, 0xC2, 0x00, 0x00, 0x03}}};
+
+//Load generator related functions
+static SupplicantVirtual *supplicantLoadGenFindVirtual(
+   SupplicantLoadGen *loadGen, const MacAddr *macAddr);
+
+static void supplicantLoadGenArrive(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v);
+
+static void supplicantLoadGenLoad(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v);
+
+static void supplicantLoadGenSave(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v);
+
+
+/**
+ * @brief Initialize load generator
+ *
+ * The load generator emulates a population of virtual supplicants on top of
+ * a single 802.1X supplicant context. The context provides the socket, the
+ * task, the buffers and the credentials, while each virtual supplicant only
+ * keeps the variables of its state machines. The context is loaded with the
+ * state of a virtual supplicant, the state machines are run, and the state is
+ * saved back. Only EAP-MD5 is supported, since EAP-TLS would require a TLS
+ * context per virtual supplicant
+ *
+ * The virtual supplicants are assigned consecutive MAC addresses, starting
+ * from the specified base address. The authenticator sends its unicast frames
+ * to these addresses, so the underlying interface must be configured to
+ * accept them (promiscuous mode, for instance)
+ *
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] virtuals Array of virtual supplicants
+ * @param[in] numVirtuals Number of virtual supplicants
+ * @param[in] baseMacAddr MAC address of the first virtual supplicant
+ * @return Error code
+ **/
+
+error_t supplicantLoadGenInit(SupplicantLoadGen *loadGen,
+   SupplicantContext *context, SupplicantVirtual *virtuals,
+   uint_t numVirtuals, const MacAddr *baseMacAddr)
+{
+   uint_t i;
+   uint32_t n;
+
+   //Check parameters
+   if(loadGen == NULL || context == NULL || virtuals == NULL ||
+      baseMacAddr == NULL)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //The MAC addresses are derived from the 24 least significant bits of the
+   //base address
+   if(numVirtuals == 0 || numVirtuals > 0x1000000)
+      return ERROR_INVALID_PARAMETER;
+
+   //The load generator must be attached before the supplicant is started
+   if(context->running)
+      return ERROR_ALREADY_RUNNING;
+
+   //Debug message
+   TRACE_INFO("Initializing load generator (%u virtual supplicants)...\r\n",
+      numVirtuals);
+
+   //Clear load generator
+   osMemset(loadGen, 0, sizeof(SupplicantLoadGen));
+
+   //Clear virtual supplicants
+   osMemset(virtuals, 0, numVirtuals * sizeof(SupplicantVirtual));
+
+   //Loop through the virtual supplicants
+   for(i = 0; i < numVirtuals; i++)
+   {
+      //Compute the NIC specific part of the MAC address
+      n = (baseMacAddr->b[3] << 16) | (baseMacAddr->b[4] << 8) |
+         baseMacAddr->b[5];
+      n = (n + i) & 0xFFFFFF;
+
+      //The OUI is the same for all the virtual supplicants
+      virtuals[i].macAddr = *baseMacAddr;
+      virtuals[i].macAddr.b[3] = (n >> 16) & 0xFF;
+      virtuals[i].macAddr.b[4] = (n >> 8) & 0xFF;
+      virtuals[i].macAddr.b[5] = n & 0xFF;
+   }
+
+   //Save parameters
+   loadGen->context = context;
+   loadGen->virtuals = virtuals;
+   loadGen->numVirtuals = numVirtuals;
+
+   //Attach the load generator to the 802.1X supplicant context
+   context->loadGen = loadGen;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Set arrival rate
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] arrivalRate Number of virtual supplicants arriving per second
+ *   (0 means that all the virtual supplicants arrive at once)
+ * @return Error code
+ **/
+
+error_t supplicantLoadGenSetArrivalRate(SupplicantLoadGen *loadGen,
+   uint_t arrivalRate)
+{
+   //Make sure the load generator is valid
+   if(loadGen == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&loadGen->context->mutex);
+   //Save arrival rate
+   loadGen->arrivalRate = arrivalRate;
+   //Release exclusive access
+   osReleaseMutex(&loadGen->context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve load generator statistics
+ * @param[in] loadGen Pointer to the load generator
+ * @param[out] stats Statistics
+ * @return Error code
+ **/
+
+error_t supplicantLoadGenGetStats(SupplicantLoadGen *loadGen,
+   SupplicantLoadGenStats *stats)
+{
+   //Check parameters
+   if(loadGen == NULL || stats == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Get exclusive access
+   osAcquireMutex(&loadGen->context->mutex);
+   //Take a snapshot of the statistics
+   *stats = loadGen->stats;
+   //Release exclusive access
+   osReleaseMutex(&loadGen->context->mutex);
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Start emulating the virtual supplicants
+ * @param[in] loadGen Pointer to the load generator
+ **/
+
+void supplicantLoadGenStart(SupplicantLoadGen *loadGen)
+{
+   uint_t i;
+   MacAddr macAddr;
+
+   //Loop through the virtual supplicants
+   for(i = 0; i < loadGen->numVirtuals; i++)
+   {
+      //Discard the state of the previous run
+      macAddr = loadGen->virtuals[i].macAddr;
+      osMemset(&loadGen->virtuals[i], 0, sizeof(SupplicantVirtual));
+      loadGen->virtuals[i].macAddr = macAddr;
+   }
+
+   //Reset statistics
+   osMemset(&loadGen->stats, 0, sizeof(SupplicantLoadGenStats));
+
+   //No virtual supplicant is loaded in the 802.1X supplicant context
+   loadGen->current = NULL;
+   //The first virtual supplicant arrives immediately
+   loadGen->numArrivals = 0;
+   loadGen->arrivalTime = osGetSystemTime();
+}
+
+
+/**
+ * @brief Handle periodic operations
+ * @param[in] loadGen Pointer to the load generator
+ **/
+
+void supplicantLoadGenTick(SupplicantLoadGen *loadGen)
+{
+   uint_t i;
+   bool_t linkState;
+   SupplicantContext *context;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+
+   //All the virtual supplicants share the same port
+   linkState = supplicantGetLinkState(context);
+
+   //Loop through the virtual supplicants
+   for(i = 0; i < loadGen->numArrivals; i++)
+   {
+      //Load the state of the virtual supplicant
+      supplicantLoadGenLoad(loadGen, &loadGen->virtuals[i]);
+
+      //Update supplicant state machines
+      context->portEnabled = linkState;
+      supplicantFsm(context);
+
+      //Save the state of the virtual supplicant
+      supplicantLoadGenSave(loadGen, &loadGen->virtuals[i]);
+   }
+
+   //Any registered callback?
+   if(context->tickCallback != NULL)
+   {
+      //Invoke user callback function
+      context->tickCallback(context);
+   }
+}
+
+
+/**
+ * @brief Process arrivals and the timers that have expired
+ * @param[in] loadGen Pointer to the load generator
+ **/
+
+void supplicantLoadGenProcessTimers(SupplicantLoadGen *loadGen)
+{
+   uint_t i;
+   uint_t j;
+   systime_t time;
+   SupplicantVirtual *v;
+   SupplicantContext *context;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+   //Get current time
+   time = osGetSystemTime();
+
+   //Process the virtual supplicants whose arrival time has been reached
+   while(loadGen->numArrivals < loadGen->numVirtuals &&
+      (loadGen->arrivalRate == 0 ||
+      timeCompare(time, loadGen->arrivalTime) >= 0))
+   {
+      //Point to the next virtual supplicant
+      v = &loadGen->virtuals[loadGen->numArrivals++];
+      //The virtual supplicant starts its authentication
+      supplicantLoadGenArrive(loadGen, v);
+
+      //Schedule the next arrival
+      if(loadGen->arrivalRate > 0)
+      {
+         loadGen->arrivalTime += MAX(1000 / loadGen->arrivalRate, 1);
+      }
+   }
+
+   //Loop through the virtual supplicants
+   for(i = 0; i < loadGen->numArrivals; i++)
+   {
+      //Point to the current virtual supplicant
+      v = &loadGen->virtuals[i];
+
+      //Loop through the timers
+      for(j = 0; j < SUPPLICANT_NUM_TIMERS; j++)
+      {
+         //Check whether the deadline has been reached
+         if((v->timerMask & (1U << j)) != 0 &&
+            timeCompare(time, v->timerDeadlines[j]) >= 0)
+         {
+            break;
+         }
+      }
+
+      //Any timer expired?
+      if(j < SUPPLICANT_NUM_TIMERS)
+      {
+         //Load the state of the virtual supplicant
+         supplicantLoadGenLoad(loadGen, v);
+
+         //Loop through the timers
+         for(j = 0; j < SUPPLICANT_NUM_TIMERS; j++)
+         {
+            //Check whether the deadline has been reached
+            if(context->timers[j].running &&
+               timeCompare(time, context->timers[j].deadline) >= 0)
+            {
+               //The timer has expired
+               context->timers[j].running = FALSE;
+               *context->timers[j].value = 0;
+            }
+         }
+
+         //Update supplicant state machines
+         supplicantFsm(context);
+
+         //Save the state of the virtual supplicant
+         supplicantLoadGenSave(loadGen, v);
+      }
+   }
+}
+
+
+/**
+ * @brief Get the time remaining before the next event
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] timeout Maximum value to be returned, in milliseconds
+ * @return Time remaining before the nearest deadline, in milliseconds
+ **/
+
+systime_t supplicantLoadGenGetTimerTimeout(SupplicantLoadGen *loadGen,
+   systime_t timeout)
+{
+   uint_t i;
+   uint_t j;
+   systime_t time;
+   SupplicantVirtual *v;
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Any virtual supplicant waiting for its arrival?
+   if(loadGen->numArrivals < loadGen->numVirtuals)
+   {
+      //Check whether the arrival time has already been reached
+      if(loadGen->arrivalRate > 0 &&
+         timeCompare(loadGen->arrivalTime, time) > 0)
+      {
+         timeout = MIN(timeout, loadGen->arrivalTime - time);
+      }
+      else
+      {
+         timeout = 0;
+      }
+   }
+
+   //Loop through the virtual supplicants
+   for(i = 0; i < loadGen->numArrivals && timeout > 0; i++)
+   {
+      //Point to the current virtual supplicant
+      v = &loadGen->virtuals[i];
+
+      //Loop through the timers
+      for(j = 0; j < SUPPLICANT_NUM_TIMERS; j++)
+      {
+         //Running timer?
+         if((v->timerMask & (1U << j)) != 0)
+         {
+            //Check whether the deadline has already been reached
+            if(timeCompare(v->timerDeadlines[j], time) > 0)
+            {
+               timeout = MIN(timeout, v->timerDeadlines[j] - time);
+            }
+            else
+            {
+               timeout = 0;
+            }
+         }
+      }
+   }
+
+   //Return the time remaining before the nearest deadline
+   return timeout;
+}
+
+
+/**
+ * @brief Dispatch an incoming EAP packet to the relevant virtual supplicants
+ *
+ * The packet is delivered to the virtual supplicant whose MAC address matches
+ * the destination address. Packets sent to the PAE group address are
+ * delivered to all the virtual supplicants that have arrived
+ *
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] destMacAddr Destination MAC address of the EAPOL frame
+ * @param[in] srcMacAddr Source MAC address of the EAPOL frame
+ * @param[in] packet Pointer to the received EAP packet
+ * @param[in] length Length of the packet, in bytes
+ **/
+
+void supplicantLoadGenProcessEapPacket(SupplicantLoadGen *loadGen,
+   const MacAddr *destMacAddr, const MacAddr *srcMacAddr,
+   const EapPacket *packet, size_t length)
+{
+   uint_t i;
+   SupplicantVirtual *v;
+   SupplicantContext *context;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+
+   //Group-addressed packet?
+   if(macCompAddr(destMacAddr, &PAE_GROUP_ADDR))
+   {
+      //Loop through the virtual supplicants
+      for(i = 0; i < loadGen->numArrivals; i++)
+      {
+         //Load the state of the virtual supplicant
+         supplicantLoadGenLoad(loadGen, &loadGen->virtuals[i]);
+
+         //Save the MAC address of the authenticator
+         context->authAddr = *srcMacAddr;
+         //Process incoming EAP packet
+         supplicantProcessEapPacket(context, packet, length);
+
+         //Save the state of the virtual supplicant
+         supplicantLoadGenSave(loadGen, &loadGen->virtuals[i]);
+      }
+   }
+   else
+   {
+      //Search the virtual supplicant the packet is addressed to
+      v = supplicantLoadGenFindVirtual(loadGen, destMacAddr);
+
+      //Any matching virtual supplicant?
+      if(v != NULL && v->active)
+      {
+         //Load the state of the virtual supplicant
+         supplicantLoadGenLoad(loadGen, v);
+
+         //Save the MAC address of the authenticator
+         context->authAddr = *srcMacAddr;
+         //Process incoming EAP packet
+         supplicantProcessEapPacket(context, packet, length);
+
+         //Save the state of the virtual supplicant
+         supplicantLoadGenSave(loadGen, v);
+      }
+   }
+}
+
+
+/**
+ * @brief Get the MAC address of the virtual supplicant being processed
+ *
+ * This function can be called from the state change callbacks to identify
+ * the virtual supplicant the event relates to
+ *
+ * @param[in] loadGen Pointer to the load generator
+ * @return MAC address of the current virtual supplicant (NULL if none)
+ **/
+
+const MacAddr *supplicantLoadGenGetMacAddr(SupplicantLoadGen *loadGen)
+{
+   const MacAddr *macAddr;
+
+   //Any virtual supplicant loaded in the 802.1X supplicant context?
+   if(loadGen->current != NULL)
+   {
+      macAddr = &loadGen->current->macAddr;
+   }
+   else
+   {
+      macAddr = NULL;
+   }
+
+   //Return the MAC address of the current virtual supplicant
+   return macAddr;
+}
+
+
+/**
+ * @brief Find the virtual supplicant that matches a given MAC address
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] macAddr MAC address
+ * @return Pointer to the matching virtual supplicant (NULL if none)
+ **/
+
+static SupplicantVirtual *supplicantLoadGenFindVirtual(
+   SupplicantLoadGen *loadGen, const MacAddr *macAddr)
+{
+   uint32_t n;
+   SupplicantVirtual *v;
+
+   //The MAC addresses are consecutive, so the index of the virtual supplicant
+   //can be computed from the NIC specific part of the address
+   n = (macAddr->b[3] << 16) | (macAddr->b[4] << 8) | macAddr->b[5];
+
+   n -= (loadGen->virtuals[0].macAddr.b[3] << 16) |
+      (loadGen->virtuals[0].macAddr.b[4] << 8) |
+      loadGen->virtuals[0].macAddr.b[5];
+
+   n &= 0xFFFFFF;
+
+   //Check the resulting index
+   if(n < loadGen->numVirtuals)
+   {
+      //Point to the candidate virtual supplicant
+      v = &loadGen->virtuals[n];
+
+      //The OUI must match as well
+      if(!macCompAddr(macAddr, &v->macAddr))
+      {
+         v = NULL;
+      }
+   }
+   else
+   {
+      //No matching virtual supplicant
+      v = NULL;
+   }
+
+   //Return the matching virtual supplicant, if any
+   return v;
+}
+
+
+/**
+ * @brief Start the authentication of a virtual supplicant
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] v Pointer to the virtual supplicant
+ **/
+
+static void supplicantLoadGenArrive(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v)
+{
+   SupplicantContext *context;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+
+   //Debug message
+   TRACE_DEBUG("Virtual supplicant %s arriving...\r\n",
+      macAddrToString(&v->macAddr, NULL));
+
+   //The virtual supplicant is now loaded in the 802.1X supplicant context
+   loadGen->current = v;
+
+   //Initialize the state machines with fresh variables
+   context->userLogoff = FALSE;
+   supplicantInitFsm(context);
+
+   //The virtual supplicant is now active
+   v->active = TRUE;
+   v->startTime = osGetSystemTime();
+   loadGen->stats.numActive++;
+
+   //The port is operable as long as the underlying link is up
+   context->portEnabled = supplicantGetLinkState(context);
+   //Update supplicant state machines
+   supplicantFsm(context);
+
+   //Save the state of the virtual supplicant
+   supplicantLoadGenSave(loadGen, v);
+}
+
+
+/**
+ * @brief Load the state of a virtual supplicant in the 802.1X supplicant context
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] v Pointer to the virtual supplicant
+ **/
+
+static void supplicantLoadGenLoad(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v)
+{
+   uint_t i;
+   systime_t time;
+   SupplicantContext *context;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+   //Get current time
+   time = osGetSystemTime();
+
+   //The virtual supplicant is now loaded in the 802.1X supplicant context
+   loadGen->current = v;
+
+   //Restore the MAC address of the authenticator
+   context->authAddr = v->authAddr;
+
+   //Restore the states of the state machines
+   context->suppPaeState = (SupplicantPaeState) v->suppPaeState;
+   context->suppBackendState = (SupplicantBackendState) v->suppBackendState;
+   context->eapPeerState = (EapPeerState) v->eapPeerState;
+
+   //Restore the timers
+   for(i = 0; i < SUPPLICANT_NUM_TIMERS; i++)
+   {
+      //Running timer?
+      if((v->timerMask & (1U << i)) != 0)
+      {
+         context->timers[i].running = TRUE;
+         context->timers[i].deadline = v->timerDeadlines[i];
+
+         //The timer variable keeps a non-zero value until the deadline is
+         //processed
+         if(timeCompare(v->timerDeadlines[i], time) > 0)
+         {
+            *context->timers[i].value = v->timerDeadlines[i] - time;
+         }
+         else
+         {
+            *context->timers[i].value = 1;
+         }
+      }
+      else
+      {
+         context->timers[i].running = FALSE;
+         context->timers[i].deadline = 0;
+         *context->timers[i].value = 0;
+      }
+   }
+
+   //Restore the variables of the state machines
+   context->eapFail = v->eapFail;
+   context->eapolEap = FALSE;
+   context->eapSuccess = v->eapSuccess;
+   context->initialize = FALSE;
+   context->keyDone = v->keyDone;
+   context->keyRun = v->keyRun;
+   context->portEnabled = v->portEnabled;
+   context->portValid = v->portValid;
+   context->suppAbort = v->suppAbort;
+   context->suppFail = v->suppFail;
+   context->suppStart = v->suppStart;
+   context->suppSuccess = v->suppSuccess;
+   context->suppTimeout = v->suppTimeout;
+
+   context->suppPortStatus = v->suppAuthorized ?
+      SUPPLICANT_PORT_STATUS_AUTH : SUPPLICANT_PORT_STATUS_UNAUTH;
+
+   context->eapRestart = v->eapRestart;
+   context->logoffSent = v->logoffSent;
+   context->sPortMode = (SupplicantPortMode) v->sPortMode;
+   context->startCount = v->startCount;
+   context->userLogoff = v->userLogoff;
+
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   context->fastStartDelay = v->fastStartDelay;
+#endif
+
+   context->eapNoResp = v->eapNoResp;
+   context->eapReq = v->eapReq;
+   context->eapResp = v->eapResp;
+
+   context->allowNotifications = v->allowNotifications;
+   context->eapReqData = context->rxBuffer + sizeof(EapolPdu);
+   context->eapReqDataLen = 0;
+   context->altAccept = v->altAccept;
+   context->altReject = v->altReject;
+   context->eapRespData = context->txBuffer + sizeof(EapolPdu);
+   context->eapRespDataLen = 0;
+   context->eapKeyData = NULL;
+   context->eapKeyAvailable = v->eapKeyAvailable;
+
+   context->selectedMethod = (EapMethodType) v->selectedMethod;
+   context->methodState = (EapMethodState) v->methodState;
+   context->decision = (EapDecision) v->decision;
+
+   //Restore the identifier of the last request
+   if(v->lastId == 0xFFFF)
+   {
+      context->lastId = EAP_LAST_ID_NONE;
+   }
+   else
+   {
+      context->lastId = v->lastId;
+   }
+
+   //Restore the last EAP response, so that it can be retransmitted
+   context->lastRespData = context->txBuffer + sizeof(EapolPdu);
+   context->lastRespDataLen = v->lastRespDataLen;
+   osMemcpy(context->lastRespData, v->lastRespData, v->lastRespDataLen);
+
+   context->rxReq = v->rxReq;
+   context->rxSuccess = v->rxSuccess;
+   context->rxFailure = v->rxFailure;
+   context->reqId = v->reqId;
+   context->reqMethod = (EapMethodType) v->reqMethod;
+   context->ignore = v->ignore;
+
+   context->allowCanned = v->allowCanned;
+}
+
+
+/**
+ * @brief Save the state of a virtual supplicant and update statistics
+ * @param[in] loadGen Pointer to the load generator
+ * @param[in] v Pointer to the virtual supplicant
+ **/
+
+static void supplicantLoadGenSave(SupplicantLoadGen *loadGen,
+   SupplicantVirtual *v)
+{
+   uint_t i;
+   bool_t authorized;
+   systime_t time;
+   systime_t latency;
+   SupplicantContext *context;
+   SupplicantLoadGenStats *stats;
+
+   //Point to the 802.1X supplicant context
+   context = loadGen->context;
+   //Point to the statistics
+   stats = &loadGen->stats;
+   //Get current time
+   time = osGetSystemTime();
+
+   //Check the authorization state of the virtual supplicant
+   authorized = (context->suppPortStatus == SUPPLICANT_PORT_STATUS_AUTH);
+
+   //An authentication attempt starts when the PAE enters CONNECTING
+   if(context->suppPaeState == SUPPLICANT_PAE_STATE_CONNECTING &&
+      v->suppPaeState != SUPPLICANT_PAE_STATE_CONNECTING && !authorized)
+   {
+      v->startTime = time;
+   }
+
+   //Check whether the virtual supplicant has been authorized
+   if(authorized && !v->suppAuthorized)
+   {
+      //Compute the time taken by the authentication
+      latency = time - v->startTime;
+
+      //Update statistics
+      if(stats->authSuccesses == 0 || latency < stats->minLatency)
+      {
+         stats->minLatency = latency;
+      }
+
+      if(latency > stats->maxLatency)
+      {
+         stats->maxLatency = latency;
+      }
+
+      stats->totalLatency += latency;
+      stats->authSuccesses++;
+      stats->numAuthorized++;
+   }
+   else if(!authorized && v->suppAuthorized)
+   {
+      //The virtual supplicant is no longer authorized
+      stats->numAuthorized--;
+   }
+   else
+   {
+      //Just for sanity
+   }
+
+   //A failed authentication causes the PAE to enter HELD
+   if(context->suppPaeState == SUPPLICANT_PAE_STATE_HELD &&
+      v->suppPaeState != SUPPLICANT_PAE_STATE_HELD)
+   {
+      stats->authFailures++;
+   }
+
+   //Check whether the authenticator has stopped responding
+   if(context->suppBackendState == SUPPLICANT_BACKEND_STATE_TIMEOUT &&
+      v->suppBackendState != SUPPLICANT_BACKEND_STATE_TIMEOUT)
+   {
+      stats->authTimeouts++;
+   }
+
+   //Save the MAC address of the authenticator
+   v->authAddr = context->authAddr;
+
+   //Save the states of the state machines
+   v->suppPaeState = (uint8_t) context->suppPaeState;
+   v->suppBackendState = (uint8_t) context->suppBackendState;
+   v->eapPeerState = (uint8_t) context->eapPeerState;
+
+   //Save the timers
+   v->timerMask = 0;
+
+   //Loop through the timers
+   for(i = 0; i < SUPPLICANT_NUM_TIMERS; i++)
+   {
+      //Running timer?
+      if(context->timers[i].running)
+      {
+         v->timerMask |= 1U << i;
+         v->timerDeadlines[i] = context->timers[i].deadline;
+      }
+   }
+
+   //Save the variables of the state machines
+   v->eapFail = context->eapFail;
+   v->eapSuccess = context->eapSuccess;
+   v->keyDone = context->keyDone;
+   v->keyRun = context->keyRun;
+   v->portEnabled = context->portEnabled;
+   v->portValid = context->portValid;
+   v->suppAbort = context->suppAbort;
+   v->suppFail = context->suppFail;
+   v->suppAuthorized = authorized;
+   v->suppStart = context->suppStart;
+   v->suppSuccess = context->suppSuccess;
+   v->suppTimeout = context->suppTimeout;
+
+   v->eapRestart = context->eapRestart;
+   v->logoffSent = context->logoffSent;
+   v->sPortMode = (uint8_t) context->sPortMode;
+   v->startCount = (uint8_t) MIN(context->startCount, UINT8_MAX);
+   v->userLogoff = context->userLogoff;
+
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   v->fastStartDelay = context->fastStartDelay;
+#endif
+
+   v->eapNoResp = context->eapNoResp;
+   v->eapReq = context->eapReq;
+   v->eapResp = context->eapResp;
+
+   v->allowNotifications = context->allowNotifications;
+   v->altAccept = context->altAccept;
+   v->altReject = context->altReject;
+   v->eapKeyAvailable = context->eapKeyAvailable;
+
+   v->selectedMethod = (uint8_t) context->selectedMethod;
+   v->methodState = (uint8_t) context->methodState;
+   v->decision = (uint8_t) context->decision;
+
+   //Save the last EAP response
+   if(context->lastId != EAP_LAST_ID_NONE &&
+      context->lastRespDataLen <= SUPPLICANT_LOADGEN_MAX_RESP_LEN)
+   {
+      v->lastId = (uint16_t) context->lastId;
+      v->lastRespDataLen = (uint8_t) context->lastRespDataLen;
+      osMemcpy(v->lastRespData, context->lastRespData,
+         context->lastRespDataLen);
+   }
+   else
+   {
+      //The response does not fit in the virtual supplicant. A duplicate
+      //request will be processed again instead of being answered with a
+      //retransmission
+      v->lastId = 0xFFFF;
+      v->lastRespDataLen = 0;
+   }
+
+   v->rxReq = context->rxReq;
+   v->rxSuccess = context->rxSuccess;
+   v->rxFailure = context->rxFailure;
+   v->reqId = (uint8_t) context->reqId;
+   v->reqMethod = (uint8_t) context->reqMethod;
+   v->ignore = context->ignore;
+
+   v->allowCanned = context->allowCanned;
+
+   //The 802.1X supplicant context is released
+   loadGen->current = NULL;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file supplicant_loadgen.h
+ * @brief Load generator emulating virtual supplicants
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _SUPPLICANT_LOADGEN_H
+#define _SUPPLICANT_LOADGEN_H
+
+//Dependencies
+#include "supplicant/supplicant.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Compact state of a virtual supplicant
+ *
+ * Only the variables of the state machines are kept for each virtual
+ * supplicant. The buffers are provided by the 802.1X supplicant context the
+ * load generator is attached to
+ *
+ **/
+
+typedef struct
+{
+   MacAddr macAddr;                   ///<MAC address of the virtual supplicant
+   MacAddr authAddr;                  ///<MAC address of the authenticator
+   uint8_t suppPaeState;              ///<Supplicant PAE state
+   uint8_t suppBackendState;          ///<Supplicant backend state
+   uint8_t eapPeerState;              ///<EAP peer state
+   uint8_t sPortMode;                 ///<Mode of operation of the port
+   uint8_t startCount;                ///<Number of EAPOL-Start messages that have been sent
+   uint8_t selectedMethod;            ///<The method currently in progress
+   uint8_t methodState;               ///<Method state
+   uint8_t decision;                  ///<Decision
+   uint8_t reqMethod;                 ///<Method type of the current EAP request
+   uint8_t reqId;                     ///<Identifier value associated with the current EAP request
+   uint16_t lastId;                   ///<EAP identifier value of the last request (0xFFFF if none)
+   uint8_t timerMask;                 ///<Running timers (bitmask)
+   uint8_t lastRespDataLen;           ///<Length of the last EAP response
+   uint_t active : 1;                 ///<The virtual supplicant has arrived
+   uint_t eapFail : 1;
+   uint_t eapSuccess : 1;
+   uint_t keyDone : 1;
+   uint_t keyRun : 1;
+   uint_t portEnabled : 1;
+   uint_t portValid : 1;
+   uint_t suppAbort : 1;
+   uint_t suppFail : 1;
+   uint_t suppAuthorized : 1;
+   uint_t suppStart : 1;
+   uint_t suppSuccess : 1;
+   uint_t suppTimeout : 1;
+   uint_t eapRestart : 1;
+   uint_t logoffSent : 1;
+   uint_t userLogoff : 1;
+   uint_t eapNoResp : 1;
+   uint_t eapReq : 1;
+   uint_t eapResp : 1;
+   uint_t allowNotifications : 1;
+   uint_t altAccept : 1;
+   uint_t altReject : 1;
+   uint_t eapKeyAvailable : 1;
+   uint_t rxReq : 1;
+   uint_t rxSuccess : 1;
+   uint_t rxFailure : 1;
+   uint_t ignore : 1;
+   uint_t allowCanned : 1;
+   systime_t timerDeadlines[SUPPLICANT_NUM_TIMERS]; ///<Time at which the running timers expire
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   systime_t fastStartDelay;          ///<Interval before the next EAPOL-Start retransmission
+#endif
+   systime_t startTime;               ///<Time at which the authentication started
+   uint8_t lastRespData[SUPPLICANT_LOADGEN_MAX_RESP_LEN]; ///<Last EAP response
+} SupplicantVirtual;
+
+
+/**
+ * @brief Load generator statistics
+ **/
+
+typedef struct
+{
+   uint_t numActive;             ///<Number of virtual supplicants that have arrived
+   uint_t numAuthorized;         ///<Number of virtual supplicants currently authorized
+   uint32_t authSuccesses;       ///<Number of successful authentications
+   uint32_t authFailures;        ///<Number of failed authentications
+   uint32_t authTimeouts;        ///<Number of authentications that have timed out
+   systime_t minLatency;         ///<Shortest authentication time, in milliseconds
+   systime_t maxLatency;         ///<Longest authentication time, in milliseconds
+   uint64_t totalLatency;        ///<Sum of the authentication times, in milliseconds
+} SupplicantLoadGenStats;
+
+
+/**
+ * @brief Load generator
+ **/
+
+struct _SupplicantLoadGen
+{
+   SupplicantContext *context;   ///<802.1X supplicant context providing the buffers and the task
+   SupplicantVirtual *virtuals;  ///<Virtual supplicants
+   uint_t numVirtuals;           ///<Number of virtual supplicants
+   SupplicantVirtual *current;   ///<Virtual supplicant loaded in the 802.1X supplicant context
+   uint_t arrivalRate;           ///<Number of virtual supplicants arriving per second (0 for all at once)
+   uint_t numArrivals;           ///<Number of virtual supplicants that have arrived
+   systime_t arrivalTime;        ///<Time at which the next virtual supplicant arrives
+   SupplicantLoadGenStats stats; ///<Statistics
+};
+
+
+//Load generator related functions
+error_t supplicantLoadGenInit(SupplicantLoadGen *loadGen,
+   SupplicantContext *context, SupplicantVirtual *virtuals,
+   uint_t numVirtuals, const MacAddr *baseMacAddr);
+
+error_t supplicantLoadGenSetArrivalRate(SupplicantLoadGen *loadGen,
+   uint_t arrivalRate);
+
+error_t supplicantLoadGenGetStats(SupplicantLoadGen *loadGen,
+   SupplicantLoadGenStats *stats);
+
+void supplicantLoadGenStart(SupplicantLoadGen *loadGen);
+void supplicantLoadGenTick(SupplicantLoadGen *loadGen);
+void supplicantLoadGenProcessTimers(SupplicantLoadGen *loadGen);
+
+systime_t supplicantLoadGenGetTimerTimeout(SupplicantLoadGen *loadGen,
+   systime_t timeout);
+
+void supplicantLoadGenProcessEapPacket(SupplicantLoadGen *loadGen,
+   const MacAddr *destMacAddr, const MacAddr *srcMacAddr,
+   const EapPacket *packet, size_t length);
+
+const MacAddr *supplicantLoadGenGetMacAddr(SupplicantLoadGen *loadGen);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
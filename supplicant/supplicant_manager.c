@@ -0,0 +1,445 @@
+/**
+ * @file supplicant_manager.c
+ * @brief Supplicant manager (multiple instances driven by a single task)
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Switch to the appropriate trace level
+#define TRACE_LEVEL SUPPLICANT_TRACE_LEVEL
+
+//Dependencies
+#include "supplicant/supplicant.h"
+#include "supplicant/supplicant_manager.h"
+#include "supplicant/supplicant_misc.h"
+#include "debug.h"
+
+//Check EAP library configuration
+#if (SUPPLICANT_SUPPORT == ENABLED && SUPPLICANT_MANAGER_SUPPORT == ENABLED)
+
+
+/**
+ * @brief Initialize settings with default values
+ * @param[out] settings Structure that contains supplicant manager settings
+ **/
+
+void supplicantManagerGetDefaultSettings(SupplicantManagerSettings *settings)
+{
+   //Default task parameters
+   settings->task = OS_TASK_DEFAULT_PARAMS;
+   settings->task.stackSize = SUPPLICANT_STACK_SIZE;
+   settings->task.priority = SUPPLICANT_PRIORITY;
+}
+
+
+/**
+ * @brief Initialize supplicant manager
+ *
+ * The manager owns the task, the event object and the reception buffer that
+ * are shared by the 802.1X supplicant instances attached to it
+ *
+ * @param[in] manager Pointer to the supplicant manager
+ * @param[in] settings Supplicant manager specific settings
+ * @return Error code
+ **/
+
+error_t supplicantManagerInit(SupplicantManager *manager,
+   const SupplicantManagerSettings *settings)
+{
+   error_t error;
+
+   //Debug message
+   TRACE_INFO("Initializing supplicant manager...\r\n");
+
+   //Ensure the parameters are valid
+   if(manager == NULL || settings == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Clear supplicant manager
+   osMemset(manager, 0, sizeof(SupplicantManager));
+
+   //Initialize task parameters
+   manager->taskParams = settings->task;
+   manager->taskId = OS_INVALID_TASK_ID;
+
+   //Start of exception handling block
+   do
+   {
+      //Create a mutex to protect the list of instances
+      if(!osCreateMutex(&manager->mutex))
+      {
+         //Failed to create mutex
+         error = ERROR_OUT_OF_RESOURCES;
+         break;
+      }
+
+      //Create an event object to poll the state of the raw sockets
+      if(!osCreateEvent(&manager->event))
+      {
+         //Failed to create event
+         error = ERROR_OUT_OF_RESOURCES;
+         break;
+      }
+
+      //Successful initialization
+      error = NO_ERROR;
+
+      //End of exception handling block
+   } while(0);
+
+   //Any error to report?
+   if(error)
+   {
+      //Clean up side effects
+      supplicantManagerDeinit(manager);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Start supplicant manager
+ * @param[in] manager Pointer to the supplicant manager
+ * @return Error code
+ **/
+
+error_t supplicantManagerStart(SupplicantManager *manager)
+{
+   //Make sure the supplicant manager is valid
+   if(manager == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Debug message
+   TRACE_INFO("Starting supplicant manager...\r\n");
+
+   //Make sure the manager is not already running
+   if(manager->running)
+      return ERROR_ALREADY_RUNNING;
+
+   //Start the manager
+   manager->stop = FALSE;
+   manager->running = TRUE;
+
+   //Create a task
+   manager->taskId = osCreateTask("Supplicant",
+      (OsTaskCode) supplicantManagerTask, manager, &manager->taskParams);
+
+   //Failed to create task?
+   if(manager->taskId == OS_INVALID_TASK_ID)
+   {
+      //Clean up side effects
+      manager->running = FALSE;
+      //Report an error
+      return ERROR_OUT_OF_RESOURCES;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Stop supplicant manager
+ * @param[in] manager Pointer to the supplicant manager
+ * @return Error code
+ **/
+
+error_t supplicantManagerStop(SupplicantManager *manager)
+{
+   //Make sure the supplicant manager is valid
+   if(manager == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Debug message
+   TRACE_INFO("Stopping supplicant manager...\r\n");
+
+   //Check whether the manager is running
+   if(manager->running)
+   {
+#if (NET_RTOS_SUPPORT == ENABLED)
+      //Stop the manager
+      manager->stop = TRUE;
+      //Send a signal to the task to abort any blocking operation
+      osSetEvent(&manager->event);
+
+      //Wait for the task to terminate
+      while(manager->running)
+      {
+         osDelayTask(1);
+      }
+#endif
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Supplicant manager task
+ *
+ * The sockets of all the running instances are polled at once. Each instance
+ * is then processed under its own mutex, exactly as it would be by a
+ * dedicated supplicant task
+ *
+ * @param[in] manager Pointer to the supplicant manager
+ **/
+
+void supplicantManagerTask(SupplicantManager *manager)
+{
+   uint_t i;
+   uint_t n;
+   systime_t time;
+   systime_t timeout;
+   SupplicantContext *context;
+
+#if (NET_RTOS_SUPPORT == ENABLED)
+   //Task prologue
+   osEnterTask();
+
+   //Process events
+   while(1)
+   {
+#endif
+      //Acquire exclusive access to the list of instances
+      osAcquireMutex(&manager->mutex);
+
+      //Build the poll set from the running instances
+      for(n = 0, i = 0; i < SUPPLICANT_MAX_INSTANCES; i++)
+      {
+         //Point to the current instance
+         context = manager->instances[i];
+
+         //Running instance?
+         if(context != NULL && context->running)
+         {
+            //Specify the events the application is interested in
+            manager->eventDesc[n].socket = context->socket;
+            manager->eventDesc[n].eventMask = SOCKET_EVENT_RX_READY;
+            manager->eventDesc[n].eventFlags = 0;
+
+            //Save the instance the descriptor belongs to
+            manager->polledInstances[n++] = context;
+         }
+      }
+
+      //Release exclusive access to the list of instances
+      osReleaseMutex(&manager->mutex);
+
+      //Get current time
+      time = osGetSystemTime();
+      //Periodic operations are performed once per tick
+      timeout = SUPPLICANT_TICK_INTERVAL;
+
+      //Wake up when the nearest tick or timer of the instances expires
+      for(i = 0; i < n; i++)
+      {
+         //Point to the current instance
+         context = manager->polledInstances[i];
+
+         //Acquire exclusive access to the 802.1X supplicant context
+         osAcquireMutex(&context->mutex);
+
+         //Next tick of the instance
+         if((time - context->timestamp) < SUPPLICANT_TICK_INTERVAL)
+         {
+            timeout = MIN(timeout, context->timestamp +
+               SUPPLICANT_TICK_INTERVAL - time);
+         }
+         else
+         {
+            timeout = 0;
+         }
+
+         //Nearest timer of the instance
+         timeout = supplicantGetTimerTimeout(context, timeout);
+
+         //Release exclusive access to the 802.1X supplicant context
+         osReleaseMutex(&context->mutex);
+      }
+
+      //Wait for an event
+      socketPoll(manager->eventDesc, n, &manager->event, timeout);
+
+      //Stop request?
+      if(manager->stop)
+      {
+         //Stop manager operation
+         manager->running = FALSE;
+         //Task epilogue
+         osExitTask();
+         //Kill ourselves
+         osDeleteTask(OS_SELF_TASK_ID);
+      }
+
+      //Process the instances of the poll set
+      for(i = 0; i < n; i++)
+      {
+         //Point to the current instance
+         context = manager->polledInstances[i];
+
+         //Acquire exclusive access to the 802.1X supplicant context
+         osAcquireMutex(&context->mutex);
+
+         //Stop request?
+         if(context->stop)
+         {
+            //The socket is no longer polled
+            context->running = FALSE;
+         }
+         else
+         {
+            //Any EAPOL packet received?
+            if(manager->eventDesc[i].eventFlags != 0)
+            {
+               //Process incoming EAPOL packet. The PDU is fully processed
+               //before the shared reception buffer is reused
+               supplicantProcessEapolPdu(context);
+            }
+
+            //Process the timers that have expired
+            supplicantProcessTimers(context);
+
+            //Get current time
+            time = osGetSystemTime();
+
+            //Periodic operations are performed once per tick
+            if((time - context->timestamp) >= SUPPLICANT_TICK_INTERVAL)
+            {
+               //Handle periodic operations
+               supplicantTick(context);
+               //Save current time
+               context->timestamp = time;
+            }
+         }
+
+         //Release exclusive access to the 802.1X supplicant context
+         osReleaseMutex(&context->mutex);
+      }
+
+#if (NET_RTOS_SUPPORT == ENABLED)
+   }
+#endif
+}
+
+
+/**
+ * @brief Release supplicant manager
+ *
+ * The instances attached to the manager must have been released beforehand
+ *
+ * @param[in] manager Pointer to the supplicant manager
+ **/
+
+void supplicantManagerDeinit(SupplicantManager *manager)
+{
+   //Make sure the supplicant manager is valid
+   if(manager != NULL)
+   {
+      //Free previously allocated resources
+      osDeleteMutex(&manager->mutex);
+      osDeleteEvent(&manager->event);
+
+      //Clear supplicant manager
+      osMemset(manager, 0, sizeof(SupplicantManager));
+   }
+}
+
+
+/**
+ * @brief Attach an 802.1X supplicant instance to the manager
+ * @param[in] manager Pointer to the supplicant manager
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @return Error code
+ **/
+
+error_t supplicantManagerAttach(SupplicantManager *manager,
+   SupplicantContext *context)
+{
+   error_t error;
+   uint_t i;
+
+   //Initialize status code
+   error = ERROR_OUT_OF_RESOURCES;
+
+   //Acquire exclusive access to the list of instances
+   osAcquireMutex(&manager->mutex);
+
+   //Loop through the instance table
+   for(i = 0; i < SUPPLICANT_MAX_INSTANCES; i++)
+   {
+      //Free entry?
+      if(manager->instances[i] == NULL)
+      {
+         //Register the instance
+         manager->instances[i] = context;
+         //Successful processing
+         error = NO_ERROR;
+         break;
+      }
+   }
+
+   //Release exclusive access to the list of instances
+   osReleaseMutex(&manager->mutex);
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Detach an 802.1X supplicant instance from the manager
+ * @param[in] manager Pointer to the supplicant manager
+ * @param[in] context Pointer to the 802.1X supplicant context
+ **/
+
+void supplicantManagerDetach(SupplicantManager *manager,
+   SupplicantContext *context)
+{
+   uint_t i;
+
+   //Acquire exclusive access to the list of instances
+   osAcquireMutex(&manager->mutex);
+
+   //Loop through the instance table
+   for(i = 0; i < SUPPLICANT_MAX_INSTANCES; i++)
+   {
+      //Matching entry?
+      if(manager->instances[i] == context)
+      {
+         //Unregister the instance
+         manager->instances[i] = NULL;
+         break;
+      }
+   }
+
+   //Release exclusive access to the list of instances
+   osReleaseMutex(&manager->mutex);
+}
+
+#endif
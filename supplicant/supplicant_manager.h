@@ -0,0 +1,96 @@
+/**
+ * @file supplicant_manager.h
+ * @brief Supplicant manager (multiple instances driven by a single task)
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _SUPPLICANT_MANAGER_H
+#define _SUPPLICANT_MANAGER_H
+
+//Dependencies
+#include "supplicant/supplicant.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Supplicant manager settings
+ **/
+
+typedef struct
+{
+   OsTaskParameters task; ///<Task parameters
+} SupplicantManagerSettings;
+
+
+/**
+ * @brief Supplicant manager
+ **/
+
+struct _SupplicantManager
+{
+   bool_t running;                                                ///<Operational state of the manager
+   bool_t stop;                                                   ///<Stop request
+   OsMutex mutex;                                                 ///<Mutex protecting the list of instances
+   OsEvent event;                                                 ///<Event object used to poll the sockets of the instances
+   OsTaskParameters taskParams;                                   ///<Task parameters
+   OsTaskId taskId;                                               ///<Task identifier
+   SupplicantContext *instances[SUPPLICANT_MAX_INSTANCES];        ///<Instances attached to the manager
+   SupplicantContext *polledInstances[SUPPLICANT_MAX_INSTANCES];  ///<Instances in the current poll set
+   SocketEventDesc eventDesc[SUPPLICANT_MAX_INSTANCES];           ///<Poll set
+   uint8_t rxBuffer[SUPPLICANT_RX_BUFFER_SIZE];                   ///<Reception buffer shared by the instances
+};
+
+
+//Supplicant manager related functions
+void supplicantManagerGetDefaultSettings(SupplicantManagerSettings *settings);
+
+error_t supplicantManagerInit(SupplicantManager *manager,
+   const SupplicantManagerSettings *settings);
+
+error_t supplicantManagerStart(SupplicantManager *manager);
+error_t supplicantManagerStop(SupplicantManager *manager);
+
+void supplicantManagerTask(SupplicantManager *manager);
+
+void supplicantManagerDeinit(SupplicantManager *manager);
+
+error_t supplicantManagerAttach(SupplicantManager *manager,
+   SupplicantContext *context);
+
+void supplicantManagerDetach(SupplicantManager *manager,
+   SupplicantContext *context);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
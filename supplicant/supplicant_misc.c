@@ -36,6 +36,7 @@
 #include "supplicant/supplicant_fsm.h"
 #include "supplicant/supplicant_procedures.h"
 #include "supplicant/supplicant_misc.h"
+#include "supplicant/supplicant_loadgen.h"
 #include "eap/eap_debug.h"
 #include "debug.h"
 
@@ -53,16 +54,20 @@ static const MacAddr PAE_GROUP_ADDR = {{{0x01, 0x80, 0xC2, 0x00, 0x00, 0x03}}};
 
 void supplicantTick(SupplicantContext *context)
 {
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+   //Virtual supplicants emulated on top of the instance?
+   if(context->loadGen != NULL)
+   {
+      //Evaluate the state machines of each virtual supplicant
+      supplicantLoadGenTick(context->loadGen);
+      return;
+   }
+#endif
+
    //The portEnabled variable is externally controlled. Its value reflects
    //the operational state of the MAC service supporting the port
    context->portEnabled = supplicantGetLinkState(context);
 
-   //Timers are decremented once per second
-   supplicantDecrementTimer(&context->startWhen);
-   supplicantDecrementTimer(&context->heldWhile);
-   supplicantDecrementTimer(&context->authWhile);
-   supplicantDecrementTimer(&context->idleWhile);
-
    //Update supplicant state machines
    supplicantFsm(context);
 
@@ -75,6 +80,208 @@ void supplicantTick(SupplicantContext *context)
 }
 
 
+/**
+ * @brief Initialize the timers
+ * @param[in] context Pointer to the 802.1X supplicant context
+ **/
+
+void supplicantInitTimers(SupplicantContext *context)
+{
+   uint_t i;
+
+   //Bind each timer to the corresponding state machine variable
+   context->timers[SUPPLICANT_TIMER_AUTH_WHILE].value = &context->authWhile;
+   context->timers[SUPPLICANT_TIMER_HELD_WHILE].value = &context->heldWhile;
+   context->timers[SUPPLICANT_TIMER_START_WHEN].value = &context->startWhen;
+   context->timers[SUPPLICANT_TIMER_IDLE_WHILE].value = &context->idleWhile;
+
+   //Initialize timers
+   for(i = 0; i < SUPPLICANT_NUM_TIMERS; i++)
+   {
+      context->timers[i].running = FALSE;
+      context->timers[i].deadline = 0;
+
+      //The timer is not running
+      *context->timers[i].value = 0;
+   }
+}
+
+
+/**
+ * @brief Start a timer
+ *
+ * The timer variable keeps a non-zero value as long as the timer is running.
+ * It is reset to zero when the deadline is reached
+ *
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] id Timer identifier
+ * @param[in] delay Initial value of the timer, in milliseconds
+ **/
+
+void supplicantStartTimer(SupplicantContext *context, SupplicantTimerId id,
+   systime_t delay)
+{
+   SupplicantTimer *timer;
+
+   //Point to the relevant timer
+   timer = &context->timers[id];
+
+   //Set the initial value of the timer
+   *timer->value = delay;
+
+   //A timer initialized with a zero value has already expired
+   if(delay > 0)
+   {
+      //Calculate the time at which the timer expires
+      timer->deadline = osGetSystemTime() + delay;
+      //The timer is now running
+      timer->running = TRUE;
+   }
+   else
+   {
+      //The timer is not running
+      timer->running = FALSE;
+   }
+}
+
+
+/**
+ * @brief Stop a timer
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] id Timer identifier
+ **/
+
+void supplicantStopTimer(SupplicantContext *context, SupplicantTimerId id)
+{
+   //The timer is no longer running
+   context->timers[id].running = FALSE;
+   *context->timers[id].value = 0;
+}
+
+
+/**
+ * @brief Process the timers that have expired
+ * @param[in] context Pointer to the 802.1X supplicant context
+ **/
+
+void supplicantProcessTimers(SupplicantContext *context)
+{
+   uint_t i;
+   bool_t expired;
+   systime_t time;
+
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+   //Virtual supplicants emulated on top of the instance?
+   if(context->loadGen != NULL)
+   {
+      //Process arrivals and the timers of each virtual supplicant
+      supplicantLoadGenProcessTimers(context->loadGen);
+      return;
+   }
+#endif
+
+   //Get current time
+   time = osGetSystemTime();
+   //No timer has expired yet
+   expired = FALSE;
+
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   //With the fast-start policy, the link state of a port that is down is
+   //polled more often than once per tick
+   if(context->fastStart && !context->portEnabled)
+   {
+      //Check whether the link is up
+      if(supplicantGetLinkState(context))
+      {
+         //The port has become operable. An EAPOL-Start is sent right away
+         context->portEnabled = TRUE;
+         //The state machines must be evaluated
+         expired = TRUE;
+      }
+   }
+#endif
+
+   //Loop through the timers
+   for(i = 0; i < SUPPLICANT_NUM_TIMERS; i++)
+   {
+      //Check whether the deadline has been reached
+      if(context->timers[i].running &&
+         timeCompare(time, context->timers[i].deadline) >= 0)
+      {
+         //The timer has expired
+         context->timers[i].running = FALSE;
+         *context->timers[i].value = 0;
+
+         //The state machines must be evaluated
+         expired = TRUE;
+      }
+   }
+
+   //Any timer expired?
+   if(expired)
+   {
+      //Update supplicant state machines
+      supplicantFsm(context);
+   }
+}
+
+
+/**
+ * @brief Get the time remaining before the next timer expires
+ * @param[in] context Pointer to the 802.1X supplicant context
+ * @param[in] timeout Maximum value to be returned, in milliseconds
+ * @return Time remaining before the nearest deadline, in milliseconds
+ **/
+
+systime_t supplicantGetTimerTimeout(SupplicantContext *context,
+   systime_t timeout)
+{
+   uint_t i;
+   systime_t time;
+
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+   //Virtual supplicants emulated on top of the instance?
+   if(context->loadGen != NULL)
+   {
+      //Get the time remaining before the next arrival or timer expiry
+      return supplicantLoadGenGetTimerTimeout(context->loadGen, timeout);
+   }
+#endif
+
+   //Get current time
+   time = osGetSystemTime();
+
+   //Loop through the timers
+   for(i = 0; i < SUPPLICANT_NUM_TIMERS; i++)
+   {
+      //Running timer?
+      if(context->timers[i].running)
+      {
+         //Check whether the deadline has already been reached
+         if(timeCompare(context->timers[i].deadline, time) > 0)
+         {
+            timeout = MIN(timeout, context->timers[i].deadline - time);
+         }
+         else
+         {
+            timeout = 0;
+         }
+      }
+   }
+
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+   //Wake up periodically to detect link-up events
+   if(context->fastStart && !context->portEnabled)
+   {
+      timeout = MIN(timeout, SUPPLICANT_LINK_POLL_INTERVAL);
+   }
+#endif
+
+   //Return the time remaining before the nearest deadline
+   return timeout;
+}
+
+
 /**
  * @brief Get link state
  * @param[in] context Pointer to the 802.1X supplicant context
@@ -292,6 +499,18 @@ error_t supplicantSendEapolPdu(SupplicantContext *context, const uint8_t *pdu,
    //section 11.1.2)
    error = netGetMacAddr(context->interface, &msg.srcMacAddr);
 
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+   //Virtual supplicant being processed?
+   if(!error && context->loadGen != NULL)
+   {
+      //Use the MAC address of the virtual supplicant
+      if(context->loadGen->current != NULL)
+      {
+         msg.srcMacAddr = context->loadGen->current->macAddr;
+      }
+   }
+#endif
+
    //Check status code
    if(!error)
    {
@@ -346,7 +565,14 @@ void supplicantProcessEapolPdu(SupplicantContext *context)
    if(!macCompAddr(&msg.destMacAddr, &PAE_GROUP_ADDR) &&
       !macCompAddr(&msg.destMacAddr, &macAddr))
    {
-      return;
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+      //Frames sent to the virtual supplicants are filtered by the load
+      //generator
+      if(context->loadGen == NULL)
+#endif
+      {
+         return;
+      }
    }
 
    //The received MPDU must contain the PAE EtherType
@@ -376,6 +602,20 @@ void supplicantProcessEapolPdu(SupplicantContext *context)
    //Check packet type
    if(pdu->packetType == EAPOL_TYPE_EAP)
    {
+#if (SUPPLICANT_LOADGEN_SUPPORT == ENABLED)
+      //Virtual supplicants emulated on top of the instance?
+      if(context->loadGen != NULL)
+      {
+         //Dispatch the EAP packet to the relevant virtual supplicants
+         supplicantLoadGenProcessEapPacket(context->loadGen, &msg.destMacAddr,
+            &msg.srcMacAddr, (EapPacket *) pdu->packetBody, length);
+         return;
+      }
+#endif
+
+      //Save the MAC address of the authenticator
+      context->authAddr = msg.srcMacAddr;
+
       //Process incoming EAP packet
       supplicantProcessEapPacket(context, (EapPacket *) pdu->packetBody,
          length);
@@ -41,6 +41,17 @@ extern "C" {
 
 //Supplicant related functions
 void supplicantTick(SupplicantContext *context);
+
+void supplicantInitTimers(SupplicantContext *context);
+
+void supplicantStartTimer(SupplicantContext *context, SupplicantTimerId id,
+   systime_t delay);
+
+void supplicantStopTimer(SupplicantContext *context, SupplicantTimerId id);
+void supplicantProcessTimers(SupplicantContext *context);
+
+systime_t supplicantGetTimerTimeout(SupplicantContext *context,
+   systime_t timeout);
 bool_t supplicantGetLinkState(SupplicantContext *context);
 
 error_t supplicantAcceptPaeGroupAddr(SupplicantContext *context);
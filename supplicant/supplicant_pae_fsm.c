@@ -327,6 +327,9 @@ void supplicantPaeChangeState(SupplicantContext *context,
       //initialized or reinitialized
       context->sPortMode = SUPPLICANT_PORT_MODE_AUTO;
       context->startCount = 0;
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+      context->fastStartDelay = SUPPLICANT_FAST_START_INITIAL_DELAY;
+#endif
       context->logoffSent = FALSE;
       context->suppPortStatus = SUPPLICANT_PORT_STATUS_UNAUTH;
       context->suppAbort = TRUE;
@@ -336,8 +339,24 @@ void supplicantPaeChangeState(SupplicantContext *context,
    case SUPPLICANT_PAE_STATE_CONNECTING:
       //In this state, the port has become operable and the supplicant is
       //attempting to acquire an authenticator
-      context->startWhen = context->startPeriod;
-      context->startCount++;
+#if (SUPPLICANT_FAST_START_SUPPORT == ENABLED)
+      if(context->fastStart &&
+         context->fastStartDelay < (context->startPeriod * 1000))
+      {
+         //The first EAPOL-Start messages are retransmitted on an exponential
+         //schedule, in case they are sent before the authenticator is ready.
+         //These early retransmissions do not count against maxStart
+         supplicantStartTimer(context, SUPPLICANT_TIMER_START_WHEN,
+            context->fastStartDelay);
+         context->fastStartDelay *= 2;
+      }
+      else
+#endif
+      {
+         supplicantStartTimer(context, SUPPLICANT_TIMER_START_WHEN,
+            context->startPeriod * 1000);
+         context->startCount++;
+      }
       context->eapolEap = FALSE;
       supplicantTxStart(context);
       break;
@@ -365,7 +384,8 @@ void supplicantPaeChangeState(SupplicantContext *context,
    case SUPPLICANT_PAE_STATE_HELD:
       //The state provides a delay period before the supplicant will attempt to
       //acquire an authenticator
-      context->heldWhile = context->heldPeriod;
+      supplicantStartTimer(context, SUPPLICANT_TIMER_HELD_WHILE,
+         context->heldPeriod * 1000);
       context->suppPortStatus = SUPPLICANT_PORT_STATUS_UNAUTH;
       break;
 
@@ -145,8 +145,9 @@ void supplicantTxSuppRsp(SupplicantContext *context)
    //Debug message
    TRACE_DEBUG("txSuppRsp() procedure...\r\n");
 
-   //Point to the buffer where to format the EAPOL packet
-   pdu = (EapolPdu *) context->txBuffer;
+   //The EAPOL header immediately precedes the EAP response, which may not be
+   //located at the beginning of the transmit buffer
+   pdu = (EapolPdu *) (context->eapRespData - sizeof(EapolPdu));
    //Retrieve the length of the EAP response
    length = context->eapRespDataLen;
 
@@ -167,23 +168,7 @@ void supplicantTxSuppRsp(SupplicantContext *context)
       eapolDumpHeader(pdu);
 
       //Send EAPOL PDU
-      supplicantSendEapolPdu(context, context->txBuffer, length);
-   }
-}
-
-
-/**
- * @brief Decrement timer value
- * @param[in,out] x Actual timer value
- **/
-
-void supplicantDecrementTimer(uint_t *x)
-{
-   //If the variable has a non-zero value, this procedure decrements the value
-   //of the variable by 1
-   if(*x > 0)
-   {
-      *x -= 1;
+      supplicantSendEapolPdu(context, (uint8_t *) pdu, length);
    }
 }
 
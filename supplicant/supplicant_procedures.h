@@ -47,8 +47,6 @@ void supplicantAbortSupp(SupplicantContext *context);
 void supplicantGetSuppRsp(SupplicantContext *context);
 void supplicantTxSuppRsp(SupplicantContext *context);
 
-void supplicantDecrementTimer(uint_t *x);
-
 //C++ guard
 #ifdef __cplusplus
 }
@@ -0,0 +1,945 @@
+/**
+ * @file bench_auth.c
+ * @brief Authentication throughput benchmark
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * The authenticator task is run against the fake network layer. Several
+ * simulated supplicants are attached to each port (the first one is bound to
+ * the port context and the others to additional sessions) and a scripted
+ * RADIUS server answers the Access-Requests after a configurable round-trip
+ * time. The server sends a configurable number of Access-Challenge rounds
+ * before accepting the supplicant. The link state of the ports is acquired
+ * through the switch driver.
+ *
+ * The rounds carry EAP-MD5 challenges. Multi-round methods such as EAP-TLS
+ * are approximated by the number of round trips only: no TLS record is
+ * formatted or processed, so the CPU time excludes the TLS handshake that an
+ * EAP-TLS supplicant would drive.
+ *
+ * Once a supplicant has been authorized, it restarts the authentication with
+ * an EAPOL-Start frame until the requested number of authentications has
+ * been run by every supplicant. The benchmark reports:
+ * - the number of authentications per second
+ * - the CPU time spent in authenticatorTask per authentication (the CPU time
+ *   of the fake network layer is included)
+ * - the percentiles of the time from the EAPOL-Start to the EAP-Success
+ * - the peak RAM used by the authenticator. The authenticator does not
+ *   allocate memory dynamically, so the peak is made of the contexts handed
+ *   over at initialization, plus the session buffers in use at the busiest
+ *   moment of the run
+ * - the peak resident set size of the whole process, for reference
+ *
+ * The benchmark relies on the POSIX clocks of the host. It is built by the
+ * bench_auth target of tests/Makefile, with the EAPOL rate limiters
+ * disabled. All the supplicants answer at the same time, so the EAPOL
+ * receive ring must hold one frame per supplicant (the frames that do not fit
+ * are dropped and only recovered by the retransmission timer).
+ *
+ * Usage: bench_auth [ports] [hosts_per_port] [rtt_ms] [auths_per_host]
+ *    [challenge_rounds]
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//POSIX clocks
+#define _POSIX_C_SOURCE 200112L
+
+//Dependencies
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "authenticator/authenticator.h"
+#include "test_net_fake.h"
+#include "test_radius_fake.h"
+
+//The EAPOL rate limiters would throttle the supplicants
+#if (AUTHENTICATOR_EAPOL_START_RATE != 0 || AUTHENTICATOR_EAP_FRAME_RATE != 0)
+   #error the benchmark requires AUTHENTICATOR_EAPOL_START_RATE and AUTHENTICATOR_EAP_FRAME_RATE to be 0
+#endif
+
+//Maximum number of ports
+#define BENCH_MAX_PORTS 48
+//Maximum number of supplicants
+#define BENCH_MAX_SUPPLICANTS 128
+//Maximum number of latency samples
+#define BENCH_MAX_SAMPLES 65536
+//Maximum length of a response of the server
+#define BENCH_MAX_REPLY_SIZE 256
+//Maximum time without progress before the benchmark is aborted, in ms
+#define BENCH_STALL_TIMEOUT 10000
+//Shared secret of the RADIUS server
+#define BENCH_SERVER_KEY "testing123"
+//Identity of the supplicants
+#define BENCH_IDENTITY "bench"
+
+
+/**
+ * @brief Simulated supplicant
+ **/
+
+typedef struct
+{
+   MacAddr macAddr;    ///<MAC address of the supplicant
+   bool_t started;     ///<The supplicant has sent its first EAPOL-Start
+   uint_t completed;   ///<Number of completed authentications
+   uint_t failed;      ///<Number of failed authentications
+   uint64_t startTime; ///<Start of the current authentication, in microseconds
+} BenchSupplicant;
+
+
+/**
+ * @brief Response delayed by the simulated RTT
+ **/
+
+typedef struct
+{
+   uint64_t dueTime;                   ///<Time at which the response is delivered, in microseconds
+   uint_t socket;                      ///<Socket the request was sent from
+   size_t length;                      ///<Length of the response, in bytes
+   uint8_t data[BENCH_MAX_REPLY_SIZE]; ///<Response
+} BenchReply;
+
+
+//Authenticator context
+static AuthenticatorContext benchContext;
+static AuthenticatorPort benchPorts[BENCH_MAX_PORTS];
+static AuthenticatorPortData benchPortData[BENCH_MAX_PORTS];
+static AuthenticatorPort benchHosts[BENCH_MAX_SUPPLICANTS];
+static AuthenticatorPortData benchHostData[BENCH_MAX_SUPPLICANTS];
+static AuthenticatorBuffer benchBuffers[BENCH_MAX_SUPPLICANTS];
+static uint8_t benchBufferMemory[AUTHENTICATOR_BUFFER_MEMORY_SIZE(
+   BENCH_MAX_SUPPLICANTS, AUTHENTICATOR_TX_BUFFER_SIZE)];
+
+//Simulated supplicants (hostsPerPort consecutive entries per port)
+static BenchSupplicant benchSupplicants[BENCH_MAX_SUPPLICANTS];
+//Responses in flight (each supplicant has at most one outstanding request)
+static BenchReply benchReplies[BENCH_MAX_SUPPLICANTS * 2];
+static uint_t benchReplyHead;
+static uint_t benchReplyCount;
+
+//Latency samples, in microseconds
+static uint32_t benchSamples[BENCH_MAX_SAMPLES];
+static uint_t benchNumSamples;
+
+//Benchmark parameters
+static uint_t benchNumPorts;
+static uint_t benchHostsPerPort;
+static uint_t benchNumSupplicants;
+static uint_t benchRtt;
+static uint_t benchAuthsPerHost;
+static uint_t benchRounds;
+
+//IP address of the RADIUS server
+static IpAddr benchServerIpAddr;
+//State of the deterministic PRNG
+static uint32_t benchPrngState;
+//CPU time spent in the authenticator task, in microseconds
+static uint64_t benchTaskCpuTime;
+//Highest number of session buffers in use
+static uint_t benchPeakSessions;
+
+
+/**
+ * @brief Read a POSIX clock
+ * @param[in] clockId Clock identifier
+ * @return Current value of the clock, in microseconds
+ **/
+
+static uint64_t benchGetClock(clockid_t clockId)
+{
+   struct timespec ts;
+
+   //Read the clock
+   clock_gettime(clockId, &ts);
+
+   //Convert the value to microseconds
+   return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+/**
+ * @brief Generate deterministic pseudo-random data
+ * @param[in] context Pointer to the PRNG state
+ * @param[out] output Buffer where to store the data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+static error_t benchPrngGenerate(void *context, uint8_t *output, size_t length)
+{
+   uint32_t *state;
+
+   //Point to the state of the generator
+   state = (uint32_t *) context;
+
+   //Xorshift generator
+   while(length-- > 0)
+   {
+      *state ^= *state << 13;
+      *state ^= *state >> 17;
+      *state ^= *state << 5;
+      *(output++) = (uint8_t) *state;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+//Deterministic PRNG (the benchmark does not need cryptographic strength)
+static const PrngAlgo benchPrngAlgo =
+{
+   .name = "Xorshift",
+   .contextSize = sizeof(uint32_t),
+   .generate = benchPrngGenerate
+};
+
+
+/**
+ * @brief Run the authenticator task until the receive queues are empty
+ **/
+
+static void benchRunTask(void)
+{
+   uint64_t startTime;
+
+   //Measure the CPU time spent by the authenticator
+   startTime = benchGetClock(CLOCK_PROCESS_CPUTIME_ID);
+
+   //The task also processes the timers that have expired
+   do
+   {
+      authenticatorTask(&benchContext);
+   } while(fakeNetGetPendingRx() > 0);
+
+   //Update the CPU time
+   benchTaskCpuTime += benchGetClock(CLOCK_PROCESS_CPUTIME_ID) - startTime;
+
+   //Keep track of the highest number of session buffers in use
+   benchPeakSessions = MAX(benchPeakSessions, benchContext.numSessions);
+}
+
+
+/**
+ * @brief Send an EAPOL PDU on behalf of a supplicant
+ * @param[in] index Index of the supplicant
+ * @param[in] packetType EAPOL packet type
+ * @param[in] body Packet body
+ * @param[in] length Length of the packet body, in bytes
+ **/
+
+static void benchSendEapol(uint_t index, uint8_t packetType, const void *body,
+   size_t length)
+{
+   uint8_t buffer[64];
+   EapolPdu *pdu;
+
+   //Format EAPOL header
+   pdu = (EapolPdu *) buffer;
+   pdu->protocolVersion = EAPOL_VERSION_2;
+   pdu->packetType = packetType;
+   pdu->packetBodyLen = htons(length);
+
+   //Copy the packet body
+   if(length > 0)
+   {
+      osMemcpy(pdu->packetBody, body, length);
+   }
+
+   //The PDU is received on the port of the supplicant
+   fakeNetInjectEapol(index / benchHostsPerPort + 1,
+      &benchSupplicants[index].macAddr, buffer, sizeof(EapolPdu) + length);
+}
+
+
+/**
+ * @brief Start the first authentication of a supplicant
+ * @param[in] index Index of the supplicant
+ **/
+
+static void benchStartSupplicant(uint_t index)
+{
+   BenchSupplicant *supplicant;
+
+   //Point to the supplicant
+   supplicant = &benchSupplicants[index];
+
+   //The supplicant has already been started?
+   if(supplicant->started)
+      return;
+
+   //Send an EAPOL-Start frame
+   supplicant->started = TRUE;
+   supplicant->startTime = benchGetClock(CLOCK_MONOTONIC);
+   benchSendEapol(index, EAPOL_TYPE_START, NULL, 0);
+}
+
+
+/**
+ * @brief Start the other supplicants of a port
+ * @param[in] index Index of the first supplicant of the port
+ *
+ * A supplicant that has no session is handled by the port context as long as
+ * the port is connecting. The other supplicants are therefore started once
+ * the first one has been bound to the port, so that each of them is given an
+ * additional session
+ **/
+
+static void benchStartOtherSupplicants(uint_t index)
+{
+   uint_t i;
+
+   //Loop through the other supplicants of the port
+   for(i = 1; i < benchHostsPerPort; i++)
+   {
+      benchStartSupplicant(index + i);
+   }
+}
+
+
+/**
+ * @brief Answer an EAP-Request on behalf of a supplicant
+ * @param[in] index Index of the supplicant
+ * @param[in] request Pointer to the EAP-Request
+ **/
+
+static void benchSendEapResponse(uint_t index, const EapRequest *request)
+{
+   size_t n;
+   uint8_t buffer[64];
+   EapResponse *response;
+
+   //Point to the EAP-Response
+   response = (EapResponse *) buffer;
+   response->code = EAP_CODE_RESPONSE;
+   response->identifier = request->identifier;
+   response->type = request->type;
+
+   //Check method type
+   if(request->type == EAP_METHOD_TYPE_IDENTITY)
+   {
+      //The supplicant identifies itself
+      n = osStrlen(BENCH_IDENTITY);
+      osMemcpy(response->data, BENCH_IDENTITY, n);
+   }
+   else
+   {
+      //The content of the challenge response is not checked by the server
+      n = MD5_DIGEST_SIZE + 1;
+      response->data[0] = MD5_DIGEST_SIZE;
+      osMemset(response->data + 1, 0x5A, MD5_DIGEST_SIZE);
+   }
+
+   //Length of the EAP-Response
+   n += sizeof(EapResponse);
+   response->length = htons(n);
+
+   //Send the EAP-Response
+   benchSendEapol(index, EAPOL_TYPE_EAP, buffer, n);
+}
+
+
+/**
+ * @brief Record the outcome of an authentication
+ * @param[in] index Index of the supplicant
+ * @param[in] success The supplicant has been authorized
+ **/
+
+static void benchCompleteAuth(uint_t index, bool_t success)
+{
+   uint64_t time;
+   BenchSupplicant *supplicant;
+
+   //Point to the supplicant
+   supplicant = &benchSupplicants[index];
+   //Get current time
+   time = benchGetClock(CLOCK_MONOTONIC);
+
+   //Check the outcome of the authentication
+   if(success)
+   {
+      //Save the latency of the authentication
+      if(benchNumSamples < BENCH_MAX_SAMPLES)
+      {
+         benchSamples[benchNumSamples++] = (uint32_t) (time -
+            supplicant->startTime);
+      }
+
+      supplicant->completed++;
+   }
+   else
+   {
+      supplicant->failed++;
+   }
+
+   //More authentications to run?
+   if((supplicant->completed + supplicant->failed) < benchAuthsPerHost)
+   {
+      //Restart the authentication
+      supplicant->startTime = time;
+      benchSendEapol(index, EAPOL_TYPE_START, NULL, 0);
+   }
+}
+
+
+/**
+ * @brief Process the EAPOL PDUs sent to the supplicants
+ * @param[in] measuring The authentications have started
+ * @return Number of supplicants that have been sent an EAP-Request/Identity
+ **/
+
+static uint_t benchRunSupplicants(bool_t measuring)
+{
+   uint_t i;
+   uint_t n;
+   uint_t index;
+   FakeNetMsg msg;
+   const EapolPdu *pdu;
+   const EapRequest *request;
+
+   //Number of EAP-Request/Identity seen
+   n = 0;
+
+   //Loop through the PDUs sent by the authenticator
+   while(fakeNetGetEapol(&msg))
+   {
+      //Point to the EAPOL PDU
+      pdu = (const EapolPdu *) msg.data;
+      //Point to the EAP packet
+      request = (const EapRequest *) pdu->packetBody;
+
+      //Discard the PDUs that do not carry an EAP packet
+      if(msg.length < (sizeof(EapolPdu) + sizeof(EapPacket)) ||
+         pdu->packetType != EAPOL_TYPE_EAP)
+      {
+         continue;
+      }
+
+      //Discard the PDUs sent on unknown ports
+      if(msg.switchPort < 1 || msg.switchPort > benchNumPorts)
+         continue;
+
+      //Index of the first supplicant of the port
+      index = (msg.switchPort - 1) * benchHostsPerPort;
+
+      //Unicast PDUs are destined to a given supplicant. Group-addressed PDUs
+      //are sent before any supplicant is bound to the port
+      for(i = 0; i < benchHostsPerPort; i++)
+      {
+         if(macCompAddr(&msg.destMacAddr, &benchSupplicants[index + i].macAddr))
+         {
+            index += i;
+            break;
+         }
+      }
+
+      //Check the code of the EAP packet
+      if(request->code == EAP_CODE_REQUEST &&
+         msg.length >= (sizeof(EapolPdu) + sizeof(EapRequest)))
+      {
+         //Count the EAP-Request/Identity
+         if(request->type == EAP_METHOD_TYPE_IDENTITY)
+         {
+            n++;
+         }
+
+         //The supplicants remain silent until the measurement starts
+         if(measuring)
+         {
+            benchSendEapResponse(index, request);
+
+            //The first supplicant of the port is being authenticated?
+            if(request->type != EAP_METHOD_TYPE_IDENTITY &&
+               (index % benchHostsPerPort) == 0)
+            {
+               benchStartOtherSupplicants(index);
+            }
+         }
+      }
+      else if(request->code == EAP_CODE_SUCCESS)
+      {
+         //The first supplicant of the port is bound to the port. The other
+         //supplicants must be started before it reconnects
+         if((index % benchHostsPerPort) == 0)
+         {
+            benchStartOtherSupplicants(index);
+         }
+
+         //The supplicant has been authorized
+         benchCompleteAuth(index, TRUE);
+      }
+      else if(request->code == EAP_CODE_FAILURE)
+      {
+         //The supplicant has been rejected
+         benchCompleteAuth(index, FALSE);
+      }
+      else
+      {
+         //Just for sanity
+      }
+   }
+
+   //Return the number of EAP-Request/Identity seen
+   return n;
+}
+
+
+/**
+ * @brief Process the Access-Requests and deliver the delayed responses
+ **/
+
+static void benchRunServer(void)
+{
+   uint8_t round;
+   size_t n;
+   uint64_t time;
+   uint8_t eapPacket[32];
+   FakeNetMsg msg;
+   BenchReply *reply;
+   const RadiusPacket *request;
+   const RadiusAttribute *attribute;
+
+   //Get current time
+   time = benchGetClock(CLOCK_MONOTONIC);
+
+   //Loop through the Access-Requests sent by the authenticator
+   while(fakeNetGetDatagram(&msg))
+   {
+      //Point to the Access-Request
+      request = (const RadiusPacket *) msg.data;
+
+      //Discard malformed requests
+      if(msg.length < sizeof(RadiusPacket) ||
+         request->code != RADIUS_CODE_ACCESS_REQUEST)
+      {
+         continue;
+      }
+
+      //Reassemble the EAP-Response
+      n = fakeRadiusGetEapMessage(request, eapPacket, sizeof(eapPacket));
+      //Discard the requests that carry no EAP-Response
+      if(n < sizeof(EapPacket) || benchReplyCount >= arraysize(benchReplies))
+         continue;
+
+      //The State attribute holds the number of challenges already sent
+      attribute = radiusGetAttribute(request, RADIUS_ATTR_STATE, 0);
+
+      //First request of the session?
+      if(attribute != NULL && attribute->length > sizeof(RadiusAttribute))
+      {
+         round = attribute->value[0];
+      }
+      else
+      {
+         round = 0;
+      }
+
+      //Allocate a slot for the response
+      reply = &benchReplies[(benchReplyHead + benchReplyCount) %
+         arraysize(benchReplies)];
+
+      //All the challenges sent?
+      if(round >= benchRounds)
+      {
+         //The EAP-Success carries the identifier of the EAP-Response
+         eapPacket[0] = EAP_CODE_SUCCESS;
+         STORE16BE(sizeof(EapPacket), eapPacket + 2);
+
+         //Format Access-Accept
+         reply->length = fakeRadiusFormatResponse(reply->data, request,
+            RADIUS_CODE_ACCESS_ACCEPT, eapPacket, sizeof(EapPacket), NULL, 0,
+            BENCH_SERVER_KEY, osStrlen(BENCH_SERVER_KEY));
+      }
+      else
+      {
+         //Format EAP-Request/MD5-Challenge (with the next identifier)
+         eapPacket[0] = EAP_CODE_REQUEST;
+         eapPacket[1]++;
+         STORE16BE(sizeof(EapRequest) + MD5_DIGEST_SIZE + 1, eapPacket + 2);
+         eapPacket[4] = EAP_METHOD_TYPE_MD5_CHALLENGE;
+         eapPacket[5] = MD5_DIGEST_SIZE;
+         osMemset(eapPacket + 6, 0xA5, MD5_DIGEST_SIZE);
+
+         //Format Access-Challenge
+         round++;
+         reply->length = fakeRadiusFormatResponse(reply->data, request,
+            RADIUS_CODE_ACCESS_CHALLENGE, eapPacket,
+            sizeof(EapRequest) + MD5_DIGEST_SIZE + 1, &round, sizeof(round),
+            BENCH_SERVER_KEY, osStrlen(BENCH_SERVER_KEY));
+      }
+
+      //The response is delivered once the simulated round-trip time has
+      //elapsed
+      reply->socket = msg.socket;
+      reply->dueTime = time + (uint64_t) benchRtt * 1000;
+      benchReplyCount++;
+   }
+
+   //Deliver the responses whose time has come (the RTT is constant, so the
+   //queue is sorted)
+   while(benchReplyCount > 0)
+   {
+      //Point to the oldest response
+      reply = &benchReplies[benchReplyHead];
+
+      //Not yet due?
+      if(reply->dueTime > time)
+         break;
+
+      //The response is received on the socket the request was sent from
+      fakeNetInjectDatagram(reply->socket, &benchServerIpAddr, RADIUS_PORT,
+         reply->data, reply->length);
+
+      //Release the slot
+      benchReplyHead = (benchReplyHead + 1) % arraysize(benchReplies);
+      benchReplyCount--;
+   }
+}
+
+
+/**
+ * @brief Initialize the authenticator and bring the ports up
+ * @return Error code
+ **/
+
+static error_t benchSetUp(void)
+{
+   error_t error;
+   uint_t i;
+   uint_t j;
+   AuthenticatorSettings settings;
+
+   //Reset the fake network layer
+   fakeNetInit();
+
+   //The server is reached through IPv4
+   osMemset(&benchServerIpAddr, 0, sizeof(IpAddr));
+   benchServerIpAddr.length = sizeof(Ipv4Addr);
+   benchServerIpAddr.ipv4Addr = htonl(0xC0000201);
+
+   //Seed the PRNG
+   benchPrngState = 0x2545F491;
+
+   //Get default settings
+   authenticatorGetDefaultSettings(&settings);
+
+   //The ports are attached to the fake network interface
+   settings.interface = fakeNetGetInterface();
+   settings.numPorts = benchNumPorts;
+   settings.ports = benchPorts;
+   settings.portData = benchPortData;
+   settings.numHosts = benchNumSupplicants - benchNumPorts;
+   settings.hosts = benchHosts;
+   settings.hostData = benchHostData;
+   settings.maxHostsPerPort = benchHostsPerPort;
+   settings.numBuffers = benchNumSupplicants;
+   settings.buffers = benchBuffers;
+   settings.bufferMemory = benchBufferMemory;
+   settings.serverIpAddr = benchServerIpAddr;
+   settings.prngAlgo = &benchPrngAlgo;
+   settings.prngContext = &benchPrngState;
+
+   //Initialize the authenticator
+   error = authenticatorInit(&benchContext, &settings);
+
+   //Check status code
+   if(!error)
+   {
+      //Set the shared secret of the server
+      error = authenticatorSetServerKey(&benchContext,
+         (const uint8_t *) BENCH_SERVER_KEY, osStrlen(BENCH_SERVER_KEY));
+   }
+
+   //Loop through the ports
+   for(i = 0; i < benchNumPorts && !error; i++)
+   {
+      //The ports are controlled by the outcome of the authentication
+      error = authenticatorSetPortControl(&benchContext, i + 1,
+         AUTHENTICATOR_PORT_MODE_AUTO);
+
+      //Each supplicant has its own MAC address
+      for(j = 0; j < benchHostsPerPort; j++)
+      {
+         benchSupplicants[i * benchHostsPerPort + j].macAddr.b[0] = 0x02;
+         benchSupplicants[i * benchHostsPerPort + j].macAddr.b[3] = (uint8_t) j;
+         benchSupplicants[i * benchHostsPerPort + j].macAddr.b[4] = 0x01;
+         benchSupplicants[i * benchHostsPerPort + j].macAddr.b[5] = (uint8_t) (i + 1);
+      }
+
+      //The link state is polled through the switch driver
+      fakeNetSetLinkState(i + 1, TRUE);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Open the sockets
+      error = authenticatorStart(&benchContext);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Compare two latency samples
+ * @param[in] a Pointer to the first sample
+ * @param[in] b Pointer to the second sample
+ * @return Comparison result
+ **/
+
+static int benchCompareSamples(const void *a, const void *b)
+{
+   uint32_t x;
+   uint32_t y;
+
+   //Retrieve the samples
+   x = *(const uint32_t *) a;
+   y = *(const uint32_t *) b;
+
+   //Compare the samples
+   return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Get a latency percentile
+ * @param[in] percentile Percentile (0 to 100)
+ * @return Latency, in microseconds
+ **/
+
+static uint32_t benchGetPercentile(uint_t percentile)
+{
+   uint_t i;
+
+   //No samples?
+   if(benchNumSamples == 0)
+      return 0;
+
+   //Nearest-rank method
+   i = (benchNumSamples * percentile + 99) / 100;
+
+   //Return the sample of that rank
+   return benchSamples[(i > 0) ? (i - 1) : 0];
+}
+
+
+/**
+ * @brief Benchmark entry point
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return Exit status
+ **/
+
+int main(int argc, char *argv[])
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t progress;
+   uint_t completed;
+   uint_t failed;
+   uint64_t time;
+   uint64_t startTime;
+   uint64_t taskTime;
+   uint64_t lastProgressTime;
+   uint64_t wallTime;
+   size_t staticMemory;
+   size_t peakMemory;
+   struct rusage usage;
+
+   //Parse the command line
+   benchNumPorts = (argc > 1) ? strtoul(argv[1], NULL, 0) : 16;
+   benchHostsPerPort = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+   benchRtt = (argc > 3) ? strtoul(argv[3], NULL, 0) : 0;
+   benchAuthsPerHost = (argc > 4) ? strtoul(argv[4], NULL, 0) : 100;
+   benchRounds = (argc > 5) ? strtoul(argv[5], NULL, 0) : 1;
+
+   //Total number of supplicants
+   benchNumSupplicants = benchNumPorts * benchHostsPerPort;
+
+   //Check parameters
+   if(benchNumPorts < 1 || benchNumPorts > BENCH_MAX_PORTS ||
+      benchNumPorts > FAKE_NET_MAX_SWITCH_PORTS || benchHostsPerPort < 1 ||
+      benchHostsPerPort > 255 || benchNumSupplicants > BENCH_MAX_SUPPLICANTS ||
+      benchAuthsPerHost < 1 || benchRounds > 255)
+   {
+      printf("Usage: %s [ports (1-%u)] [hosts_per_port] [rtt_ms] "
+         "[auths_per_host] [challenge_rounds]\r\n", argv[0], BENCH_MAX_PORTS);
+      printf("At most %u supplicants can be simulated\r\n",
+         BENCH_MAX_SUPPLICANTS);
+      return EXIT_FAILURE;
+   }
+
+   //Each supplicant must be able to have a frame in the EAPOL receive ring
+   if(benchNumSupplicants > AUTHENTICATOR_EAPOL_RX_RING_SIZE)
+   {
+      printf("The EAPOL receive ring holds %u frames. Rebuild with "
+         "AUTHENTICATOR_EAPOL_RX_RING_SIZE set to %u or more\r\n",
+         AUTHENTICATOR_EAPOL_RX_RING_SIZE, benchNumSupplicants);
+      return EXIT_FAILURE;
+   }
+
+   //Initialize the authenticator
+   error = benchSetUp();
+   //Any error to report?
+   if(error)
+   {
+      printf("Failed to initialize the authenticator (error %u)\r\n", error);
+      return EXIT_FAILURE;
+   }
+
+   //The link state is polled once per tick. Wait for every port to send
+   //its first EAP-Request/Identity
+   startTime = benchGetClock(CLOCK_MONOTONIC);
+
+   for(n = 0; n < benchNumPorts; )
+   {
+      //Run the authenticator task
+      authenticatorTask(&benchContext);
+      //Collect the EAP-Request/Identity
+      n += benchRunSupplicants(FALSE);
+
+      //The ports should be up after the first tick
+      if((benchGetClock(CLOCK_MONOTONIC) - startTime) >=
+         (uint64_t) (AUTHENTICATOR_TICK_INTERVAL + BENCH_STALL_TIMEOUT) * 1000)
+      {
+         printf("The ports failed to come up\r\n");
+         return EXIT_FAILURE;
+      }
+   }
+
+   //Start the measurement
+   startTime = benchGetClock(CLOCK_MONOTONIC);
+   lastProgressTime = startTime;
+   benchTaskCpuTime = 0;
+   benchPeakSessions = 0;
+
+   //The first supplicant of each port starts its authentication. The other
+   //ones are started once it has been bound to the port
+   for(i = 0; i < benchNumPorts; i++)
+   {
+      benchStartSupplicant(i * benchHostsPerPort);
+   }
+
+   //Run the authentications
+   for(progress = 0, taskTime = 0; ; )
+   {
+      //Get current time
+      time = benchGetClock(CLOCK_MONOTONIC);
+
+      //While waiting for the server, the task is only run once per
+      //millisecond so that idle polling does not inflate the CPU time
+      if(fakeNetGetPendingRx() > 0 || (time - taskTime) >= 1000)
+      {
+         //Let the authenticator process the pending frames and timers
+         benchRunTask();
+         taskTime = time;
+      }
+
+      //Let the supplicants and the server answer
+      benchRunSupplicants(TRUE);
+      benchRunServer();
+
+      //Count the authentications that have been run so far
+      for(completed = 0, failed = 0, i = 0; i < benchNumSupplicants; i++)
+      {
+         completed += benchSupplicants[i].completed;
+         failed += benchSupplicants[i].failed;
+      }
+
+      //Get current time
+      time = benchGetClock(CLOCK_MONOTONIC);
+
+      //All the authentications run?
+      if((completed + failed) >= (benchNumSupplicants * benchAuthsPerHost))
+         break;
+
+      //Any progress?
+      if((completed + failed) != progress)
+      {
+         progress = completed + failed;
+         lastProgressTime = time;
+      }
+      else if((time - lastProgressTime) >= (uint64_t) BENCH_STALL_TIMEOUT * 1000)
+      {
+         printf("The authentications stalled after %u runs\r\n", progress);
+         return EXIT_FAILURE;
+      }
+      else
+      {
+         //Just for sanity
+      }
+   }
+
+   //Duration of the measurement
+   wallTime = MAX(time - startTime, 1);
+
+   //The contexts handed over to the authenticator are in use for its whole
+   //lifetime
+   staticMemory = sizeof(AuthenticatorContext) + benchNumSupplicants *
+      (sizeof(AuthenticatorPort) + sizeof(AuthenticatorPortData) +
+      sizeof(AuthenticatorBuffer));
+
+   //The memory backing the session buffers is only in use while a
+   //supplicant is authenticating
+   peakMemory = staticMemory + AUTHENTICATOR_BUFFER_MEMORY_SIZE(
+      benchPeakSessions, AUTHENTICATOR_TX_BUFFER_SIZE);
+
+   //Peak resident set size of the process
+   osMemset(&usage, 0, sizeof(usage));
+   getrusage(RUSAGE_SELF, &usage);
+
+   //Sort the latency samples
+   qsort(benchSamples, benchNumSamples, sizeof(uint32_t), benchCompareSamples);
+
+   //Display the results
+   printf("ports=%u hosts_per_port=%u rtt=%ums rounds=%u\r\n", benchNumPorts,
+      benchHostsPerPort, benchRtt, benchRounds);
+   printf("  method: EAP-MD5 challenge rounds (approximation of a multi-round "
+      "method such as EAP-TLS, without TLS processing)\r\n");
+   printf("  authentications: %u succeeded, %u failed\r\n", completed, failed);
+   printf("  throughput: %.1f auths/s\r\n",
+      (double) completed * 1000000 / wallTime);
+   printf("  CPU time: %.1f us/auth\r\n",
+      (double) benchTaskCpuTime / MAX(completed + failed, 1));
+   printf("  latency: p50=%uus p90=%uus p99=%uus max=%uus\r\n",
+      benchGetPercentile(50), benchGetPercentile(90), benchGetPercentile(99),
+      benchGetPercentile(100));
+   printf("  peak RAM: %u bytes (%u bytes of contexts + %u of %u session "
+      "buffers)\r\n", (uint_t) peakMemory, (uint_t) staticMemory,
+      benchPeakSessions, benchNumSupplicants);
+   printf("  process peak RSS: %ld KiB\r\n", (long) usage.ru_maxrss);
+
+   //Release the authenticator
+   authenticatorStop(&benchContext);
+   authenticatorDeinit(&benchContext);
+
+   //Failed authentications indicate a regression
+   return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
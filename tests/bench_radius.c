@@ -0,0 +1,552 @@
+/**
+ * @file bench_radius.c
+ * @brief RADIUS encode/verify microbenchmarks
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * The per-message costs of the RADIUS path are measured in cycles:
+ * - radiusAddAttribute and radiusGetAttribute
+ * - radiusParseAttributes followed by an indexed lookup
+ * - authenticatorBuildRadiusRequest (Request Authenticator, cached NAS
+ *   attributes and Message-Authenticator)
+ * - the verification of an Access-Challenge as performed by
+ *   authenticatorProcessRadiusPacket, i.e. the attribute index followed by
+ *   the Response Authenticator and Message-Authenticator checks
+ *
+ * The last two are run for several counts of EAP-Message attributes. The
+ * cycle counter of the profiling hooks (AUTHENTICATOR_PROFILE_GET_CYCLES) is
+ * used when it is defined. On x86 hosts, the time-stamp counter is used
+ * otherwise.
+ *
+ * The benchmark is built by the bench_radius target of tests/Makefile.
+ *
+ * Usage: bench_radius [iterations]
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include <stdlib.h>
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_misc.h"
+#include "authenticator/authenticator_buffer.h"
+#include "test_net_fake.h"
+#include "test_radius_fake.h"
+
+//Cycle counter
+#if defined(AUTHENTICATOR_PROFILE_GET_CYCLES)
+   #define BENCH_GET_CYCLES() ((uint64_t) AUTHENTICATOR_PROFILE_GET_CYCLES())
+#elif defined(__x86_64__) || defined(__i386__)
+   #include <x86intrin.h>
+   #define BENCH_GET_CYCLES() ((uint64_t) __rdtsc())
+#else
+   #error AUTHENTICATOR_PROFILE_GET_CYCLES must be defined on this target
+#endif
+
+//Default number of iterations per measurement
+#define BENCH_DEFAULT_ITERATIONS 10000
+//Number of attributes of the packet searched by radiusGetAttribute
+#define BENCH_NUM_ATTRIBUTES 32
+//Maximum length of a RADIUS packet
+#define BENCH_MAX_PACKET_SIZE 4096
+//Shared secret of the RADIUS server
+#define BENCH_SERVER_KEY "testing123"
+//Identity of the supplicant
+#define BENCH_IDENTITY "bench"
+
+//Counts of EAP-Message attributes
+static const uint_t benchFragmentCounts[] = {1, 2, 4, 5};
+
+//Authenticator context
+static AuthenticatorContext benchContext;
+static AuthenticatorPort benchPorts[1];
+static AuthenticatorPortData benchPortData[1];
+static AuthenticatorBuffer benchBuffers[1];
+static uint8_t benchBufferMemory[AUTHENTICATOR_BUFFER_MEMORY_SIZE(1,
+   AUTHENTICATOR_TX_BUFFER_SIZE)];
+
+//Packet buffers
+static uint8_t benchPacket[BENCH_MAX_PACKET_SIZE];
+static uint8_t benchEapPacket[BENCH_MAX_PACKET_SIZE];
+//Copy of the Access-Request answered by the server
+static uint8_t benchRequest[BENCH_MAX_PACKET_SIZE];
+
+//State of the deterministic PRNG
+static uint32_t benchPrngState;
+//Number of iterations per measurement
+static uint_t benchIterations;
+
+
+/**
+ * @brief Generate deterministic pseudo-random data
+ * @param[in] context Pointer to the PRNG state
+ * @param[out] output Buffer where to store the data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+static error_t benchPrngGenerate(void *context, uint8_t *output, size_t length)
+{
+   uint32_t *state;
+
+   //Point to the state of the generator
+   state = (uint32_t *) context;
+
+   //Xorshift generator
+   while(length-- > 0)
+   {
+      *state ^= *state << 13;
+      *state ^= *state >> 17;
+      *state ^= *state << 5;
+      *(output++) = (uint8_t) *state;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+//Deterministic PRNG (the benchmark does not need cryptographic strength)
+static const PrngAlgo benchPrngAlgo =
+{
+   .name = "Xorshift",
+   .contextSize = sizeof(uint32_t),
+   .generate = benchPrngGenerate
+};
+
+
+/**
+ * @brief Initialize the authenticator and attach a session buffer to the port
+ * @return Error code
+ **/
+
+static error_t benchSetUp(void)
+{
+   error_t error;
+   AuthenticatorPort *port;
+   AuthenticatorSettings settings;
+
+   //Reset the fake network layer
+   fakeNetInit();
+
+   //Seed the PRNG
+   benchPrngState = 0x2545F491;
+
+   //Get default settings
+   authenticatorGetDefaultSettings(&settings);
+
+   //A single port is attached to the fake network interface
+   settings.interface = fakeNetGetInterface();
+   settings.numPorts = 1;
+   settings.ports = benchPorts;
+   settings.portData = benchPortData;
+   settings.numBuffers = 1;
+   settings.buffers = benchBuffers;
+   settings.bufferMemory = benchBufferMemory;
+   settings.serverIpAddr.length = sizeof(Ipv4Addr);
+   settings.serverIpAddr.ipv4Addr = htonl(0xC0000201);
+   settings.prngAlgo = &benchPrngAlgo;
+   settings.prngContext = &benchPrngState;
+
+   //Initialize the authenticator
+   error = authenticatorInit(&benchContext, &settings);
+
+   //Check status code
+   if(!error)
+   {
+      //Set the shared secret of the server
+      error = authenticatorSetServerKey(&benchContext,
+         (const uint8_t *) BENCH_SERVER_KEY, osStrlen(BENCH_SERVER_KEY));
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Point to the port
+      port = &benchPorts[0];
+
+      //The Access-Requests are formatted in the session buffer of the port
+      if(authenticatorAllocPortBuffer(port))
+      {
+         //The identity of the supplicant is copied in the User-Name attribute
+         osStrcpy(port->data->aaaIdentity, BENCH_IDENTITY);
+      }
+      else
+      {
+         //Report an error
+         error = ERROR_OUT_OF_RESOURCES;
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Format an EAP packet
+ * @param[in] code Code of the EAP packet
+ * @param[in] length Length of the EAP packet, in bytes
+ **/
+
+static void benchFormatEapPacket(uint8_t code, size_t length)
+{
+   //The contents of the packet are not inspected by the RADIUS path
+   osMemset(benchEapPacket, 0xA5, length);
+
+   //Format EAP header
+   benchEapPacket[0] = code;
+   benchEapPacket[1] = 1;
+   STORE16BE(length, benchEapPacket + 2);
+   benchEapPacket[4] = EAP_METHOD_TYPE_MD5_CHALLENGE;
+}
+
+
+/**
+ * @brief Display the cost of an operation
+ * @param[in] name Name of the operation
+ * @param[in] cycles Number of cycles spent
+ * @param[in] count Number of operations performed
+ **/
+
+static void benchReport(const char_t *name, uint64_t cycles, uint_t count)
+{
+   //Display the average number of cycles per operation
+   printf("  %-52s %10.1f cycles\r\n", name, (double) cycles / count);
+}
+
+
+/**
+ * @brief Measure radiusAddAttribute
+ **/
+
+static void benchAddAttribute(void)
+{
+   uint_t i;
+   uint_t j;
+   uint64_t cycles;
+   uint8_t value[16];
+   RadiusPacket *packet;
+
+   //Point to the RADIUS packet
+   packet = (RadiusPacket *) benchPacket;
+   osMemset(value, 0x5A, sizeof(value));
+
+   //Start measurement
+   cycles = BENCH_GET_CYCLES();
+
+   //Fill the packet with attributes again and again
+   for(i = 0; i < benchIterations; i++)
+   {
+      packet->length = htons(sizeof(RadiusPacket));
+
+      for(j = 0; j < BENCH_NUM_ATTRIBUTES; j++)
+      {
+         radiusAddAttribute(packet, RADIUS_ATTR_VENDOR_SPECIFIC, value,
+            sizeof(value));
+      }
+   }
+
+   //Stop measurement
+   cycles = BENCH_GET_CYCLES() - cycles;
+
+   //Display the cost of a single attribute
+   benchReport("radiusAddAttribute (16-byte value)", cycles,
+      benchIterations * BENCH_NUM_ATTRIBUTES);
+}
+
+
+/**
+ * @brief Measure radiusGetAttribute and the indexed lookups
+ **/
+
+static void benchGetAttribute(void)
+{
+   uint_t i;
+   uint_t j;
+   uint_t entry;
+   uint64_t cycles;
+   uint8_t value[16];
+   RadiusPacket *packet;
+   RadiusAttrIndex index;
+   const RadiusAttribute *attribute;
+
+   //Point to the RADIUS packet
+   packet = (RadiusPacket *) benchPacket;
+   packet->length = htons(sizeof(RadiusPacket));
+   osMemset(value, 0x5A, sizeof(value));
+
+   //The searched attribute comes last
+   for(j = 0; j < (BENCH_NUM_ATTRIBUTES - 1); j++)
+   {
+      radiusAddAttribute(packet, RADIUS_ATTR_VENDOR_SPECIFIC, value,
+         sizeof(value));
+   }
+
+   radiusAddAttribute(packet, RADIUS_ATTR_STATE, value, sizeof(value));
+
+   //Start measurement
+   cycles = BENCH_GET_CYCLES();
+
+   //Search the packet for the last attribute
+   for(attribute = NULL, i = 0; i < benchIterations; i++)
+   {
+      attribute = radiusGetAttribute(packet, RADIUS_ATTR_STATE, 0);
+   }
+
+   //Stop measurement
+   cycles = BENCH_GET_CYCLES() - cycles;
+
+   //Display the cost of the linear search
+   if(attribute != NULL)
+   {
+      benchReport("radiusGetAttribute (last of 32 attributes)", cycles,
+         benchIterations);
+   }
+
+   //Start measurement
+   cycles = BENCH_GET_CYCLES();
+
+   //Index the packet, then retrieve the last attribute
+   for(attribute = NULL, i = 0; i < benchIterations; i++)
+   {
+      if(!radiusParseAttributes(packet, &index))
+      {
+         attribute = radiusGetFirstAttribute(&index, RADIUS_ATTR_STATE, &entry);
+      }
+   }
+
+   //Stop measurement
+   cycles = BENCH_GET_CYCLES() - cycles;
+
+   //Display the cost of the indexed search
+   if(attribute != NULL)
+   {
+      benchReport("radiusParseAttributes + radiusGetFirstAttribute", cycles,
+         benchIterations);
+   }
+}
+
+
+/**
+ * @brief Measure authenticatorBuildRadiusRequest
+ * @param[in] numFragments Number of EAP-Message attributes
+ * @return Error code
+ **/
+
+static error_t benchBuildRequest(uint_t numFragments)
+{
+   error_t error;
+   uint_t i;
+   uint64_t cycles;
+   char_t name[64];
+   AuthenticatorPort *port;
+
+   //Point to the port
+   port = &benchPorts[0];
+
+   //The EAP-Response fills the EAP-Message attributes
+   benchFormatEapPacket(EAP_CODE_RESPONSE,
+      numFragments * RADIUS_MAX_ATTR_VALUE_LEN);
+
+   port->eapRespData = benchEapPacket;
+   port->eapRespDataLen = numFragments * RADIUS_MAX_ATTR_VALUE_LEN;
+
+   //The first request serializes the NAS attributes into the template
+   error = authenticatorBuildRadiusRequest(port);
+   //The request does not fit in the session buffer?
+   if(error)
+      return error;
+
+   //Start measurement
+   cycles = BENCH_GET_CYCLES();
+
+   //Build the Access-Request again and again
+   for(i = 0; i < benchIterations && !error; i++)
+   {
+      error = authenticatorBuildRadiusRequest(port);
+   }
+
+   //Stop measurement
+   cycles = BENCH_GET_CYCLES() - cycles;
+
+   //Check status code
+   if(!error)
+   {
+      //Display the cost of a single request
+      osSprintf(name, "authenticatorBuildRadiusRequest (%u x EAP-Message)",
+         numFragments);
+      benchReport(name, cycles, benchIterations);
+
+      //Keep a copy of the request for the verification benchmark
+      osMemcpy(benchRequest, port->aaaReqData, port->aaaReqDataLen);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Measure the verification of an Access-Challenge
+ * @param[in] numFragments Number of EAP-Message attributes
+ * @return Error code
+ **/
+
+static error_t benchCheckResponse(uint_t numFragments)
+{
+   error_t error;
+   uint_t i;
+   uint64_t cycles;
+   char_t name[64];
+   AuthenticatorPort *port;
+   RadiusAttrIndex index;
+
+   //Point to the port
+   port = &benchPorts[0];
+
+   //The EAP-Request fills the EAP-Message attributes
+   benchFormatEapPacket(EAP_CODE_REQUEST,
+      numFragments * RADIUS_MAX_ATTR_VALUE_LEN);
+
+   //Format the Access-Challenge the server would send
+   fakeRadiusFormatResponse(benchPacket, (const RadiusPacket *) benchRequest,
+      RADIUS_CODE_ACCESS_CHALLENGE, benchEapPacket,
+      numFragments * RADIUS_MAX_ATTR_VALUE_LEN, "state", 5, BENCH_SERVER_KEY,
+      osStrlen(BENCH_SERVER_KEY));
+
+   //Start measurement
+   cycles = BENCH_GET_CYCLES();
+
+   //Verify the Access-Challenge again and again
+   for(error = NO_ERROR, i = 0; i < benchIterations && !error; i++)
+   {
+      //Validate and index the attributes
+      error = radiusParseAttributes((const RadiusPacket *) benchPacket, &index);
+
+      //Check status code
+      if(!error)
+      {
+         //Verify the Response Authenticator and the Message-Authenticator
+         error = authenticatorCheckRadiusResponse(&benchContext,
+            &port->shard->md5Context, &benchContext.servers[port->aaaServerIndex],
+            (const RadiusPacket *) benchPacket, &index,
+            port->data->reqAuthenticator);
+      }
+   }
+
+   //Stop measurement
+   cycles = BENCH_GET_CYCLES() - cycles;
+
+   //Check status code
+   if(!error)
+   {
+      //Display the cost of a single response
+      osSprintf(name, "Access-Challenge verification (%u x EAP-Message)",
+         numFragments);
+      benchReport(name, cycles, benchIterations);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Benchmark entry point
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return Exit status
+ **/
+
+int main(int argc, char *argv[])
+{
+   error_t error;
+   uint_t i;
+
+   //Parse the command line
+   benchIterations = (argc > 1) ? strtoul(argv[1], NULL, 0) :
+      BENCH_DEFAULT_ITERATIONS;
+
+   //Check parameters
+   if(benchIterations < 1)
+   {
+      printf("Usage: %s [iterations]\r\n", argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   //Initialize the authenticator
+   error = benchSetUp();
+   //Any error to report?
+   if(error)
+   {
+      printf("Failed to initialize the authenticator (error %u)\r\n", error);
+      return EXIT_FAILURE;
+   }
+
+   //Display the results
+   printf("RADIUS encode/verify (%u iterations)\r\n", benchIterations);
+
+   //Attribute helpers
+   benchAddAttribute();
+   benchGetAttribute();
+
+   //Loop through the fragment counts
+   for(i = 0; i < arraysize(benchFragmentCounts); i++)
+   {
+      //Build an Access-Request carrying the EAP-Response
+      error = benchBuildRequest(benchFragmentCounts[i]);
+
+      //The largest requests may not fit in the session buffer
+      if(error == ERROR_BUFFER_OVERFLOW)
+      {
+         printf("  %u x EAP-Message: request exceeds AUTHENTICATOR_TX_BUFFER_SIZE\r\n",
+            benchFragmentCounts[i]);
+         break;
+      }
+
+      //Check status code
+      if(!error)
+      {
+         //Verify the answer of the server
+         error = benchCheckResponse(benchFragmentCounts[i]);
+      }
+
+      //Any error to report?
+      if(error)
+      {
+         printf("  %u x EAP-Message: failed (error %u)\r\n",
+            benchFragmentCounts[i], error);
+         return EXIT_FAILURE;
+      }
+   }
+
+   //Release the authenticator
+   authenticatorDeinit(&benchContext);
+
+   //Successful processing
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,556 @@
+/**
+ * @file test_eap_response.c
+ * @brief EAP-Response forwarding test
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * A full EAP-MD5 exchange is run through the PAE, backend and EAP full
+ * authenticator state machines, with a scripted RADIUS server on the other
+ * side of the fake network layer. The test checks that:
+ * - each EAP-Response received from the supplicant is forwarded verbatim in
+ *   the EAP-Message attributes of the Access-Request
+ * - a retransmitted EAP-Response does not start a new RADIUS transaction
+ * - the EAP requests carried by Access-Challenge packets are relayed verbatim
+ * - the port is authorized once the server accepts the supplicant
+ *
+ * The test is built together with the authenticator, EAP and RADIUS sources,
+ * test_net_fake.c (which stands in for the TCP/IP stack), test_radius_fake.c,
+ * and the OS port and MD5 implementation of the target. The authenticator
+ * task runs in the context of the test, so NET_RTOS_SUPPORT must be disabled.
+ * The test_eap_response target of tests/Makefile builds it that way, and
+ * "make check" runs it.
+ *
+ * The process exits with a non-zero status if any check fails
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include <stdlib.h>
+#include "authenticator/authenticator.h"
+#include "radius/radius_attributes.h"
+#include "test_net_fake.h"
+#include "test_radius_fake.h"
+
+//Port under test
+#define TEST_PORT_INDEX 1
+//Number of iterations of the authenticator task run per step
+#define TEST_TASK_ITERATIONS 4
+//Shared secret of the RADIUS server
+#define TEST_SERVER_KEY "testing123"
+//Identity of the supplicant
+#define TEST_IDENTITY "alice"
+
+//Check a condition and record the failure
+#define TEST_CHECK(cond) \
+   do \
+   { \
+      if(!(cond)) \
+      { \
+         printf("  %s:%d: check failed: %s\r\n", __FILE__, __LINE__, #cond); \
+         testFailures++; \
+      } \
+   } while(0)
+
+//Authenticator context
+static AuthenticatorContext authContext;
+static AuthenticatorPort authPorts[1];
+static AuthenticatorPortData authPortData[1];
+static AuthenticatorBuffer authBuffers[1];
+static uint8_t authBufferMemory[AUTHENTICATOR_BUFFER_MEMORY_SIZE(1,
+   AUTHENTICATOR_TX_BUFFER_SIZE)];
+
+//MAC address of the supplicant
+static const MacAddr testSupplicantMacAddr = {{{0x02, 0x00, 0x00, 0x00, 0x00, 0x10}}};
+//IP address of the RADIUS server
+static IpAddr testServerIpAddr;
+//State of the deterministic PRNG
+static uint32_t testPrngState;
+//Number of failed checks
+static uint_t testFailures;
+
+//Last Access-Request sent by the authenticator
+static FakeNetMsg testRequest;
+//Last EAPOL PDU sent by the authenticator
+static FakeNetMsg testEapolPdu;
+
+
+/**
+ * @brief Generate deterministic pseudo-random data
+ * @param[in] context Pointer to the PRNG state
+ * @param[out] output Buffer where to store the data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+static error_t testPrngGenerate(void *context, uint8_t *output, size_t length)
+{
+   uint32_t *state;
+
+   //Point to the state of the generator
+   state = (uint32_t *) context;
+
+   //Xorshift generator
+   while(length-- > 0)
+   {
+      *state ^= *state << 13;
+      *state ^= *state >> 17;
+      *state ^= *state << 5;
+      *(output++) = (uint8_t) *state;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+//Deterministic PRNG (the test does not need cryptographic strength)
+static const PrngAlgo testPrngAlgo =
+{
+   .name = "Xorshift",
+   .contextSize = sizeof(uint32_t),
+   .generate = testPrngGenerate
+};
+
+
+/**
+ * @brief Run the authenticator task
+ **/
+
+static void testRunTask(void)
+{
+   uint_t i;
+
+   //The task processes the queued frames and returns
+   for(i = 0; i < TEST_TASK_ITERATIONS; i++)
+   {
+      authenticatorTask(&authContext);
+   }
+}
+
+
+/**
+ * @brief Send an EAP-Response on behalf of the supplicant
+ * @param[in] identifier Identifier of the EAP packet
+ * @param[in] type Method type
+ * @param[in] data Type-Data field
+ * @param[in] length Length of the Type-Data field, in bytes
+ * @param[out] packet Copy of the EAP-Response (optional parameter)
+ * @return Length of the EAP-Response, in bytes
+ **/
+
+static size_t testSendEapResponse(uint8_t identifier, uint8_t type,
+   const void *data, size_t length, uint8_t *packet)
+{
+   size_t n;
+   uint8_t buffer[128];
+   EapolPdu *pdu;
+   EapResponse *response;
+
+   //Length of the EAP-Response
+   n = sizeof(EapResponse) + length;
+
+   //Format EAPOL header
+   pdu = (EapolPdu *) buffer;
+   pdu->protocolVersion = EAPOL_VERSION_2;
+   pdu->packetType = EAPOL_TYPE_EAP;
+   pdu->packetBodyLen = htons(n);
+
+   //Format EAP-Response
+   response = (EapResponse *) pdu->packetBody;
+   response->code = EAP_CODE_RESPONSE;
+   response->identifier = identifier;
+   response->length = htons(n);
+   response->type = type;
+   osMemcpy(response->data, data, length);
+
+   //Save a copy of the response
+   if(packet != NULL)
+   {
+      osMemcpy(packet, response, n);
+   }
+
+   //The PDU is received on the port under test
+   fakeNetInjectEapol(TEST_PORT_INDEX, &testSupplicantMacAddr, buffer,
+      sizeof(EapolPdu) + n);
+
+   //Return the length of the EAP-Response
+   return n;
+}
+
+
+/**
+ * @brief Answer the last Access-Request on behalf of the RADIUS server
+ * @param[in] code Code of the response
+ * @param[in] eapPacket EAP packet to be carried by the response
+ * @param[in] eapPacketLen Length of the EAP packet, in bytes
+ * @param[in] state Value of the State attribute (optional parameter)
+ **/
+
+static void testSendRadiusResponse(uint8_t code, const void *eapPacket,
+   size_t eapPacketLen, const char_t *state)
+{
+   size_t n;
+   uint8_t buffer[512];
+
+   //Format and sign the response
+   n = fakeRadiusFormatResponse(buffer, (const RadiusPacket *) testRequest.data,
+      code, eapPacket, eapPacketLen, state, (state != NULL) ? osStrlen(state) : 0,
+      TEST_SERVER_KEY, osStrlen(TEST_SERVER_KEY));
+
+   //The response is received on the socket the request was sent from
+   fakeNetInjectDatagram(testRequest.socket, &testServerIpAddr, RADIUS_PORT,
+      buffer, n);
+}
+
+
+/**
+ * @brief Retrieve the EAP packet sent to the supplicant
+ * @param[in] code Expected code
+ * @param[in] identifier Expected identifier
+ * @return Pointer to the EAP packet, or NULL if no such packet has been sent
+ **/
+
+static const EapPacket *testGetEapPacket(uint8_t code, uint8_t identifier)
+{
+   const EapolPdu *pdu;
+   const EapPacket *packet;
+
+   //Retrieve the oldest PDU sent by the authenticator
+   if(!fakeNetGetEapol(&testEapolPdu))
+      return NULL;
+
+   //Point to the EAPOL PDU
+   pdu = (const EapolPdu *) testEapolPdu.data;
+
+   //The PDU must carry an EAP packet
+   if(testEapolPdu.length < (sizeof(EapolPdu) + sizeof(EapPacket)) ||
+      pdu->packetType != EAPOL_TYPE_EAP)
+   {
+      return NULL;
+   }
+
+   //Point to the EAP packet
+   packet = (const EapPacket *) pdu->packetBody;
+
+   //Check the code and the identifier of the packet
+   if(packet->code != code || packet->identifier != identifier)
+      return NULL;
+
+   //The PDU must be sent to the supplicant port
+   if(testEapolPdu.switchPort != TEST_PORT_INDEX)
+      return NULL;
+
+   //Return a pointer to the EAP packet
+   return packet;
+}
+
+
+/**
+ * @brief Retrieve the Access-Request sent to the server
+ * @return Pointer to the Access-Request, or NULL if no such packet has been
+ *   sent
+ **/
+
+static const RadiusPacket *testGetAccessRequest(void)
+{
+   const RadiusPacket *packet;
+
+   //Retrieve the oldest datagram sent by the authenticator
+   if(!fakeNetGetDatagram(&testRequest))
+      return NULL;
+
+   //Point to the RADIUS packet
+   packet = (const RadiusPacket *) testRequest.data;
+
+   //Check the length and the code of the packet
+   if(testRequest.length < sizeof(RadiusPacket) ||
+      ntohs(packet->length) != testRequest.length ||
+      packet->code != RADIUS_CODE_ACCESS_REQUEST)
+   {
+      return NULL;
+   }
+
+   //The request must be sent to the configured server
+   if(!ipCompAddr(&testRequest.ipAddr, &testServerIpAddr) ||
+      testRequest.port != RADIUS_PORT)
+   {
+      return NULL;
+   }
+
+   //Return a pointer to the Access-Request
+   return packet;
+}
+
+
+/**
+ * @brief Initialize the authenticator and bring the port up
+ * @return Error code
+ **/
+
+static error_t testSetUp(void)
+{
+   error_t error;
+   AuthenticatorSettings settings;
+
+   //Reset the fake network layer
+   fakeNetInit();
+
+   //The server is reached through IPv4
+   osMemset(&testServerIpAddr, 0, sizeof(IpAddr));
+   testServerIpAddr.length = sizeof(Ipv4Addr);
+   testServerIpAddr.ipv4Addr = htonl(0xC0000201);
+
+   //Seed the PRNG
+   testPrngState = 0x2545F491;
+
+   //Get default settings
+   authenticatorGetDefaultSettings(&settings);
+
+   //A single port is attached to the fake network interface
+   settings.interface = fakeNetGetInterface();
+   settings.numPorts = 1;
+   settings.ports = authPorts;
+   settings.portData = authPortData;
+   settings.numBuffers = 1;
+   settings.buffers = authBuffers;
+   settings.bufferMemory = authBufferMemory;
+   settings.serverIpAddr = testServerIpAddr;
+   settings.prngAlgo = &testPrngAlgo;
+   settings.prngContext = &testPrngState;
+   //The link state changes are reported by the test
+   settings.linkChangeNotification = TRUE;
+
+   //Initialize the authenticator
+   error = authenticatorInit(&authContext, &settings);
+
+   //Check status code
+   if(!error)
+   {
+      //Set the shared secret of the server
+      error = authenticatorSetServerKey(&authContext,
+         (const uint8_t *) TEST_SERVER_KEY, osStrlen(TEST_SERVER_KEY));
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //The port is controlled by the outcome of the authentication
+      error = authenticatorSetPortControl(&authContext, TEST_PORT_INDEX,
+         AUTHENTICATOR_PORT_MODE_AUTO);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Open the sockets
+      error = authenticatorStart(&authContext);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Bring the port up
+      error = authenticatorSetLinkState(&authContext, TEST_PORT_INDEX, TRUE);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Release the authenticator
+ **/
+
+static void testTearDown(void)
+{
+   //Close the sockets
+   authenticatorStop(&authContext);
+   //Release resources
+   authenticatorDeinit(&authContext);
+}
+
+
+/**
+ * @brief Run an EAP-MD5 exchange
+ **/
+
+static void testEapMd5Exchange(void)
+{
+   size_t n;
+   size_t length;
+   uint8_t md5Value[17];
+   uint8_t response[128];
+   uint8_t buffer[512];
+   uint8_t challenge[24];
+   const EapPacket *eapPacket;
+   const RadiusPacket *request;
+   const RadiusAttribute *attribute;
+   AuthenticatorPortStatus portStatus;
+
+   //The link up event starts the authentication with an EAP-Request/Identity
+   testRunTask();
+   eapPacket = testGetEapPacket(EAP_CODE_REQUEST, 0);
+   TEST_CHECK(eapPacket != NULL);
+
+   //The supplicant answers with its identity
+   length = testSendEapResponse(0, EAP_METHOD_TYPE_IDENTITY, TEST_IDENTITY,
+      osStrlen(TEST_IDENTITY), response);
+   testRunTask();
+
+   //The response must be forwarded verbatim to the server
+   request = testGetAccessRequest();
+   TEST_CHECK(request != NULL);
+
+   //Valid Access-Request?
+   if(request != NULL)
+   {
+      //Check the EAP-Message attributes
+      n = fakeRadiusGetEapMessage(request, buffer, sizeof(buffer));
+      TEST_CHECK(n == length && osMemcmp(buffer, response, n) == 0);
+
+      //The User-Name attribute is copied from the EAP-Response/Identity
+      attribute = radiusGetAttribute(request, RADIUS_ATTR_USER_NAME, 0);
+      TEST_CHECK(attribute != NULL && attribute->length ==
+         (sizeof(RadiusAttribute) + osStrlen(TEST_IDENTITY)) &&
+         osMemcmp(attribute->value, TEST_IDENTITY,
+         osStrlen(TEST_IDENTITY)) == 0);
+
+      //The Access-Request must be protected by a Message-Authenticator
+      attribute = radiusGetAttribute(request,
+         RADIUS_ATTR_MESSAGE_AUTHENTICATOR, 0);
+      TEST_CHECK(attribute != NULL);
+   }
+
+   //The supplicant retransmits its response before the server answers
+   testSendEapResponse(0, EAP_METHOD_TYPE_IDENTITY, TEST_IDENTITY,
+      osStrlen(TEST_IDENTITY), NULL);
+   testRunTask();
+
+   //The retransmission must not start a new RADIUS transaction
+   TEST_CHECK(fakeNetGetPendingDatagrams() == 0);
+   TEST_CHECK(authPortData[0].stats.dupEapRespFramesRx == 1);
+
+   //The server challenges the supplicant with EAP-MD5
+   challenge[0] = EAP_CODE_REQUEST;
+   challenge[1] = 1;
+   challenge[2] = 0;
+   challenge[3] = 0;
+   challenge[4] = EAP_METHOD_TYPE_MD5_CHALLENGE;
+   challenge[5] = 16;
+   osMemset(challenge + 6, 0xA5, 16);
+   challenge[22] = 'S';
+   challenge[23] = 'V';
+   STORE16BE(sizeof(challenge), challenge + 2);
+
+   //Send Access-Challenge
+   testSendRadiusResponse(RADIUS_CODE_ACCESS_CHALLENGE, challenge,
+      sizeof(challenge), "state-1");
+   testRunTask();
+
+   //The EAP request must be relayed verbatim to the supplicant
+   eapPacket = testGetEapPacket(EAP_CODE_REQUEST, 1);
+   TEST_CHECK(eapPacket != NULL && ntohs(eapPacket->length) ==
+      sizeof(challenge) && osMemcmp(eapPacket, challenge,
+      sizeof(challenge)) == 0);
+
+   //The supplicant answers the challenge
+   md5Value[0] = 16;
+   osMemset(md5Value + 1, 0x5A, 16);
+   length = testSendEapResponse(1, EAP_METHOD_TYPE_MD5_CHALLENGE, md5Value,
+      sizeof(md5Value), response);
+   testRunTask();
+
+   //The response must be forwarded verbatim to the server
+   request = testGetAccessRequest();
+   TEST_CHECK(request != NULL);
+
+   //Valid Access-Request?
+   if(request != NULL)
+   {
+      //Check the EAP-Message attributes
+      n = fakeRadiusGetEapMessage(request, buffer, sizeof(buffer));
+      TEST_CHECK(n == length && osMemcmp(buffer, response, n) == 0);
+
+      //The State attribute must be echoed
+      attribute = radiusGetAttribute(request, RADIUS_ATTR_STATE, 0);
+      TEST_CHECK(attribute != NULL && attribute->length ==
+         (sizeof(RadiusAttribute) + 7) &&
+         osMemcmp(attribute->value, "state-1", 7) == 0);
+   }
+
+   //The server accepts the supplicant
+   buffer[0] = EAP_CODE_SUCCESS;
+   buffer[1] = 1;
+   STORE16BE(sizeof(EapPacket), buffer + 2);
+
+   //Send Access-Accept
+   testSendRadiusResponse(RADIUS_CODE_ACCESS_ACCEPT, buffer, sizeof(EapPacket),
+      NULL);
+   testRunTask();
+
+   //The EAP-Success must be relayed to the supplicant
+   eapPacket = testGetEapPacket(EAP_CODE_SUCCESS, 1);
+   TEST_CHECK(eapPacket != NULL);
+
+   //The port must be authorized
+   TEST_CHECK(authenticatorGetPortStatus(&authContext, TEST_PORT_INDEX,
+      &portStatus) == NO_ERROR);
+   TEST_CHECK(portStatus == AUTHENTICATOR_PORT_STATUS_AUTH);
+}
+
+
+/**
+ * @brief Test entry point
+ * @return Exit status
+ **/
+
+int main(void)
+{
+   error_t error;
+
+   //Initialize the authenticator
+   error = testSetUp();
+   TEST_CHECK(error == NO_ERROR);
+
+   //Successful initialization?
+   if(!error)
+   {
+      //Run the exchange
+      testEapMd5Exchange();
+   }
+
+   //Release the authenticator
+   testTearDown();
+
+   //Display the outcome of the test
+   printf("%s: %u failed check(s)\r\n", testFailures ? "FAIL" : "PASS",
+      testFailures);
+
+   //Return exit status
+   return (testFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
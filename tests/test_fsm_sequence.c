@@ -0,0 +1,719 @@
+/**
+ * @file test_fsm_sequence.c
+ * @brief State transition sequences of the authenticator state machines
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * The authenticator PAE, backend authentication, reauthentication timer and
+ * EAP full authenticator state machines are evaluated from transition
+ * tables. This test runs the main authentication paths against the fake
+ * network layer and compares the state transitions recorded in the trace
+ * ring of the port with the sequences produced by the switch-based state
+ * machines the tables replaced:
+ * - EAP-MD5 authentication accepted by the server
+ * - Authentication rejected by the server
+ * - Supplicant logoff once the port has been authorized
+ *
+ * The test_fsm_sequence target of tests/Makefile builds it, and
+ * "make check" runs it. The process exits with a non-zero status if any
+ * check fails
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include <stdlib.h>
+#include "authenticator/authenticator.h"
+#include "authenticator/authenticator_pae_fsm.h"
+#include "authenticator/authenticator_backend_fsm.h"
+#include "authenticator/authenticator_reauth_timer_fsm.h"
+#include "eap/eap_full_auth_fsm.h"
+#include "test_net_fake.h"
+#include "test_radius_fake.h"
+
+//Port under test
+#define TEST_PORT_INDEX 1
+//Number of iterations of the authenticator task run per step
+#define TEST_TASK_ITERATIONS 4
+//Shared secret of the RADIUS server
+#define TEST_SERVER_KEY "testing123"
+//Identity of the supplicant
+#define TEST_IDENTITY "alice"
+//Maximum number of records read from the trace ring
+#define TEST_MAX_RECORDS AUTHENTICATOR_TRACE_RING_SIZE
+
+//Check a condition and record the failure
+#define TEST_CHECK(cond) \
+   do \
+   { \
+      if(!(cond)) \
+      { \
+         printf("  %s:%d: check failed: %s\r\n", __FILE__, __LINE__, #cond); \
+         testFailures++; \
+      } \
+   } while(0)
+
+//Transitions of the state machines
+#define PAE(from, to) {AUTHENTICATOR_TRACE_EVENT_PAE_STATE, \
+   AUTHENTICATOR_PAE_STATE_##from, AUTHENTICATOR_PAE_STATE_##to}
+#define BACKEND(from, to) {AUTHENTICATOR_TRACE_EVENT_BACKEND_STATE, \
+   AUTHENTICATOR_BACKEND_STATE_##from, AUTHENTICATOR_BACKEND_STATE_##to}
+#define REAUTH(from, to) {AUTHENTICATOR_TRACE_EVENT_REAUTH_TIMER_STATE, \
+   AUTHENTICATOR_REAUTH_TIMER_STATE_##from, AUTHENTICATOR_REAUTH_TIMER_STATE_##to}
+#define EAP(from, to) {AUTHENTICATOR_TRACE_EVENT_EAP_FULL_AUTH_STATE, \
+   EAP_FULL_AUTH_STATE_##from, EAP_FULL_AUTH_STATE_##to}
+
+
+/**
+ * @brief State transition
+ **/
+
+typedef struct
+{
+   uint8_t event;     ///<State machine (trace event)
+   uint8_t fromState; ///<Previous state
+   uint8_t toState;   ///<New state
+} TestTransition;
+
+
+/**
+ * @brief Authentication path
+ **/
+
+typedef struct
+{
+   const char_t *name;                 ///<Description of the path
+   void (*run)(void);                  ///<Function that drives the path
+   const TestTransition *transitions;  ///<Expected state transitions
+   uint_t numTransitions;              ///<Number of expected transitions
+} TestPath;
+
+
+//Authenticator context
+static AuthenticatorContext authContext;
+static AuthenticatorPort authPorts[1];
+static AuthenticatorPortData authPortData[1];
+static AuthenticatorBuffer authBuffers[1];
+static uint8_t authBufferMemory[AUTHENTICATOR_BUFFER_MEMORY_SIZE(1,
+   AUTHENTICATOR_TX_BUFFER_SIZE)];
+
+//MAC address of the supplicant
+static const MacAddr testSupplicantMacAddr = {{{0x02, 0x00, 0x00, 0x00, 0x00, 0x10}}};
+//IP address of the RADIUS server
+static IpAddr testServerIpAddr;
+//State of the deterministic PRNG
+static uint32_t testPrngState;
+//Number of failed checks
+static uint_t testFailures;
+
+//Last Access-Request sent by the authenticator
+static FakeNetMsg testRequest;
+
+//EAP-MD5 authentication accepted by the server
+static const TestTransition testSuccessTransitions[] =
+{
+   PAE(INITIALIZE, DISCONNECTED),
+   BACKEND(INITIALIZE, IDLE),
+   EAP(DISABLED, INITIALIZE),
+   PAE(DISCONNECTED, RESTART),
+   PAE(RESTART, CONNECTING),
+   EAP(INITIALIZE, SELECT_ACTION),
+   EAP(SELECT_ACTION, PROPOSE_METHOD),
+   EAP(PROPOSE_METHOD, METHOD_REQUEST),
+   EAP(METHOD_REQUEST, SEND_REQUEST),
+   PAE(CONNECTING, AUTHENTICATING),
+   BACKEND(IDLE, REQUEST),
+   EAP(SEND_REQUEST, IDLE),
+   BACKEND(REQUEST, RESPONSE),
+   EAP(IDLE, RECEIVED),
+   EAP(RECEIVED, INTEGRITY_CHECK),
+   EAP(INTEGRITY_CHECK, METHOD_RESPONSE),
+   EAP(METHOD_RESPONSE, SELECT_ACTION),
+   EAP(SELECT_ACTION, INITIALIZE_PASSTHROUGH),
+   EAP(INITIALIZE_PASSTHROUGH, AAA_REQUEST),
+   EAP(AAA_REQUEST, AAA_IDLE),
+   EAP(AAA_IDLE, AAA_RESPONSE),
+   EAP(AAA_RESPONSE, SEND_REQUEST2),
+   BACKEND(RESPONSE, REQUEST),
+   EAP(SEND_REQUEST2, IDLE2),
+   BACKEND(REQUEST, RESPONSE),
+   EAP(IDLE2, RECEIVED2),
+   EAP(RECEIVED2, AAA_REQUEST),
+   EAP(AAA_REQUEST, AAA_IDLE),
+   EAP(AAA_IDLE, SUCCESS2),
+   BACKEND(RESPONSE, SUCCESS),
+   PAE(AUTHENTICATING, AUTHENTICATED),
+   BACKEND(SUCCESS, IDLE)
+};
+
+//Authentication rejected by the server
+static const TestTransition testRejectTransitions[] =
+{
+   PAE(INITIALIZE, DISCONNECTED),
+   BACKEND(INITIALIZE, IDLE),
+   EAP(DISABLED, INITIALIZE),
+   PAE(DISCONNECTED, RESTART),
+   PAE(RESTART, CONNECTING),
+   EAP(INITIALIZE, SELECT_ACTION),
+   EAP(SELECT_ACTION, PROPOSE_METHOD),
+   EAP(PROPOSE_METHOD, METHOD_REQUEST),
+   EAP(METHOD_REQUEST, SEND_REQUEST),
+   PAE(CONNECTING, AUTHENTICATING),
+   BACKEND(IDLE, REQUEST),
+   EAP(SEND_REQUEST, IDLE),
+   BACKEND(REQUEST, RESPONSE),
+   EAP(IDLE, RECEIVED),
+   EAP(RECEIVED, INTEGRITY_CHECK),
+   EAP(INTEGRITY_CHECK, METHOD_RESPONSE),
+   EAP(METHOD_RESPONSE, SELECT_ACTION),
+   EAP(SELECT_ACTION, INITIALIZE_PASSTHROUGH),
+   EAP(INITIALIZE_PASSTHROUGH, AAA_REQUEST),
+   EAP(AAA_REQUEST, AAA_IDLE),
+   EAP(AAA_IDLE, FAILURE2),
+   BACKEND(RESPONSE, FAIL),
+   PAE(AUTHENTICATING, HELD),
+   BACKEND(FAIL, IDLE)
+};
+
+//Supplicant logoff once the port has been authorized
+static const TestTransition testLogoffTransitions[] =
+{
+   PAE(INITIALIZE, DISCONNECTED),
+   BACKEND(INITIALIZE, IDLE),
+   EAP(DISABLED, INITIALIZE),
+   PAE(DISCONNECTED, RESTART),
+   PAE(RESTART, CONNECTING),
+   EAP(INITIALIZE, SELECT_ACTION),
+   EAP(SELECT_ACTION, PROPOSE_METHOD),
+   EAP(PROPOSE_METHOD, METHOD_REQUEST),
+   EAP(METHOD_REQUEST, SEND_REQUEST),
+   PAE(CONNECTING, AUTHENTICATING),
+   BACKEND(IDLE, REQUEST),
+   EAP(SEND_REQUEST, IDLE),
+   BACKEND(REQUEST, RESPONSE),
+   EAP(IDLE, RECEIVED),
+   EAP(RECEIVED, INTEGRITY_CHECK),
+   EAP(INTEGRITY_CHECK, METHOD_RESPONSE),
+   EAP(METHOD_RESPONSE, SELECT_ACTION),
+   EAP(SELECT_ACTION, INITIALIZE_PASSTHROUGH),
+   EAP(INITIALIZE_PASSTHROUGH, AAA_REQUEST),
+   EAP(AAA_REQUEST, AAA_IDLE),
+   EAP(AAA_IDLE, AAA_RESPONSE),
+   EAP(AAA_RESPONSE, SEND_REQUEST2),
+   BACKEND(RESPONSE, REQUEST),
+   EAP(SEND_REQUEST2, IDLE2),
+   BACKEND(REQUEST, RESPONSE),
+   EAP(IDLE2, RECEIVED2),
+   EAP(RECEIVED2, AAA_REQUEST),
+   EAP(AAA_REQUEST, AAA_IDLE),
+   EAP(AAA_IDLE, SUCCESS2),
+   BACKEND(RESPONSE, SUCCESS),
+   PAE(AUTHENTICATING, AUTHENTICATED),
+   BACKEND(SUCCESS, IDLE),
+   PAE(AUTHENTICATED, DISCONNECTED),
+   PAE(DISCONNECTED, RESTART),
+   EAP(SUCCESS2, INITIALIZE),
+   PAE(RESTART, CONNECTING),
+   EAP(INITIALIZE, SELECT_ACTION),
+   EAP(SELECT_ACTION, PROPOSE_METHOD),
+   EAP(PROPOSE_METHOD, METHOD_REQUEST),
+   EAP(METHOD_REQUEST, SEND_REQUEST),
+   PAE(CONNECTING, AUTHENTICATING),
+   BACKEND(IDLE, REQUEST),
+   EAP(SEND_REQUEST, IDLE)
+};
+
+
+/**
+ * @brief Generate deterministic pseudo-random data
+ * @param[in] context Pointer to the PRNG state
+ * @param[out] output Buffer where to store the data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+static error_t testPrngGenerate(void *context, uint8_t *output, size_t length)
+{
+   uint32_t *state;
+
+   //Point to the state of the generator
+   state = (uint32_t *) context;
+
+   //Xorshift generator
+   while(length-- > 0)
+   {
+      *state ^= *state << 13;
+      *state ^= *state >> 17;
+      *state ^= *state << 5;
+      *(output++) = (uint8_t) *state;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+//Deterministic PRNG (the test does not need cryptographic strength)
+static const PrngAlgo testPrngAlgo =
+{
+   .name = "Xorshift",
+   .contextSize = sizeof(uint32_t),
+   .generate = testPrngGenerate
+};
+
+
+/**
+ * @brief Run the authenticator task
+ **/
+
+static void testRunTask(void)
+{
+   uint_t i;
+
+   //The task processes the queued frames and returns
+   for(i = 0; i < TEST_TASK_ITERATIONS; i++)
+   {
+      authenticatorTask(&authContext);
+   }
+}
+
+
+/**
+ * @brief Send an EAPOL PDU on behalf of the supplicant
+ * @param[in] packetType EAPOL packet type
+ * @param[in] body Packet body
+ * @param[in] length Length of the packet body, in bytes
+ **/
+
+static void testSendEapolPdu(uint8_t packetType, const void *body,
+   size_t length)
+{
+   uint8_t buffer[128];
+   EapolPdu *pdu;
+
+   //Format EAPOL header
+   pdu = (EapolPdu *) buffer;
+   pdu->protocolVersion = EAPOL_VERSION_2;
+   pdu->packetType = packetType;
+   pdu->packetBodyLen = htons(length);
+
+   //Copy the packet body
+   osMemcpy(pdu->packetBody, body, length);
+
+   //The PDU is received on the port under test
+   fakeNetInjectEapol(TEST_PORT_INDEX, &testSupplicantMacAddr, buffer,
+      sizeof(EapolPdu) + length);
+
+   //Process the PDU
+   testRunTask();
+}
+
+
+/**
+ * @brief Send an EAP-Response on behalf of the supplicant
+ * @param[in] identifier Identifier of the EAP packet
+ * @param[in] type Method type
+ * @param[in] data Type-Data field
+ * @param[in] length Length of the Type-Data field, in bytes
+ **/
+
+static void testSendEapResponse(uint8_t identifier, uint8_t type,
+   const void *data, size_t length)
+{
+   size_t n;
+   uint8_t buffer[128];
+   EapResponse *response;
+
+   //Length of the EAP-Response
+   n = sizeof(EapResponse) + length;
+
+   //Format EAP-Response
+   response = (EapResponse *) buffer;
+   response->code = EAP_CODE_RESPONSE;
+   response->identifier = identifier;
+   response->length = htons(n);
+   response->type = type;
+   osMemcpy(response->data, data, length);
+
+   //Send EAPOL-EAP frame
+   testSendEapolPdu(EAPOL_TYPE_EAP, buffer, n);
+}
+
+
+/**
+ * @brief Answer the last Access-Request on behalf of the RADIUS server
+ * @param[in] code Code of the response
+ * @param[in] eapPacket EAP packet to be carried by the response
+ * @param[in] eapPacketLen Length of the EAP packet, in bytes
+ * @param[in] state Value of the State attribute (optional parameter)
+ **/
+
+static void testSendRadiusResponse(uint8_t code, const void *eapPacket,
+   size_t eapPacketLen, const char_t *state)
+{
+   size_t n;
+   uint8_t buffer[512];
+
+   //Retrieve the Access-Request to answer
+   TEST_CHECK(fakeNetGetDatagram(&testRequest));
+
+   //Format and sign the response
+   n = fakeRadiusFormatResponse(buffer, (const RadiusPacket *) testRequest.data,
+      code, eapPacket, eapPacketLen, state, (state != NULL) ? osStrlen(state) : 0,
+      TEST_SERVER_KEY, osStrlen(TEST_SERVER_KEY));
+
+   //The response is received on the socket the request was sent from
+   fakeNetInjectDatagram(testRequest.socket, &testServerIpAddr, RADIUS_PORT,
+      buffer, n);
+
+   //Process the response
+   testRunTask();
+}
+
+
+/**
+ * @brief Send an EAP packet with no Type-Data field on behalf of the server
+ * @param[in] radiusCode Code of the RADIUS response
+ * @param[in] eapCode Code of the EAP packet
+ * @param[in] identifier Identifier of the EAP packet
+ **/
+
+static void testSendRadiusResult(uint8_t radiusCode, uint8_t eapCode,
+   uint8_t identifier)
+{
+   uint8_t buffer[sizeof(EapPacket)];
+
+   //Format EAP-Success or EAP-Failure packet
+   buffer[0] = eapCode;
+   buffer[1] = identifier;
+   STORE16BE(sizeof(EapPacket), buffer + 2);
+
+   //Send Access-Accept or Access-Reject
+   testSendRadiusResponse(radiusCode, buffer, sizeof(EapPacket), NULL);
+}
+
+
+/**
+ * @brief Run an EAP-MD5 authentication accepted by the server
+ **/
+
+static void testRunSuccess(void)
+{
+   uint8_t md5Value[17];
+   uint8_t challenge[24];
+
+   //The supplicant answers the EAP-Request/Identity sent on link up
+   testSendEapResponse(0, EAP_METHOD_TYPE_IDENTITY, TEST_IDENTITY,
+      osStrlen(TEST_IDENTITY));
+
+   //Format EAP-MD5 challenge
+   challenge[0] = EAP_CODE_REQUEST;
+   challenge[1] = 1;
+   STORE16BE(sizeof(challenge), challenge + 2);
+   challenge[4] = EAP_METHOD_TYPE_MD5_CHALLENGE;
+   challenge[5] = 16;
+   osMemset(challenge + 6, 0xA5, 16);
+   challenge[22] = 'S';
+   challenge[23] = 'V';
+
+   //The server challenges the supplicant
+   testSendRadiusResponse(RADIUS_CODE_ACCESS_CHALLENGE, challenge,
+      sizeof(challenge), "state-1");
+
+   //The supplicant answers the challenge
+   md5Value[0] = 16;
+   osMemset(md5Value + 1, 0x5A, 16);
+   testSendEapResponse(1, EAP_METHOD_TYPE_MD5_CHALLENGE, md5Value,
+      sizeof(md5Value));
+
+   //The server accepts the supplicant
+   testSendRadiusResult(RADIUS_CODE_ACCESS_ACCEPT, EAP_CODE_SUCCESS, 1);
+}
+
+
+/**
+ * @brief Run an authentication rejected by the server
+ **/
+
+static void testRunReject(void)
+{
+   //The supplicant answers the EAP-Request/Identity sent on link up
+   testSendEapResponse(0, EAP_METHOD_TYPE_IDENTITY, TEST_IDENTITY,
+      osStrlen(TEST_IDENTITY));
+
+   //The server rejects the supplicant
+   testSendRadiusResult(RADIUS_CODE_ACCESS_REJECT, EAP_CODE_FAILURE, 0);
+}
+
+
+/**
+ * @brief Log the supplicant off once the port has been authorized
+ **/
+
+static void testRunLogoff(void)
+{
+   //Authenticate the supplicant
+   testRunSuccess();
+
+   //The supplicant logs off
+   testSendEapolPdu(EAPOL_TYPE_LOGOFF, NULL, 0);
+}
+
+
+//Authentication paths
+static const TestPath testPaths[] =
+{
+   {"EAP-MD5 success", testRunSuccess, testSuccessTransitions,
+      arraysize(testSuccessTransitions)},
+   {"Access-Reject", testRunReject, testRejectTransitions,
+      arraysize(testRejectTransitions)},
+   {"EAPOL-Logoff", testRunLogoff, testLogoffTransitions,
+      arraysize(testLogoffTransitions)}
+};
+
+
+/**
+ * @brief Initialize the authenticator and bring the port up
+ * @return Error code
+ **/
+
+static error_t testSetUp(void)
+{
+   error_t error;
+   AuthenticatorSettings settings;
+
+   //Reset the fake network layer
+   fakeNetInit();
+
+   //The server is reached through IPv4
+   osMemset(&testServerIpAddr, 0, sizeof(IpAddr));
+   testServerIpAddr.length = sizeof(Ipv4Addr);
+   testServerIpAddr.ipv4Addr = htonl(0xC0000201);
+
+   //Seed the PRNG
+   testPrngState = 0x2545F491;
+
+   //Get default settings
+   authenticatorGetDefaultSettings(&settings);
+
+   //A single port is attached to the fake network interface
+   settings.interface = fakeNetGetInterface();
+   settings.numPorts = 1;
+   settings.ports = authPorts;
+   settings.portData = authPortData;
+   settings.numBuffers = 1;
+   settings.buffers = authBuffers;
+   settings.bufferMemory = authBufferMemory;
+   settings.serverIpAddr = testServerIpAddr;
+   settings.prngAlgo = &testPrngAlgo;
+   settings.prngContext = &testPrngState;
+   //The link state changes are reported by the test
+   settings.linkChangeNotification = TRUE;
+
+   //Initialize the authenticator
+   error = authenticatorInit(&authContext, &settings);
+
+   //Check status code
+   if(!error)
+   {
+      //Set the shared secret of the server
+      error = authenticatorSetServerKey(&authContext,
+         (const uint8_t *) TEST_SERVER_KEY, osStrlen(TEST_SERVER_KEY));
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //The port is controlled by the outcome of the authentication
+      error = authenticatorSetPortControl(&authContext, TEST_PORT_INDEX,
+         AUTHENTICATOR_PORT_MODE_AUTO);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Open the sockets
+      error = authenticatorStart(&authContext);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Settle the state machines before recording the transitions
+      testRunTask();
+      //Record the state transitions of the port
+      error = authenticatorSetTraceEnabled(&authContext, TRUE);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Bring the port up
+      error = authenticatorSetLinkState(&authContext, TEST_PORT_INDEX, TRUE);
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //The authentication starts with an EAP-Request/Identity
+      testRunTask();
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Release the authenticator
+ **/
+
+static void testTearDown(void)
+{
+   //Close the sockets
+   authenticatorStop(&authContext);
+   //Release resources
+   authenticatorDeinit(&authContext);
+}
+
+
+/**
+ * @brief Compare the recorded state transitions with the expected ones
+ * @param[in] path Authentication path
+ **/
+
+static void testCheckTransitions(const TestPath *path)
+{
+   error_t error;
+   uint_t i;
+   uint_t n;
+   uint_t numRecords;
+   bool_t match;
+   TestTransition transitions[TEST_MAX_RECORDS];
+   AuthenticatorTraceRecord records[TEST_MAX_RECORDS];
+
+   //Read the trace ring of the port
+   error = authenticatorReadTraceRing(&authContext, TEST_PORT_INDEX, records,
+      TEST_MAX_RECORDS, &numRecords);
+   TEST_CHECK(error == NO_ERROR);
+
+   //Any error to report?
+   if(error)
+      return;
+
+   //The ring must hold the whole path
+   TEST_CHECK(authPortData[0].traceCount <= AUTHENTICATOR_TRACE_RING_SIZE);
+
+   //Keep the state transitions only
+   for(n = 0, i = 0; i < numRecords; i++)
+   {
+      //State transition?
+      if(records[i].event == AUTHENTICATOR_TRACE_EVENT_PAE_STATE ||
+         records[i].event == AUTHENTICATOR_TRACE_EVENT_BACKEND_STATE ||
+         records[i].event == AUTHENTICATOR_TRACE_EVENT_REAUTH_TIMER_STATE ||
+         records[i].event == AUTHENTICATOR_TRACE_EVENT_EAP_FULL_AUTH_STATE)
+      {
+         transitions[n].event = records[i].event;
+         transitions[n].fromState = records[i].fromState;
+         transitions[n].toState = records[i].toState;
+         n++;
+      }
+   }
+
+   //Compare the sequences
+   match = (n == path->numTransitions);
+
+   //Same number of transitions?
+   for(i = 0; match && i < n; i++)
+   {
+      //Compare the current transitions
+      if(transitions[i].event != path->transitions[i].event ||
+         transitions[i].fromState != path->transitions[i].fromState ||
+         transitions[i].toState != path->transitions[i].toState)
+      {
+         match = FALSE;
+      }
+   }
+
+   //The sequences must be identical
+   TEST_CHECK(match);
+
+   //Dump the recorded sequence when it differs from the expected one
+   if(!match)
+   {
+      //Debug message
+      printf("  Recorded transitions (event, from, to):\r\n");
+
+      //Loop through the recorded transitions
+      for(i = 0; i < n; i++)
+      {
+         printf("    {%u, %u, %u}\r\n", transitions[i].event,
+            transitions[i].fromState, transitions[i].toState);
+      }
+   }
+}
+
+
+/**
+ * @brief Test entry point
+ * @return Exit status
+ **/
+
+int main(void)
+{
+   error_t error;
+   uint_t i;
+
+   //Loop through the authentication paths
+   for(i = 0; i < arraysize(testPaths); i++)
+   {
+      //Debug message
+      printf("  %s\r\n", testPaths[i].name);
+
+      //Initialize the authenticator
+      error = testSetUp();
+      TEST_CHECK(error == NO_ERROR);
+
+      //Successful initialization?
+      if(!error)
+      {
+         //Drive the path
+         testPaths[i].run();
+         //Check the state transitions of the port
+         testCheckTransitions(&testPaths[i]);
+      }
+
+      //Release the authenticator
+      testTearDown();
+   }
+
+   //Display the outcome of the test
+   printf("%s: %u failed check(s)\r\n", testFailures ? "FAIL" : "PASS",
+      testFailures);
+
+   //Return exit status
+   return (testFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,929 @@
+/**
+ * @file test_net_fake.c
+ * @brief In-memory fakes of the network layer
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * This module replaces the socket, Ethernet, IP and NIC layers of the TCP/IP
+ * stack, so that the authenticator can be driven without any hardware. The
+ * raw EAPOL sockets and the UDP sockets are backed by message queues. The
+ * link states of the switch ports are reported by a fake switch driver.
+ * The fakes are not thread-safe: the authenticator task must be run from
+ * the test itself (NET_RTOS_SUPPORT disabled)
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include "core/net.h"
+#include "test_net_fake.h"
+
+
+/**
+ * @brief Message queue
+ **/
+
+typedef struct
+{
+   uint_t head;                          ///<Index of the oldest message
+   uint_t count;                         ///<Number of queued messages
+   FakeNetMsg msgs[FAKE_NET_QUEUE_SIZE]; ///<Messages
+} FakeNetQueue;
+
+
+/**
+ * @brief Fake socket
+ **/
+
+typedef struct
+{
+   bool_t used;           ///<The socket is open
+   uint_t type;           ///<Socket type
+   FakeNetQueue rxQueue;  ///<Messages waiting to be received
+} FakeNetSocket;
+
+
+//Default options passed to socketSendMsg and socketReceiveMsg
+const SocketMsg SOCKET_DEFAULT_MSG;
+//Unspecified IP address
+const IpAddr IP_ADDR_UNSPECIFIED;
+//Wildcard IP address
+const IpAddr IP_ADDR_ANY;
+//Unspecified MAC address
+const MacAddr MAC_UNSPECIFIED_ADDR;
+
+//Socket handles
+static Socket fakeSocketHandles[FAKE_NET_MAX_SOCKETS];
+//State of the sockets
+static FakeNetSocket fakeSockets[FAKE_NET_MAX_SOCKETS];
+//EAPOL PDUs sent by the authenticator
+static FakeNetQueue fakeEapolTxQueue;
+//Datagrams sent by the authenticator
+static FakeNetQueue fakeDatagramTxQueue;
+//Link state of the switch ports
+static bool_t fakeLinkStates[FAKE_NET_MAX_SWITCH_PORTS + 1];
+
+//TCP/IP stack context
+static NetContext fakeNetContext;
+//Network interface
+static NetInterface fakeInterface;
+
+//Forward declaration of functions
+static bool_t fakeSwitchGetLinkState(NetInterface *interface, uint8_t port);
+static void fakeSwitchSetPortState(NetInterface *interface, uint8_t port,
+   SwitchPortState state);
+static error_t fakeSwitchUpdateFdbEntry(NetInterface *interface,
+   const SwitchFdbEntry *entry);
+
+//Fake switch driver
+static const SwitchDriver fakeSwitchDriver =
+{
+   .getLinkState = fakeSwitchGetLinkState,
+   .setPortState = fakeSwitchSetPortState,
+   .addStaticFdbEntry = fakeSwitchUpdateFdbEntry,
+   .deleteStaticFdbEntry = fakeSwitchUpdateFdbEntry
+};
+
+
+/**
+ * @brief Append a message to a queue
+ * @param[in] queue Pointer to the queue
+ * @return Pointer to the new entry, or NULL if the queue is full
+ **/
+
+static FakeNetMsg *fakeNetEnqueue(FakeNetQueue *queue)
+{
+   FakeNetMsg *msg;
+
+   //The queue is full?
+   if(queue->count >= FAKE_NET_QUEUE_SIZE)
+      return NULL;
+
+   //Point to the first free entry
+   msg = &queue->msgs[(queue->head + queue->count) % FAKE_NET_QUEUE_SIZE];
+   queue->count++;
+
+   //Clear the entry
+   osMemset(msg, 0, sizeof(FakeNetMsg));
+   //Save the current time
+   msg->timestamp = osGetSystemTime();
+
+   //Return a pointer to the entry
+   return msg;
+}
+
+
+/**
+ * @brief Remove the oldest message of a queue
+ * @param[in] queue Pointer to the queue
+ * @return Pointer to the message, or NULL if the queue is empty
+ **/
+
+static FakeNetMsg *fakeNetDequeue(FakeNetQueue *queue)
+{
+   FakeNetMsg *msg;
+
+   //The queue is empty?
+   if(queue->count == 0)
+      return NULL;
+
+   //Point to the oldest message
+   msg = &queue->msgs[queue->head];
+
+   //The entry is released
+   queue->head = (queue->head + 1) % FAKE_NET_QUEUE_SIZE;
+   queue->count--;
+
+   //The contents of the entry remain valid until the next enqueue
+   return msg;
+}
+
+
+/**
+ * @brief Retrieve the state of a socket
+ * @param[in] socket Handle referencing the socket
+ * @return Pointer to the state of the socket, or NULL if the handle is
+ *   invalid
+ **/
+
+static FakeNetSocket *fakeNetGetSocketState(Socket *socket)
+{
+   uint_t i;
+
+   //Invalid handle?
+   if(socket < fakeSocketHandles ||
+      socket >= (fakeSocketHandles + FAKE_NET_MAX_SOCKETS))
+   {
+      return NULL;
+   }
+
+   //Retrieve the index of the socket
+   i = socket - fakeSocketHandles;
+
+   //The socket must be open
+   if(!fakeSockets[i].used)
+      return NULL;
+
+   //Return the state of the socket
+   return &fakeSockets[i];
+}
+
+
+/**
+ * @brief Reset the fake network layer
+ **/
+
+void fakeNetInit(void)
+{
+   uint_t i;
+
+   //Close all the sockets and flush all the queues
+   osMemset(fakeSockets, 0, sizeof(fakeSockets));
+   osMemset(&fakeEapolTxQueue, 0, sizeof(FakeNetQueue));
+   osMemset(&fakeDatagramTxQueue, 0, sizeof(FakeNetQueue));
+
+   //All the links are down
+   for(i = 0; i <= FAKE_NET_MAX_SWITCH_PORTS; i++)
+   {
+      fakeLinkStates[i] = FALSE;
+   }
+
+   //Initialize the network interface
+   osMemset(&fakeInterface, 0, sizeof(NetInterface));
+   fakeInterface.netContext = &fakeNetContext;
+   fakeInterface.switchDriver = &fakeSwitchDriver;
+   fakeInterface.linkState = TRUE;
+
+   //Locally administered MAC address of the interface
+   fakeInterface.macAddr.b[0] = 0x02;
+   fakeInterface.macAddr.b[5] = 0x01;
+}
+
+
+/**
+ * @brief Get the fake network interface
+ * @return Pointer to the network interface
+ **/
+
+NetInterface *fakeNetGetInterface(void)
+{
+   return &fakeInterface;
+}
+
+
+/**
+ * @brief Get the fake TCP/IP stack context
+ * @return Pointer to the TCP/IP stack context
+ **/
+
+NetContext *fakeNetGetContext(void)
+{
+   return &fakeNetContext;
+}
+
+
+/**
+ * @brief Set the link state of a switch port
+ * @param[in] switchPort Switch port number
+ * @param[in] linkState Link state
+ **/
+
+void fakeNetSetLinkState(uint8_t switchPort, bool_t linkState)
+{
+   //Check port number
+   if(switchPort <= FAKE_NET_MAX_SWITCH_PORTS)
+   {
+      fakeLinkStates[switchPort] = linkState;
+   }
+}
+
+
+/**
+ * @brief Queue an EAPOL PDU on the raw sockets
+ * @param[in] switchPort Switch port the PDU is received on
+ * @param[in] srcMacAddr MAC address of the supplicant
+ * @param[in] pdu Pointer to the EAPOL PDU
+ * @param[in] length Length of the EAPOL PDU, in bytes
+ * @return Error code
+ **/
+
+error_t fakeNetInjectEapol(uint8_t switchPort, const MacAddr *srcMacAddr,
+   const void *pdu, size_t length)
+{
+   uint_t i;
+   FakeNetMsg *msg;
+
+   //Check the length of the PDU
+   if(length > FAKE_NET_MAX_MSG_SIZE)
+      return ERROR_INVALID_LENGTH;
+
+   //Search for the raw socket
+   for(i = 0; i < FAKE_NET_MAX_SOCKETS; i++)
+   {
+      if(fakeSockets[i].used && fakeSockets[i].type == SOCKET_TYPE_RAW_ETH)
+         break;
+   }
+
+   //The authenticator has not been started?
+   if(i >= FAKE_NET_MAX_SOCKETS)
+      return ERROR_WRONG_STATE;
+
+   //Allocate an entry in the receive queue of the socket
+   msg = fakeNetEnqueue(&fakeSockets[i].rxQueue);
+   //The queue is full?
+   if(msg == NULL)
+      return ERROR_OUT_OF_RESOURCES;
+
+   //EAPOL PDUs are sent to the PAE group address
+   msg->socket = i;
+   msg->srcMacAddr = *srcMacAddr;
+   msg->destMacAddr.b[0] = 0x01;
+   msg->destMacAddr.b[1] = 0x80;
+   msg->destMacAddr.b[2] = 0xC2;
+   msg->destMacAddr.b[5] = 0x03;
+   msg->switchPort = switchPort;
+
+   //Copy the PDU
+   osMemcpy(msg->data, pdu, length);
+   msg->length = length;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Queue a datagram on a UDP socket
+ * @param[in] socket Index of the socket
+ * @param[in] srcIpAddr IP address of the sender
+ * @param[in] srcPort Port number of the sender
+ * @param[in] data Pointer to the datagram
+ * @param[in] length Length of the datagram, in bytes
+ * @return Error code
+ **/
+
+error_t fakeNetInjectDatagram(uint_t socket, const IpAddr *srcIpAddr,
+   uint16_t srcPort, const void *data, size_t length)
+{
+   FakeNetMsg *msg;
+
+   //Check parameters
+   if(socket >= FAKE_NET_MAX_SOCKETS || !fakeSockets[socket].used ||
+      fakeSockets[socket].type != SOCKET_TYPE_DGRAM)
+   {
+      return ERROR_INVALID_PARAMETER;
+   }
+
+   //Check the length of the datagram
+   if(length > FAKE_NET_MAX_MSG_SIZE)
+      return ERROR_INVALID_LENGTH;
+
+   //Allocate an entry in the receive queue of the socket
+   msg = fakeNetEnqueue(&fakeSockets[socket].rxQueue);
+   //The queue is full?
+   if(msg == NULL)
+      return ERROR_OUT_OF_RESOURCES;
+
+   //Save the address of the sender
+   msg->socket = socket;
+   msg->ipAddr = *srcIpAddr;
+   msg->port = srcPort;
+
+   //Copy the datagram
+   osMemcpy(msg->data, data, length);
+   msg->length = length;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve the oldest EAPOL PDU sent by the authenticator
+ * @param[out] msg Copy of the EAPOL PDU
+ * @return TRUE if a PDU has been retrieved, else FALSE
+ **/
+
+bool_t fakeNetGetEapol(FakeNetMsg *msg)
+{
+   FakeNetMsg *entry;
+
+   //Remove the oldest PDU from the transmit queue
+   entry = fakeNetDequeue(&fakeEapolTxQueue);
+   //The queue is empty?
+   if(entry == NULL)
+      return FALSE;
+
+   //Copy the PDU
+   *msg = *entry;
+
+   //Successful processing
+   return TRUE;
+}
+
+
+/**
+ * @brief Retrieve the oldest datagram sent by the authenticator
+ * @param[out] msg Copy of the datagram
+ * @return TRUE if a datagram has been retrieved, else FALSE
+ **/
+
+bool_t fakeNetGetDatagram(FakeNetMsg *msg)
+{
+   FakeNetMsg *entry;
+
+   //Remove the oldest datagram from the transmit queue
+   entry = fakeNetDequeue(&fakeDatagramTxQueue);
+   //The queue is empty?
+   if(entry == NULL)
+      return FALSE;
+
+   //Copy the datagram
+   *msg = *entry;
+
+   //Successful processing
+   return TRUE;
+}
+
+
+/**
+ * @brief Get the number of EAPOL PDUs sent by the authenticator
+ * @return Number of PDUs waiting in the transmit queue
+ **/
+
+uint_t fakeNetGetPendingEapol(void)
+{
+   return fakeEapolTxQueue.count;
+}
+
+
+/**
+ * @brief Get the number of datagrams sent by the authenticator
+ * @return Number of datagrams waiting in the transmit queue
+ **/
+
+uint_t fakeNetGetPendingDatagrams(void)
+{
+   return fakeDatagramTxQueue.count;
+}
+
+
+/**
+ * @brief Get the number of messages waiting to be received by the authenticator
+ * @return Number of messages waiting in the receive queues of the sockets
+ **/
+
+uint_t fakeNetGetPendingRx(void)
+{
+   uint_t i;
+   uint_t n;
+
+   //Loop through the sockets
+   for(n = 0, i = 0; i < FAKE_NET_MAX_SOCKETS; i++)
+   {
+      //Count the messages queued on the socket
+      if(fakeSockets[i].used)
+      {
+         n += fakeSockets[i].rxQueue.count;
+      }
+   }
+
+   //Return the number of pending messages
+   return n;
+}
+
+
+/**
+ * @brief Get the link state of a switch port
+ * @param[in] interface Underlying network interface
+ * @param[in] port Switch port number
+ * @return Link state
+ **/
+
+static bool_t fakeSwitchGetLinkState(NetInterface *interface, uint8_t port)
+{
+   //Check port number
+   if(port > FAKE_NET_MAX_SWITCH_PORTS)
+      return FALSE;
+
+   //Return the simulated link state
+   return fakeLinkStates[port];
+}
+
+
+/**
+ * @brief Set the state of a switch port
+ * @param[in] interface Underlying network interface
+ * @param[in] port Switch port number
+ * @param[in] state Port state
+ **/
+
+static void fakeSwitchSetPortState(NetInterface *interface, uint8_t port,
+   SwitchPortState state)
+{
+   //The forwarding state of the ports is not simulated
+}
+
+
+/**
+ * @brief Add or remove an entry of the static MAC table
+ * @param[in] interface Underlying network interface
+ * @param[in] entry Pointer to the MAC table entry
+ * @return Error code
+ **/
+
+static error_t fakeSwitchUpdateFdbEntry(NetInterface *interface,
+   const SwitchFdbEntry *entry)
+{
+   //The MAC table is not simulated
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Create a socket
+ * @param[in] context Pointer to the TCP/IP stack context
+ * @param[in] type Type specification for the new socket
+ * @param[in] protocol Protocol to be used
+ * @return Handle referencing the new socket
+ **/
+
+Socket *socketOpenEx(NetContext *context, uint_t type, uint_t protocol)
+{
+   uint_t i;
+
+   //Search for a free socket
+   for(i = 0; i < FAKE_NET_MAX_SOCKETS; i++)
+   {
+      if(!fakeSockets[i].used)
+         break;
+   }
+
+   //No socket available?
+   if(i >= FAKE_NET_MAX_SOCKETS)
+      return NULL;
+
+   //Initialize the socket
+   osMemset(&fakeSockets[i], 0, sizeof(FakeNetSocket));
+   fakeSockets[i].used = TRUE;
+   fakeSockets[i].type = type;
+
+   //Return a handle to the socket
+   return &fakeSocketHandles[i];
+}
+
+
+/**
+ * @brief Set timeout value for blocking operations
+ * @param[in] socket Handle to a socket
+ * @param[in] timeout Maximum time to wait
+ * @return Error code
+ **/
+
+error_t socketSetTimeout(Socket *socket, systime_t timeout)
+{
+   //The fake sockets never block
+   return (fakeNetGetSocketState(socket) != NULL) ? NO_ERROR :
+      ERROR_INVALID_PARAMETER;
+}
+
+
+/**
+ * @brief Bind a socket to a particular network interface
+ * @param[in] socket Handle to a socket
+ * @param[in] interface Network interface to be used
+ * @return Error code
+ **/
+
+error_t socketBindToInterface(Socket *socket, NetInterface *interface)
+{
+   //There is a single network interface
+   return (fakeNetGetSocketState(socket) != NULL) ? NO_ERROR :
+      ERROR_INVALID_PARAMETER;
+}
+
+
+/**
+ * @brief Associate a local address with a socket
+ * @param[in] socket Handle to a socket
+ * @param[in] localIpAddr Local address to assign to the bound socket
+ * @param[in] localPort Local port number to assign to the bound socket
+ * @return Error code
+ **/
+
+error_t socketBind(Socket *socket, const IpAddr *localIpAddr,
+   uint16_t localPort)
+{
+   //The local endpoint is not simulated
+   return (fakeNetGetSocketState(socket) != NULL) ? NO_ERROR :
+      ERROR_INVALID_PARAMETER;
+}
+
+
+/**
+ * @brief Send a message to a connectionless socket
+ * @param[in] socket Handle to a socket
+ * @param[in] message Pointer to the message
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t socketSendMsg(Socket *socket, const SocketMsg *message, uint_t flags)
+{
+   FakeNetMsg *msg;
+   FakeNetSocket *state;
+
+   //Retrieve the state of the socket
+   state = fakeNetGetSocketState(socket);
+   //Invalid socket?
+   if(state == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Check the length of the message
+   if(message->length > FAKE_NET_MAX_MSG_SIZE)
+      return ERROR_INVALID_LENGTH;
+
+   //Raw socket?
+   if(state->type == SOCKET_TYPE_RAW_ETH)
+   {
+      //The PDU is transmitted to the supplicants
+      msg = fakeNetEnqueue(&fakeEapolTxQueue);
+   }
+   else
+   {
+      //The datagram is transmitted to the RADIUS server
+      msg = fakeNetEnqueue(&fakeDatagramTxQueue);
+   }
+
+   //The queue is full?
+   if(msg == NULL)
+      return ERROR_OUT_OF_RESOURCES;
+
+   //Save the properties of the message
+   msg->socket = socket - fakeSocketHandles;
+   msg->ipAddr = message->destIpAddr;
+   msg->port = message->destPort;
+   msg->srcMacAddr = message->srcMacAddr;
+   msg->destMacAddr = message->destMacAddr;
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   msg->switchPort = message->switchPort;
+#endif
+
+   //Copy the message
+   osMemcpy(msg->data, message->data, message->length);
+   msg->length = message->length;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Receive a message from a connectionless socket
+ * @param[in] socket Handle to a socket
+ * @param[in,out] message Pointer to the structure describing the message
+ * @param[in] flags Set of flags that influences the behavior of this function
+ * @return Error code
+ **/
+
+error_t socketReceiveMsg(Socket *socket, SocketMsg *message, uint_t flags)
+{
+   FakeNetMsg *msg;
+   FakeNetSocket *state;
+
+   //Retrieve the state of the socket
+   state = fakeNetGetSocketState(socket);
+   //Invalid socket?
+   if(state == NULL)
+      return ERROR_INVALID_PARAMETER;
+
+   //Remove the oldest message from the receive queue
+   msg = fakeNetDequeue(&state->rxQueue);
+   //No message available?
+   if(msg == NULL)
+      return ERROR_TIMEOUT;
+
+   //The message is truncated if the buffer is too small
+   message->length = MIN(msg->length, message->size);
+   osMemcpy(message->data, msg->data, message->length);
+
+   //Save the properties of the message
+   message->srcIpAddr = msg->ipAddr;
+   message->srcPort = msg->port;
+   message->srcMacAddr = msg->srcMacAddr;
+   message->destMacAddr = msg->destMacAddr;
+   message->timestamp = msg->timestamp;
+#if (ETH_PORT_TAGGING_SUPPORT == ENABLED)
+   message->switchPort = msg->switchPort;
+#endif
+
+   //Raw sockets are bound to the PAE EtherType
+   if(state->type == SOCKET_TYPE_RAW_ETH)
+   {
+      message->ethType = ETH_TYPE_EAPOL;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Close an existing socket
+ * @param[in] socket Handle identifying the socket to close
+ **/
+
+void socketClose(Socket *socket)
+{
+   FakeNetSocket *state;
+
+   //Retrieve the state of the socket
+   state = fakeNetGetSocketState(socket);
+
+   //Valid socket?
+   if(state != NULL)
+   {
+      //Discard the pending messages
+      osMemset(state, 0, sizeof(FakeNetSocket));
+   }
+}
+
+
+/**
+ * @brief Wait for one of a set of sockets to become ready to perform I/O
+ *
+ * The fake sockets never block. The function returns immediately with the
+ * sockets that have messages waiting in their receive queue
+ *
+ * @param[in,out] eventDesc Set of entries specifying the events the user is
+ *   interested in
+ * @param[in] size Number of entries in the descriptor set
+ * @param[in] extEvent External event that can abort the wait if necessary
+ * @param[in] timeout Maximum time to wait
+ * @return Error code
+ **/
+
+error_t socketPoll(SocketEventDesc *eventDesc, uint_t size, OsEvent *extEvent,
+   systime_t timeout)
+{
+   uint_t i;
+   bool_t ready;
+   FakeNetSocket *state;
+
+   //No socket is ready yet
+   ready = FALSE;
+
+   //Loop through the descriptor set
+   for(i = 0; i < size; i++)
+   {
+      //Clear event flags
+      eventDesc[i].eventFlags = 0;
+
+      //Retrieve the state of the socket
+      state = fakeNetGetSocketState(eventDesc[i].socket);
+
+      //Any message waiting in the receive queue?
+      if(state != NULL && state->rxQueue.count > 0)
+      {
+         eventDesc[i].eventFlags = eventDesc[i].eventMask &
+            SOCKET_EVENT_RX_READY;
+      }
+
+      //Check whether the socket is ready
+      if(eventDesc[i].eventFlags != 0)
+      {
+         ready = TRUE;
+      }
+   }
+
+   //Return status code
+   return ready ? NO_ERROR : ERROR_TIMEOUT;
+}
+
+
+/**
+ * @brief Get exclusive access to the TCP/IP stack
+ * @param[in] context Pointer to the TCP/IP stack context
+ **/
+
+void netLock(NetContext *context)
+{
+   //The fake network layer is single-threaded
+}
+
+
+/**
+ * @brief Release exclusive access to the TCP/IP stack
+ * @param[in] context Pointer to the TCP/IP stack context
+ **/
+
+void netUnlock(NetContext *context)
+{
+   //The fake network layer is single-threaded
+}
+
+
+/**
+ * @brief Retrieve MAC address
+ * @param[in] interface Pointer to the desired network interface
+ * @param[out] macAddr MAC address
+ * @return Error code
+ **/
+
+error_t netGetMacAddr(NetInterface *interface, MacAddr *macAddr)
+{
+   //Retrieve the MAC address of the interface
+   *macAddr = interface->macAddr;
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Retrieve physical interface
+ * @param[in] interface Pointer to the network interface
+ * @return Physical interface
+ **/
+
+NetInterface *nicGetPhysicalInterface(NetInterface *interface)
+{
+   //There is no virtual interface
+   return interface;
+}
+
+
+/**
+ * @brief Add a multicast address to the MAC filter table
+ * @param[in] interface Underlying network interface
+ * @param[in] macAddr MAC address to accept
+ * @return Error code
+ **/
+
+error_t ethAcceptMacAddr(NetInterface *interface, const MacAddr *macAddr)
+{
+   //The MAC filter is not simulated
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Remove a multicast address from the MAC filter table
+ * @param[in] interface Underlying network interface
+ * @param[in] macAddr MAC address to drop
+ * @return Error code
+ **/
+
+error_t ethDropMacAddr(NetInterface *interface, const MacAddr *macAddr)
+{
+   //The MAC filter is not simulated
+   return NO_ERROR;
+}
+
+
+/**
+ * @brief Convert a MAC address to a dash delimited string
+ * @param[in] macAddr Pointer to the MAC address
+ * @param[out] str NULL-terminated string representing the MAC address
+ * @return Pointer to the formatted string
+ **/
+
+char_t *macAddrToString(const MacAddr *macAddr, char_t *str)
+{
+   static char_t buffer[18];
+
+   //The str parameter is optional
+   if(str == NULL)
+   {
+      str = buffer;
+   }
+
+   //Format MAC address
+   osSprintf(str, "%02X-%02X-%02X-%02X-%02X-%02X", macAddr->b[0],
+      macAddr->b[1], macAddr->b[2], macAddr->b[3], macAddr->b[4],
+      macAddr->b[5]);
+
+   //Return a pointer to the formatted string
+   return str;
+}
+
+
+/**
+ * @brief Compare IP addresses
+ * @param[in] ipAddr1 First IP address
+ * @param[in] ipAddr2 Second IP address
+ * @return Comparison result
+ **/
+
+bool_t ipCompAddr(const IpAddr *ipAddr1, const IpAddr *ipAddr2)
+{
+   //Both addresses must have the same type
+   if(ipAddr1->length != ipAddr2->length)
+      return FALSE;
+
+#if (IPV4_SUPPORT == ENABLED)
+   //IPv4 addresses?
+   if(ipAddr1->length == sizeof(Ipv4Addr))
+      return (ipAddr1->ipv4Addr == ipAddr2->ipv4Addr) ? TRUE : FALSE;
+#endif
+
+#if (IPV6_SUPPORT == ENABLED)
+   //IPv6 addresses?
+   if(ipAddr1->length == sizeof(Ipv6Addr))
+   {
+      return (osMemcmp(&ipAddr1->ipv6Addr, &ipAddr2->ipv6Addr,
+         sizeof(Ipv6Addr)) == 0) ? TRUE : FALSE;
+   }
+#endif
+
+   //Both addresses are unspecified
+   return TRUE;
+}
+
+
+/**
+ * @brief IP source address selection
+ * @param[in] context Pointer to the TCP/IP stack context
+ * @param[in,out] interface A pointer to a valid network interface may be
+ *   provided as a hint
+ * @param[in] destAddr Destination IP address
+ * @param[out] srcAddr Local IP address to be used
+ * @return Error code
+ **/
+
+error_t ipSelectSourceAddr(NetContext *context, NetInterface **interface,
+   const IpAddr *destAddr, IpAddr *srcAddr)
+{
+   //Select the network interface
+   *interface = &fakeInterface;
+
+   //The local address has the same type as the destination address
+   osMemset(srcAddr, 0, sizeof(IpAddr));
+   srcAddr->length = destAddr->length;
+
+   //Successful processing
+   return NO_ERROR;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_net_fake.h
+ * @brief In-memory fakes of the network layer
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _TEST_NET_FAKE_H
+#define _TEST_NET_FAKE_H
+
+//Dependencies
+#include "core/net.h"
+
+//Maximum number of sockets
+#ifndef FAKE_NET_MAX_SOCKETS
+   #define FAKE_NET_MAX_SOCKETS 16
+#elif (FAKE_NET_MAX_SOCKETS < 1)
+   #error FAKE_NET_MAX_SOCKETS parameter is not valid
+#endif
+
+//Number of messages each queue can hold
+#ifndef FAKE_NET_QUEUE_SIZE
+   #define FAKE_NET_QUEUE_SIZE 256
+#elif (FAKE_NET_QUEUE_SIZE < 1)
+   #error FAKE_NET_QUEUE_SIZE parameter is not valid
+#endif
+
+//Maximum length of a queued message
+#ifndef FAKE_NET_MAX_MSG_SIZE
+   #define FAKE_NET_MAX_MSG_SIZE 1600
+#elif (FAKE_NET_MAX_MSG_SIZE < 64)
+   #error FAKE_NET_MAX_MSG_SIZE parameter is not valid
+#endif
+
+//Number of switch ports whose link state is simulated
+#ifndef FAKE_NET_MAX_SWITCH_PORTS
+   #define FAKE_NET_MAX_SWITCH_PORTS 64
+#elif (FAKE_NET_MAX_SWITCH_PORTS < 1 || FAKE_NET_MAX_SWITCH_PORTS > 255)
+   #error FAKE_NET_MAX_SWITCH_PORTS parameter is not valid
+#endif
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @brief Message queued by the fake network layer
+ **/
+
+typedef struct
+{
+   uint_t socket;                         ///<Socket the message is sent from or destined to
+   IpAddr ipAddr;                         ///<Remote IP address (UDP sockets)
+   uint16_t port;                         ///<Remote port number (UDP sockets)
+   MacAddr srcMacAddr;                    ///<Source MAC address (raw sockets)
+   MacAddr destMacAddr;                   ///<Destination MAC address (raw sockets)
+   uint8_t switchPort;                    ///<Switch port (raw sockets)
+   systime_t timestamp;                   ///<Time at which the message has been queued
+   size_t length;                         ///<Length of the message, in bytes
+   uint8_t data[FAKE_NET_MAX_MSG_SIZE];   ///<Message contents
+} FakeNetMsg;
+
+
+//Fake network layer related functions
+void fakeNetInit(void);
+NetInterface *fakeNetGetInterface(void);
+NetContext *fakeNetGetContext(void);
+
+void fakeNetSetLinkState(uint8_t switchPort, bool_t linkState);
+
+error_t fakeNetInjectEapol(uint8_t switchPort, const MacAddr *srcMacAddr,
+   const void *pdu, size_t length);
+
+error_t fakeNetInjectDatagram(uint_t socket, const IpAddr *srcIpAddr,
+   uint16_t srcPort, const void *data, size_t length);
+
+bool_t fakeNetGetEapol(FakeNetMsg *msg);
+bool_t fakeNetGetDatagram(FakeNetMsg *msg);
+
+uint_t fakeNetGetPendingEapol(void);
+uint_t fakeNetGetPendingDatagrams(void);
+uint_t fakeNetGetPendingRx(void);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,420 @@
+/**
+ * @file test_pae_mib.c
+ * @brief GetNext test of the Port Access Control MIB tables
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * The GetNext operation of the dot1xPaePortTable is run against an
+ * authenticator with sparse port numbers, some of which are encoded on
+ * several subidentifier bytes. The test checks that:
+ * - a walk of the column returns every port, in ascending order
+ * - an instance identifier followed by further subidentifiers is succeeded
+ *   by the next row
+ * - a malformed or truncated instance identifier is succeeded by the first
+ *   row that follows it in lexicographic order, instead of ending the walk
+ *
+ * The test_pae_mib target of tests/Makefile builds it together with the MIB
+ * sources and the MIB helpers of CycloneTCP, and "make check" runs it. The
+ * process exits with a non-zero status if any check fails
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include <stdlib.h>
+#include "authenticator/authenticator.h"
+#include "mibs/ieee8021_pae_mib_module.h"
+#include "mibs/ieee8021_pae_mib_impl.h"
+#include "mibs/ieee8021_pae_mib_impl_sys.h"
+#include "test_net_fake.h"
+
+//Check a condition and record the failure
+#define TEST_CHECK(cond) \
+   do \
+   { \
+      if(!(cond)) \
+      { \
+         printf("  %s:%d: check failed: %s\r\n", __FILE__, __LINE__, #cond); \
+         testFailures++; \
+      } \
+   } while(0)
+
+//Number of ports
+#define TEST_NUM_PORTS 6
+//Maximum length of an OID
+#define TEST_MAX_OID_SIZE 64
+
+
+/**
+ * @brief GetNext test vector
+ **/
+
+typedef struct
+{
+   const char_t *name;   ///<Description of the instance identifier
+   uint8_t instance[8];  ///<Instance identifier
+   size_t instanceLen;   ///<Length of the instance identifier, in bytes
+   uint_t nextPortNum;   ///<Expected successor (0 if none)
+} TestVector;
+
+
+//Port numbers (128 and 300 are encoded on two bytes)
+static const uint16_t testPortNumbers[TEST_NUM_PORTS] = {1, 2, 100, 127, 128, 300};
+
+//GetNext test vectors
+static const TestVector testVectors[] =
+{
+   {"table prefix", {0}, 0, 1},
+   {"first row", {0x01}, 1, 2},
+   {"absent row", {0x03}, 1, 100},
+   {"row followed by a subidentifier", {0x02, 0x05}, 2, 100},
+   {"last one-byte row", {0x7F}, 1, 128},
+   {"two-byte row", {0x81, 0x00}, 2, 300},
+   {"truncated subidentifier 0x80", {0x80}, 1, 128},
+   {"truncated subidentifier 0x81", {0x81}, 1, 128},
+   {"truncated subidentifier 0x82", {0x82}, 1, 300},
+   {"truncated subidentifier 0x81 0x80", {0x81, 0x80}, 2, 300},
+   {"truncated subidentifier past the last row", {0x83}, 1, 0},
+   {"oversized subidentifier", {0x8F, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F}, 6, 0},
+   {"last row", {0x82, 0x2C}, 2, 0}
+};
+
+//Authenticator context
+static AuthenticatorContext authContext;
+static AuthenticatorPort authPorts[TEST_NUM_PORTS];
+static AuthenticatorPortData authPortData[TEST_NUM_PORTS];
+static AuthenticatorBuffer authBuffers[1];
+static uint8_t authBufferMemory[AUTHENTICATOR_BUFFER_MEMORY_SIZE(1,
+   AUTHENTICATOR_TX_BUFFER_SIZE)];
+
+//State of the deterministic PRNG
+static uint32_t testPrngState;
+//Number of failed checks
+static uint_t testFailures;
+
+
+/**
+ * @brief Generate deterministic pseudo-random data
+ * @param[in] context Pointer to the PRNG state
+ * @param[out] output Buffer where to store the data
+ * @param[in] length Number of bytes to generate
+ * @return Error code
+ **/
+
+static error_t testPrngGenerate(void *context, uint8_t *output, size_t length)
+{
+   uint32_t *state;
+
+   //Point to the state of the generator
+   state = (uint32_t *) context;
+
+   //Xorshift generator
+   while(length-- > 0)
+   {
+      *state ^= *state << 13;
+      *state ^= *state >> 17;
+      *state ^= *state << 5;
+      *(output++) = (uint8_t) *state;
+   }
+
+   //Successful processing
+   return NO_ERROR;
+}
+
+
+//Deterministic PRNG (the test does not need cryptographic strength)
+static const PrngAlgo testPrngAlgo =
+{
+   .name = "Xorshift",
+   .contextSize = sizeof(uint32_t),
+   .generate = testPrngGenerate
+};
+
+
+/**
+ * @brief Initialize the authenticator and attach it to the MIB
+ * @return Error code
+ **/
+
+static error_t testSetUp(void)
+{
+   error_t error;
+   AuthenticatorSettings settings;
+
+   //Reset the fake network layer
+   fakeNetInit();
+
+   //Seed the PRNG
+   testPrngState = 0x2545F491;
+
+   //Get default settings
+   authenticatorGetDefaultSettings(&settings);
+
+   //The ports are attached to the fake network interface
+   settings.interface = fakeNetGetInterface();
+   settings.numPorts = TEST_NUM_PORTS;
+   settings.ports = authPorts;
+   settings.portData = authPortData;
+   settings.portNumbers = testPortNumbers;
+   settings.numBuffers = 1;
+   settings.buffers = authBuffers;
+   settings.bufferMemory = authBufferMemory;
+   settings.prngAlgo = &testPrngAlgo;
+   settings.prngContext = &testPrngState;
+
+   //Initialize the authenticator
+   error = authenticatorInit(&authContext, &settings);
+
+   //Check status code
+   if(!error)
+   {
+      //Initialize the MIB
+      error = ieee8021PaeMibInit();
+   }
+
+   //Check status code
+   if(!error)
+   {
+      //Attach the authenticator to the MIB
+      error = ieee8021PaeMibSetAuthenticatorContext(&authContext);
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Retrieve the descriptor of a MIB object
+ * @param[in] name Name of the object
+ * @return Pointer to the MIB object descriptor (NULL if not found)
+ **/
+
+static const MibObject *testGetObject(const char_t *name)
+{
+   uint_t i;
+
+   //Loop through the objects of the MIB module
+   for(i = 0; i < ieee8021PaeMibModule.numObjects; i++)
+   {
+      //Matching name?
+      if(osStrcmp(ieee8021PaeMibModule.objects[i].name, name) == 0)
+         return &ieee8021PaeMibModule.objects[i];
+   }
+
+   //The object does not exist
+   return NULL;
+}
+
+
+/**
+ * @brief Run a GetNext operation on a column of the port table
+ * @param[in] object Pointer to the MIB object descriptor
+ * @param[in] instance Instance identifier
+ * @param[in] instanceLen Length of the instance identifier, in bytes
+ * @param[out] nextInstance Instance identifier of the next row
+ * @param[out] nextInstanceLen Length of the next instance identifier
+ * @return Error code
+ **/
+
+static error_t testGetNext(const MibObject *object, const uint8_t *instance,
+   size_t instanceLen, uint8_t *nextInstance, size_t *nextInstanceLen)
+{
+   error_t error;
+   size_t oidLen;
+   size_t nextOidLen;
+   uint8_t oid[TEST_MAX_OID_SIZE];
+   uint8_t nextOid[TEST_MAX_OID_SIZE];
+
+   //The OID is made of the OID of the column followed by the instance
+   //identifier
+   osMemcpy(oid, object->oid, object->oidLen);
+   osMemcpy(oid + object->oidLen, instance, instanceLen);
+   oidLen = object->oidLen + instanceLen;
+
+   //Retrieve the next object
+   nextOidLen = sizeof(nextOid);
+   error = ieee8021PaeMibGetNextDot1xPaePortEntry(object, oid, oidLen,
+      nextOid, &nextOidLen);
+
+   //Check status code
+   if(!error)
+   {
+      //The next object must belong to the same column
+      if(nextOidLen > object->oidLen &&
+         osMemcmp(nextOid, object->oid, object->oidLen) == 0)
+      {
+         //Return the instance identifier of the next row
+         *nextInstanceLen = nextOidLen - object->oidLen;
+         osMemcpy(nextInstance, nextOid + object->oidLen, *nextInstanceLen);
+      }
+      else
+      {
+         //Report an error
+         error = ERROR_FAILURE;
+      }
+   }
+
+   //Return status code
+   return error;
+}
+
+
+/**
+ * @brief Check the successor of each test vector
+ * @param[in] object Pointer to the MIB object descriptor
+ **/
+
+static void testSuccessors(const MibObject *object)
+{
+   error_t error;
+   uint_t i;
+   size_t n;
+   size_t expectedLen;
+   uint8_t next[TEST_MAX_OID_SIZE];
+   uint8_t expected[TEST_MAX_OID_SIZE];
+   const TestVector *vector;
+
+   //Loop through the test vectors
+   for(i = 0; i < arraysize(testVectors); i++)
+   {
+      //Point to the current test vector
+      vector = &testVectors[i];
+      printf("  GetNext after %s\r\n", vector->name);
+
+      //Retrieve the next row
+      error = testGetNext(object, vector->instance, vector->instanceLen, next,
+         &n);
+
+      //Any row expected?
+      if(vector->nextPortNum != 0)
+      {
+         //Encode the instance identifier of the expected row
+         expectedLen = 0;
+         mibEncodeIndex(expected, sizeof(expected), &expectedLen,
+            vector->nextPortNum);
+
+         //The next row must be the expected one
+         TEST_CHECK(error == NO_ERROR);
+         TEST_CHECK(error || (n == expectedLen &&
+            osMemcmp(next, expected, n) == 0));
+      }
+      else
+      {
+         //The walk must leave the column
+         TEST_CHECK(error == ERROR_OBJECT_NOT_FOUND);
+      }
+   }
+}
+
+
+/**
+ * @brief Walk a column of the port table
+ * @param[in] object Pointer to the MIB object descriptor
+ **/
+
+static void testWalk(const MibObject *object)
+{
+   error_t error;
+   uint_t i;
+   uint_t portNum;
+   size_t n;
+   size_t pos;
+   uint8_t instance[TEST_MAX_OID_SIZE];
+
+   //Debug message
+   printf("  Walk of the column\r\n");
+
+   //The walk starts from the OID of the column
+   n = 0;
+
+   //Loop through the ports
+   for(i = 0; i < TEST_NUM_PORTS; i++)
+   {
+      //Retrieve the next row
+      error = testGetNext(object, instance, n, instance, &n);
+      TEST_CHECK(error == NO_ERROR);
+
+      //Any error to report?
+      if(error)
+         return;
+
+      //Decode the instance identifier
+      pos = 0;
+      error = mibDecodeIndex(instance, n, &pos, &portNum);
+
+      //The rows must be returned in ascending order of port number
+      TEST_CHECK(error == NO_ERROR && pos == n);
+      TEST_CHECK(portNum == testPortNumbers[i]);
+   }
+
+   //No row follows the last port
+   error = testGetNext(object, instance, n, instance, &n);
+   TEST_CHECK(error == ERROR_OBJECT_NOT_FOUND);
+}
+
+
+/**
+ * @brief Test entry point
+ * @return Exit status
+ **/
+
+int main(void)
+{
+   error_t error;
+   const MibObject *object;
+
+   //Initialize the authenticator
+   error = testSetUp();
+   TEST_CHECK(error == NO_ERROR);
+
+   //Successful initialization?
+   if(!error)
+   {
+      //dot1xPaePortProtocolVersion is the first column of the port table
+      object = testGetObject("dot1xPaePortProtocolVersion");
+      TEST_CHECK(object != NULL);
+
+      //Valid object?
+      if(object != NULL)
+      {
+         //Walk the column
+         testWalk(object);
+         //Check the successor of valid and malformed instance identifiers
+         testSuccessors(object);
+      }
+   }
+
+   //Release the authenticator
+   authenticatorDeinit(&authContext);
+
+   //Display the outcome of the test
+   printf("%s: %u failed check(s)\r\n", testFailures ? "FAIL" : "PASS",
+      testFailures);
+
+   //Return exit status
+   return (testFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
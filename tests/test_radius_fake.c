@@ -0,0 +1,200 @@
+/**
+ * @file test_radius_fake.c
+ * @brief Helpers for scripted RADIUS servers
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @section Description
+ *
+ * The tests and benchmarks play the role of the RADIUS server. These helpers
+ * format the responses they send and sign them the way a server would
+ * (refer to RFC 2865 and RFC 3579)
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+//Dependencies
+#include "core/crypto.h"
+#include "hash/md5.h"
+#include "radius/radius_attributes.h"
+#include "test_radius_fake.h"
+
+
+/**
+ * @brief Compute HMAC-MD5
+ *
+ * The key must not be longer than the block size of MD5
+ *
+ * @param[in] key Pointer to the key
+ * @param[in] keyLen Length of the key, in bytes
+ * @param[in] data Pointer to the data
+ * @param[in] length Length of the data, in bytes
+ * @param[out] digest HMAC-MD5 digest
+ **/
+
+void fakeRadiusHmacMd5(const void *key, size_t keyLen, const void *data,
+   size_t length, uint8_t *digest)
+{
+   uint_t i;
+   uint8_t pad[MD5_BLOCK_SIZE];
+   Md5Context md5Context;
+
+   //Inner hash
+   osMemset(pad, 0x36, MD5_BLOCK_SIZE);
+   for(i = 0; i < keyLen && i < MD5_BLOCK_SIZE; i++)
+   {
+      pad[i] ^= ((const uint8_t *) key)[i];
+   }
+
+   md5Init(&md5Context);
+   md5Update(&md5Context, pad, MD5_BLOCK_SIZE);
+   md5Update(&md5Context, data, length);
+   md5Final(&md5Context, digest);
+
+   //Outer hash
+   osMemset(pad, 0x5C, MD5_BLOCK_SIZE);
+   for(i = 0; i < keyLen && i < MD5_BLOCK_SIZE; i++)
+   {
+      pad[i] ^= ((const uint8_t *) key)[i];
+   }
+
+   md5Init(&md5Context);
+   md5Update(&md5Context, pad, MD5_BLOCK_SIZE);
+   md5Update(&md5Context, digest, MD5_DIGEST_SIZE);
+   md5Final(&md5Context, digest);
+}
+
+
+/**
+ * @brief Format a signed response to an Access-Request
+ * @param[out] buffer Buffer where to format the response
+ * @param[in] request Pointer to the Access-Request
+ * @param[in] code Code of the response
+ * @param[in] eapPacket EAP packet to be carried by the response
+ * @param[in] eapPacketLen Length of the EAP packet, in bytes
+ * @param[in] state Value of the State attribute (optional parameter)
+ * @param[in] stateLen Length of the State attribute, in bytes
+ * @param[in] key Shared secret of the server
+ * @param[in] keyLen Length of the shared secret, in bytes
+ * @return Length of the response, in bytes
+ **/
+
+size_t fakeRadiusFormatResponse(uint8_t *buffer, const RadiusPacket *request,
+   uint8_t code, const void *eapPacket, size_t eapPacketLen,
+   const void *state, size_t stateLen, const void *key, size_t keyLen)
+{
+   size_t n;
+   size_t length;
+   uint8_t digest[MD5_DIGEST_SIZE];
+   RadiusPacket *packet;
+   RadiusAttribute *attribute;
+   Md5Context md5Context;
+
+   //The response carries the identifier and the Request Authenticator of
+   //the request until it is signed
+   packet = (RadiusPacket *) buffer;
+   packet->code = code;
+   packet->identifier = request->identifier;
+   packet->length = htons(sizeof(RadiusPacket));
+   osMemcpy(packet->authenticator, request->authenticator, 16);
+
+   //The EAP packet is split into EAP-Message attributes (refer to RFC 3579,
+   //section 3.1)
+   for(n = 0; n < eapPacketLen; n += RADIUS_MAX_ATTR_VALUE_LEN)
+   {
+      radiusAddAttribute(packet, RADIUS_ATTR_EAP_MESSAGE,
+         (const uint8_t *) eapPacket + n,
+         MIN(eapPacketLen - n, RADIUS_MAX_ATTR_VALUE_LEN));
+   }
+
+   //State attribute
+   if(state != NULL)
+   {
+      radiusAddAttribute(packet, RADIUS_ATTR_STATE, state, stateLen);
+   }
+
+   //The Message-Authenticator is calculated over sixteen octets of zero
+   osMemset(digest, 0, MD5_DIGEST_SIZE);
+   radiusAddAttribute(packet, RADIUS_ATTR_MESSAGE_AUTHENTICATOR, digest,
+      MD5_DIGEST_SIZE);
+
+   //Retrieve the length of the response
+   length = ntohs(packet->length);
+
+   //Calculate the Message-Authenticator (refer to RFC 3579, section 3.2)
+   attribute = (RadiusAttribute *) (buffer + length -
+      sizeof(RadiusAttribute) - MD5_DIGEST_SIZE);
+   fakeRadiusHmacMd5(key, keyLen, packet, length, attribute->value);
+
+   //Calculate the Response Authenticator (refer to RFC 2865, section 3)
+   md5Init(&md5Context);
+   md5Update(&md5Context, packet, length);
+   md5Update(&md5Context, key, keyLen);
+   md5Final(&md5Context, packet->authenticator);
+
+   //Return the length of the response
+   return length;
+}
+
+
+/**
+ * @brief Reassemble the EAP packet carried by a RADIUS packet
+ * @param[in] packet Pointer to the RADIUS packet
+ * @param[out] buffer Buffer where to store the EAP packet
+ * @param[in] size Size of the buffer, in bytes
+ * @return Length of the EAP packet, in bytes (0 if the buffer is too small)
+ **/
+
+size_t fakeRadiusGetEapMessage(const RadiusPacket *packet, uint8_t *buffer,
+   size_t size)
+{
+   uint_t i;
+   size_t n;
+   size_t length;
+   const RadiusAttribute *attribute;
+
+   //Concatenate the EAP-Message attributes
+   for(length = 0, i = 0; ; i++)
+   {
+      //Retrieve the next fragment
+      attribute = radiusGetAttribute(packet, RADIUS_ATTR_EAP_MESSAGE, i);
+      //No more fragments?
+      if(attribute == NULL)
+         break;
+
+      //Length of the fragment
+      n = attribute->length - sizeof(RadiusAttribute);
+
+      //Make sure the buffer is large enough
+      if((length + n) > size)
+         return 0;
+
+      //Copy the fragment
+      osMemcpy(buffer + length, attribute->value, n);
+      length += n;
+   }
+
+   //Return the length of the EAP packet
+   return length;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file test_radius_fake.h
+ * @brief Helpers for scripted RADIUS servers
+ *
+ * @section License
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2022-2026 Oryx Embedded SARL. All rights reserved.
+ *
+ * This file is part of CycloneEAP Open.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @author Oryx Embedded SARL (www.oryx-embedded.com)
+ * @version 2.6.4
+ **/
+
+#ifndef _TEST_RADIUS_FAKE_H
+#define _TEST_RADIUS_FAKE_H
+
+//Dependencies
+#include "radius/radius.h"
+
+//C++ guard
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Scripted RADIUS server related functions
+void fakeRadiusHmacMd5(const void *key, size_t keyLen, const void *data,
+   size_t length, uint8_t *digest);
+
+size_t fakeRadiusFormatResponse(uint8_t *buffer, const RadiusPacket *request,
+   uint8_t code, const void *eapPacket, size_t eapPacketLen,
+   const void *state, size_t stateLen, const void *key, size_t keyLen);
+
+size_t fakeRadiusGetEapMessage(const RadiusPacket *packet, uint8_t *buffer,
+   size_t size);
+
+//C++ guard
+#ifdef __cplusplus
+}
+#endif
+
+#endif